@@ -0,0 +1,109 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+/*  Board description folding (pin lists in board_cfg.h)
+    *   include after gpio_int.h, rcc_int.h and board_cfg.h
+*/
+
+typedef enum {
+    BOARD_OK = 0,                   // boot images applied
+    BOARD_NOT_OK,                   // general error
+    BOARD_GPIO_ERROR                // a port image was refused by the GPIO driver
+}BOARD_Status_t;
+
+// Port and pin of every described pin : BOARD_<name>_PORT, BOARD_<name>_PIN
+#define BOARD_X_NAMES(ctx, name, port, pin, mode, outputType, speed, pull, af) \
+    BOARD_##name##_PORT = (port), BOARD_##name##_PIN = (pin),
+
+enum {
+    BOARD_ALL_PINS(BOARD_X_NAMES, 0)
+};
+
+// Value kept only for the pins of port P (the context of the per-port macros)
+#define BOARD_ON_PORT(P, port, value)        (((uint32_t)(port) == (uint32_t)(P)) ? (value) : 0UL)
+
+// Per-pin macros of the port images, context = port
+#define BOARD_X_PIN_MASK(P, name, port, pin, mode, outputType, speed, pull, af)    | BOARD_ON_PORT(P, port, GPIO_IMAGE_PIN_MASK(pin))
+#define BOARD_X_PIN_SUM(P, name, port, pin, mode, outputType, speed, pull, af)     + BOARD_ON_PORT(P, port, GPIO_IMAGE_PIN_MASK(pin))
+#define BOARD_X_PIN_COUNT(P, name, port, pin, mode, outputType, speed, pull, af)   + BOARD_ON_PORT(P, port, 1UL)
+#define BOARD_X_WIDE_MASK(P, name, port, pin, mode, outputType, speed, pull, af)   | BOARD_ON_PORT(P, port, GPIO_IMAGE_WIDE(pin, 3U))
+#define BOARD_X_AFRL_MASK(P, name, port, pin, mode, outputType, speed, pull, af)   | BOARD_ON_PORT(P, port, GPIO_IMAGE_AFRL(pin, 0xFU))
+#define BOARD_X_AFRH_MASK(P, name, port, pin, mode, outputType, speed, pull, af)   | BOARD_ON_PORT(P, port, GPIO_IMAGE_AFRH(pin, 0xFU))
+#define BOARD_X_MODER(P, name, port, pin, mode, outputType, speed, pull, af)       | BOARD_ON_PORT(P, port, GPIO_IMAGE_WIDE(pin, mode))
+#define BOARD_X_OTYPER(P, name, port, pin, mode, outputType, speed, pull, af)      | BOARD_ON_PORT(P, port, ((uint32_t)(outputType) << (uint32_t)(pin)))
+#define BOARD_X_OSPEEDR(P, name, port, pin, mode, outputType, speed, pull, af)     | BOARD_ON_PORT(P, port, GPIO_IMAGE_WIDE(pin, speed))
+#define BOARD_X_PUPDR(P, name, port, pin, mode, outputType, speed, pull, af)       | BOARD_ON_PORT(P, port, GPIO_IMAGE_WIDE(pin, pull))
+#define BOARD_X_AFRL(P, name, port, pin, mode, outputType, speed, pull, af)        | BOARD_ON_PORT(P, port, GPIO_IMAGE_AFRL(pin, af))
+#define BOARD_X_AFRH(P, name, port, pin, mode, outputType, speed, pull, af)        | BOARD_ON_PORT(P, port, GPIO_IMAGE_AFRH(pin, af))
+
+// Per-pin macros of the whole board, context unused
+#define BOARD_X_COUNT(ctx, name, port, pin, mode, outputType, speed, pull, af)     + 1UL
+#define BOARD_X_CLOCK(ctx, name, port, pin, mode, outputType, speed, pull, af)     | BOARD_PORT_CLOCK(port)
+#define BOARD_X_CHECK(ctx, name, port, pin, mode, outputType, speed, pull, af) \
+    _Static_assert((uint32_t)(port) <= (uint32_t)GPIO_PORT_H, "Board: wrong port for " #name); \
+    GPIO_IMAGE_X_CHECK(pin, mode, outputType, speed, pull, af)
+
+// GPIO_Image_t of the pins of a list that sit on port P
+#define BOARD_PORT_IMAGE_INITIALIZER(P, PINS) { \
+    .Port     = (GPIO_Port_t)(P), \
+    .PinMask  = 0UL PINS(BOARD_X_PIN_MASK, P), \
+    .WideMask = 0UL PINS(BOARD_X_WIDE_MASK, P), \
+    .AfrlMask = 0UL PINS(BOARD_X_AFRL_MASK, P), \
+    .AfrhMask = 0UL PINS(BOARD_X_AFRH_MASK, P), \
+    .MODER    = 0UL PINS(BOARD_X_MODER, P), \
+    .OTYPER   = 0UL PINS(BOARD_X_OTYPER, P), \
+    .OSPEEDR  = 0UL PINS(BOARD_X_OSPEEDR, P), \
+    .PUPDR    = 0UL PINS(BOARD_X_PUPDR, P), \
+    .AFRL     = 0UL PINS(BOARD_X_AFRL, P), \
+    .AFRH     = 0UL PINS(BOARD_X_AFRH, P) }
+
+// A pin listed twice on port P makes the sum differ from the OR
+#define BOARD_PORT_CHECK(P, PINS) \
+    _Static_assert((0UL PINS(BOARD_X_PIN_SUM, P)) == (0UL PINS(BOARD_X_PIN_MASK, P)), "Board: pin used twice on " #P)
+
+// True when every pin of a list sits on port P (one image, one BSRR word)
+#define BOARD_PINS_ON_PORT(P, PINS)          ((0UL PINS(BOARD_X_COUNT, 0)) == (0UL PINS(BOARD_X_PIN_COUNT, P)))
+
+// True when the pins of a list on port P are all fitted with the same mode and AF,
+// BOARD_enuInit already set them up (a pin fitted for another function does not count)
+#define BOARD_PINS_FITTED(P, PINS) \
+    ((((0UL PINS(BOARD_X_PIN_MASK, P)) & ~(0UL BOARD_FITTED_PINS(BOARD_X_PIN_MASK, P))) == 0UL) && \
+     (((0UL BOARD_FITTED_PINS(BOARD_X_MODER, P)) & (0UL PINS(BOARD_X_WIDE_MASK, P))) == (0UL PINS(BOARD_X_MODER, P))) && \
+     (((0UL BOARD_FITTED_PINS(BOARD_X_AFRL, P)) & (0UL PINS(BOARD_X_AFRL_MASK, P))) == (0UL PINS(BOARD_X_AFRL, P))) && \
+     (((0UL BOARD_FITTED_PINS(BOARD_X_AFRH, P)) & (0UL PINS(BOARD_X_AFRH_MASK, P))) == (0UL PINS(BOARD_X_AFRH, P))))
+
+// AHB1 clock mask of a port, RCC encoding (bus in bits 35:32, GPIOH on bit 7)
+#define BOARD_PORT_CLOCK(port) \
+    (((uint64_t)RCC_AHB1_BUS << 32U) | (1ULL << (((uint32_t)(port) == (uint32_t)GPIO_PORT_H) ? 7U : (uint32_t)(port))))
+
+// GPIO clocks of the fitted pins, for MCU_AHB1_PERIPHERALS_ENABLE / MCU_Configs
+#define BOARD_AHB1_CLOCKS                    (0ULL BOARD_FITTED_PINS(BOARD_X_CLOCK, 0))
+
+// BSRR word driving one pin to a level (1 : set, 0 : reset)
+#define BOARD_BSRR(pin, level)               (((level) != 0U) ? GPIO_IMAGE_PIN_MASK(pin) : (GPIO_IMAGE_PIN_MASK(pin) << 16U))
+
+// BSRR word putting a 4-bit value on four pins of one port, bit 0 on p0
+#define BOARD_NIBBLE_BSRR(p0, p1, p2, p3, value) \
+    (BOARD_BSRR(p0, (value) & 1U) | BOARD_BSRR(p1, ((value) >> 1U) & 1U) | \
+     BOARD_BSRR(p2, ((value) >> 2U) & 1U) | BOARD_BSRR(p3, ((value) >> 3U) & 1U))
+
+// Initializer of a uint32_t[16] table : BSRR word of every nibble value
+#define BOARD_NIBBLE_TABLE(p0, p1, p2, p3) { \
+    BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 0U),  BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 1U),  \
+    BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 2U),  BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 3U),  \
+    BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 4U),  BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 5U),  \
+    BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 6U),  BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 7U),  \
+    BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 8U),  BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 9U),  \
+    BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 10U), BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 11U), \
+    BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 12U), BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 13U), \
+    BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 14U), BOARD_NIBBLE_BSRR(p0, p1, p2, p3, 15U) }
+
+// Applies the image of every port holding a fitted pin (six read-modify-writes per port)
+// GPIO clocks must be on (BOARD_AHB1_CLOCKS in the MCU configuration)
+// Called by MCU_enuInit / MCU_enuFastStartInit once the peripheral clocks are enabled
+BOARD_Status_t BOARD_enuInit(void);
+
+// TRUE when the pin belongs to a fitted list : it is set up at boot, drivers skip it
+bool_t BOARD_boolIsFitted(GPIO_Port_t port, GPIO_Pin_t pin);
+
+#endif /* BOARD_H */
@@ -0,0 +1,137 @@
+#ifndef BOARD_CFG_H
+#define BOARD_CFG_H
+
+/*  Board description : every pin of the board is written once, here
+    *   The LED, switch, seven-segment and LCD configurations take their
+    *   port and pin from these lists (BOARD_<name>_PORT / BOARD_<name>_PIN),
+    *   the boot images, the GPIO clock mask and the LCD / seven-segment
+    *   BSRR tables are folded from them at build time (see board.h)
+
+    *   A pin list is a macro taking a per-pin macro and a context, it calls
+    *   the per-pin macro once per pin with
+    *   (ctx, name, port, pin, mode, outputType, speed, pull, af)
+*/
+
+/*  Character LCD (HD44780), control lines and upper data nibble
+    *   Also the whole bus in 4-bit mode, all the LCD pins share one port
+*/
+#define BOARD_LCD_PINS(PIN, ctx) \
+    PIN(ctx, LCD_RS,  GPIO_PORT_A, GPIO_PIN_0,  GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LCD_RW,  GPIO_PORT_A, GPIO_PIN_1,  GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LCD_EN,  GPIO_PORT_A, GPIO_PIN_2,  GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LCD_DB4, GPIO_PORT_A, GPIO_PIN_7,  GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LCD_DB5, GPIO_PORT_A, GPIO_PIN_8,  GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LCD_DB6, GPIO_PORT_A, GPIO_PIN_9,  GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LCD_DB7, GPIO_PORT_A, GPIO_PIN_10, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0)
+
+/*  Character LCD lower data nibble, wired in 8-bit mode only */
+#define BOARD_LCD_LOW_PINS(PIN, ctx) \
+    PIN(ctx, LCD_DB0, GPIO_PORT_A, GPIO_PIN_3,  GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LCD_DB1, GPIO_PORT_A, GPIO_PIN_4,  GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LCD_DB2, GPIO_PORT_A, GPIO_PIN_5,  GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LCD_DB3, GPIO_PORT_A, GPIO_PIN_6,  GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0)
+
+/*  BlackPill on-board LED and the two kit LEDs on port B */
+#define BOARD_LED_PINS(PIN, ctx) \
+    PIN(ctx, LED_BLACK_PILL, GPIO_PORT_C, GPIO_PIN_13, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LED_KIT_1,      GPIO_PORT_B, GPIO_PIN_0,  GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LED_KIT_2,      GPIO_PORT_B, GPIO_PIN_1,  GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0)
+
+/*  Kit LEDs 3 to 8, they share PA2..PA7 with the LCD (jumpers on the kit) */
+#define BOARD_KIT_LED_PINS(PIN, ctx) \
+    PIN(ctx, LED_KIT_3, GPIO_PORT_A, GPIO_PIN_2, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LED_KIT_4, GPIO_PORT_A, GPIO_PIN_3, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LED_KIT_5, GPIO_PORT_A, GPIO_PIN_4, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LED_KIT_6, GPIO_PORT_A, GPIO_PIN_5, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LED_KIT_7, GPIO_PORT_A, GPIO_PIN_6, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, LED_KIT_8, GPIO_PORT_A, GPIO_PIN_7, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0)
+
+/*  Kit push button, internal pull-up */
+#define BOARD_SWITCH_PINS(PIN, ctx) \
+    PIN(ctx, SWITCH_KIT_1, GPIO_PORT_B, GPIO_PIN_4, GPIO_MODE_INPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_PULL_UP, GPIO_AF0)
+
+/*  Seven-segment display, segments A..G in order, shares PA0..PA6 with the LCD */
+#define BOARD_SEVSEG_PINS(PIN, ctx) \
+    PIN(ctx, SEVSEG_A, GPIO_PORT_A, GPIO_PIN_0, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, SEVSEG_B, GPIO_PORT_A, GPIO_PIN_1, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, SEVSEG_C, GPIO_PORT_A, GPIO_PIN_2, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, SEVSEG_D, GPIO_PORT_A, GPIO_PIN_3, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, SEVSEG_E, GPIO_PORT_A, GPIO_PIN_4, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, SEVSEG_F, GPIO_PORT_A, GPIO_PIN_5, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(ctx, SEVSEG_G, GPIO_PORT_A, GPIO_PIN_6, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF0)
+
+/*  Seven-segment level that lights a segment
+    *   0 : active high (common cathode)
+    *   1 : active low  (common anode)
+*/
+#define BOARD_SEVSEG_ACTIVE_STATE   (1U)
+
+/*  UART pins, one list per direction (the UART driver applies TX and RX apart)
+    *   USART1 on PA9 (TX) / PA10 (RX) : the HSERIAL link (HSERIAL_CHANNEL_1),
+    *   shares PA9/PA10 with LCD_DB6/DB7
+    *   USART2 on PA2 (TX) / PA3 (RX) : shares PA2/PA3 with LCD_EN/DB0
+    *   USART6 on PC6 (TX) / PC7 (RX) : loopback link of the UART tests,
+    *   trace stream (HSERIAL_CHANNEL_TRACE) with TRACE_ENABLED
+*/
+#define BOARD_UART1_TX_PINS(PIN, ctx) \
+    PIN(ctx, UART1_TX, GPIO_PORT_A, GPIO_PIN_9,  GPIO_MODE_ALTERNATE_FUNCTION, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF7)
+#define BOARD_UART1_RX_PINS(PIN, ctx) \
+    PIN(ctx, UART1_RX, GPIO_PORT_A, GPIO_PIN_10, GPIO_MODE_ALTERNATE_FUNCTION, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF7)
+#define BOARD_UART2_TX_PINS(PIN, ctx) \
+    PIN(ctx, UART2_TX, GPIO_PORT_A, GPIO_PIN_2,  GPIO_MODE_ALTERNATE_FUNCTION, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF7)
+#define BOARD_UART2_RX_PINS(PIN, ctx) \
+    PIN(ctx, UART2_RX, GPIO_PORT_A, GPIO_PIN_3,  GPIO_MODE_ALTERNATE_FUNCTION, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF7)
+#define BOARD_UART6_TX_PINS(PIN, ctx) \
+    PIN(ctx, UART6_TX, GPIO_PORT_C, GPIO_PIN_6,  GPIO_MODE_ALTERNATE_FUNCTION, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF8)
+#define BOARD_UART6_RX_PINS(PIN, ctx) \
+    PIN(ctx, UART6_RX, GPIO_PORT_C, GPIO_PIN_7,  GPIO_MODE_ALTERNATE_FUNCTION, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_DEFAULT, GPIO_NO_PULL, GPIO_AF8)
+
+#define BOARD_UART1_PINS(PIN, ctx)  BOARD_UART1_TX_PINS(PIN, ctx) BOARD_UART1_RX_PINS(PIN, ctx)
+#define BOARD_UART2_PINS(PIN, ctx)  BOARD_UART2_TX_PINS(PIN, ctx) BOARD_UART2_RX_PINS(PIN, ctx)
+#define BOARD_UART6_PINS(PIN, ctx)  BOARD_UART6_TX_PINS(PIN, ctx) BOARD_UART6_RX_PINS(PIN, ctx)
+
+/*  Every described pin : names the BOARD_<name>_PORT / _PIN constants */
+#define BOARD_ALL_PINS(PIN, ctx) \
+    BOARD_LCD_PINS(PIN, ctx) \
+    BOARD_LCD_LOW_PINS(PIN, ctx) \
+    BOARD_LED_PINS(PIN, ctx) \
+    BOARD_KIT_LED_PINS(PIN, ctx) \
+    BOARD_SWITCH_PINS(PIN, ctx) \
+    BOARD_SEVSEG_PINS(PIN, ctx) \
+    BOARD_UART1_PINS(PIN, ctx) \
+    BOARD_UART2_PINS(PIN, ctx) \
+    BOARD_UART6_PINS(PIN, ctx)
+
+/*  Fitted set of this build, follows the kit jumpers
+    *   BOARD_SET_LCD     : LCD, LEDs, switch, USART6 (the test builds)
+    *   BOARD_SET_HSERIAL : LEDs, switch, USART1 as the HSERIAL link, USART6
+    *   The LCD and USART1 cannot be fitted together (PA9/PA10)
+*/
+#define BOARD_SET_LCD               (0U)
+#define BOARD_SET_HSERIAL           (1U)
+
+#define BOARD_FITTED_SET            BOARD_SET_LCD
+
+/*  Pins fitted on this build : boot images, GPIO clocks and conflict checks
+    *   A pin listed by two fitted lists stops the build, swap a list in or
+    *   out here when the kit jumpers change (ex: BOARD_SEVSEG_PINS for
+    *   BOARD_LCD_PINS)
+    *   A UART whose pins are not fitted still sets them up at its init
+*/
+#if (BOARD_FITTED_SET == BOARD_SET_LCD)
+#define BOARD_FITTED_PINS(PIN, ctx) \
+    BOARD_LCD_PINS(PIN, ctx) \
+    BOARD_LED_PINS(PIN, ctx) \
+    BOARD_SWITCH_PINS(PIN, ctx) \
+    BOARD_UART6_PINS(PIN, ctx)
+#elif (BOARD_FITTED_SET == BOARD_SET_HSERIAL)
+#define BOARD_FITTED_PINS(PIN, ctx) \
+    BOARD_LED_PINS(PIN, ctx) \
+    BOARD_SWITCH_PINS(PIN, ctx) \
+    BOARD_UART1_PINS(PIN, ctx) \
+    BOARD_UART6_PINS(PIN, ctx)
+#else
+#error "board_cfg.h: BOARD_FITTED_SET must be BOARD_SET_LCD or BOARD_SET_HSERIAL"
+#endif
+
+#endif /* BOARD_CFG_H */
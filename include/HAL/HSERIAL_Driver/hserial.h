@@ -18,6 +18,7 @@ typedef enum {
     HSERIAL_ERROR_NVIC,
     HSERIAL_ERROR_INIT_DMA,
     HSERIAL_ERROR_INIT_SPI,
+    HSERIAL_WRONG_MODE,
 } HSERIAL_Status_t;
 
 typedef enum {
@@ -36,6 +37,9 @@ typedef enum {
     HSERIAL_UART_6
 }HSERIAL_Uart_Number_t;
 
+// UART peripheral clock read from the clock tree (APB1/APB2) instead of a fixed value
+#define HSERIAL_UART_PERIPHERAL_CLOCK_AUTO     (0UL)
+
 
 typedef enum {
     HSERIAL_UART_PARITY_NONE = 0b0000000000000000000000,
@@ -73,6 +77,10 @@ typedef enum {
     HSERIAL_ENABLE_UART_BOTH      = 0b0000000000000000001100UL
 }HSERIAL_Uart_Enable_t; 
 
+/*  Interrupt priority of the USART / DMA / SPI handlers
+    *   Values more urgent than NVIC_CRITICAL_BASEPRI_THRESHOLD (nvic_cfg.h) are
+    *   lowered to it at init, the handlers must stay maskable by NVIC_EnterCritical()
+*/
 typedef enum {
     HSERIAL_PRIORITY_0  = 0x00,  /**< Priority 0 (Highest) - 0000 0000 */
     HSERIAL_PRIORITY_1  = 0x10,  /**< Priority 1 - 0001 0000 */
@@ -258,5 +266,46 @@ HSERIAL_Status_t HSERIAL_enuInit(void);
 HSERIAL_Status_t HSERIAL_enuTransmitBuffer(HSERIAL_Channel_t channel, const uint8_t* dataBuffer, uint16_t size);
 HSERIAL_Status_t HSERIAL_enuReceiveBuffer(HSERIAL_Channel_t channel,uint8_t* dataBuffer, uint16_t size);
 
+/*
+ * Function: HSERIAL_enuStartReceiveStream
+ * Description: Receives continuously into a ring buffer split in two halves
+ *              (circular DMA, half-transfer and transfer-complete interrupts)
+ * Parameters:
+ *   - channel: HSERIAL_MODE_UART_DMA channel with reception enabled
+ *   - ringBuffer: Buffer of size bytes, the DMA fills it over and over
+ *   - size: Even number of bytes
+ *   - halfCallback: Called when the first half is full (the DMA moves to the second)
+ *   - fullCallback: Called when the second half is full (the DMA wraps to the first)
+ * Returns: HSERIAL_Status_t (HSERIAL_OK, HSERIAL_WRONG_CHANNEL, HSERIAL_NULL_POINTER,
+ *          HSERIAL_INVALID_SIZE, HSERIAL_WRONG_MODE, HSERIAL_ERROR_INIT_DMA)
+ * Note: The DMA never stops between halves : one half can be processed while
+ *       the other fills, with no byte lost to the interrupt latency
+ *       The processing of a half must end before the DMA comes back to it
+ */
+HSERIAL_Status_t HSERIAL_enuStartReceiveStream(HSERIAL_Channel_t channel, uint8_t* ringBuffer, uint16_t size,
+                                               HSERIAL_Callback_t halfCallback, HSERIAL_Callback_t fullCallback);
+
+/*
+ * Function: HSERIAL_enuStopReceiveStream
+ * Description: Stops the ring reception, HSERIAL_enuReceiveBuffer can be used again
+ * Returns: HSERIAL_Status_t (HSERIAL_OK, HSERIAL_WRONG_CHANNEL, HSERIAL_WRONG_MODE, HSERIAL_ERROR_INIT_DMA)
+ */
+HSERIAL_Status_t HSERIAL_enuStopReceiveStream(HSERIAL_Channel_t channel);
+
+/*
+ * Function: HSERIAL_enuGetTransferTime
+ * Description: Time size bytes take on the wire at the rate programmed in the
+ *              channel peripheral (UART BRR / SPI prescaler and the live APB clock)
+ * Parameters:
+ *   - channel: Initialized UART or SPI (sync / async) channel
+ *   - size: Number of bytes
+ *   - transferUs: Pointer to store the time in us, rounded up
+ * Returns: HSERIAL_Status_t (HSERIAL_OK, HSERIAL_WRONG_CHANNEL, HSERIAL_NULL_POINTER,
+ *          HSERIAL_ERROR_INIT_UART, HSERIAL_ERROR_INIT_SPI, HSERIAL_WRONG_MODE)
+ * Note: Back-to-back frames, the line rate : a sustained throughput measured
+ *       against it shows the software and interrupt cost between frames
+ */
+HSERIAL_Status_t HSERIAL_enuGetTransferTime(HSERIAL_Channel_t channel, uint16_t size, uint32_t* transferUs);
+
 
 #endif // HSERIAL_H
\ No newline at end of file
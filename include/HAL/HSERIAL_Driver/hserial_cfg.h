@@ -1,11 +1,15 @@
 #ifndef HSERIAL_CFG_H
 #define HSERIAL_CFG_H
 
+#include "OS/trace.h"
 
 typedef enum {
     HSERIAL_CHANNEL_1 = 0,
     // HSERIAL_CHANNEL_2,
     // HSERIAL_SENSOR_TEMP,
+#if (TRACE == TRACE_ENABLED)
+    HSERIAL_CHANNEL_TRACE,      // TRACE_HSERIAL_CHANNEL : USART6 TX by DMA
+#endif
 
     HSERIAL_CHANNEL_LENGTH
 } HSERIAL_Channel_t;
@@ -24,7 +24,13 @@ typedef enum {
     MCU_WRONG_AHB_PRESCALER,                      /* Invalid AHB prescaler value */
     MCU_WRONG_APB_PRESCALER,                      /* Invalid APB prescaler value */
     MCU_WRONG_CONFIG,                             /* General configuration error */
-    MCU_ERROR                                     /* Generic error condition */
+    MCU_ERROR,                                    /* Generic error condition */
+    MCU_CLOCK_NOTIFIERS_FULL,                     /* No free slot left for another clock change notifier */
+    MCU_FLASH_ERROR,                              /* Flash wait states or accelerator could not be configured */
+    MCU_BOOT_PENDING,                             /* Fast-start: oscillator or PLL still stabilizing, poll again */
+    MCU_BOOT_REPORT_FULL,                         /* Boot profiler: no room left for another phase */
+    MCU_CLOCK_BUSY,                               /* Clock switch refused: a registered guard reported a transfer in flight */
+    MCU_BOARD_ERROR                               /* Fitted board pins (board_cfg.h) could not be applied */
 }MCU_Status_t;
 
 
@@ -50,6 +56,49 @@ typedef enum {
 #define MCU_PLL_SOURCE_HSE                RCC_PLL_SOURCE_HSE
 
 
+/* PLL factors are computed by the clock tree solver from the target frequency */
+#define MCU_PLL_AUTO_FACTORS              (1U)
+
+/* PLL factors are taken as written in the configuration */
+#define MCU_PLL_MANUAL_FACTORS            (0U)
+
+
+/* Boot profiler timestamps every boot phase with the DWT cycle counter */
+#define MCU_BOOT_PROFILER_ENABLED         (1U)
+
+/* Boot profiler marks compile to nothing */
+#define MCU_BOOT_PROFILER_DISABLED        (0U)
+
+
+/* Highest HCLK of the device, flash wait states are set for it before any clock switch */
+#define MCU_FLASH_HCLK_MAX                (84000000UL)
+
+/* Supply voltage range 2.7 V - 3.6 V (up to 30 MHz per flash wait state) */
+#define MCU_FLASH_VOLTAGE_2V7_TO_3V6      FLASH_VOLTAGE_2V7_TO_3V6
+
+/* Supply voltage range 2.4 V - 2.7 V (up to 24 MHz per flash wait state) */
+#define MCU_FLASH_VOLTAGE_2V4_TO_2V7      FLASH_VOLTAGE_2V4_TO_2V7
+
+/* Supply voltage range 2.1 V - 2.4 V (up to 18 MHz per flash wait state) */
+#define MCU_FLASH_VOLTAGE_2V1_TO_2V4      FLASH_VOLTAGE_2V1_TO_2V4
+
+/* Supply voltage range 1.8 V - 2.1 V (up to 16 MHz per flash wait state, no prefetch) */
+#define MCU_FLASH_VOLTAGE_1V8_TO_2V1      FLASH_VOLTAGE_1V8_TO_2V1
+
+/* Flash accelerator features (can be ORed) */
+#define MCU_FLASH_NO_FEATURE              FLASH_NO_FEATURE
+#define MCU_FLASH_PREFETCH_ENABLE         FLASH_PREFETCH_ENABLE
+#define MCU_FLASH_ICACHE_ENABLE           FLASH_ICACHE_ENABLE
+#define MCU_FLASH_DCACHE_ENABLE           FLASH_DCACHE_ENABLE
+
+
+/* Clock change phase - the clock is about to change (finish ongoing transfers) */
+#define MCU_CLOCK_PRE_CHANGE              RCC_CLOCK_PRE_CHANGE
+
+/* Clock change phase - the clock has changed (recompute dividers from MCU_GetClockHz) */
+#define MCU_CLOCK_POST_CHANGE             RCC_CLOCK_POST_CHANGE
+
+
 /* Bus identifier for Advanced High-performance Bus 1 (connects high-speed peripherals) */
 #define MCU_AHB1_BUS                      RCC_AHB1_BUS
 
@@ -277,8 +326,69 @@ uint8_t               MCU_PLLP;
 /* PLL division factor for USB OTG FS, SDIO and RNG clocks - Valid range: 2 to 15
  * Used to generate 48 MHz clock required by USB, SDIO, and RNG peripherals */
 uint8_t               MCU_PLLQ;
+
+/* Target system clock in Hz for the PLL solver (max 84,000,000)
+ * 0 means the PLLM/PLLN/PLLP/PLLQ fields above are used as written */
+uint32_t              MCU_PLLTargetFrequency;
+
+/* Supply voltage range used to select the flash wait states (MCU_FLASH_VOLTAGE_xxx) */
+uint8_t               MCU_FlashVoltageRange;
+
+/* Flash accelerator features to enable (OR of MCU_FLASH_xxx_ENABLE) */
+uint32_t              MCU_FlashAccelerator;
 }MCU_Config_t;
 
+/*
+ * Clock profile used for runtime frequency scaling (see MCU_enuSetClockProfile)
+ * Describes a complete operating point: SYSCLK source, PLL target and bus prescalers
+ */
+typedef struct{
+/* System clock source selection (HSI, HSE, or PLL) */
+MCU_ClockSrc_t        MCU_SystemClockSource;
+
+/* PLL clock source selection (MCU_PLL_SOURCE_HSI or MCU_PLL_SOURCE_HSE), used with MCU_SYSCLK_PLL */
+uint8_t               MCU_PLLClockSource;
+
+/* Target system clock in Hz, PLL factors are solved automatically (used with MCU_SYSCLK_PLL) */
+uint32_t              MCU_PLLTargetFrequency;
+
+/* AHB bus prescaler - divides system clock to generate AHB clock */
+MCU_AHPPrescaler_t    MCU_AHP_Prescaler;
+
+/* APB1 bus prescaler - APB1 clock must stay at or below 42 MHz */
+MCU_APB1Prescaler_t   MCU_APB1_Prescaler;
+
+/* APB2 bus prescaler - APB2 clock must stay at or below 84 MHz */
+MCU_APB2Prescaler_t   MCU_APB2_Prescaler;
+}MCU_ClockProfile_t;
+
+/*
+ * One entry of the boot-time report (see MCU_enuBootMark / MCU_enuGetBootReport)
+ * A phase lasts from the previous mark (or MCU_vdBootProfilerStart) to its own mark
+ */
+typedef struct{
+/* Name given to MCU_enuBootMark (string literal, not copied) */
+const char           *MCU_PhaseName;
+
+/* CPU cycles spent in the phase */
+uint32_t              MCU_PhaseCycles;
+
+/* Phase duration in microseconds, converted with the HCLK running when the phase started */
+uint32_t              MCU_PhaseMicroseconds;
+}MCU_BootPhase_t;
+
+/*
+ * Function pointer type for clock change notifiers
+ * Called with MCU_CLOCK_PRE_CHANGE before and MCU_CLOCK_POST_CHANGE after a switch
+ */
+typedef void (*MCU_ClockNotifier_t)(uint8_t phase);
+
+/*
+ * Function pointer type for clock change guards
+ * Returns 1 while the clock must not change (ex: a DMA frame still on the wire), 0 otherwise
+ */
+typedef uint8_t (*MCU_ClockGuard_t)(void);
+
 /* 
  * External declaration of the MCU configuration structure
  * This structure should be defined in the application configuration file
@@ -293,11 +403,144 @@ extern const MCU_Config_t MCU_Configs;
  *   - Pointer to MCU_Config_t structure containing clock and peripheral configuration
  * Returns: MCU_Status_t indicating success or specific error condition
  * Note: This function configures:
+ *       - Flash wait states for the resulting HCLK, prefetch and ART caches
  *       - System clock source (HSI/HSE/PLL)
  *       - PLL parameters if PLL is used
  *       - AHB, APB1, and APB2 prescalers
  *       - Peripheral clock enables for all buses
+ *       MCU_WRONG_APB_PRESCALER is returned before anything is switched when
+ *       PCLK1 would exceed 42 MHz or PCLK2 84 MHz (ex: 84 MHz PLL with APB1 /1)
+ */
+MCU_Status_t MCU_enuInit(const MCU_Config_t *);
+
+/*
+ * Function: MCU_enuFastStartInit
+ * Description: Non-blocking variant of MCU_enuInit for a short boot
+ * Parameters:
+ *   - Pointer to MCU_Config_t structure (NULL or &MCU_Configs, same as MCU_enuInit)
+ * Returns: MCU_Status_t indicating success or specific error condition
+ * Note: Flash wait states and the peripheral clocks are set at once, HSE and/or
+ *       the PLL are started but NOT waited for : the CPU keeps running from HSI
+ *       so GPIO, DMA and other independent driver inits can overlap the crystal
+ *       start-up and the PLL lock. Call MCU_enuPollInit() between those inits
+ *       until it returns MCU_OK, the clock tree is then the same as MCU_enuInit
+ *       Bus limits are checked as in MCU_enuInit
+ */
+MCU_Status_t MCU_enuFastStartInit(const MCU_Config_t *);
+
+/*
+ * Function: MCU_enuPollInit
+ * Description: Advances the fast-start clock sequence without blocking
+ * Returns: MCU_BOOT_PENDING  oscillator or PLL still stabilizing
+ *          MCU_OK            final clock tree applied (prescalers, SYSCLK, flash)
+ *          MCU_TIMEOUT       not ready within MCU_FAST_START_TIMEOUT_US, still on HSI
+ *          MCU_NOT_OK        MCU_enuFastStartInit was not called
+ */
+MCU_Status_t MCU_enuPollInit(void);
+
+/*
+ * Function: MCU_vdBootProfilerStart
+ * Description: Starts the DWT cycle counter and clears the boot report
+ * Note: Call it first thing in main, the time spent in the startup code before
+ *       main (.data/.bss init) is not measured
+ */
+void MCU_vdBootProfilerStart(void);
+
+/*
+ * Function: MCU_enuBootMark
+ * Description: Closes the current boot phase and gives it a name
+ * Parameters:
+ *   - phaseName: Name of the phase that just ended (string literal)
+ * Returns: MCU_OK, MCU_NOT_OK (profiler not started or NULL) or MCU_BOOT_REPORT_FULL
+ * Note: MCU_enuInit / MCU_enuFastStartInit / MCU_enuPollInit add their own marks
+ *       ("MCU ...") when MCU_BOOT_PROFILER is enabled
+ */
+MCU_Status_t MCU_enuBootMark(const char *phaseName);
+
+/*
+ * Function: MCU_enuGetBootReport
+ * Description: Returns the per-phase boot-time report
+ * Parameters:
+ *   - phases: Pointer set to the first phase of the report
+ *   - phaseCount: Pointer to store the number of phases
+ *   - totalMicroseconds: Pointer to store the sum of all phases
+ * Returns: MCU_OK or MCU_NOT_OK for a NULL pointer
+ */
+MCU_Status_t MCU_enuGetBootReport(const MCU_BootPhase_t **phases, uint8_t *phaseCount, uint32_t *totalMicroseconds);
+
+/*
+ * Function: MCU_GetClockHz
+ * Description: Returns the current clock frequency of a bus, read back from the clock tree
+ * Parameters:
+ *   - bus: MCU_AHB1_BUS, MCU_AHB2_BUS, MCU_APB1_BUS or MCU_APB2_BUS
+ *   - clockHz: Pointer to store the frequency in Hz
+ * Returns: MCU_Status_t indicating success or specific error condition
+ * Note: AHB buses return HCLK, which is also the CPU and SysTick clock
+ */
+MCU_Status_t MCU_GetClockHz(uint8_t bus, uint32_t *clockHz);
+
+/*
+ * Function: MCU_enuRegisterClockNotifier
+ * Description: Registers a driver callback to be notified around runtime clock changes
+ * Parameters:
+ *   - notifier: Callback receiving MCU_CLOCK_PRE_CHANGE / MCU_CLOCK_POST_CHANGE
+ *               (ex: UART_vdClockChangeNotifier, SPI_vdClockChangeNotifier)
+ * Returns: MCU_Status_t (MCU_OK, MCU_NOT_OK for NULL, MCU_CLOCK_NOTIFIERS_FULL)
+ * Note: Registering the same notifier twice has no effect
+ */
+MCU_Status_t MCU_enuRegisterClockNotifier(MCU_ClockNotifier_t notifier);
+
+/*
+ * Function: MCU_enuRegisterClockGuard
+ * Description: Registers a driver callback that can veto a runtime clock change
+ * Parameters:
+ *   - guard: Callback returning 1 while a transfer the driver cannot drain is running
+ *            (ex: UART_u8ClockChangeBusy for DMA transmissions)
+ * Returns: MCU_Status_t (MCU_OK, MCU_NOT_OK for NULL, MCU_CLOCK_NOTIFIERS_FULL)
+ * Note: Registering the same guard twice has no effect
+ */
+MCU_Status_t MCU_enuRegisterClockGuard(MCU_ClockGuard_t guard);
+
+/*
+ * Function: MCU_enuSetClockProfile
+ * Description: Switches the clock tree to a new operating point at runtime
+ * Parameters:
+ *   - profile: Pointer to the clock profile to apply
+ * Returns: MCU_Status_t indicating success or specific error condition
+ * Note: A profile putting PCLK1 above 42 MHz or PCLK2 above 84 MHz returns
+ *       MCU_WRONG_APB_PRESCALER before any notifier is called
+ *       Sequence:
+ *       1. Notifiers are called with MCU_CLOCK_PRE_CHANGE (drivers drain transfers)
+ *       2. With interrupts enabled: HSI/HSE are started, the PLL is re-solved and
+ *          re-locked. When SYSCLK runs from the PLL it first moves to HSI through
+ *          a complete notified switch, a running PLL cannot take new factors
+ *       3. Inside a critical section the guards are checked, MCU_CLOCK_BUSY is
+ *          returned and nothing is changed when one of them is still busy
+ *       4. Otherwise, still masked: flash latency, SYSCLK to HSI, prescalers,
+ *          SYSCLK to the target source (no oscillator wait is left inside)
+ *       5. Still inside the critical section, notifiers are called with
+ *          MCU_CLOCK_POST_CHANGE so every divider is re-timed before any ISR runs
+ *       6. The PLL is stopped when SYSCLK no longer runs from it
+ */
+MCU_Status_t MCU_enuSetClockProfile(const MCU_ClockProfile_t *profile);
+
+/*
+ * Function: MCU_enuSuspendClock
+ * Description: Records the running SYSCLK source (and PLL input) before STOP mode
+ * Returns: MCU_OK or the RCC error read back
+ * Note: STOP mode switches SYSCLK to HSI and turns HSE and the PLL off,
+ *       prescalers, PLL factors and flash wait states are kept
+ */
+MCU_Status_t MCU_enuSuspendClock(void);
+
+/*
+ * Function: MCU_enuResumeClock
+ * Description: Restores the clock source recorded by MCU_enuSuspendClock after STOP mode
+ * Returns: MCU_Status_t of the first failing step, MCU_OK otherwise
+ * Note: Same oscillator / PLL / SYSCLK sequence as MCU_enuInit with the PLL
+ *       factors still in PLLCFGR, HCLK ends at the pre-STOP value so no clock
+ *       notifier is called. Call it with interrupts masked, right after WFI
  */
-MCU_Status_t MCU_enuInit(MCU_Config_t *);
+MCU_Status_t MCU_enuResumeClock(void);
 
 #endif // MCU_H
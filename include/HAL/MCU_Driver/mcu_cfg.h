@@ -21,7 +21,16 @@
 */
 #define MCU_PLL_SOURCE     MCU_PLL_SOURCE_HSI
 
-/*  PLL Configuration Parameters */
+/*  The available values for MCU_PLL_FACTORS_MODE are 
+    *   MCU_PLL_AUTO_FACTORS     (M/N/P/Q are solved from MCU_PLL_TARGET_FREQUENCY)
+    *   MCU_PLL_MANUAL_FACTORS   (M/N/P/Q are taken from the parameters below)
+*/
+#define MCU_PLL_FACTORS_MODE     MCU_PLL_AUTO_FACTORS
+
+/*  Target system clock when MCU_PLL_AUTO_FACTORS is selected (max 84MHZ) */
+#define MCU_PLL_TARGET_FREQUENCY    (84000000UL)                     // 84MHZ
+
+/*  PLL Configuration Parameters (used with MCU_PLL_MANUAL_FACTORS) */
 #define MCU_PLL_M        (16UL)
 #define MCU_PLL_N        (336UL)
 #define MCU_PLL_P        (4UL)
@@ -46,6 +55,8 @@
     *   MCU_APB1_DIVIDED_BY_4
     *   MCU_APB1_DIVIDED_BY_8
     *   MCU_APB1_DIVIDED_BY_16
+    PCLK1 must stay at or below 42MHZ, divide by 2 when SYSCLK is above 42MHZ
+    (MCU_enuInit returns MCU_WRONG_APB_PRESCALER otherwise)
 */
 #define MCU_APB1_PRESCALER   MCU_APB1_NO_DIVISION
 
@@ -72,10 +83,10 @@
   *  MCU_AHB1_DMA1_CLOCK
   *  MCU_AHB1_DMA2_CLOCK 
 */
+/*  BOARD_AHB1_CLOCKS : the GPIO ports of the fitted pins (board_cfg.h) */
 #define MCU_AHB1_PERIPHERALS_ENABLE   \
     (                                 \
-      MCU_AHB1_GPIOB_CLOCK |          \
-      MCU_AHB1_GPIOA_CLOCK            \
+      BOARD_AHB1_CLOCKS               \
     )
 
         
@@ -129,4 +140,50 @@
       MCU_APB2_NO_PERIPHERAL            \
     )
 
+/*  The available values for MCU_FLASH_VOLTAGE_RANGE are 
+    *   MCU_FLASH_VOLTAGE_2V7_TO_3V6
+    *   MCU_FLASH_VOLTAGE_2V4_TO_2V7
+    *   MCU_FLASH_VOLTAGE_2V1_TO_2V4
+    *   MCU_FLASH_VOLTAGE_1V8_TO_2V1      (prefetch not allowed)
+*/
+#define MCU_FLASH_VOLTAGE_RANGE     MCU_FLASH_VOLTAGE_2V7_TO_3V6
+
+/*  The available values for MCU_FLASH_ACCELERATOR are 
+  --->> YOU CAN or more than value as this example
+    *   MCU_FLASH_NO_FEATURE
+    *   MCU_FLASH_PREFETCH_ENABLE
+    *   MCU_FLASH_ICACHE_ENABLE
+    *   MCU_FLASH_DCACHE_ENABLE
+*/
+#define MCU_FLASH_ACCELERATOR       \
+    (                               \
+      MCU_FLASH_PREFETCH_ENABLE |   \
+      MCU_FLASH_ICACHE_ENABLE   |   \
+      MCU_FLASH_DCACHE_ENABLE       \
+    )
+
+/*  Maximum number of drivers that can be notified on a runtime clock change
+    (see MCU_enuRegisterClockNotifier / MCU_enuSetClockProfile)
+*/
+#define MCU_MAX_CLOCK_NOTIFIERS         (8U)
+
+/*  Maximum number of drivers that can refuse a runtime clock change
+    (see MCU_enuRegisterClockGuard / MCU_enuSetClockProfile)
+*/
+#define MCU_MAX_CLOCK_GUARDS            (4U)
+
+/*  The available values for MCU_BOOT_PROFILER are 
+    *   MCU_BOOT_PROFILER_ENABLED     MCU init functions mark their own boot phases
+    *   MCU_BOOT_PROFILER_DISABLED
+*/
+#define MCU_BOOT_PROFILER               MCU_BOOT_PROFILER_DISABLED
+
+/*  Maximum number of phases kept in the boot report (see MCU_enuBootMark) */
+#define MCU_BOOT_MAX_PHASES             (16U)
+
+/*  Fast-start gives up on HSE start-up / PLL lock after this time
+    (see MCU_enuFastStartInit / MCU_enuPollInit)
+*/
+#define MCU_FAST_START_TIMEOUT_US       (100000UL)                       // 100ms
+
 #endif  // MCU_CFG_H - End of header guard
\ No newline at end of file
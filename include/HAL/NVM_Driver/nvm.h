@@ -0,0 +1,95 @@
+#ifndef NVM_H
+#define NVM_H
+
+#include "LIB/stdtypes.h"
+#include "HAL/NVM_Driver/nvm_cfg.h"
+
+/*
+ * Enumeration of possible return status codes for NVM functions
+ */
+typedef enum {
+    NVM_NOT_OK,                     /* General error or operation failed */
+    NVM_OK,                         /* Operation completed successfully */
+    NVM_NULL_PTR,                   /* Null pointer passed as parameter */
+    NVM_NOT_INIT,                   /* NVM_enuInit() was not called */
+    NVM_WRONG_KEY,                  /* Key above NVM_MAX_KEYS - 1 */
+    NVM_WRONG_SIZE,                 /* Value size 0 or above NVM_MAX_VALUE_SIZE */
+    NVM_KEY_NOT_FOUND,              /* No value stored for this key */
+    NVM_BUFFER_TOO_SMALL,           /* Stored value larger than the buffer (length is still returned) */
+    NVM_FULL,                       /* No room left even after compaction */
+    NVM_FLASH_ERROR,                /* Erase or program failed in the FLASH driver */
+}NVM_Status_t;
+
+/*
+ * Store statistics
+ */
+typedef struct {
+    uint32_t NVM_Generation;        /* Number of compactions since the first format (each erases one sector) */
+    uint32_t NVM_UsedBytes;         /* Bytes used in the active sector (live and stale records) */
+    uint32_t NVM_FreeBytes;         /* Bytes left before the next compaction */
+    uint32_t NVM_Keys;              /* Number of keys holding a value */
+}NVM_Stats_t;
+
+/*
+ * Function: NVM_enuInit
+ * Description: Finds the active sector, finishes an interrupted compaction and
+ *              builds the RAM index (key -> latest record) with one scan of the log
+ * Parameters: None (sectors from nvm_cfg.h)
+ * Returns: NVM_Status_t (NVM_OK, NVM_FLASH_ERROR)
+ * Note: Blank or foreign sectors are formatted
+ *       Call it once at boot, before any driver loads its configuration
+ */
+NVM_Status_t NVM_enuInit(void);
+
+/*
+ * Function: NVM_enuRead
+ * Description: Copies the value of a key, O(1) through the RAM index
+ * Parameters:
+ *   - key: 0 .. NVM_MAX_KEYS - 1
+ *   - buffer: Destination
+ *   - bufferSize: Size of the destination in bytes
+ *   - length: Pointer to store the value size in bytes
+ * Returns: NVM_Status_t (NVM_OK, NVM_NULL_PTR, NVM_NOT_INIT, NVM_WRONG_KEY,
+ *          NVM_KEY_NOT_FOUND, NVM_BUFFER_TOO_SMALL)
+ */
+NVM_Status_t NVM_enuRead(uint16_t key, void *buffer, uint16_t bufferSize, uint16_t *length);
+
+/*
+ * Function: NVM_enuWrite
+ * Description: Appends a new record for a key (the previous one becomes stale)
+ * Parameters:
+ *   - key: 0 .. NVM_MAX_KEYS - 1
+ *   - data: Value to store
+ *   - length: 1 .. NVM_MAX_VALUE_SIZE bytes
+ * Returns: NVM_Status_t (NVM_OK, NVM_NULL_PTR, NVM_NOT_INIT, NVM_WRONG_KEY,
+ *          NVM_WRONG_SIZE, NVM_FULL, NVM_FLASH_ERROR)
+ * Note: Writing the value already stored does nothing (no flash wear)
+ *       When the active sector is full the live records are copied to the
+ *       other sector first (compaction : one sector erase, ~250 ms)
+ *       Power loss at any point keeps either the old or the new value
+ */
+NVM_Status_t NVM_enuWrite(uint16_t key, const void *data, uint16_t length);
+
+/*
+ * Function: NVM_enuDelete
+ * Description: Removes the value of a key (tombstone record, dropped at compaction)
+ * Returns: NVM_Status_t (NVM_OK, NVM_NOT_INIT, NVM_WRONG_KEY, NVM_KEY_NOT_FOUND,
+ *          NVM_FULL, NVM_FLASH_ERROR)
+ */
+NVM_Status_t NVM_enuDelete(uint16_t key);
+
+/*
+ * Function: NVM_enuGetStats
+ * Description: Returns the generation and the fill level of the store
+ * Returns: NVM_Status_t (NVM_OK, NVM_NULL_PTR, NVM_NOT_INIT)
+ */
+NVM_Status_t NVM_enuGetStats(NVM_Stats_t *stats);
+
+/*
+ * Function: NVM_enuFormat
+ * Description: Erases both sectors and starts an empty store
+ * Returns: NVM_Status_t (NVM_OK, NVM_FLASH_ERROR)
+ */
+NVM_Status_t NVM_enuFormat(void);
+
+#endif /* NVM_H */
@@ -0,0 +1,16 @@
+#ifndef NVM_CFG_H
+#define NVM_CFG_H
+
+/*  Flash sectors holding the store (NVM_FLASH region of the linker script)
+    Two sectors of the same size, the store alternates between them */
+#define NVM_SECTOR_A            (2U)
+#define NVM_SECTOR_B            (3U)
+
+/*  Number of keys : valid keys are 0 .. NVM_MAX_KEYS - 1
+    The RAM index takes 4 bytes per key */
+#define NVM_MAX_KEYS            (32U)
+
+/*  Largest value in bytes (multiple of 4, sizes the record buffer on the stack) */
+#define NVM_MAX_VALUE_SIZE      (128U)
+
+#endif /* NVM_CFG_H */
@@ -0,0 +1,120 @@
+#ifndef SD_H
+#define SD_H
+
+#include "LIB/stdtypes.h"
+
+#define SD_BLOCK_SIZE               (512UL)
+
+/*
+ * Enumeration of possible return status codes for SD functions
+ */
+typedef enum {
+    SD_NOT_OK,                      /* General error or operation failed */
+    SD_OK,                          /* Operation completed successfully */
+    SD_NULL_PTR,                    /* Null pointer passed as parameter */
+    SD_NOT_INIT,                    /* SD_enuInit() was not called or failed */
+    SD_BUSY,                        /* Stream block or stop token still in progress */
+    SD_WRONG_STATE,                 /* Call not allowed in the current stream state */
+    SD_NO_CARD,                     /* No answer to CMD0 */
+    SD_UNSUPPORTED_CARD,            /* Wrong CMD8 echo or voltage range */
+    SD_TIMEOUT,                     /* Card still busy or idle after the configured retries */
+    SD_COMMAND_ERROR,               /* R1 response with an error bit */
+    SD_DATA_ERROR,                  /* Read error token or write rejected by the card */
+    SD_SPI_ERROR,                   /* SPI driver refused the configuration */
+    SD_DMA_ERROR,                   /* DMA driver refused the configuration */
+}SD_Status_t;
+
+/*
+ * Card identified by SD_enuInit
+ */
+typedef enum {
+    SD_CARD_NONE,                   /* Not identified */
+    SD_CARD_V1,                     /* SD version 1.x, byte addressed */
+    SD_CARD_V2_SC,                  /* SD version 2.0 standard capacity, byte addressed */
+    SD_CARD_V2_HC,                  /* SDHC / SDXC, block addressed */
+}SD_CardType_t;
+
+/*
+ * Function: SD_enuInit
+ * Description: Identifies the card at SD_INIT_SCK_HZ (CMD0, CMD8, ACMD41, CMD58),
+ *              then sets the block length and moves SPI to SD_DATA_SCK_HZ
+ * Parameters: None (SPI, chip select and DMA streams from sd_cfg.h)
+ * Returns: SD_Status_t (SD_OK, SD_NO_CARD, SD_UNSUPPORTED_CARD, SD_TIMEOUT,
+ *          SD_COMMAND_ERROR, SD_SPI_ERROR, SD_DMA_ERROR)
+ * Note: Blocks up to ~1 s (ACMD41 loop), call it at boot before the scheduler
+ */
+SD_Status_t SD_enuInit(void);
+
+/*
+ * Function: SD_enuGetCardType
+ * Description: Returns the card version found by SD_enuInit
+ */
+SD_Status_t SD_enuGetCardType(SD_CardType_t *type);
+
+/*
+ * Function: SD_enuReadBlock
+ * Description: Reads one 512-byte block (CMD17), the data phase by DMA
+ * Parameters:
+ *   - block: Block number (converted to a byte address on SDSC cards)
+ *   - buffer: SD_BLOCK_SIZE bytes
+ * Returns: SD_Status_t (SD_OK, SD_NULL_PTR, SD_NOT_INIT, SD_WRONG_STATE,
+ *          SD_COMMAND_ERROR, SD_DATA_ERROR, SD_TIMEOUT)
+ * Note: Blocking, not allowed while a stream is open
+ */
+SD_Status_t SD_enuReadBlock(uint32_t block, uint8_t *buffer);
+
+/*
+ * Function: SD_enuWriteBlock
+ * Description: Writes one 512-byte block (CMD24) and waits for the end of programming
+ * Returns: SD_Status_t (SD_OK, SD_NULL_PTR, SD_NOT_INIT, SD_WRONG_STATE,
+ *          SD_COMMAND_ERROR, SD_DATA_ERROR, SD_TIMEOUT)
+ * Note: Blocking (up to 250 ms of card busy), not allowed while a stream is open
+ */
+SD_Status_t SD_enuWriteBlock(uint32_t block, const uint8_t *buffer);
+
+/*
+ * Function: SD_enuStreamOpen
+ * Description: Starts a multi-block write at firstBlock (CMD25), after announcing
+ *              the number of blocks to pre-erase (ACMD23)
+ * Parameters:
+ *   - firstBlock: First block written
+ *   - eraseCount: Blocks the card may erase ahead (1 .. 0x7FFFFF), only a hint :
+ *                 the stream may stop before or go past it
+ * Returns: SD_Status_t (SD_OK, SD_NOT_INIT, SD_WRONG_STATE, SD_COMMAND_ERROR, SD_TIMEOUT)
+ * Note: The chip select stays low until SD_enuStreamClose finished
+ */
+SD_Status_t SD_enuStreamOpen(uint32_t firstBlock, uint32_t eraseCount);
+
+/*
+ * Function: SD_enuStreamWrite
+ * Description: Sends the start token and starts the DMA of one block of the stream
+ * Parameters:
+ *   - buffer: SD_BLOCK_SIZE bytes, must stay untouched until SD_enuStreamPoll returns SD_OK
+ * Returns: SD_Status_t (SD_OK = block started, SD_BUSY = previous block or card
+ *          busy, nothing done, SD_NULL_PTR, SD_WRONG_STATE)
+ * Note: Never waits : returns after one token byte
+ */
+SD_Status_t SD_enuStreamWrite(const uint8_t *buffer);
+
+/*
+ * Function: SD_enuStreamPoll
+ * Description: Advances the stream : one busy byte per call until the card
+ *              programmed the block (the CRC and the data response are sent from
+ *              the DMA interrupt)
+ * Returns: SD_Status_t (SD_OK = ready for the next block or stream closed,
+ *          SD_BUSY, SD_DATA_ERROR = block rejected, the stream is being closed :
+ *          SD_BUSY then SD_OK follow, SD_NOT_INIT)
+ * Note: Each call clocks at most 2 bytes, call it from a periodic runnable
+ */
+SD_Status_t SD_enuStreamPoll(void);
+
+/*
+ * Function: SD_enuStreamClose
+ * Description: Sends the stop token, SD_enuStreamPoll returns SD_OK once the card
+ *              finished programming and the chip select is released
+ * Returns: SD_Status_t (SD_OK, SD_BUSY = last block not finished, call it again,
+ *          SD_WRONG_STATE = no stream open)
+ */
+SD_Status_t SD_enuStreamClose(void);
+
+#endif /* SD_H */
@@ -0,0 +1,35 @@
+#ifndef SD_CFG_H
+#define SD_CFG_H
+
+/*  Card on SPI1 (PA5 SCK, PA6 MISO, PA7 MOSI) with a software chip select
+    on port A (clocked with the SPI1 pins by SPI_enuInit)
+    The DMA streams below are the SPI1 ones : another SPI needs other streams */
+#define SD_SPI_NUMBER           SPI1
+#define SD_CS_PORT              GPIO_PORT_A
+#define SD_CS_PIN               GPIO_PIN_4
+
+/*  SCK during the card identification (the card accepts 100 - 400 kHz)
+    and after it (25 MHz max in default speed : 21 MHz from an 84 MHz PCLK2) */
+#define SD_INIT_SCK_HZ          (400000UL)
+#define SD_DATA_SCK_HZ          (25000000UL)
+
+/*  DMA2 streams of SPI1 (channel 3)
+    *   RX : stream 2 (also USART6 RX) or stream 0 (taken by the ADC)
+    *   TX : stream 3 or stream 5 (taken by HSERIAL UART1 RX) */
+#define SD_DMA_RX_STREAM        DMA_STREAM2
+#define SD_DMA_TX_STREAM        DMA_STREAM3
+#define SD_DMA_RX_IRQ           NVIC_DMA2_STREAM2_IRQ
+#define SD_DMA_TX_IRQ           NVIC_DMA2_STREAM3_IRQ
+
+/*  NVIC priority of the two DMA interrupts (they only set a flag) */
+#define SD_INTERRUPT_PRIORITY   NVIC_PRIORITY_5
+
+/*  ACMD41 attempts while the card leaves the idle state
+    one attempt is ~16 bytes at SD_INIT_SCK_HZ (~0.3 ms), the card needs up to 1 s */
+#define SD_INIT_RETRIES         (4000UL)
+
+/*  Bytes clocked while waiting for the card in the blocking calls
+    (read token, busy after a single block write) : ~250 ms at SD_DATA_SCK_HZ */
+#define SD_WAIT_BYTES           (800000UL)
+
+#endif /* SD_CFG_H */
@@ -0,0 +1,111 @@
+/*****************************************************
+ * File: bench.h
+ * Description: Microbenchmark harness
+ *              Target : DWT cycle counter, results in cycles
+ *              Host   : clock_gettime(CLOCK_MONOTONIC), results in ns
+ *****************************************************/
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include "LIB/stdtypes.h"
+#include "LIB/bench_cfg.h"
+
+/*
+ * Enumeration of possible return status codes for BENCH functions
+ */
+typedef enum {
+    BENCH_NOT_OK,                   /* General error or operation failed */
+    BENCH_OK,                       /* Operation completed successfully */
+    BENCH_NULL_PTR,                 /* Null pointer passed as parameter */
+    BENCH_NOT_INIT,                 /* BENCH_enuInit() was not called */
+    BENCH_WRONG_REPETITIONS,        /* 0 or above BENCH_MAX_REPETITIONS */
+}BENCH_Status_t;
+
+typedef void (*BENCH_Function_t)(void *args);
+
+/* Receives one report line (CSV, newline terminated) */
+typedef void (*BENCH_Output_t)(const uint8_t *line, uint16_t length);
+
+/*
+ * One benchmark case, declared with BENCH_CASE
+ */
+typedef struct {
+    const char *BENCH_Name;
+    BENCH_Function_t BENCH_Setup;   /* Called once before the warm-up, may be NULL */
+    BENCH_Function_t BENCH_Body;    /* Code measured, once per repetition */
+    void *BENCH_Args;               /* Passed to Setup and Body */
+    uint16_t BENCH_Warmup;          /* Unmeasured calls first (caches, flash prefetch, lazy init) */
+    uint16_t BENCH_Repetitions;     /* Measured calls, 1 .. BENCH_MAX_REPETITIONS */
+}BENCH_Case_t;
+
+/*
+ * Statistics of one case, in cycles (target) or ns (host), overhead removed
+ */
+typedef struct {
+    uint32_t BENCH_Min;
+    uint32_t BENCH_Median;
+    uint32_t BENCH_P99;
+    uint32_t BENCH_Max;
+    uint16_t BENCH_Repetitions;
+}BENCH_Result_t;
+
+/*
+ * Declares a case named after its identifier, for a table of BENCH_Case_t pointers
+ *   BENCH_CASE(gpio_set_pin, benchGpioSet, NULL, NULL, 16, 256);
+ */
+#define BENCH_CASE(name, body, setup, args, warmup, repetitions) \
+    const BENCH_Case_t name = { #name, (setup), (body), (args), (warmup), (repetitions) }
+
+/*
+ * Function: BENCH_enuInit
+ * Description: Starts the time base and measures the overhead of an empty case
+ * Returns: BENCH_Status_t (BENCH_OK)
+ * Note: Target : enables DWT CYCCNT, call it after MCU_enuInit (the clock
+ *       seen by the cycle counter)
+ */
+BENCH_Status_t BENCH_enuInit(void);
+
+/*
+ * Function: BENCH_enuRun
+ * Description: Setup, warm-up, then one timestamp pair per repetition,
+ *              the samples sorted for the statistics
+ * Parameters:
+ *   - benchCase: Case to run
+ *   - result: Pointer to store the statistics
+ * Returns: BENCH_Status_t (BENCH_OK, BENCH_NULL_PTR, BENCH_NOT_INIT, BENCH_WRONG_REPETITIONS)
+ * Note: Interrupts stay enabled : what they steal shows in P99 and Max, not in Min
+ */
+BENCH_Status_t BENCH_enuRun(const BENCH_Case_t *benchCase, BENCH_Result_t *result);
+
+/*
+ * Function: BENCH_enuRunAll
+ * Description: Runs every case and sends one CSV line per case to output,
+ *              after the header line
+ *   name,unit,reps,min,median,p99,max
+ *   gpio_set_pin,cycles,256,41,41,44,212
+ * Returns: BENCH_Status_t (BENCH_OK, BENCH_NULL_PTR, or the status of the
+ *          first case that failed, its line is skipped)
+ * Note: output is called between cases, never inside a measurement
+ */
+BENCH_Status_t BENCH_enuRunAll(const BENCH_Case_t *const *cases, uint16_t count, BENCH_Output_t output);
+
+/*
+ * Function: BENCH_u32Start
+ * Description: Timestamp opening a one-shot measurement, for code that cannot
+ *              run as a repeated BENCH_Case_t (a transfer, an init sequence)
+ * Returns: Cycle counter (target) or monotonic ns (host)
+ * Note: The time base is started by BENCH_enuInit
+ */
+uint32_t BENCH_u32Start(void);
+
+/*
+ * Function: BENCH_u32Stop
+ * Description: Time elapsed since a BENCH_u32Start timestamp
+ * Returns: Cycles (target) or ns (host), one wrap of the time base handled
+ * Note: Nothing is taken off : the pair costs a few cycles, negligible
+ *       against what a one-shot measurement times
+ */
+uint32_t BENCH_u32Stop(uint32_t start);
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,19 @@
+/*****************************************************
+ * File: bench_cfg.h
+ * Description: Microbenchmark harness configuration
+ *****************************************************/
+
+#ifndef BENCH_CFG_H_
+#define BENCH_CFG_H_
+
+/*  Most repetitions of one case (one uint32_t per repetition kept for the sort) */
+#define BENCH_MAX_REPETITIONS       (256U)
+
+/*  Runs of the empty case measured by BENCH_enuInit, the smallest is the
+    timer and call overhead taken off every sample */
+#define BENCH_CALIBRATION_RUNS      (32U)
+
+/*  Longest report line, the terminating newline included */
+#define BENCH_LINE_SIZE             (96U)
+
+#endif /* BENCH_CFG_H_ */
@@ -0,0 +1,161 @@
+/*****************************************************
+ * File: bits.h
+ * Description: Bit-manipulation and saturating arithmetic helpers
+ *              Cortex-M4 instructions (CLZ, RBIT, REV, REV16, QADD, QSUB)
+ *              when the compiler targets ARMv7-M, GCC builtins or plain C
+ *              otherwise (host builds, unit checks). Build with
+ *              -DBITS_PORTABLE to force the host path on target (cycle
+ *              comparison). Results are the same on both paths, including
+ *              for a zero input (CLZ / CTZ of 0 is 32).
+ *****************************************************/
+
+#ifndef BITS_H_
+#define BITS_H_
+
+#include "LIB/stdtypes.h"
+
+#if (defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)) && !defined(BITS_PORTABLE)
+#define BITS_TARGET
+#endif
+
+/* Bit n of a 32-bit word */
+#define BITS_MASK(n)                (1UL << (uint32_t)(n))
+
+/*
+ * Function: BITS_u32Clz
+ * Description: Number of leading zero bits, 32 for 0 (CLZ on target)
+ */
+static inline uint32_t BITS_u32Clz(uint32_t value){
+#if defined(BITS_TARGET)
+    uint32_t result;
+    __asm ("CLZ %0, %1" : "=r" (result) : "r" (value));
+    return result;
+#else
+    return (0U == value) ? 32U : (uint32_t)__builtin_clz(value);
+#endif
+}
+
+/*
+ * Function: BITS_u32Rbit
+ * Description: Reverses the bit order of a word, bit 0 to bit 31 (RBIT on target)
+ */
+static inline uint32_t BITS_u32Rbit(uint32_t value){
+#if defined(BITS_TARGET)
+    uint32_t result;
+    __asm ("RBIT %0, %1" : "=r" (result) : "r" (value));
+    return result;
+#else
+    value = ((value >> 1) & 0x55555555UL) | ((value & 0x55555555UL) << 1);
+    value = ((value >> 2) & 0x33333333UL) | ((value & 0x33333333UL) << 2);
+    value = ((value >> 4) & 0x0F0F0F0FUL) | ((value & 0x0F0F0F0FUL) << 4);
+    value = ((value >> 8) & 0x00FF00FFUL) | ((value & 0x00FF00FFUL) << 8);
+    return (value >> 16) | (value << 16);
+#endif
+}
+
+/*
+ * Function: BITS_u32Ctz
+ * Description: Number of trailing zero bits, 32 for 0 (RBIT + CLZ on target)
+ *              Index of the lowest set bit when value != 0
+ */
+static inline uint32_t BITS_u32Ctz(uint32_t value){
+#if defined(BITS_TARGET)
+    return BITS_u32Clz(BITS_u32Rbit(value));
+#else
+    return (0U == value) ? 32U : (uint32_t)__builtin_ctz(value);
+#endif
+}
+
+/*
+ * Function: BITS_u32Rev
+ * Description: Reverses the byte order of a word (REV on target)
+ */
+static inline uint32_t BITS_u32Rev(uint32_t value){
+#if defined(BITS_TARGET)
+    uint32_t result;
+    __asm ("REV %0, %1" : "=r" (result) : "r" (value));
+    return result;
+#else
+    return __builtin_bswap32(value);
+#endif
+}
+
+/*
+ * Function: BITS_u32Rev16
+ * Description: Reverses the byte order of each half-word (REV16 on target)
+ */
+static inline uint32_t BITS_u32Rev16(uint32_t value){
+#if defined(BITS_TARGET)
+    uint32_t result;
+    __asm ("REV16 %0, %1" : "=r" (result) : "r" (value));
+    return result;
+#else
+    return ((value >> 8) & 0x00FF00FFUL) | ((value & 0x00FF00FFUL) << 8);
+#endif
+}
+
+/*
+ * Function: BITS_u32Popcount
+ * Description: Number of set bits
+ *              No Cortex-M4 instruction : parallel sums on target, where
+ *              __builtin_popcount would call the libgcc loop
+ */
+static inline uint32_t BITS_u32Popcount(uint32_t value){
+#if defined(BITS_TARGET)
+    value = value - ((value >> 1) & 0x55555555UL);
+    value = (value & 0x33333333UL) + ((value >> 2) & 0x33333333UL);
+    value = (value + (value >> 4)) & 0x0F0F0F0FUL;
+    return (value * 0x01010101UL) >> 24;
+#else
+    return (uint32_t)__builtin_popcount(value);
+#endif
+}
+
+/*
+ * Function: BITS_u32AddSat / BITS_u32SubSat
+ * Description: Unsigned add / subtract clamped to 0 .. 0xFFFFFFFF
+ *              (ADDS / SUBS and a conditional move, the M4 has no 32-bit UQADD)
+ */
+static inline uint32_t BITS_u32AddSat(uint32_t a, uint32_t b){
+    uint32_t sum = a + b;
+    return (sum < a) ? 0xFFFFFFFFUL : sum;
+}
+
+static inline uint32_t BITS_u32SubSat(uint32_t a, uint32_t b){
+    return (a > b) ? (a - b) : 0U;
+}
+
+/*
+ * Function: BITS_s32AddSat / BITS_s32SubSat
+ * Description: Signed add / subtract clamped to the sint32_t range
+ *              (QADD / QSUB when the DSP extension is there)
+ */
+static inline sint32_t BITS_s32AddSat(sint32_t a, sint32_t b){
+#if defined(BITS_TARGET) && defined(__ARM_FEATURE_DSP)
+    sint32_t result;
+    __asm ("QADD %0, %1, %2" : "=r" (result) : "r" (a), "r" (b));
+    return result;
+#else
+    sint32_t result;
+    if(__builtin_add_overflow(a, b, &result)){
+        result = (a < 0) ? (-2147483647 - 1) : 2147483647;
+    }
+    return result;
+#endif
+}
+
+static inline sint32_t BITS_s32SubSat(sint32_t a, sint32_t b){
+#if defined(BITS_TARGET) && defined(__ARM_FEATURE_DSP)
+    sint32_t result;
+    __asm ("QSUB %0, %1, %2" : "=r" (result) : "r" (a), "r" (b));
+    return result;
+#else
+    sint32_t result;
+    if(__builtin_sub_overflow(a, b, &result)){
+        result = (a < 0) ? (-2147483647 - 1) : 2147483647;
+    }
+    return result;
+#endif
+}
+
+#endif /* BITS_H_ */
@@ -0,0 +1,207 @@
+/*****************************************************
+ * File: dsp.h
+ * Description: Fixed-point Q15 / Q31 filters and vector kernels
+ *              Cortex-M4 DSP instructions (SMLALD, QADD16, SSAT) when the
+ *              compiler targets them (__ARM_FEATURE_DSP), bit-exact portable
+ *              C otherwise. Build with -DDSP_PORTABLE to force the C path on
+ *              target (cycle comparison).
+ *****************************************************/
+
+#ifndef DSP_H_
+#define DSP_H_
+
+#include "LIB/stdtypes.h"
+
+/* Q15 : sint16_t, value / 32768, Q31 : sint32_t, value / 2^31 */
+#define DSP_Q15_MAX                 (32767)
+#define DSP_Q15_MIN                 (-32768)
+#define DSP_Q31_MAX                 (2147483647L)
+#define DSP_Q31_MIN                 (-2147483647L - 1L)
+
+/* Biquad stage sizes : coefficients { b0, b1, b2, a1, a2 } and state { x1, x2, y1, y2 } */
+#define DSP_BIQUAD_COEFFS           (5U)
+#define DSP_BIQUAD_STATE            (4U)
+
+/*
+ * Enumeration of possible return status codes for DSP functions
+ */
+typedef enum {
+    DSP_NOT_OK,                     /* General error or operation failed */
+    DSP_OK,                         /* Operation completed successfully */
+    DSP_NULL_PTR,                   /* Null pointer passed as parameter */
+    DSP_WRONG_LENGTH,               /* Taps, stages or length out of range */
+}DSP_Status_t;
+
+/*
+ * FIR filter Q15, y[n] = sum h[k] x[n-k], 64-bit accumulator
+ */
+typedef struct {
+    const sint16_t *DSP_Coeffs;     /* Taps coefficients, time reversed : h[Taps-1] first */
+    sint16_t *DSP_State;            /* 2 * Taps samples (delay line kept twice, no wrap in the loop) */
+    uint16_t DSP_Taps;
+    uint16_t DSP_Index;
+}DSP_FirQ15_t;
+
+/*
+ * FIR filter Q31, same layout as DSP_FirQ15_t
+ */
+typedef struct {
+    const sint32_t *DSP_Coeffs;     /* Taps coefficients, time reversed */
+    sint32_t *DSP_State;            /* 2 * Taps samples */
+    uint16_t DSP_Taps;
+    uint16_t DSP_Index;
+}DSP_FirQ31_t;
+
+/*
+ * Biquad cascade Q15, direct form I
+ * y = (b0 x + b1 x1 + b2 x2 + a1 y1 + a2 y2) << PostShift
+ * a1 and a2 are stored negated (the sum uses +), coefficients in Q(15 - PostShift)
+ */
+typedef struct {
+    const sint16_t *DSP_Coeffs;     /* DSP_BIQUAD_COEFFS per stage */
+    sint16_t *DSP_State;            /* DSP_BIQUAD_STATE per stage */
+    uint8_t DSP_Stages;
+    uint8_t DSP_PostShift;          /* 0 .. 14, 1 for coefficients up to +-2 */
+}DSP_BiquadQ15_t;
+
+/*
+ * Biquad cascade Q31, direct form I, same layout in 32-bit words
+ */
+typedef struct {
+    const sint32_t *DSP_Coeffs;     /* DSP_BIQUAD_COEFFS per stage, Q(31 - PostShift) */
+    sint32_t *DSP_State;            /* DSP_BIQUAD_STATE per stage */
+    uint8_t DSP_Stages;
+    uint8_t DSP_PostShift;          /* 0 .. 30 */
+}DSP_BiquadQ31_t;
+
+/*
+ * Moving average Q15 over 2^Shift samples, running sum
+ */
+typedef struct {
+    sint16_t *DSP_Buffer;           /* 2^Shift samples */
+    sint32_t DSP_Sum;
+    uint16_t DSP_Index;
+    uint8_t DSP_Shift;              /* 0 .. 15 */
+}DSP_MovingAverageQ15_t;
+
+/*
+ * Function: DSP_s16SaturateQ15
+ * Description: Clamps a 32-bit value to the Q15 range (SSAT on target)
+ */
+static inline sint16_t DSP_s16SaturateQ15(sint32_t value){
+#if defined(__ARM_FEATURE_DSP) && !defined(DSP_PORTABLE)
+    sint32_t result;
+    __asm ("SSAT %0, #16, %1" : "=r" (result) : "r" (value));
+    return (sint16_t)result;
+#else
+    return (sint16_t)((value > DSP_Q15_MAX) ? DSP_Q15_MAX : ((value < DSP_Q15_MIN) ? DSP_Q15_MIN : value));
+#endif
+}
+
+/*
+ * Function: DSP_s32SaturateQ31
+ * Description: Clamps a 64-bit value to the Q31 range
+ */
+static inline sint32_t DSP_s32SaturateQ31(sint64_t value){
+    return (sint32_t)((value > DSP_Q31_MAX) ? DSP_Q31_MAX : ((value < DSP_Q31_MIN) ? DSP_Q31_MIN : value));
+}
+
+/*
+ * Function: DSP_enuFirInitQ15 / DSP_enuFirInitQ31
+ * Description: Binds the coefficients and the delay line, clears the delay line
+ * Parameters:
+ *   - fir: Filter instance
+ *   - coeffs: taps coefficients, time reversed
+ *   - state: 2 * taps samples
+ *   - taps: 1 .. 32767
+ * Returns: DSP_Status_t (DSP_OK, DSP_NULL_PTR, DSP_WRONG_LENGTH)
+ */
+DSP_Status_t DSP_enuFirInitQ15(DSP_FirQ15_t *fir, const sint16_t *coeffs, sint16_t *state, uint16_t taps);
+DSP_Status_t DSP_enuFirInitQ31(DSP_FirQ31_t *fir, const sint32_t *coeffs, sint32_t *state, uint16_t taps);
+
+/*
+ * Function: DSP_vdFirQ15 / DSP_vdFirQ31
+ * Description: Filters count samples, output saturated
+ * Parameters:
+ *   - fir: Filter from DSP_enuFirInitQ15 / Q31
+ *   - input, output: count samples (may be the same buffer)
+ * Note: Q15 : two taps per SMLALD on target
+ */
+void DSP_vdFirQ15(DSP_FirQ15_t *fir, const sint16_t *input, sint16_t *output, uint32_t count);
+void DSP_vdFirQ31(DSP_FirQ31_t *fir, const sint32_t *input, sint32_t *output, uint32_t count);
+
+/*
+ * Function: DSP_enuBiquadInitQ15 / DSP_enuBiquadInitQ31
+ * Description: Binds the coefficients and the state of a cascade, clears the state
+ * Returns: DSP_Status_t (DSP_OK, DSP_NULL_PTR, DSP_WRONG_LENGTH = no stage or PostShift too large)
+ */
+DSP_Status_t DSP_enuBiquadInitQ15(DSP_BiquadQ15_t *biquad, const sint16_t *coeffs, sint16_t *state,
+                                  uint8_t stages, uint8_t postShift);
+DSP_Status_t DSP_enuBiquadInitQ31(DSP_BiquadQ31_t *biquad, const sint32_t *coeffs, sint32_t *state,
+                                  uint8_t stages, uint8_t postShift);
+
+/*
+ * Function: DSP_vdBiquadQ15 / DSP_vdBiquadQ31
+ * Description: Filters count samples through every stage, output of each stage saturated
+ * Note: Q15 : b1/b2 and a1/a2 paired in one SMLALD each on target
+ */
+void DSP_vdBiquadQ15(DSP_BiquadQ15_t *biquad, const sint16_t *input, sint16_t *output, uint32_t count);
+void DSP_vdBiquadQ31(DSP_BiquadQ31_t *biquad, const sint32_t *input, sint32_t *output, uint32_t count);
+
+/*
+ * Function: DSP_enuMovingAverageInitQ15
+ * Description: Binds and clears a 2^shift sample window
+ * Returns: DSP_Status_t (DSP_OK, DSP_NULL_PTR, DSP_WRONG_LENGTH = shift above 15)
+ */
+DSP_Status_t DSP_enuMovingAverageInitQ15(DSP_MovingAverageQ15_t *average, sint16_t *buffer, uint8_t shift);
+
+/*
+ * Function: DSP_vdMovingAverageQ15
+ * Description: Average of the last 2^Shift samples for each input, rounded down
+ * Note: One add, one subtract and one shift per sample whatever the window
+ */
+void DSP_vdMovingAverageQ15(DSP_MovingAverageQ15_t *average, const sint16_t *input, sint16_t *output, uint32_t count);
+
+/*
+ * Function: DSP_s64DotQ15
+ * Description: Sum of a[i] * b[i] in Q30, 64-bit (no overflow below 2^33 terms)
+ * Note: Two products per SMLALD on target
+ */
+sint64_t DSP_s64DotQ15(const sint16_t *a, const sint16_t *b, uint32_t count);
+
+/*
+ * Function: DSP_s64DotQ31
+ * Description: Sum of a[i] * b[i] in Q62, 64-bit, wraps past 2 terms of full scale
+ *              (scale the inputs down for long vectors)
+ */
+sint64_t DSP_s64DotQ31(const sint32_t *a, const sint32_t *b, uint32_t count);
+
+/*
+ * Function: DSP_vdAddQ15
+ * Description: output[i] = saturate(a[i] + b[i])
+ * Note: Two samples per QADD16 on target
+ */
+void DSP_vdAddQ15(const sint16_t *a, const sint16_t *b, sint16_t *output, uint32_t count);
+
+/*
+ * Function: DSP_vdScaleQ15
+ * Description: output[i] = saturate((input[i] * scale) >> (15 - shift))
+ * Parameters:
+ *   - scale: Q15 factor
+ *   - shift: Extra left shift 0 .. 15 (gain up to 2^shift)
+ */
+void DSP_vdScaleQ15(const sint16_t *input, sint16_t scale, uint8_t shift, sint16_t *output, uint32_t count);
+
+/*
+ * Function: DSP_vdScaleQ31
+ * Description: output[i] = saturate((input[i] * scale) >> (31 - shift)), shift 0 .. 31
+ */
+void DSP_vdScaleQ31(const sint32_t *input, sint32_t scale, uint8_t shift, sint32_t *output, uint32_t count);
+
+/*
+ * Function: DSP_vdQ31ToQ15
+ * Description: output[i] = input[i] >> 16 rounded to nearest, saturated
+ */
+void DSP_vdQ31ToQ15(const sint32_t *input, sint16_t *output, uint32_t count);
+
+#endif /* DSP_H_ */
@@ -0,0 +1,47 @@
+/*****************************************************
+ * File: dwt.h
+ * Description: DWT cycle counter of the Cortex-M4 core debug block
+ *              CYCCNT counts HCLK cycles and wraps at 2^32 : the unsigned
+ *              difference of two reads is right across one wrap
+ *              Shared by the drivers, services and tests that timestamp
+ *              with it (one counter, enabled by whoever needs it first)
+ *****************************************************/
+
+#ifndef DWT_H_
+#define DWT_H_
+
+#include "LIB/stdtypes.h"
+
+/* Debug Exception and Monitor Control, DWT Control, DWT cycle count */
+#define DWT_DEMCR                   (*(volatile uint32_t *)0xE000EDFCUL)
+#define DWT_CTRL                    (*(volatile uint32_t *)0xE0001000UL)
+#define DWT_CYCCNT                  (*(volatile uint32_t *)0xE0001004UL)
+
+/* TRCENA (DEMCR bit 24) powers the DWT / ITM blocks, CYCCNTENA (CTRL bit 0) runs the counter */
+#define DWT_DEMCR_TRCENA            (0x01000000UL)
+#define DWT_CTRL_CYCCNTENA          (0x00000001UL)
+
+/*
+ * Function: DWT_vdStart
+ * Description: Starts CYCCNT from 0 when it is stopped, a running count is kept
+ *              so another user's timestamps stay valid
+ */
+static inline void DWT_vdStart(void){
+    if (0UL == (DWT_CTRL & DWT_CTRL_CYCCNTENA)) {
+        DWT_DEMCR |= DWT_DEMCR_TRCENA;
+        DWT_CYCCNT = 0UL;
+        DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+    }
+}
+
+/*
+ * Function: DWT_vdRestart
+ * Description: Starts CYCCNT from 0 whatever its state (boot profiler time base)
+ */
+static inline void DWT_vdRestart(void){
+    DWT_DEMCR |= DWT_DEMCR_TRCENA;
+    DWT_CYCCNT = 0UL;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+}
+
+#endif /* DWT_H_ */
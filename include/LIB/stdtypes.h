@@ -34,5 +34,14 @@ typedef enum {
 #define NULL ((void*)0)
 #endif
 
+/* Function executed from RAM (.ramfunc section, see CustomLinkerScript.ld)
+   For ISRs and hot paths : no flash wait states, no ART cache misses
+   Build with -DRAMFUNC_DISABLE to keep everything in flash (latency comparison) */
+#ifndef RAMFUNC_DISABLE
+#define RAMFUNC     __attribute__((section(".ramfunc"), noinline))
+#else
+#define RAMFUNC
+#endif
+
 #endif /* STDTYPES_H_ */
 
@@ -0,0 +1,186 @@
+/******************************************************************************
+ * @file    ADC.H
+ * @author  Eng.Gemy
+ * @brief   ADC Driver Header File
+ *          ADC1 scan sequences triggered by TIM2, samples moved by circular
+ *          DMA (DMA2 stream 0) into a buffer split in two blocks
+ * @note    The CPU only runs once per completed block (half-transfer and
+ *          transfer-complete of the DMA), never per conversion.
+ *          The block callback may read its block until the DMA comes back
+ *          to it, one block time later
+ ******************************************************************************/
+
+#ifndef ADC_H
+#define ADC_H
+
+#include "LIB/stdtypes.h"
+
+/******************************************************************************
+ *                        ADC STATUS ENUMERATION
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef enum {
+    ADC_NOT_OK = 0,                 /**< Operation failed */
+    ADC_OK,                         /**< Operation completed successfully */
+    ADC_NULL_PTR,                   /**< Null pointer passed */
+    ADC_NOT_INIT,                   /**< ADC_enuInit() was not called */
+    ADC_BUSY,                       /**< Sampling running (ADC_enuStart called) */
+    ADC_WRONG_CHANNEL,              /**< Channel above ADC_CHANNEL_VBAT */
+    ADC_WRONG_SEQUENCE_LENGTH,      /**< 0 or more than ADC_MAX_SEQUENCE_LENGTH channels */
+    ADC_WRONG_SAMPLE_TIME,          /**< Unknown sampling time */
+    ADC_WRONG_RESOLUTION,           /**< Unknown resolution */
+    ADC_WRONG_SAMPLE_RATE,          /**< 0, or the sequence does not fit in one trigger period */
+    ADC_WRONG_BLOCK_LENGTH,         /**< 0, or the buffer is above 65535 samples */
+    ADC_CLOCK_ERROR,                /**< ADC1, TIM2, GPIO or DMA2 clock could not be acquired */
+    ADC_DMA_ERROR,                  /**< DMA stream configuration failed */
+    ADC_TIMEOUT,                    /**< Single conversion did not end */
+}ADC_Status_t;
+
+/******************************************************************************
+ *                        ADC CHANNELS
+ * @details 0-7 : PA0-PA7, 8-9 : PB0-PB1, 10-15 : PC0-PC5 (not bonded on the
+ *          48-pin package), 16 : temperature sensor, 17 : VREFINT, 18 : VBAT / 4
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define ADC_CHANNEL_TEMPERATURE     (16U)
+#define ADC_CHANNEL_VREFINT         (17U)
+#define ADC_CHANNEL_VBAT            (18U)
+#define ADC_MAX_SEQUENCE_LENGTH     (16U)   /**< SQ1..SQ16 */
+
+/******************************************************************************
+ *                        SAMPLING TIME (ADC clock cycles)
+ * @details Conversion time = sampling time + resolution bits + 0.5 cycles
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef enum {
+    ADC_SAMPLE_3_CYCLES = 0,
+    ADC_SAMPLE_15_CYCLES,
+    ADC_SAMPLE_28_CYCLES,
+    ADC_SAMPLE_56_CYCLES,
+    ADC_SAMPLE_84_CYCLES,
+    ADC_SAMPLE_112_CYCLES,
+    ADC_SAMPLE_144_CYCLES,
+    ADC_SAMPLE_480_CYCLES,
+}ADC_SampleTime_t;
+
+/******************************************************************************
+ *                        RESOLUTION
+ * @details Samples are right aligned in 16-bit words
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef enum {
+    ADC_RESOLUTION_12_BIT = 0,      /**< 15 cycles with 3 cycles sampling */
+    ADC_RESOLUTION_10_BIT,
+    ADC_RESOLUTION_8_BIT,
+    ADC_RESOLUTION_6_BIT,
+}ADC_Resolution_t;
+
+/******************************************************************************
+ *                        AVERAGING OPTIONS
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define ADC_AVERAGING_DISABLED      (0U)    /**< Raw block only */
+#define ADC_AVERAGING_ENABLED       (1U)    /**< Per-channel mean of the block : decimation by ADC_BlockLength */
+
+/**
+ * @brief Block callback, called from the DMA interrupt
+ * @param block     ADC_BlockLength sequences of ADC_SequenceLength samples,
+ *                  in sequence order (block[s * ADC_SequenceLength + i] = channel i of sequence s)
+ * @param averages  ADC_SequenceLength means (rounded), NULL when averaging is disabled
+ */
+typedef void (*ADC_BlockCallback_t)(const uint16_t *block, const uint16_t *averages);
+
+/******************************************************************************
+ *                        CONFIGURATION STRUCTURE
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef struct {
+    const uint8_t       *ADC_Sequence;          /**< Channels in conversion order (a channel may repeat) */
+    uint8_t              ADC_SequenceLength;    /**< 1 .. ADC_MAX_SEQUENCE_LENGTH */
+    ADC_SampleTime_t     ADC_SampleTime;        /**< Same sampling time for every channel */
+    ADC_Resolution_t     ADC_Resolution;
+    uint32_t             ADC_SampleRate_Hz;     /**< Sequences per second (TIM2 update rate) */
+    uint16_t            *ADC_Buffer;            /**< 2 x ADC_BlockLength x ADC_SequenceLength samples */
+    uint16_t             ADC_BlockLength;       /**< Sequences per block */
+    uint8_t              ADC_Averaging;         /**< ADC_AVERAGING_ENABLED or ADC_AVERAGING_DISABLED */
+    ADC_BlockCallback_t  ADC_BlockCallback;     /**< Called for each completed block, may be NULL */
+}ADC_Config_t;
+
+/******************************************************************************
+ *                        FUNCTION PROTOTYPES
+ * @author Eng.Gemy
+ ******************************************************************************/
+
+/**
+ * @brief Configure ADC1, the TIM2 trigger and the DMA stream
+ * @details Acquires the clocks, puts the GPIO channels in analog mode, loads
+ *          the scan sequence and sampling times, sets TIM2 to overflow at
+ *          ADC_SampleRate_Hz (TRGO on update) and DMA2 stream 0 in circular mode
+ *
+ * @param[in] config  Configuration, the sequence and buffer must stay valid
+ *
+ * @return ADC_Status_t (ADC_OK, ADC_NULL_PTR, ADC_BUSY, ADC_WRONG_CHANNEL,
+ *         ADC_WRONG_SEQUENCE_LENGTH, ADC_WRONG_SAMPLE_TIME, ADC_WRONG_RESOLUTION,
+ *         ADC_WRONG_SAMPLE_RATE, ADC_WRONG_BLOCK_LENGTH, ADC_CLOCK_ERROR, ADC_DMA_ERROR)
+ *
+ * @note The timer clock is read from the RCC : call it again after a clock change
+ */
+ADC_Status_t ADC_enuInit(const ADC_Config_t *config);
+
+/**
+ * @brief Start the triggered sampling, the first block completes after
+ *        ADC_BlockLength trigger periods
+ *
+ * @return ADC_Status_t (ADC_OK, ADC_NOT_INIT, ADC_BUSY, ADC_DMA_ERROR,
+ *         ADC_WRONG_SAMPLE_RATE or ADC_CLOCK_ERROR when the running clock
+ *         cannot reach the configured rate after a clock change)
+ */
+ADC_Status_t ADC_enuStart(void);
+
+/**
+ * @brief Stop the timer, the ADC and the DMA stream
+ *
+ * @return ADC_Status_t (ADC_OK, ADC_NOT_INIT)
+ */
+ADC_Status_t ADC_enuStop(void);
+
+/**
+ * @brief One software-started conversion, polled
+ *
+ * @param[in]  channel  0 .. ADC_CHANNEL_VBAT
+ * @param[out] value    Pointer to store the result
+ *
+ * @return ADC_Status_t (ADC_OK, ADC_NULL_PTR, ADC_NOT_INIT, ADC_BUSY, ADC_WRONG_CHANNEL, ADC_TIMEOUT)
+ *
+ * @note Only while the triggered sampling is stopped, the sequence is restored afterwards
+ */
+ADC_Status_t ADC_enuReadChannel(uint8_t channel, uint16_t *value);
+
+/**
+ * @brief Number of overruns since ADC_enuStart()
+ * @details An overrun (a conversion not read by the DMA in time) stops the
+ *          DMA requests : the interrupt restarts the stream at the start of
+ *          the buffer, the partial block is dropped
+ *
+ * @param[out] overruns  Pointer to store the count
+ *
+ * @return ADC_Status_t (ADC_OK, ADC_NULL_PTR)
+ */
+ADC_Status_t ADC_enuGetOverruns(uint32_t *overruns);
+
+/**
+ * @brief Clock change notifier, registered with MCU_enuRegisterClockNotifier by ADC_enuInit()
+ * @details ADCPRE and TIM2 ARR are computed again from the new PCLK1/PCLK2
+ *
+ * @param[in] phase  MCU_CLOCK_PRE_CHANGE or MCU_CLOCK_POST_CHANGE
+ */
+void ADC_vdClockChangeNotifier(uint8_t phase);
+
+/**
+ * @brief Clock change guard, registered with MCU_enuRegisterClockGuard by ADC_enuInit()
+ *
+ * @return 1 while the triggered sampling runs (stop it before a clock change), 0 otherwise
+ */
+uint8_t ADC_u8ClockChangeBusy(void);
+
+#endif /* ADC_H */
@@ -0,0 +1,24 @@
+/******************************************************************************
+ * @file    ADC_CFG.H
+ * @author  Eng.Gemy
+ * @brief   ADC Driver Configuration File
+ ******************************************************************************/
+
+#ifndef ADC_CFG_H
+#define ADC_CFG_H
+
+/******************************************************************************
+ * @brief ADC clock = PCLK2 / ADC_CLOCK_DIVIDER (2, 4, 6 or 8)
+ * @details 36 MHz max at 2.4 V - 3.6 V : 4 gives 21 MHz from an 84 MHz PCLK2
+ * @author  Eng.Gemy
+ ******************************************************************************/
+#define ADC_CLOCK_DIVIDER           (4U)
+
+/******************************************************************************
+ * @brief NVIC priority of the DMA block interrupt and the ADC overrun interrupt
+ * @details The block callback and the averaging run at this level
+ * @author  Eng.Gemy
+ ******************************************************************************/
+#define ADC_INTERRUPT_PRIORITY      NVIC_PRIORITY_5
+
+#endif /* ADC_CFG_H */
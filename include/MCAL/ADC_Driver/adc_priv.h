@@ -0,0 +1,126 @@
+/******************************************************************************
+ * @file    ADC_PRIV.H
+ * @author  Eng.Gemy
+ * @brief   ADC Driver Private Header File
+ *          Register maps and masks of ADC1, the ADC common block and TIM2
+ *          (trigger timer)
+ * @note    This file should NOT be included by application code
+ ******************************************************************************/
+
+#ifndef ADC_PRIV_H
+#define ADC_PRIV_H
+
+#include "LIB/stdtypes.h"
+
+/******************************************************************************
+ *                        BASE ADDRESSES
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define ADC1_BASE_ADDRESS           (0x40012000UL)  /**< ADC1 (APB2) */
+#define ADC_COMMON_BASE_ADDRESS     (0x40012300UL)  /**< ADC common registers */
+#define TIM2_BASE_ADDRESS           (0x40000000UL)  /**< TIM2 (APB1, 32-bit counter) */
+
+/******************************************************************************
+ *                        ADC MASKS
+ * @details SR  : EOC bit 1, OVR bit 5
+ *          CR1 : SCAN bit 8, RES[1:0] bits 25:24, OVRIE bit 26
+ *          CR2 : ADON bit 0, DMA bit 8, DDS bit 9, EOCS bit 10,
+ *                EXTSEL[3:0] bits 27:24, EXTEN[1:0] bits 29:28, SWSTART bit 30
+ *          CCR : ADCPRE[1:0] bits 17:16, TSVREFE bit 23
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define ADC_SR_EOC                  (0x00000002UL)
+#define ADC_SR_OVR                  (0x00000020UL)
+
+#define ADC_CR1_SCAN                (0x00000100UL)
+#define ADC_CR1_RES_POS             (24UL)
+#define ADC_CR1_OVRIE               (0x04000000UL)
+
+#define ADC_CR2_ADON                (0x00000001UL)
+#define ADC_CR2_DMA                 (0x00000100UL)
+#define ADC_CR2_DDS                 (0x00000200UL)  /**< DMA requests go on after the last transfer (circular) */
+#define ADC_CR2_EOCS                (0x00000400UL)
+#define ADC_CR2_EXTSEL_TIM2_TRGO    (0x06000000UL)  /**< EXTSEL = 0110 */
+#define ADC_CR2_EXTEN_RISING        (0x10000000UL)
+#define ADC_CR2_SWSTART             (0x40000000UL)
+
+#define ADC_CCR_ADCPRE_POS          (16UL)
+#define ADC_CCR_ADCPRE_MASK         (0x00030000UL)
+#define ADC_CCR_TSVREFE             (0x00800000UL)  /**< Temperature sensor and VREFINT enable */
+#define ADC_CCR_VBATE               (0x00400000UL)  /**< VBAT bridge enable */
+
+#define ADC_SQR_BITS                (5UL)           /**< 5 bits per SQx field */
+#define ADC_SQR_PER_REGISTER        (6U)            /**< SQ1..6 in SQR3, SQ7..12 in SQR2, SQ13..16 in SQR1 */
+#define ADC_SQR1_L_POS              (20UL)          /**< Sequence length - 1 */
+#define ADC_SMPR_BITS               (3UL)           /**< 3 bits per channel */
+#define ADC_SMPR2_CHANNELS          (10U)           /**< Channels 0-9 in SMPR2, 10-18 in SMPR1 */
+
+#define ADC_MAX_CLOCK_HZ            (36000000UL)
+#define ADC_STABILIZATION_LOOPS     (1000UL)        /**< tSTAB (3 us) after ADON */
+#define ADC_TIMEOUT_VALUE           (100000UL)      /**< Loop count waiting for EOC */
+
+/******************************************************************************
+ *                        TIM2 MASKS
+ * @details CR1 : CEN bit 0, URS bit 2
+ *          CR2 : MMS[2:0] bits 6:4 (010 : update event as TRGO)
+ *          EGR : UG bit 0
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define TIM_CR1_CEN                 (0x00000001UL)
+#define TIM_CR1_URS                 (0x00000004UL)  /**< Only overflows generate update events */
+#define TIM_CR2_MMS_UPDATE          (0x00000020UL)
+#define TIM_EGR_UG                  (0x00000001UL)
+
+/******************************************************************************
+ *                        REGISTER STRUCTURES
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef struct
+{
+    volatile uint32_t SR;       /**< 0x00 Status register */
+    volatile uint32_t CR1;      /**< 0x04 Control register 1 */
+    volatile uint32_t CR2;      /**< 0x08 Control register 2 */
+    volatile uint32_t SMPR1;    /**< 0x0C Sample time register 1 (channels 10-18) */
+    volatile uint32_t SMPR2;    /**< 0x10 Sample time register 2 (channels 0-9) */
+    volatile uint32_t JOFR[4];  /**< 0x14 Injected channel data offset registers */
+    volatile uint32_t HTR;      /**< 0x24 Watchdog higher threshold register */
+    volatile uint32_t LTR;      /**< 0x28 Watchdog lower threshold register */
+    volatile uint32_t SQR1;     /**< 0x2C Regular sequence register 1 (SQ13-16, L) */
+    volatile uint32_t SQR2;     /**< 0x30 Regular sequence register 2 (SQ7-12) */
+    volatile uint32_t SQR3;     /**< 0x34 Regular sequence register 3 (SQ1-6) */
+    volatile uint32_t JSQR;     /**< 0x38 Injected sequence register */
+    volatile uint32_t JDR[4];   /**< 0x3C Injected data registers */
+    volatile uint32_t DR;       /**< 0x4C Regular data register */
+}ADC_Regs_t;
+
+typedef struct
+{
+    volatile uint32_t CSR;      /**< 0x00 Common status register */
+    volatile uint32_t CCR;      /**< 0x04 Common control register */
+}ADC_CommonRegs_t;
+
+typedef struct
+{
+    volatile uint32_t CR1;      /**< 0x00 Control register 1 */
+    volatile uint32_t CR2;      /**< 0x04 Control register 2 */
+    volatile uint32_t SMCR;     /**< 0x08 Slave mode control register */
+    volatile uint32_t DIER;     /**< 0x0C DMA/interrupt enable register */
+    volatile uint32_t SR;       /**< 0x10 Status register */
+    volatile uint32_t EGR;      /**< 0x14 Event generation register */
+    volatile uint32_t CCMR1;    /**< 0x18 Capture/compare mode register 1 */
+    volatile uint32_t CCMR2;    /**< 0x1C Capture/compare mode register 2 */
+    volatile uint32_t CCER;     /**< 0x20 Capture/compare enable register */
+    volatile uint32_t CNT;      /**< 0x24 Counter */
+    volatile uint32_t PSC;      /**< 0x28 Prescaler */
+    volatile uint32_t ARR;      /**< 0x2C Auto-reload register */
+}TIM_Regs_t;
+
+/******************************************************************************
+ *                        PERIPHERAL POINTER DEFINITIONS
+ * @author Eng.Gemy
+ ******************************************************************************/
+ADC_Regs_t       *ADC1_Registers      = (ADC_Regs_t *)ADC1_BASE_ADDRESS;
+ADC_CommonRegs_t *ADC_CommonRegisters = (ADC_CommonRegs_t *)ADC_COMMON_BASE_ADDRESS;
+TIM_Regs_t       *TIM2_Registers      = (TIM_Regs_t *)TIM2_BASE_ADDRESS;
+
+#endif /* ADC_PRIV_H */
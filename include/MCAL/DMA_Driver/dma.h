@@ -214,11 +214,89 @@ typedef enum {
     DMA_WRONG_MODE,
     DMA_WRONG_FIFO_THRESHOLD,
     DMA_WRONG_INTERRUPTS,
-    DMA_WRONG_ZERO_NUMBER_OF_DATA
+    DMA_WRONG_ZERO_NUMBER_OF_DATA,
+    DMA_CLOCK_ERROR,
+    DMA_STREAM_NOT_INIT
 }DMA_Status_t;
 
 
+// Stream registers folded at build time by DMA_IMAGE_DECLARE (SCR without EN)
+typedef struct {
+    DMA_Controller_t          DMAx;
+    DMA_Stream_t              Streamx;
+    uint32_t                  SCR;
+    uint32_t                  SFCR;
+    uint32_t                  SNDTR;
+    uint32_t                  SPAR;
+    uint32_t                  SM0AR;
+    uint32_t                  SM1AR;
+}DMA_Image_t;
+
+// Checked stream image in flash, the fields in the order of DMA_Config_t :
+//   [static] DMA_IMAGE_DECLARE(name, DMAx, Streamx, Channel, Direction, PeripheralFlowCtrl, Mode,
+//                              Priority, MSize, PSize, MemoryInc, PeripheralInc, CircularMode,
+//                              MBurst, PBurst, DoubleBuffer, FifoThreshold, PeripheralAddress,
+//                              Memory0Address, Memory1Address, Interrupts, NumberOfData);
+// Every check of DMA_enuInit, plus the ones between fields, runs as _Static_assert :
+// a wrong configuration stops the build and DMA_enuInitImage only stores the registers
+#define DMA_IMAGE_DECLARE(name, dmax, streamx, channel, direction, flowCtrl, mode, \
+                          priority, msize, psize, minc, pinc, circular, \
+                          mburst, pburst, doubleBuffer, fifoThreshold, peripheralAddress, \
+                          memory0Address, memory1Address, interrupts, numberOfData) \
+    const DMA_Image_t name = { \
+        .DMAx    = (dmax), \
+        .Streamx = (streamx), \
+        .SCR     = (uint32_t)(channel) | (uint32_t)(mburst) | (uint32_t)(pburst) | (uint32_t)(doubleBuffer) \
+                 | (uint32_t)(priority) | (uint32_t)(msize) | (uint32_t)(psize) | (uint32_t)(minc) \
+                 | (uint32_t)(pinc) | (uint32_t)(circular) | (uint32_t)(direction) | (uint32_t)(flowCtrl) \
+                 | ((uint32_t)(interrupts) & DMA_IMAGE_SCR_INTERRUPTS), \
+        .SFCR    = (uint32_t)(mode) | (uint32_t)(fifoThreshold) | ((uint32_t)(interrupts) & DMA_INTERRUPT_FIFO_ERROR_ENABLE), \
+        .SNDTR   = (uint32_t)(numberOfData), \
+        .SPAR    = (uint32_t)(peripheralAddress), \
+        .SM0AR   = (uint32_t)(memory0Address), \
+        .SM1AR   = (uint32_t)(memory1Address) }; \
+    _Static_assert((uint32_t)(dmax) <= (uint32_t)DMA2, #name ": wrong DMA controller"); \
+    _Static_assert((uint32_t)(streamx) <= (uint32_t)DMA_STREAM7, #name ": wrong stream"); \
+    _Static_assert(((uint32_t)(channel) & ~(uint32_t)DMA_CHANNEL7) == 0U, #name ": wrong channel"); \
+    _Static_assert(((uint32_t)(direction) == DMA_DIRECTION_P2M) || ((uint32_t)(direction) == DMA_DIRECTION_M2P) \
+                   || ((uint32_t)(direction) == DMA_DIRECTION_M2M), #name ": wrong direction"); \
+    _Static_assert(((uint32_t)(flowCtrl) & ~(uint32_t)DMA_FLOW_CONTROL_USING_PERIPHERAL) == 0U, #name ": wrong flow control"); \
+    _Static_assert(((uint32_t)(mode) & ~(uint32_t)DMA_MODE_FIFO) == 0U, #name ": wrong mode"); \
+    _Static_assert(((uint32_t)(priority) & ~(uint32_t)DMA_PRIORITY_VERY_HIGH) == 0U, #name ": wrong priority"); \
+    _Static_assert(((uint32_t)(msize) == DMA_MSIZE_BYTE) || ((uint32_t)(msize) == DMA_MSIZE_HALFWORD) \
+                   || ((uint32_t)(msize) == DMA_MSIZE_WORD), #name ": wrong memory size"); \
+    _Static_assert(((uint32_t)(psize) == DMA_PSIZE_BYTE) || ((uint32_t)(psize) == DMA_PSIZE_HALFWORD) \
+                   || ((uint32_t)(psize) == DMA_PSIZE_WORD), #name ": wrong peripheral size"); \
+    _Static_assert(((uint32_t)(minc) & ~(uint32_t)DMA_MINC_AUTO_INCREMENT) == 0U, #name ": wrong memory increment"); \
+    _Static_assert(((uint32_t)(pinc) & ~(uint32_t)DMA_PINC_AUTO_INCREMENT) == 0U, #name ": wrong peripheral increment"); \
+    _Static_assert(((uint32_t)(circular) & ~(uint32_t)DMA_CIRCULAR_MODE_ENABLE) == 0U, #name ": wrong circular mode"); \
+    _Static_assert(((uint32_t)(mburst) & ~(uint32_t)DMA_MBurst_INCR16) == 0U, #name ": wrong memory burst"); \
+    _Static_assert(((uint32_t)(pburst) & ~(uint32_t)DMA_PBurst_INCR16) == 0U, #name ": wrong peripheral burst"); \
+    _Static_assert(((uint32_t)(doubleBuffer) == DMA_DISABLE_DOUBLE_BUFFER) \
+                   || ((uint32_t)(doubleBuffer) == DMA_ENABLE_DOUBLE_BUFFER), #name ": wrong double buffer"); \
+    _Static_assert(((uint32_t)(fifoThreshold) & ~(uint32_t)DMA_FIFO_THRESHOLD_FULL) == 0U, #name ": wrong FIFO threshold"); \
+    _Static_assert(((uint32_t)(interrupts) & ~DMA_IMAGE_INTERRUPTS) == 0U, #name ": wrong interrupts"); \
+    _Static_assert(((uint32_t)(numberOfData) != 0U) && ((uint32_t)(numberOfData) <= 0xFFFFU), #name ": wrong number of data"); \
+    _Static_assert(((uint32_t)(direction) != DMA_DIRECTION_M2M) || ((uint32_t)(mode) == DMA_MODE_FIFO), \
+                   #name ": memory to memory needs the FIFO mode"); \
+    _Static_assert(((uint32_t)(direction) != DMA_DIRECTION_M2M) || ((uint32_t)(circular) == DMA_CIRCULAR_MODE_DISABLE), \
+                   #name ": memory to memory cannot be circular"); \
+    _Static_assert((((uint32_t)(mburst) | (uint32_t)(pburst)) == 0U) || ((uint32_t)(mode) == DMA_MODE_FIFO), \
+                   #name ": bursts need the FIFO mode")
+
+// Interrupt enables accepted by DMA_IMAGE_DECLARE, and the ones living in SCR
+#define DMA_IMAGE_INTERRUPTS        (DMA_INTERRUPT_TRANSFER_COMPLETE_ENABLE | DMA_INTERRUPT_HALF_TRANSFER_ENABLE \
+                                    | DMA_INTERRUPT_TRANSFER_ERROR_ENABLE | DMA_INTERRUPT_DIRECT_MODE_ERROR_ENABLE \
+                                    | DMA_INTERRUPT_FIFO_ERROR_ENABLE)
+#define DMA_IMAGE_SCR_INTERRUPTS    (DMA_IMAGE_INTERRUPTS & ~DMA_INTERRUPT_FIFO_ERROR_ENABLE)
+
 DMA_Status_t DMA_enuInit(const DMA_Config_t* ConfigPtr);
+// Clocks the controller and stores an image built by DMA_IMAGE_DECLARE : no field checks
+// at run time (they ran at build time), the stream is left disabled as with DMA_enuInit
+DMA_Status_t DMA_enuInitImage(const DMA_Image_t* Image);
+// Stops the stream and releases its owner reference on the controller clock
+// (DMA_enuInit acquires it, the controller is gated off when its last stream is released)
+DMA_Status_t DMA_enuDeInit(DMA_Controller_t DMAx, DMA_Stream_t Streamx);
 DMA_Status_t DMA_enuStartTransfer(DMA_Controller_t DMAx, DMA_Stream_t Streamx);
 DMA_Status_t DMA_enuStopTransfer(DMA_Controller_t DMAx, DMA_Stream_t Streamx);
 DMA_Status_t DMA_enuSetMemoryAddress(DMA_Controller_t DMAx, DMA_Stream_t Streamx, uint32_t MemoryAddress);
@@ -0,0 +1,169 @@
+/******************************************************************************
+ * @file    FLASH.H
+ * @author  Eng.Gemy
+ * @brief   FLASH Interface Driver Header File
+ *          Wait states, prefetch buffer, ART accelerator (I/D caches),
+ *          sector erase and word programming
+ * @note    Wait states must be raised BEFORE HCLK increases and may only be
+ *          lowered AFTER HCLK decreases
+ ******************************************************************************/
+
+#ifndef FLASH_H
+#define FLASH_H
+
+#include "LIB/stdtypes.h"
+
+/******************************************************************************
+ *                        FLASH STATUS ENUMERATION
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef enum {
+    FLASH_NOT_OK = 0,               /**< Operation failed */
+    FLASH_OK,                       /**< Operation completed successfully */
+    FLASH_NULL_PTR,                 /**< Null pointer passed */
+    FLASH_WRONG_VOLTAGE_RANGE,      /**< Unknown supply voltage range */
+    FLASH_WRONG_FREQUENCY,          /**< HCLK above the device limit */
+    FLASH_WRONG_FEATURES,           /**< Unknown accelerator feature bits */
+    FLASH_PREFETCH_NOT_ALLOWED,     /**< Prefetch requested below 2.1 V */
+    FLASH_LATENCY_NOT_APPLIED,      /**< LATENCY read back differs from the written value */
+    FLASH_WRONG_SECTOR,             /**< Sector number above FLASH_NUMBER_OF_SECTORS - 1 */
+    FLASH_WRONG_ADDRESS,            /**< Address outside the main memory or not word aligned */
+    FLASH_PROGRAM_ERROR,            /**< WRPERR / PGAERR / PGPERR / PGSERR / OPERR set by the operation */
+    FLASH_VERIFY_ERROR,             /**< Word read back differs from the programmed value */
+    FLASH_TIMEOUT,                  /**< BSY still set after the timeout */
+    FLASH_SECTOR_PROTECTED,         /**< Bootloader sector or sector of the running application */
+}FLASH_Status_t;
+
+/******************************************************************************
+ *                        SUPPLY VOLTAGE RANGES
+ * @brief Supply voltage range of the device, selects the wait state table
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef enum {
+    FLASH_VOLTAGE_2V7_TO_3V6 = 0,   /**< 30 MHz per wait state */
+    FLASH_VOLTAGE_2V4_TO_2V7,       /**< 24 MHz per wait state */
+    FLASH_VOLTAGE_2V1_TO_2V4,       /**< 18 MHz per wait state */
+    FLASH_VOLTAGE_1V8_TO_2V1,       /**< 16 MHz per wait state, no prefetch */
+}FLASH_VoltageRange_t;
+
+/******************************************************************************
+ *                        ACCELERATOR FEATURES
+ * @brief ACR feature bits, can be ORed together
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define FLASH_NO_FEATURE        (0x00000000UL)  /**< Prefetch and caches disabled */
+#define FLASH_PREFETCH_ENABLE   (0x00000100UL)  /**< Prefetch buffer (PRFTEN) */
+#define FLASH_ICACHE_ENABLE     (0x00000200UL)  /**< ART instruction cache (ICEN) */
+#define FLASH_DCACHE_ENABLE     (0x00000400UL)  /**< ART data cache (DCEN) */
+#define FLASH_ALL_FEATURES      (FLASH_PREFETCH_ENABLE | FLASH_ICACHE_ENABLE | FLASH_DCACHE_ENABLE)
+
+/******************************************************************************
+ *                        MAIN MEMORY ORGANIZATION
+ * @brief STM32F401CC : 256 KB in 6 sectors
+ * @details Sectors 0-3 : 16 KB (0x08000000, 0x08004000, 0x08008000, 0x0800C000)
+ *          Sector  4   : 64 KB (0x08010000)
+ *          Sector  5   : 128 KB (0x08020000)
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define FLASH_NUMBER_OF_SECTORS (6U)
+#define FLASH_BOOT_SECTORS      (2U)            /**< Sectors 0-1 : bootloader, written only by the bootloader itself */
+#define FLASH_ERASED_WORD       (0xFFFFFFFFUL)  /**< Content of an erased word */
+
+/******************************************************************************
+ *                        FUNCTION PROTOTYPES
+ * @author Eng.Gemy
+ ******************************************************************************/
+
+/**
+ * @brief Compute the wait states needed for a given HCLK
+ * 
+ * @param[in]  hclkHz        AHB clock frequency in Hz
+ * @param[in]  voltageRange  Device supply voltage range
+ * @param[out] waitStates    Pointer to store the number of wait states
+ * 
+ * @return FLASH_Status_t (FLASH_OK, FLASH_NULL_PTR, FLASH_WRONG_VOLTAGE_RANGE, FLASH_WRONG_FREQUENCY)
+ * 
+ * @example 84 MHz at 3.3 V : waitStates = 2
+ */
+FLASH_Status_t FLASH_enuCalculateLatency(uint32_t hclkHz, FLASH_VoltageRange_t voltageRange, uint8_t* waitStates);
+
+/**
+ * @brief Program the wait states for a given HCLK
+ * @details The value is read back to make sure the new latency is in effect
+ *          before the caller changes the clock
+ * 
+ * @param[in] hclkHz        AHB clock frequency in Hz
+ * @param[in] voltageRange  Device supply voltage range
+ * 
+ * @return FLASH_Status_t (FLASH_OK, FLASH_WRONG_VOLTAGE_RANGE, FLASH_WRONG_FREQUENCY, FLASH_LATENCY_NOT_APPLIED)
+ */
+FLASH_Status_t FLASH_enuSetLatency(uint32_t hclkHz, FLASH_VoltageRange_t voltageRange);
+
+/**
+ * @brief Read the current number of wait states
+ * 
+ * @param[out] waitStates  Pointer to store the LATENCY field
+ * 
+ * @return FLASH_Status_t (FLASH_OK, FLASH_NULL_PTR)
+ */
+FLASH_Status_t FLASH_enuGetLatency(uint8_t* waitStates);
+
+/**
+ * @brief Enable the selected accelerator features and disable the others
+ * @details Caches are reset before being enabled so no stale line survives
+ *          a previous configuration
+ * 
+ * @param[in] features      OR of FLASH_PREFETCH_ENABLE, FLASH_ICACHE_ENABLE, FLASH_DCACHE_ENABLE
+ * @param[in] voltageRange  Device supply voltage range (prefetch is not allowed below 2.1 V)
+ * 
+ * @return FLASH_Status_t (FLASH_OK, FLASH_WRONG_FEATURES, FLASH_WRONG_VOLTAGE_RANGE, FLASH_PREFETCH_NOT_ALLOWED)
+ */
+FLASH_Status_t FLASH_enuConfigureAccelerator(uint32_t features, FLASH_VoltageRange_t voltageRange);
+
+/**
+ * @brief Get the start address and size of a sector
+ * 
+ * @param[in]  sector   Sector number (0 .. FLASH_NUMBER_OF_SECTORS - 1)
+ * @param[out] address  Pointer to store the first address of the sector
+ * @param[out] size     Pointer to store the sector size in bytes
+ * 
+ * @return FLASH_Status_t (FLASH_OK, FLASH_NULL_PTR, FLASH_WRONG_SECTOR)
+ */
+FLASH_Status_t FLASH_enuGetSectorInfo(uint8_t sector, uint32_t* address, uint32_t* size);
+
+/**
+ * @brief Erase one sector (all words read 0xFFFFFFFF afterwards)
+ * @details x32 parallelism, needs a 2.7 V - 3.6 V supply
+ *          The CPU stalls on any flash fetch while the erase runs
+ *          (16 KB : ~250 ms, 128 KB : ~1 s)
+ * 
+ * @param[in] sector  Sector number (0 .. FLASH_NUMBER_OF_SECTORS - 1)
+ * 
+ * @return FLASH_Status_t (FLASH_OK, FLASH_WRONG_SECTOR, FLASH_SECTOR_PROTECTED,
+ *                         FLASH_PROGRAM_ERROR, FLASH_TIMEOUT)
+ * 
+ * @note The bootloader sectors and the sector holding the running vector table
+ *       (VTOR, the linked image once the table is relocated to SRAM) are refused : the bootloader installs images with its own
+ *       register sequence (OS/bootloader.c), the update service only writes
+ *       its download slot
+ */
+FLASH_Status_t FLASH_enuEraseSector(uint8_t sector);
+
+/**
+ * @brief Program words and verify them
+ * @details Bits can only go from 1 to 0 : a word may be programmed again
+ *          as long as no 0 bit has to become 1
+ *          The ART data cache is flushed so reads return the new content
+ * 
+ * @param[in] address    Word aligned destination in the main memory
+ * @param[in] data       Words to program
+ * @param[in] wordCount  Number of words
+ * 
+ * @return FLASH_Status_t (FLASH_OK, FLASH_NULL_PTR, FLASH_WRONG_ADDRESS, FLASH_SECTOR_PROTECTED,
+ *                         FLASH_PROGRAM_ERROR, FLASH_VERIFY_ERROR, FLASH_TIMEOUT)
+ * 
+ * @note Same protected sectors as FLASH_enuEraseSector, checked for every word
+ */
+FLASH_Status_t FLASH_enuProgram(uint32_t address, const uint32_t* data, uint32_t wordCount);
+
+#endif /* FLASH_H */
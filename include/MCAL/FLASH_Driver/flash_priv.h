@@ -0,0 +1,106 @@
+/******************************************************************************
+ * @file    FLASH_PRIV.H
+ * @author  Eng.Gemy
+ * @brief   FLASH Interface Driver Private Header File
+ *          This file contains the hardware register definitions, base address
+ *          and masks for the embedded flash interface
+ * @note    This file should NOT be included by application code
+ ******************************************************************************/
+
+#ifndef FLASH_PRIV_H
+#define FLASH_PRIV_H
+
+#include "LIB/stdtypes.h"
+
+/******************************************************************************
+ *                        FLASH INTERFACE BASE ADDRESS
+ * @brief Memory-mapped base address of the flash interface registers (AHB1)
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define FLASH_BASE_ADDRESS          (0x40023C00UL)
+
+/******************************************************************************
+ *                        ACR REGISTER MASKS
+ * @brief Access Control Register bit fields
+ * @details LATENCY[3:0], PRFTEN bit 8, ICEN bit 9, DCEN bit 10,
+ *          ICRST bit 11, DCRST bit 12
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define FLASH_ACR_LATENCY_MASK      (0x0000000FUL)  /**< Wait states field */
+#define FLASH_ACR_FEATURES_MASK     (0x00000700UL)  /**< PRFTEN | ICEN | DCEN */
+#define FLASH_ACR_ICRST             (0x00000800UL)  /**< Instruction cache reset (only while ICEN = 0) */
+#define FLASH_ACR_DCRST             (0x00001000UL)  /**< Data cache reset (only while DCEN = 0) */
+
+/******************************************************************************
+ *                        WAIT STATE LIMITS
+ * @brief HCLK range covered by one wait state for each voltage range
+ * @details STM32F401 (RM0368 Table 6) : WS = ceil(HCLK / step) - 1
+ *          2.7-3.6V : 30 MHz | 2.4-2.7V : 24 MHz | 2.1-2.4V : 18 MHz | 1.8-2.1V : 16 MHz
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define FLASH_HCLK_MAX              (84000000UL)    /**< Maximum HCLK for STM32F401 */
+#define FLASH_MAX_LATENCY           (15UL)          /**< Largest value of LATENCY[3:0] */
+
+/******************************************************************************
+ *                        KEYR / SR / CR MASKS
+ * @brief Unlock keys, status flags and control bits of erase / program
+ * @details SR : EOP bit 0, OPERR bit 1, WRPERR bit 4, PGAERR bit 5,
+ *               PGPERR bit 6, PGSERR bit 7, BSY bit 16
+ *          CR : PG bit 0, SER bit 1, SNB[6:3], PSIZE[9:8], STRT bit 16, LOCK bit 31
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define FLASH_KEY1                  (0x45670123UL)  /**< First unlock key */
+#define FLASH_KEY2                  (0xCDEF89ABUL)  /**< Second unlock key */
+
+#define FLASH_SR_EOP                (0x00000001UL)  /**< End of operation */
+#define FLASH_SR_ERRORS             (0x000000F2UL)  /**< OPERR | WRPERR | PGAERR | PGPERR | PGSERR (write 1 to clear) */
+#define FLASH_SR_BSY                (0x00010000UL)  /**< Operation in progress */
+
+#define FLASH_CR_PG                 (0x00000001UL)  /**< Programming */
+#define FLASH_CR_SER                (0x00000002UL)  /**< Sector erase */
+#define FLASH_CR_SNB_MASK           (0x00000078UL)  /**< Sector number field */
+#define FLASH_CR_SNB_POS            (3UL)
+#define FLASH_CR_PSIZE_MASK         (0x00000300UL)  /**< Program parallelism field */
+#define FLASH_CR_PSIZE_X32          (0x00000200UL)  /**< 32-bit parallelism (2.7 V - 3.6 V) */
+#define FLASH_CR_STRT               (0x00010000UL)  /**< Start the erase */
+#define FLASH_CR_LOCK               (0x80000000UL)  /**< CR locked until the key sequence */
+
+/******************************************************************************
+ *                        MAIN MEMORY LIMITS AND TIMEOUTS
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define FLASH_MAIN_MEMORY_START     (0x08000000UL)
+#define FLASH_MAIN_MEMORY_END       (0x08040000UL)  /**< First address after the 256 KB */
+#define FLASH_ERASE_TIMEOUT         (0x02000000UL)  /**< Loop count, above the 2 s of a 128 KB sector at 84 MHz */
+#define FLASH_PROGRAM_TIMEOUT       (0x00010000UL)  /**< Loop count, a word takes ~16 us */
+
+/******************************************************************************
+ *                        RUNNING IMAGE
+ * @brief Vector table offset register (SCB), its sector holds the running application
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define FLASH_SCB_VTOR              (*(volatile uint32_t *)0xE000ED08UL)
+
+/******************************************************************************
+ *                        FLASH REGISTERS STRUCTURE
+ * @brief Flash interface register map
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef struct
+{
+    volatile uint32_t ACR;      /**< 0x00 Access control register */
+    volatile uint32_t KEYR;     /**< 0x04 Key register */
+    volatile uint32_t OPTKEYR;  /**< 0x08 Option key register */
+    volatile uint32_t SR;       /**< 0x0C Status register */
+    volatile uint32_t CR;       /**< 0x10 Control register */
+    volatile uint32_t OPTCR;    /**< 0x14 Option control register */
+}FLASH_Regs_t;
+
+/******************************************************************************
+ *                        FLASH PERIPHERAL POINTER DEFINITION
+ * @brief Pointer to flash interface registers
+ * @author Eng.Gemy
+ ******************************************************************************/
+FLASH_Regs_t *FLASH_Registers = (FLASH_Regs_t *)FLASH_BASE_ADDRESS;
+
+#endif /* FLASH_PRIV_H */
@@ -167,6 +167,107 @@ typedef enum {
     GPIO_LOW  = 16          /**< Logic LOW (set bit in BSRR upper 16 bits) */
 }GPIO_Val_t;
 
+/******************************************************************************
+ * @brief GPIO Port Image Structure
+ * @details Register values of a set of pins of one port, folded at build time
+ *          by GPIO_IMAGE_DECLARE. Each register is written as
+ *          (register & ~mask) | value, the other pins of the port keep theirs
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef struct
+{
+    GPIO_Port_t Port;                           /**< GPIO Port (A, B, C, D, E, H) */
+    uint32_t PinMask;                           /**< 1 bit per pin : OTYPER mask */
+    uint32_t WideMask;                          /**< 2 bits per pin : MODER, OSPEEDR, PUPDR mask */
+    uint32_t AfrlMask;                          /**< 4 bits per pin 0-7 : AFRL mask */
+    uint32_t AfrhMask;                          /**< 4 bits per pin 8-15 : AFRH mask */
+    uint32_t MODER;                             /**< MODER bits of the pins */
+    uint32_t OTYPER;                            /**< OTYPER bits of the pins */
+    uint32_t OSPEEDR;                           /**< OSPEEDR bits of the pins */
+    uint32_t PUPDR;                             /**< PUPDR bits of the pins */
+    uint32_t AFRL;                              /**< AFRL bits of the pins 0-7 */
+    uint32_t AFRH;                              /**< AFRH bits of the pins 8-15 */
+}GPIO_Image_t;
+
+/******************************************************************************
+ * @brief Build-time pin folding
+ * @details A pin list is a macro taking the name of a per-pin macro and
+ *          calling it once per pin with (pin, mode, outputType, speed, pull, af):
+ *
+ *     #define LED_PINS(PIN) \
+ *         PIN(GPIO_PIN_0, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_NO_PULL, GPIO_AF0) \
+ *         PIN(GPIO_PIN_1, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_NO_PULL, GPIO_AF0)
+ *
+ *     static GPIO_IMAGE_DECLARE(ledImage, GPIO_PORT_A, LED_PINS);
+ *
+ * @note A wrong field or a pin listed twice stops the build (_Static_assert),
+ *       the image holds constants only and lives in flash
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define GPIO_IMAGE_PIN_MASK(pin)             (1UL << (uint32_t)(pin))
+#define GPIO_IMAGE_WIDE(pin, value)          ((uint32_t)(value) << ((uint32_t)(pin) * 2U))
+#define GPIO_IMAGE_AFRL(pin, value)          (((uint32_t)(pin) < 8U) ? ((uint32_t)(value) << (((uint32_t)(pin) & 7U) * 4U)) : 0UL)
+#define GPIO_IMAGE_AFRH(pin, value)          (((uint32_t)(pin) < 8U) ? 0UL : ((uint32_t)(value) << (((uint32_t)(pin) & 7U) * 4U)))
+
+/* Per-pin macros handed to a pin list, each one adds the pin to a field */
+#define GPIO_IMAGE_X_PIN_MASK(pin, mode, outputType, speed, pull, af)    | GPIO_IMAGE_PIN_MASK(pin)
+#define GPIO_IMAGE_X_PIN_SUM(pin, mode, outputType, speed, pull, af)     + GPIO_IMAGE_PIN_MASK(pin)
+#define GPIO_IMAGE_X_WIDE_MASK(pin, mode, outputType, speed, pull, af)   | GPIO_IMAGE_WIDE(pin, 3U)
+#define GPIO_IMAGE_X_AFRL_MASK(pin, mode, outputType, speed, pull, af)   | GPIO_IMAGE_AFRL(pin, 0xFU)
+#define GPIO_IMAGE_X_AFRH_MASK(pin, mode, outputType, speed, pull, af)   | GPIO_IMAGE_AFRH(pin, 0xFU)
+#define GPIO_IMAGE_X_MODER(pin, mode, outputType, speed, pull, af)       | GPIO_IMAGE_WIDE(pin, mode)
+#define GPIO_IMAGE_X_OTYPER(pin, mode, outputType, speed, pull, af)      | ((uint32_t)(outputType) << (uint32_t)(pin))
+#define GPIO_IMAGE_X_OSPEEDR(pin, mode, outputType, speed, pull, af)     | GPIO_IMAGE_WIDE(pin, speed)
+#define GPIO_IMAGE_X_PUPDR(pin, mode, outputType, speed, pull, af)       | GPIO_IMAGE_WIDE(pin, pull)
+#define GPIO_IMAGE_X_AFRL(pin, mode, outputType, speed, pull, af)        | GPIO_IMAGE_AFRL(pin, af)
+#define GPIO_IMAGE_X_AFRH(pin, mode, outputType, speed, pull, af)        | GPIO_IMAGE_AFRH(pin, af)
+#define GPIO_IMAGE_X_CHECK(pin, mode, outputType, speed, pull, af) \
+    _Static_assert((uint32_t)(pin) <= 15U, "GPIO image: wrong pin " #pin); \
+    _Static_assert((uint32_t)(mode) <= (uint32_t)GPIO_MODE_ANALOG, "GPIO image: wrong mode for " #pin); \
+    _Static_assert((uint32_t)(outputType) <= (uint32_t)GPIO_OUTPUT_TYPE_OPEN_DRAIN, "GPIO image: wrong output type for " #pin); \
+    _Static_assert((uint32_t)(speed) <= (uint32_t)GPIO_SPEED_VERY_HIGH, "GPIO image: wrong speed for " #pin); \
+    _Static_assert((uint32_t)(pull) <= (uint32_t)GPIO_PULL_DOWN, "GPIO image: wrong pull for " #pin); \
+    _Static_assert((uint32_t)(af) <= (uint32_t)GPIO_AF15, "GPIO image: wrong alternate function for " #pin);
+
+/* Initializer of a GPIO_Image_t from a pin list (no checks, see GPIO_IMAGE_CHECK) */
+#define GPIO_IMAGE_INITIALIZER(port, PINS) { \
+    .Port     = (port), \
+    .PinMask  = 0UL PINS(GPIO_IMAGE_X_PIN_MASK), \
+    .WideMask = 0UL PINS(GPIO_IMAGE_X_WIDE_MASK), \
+    .AfrlMask = 0UL PINS(GPIO_IMAGE_X_AFRL_MASK), \
+    .AfrhMask = 0UL PINS(GPIO_IMAGE_X_AFRH_MASK), \
+    .MODER    = 0UL PINS(GPIO_IMAGE_X_MODER), \
+    .OTYPER   = 0UL PINS(GPIO_IMAGE_X_OTYPER), \
+    .OSPEEDR  = 0UL PINS(GPIO_IMAGE_X_OSPEEDR), \
+    .PUPDR    = 0UL PINS(GPIO_IMAGE_X_PUPDR), \
+    .AFRL     = 0UL PINS(GPIO_IMAGE_X_AFRL), \
+    .AFRH     = 0UL PINS(GPIO_IMAGE_X_AFRH) }
+
+/* Initializer of a one-pin GPIO_Image_t, for the pin tables of the drivers */
+#define GPIO_IMAGE_PIN_INITIALIZER(port, pin, mode, outputType, speed, pull, af) { \
+    .Port     = (port), \
+    .PinMask  = GPIO_IMAGE_PIN_MASK(pin), \
+    .WideMask = GPIO_IMAGE_WIDE(pin, 3U), \
+    .AfrlMask = GPIO_IMAGE_AFRL(pin, 0xFU), \
+    .AfrhMask = GPIO_IMAGE_AFRH(pin, 0xFU), \
+    .MODER    = GPIO_IMAGE_WIDE(pin, mode), \
+    .OTYPER   = ((uint32_t)(outputType) << (uint32_t)(pin)), \
+    .OSPEEDR  = GPIO_IMAGE_WIDE(pin, speed), \
+    .PUPDR    = GPIO_IMAGE_WIDE(pin, pull), \
+    .AFRL     = GPIO_IMAGE_AFRL(pin, af), \
+    .AFRH     = GPIO_IMAGE_AFRH(pin, af) }
+
+/* Build-time checks of a pin list, a pin listed twice makes the sum differ from the OR */
+#define GPIO_IMAGE_CHECK(port, PINS) \
+    _Static_assert((uint32_t)(port) <= (uint32_t)GPIO_PORT_H, "GPIO image: wrong port"); \
+    PINS(GPIO_IMAGE_X_CHECK) \
+    _Static_assert((0UL PINS(GPIO_IMAGE_X_PIN_SUM)) == (0UL PINS(GPIO_IMAGE_X_PIN_MASK)), "GPIO image: pin listed twice")
+
+/* Checked image in flash : [static] GPIO_IMAGE_DECLARE(name, port, PINS); */
+#define GPIO_IMAGE_DECLARE(name, port, PINS) \
+    const GPIO_Image_t name = GPIO_IMAGE_INITIALIZER(port, PINS); \
+    GPIO_IMAGE_CHECK(port, PINS)
+
 /******************************************************************************
  *                           FUNCTION PROTOTYPES
  ******************************************************************************/
@@ -292,4 +393,30 @@ GPIO_Status_t GPIO_enuSetPinSpeed(GPIO_Port_t Copy_Port, GPIO_Pin_t Copy_Pin, GP
  ******************************************************************************/
 GPIO_Status_t GPIO_enuReadPinVal(GPIO_Port_t Copy_Port, GPIO_Pin_t Copy_Pin, uint8_t *Copy_pVal);
 
+/******************************************************************************
+ * @brief Apply a build-time checked port image (GPIO_IMAGE_DECLARE)
+ * @param[in] Copy_pstImage Pointer to the image
+ * @return GPIO_Status_t Status of the operation
+ * @retval GPIO_OK              Image applied
+ * @retval GPIO_NULL_PTR        Null pointer passed
+ * @retval GPIO_WRONG_PORT      Invalid port
+ * @note The fields are checked when the image is built, only the port is
+ *       checked here : six read-modify-writes, whatever the number of pins
+ * @warning Ensure GPIO clock is enabled before calling this function
+ * @author Eng.Gemy
+ ******************************************************************************/
+GPIO_Status_t GPIO_enuApplyImage(const GPIO_Image_t *Copy_pstImage);
+
+/******************************************************************************
+ * @brief Set and reset several pins of a port with one BSRR write
+ * @param[in] Copy_Port GPIO port (GPIO_PORT_A to GPIO_PORT_H)
+ * @param[in] Copy_Bsrr BSRR word : bits 0-15 set pins, bits 16-31 reset pins
+ * @return GPIO_Status_t Status of the operation
+ * @retval GPIO_OK          Operation successful
+ * @retval GPIO_WRONG_PORT  Invalid port
+ * @note Atomic, the other pins of the port are untouched
+ * @author Eng.Gemy
+ ******************************************************************************/
+GPIO_Status_t GPIO_enuSetResetPins(GPIO_Port_t Copy_Port, uint32_t Copy_Bsrr);
+
 #endif // GPIO_INT_H
\ No newline at end of file
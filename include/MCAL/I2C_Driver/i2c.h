@@ -0,0 +1,190 @@
+/******************************************************************************
+ * @file    I2C.H
+ * @author  Eng.Gemy
+ * @brief   I2C Master Driver Header File
+ *          Queued transactions (write, read or write-then-read with a
+ *          repeated START) driven by the event / error interrupts, longer
+ *          phases moved by DMA
+ * @note    Pins (alternate function, open drain, external pull-ups needed):
+ *          I2C1 : SCL PB6,  SDA PB7 (AF4)
+ *          I2C2 : SCL PB10, SDA PB3 (AF9)
+ *          I2C3 : SCL PA8,  SDA PB4 (AF9)
+ ******************************************************************************/
+
+#ifndef I2C_H
+#define I2C_H
+
+#include "LIB/stdtypes.h"
+
+/******************************************************************************
+ *                        I2C STATUS ENUMERATION
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef enum {
+    I2C_NOT_OK = 0,                 /**< Operation failed */
+    I2C_OK,                         /**< Operation completed successfully */
+    I2C_NULL_PTR,                   /**< Null pointer passed */
+    I2C_NOT_INIT,                   /**< I2C_enuInit() was not called for this bus */
+    I2C_WRONG_I2C_NUMBER,           /**< Bus above I2C_3 */
+    I2C_WRONG_SPEED,                /**< Unknown speed */
+    I2C_WRONG_ADDRESS,              /**< Address above 0x7F */
+    I2C_WRONG_LENGTH,               /**< Nothing to write nor to read */
+    I2C_QUEUE_FULL,                 /**< I2C_QUEUE_LENGTH transactions already queued */
+    I2C_CLOCK_ERROR,                /**< Clock could not be acquired, or PCLK1 out of range for the speed */
+    I2C_GPIO_ERROR,                 /**< SCL / SDA pin configuration failed */
+    I2C_DMA_ERROR,                  /**< DMA stream configuration failed */
+    I2C_TRANSFER_ERROR,             /**< I2C_enuTransferSync() : see I2C_Result of the transaction */
+}I2C_Status_t;
+
+/******************************************************************************
+ *                        I2C BUSES
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef enum {
+    I2C_1 = 0,
+    I2C_2,
+    I2C_3,
+}I2C_Number_t;
+
+#define I2C_NUMBER_OF_BUSES         (3U)
+
+/******************************************************************************
+ *                        BUS SPEED
+ * @details 400 kHz needs PCLK1 >= 4 MHz (a multiple of 10 MHz for an exact rate)
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef enum {
+    I2C_SPEED_STANDARD_100K = 0,
+    I2C_SPEED_FAST_400K,
+}I2C_Speed_t;
+
+/******************************************************************************
+ *                        DMA OPTIONS (i2c_cfg.h)
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define I2C_DMA_DISABLED            (0U)
+#define I2C_DMA_ENABLED             (1U)
+
+/******************************************************************************
+ *                        TRANSACTION RESULT
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef enum {
+    I2C_RESULT_PENDING = 0,         /**< Queued or on the bus */
+    I2C_RESULT_OK,                  /**< Every byte acknowledged, STOP sent */
+    I2C_RESULT_NACK,                /**< Address or data byte not acknowledged (AF) */
+    I2C_RESULT_BUS_ERROR,           /**< Misplaced START / STOP (BERR) */
+    I2C_RESULT_ARBITRATION_LOST,    /**< Another master won the bus (ARLO) */
+    I2C_RESULT_OVERRUN,             /**< Data register not read in time (OVR) */
+    I2C_RESULT_ABORTED,             /**< Dropped by I2C_enuAbort() */
+}I2C_Result_t;
+
+typedef struct I2C_Transaction I2C_Transaction_t;
+
+/**
+ * @brief Completion callback, called from the I2C or DMA interrupt
+ * @details May submit the next transaction (it is queued behind the others)
+ */
+typedef void (*I2C_Callback_t)(I2C_Transaction_t *transaction);
+
+/******************************************************************************
+ *                        TRANSACTION
+ * @brief Owned by the caller, must stay valid until I2C_Result leaves
+ *        I2C_RESULT_PENDING
+ * @details I2C_TxLength bytes are written, then, if I2C_RxLength is not 0,
+ *          I2C_RxLength bytes are read after a repeated START (register
+ *          read). A read alone has I2C_TxLength = 0
+ * @author Eng.Gemy
+ ******************************************************************************/
+struct I2C_Transaction {
+    uint8_t                 I2C_Address;    /**< 7-bit slave address */
+    const uint8_t          *I2C_TxBuffer;
+    uint16_t                I2C_TxLength;
+    uint8_t                *I2C_RxBuffer;
+    uint16_t                I2C_RxLength;
+    I2C_Callback_t          I2C_Callback;   /**< May be NULL : poll I2C_Result instead */
+    void                   *I2C_Context;    /**< Free for the caller */
+    volatile I2C_Result_t   I2C_Result;     /**< Written by the driver */
+};
+
+/******************************************************************************
+ *                        CONFIGURATION STRUCTURE
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef struct {
+    I2C_Number_t    I2C_Number;
+    I2C_Speed_t     I2C_Speed;
+}I2C_Config_t;
+
+/******************************************************************************
+ *                        FUNCTION PROTOTYPES
+ * @author Eng.Gemy
+ ******************************************************************************/
+
+/**
+ * @brief Configure a bus as master
+ * @details Acquires the I2C and GPIO clocks, configures SCL / SDA, the bus
+ *          timing from the current PCLK1, the interrupts and (i2c_cfg.h) the
+ *          DMA streams
+ *
+ * @param[in] config  Bus and speed
+ *
+ * @return I2C_Status_t (I2C_OK, I2C_NULL_PTR, I2C_WRONG_I2C_NUMBER, I2C_WRONG_SPEED,
+ *         I2C_CLOCK_ERROR, I2C_GPIO_ERROR, I2C_DMA_ERROR)
+ *
+ * @note Registers I2C_vdClockChangeNotifier and I2C_u8ClockChangeBusy, a PCLK1
+ *       change through MCU_enuSetClockProfile re-times the bus
+ */
+I2C_Status_t I2C_enuInit(const I2C_Config_t *config);
+
+/**
+ * @brief Queue a transaction, it starts at once when the bus is idle
+ *
+ * @param[in] bus          I2C_1 .. I2C_3
+ * @param[in] transaction  Transaction, I2C_Result is set to I2C_RESULT_PENDING
+ *
+ * @return I2C_Status_t (I2C_OK, I2C_NULL_PTR, I2C_NOT_INIT, I2C_WRONG_I2C_NUMBER,
+ *         I2C_WRONG_ADDRESS, I2C_WRONG_LENGTH, I2C_QUEUE_FULL, I2C_CLOCK_ERROR
+ *         when the running PCLK1 does not fit the bus speed)
+ *
+ * @note Transactions run one after the other in submission order, each ends
+ *       with a STOP. The callback of one runs before the next one starts
+ */
+I2C_Status_t I2C_enuSubmit(I2C_Number_t bus, I2C_Transaction_t *transaction);
+
+/**
+ * @brief Queue a transaction and wait for its end
+ *
+ * @return I2C_Status_t : as I2C_enuSubmit(), or I2C_TRANSFER_ERROR when
+ *         I2C_Result is not I2C_RESULT_OK
+ *
+ * @warning Busy-waits : not from an interrupt at or above I2C_INTERRUPT_PRIORITY
+ */
+I2C_Status_t I2C_enuTransferSync(I2C_Number_t bus, I2C_Transaction_t *transaction);
+
+/**
+ * @brief Drop every queued transaction and reset the bus peripheral
+ * @details The transaction on the bus is cut (the slave may hold SDA until
+ *          its next clock), every transaction ends with I2C_RESULT_ABORTED
+ *          and its callback
+ *
+ * @return I2C_Status_t (I2C_OK, I2C_NOT_INIT, I2C_WRONG_I2C_NUMBER)
+ */
+I2C_Status_t I2C_enuAbort(I2C_Number_t bus);
+
+/**
+ * @brief Clock change notifier, registered with MCU_enuRegisterClockNotifier by I2C_enuInit()
+ * @details FREQ, CCR and TRISE of every idle bus are computed again from the new PCLK1
+ *
+ * @param[in] phase  MCU_CLOCK_PRE_CHANGE or MCU_CLOCK_POST_CHANGE
+ */
+void I2C_vdClockChangeNotifier(uint8_t phase);
+
+/**
+ * @brief Clock change guard, registered with MCU_enuRegisterClockGuard by I2C_enuInit()
+ *
+ * @return 1 while a transaction is queued or on the bus, 0 otherwise
+ */
+uint8_t I2C_u8ClockChangeBusy(void);
+
+#endif /* I2C_H */
@@ -0,0 +1,47 @@
+/******************************************************************************
+ * @file    I2C_CFG.H
+ * @author  Eng.Gemy
+ * @brief   I2C Driver Configuration File
+ ******************************************************************************/
+
+#ifndef I2C_CFG_H
+#define I2C_CFG_H
+
+/******************************************************************************
+ * @brief Transactions waiting per bus, the one on the bus included
+ * @author  Eng.Gemy
+ ******************************************************************************/
+#define I2C_QUEUE_LENGTH            (8U)
+
+/******************************************************************************
+ * @brief DMA use per bus (I2C_DMA_ENABLED / I2C_DMA_DISABLED)
+ * @details Streams (DMA1) :
+ *          I2C1 : RX stream 0 ch 1, TX stream 7 ch 1
+ *          I2C2 : RX stream 3 ch 7, TX stream 7 ch 7
+ *          I2C3 : RX stream 2 ch 3, TX stream 4 ch 3
+ *          I2C1 and I2C2 share TX stream 7 : only one of them can use DMA.
+ *          SPI2 / SPI3 DMA use streams 0, 3 and 4 too
+ * @author  Eng.Gemy
+ ******************************************************************************/
+#define I2C1_DMA                    I2C_DMA_ENABLED
+#define I2C2_DMA                    I2C_DMA_DISABLED
+#define I2C3_DMA                    I2C_DMA_DISABLED
+
+/******************************************************************************
+ * @brief Shortest write or read phase moved by DMA on a DMA-enabled bus
+ * @details Below it the event interrupt handles each byte : setting up a
+ *          stream costs about as much as 3-4 byte interrupts.
+ *          Reads of 1 or 2 bytes always use interrupts (NACK/STOP timing)
+ * @author  Eng.Gemy
+ ******************************************************************************/
+#define I2C_DMA_MIN_LENGTH          (8U)
+
+/******************************************************************************
+ * @brief NVIC priority of the event, error and DMA interrupts
+ * @details Not more urgent than NVIC_CRITICAL_BASEPRI_THRESHOLD : the queue is
+ *          shared with I2C_enuSubmit() through NVIC_EnterCritical()
+ * @author  Eng.Gemy
+ ******************************************************************************/
+#define I2C_INTERRUPT_PRIORITY      NVIC_PRIORITY_5
+
+#endif /* I2C_CFG_H */
@@ -0,0 +1,98 @@
+/******************************************************************************
+ * @file    I2C_PRIV.H
+ * @author  Eng.Gemy
+ * @brief   I2C Driver Private Header File
+ *          Register map and masks of I2C1-I2C3
+ * @note    This file should NOT be included by application code
+ ******************************************************************************/
+
+#ifndef I2C_PRIV_H
+#define I2C_PRIV_H
+
+#include "LIB/stdtypes.h"
+
+/******************************************************************************
+ *                        BASE ADDRESSES (APB1)
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define I2C1_BASE_ADDRESS           (0x40005400UL)
+#define I2C2_BASE_ADDRESS           (0x40005800UL)
+#define I2C3_BASE_ADDRESS           (0x40005C00UL)
+
+/******************************************************************************
+ *                        REGISTER MASKS
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define I2C_CR1_PE                  (0x00000001UL)
+#define I2C_CR1_START               (0x00000100UL)
+#define I2C_CR1_STOP                (0x00000200UL)
+#define I2C_CR1_ACK                 (0x00000400UL)
+#define I2C_CR1_POS                 (0x00000800UL)  /**< ACK/NACK applies to the next byte (2-byte reception) */
+#define I2C_CR1_SWRST               (0x00008000UL)
+
+#define I2C_CR2_FREQ_MASK           (0x0000003FUL)
+#define I2C_CR2_ITERREN             (0x00000100UL)
+#define I2C_CR2_ITEVTEN             (0x00000200UL)
+#define I2C_CR2_ITBUFEN             (0x00000400UL)  /**< TXE / RXNE also raise the event interrupt */
+#define I2C_CR2_DMAEN               (0x00000800UL)
+#define I2C_CR2_LAST                (0x00001000UL)  /**< NACK after the last DMA byte */
+
+#define I2C_SR1_SB                  (0x00000001UL)
+#define I2C_SR1_ADDR                (0x00000002UL)
+#define I2C_SR1_BTF                 (0x00000004UL)
+#define I2C_SR1_RXNE                (0x00000040UL)
+#define I2C_SR1_TXE                 (0x00000080UL)
+#define I2C_SR1_BERR                (0x00000100UL)
+#define I2C_SR1_ARLO                (0x00000200UL)
+#define I2C_SR1_AF                  (0x00000400UL)
+#define I2C_SR1_OVR                 (0x00000800UL)
+#define I2C_SR1_ERRORS              (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR)
+
+#define I2C_CCR_FS                  (0x00008000UL)  /**< Fast mode, DUTY = 0 : Tlow = 2 x Thigh */
+#define I2C_CCR_MASK                (0x00000FFFUL)
+
+/******************************************************************************
+ *                        TIMING LIMITS
+ * @details Standard mode : Thigh = Tlow = CCR x Tpclk, CCR >= 4, rise 1000 ns
+ *          Fast mode     : Thigh = CCR x Tpclk, Tlow = 2 x CCR x Tpclk, CCR >= 1, rise 300 ns
+ *          TRISE = rise time / Tpclk + 1
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define I2C_MIN_FREQ_MHZ            (2UL)
+#define I2C_MIN_FREQ_FAST_MHZ       (4UL)
+#define I2C_MAX_FREQ_MHZ            (50UL)
+#define I2C_STANDARD_MIN_CCR        (4UL)
+#define I2C_STANDARD_RISE_NS        (1000UL)
+#define I2C_FAST_RISE_NS            (300UL)
+
+#define I2C_STOP_TIMEOUT            (10000UL)       /**< Loop count waiting for the STOP bit to clear */
+
+/******************************************************************************
+ *                        REGISTER STRUCTURE
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef struct
+{
+    volatile uint32_t CR1;      /**< 0x00 Control register 1 */
+    volatile uint32_t CR2;      /**< 0x04 Control register 2 */
+    volatile uint32_t OAR1;     /**< 0x08 Own address register 1 */
+    volatile uint32_t OAR2;     /**< 0x0C Own address register 2 */
+    volatile uint32_t DR;       /**< 0x10 Data register */
+    volatile uint32_t SR1;      /**< 0x14 Status register 1 */
+    volatile uint32_t SR2;      /**< 0x18 Status register 2 (read after SR1 clears ADDR) */
+    volatile uint32_t CCR;      /**< 0x1C Clock control register */
+    volatile uint32_t TRISE;    /**< 0x20 Rise time register */
+    volatile uint32_t FLTR;     /**< 0x24 Filter register */
+}I2C_Regs_t;
+
+/******************************************************************************
+ *                        PERIPHERAL POINTER DEFINITIONS
+ * @author Eng.Gemy
+ ******************************************************************************/
+I2C_Regs_t *I2C_Registers[3] = {
+    (I2C_Regs_t *)I2C1_BASE_ADDRESS,
+    (I2C_Regs_t *)I2C2_BASE_ADDRESS,
+    (I2C_Regs_t *)I2C3_BASE_ADDRESS
+};
+
+#endif /* I2C_PRIV_H */
@@ -49,6 +49,14 @@ typedef enum {
     NVIC_ACTIVE         /**< Interrupt is currently being serviced */
 }NVIC_Active_t;
 
+/******************************************************************************
+ * @brief Interrupt Handler Type
+ * @details Signature of an entry in the vector table
+ * @note Used to install handlers directly in the RAM vector table
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef void (*NVIC_Handler_t)(void);
+
 /******************************************************************************
  * @brief NVIC IRQ Numbers Enumeration
  * @details Defines all external interrupt request numbers (0-239)
@@ -554,7 +562,168 @@ NVIC_Status_t NVIC_SystemReset (void);
  * @author Eng.Gemy
  */
 NVIC_Status_t NVIC_SetPriorityGrouping(uint32_t);
- 
+
+/**
+ * @brief Copy the vector table to RAM and point VTOR at the copy
+ *
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK       Vector table relocated (or already relocated)
+ *
+ * @note Copies the currently active table (flash after reset) so every
+ *       existing handler keeps working after relocation
+ * @note Must be called before NVIC_SetVector()
+ * @note Interrupts are disabled during the copy and the VTOR write
+ *
+ * @author Eng.Gemy
+ */
+NVIC_Status_t NVIC_RelocateVectorTable(void);
+
+/**
+ * @brief Install an interrupt handler directly in the RAM vector table
+ *
+ * @param[in] IRQ_Number  Interrupt request number
+ * @param[in] Handler     Function executed by the core on this interrupt
+ *
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK       Handler installed
+ * @retval NVIC_NOT_OK   Table not relocated or IRQ outside the table
+ * @retval NVIC_NULL_PTR Null handler passed
+ *
+ * @note The handler is entered straight from the vector fetch, without
+ *       going through the driver IRQHandler / local dispatcher / callback chain
+ * @note The handler is responsible for clearing the peripheral flags
+ * @note For application handlers that replace a driver ISR : the UART, DMA
+ *       and SPI drivers keep their USARTx / DMAx_Streamy / SPIx_IRQHandler
+ *       entries, linked in the flash table at build time, so they work
+ *       without NVIC_RelocateVectorTable()
+ *
+ * @example Route USART1 directly to an application handler:
+ *          NVIC_RelocateVectorTable();
+ *          NVIC_SetVector(NVIC_IRQ37, App_Usart1Handler);
+ *
+ * @author Eng.Gemy
+ */
+NVIC_Status_t NVIC_SetVector(NVIC_IRQ_t ,NVIC_Handler_t);
+
+/**
+ * @brief Read the handler currently installed for an interrupt
+ *
+ * @param[in]  IRQ_Number  Interrupt request number
+ * @param[out] Handler     Pointer to store the handler address
+ *
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK       Handler read successfully
+ * @retval NVIC_NOT_OK   IRQ outside the table
+ * @retval NVIC_NULL_PTR Null pointer passed
+ *
+ * @note Reads the active table (RAM copy if relocated, flash otherwise)
+ *
+ * @author Eng.Gemy
+ */
+NVIC_Status_t NVIC_GetVector(NVIC_IRQ_t ,NVIC_Handler_t*);
+
+/**
+ * @brief Enter a BASEPRI critical section
+ *
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK       Critical section entered
+ *
+ * @note Raises BASEPRI to the configured threshold (NVIC_CRITICAL_BASEPRI_THRESHOLD)
+ *       so only interrupts with priority value >= threshold are masked
+ * @note Interrupts more urgent than the threshold are never blocked
+ * @note Calls can be nested, BASEPRI is restored by the outermost exit only
+ * @note BASEPRI is never lowered : entering from a context that already masks
+ *       more interrupts keeps the stronger mask
+ *
+ * @example Protect a flag shared with an ISR:
+ *          NVIC_EnterCritical();
+ *          flag = FALSE;
+ *          NVIC_ExitCritical();
+ *
+ * @warning Must not be called from an ISR whose priority is above the threshold
+ *
+ * @author Eng.Gemy
+ */
+NVIC_Status_t NVIC_EnterCritical(void);
+
+/**
+ * @brief Exit a BASEPRI critical section
+ *
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK       Critical section exited
+ * @retval NVIC_NOT_OK   Called without a matching NVIC_EnterCritical()
+ *
+ * @note Outermost exit restores the BASEPRI value saved at entry and
+ *       updates the longest measured critical section
+ *
+ * @author Eng.Gemy
+ */
+NVIC_Status_t NVIC_ExitCritical(void);
+
+/**
+ * @brief Change the BASEPRI threshold used by NVIC_EnterCritical()
+ *
+ * @param[in] Priority  Raw priority value (NVIC_PRIORITY_1 .. NVIC_PRIORITY_15 encoding)
+ *
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK       Threshold changed
+ * @retval NVIC_NOT_OK   Zero threshold (would disable masking) or critical section active
+ *
+ * @author Eng.Gemy
+ */
+NVIC_Status_t NVIC_SetCriticalThreshold(uint8_t);
+
+/**
+ * @brief Get the longest critical section measured so far
+ *
+ * @param[out] Cycles  Pointer to store the duration in CPU cycles
+ *
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK       Value read successfully
+ * @retval NVIC_NULL_PTR Null pointer passed
+ *
+ * @note Always 0 when NVIC_CRITICAL_MEASURE_ENABLE is 0
+ * @note Divide by HCLK in MHz to get microseconds
+ *
+ * @author Eng.Gemy
+ */
+NVIC_Status_t NVIC_GetMaxCriticalTime(uint32_t*);
+
+/**
+ * @brief Reset the longest critical section measurement
+ *
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK       Measurement cleared
+ *
+ * @author Eng.Gemy
+ */
+NVIC_Status_t NVIC_ResetMaxCriticalTime(void);
+
+/**
+ * @brief Mask every configurable interrupt (PRIMASK)
+ *
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK       Interrupts masked
+ *
+ * @note Used around WFI : a pending interrupt still wakes the core, but its
+ *       handler only runs after NVIC_EnableAllIRQ(), once the clock tree
+ *       has been restored
+ * @note Not nestable, unlike NVIC_EnterCritical()
+ *
+ * @author Eng.Gemy
+ */
+NVIC_Status_t NVIC_DisableAllIRQ(void);
+
+/**
+ * @brief Unmask the interrupts masked by NVIC_DisableAllIRQ() (PRIMASK)
+ *
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK       Interrupts unmasked
+ *
+ * @author Eng.Gemy
+ */
+NVIC_Status_t NVIC_EnableAllIRQ(void);
+
 
 #endif /* MCAL_NVIC_DRIVER_NVIC_H */
 
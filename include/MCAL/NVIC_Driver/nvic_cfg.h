@@ -0,0 +1,48 @@
+/******************************************************************************
+ * @file    NVIC_CFG.H
+ * @author  Eng.Gemy
+ * @brief   NVIC Driver Configuration File
+ *          Compile-time options for the BASEPRI critical section API
+ ******************************************************************************/
+
+#ifndef MCAL_NVIC_DRIVER_NVIC_CFG_H
+#define MCAL_NVIC_DRIVER_NVIC_CFG_H
+
+/******************************************************************************
+ * @brief Default BASEPRI threshold used by NVIC_EnterCritical()
+ * @details Raw 8-bit priority value (STM32F4 implements bits [7:4] only)
+ *          Interrupts with priority value >= threshold are masked inside a
+ *          critical section, interrupts with a lower value (more urgent)
+ *          keep running with unchanged latency
+ * @note    Must NOT be 0 : writing 0 to BASEPRI disables masking entirely
+ * @note    Can be changed at runtime with NVIC_SetCriticalThreshold()
+ * @author  Eng.Gemy
+ ******************************************************************************/
+#define NVIC_CRITICAL_BASEPRI_THRESHOLD     (0x50)
+
+/******************************************************************************
+ * @brief Enable measurement of the longest critical section
+ * @details 1 : DWT cycle counter is started and every outermost critical
+ *              section is timed in CPU cycles
+ *          0 : No measurement, NVIC_GetMaxCriticalTime() always reports 0
+ * @author  Eng.Gemy
+ ******************************************************************************/
+#define NVIC_CRITICAL_MEASURE_ENABLE        (1)
+
+/******************************************************************************
+ * @brief Number of external interrupt vectors copied to the RAM vector table
+ * @details STM32F401CC implements IRQ 0 .. IRQ 84 (SPI4)
+ * @note    Table size = (16 core exceptions + IRQs) words
+ * @author  Eng.Gemy
+ ******************************************************************************/
+#define NVIC_RAM_VECTOR_IRQS                (85)
+
+/******************************************************************************
+ * @brief Alignment of the RAM vector table in bytes
+ * @details VTOR requires the table to be aligned to the next power of two
+ *          of its size : (16 + 85) * 4 = 404 bytes -> 512 bytes
+ * @author  Eng.Gemy
+ ******************************************************************************/
+#define NVIC_RAM_VECTOR_ALIGNMENT           (512)
+
+#endif /* MCAL_NVIC_DRIVER_NVIC_CFG_H */
@@ -44,6 +44,27 @@
 #define SCB_AIRCR   (*(volatile uint32_t *)0xE000ED0C)  /**< SCB Application Interrupt and Reset Control Register */
 #define AIRCR_VECTKEY_MASK    0x05FA0000                /**< VECTKEY field - must write 0x05FA for register writes to take effect (bits 31:16) */
 #define AIRCR_PRIGROUP_MASK   0x00000700                /**< PRIGROUP field - Priority grouping configuration (bits 10:8) */
+#define AIRCR_SYSRESETREQ_MASK 0x00000004               /**< SYSRESETREQ bit 2 - requests a system reset */
+
+/******************************************************************************
+ *                        SCB VTOR REGISTER
+ * @brief System Control Block - Vector Table Offset Register
+ * @details Holds the address of the active vector table (bits 29:9 on STM32F4)
+ * @note At reset VTOR = 0, flash is aliased at 0x00000000 when booting from flash
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define SCB_VTOR    (*(volatile uint32_t *)0xE000ED08)  /**< SCB Vector Table Offset Register */
+#define VTOR_FLASH_BOOT_ADDRESS     (0x08000000UL)      /**< Flash vector table when VTOR still 0 */
+#define NVIC_CORE_EXCEPTIONS        (16UL)              /**< SP + 15 core exception entries before IRQ0 */
+
+/******************************************************************************
+ *                        BASEPRI CRITICAL SECTION DEFINITIONS
+ * @brief Masks used by the critical section API
+ * @details BASEPRI only implements the upper 4 bits on STM32F4
+ * @note DWT cycle counter (LIB/dwt.h) is used to measure critical section length
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define BASEPRI_IMPLEMENTED_MASK    (0xF0UL)                /**< Implemented priority bits [7:4] */
 
 /******************************************************************************
  *                        NVIC REGISTERS STRUCTURE
@@ -399,4 +399,26 @@ NVIC_BP_Status_t NVIC_BP_GetPriority (NVIC_BP_IRQ_t IRQn,NVIC_BP_Priority_t *);
  */
 NVIC_BP_Status_t NVIC_BP_SetPriorityGrouping(NVIC_BP_PriorityGroupBits_t);
 
+/**
+ * @brief Install an interrupt handler in the RAM vector table (Black Pill-specific)
+ * 
+ * @param[in] IRQn     Interrupt request number from NVIC_BP_IRQ_t enum
+ * @param[in] Handler  Function executed directly by the core on this interrupt
+ * 
+ * @return NVIC_BP_Status_t Status of the operation
+ * @retval NVIC_BP_OK        Handler installed successfully
+ * @retval NVIC_BP_WRONG_IRQ Invalid IRQ number for STM32F401CC Black Pill
+ * @retval NVIC_BP_NULL_PTR  Null handler passed
+ * @retval NVIC_BP_NOT_OK    NVIC_RelocateVectorTable() not called yet
+ * 
+ * @note Bypasses the driver IRQHandler -> local handler -> callback chain
+ * 
+ * @example Handle USART1 without the UART driver dispatcher:
+ *          NVIC_RelocateVectorTable();
+ *          NVIC_BP_SetVector(NVIC_USART1_IRQ, App_Usart1Handler);
+ * 
+ * @author Eng.Gemy
+ */
+NVIC_BP_Status_t NVIC_BP_SetVector(NVIC_BP_IRQ_t IRQn, void (*Handler)(void));
+
 #endif /* NVIC_STM32F401CC_H */
\ No newline at end of file
@@ -0,0 +1,205 @@
+/******************************************************************************
+ * @file    PWR.H
+ * @author  Eng.Gemy
+ * @brief   PWR (Power Controller) Driver Header File
+ *          Sleep / STOP mode entry and the wake-up sources that work in STOP:
+ *          RTC wake-up timer (LSI) and EXTI lines on GPIO pins
+ * @note    In STOP mode every 1.2 V domain clock is off : SysTick, UART, SPI,
+ *          DMA and timers are frozen, RAM and registers are kept.
+ *          Only EXTI lines and the RTC (running from LSI) can wake the core
+ ******************************************************************************/
+
+#ifndef PWR_H
+#define PWR_H
+
+#include "LIB/stdtypes.h"
+
+/******************************************************************************
+ *                        PWR STATUS ENUMERATION
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef enum {
+    PWR_NOT_OK = 0,                 /**< Operation failed */
+    PWR_OK,                         /**< Operation completed successfully */
+    PWR_NULL_PTR,                   /**< Null pointer passed */
+    PWR_NOT_INIT,                   /**< PWR_enuInit() was not called */
+    PWR_CLOCK_ERROR,                /**< PWR/SYSCFG clock, LSI or RTC clock could not be started */
+    PWR_TIMEOUT,                    /**< RTC did not acknowledge init or wake-up timer write access */
+    PWR_WRONG_MODE,                 /**< Unknown low-power mode */
+    PWR_WRONG_WAKEUP_TIME,          /**< Wake-up time is 0 or above PWR_enuGetMaxWakeupTime() */
+    PWR_WRONG_EXTI_LINE,            /**< Port or pin out of range */
+    PWR_WRONG_EDGE,                 /**< Unknown edge selection */
+}PWR_Status_t;
+
+/******************************************************************************
+ *                        LOW-POWER MODES
+ * @brief Ordered from the lightest to the deepest
+ * @details Typical STM32F401 figures at 25 C : Sleep ~ 40% of run current,
+ *          STOP (main regulator, flash off) ~ 40 uA / ~ 30 us wake-up,
+ *          STOP (low-power regulator, flash off) ~ 10 uA / ~ 110 us wake-up
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef enum {
+    PWR_MODE_SLEEP = 0,             /**< CPU clock stopped, peripherals and SysTick running */
+    PWR_MODE_STOP_FLASH_PD,         /**< STOP, main regulator on, flash in power-down */
+    PWR_MODE_STOP_LP_FLASH_PD,      /**< STOP, low-power regulator, flash in power-down */
+}PWR_Mode_t;
+
+#define PWR_NUMBER_OF_MODES     (3U)
+
+/******************************************************************************
+ *                        LSI CALIBRATION OPTIONS
+ * @brief Values of PWR_LSI_CALIBRATION in pwr_cfg.h
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define PWR_LSI_CALIBRATION_ENABLED     (1U)    /**< LSI measured against HCLK at init */
+#define PWR_LSI_CALIBRATION_DISABLED    (0U)    /**< PWR_LSI_NOMINAL_HZ is used as is */
+
+/******************************************************************************
+ *                        EXTI EDGE SELECTION
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef enum {
+    PWR_EDGE_RISING = 1,            /**< Wake on rising edge */
+    PWR_EDGE_FALLING,               /**< Wake on falling edge (ex: UART start bit) */
+    PWR_EDGE_BOTH,                  /**< Wake on both edges */
+}PWR_Edge_t;
+
+/******************************************************************************
+ *                        WAKE-UP LINES
+ * @brief Bit positions reported to the wake-up callback
+ * @details Bits 0..15 are the EXTI lines of GPIO pins 0..15
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define PWR_RTC_WAKEUP_LINE     (22U)                           /**< EXTI line of the RTC wake-up timer */
+#define PWR_RTC_WAKEUP_MASK     (1UL << PWR_RTC_WAKEUP_LINE)    /**< RTC wake-up bit in the line mask */
+
+/* PWR_enuGetTime_ms() wraps at midnight of the RTC calendar */
+#define PWR_TIME_WRAP_MS        (86400000UL)
+
+/**
+ * @brief Wake-up callback, called from the EXTI interrupt
+ * @param wakeupLines  Mask of the lines that fired (bit n = EXTI line n)
+ */
+typedef void (*PWR_WakeupCallback_t)(uint32_t wakeupLines);
+
+/******************************************************************************
+ *                        FUNCTION PROTOTYPES
+ * @author Eng.Gemy
+ ******************************************************************************/
+
+/**
+ * @brief Initialize the power controller and the RTC time base
+ * @details Acquires the PWR clock, enables backup domain access, starts LSI,
+ *          clocks the RTC from LSI with a 1 ms sub-second counter and routes
+ *          the RTC wake-up timer to EXTI line 22
+ *
+ * @return PWR_Status_t (PWR_OK, PWR_CLOCK_ERROR, PWR_TIMEOUT)
+ *
+ * @note LSI is measured against HCLK when PWR_LSI_CALIBRATION is enabled,
+ *       its 17-47 kHz spread would otherwise show up in every STOP duration
+ * @note The RTC calendar is reset to 00:00:00, it is only used as a time base
+ */
+PWR_Status_t PWR_enuInit(void);
+
+/**
+ * @brief Enter a low-power mode and wait for an interrupt (WFI)
+ *
+ * @param[in] mode  PWR_MODE_SLEEP, PWR_MODE_STOP_FLASH_PD or PWR_MODE_STOP_LP_FLASH_PD
+ *
+ * @return PWR_Status_t (PWR_OK after wake-up, PWR_WRONG_MODE, PWR_NOT_INIT)
+ *
+ * @warning Call it with interrupts masked (NVIC_DisableAllIRQ) : the wake-up
+ *          interrupt must only run once the caller has restored the clocks
+ * @note After STOP, SYSCLK is HSI : restore it with MCU_enuResumeClock()
+ */
+PWR_Status_t PWR_enuEnterMode(PWR_Mode_t mode);
+
+/**
+ * @brief Program the RTC wake-up timer
+ *
+ * @param[in] time_ms  Time to the wake-up in milliseconds
+ *
+ * @return PWR_Status_t (PWR_OK, PWR_NOT_INIT, PWR_WRONG_WAKEUP_TIME, PWR_TIMEOUT)
+ *
+ * @note Resolution is 16 LSI periods (~0.5 ms), the timer is one-shot from the
+ *       driver point of view : stop it with PWR_enuStopWakeupTimer() on wake-up
+ */
+PWR_Status_t PWR_enuStartWakeupTimer(uint32_t time_ms);
+
+/**
+ * @brief Stop the RTC wake-up timer and clear its flag
+ *
+ * @return PWR_Status_t (PWR_OK, PWR_NOT_INIT)
+ */
+PWR_Status_t PWR_enuStopWakeupTimer(void);
+
+/**
+ * @brief Longest time accepted by PWR_enuStartWakeupTimer()
+ *
+ * @param[out] time_ms  Pointer to store the limit in milliseconds (~32 s)
+ *
+ * @return PWR_Status_t (PWR_OK, PWR_NULL_PTR, PWR_NOT_INIT)
+ */
+PWR_Status_t PWR_enuGetMaxWakeupTime(uint32_t* time_ms);
+
+/**
+ * @brief Read the RTC time base
+ *
+ * @param[out] time_ms  Pointer to store the milliseconds since PWR_enuInit (modulo 24 h)
+ *
+ * @return PWR_Status_t (PWR_OK, PWR_NULL_PTR, PWR_NOT_INIT)
+ *
+ * @note Keeps counting in STOP mode, used to measure the time spent there
+ */
+PWR_Status_t PWR_enuGetTime_ms(uint32_t* time_ms);
+
+/**
+ * @brief Read the LSI frequency used by the RTC time base
+ *
+ * @param[out] lsiHz  Pointer to store the measured (or nominal) LSI frequency
+ *
+ * @return PWR_Status_t (PWR_OK, PWR_NULL_PTR, PWR_NOT_INIT)
+ */
+PWR_Status_t PWR_enuGetLsiFrequency(uint32_t* lsiHz);
+
+/**
+ * @brief Make a GPIO pin a wake-up source (EXTI line = pin number)
+ *
+ * @param[in] port  GPIO_PORT_A .. GPIO_PORT_H
+ * @param[in] pin   GPIO_PIN_0 .. GPIO_PIN_15
+ * @param[in] edge  PWR_EDGE_RISING, PWR_EDGE_FALLING or PWR_EDGE_BOTH
+ *
+ * @return PWR_Status_t (PWR_OK, PWR_WRONG_EXTI_LINE, PWR_WRONG_EDGE, PWR_CLOCK_ERROR)
+ *
+ * @note One port per line : enabling PB3 replaces PA3
+ * @note The pin keeps its GPIO configuration (input, alternate function, ...)
+ */
+PWR_Status_t PWR_enuEnableExtiWakeup(uint8_t port, uint8_t pin, PWR_Edge_t edge);
+
+/**
+ * @brief Remove a GPIO pin from the wake-up sources
+ *
+ * @param[in] pin  GPIO_PIN_0 .. GPIO_PIN_15
+ *
+ * @return PWR_Status_t (PWR_OK, PWR_WRONG_EXTI_LINE)
+ */
+PWR_Status_t PWR_enuDisableExtiWakeup(uint8_t pin);
+
+/**
+ * @brief Register the callback called when a wake-up line fires
+ *
+ * @param[in] callback  Callback or NULL to remove it
+ *
+ * @return PWR_Status_t PWR_OK
+ */
+PWR_Status_t PWR_enuRegisterWakeupCallback(PWR_WakeupCallback_t callback);
+
+/**
+ * @brief Read and clear the lines that fired since the last call
+ *
+ * @return uint32_t Mask of EXTI lines (PWR_RTC_WAKEUP_MASK for the RTC)
+ */
+uint32_t PWR_u32GetWakeupLines(void);
+
+#endif /* PWR_H */
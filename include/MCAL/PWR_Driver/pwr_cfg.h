@@ -0,0 +1,34 @@
+/******************************************************************************
+ * @file    PWR_CFG.H
+ * @author  Eng.Gemy
+ * @brief   PWR Driver Configuration File
+ *          Compile-time options for the RTC time base used in STOP mode
+ ******************************************************************************/
+
+#ifndef PWR_CFG_H
+#define PWR_CFG_H
+
+/******************************************************************************
+ * @brief Nominal LSI frequency in Hz
+ * @details Used as is when the calibration is disabled
+ * @author  Eng.Gemy
+ ******************************************************************************/
+#define PWR_LSI_NOMINAL_HZ              (32000UL)
+
+/******************************************************************************
+ * @brief LSI calibration against HCLK in PWR_enuInit()
+ * @details PWR_LSI_CALIBRATION_ENABLED  : LSI is measured with the DWT cycle
+ *                                         counter, the RTC prescaler is trimmed
+ *          PWR_LSI_CALIBRATION_DISABLED : PWR_LSI_NOMINAL_HZ is trusted
+ * @author  Eng.Gemy
+ ******************************************************************************/
+#define PWR_LSI_CALIBRATION             PWR_LSI_CALIBRATION_ENABLED
+
+/******************************************************************************
+ * @brief Number of RTC sub-second ticks (1 ms each) timed by the calibration
+ * @details Longer is more accurate, PWR_enuInit() blocks for about this many ms
+ * @author  Eng.Gemy
+ ******************************************************************************/
+#define PWR_LSI_CALIBRATION_TICKS       (16UL)
+
+#endif /* PWR_CFG_H */
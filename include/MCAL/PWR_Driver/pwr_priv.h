@@ -0,0 +1,138 @@
+/******************************************************************************
+ * @file    PWR_PRIV.H
+ * @author  Eng.Gemy
+ * @brief   PWR Driver Private Header File
+ *          Register maps and masks of the power controller, the RTC wake-up
+ *          timer, EXTI, SYSCFG external interrupt routing and SCB SCR
+ * @note    This file should NOT be included by application code
+ ******************************************************************************/
+
+#ifndef PWR_PRIV_H
+#define PWR_PRIV_H
+
+#include "LIB/stdtypes.h"
+
+/******************************************************************************
+ *                        BASE ADDRESSES
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define PWR_BASE_ADDRESS            (0x40007000UL)  /**< Power controller (APB1) */
+#define RTC_BASE_ADDRESS            (0x40002800UL)  /**< Real-time clock (APB1, backup domain) */
+#define EXTI_BASE_ADDRESS           (0x40013C00UL)  /**< External interrupt controller (APB2) */
+#define SYSCFG_BASE_ADDRESS         (0x40013800UL)  /**< System configuration controller (APB2) */
+
+/******************************************************************************
+ *                        SCB SYSTEM CONTROL REGISTER
+ * @brief SLEEPDEEP selects STOP instead of Sleep on WFI
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define SCB_SCR                     (*(volatile uint32_t *)0xE000ED10)
+#define SCB_SCR_SLEEPDEEP           (0x00000004UL)  /**< Bit 2 : deep sleep on WFI */
+
+/******************************************************************************
+ *                        PWR_CR MASKS
+ * @details LPDS bit 0, PDDS bit 1, CWUF bit 2, DBP bit 8, FPDS bit 9
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define PWR_CR_LPDS                 (0x00000001UL)  /**< Low-power regulator in STOP */
+#define PWR_CR_PDDS                 (0x00000002UL)  /**< Standby instead of STOP (never set here) */
+#define PWR_CR_CWUF                 (0x00000004UL)  /**< Clear wake-up flag */
+#define PWR_CR_DBP                  (0x00000100UL)  /**< Backup domain (RTC) write access */
+#define PWR_CR_FPDS                 (0x00000200UL)  /**< Flash power-down in STOP */
+
+/******************************************************************************
+ *                        RTC MASKS
+ * @details CR  : WUCKSEL[2:0], BYPSHAD bit 5, FMT bit 6, WUTE bit 10, WUTIE bit 14
+ *          ISR : WUTWF bit 2, INITF bit 6, INIT bit 7, WUTF bit 10
+ *          TR  : SU[3:0] ST[6:4] MNU[11:8] MNT[14:12] HU[19:16] HT[21:20]
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define RTC_CR_WUCKSEL_MASK         (0x00000007UL)  /**< 000 : RTC clock / 16 */
+#define RTC_CR_BYPSHAD              (0x00000020UL)  /**< Read SSR/TR directly, no shadow registers */
+#define RTC_CR_FMT                  (0x00000040UL)  /**< AM/PM format (kept at 24 h) */
+#define RTC_CR_WUTE                 (0x00000400UL)  /**< Wake-up timer enable */
+#define RTC_CR_WUTIE                (0x00004000UL)  /**< Wake-up timer interrupt enable */
+
+#define RTC_ISR_WUTWF               (0x00000004UL)  /**< Wake-up timer write allowed */
+#define RTC_ISR_INITF               (0x00000040UL)  /**< Initialization mode entered */
+#define RTC_ISR_INIT                (0x00000080UL)  /**< Request initialization mode */
+#define RTC_ISR_WUTF                (0x00000400UL)  /**< Wake-up timer flag */
+#define RTC_ISR_CLEAR_WUTF          ((uint32_t)~(RTC_ISR_WUTF | RTC_ISR_INIT))  /**< rc_w0 : only WUTF cleared, INIT left at 0 */
+
+#define RTC_WPR_KEY1                (0xCAUL)        /**< First write protection key */
+#define RTC_WPR_KEY2                (0x53UL)        /**< Second write protection key */
+#define RTC_WPR_LOCK                (0xFFUL)        /**< Any wrong key locks the registers again */
+
+#define RTC_PREDIV_A                (31UL)          /**< Asynchronous prescaler : LSI / 32 ~ 1 kHz */
+#define RTC_PREDIV_A_POS            (16UL)          /**< PREDIV_A position in PRER */
+#define RTC_WAKEUP_DIVIDER          (16UL)          /**< WUCKSEL = 000 : wake-up counter clock = LSI / 16 */
+#define RTC_WUTR_MAX                (0x10000UL)     /**< 16-bit auto-reload, WUTR + 1 periods */
+#define RTC_TIMEOUT_VALUE           (100000UL)      /**< Loop count waiting for INITF / WUTWF */
+
+#define RTC_TR_SECONDS(tr)          ((((tr) >> 4) & 0x7UL) * 10UL + ((tr) & 0xFUL))
+#define RTC_TR_MINUTES(tr)          ((((tr) >> 12) & 0x7UL) * 10UL + (((tr) >> 8) & 0xFUL))
+#define RTC_TR_HOURS(tr)            ((((tr) >> 20) & 0x3UL) * 10UL + (((tr) >> 16) & 0xFUL))
+
+/******************************************************************************
+ *                        EXTI / SYSCFG DEFINITIONS
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define EXTI_GPIO_LINES             (16U)           /**< Lines 0..15 are routed from GPIO pins */
+#define EXTI_LINES_9_5_MASK         (0x000003E0UL)  /**< Lines sharing EXTI9_5_IRQHandler */
+#define EXTI_LINES_15_10_MASK       (0x0000FC00UL)  /**< Lines sharing EXTI15_10_IRQHandler */
+#define SYSCFG_EXTICR_FIELD_BITS    (4U)            /**< 4 bits per line, 4 lines per EXTICR */
+#define SYSCFG_EXTICR_FIELD_MASK    (0xFUL)
+#define SYSCFG_EXTICR_PORT_H        (7UL)           /**< PH is 0b0111 in EXTICR, not 5 */
+
+/******************************************************************************
+ *                        REGISTER STRUCTURES
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef struct
+{
+    volatile uint32_t CR;       /**< 0x00 Power control register */
+    volatile uint32_t CSR;      /**< 0x04 Power control/status register */
+}PWR_Regs_t;
+
+typedef struct
+{
+    volatile uint32_t TR;       /**< 0x00 Time register */
+    volatile uint32_t DR;       /**< 0x04 Date register */
+    volatile uint32_t CR;       /**< 0x08 Control register */
+    volatile uint32_t ISR;      /**< 0x0C Initialization and status register */
+    volatile uint32_t PRER;     /**< 0x10 Prescaler register */
+    volatile uint32_t WUTR;     /**< 0x14 Wake-up timer register */
+    volatile uint32_t CALIBR;   /**< 0x18 Coarse calibration register */
+    volatile uint32_t ALRMAR;   /**< 0x1C Alarm A register */
+    volatile uint32_t ALRMBR;   /**< 0x20 Alarm B register */
+    volatile uint32_t WPR;      /**< 0x24 Write protection register */
+    volatile uint32_t SSR;      /**< 0x28 Sub-second register */
+}RTC_Regs_t;
+
+typedef struct
+{
+    volatile uint32_t IMR;      /**< 0x00 Interrupt mask register */
+    volatile uint32_t EMR;      /**< 0x04 Event mask register */
+    volatile uint32_t RTSR;     /**< 0x08 Rising trigger selection register */
+    volatile uint32_t FTSR;     /**< 0x0C Falling trigger selection register */
+    volatile uint32_t SWIER;    /**< 0x10 Software interrupt event register */
+    volatile uint32_t PR;       /**< 0x14 Pending register (write 1 to clear) */
+}EXTI_Regs_t;
+
+typedef struct
+{
+    volatile uint32_t MEMRMP;   /**< 0x00 Memory remap register */
+    volatile uint32_t PMC;      /**< 0x04 Peripheral mode configuration register */
+    volatile uint32_t EXTICR[4];/**< 0x08 External interrupt configuration registers */
+}SYSCFG_Regs_t;
+
+/******************************************************************************
+ *                        PERIPHERAL POINTER DEFINITIONS
+ * @author Eng.Gemy
+ ******************************************************************************/
+PWR_Regs_t    *PWR_Registers    = (PWR_Regs_t *)PWR_BASE_ADDRESS;
+RTC_Regs_t    *RTC_Registers    = (RTC_Regs_t *)RTC_BASE_ADDRESS;
+EXTI_Regs_t   *EXTI_Registers   = (EXTI_Regs_t *)EXTI_BASE_ADDRESS;
+SYSCFG_Regs_t *SYSCFG_Registers = (SYSCFG_Regs_t *)SYSCFG_BASE_ADDRESS;
+
+#endif /* PWR_PRIV_H */
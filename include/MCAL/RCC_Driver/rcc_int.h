@@ -23,6 +23,14 @@
 #define RCC_PLL_SOURCE_HSI   0U     /**< PLL source is HSI (High Speed Internal) oscillator */
 #define RCC_PLL_SOURCE_HSE   1U     /**< PLL source is HSE (High Speed External) oscillator */
 
+/******************************************************************************
+ *                        RTC CLOCK SOURCE SELECTION
+ * @brief Values of BDCR RTCSEL[1:0]
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define RCC_RTC_SOURCE_LSE   1U     /**< RTC clocked by the 32.768 kHz external crystal */
+#define RCC_RTC_SOURCE_LSI   2U     /**< RTC clocked by the ~32 kHz internal RC oscillator */
+
 
 /******************************************************************************
  *                        BUS SELECTION MASKS
@@ -36,6 +44,16 @@
 #define RCC_APB1_BUS    0b0100U     /**< APB1 Bus identifier (Advanced Peripheral Bus 1 - Low speed) */
 #define RCC_APB2_BUS    0b1000U     /**< APB2 Bus identifier (Advanced Peripheral Bus 2 - High speed) */
 
+/******************************************************************************
+ *                        CLOCK CHANGE PHASES
+ * @brief Phases passed to clock change notifiers around a frequency switch
+ * @details PRE  : clock is about to change, finish any ongoing transfer
+ *          POST : clock has changed, recompute dividers from RCC_GetClockHz()
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define RCC_CLOCK_PRE_CHANGE    0U  /**< Called before the clock tree is modified */
+#define RCC_CLOCK_POST_CHANGE   1U  /**< Called after the clock tree is modified */
+
 /******************************************************************************
  *                   AHB1 PERIPHERAL CLOCK ENABLE MASKS
  * @brief Clock enable masks for peripherals on AHB1 bus
@@ -150,7 +168,7 @@ RCC_AHB_DIVIDED_BY_512 = 0b00000000000000000000000011110000   /**< SYSCLK divide
 /******************************************************************************
  * @brief APB1 Prescaler Enumeration
  * @details Defines division factors for APB1 clock derived from AHB clock
- * @note APB1 is the low-speed peripheral bus (max 45 MHz on STM32F4)
+ * @note APB1 is the low-speed peripheral bus (max 42 MHz on STM32F401)
  * @note Bit positions match CFGR register PPRE1 field encoding
  * @author Eng.Gemy
  ******************************************************************************/
@@ -166,7 +184,7 @@ RCC_APB1_DIVIDED_BY_16  = 0b00000000000000000001110000000000   /**< AHB clock di
 /******************************************************************************
  * @brief APB2 Prescaler Enumeration
  * @details Defines division factors for APB2 clock derived from AHB clock
- * @note APB2 is the high-speed peripheral bus (max 90 MHz on STM32F4)
+ * @note APB2 is the high-speed peripheral bus (max 84 MHz on STM32F401)
  * @note Bit positions match CFGR register PPRE2 field encoding
  * @author Eng.Gemy
  ******************************************************************************/
@@ -204,7 +222,9 @@ typedef enum {
     RCC_WRONG_AHB_PRESCALER,                    /**< Invalid AHB prescaler value */
     RCC_WRONG_APB_PRESCALER,                    /**< Invalid APB prescaler value */
     RCC_WRONG_CLOCK_SOURCE,                     /**< Invalid clock source */
-    RCC_ERROR                                   /**< General RCC error */
+    RCC_ERROR,                                  /**< General RCC error */
+    RCC_PERIPHERAL_NOT_ACQUIRED,                /**< Release without a matching acquire */
+    RCC_CLOCK_OWNERS_FULL                       /**< Acquire beyond RCC_MAX_CLOCK_OWNERS owners */
 }RCC_Status_t;
 
 /******************************************************************************
@@ -213,8 +233,21 @@ typedef enum {
  * @note These should be set by the application to match actual hardware
  * @author Eng.Gemy
  ******************************************************************************/
-uint32_t RCC_HSI_ClockSourceValue;  /**< HSI oscillator frequency (typically 16 MHz) */
-uint32_t RCC_HSE_ClockSourceValue;  /**< HSE oscillator frequency (external crystal, e.g., 8 MHz, 25 MHz) */
+extern uint32_t RCC_HSI_ClockSourceValue;  /**< HSI oscillator frequency (typically 16 MHz) */
+extern uint32_t RCC_HSE_ClockSourceValue;  /**< HSE oscillator frequency (external crystal, e.g., 8 MHz, 25 MHz) */
+
+/******************************************************************************
+ *                   PLL FACTORS STRUCTURE
+ * @brief Set of PLL factors produced by RCC_SolvePLL()
+ * @details Can be passed field by field to RCC_ConfigurePLL()
+ * @author Eng.Gemy
+ ******************************************************************************/
+typedef struct {
+    uint8_t  PLLM;      /**< Input divider (2-63), VCO input 1-2 MHz */
+    uint16_t PLLN;      /**< VCO multiplier (192-432), VCO output 192-432 MHz */
+    uint8_t  PLLP;      /**< System clock divider (2, 4, 6, 8) */
+    uint8_t  PLLQ;      /**< USB/SDIO/RNG divider (2-15), 48 MHz or below */
+}RCC_PLLFactors_t;
 
 /******************************************************************************
  *                   HSI (HIGH SPEED INTERNAL) FUNCTIONS
@@ -279,6 +312,14 @@ RCC_Status_t RCC_DisableHSE(void);
  */
 uint8_t RCC_IsHSEReady(void);
 
+/**
+ * @brief Start HSE oscillator without waiting for it to be ready
+ * @return RCC_Status_t Status of the operation
+ * @retval RCC_OK       HSEON set
+ * @note Poll RCC_IsHSEReady() before using HSE (fast-start boot path)
+ */
+RCC_Status_t RCC_StartHSE(void);
+
 
 /******************************************************************************
  *                   PLL (PHASE-LOCKED LOOP) FUNCTIONS
@@ -349,6 +390,15 @@ RCC_Status_t RCC_DisablePLL(void);
  */
 uint8_t RCC_IsPLLReady(void);
 
+/**
+ * @brief Start PLL without waiting for the lock
+ * @return RCC_Status_t Status of the operation
+ * @retval RCC_OK       PLLON set
+ * @note PLL must be configured before starting
+ * @note Poll RCC_IsPLLReady() before selecting the PLL (fast-start boot path)
+ */
+RCC_Status_t RCC_StartPLL(void);
+
 /******************************************************************************
  *                   SYSTEM CLOCK CONFIGURATION FUNCTIONS
  * @brief Functions to configure system clock source and prescalers
@@ -511,6 +561,202 @@ void RCC_ResetALLPeripheralClock(void);
  */
 RCC_Status_t RCC_ResetPeripheralClock(uint8_t bus,uint64_t PeripheralClockMask);
 
+/******************************************************************************
+ *                   ON-DEMAND PERIPHERAL CLOCK MANAGER
+ * @brief Reference counted wrappers around Enable/DisablePeripheralClock
+ * @details Every driver that owns a peripheral (or a GPIO port, or a DMA
+ *          controller) acquires its clock and releases it when done, the
+ *          clock is gated on the 0 -> 1 transition and gated off on 1 -> 0
+ * @note Clocks already enabled before their first acquire (e.g. from
+ *       MCU_Configs) are pinned : they are never gated off by a release
+ * @author Eng.Gemy
+ ******************************************************************************/
+
+/**
+ * @brief Acquire peripheral clock(s)
+ * @details Increments the reference count of every peripheral in the mask
+ *          and enables the clocks whose count was 0
+ * 
+ * @param[in] bus                  Bus identifier (RCC_AHB1_BUS/AHB2_BUS/APB1_BUS/APB2_BUS)
+ * @param[in] PeripheralClockMask  64-bit mask containing bus and peripheral information
+ * 
+ * @return RCC_Status_t Status of the operation
+ * @retval RCC_OK                                  Clock(s) acquired
+ * @retval RCC_CLOCK_OWNERS_FULL                   One of the peripherals already has
+ *                                                 255 owners, nothing is changed
+ * @retval RCC_WRONG_BUS_SELECTION                 Invalid bus identifier
+ * @retval RCC_WRONG_PEREPHRAL_SELECTION           Invalid peripheral mask
+ * @retval RCC_WRONG_PEREPHRAL_WITHBUS_SELECTION   Peripheral-bus mismatch
+ * 
+ * @note Safe to call from thread and interrupt context (BASEPRI critical section)
+ * @example UART1 owner:
+ *          RCC_AcquirePeripheralClock(RCC_APB2_BUS, RCC_APB2_USART1_CLOCK);
+ */
+RCC_Status_t RCC_AcquirePeripheralClock(uint8_t bus,uint64_t PeripheralClockMask);
+
+/**
+ * @brief Release peripheral clock(s)
+ * @details Decrements the reference count of every peripheral in the mask
+ *          and disables the clocks whose count reached 0
+ * 
+ * @param[in] bus                  Bus identifier (RCC_AHB1_BUS/AHB2_BUS/APB1_BUS/APB2_BUS)
+ * @param[in] PeripheralClockMask  64-bit mask containing bus and peripheral information
+ * 
+ * @return RCC_Status_t Status of the operation
+ * @retval RCC_OK                                  Clock(s) released
+ * @retval RCC_PERIPHERAL_NOT_ACQUIRED             One of the peripherals has no owner,
+ *                                                 nothing is changed
+ * @retval RCC_WRONG_BUS_SELECTION                 Invalid bus identifier
+ * @retval RCC_WRONG_PEREPHRAL_SELECTION           Invalid peripheral mask
+ * @retval RCC_WRONG_PEREPHRAL_WITHBUS_SELECTION   Peripheral-bus mismatch
+ * 
+ * @warning Ensure peripheral is not in use before the last release
+ */
+RCC_Status_t RCC_ReleasePeripheralClock(uint8_t bus,uint64_t PeripheralClockMask);
+
+/**
+ * @brief Get the number of owners of one peripheral clock
+ * 
+ * @param[in]  bus                  Bus identifier (RCC_AHB1_BUS/AHB2_BUS/APB1_BUS/APB2_BUS)
+ * @param[in]  PeripheralClockMask  64-bit mask of a single peripheral
+ * @param[out] refCount             Pointer to store the reference count
+ * 
+ * @return RCC_Status_t Status of the operation
+ * @retval RCC_OK                                  Count read successfully
+ * @retval RCC_NOT_OK                              Null pointer passed
+ * @retval RCC_WRONG_PEREPHRAL_SELECTION           Mask does not select exactly one peripheral
+ * @retval RCC_WRONG_BUS_SELECTION                 Invalid bus identifier
+ * @retval RCC_WRONG_PEREPHRAL_WITHBUS_SELECTION   Peripheral-bus mismatch
+ */
+RCC_Status_t RCC_GetPeripheralClockRefCount(uint8_t bus,uint64_t PeripheralClockMask,uint8_t* refCount);
+
+/**
+ * @brief Get the number of clock gate transitions done by the manager
+ * @details Counts every gate on (0 -> 1) and gate off (1 -> 0) written to
+ *          the xxxENR registers by Acquire/Release since reset
+ * 
+ * @return uint32_t Number of transitions
+ * 
+ * @note Used to measure how often the peripherals are powered up and down
+ */
+uint32_t RCC_GetPeripheralClockTransitions(void);
+
+/******************************************************************************
+ *                   CLOCK TREE SOLVER AND QUERY FUNCTIONS
+ * @brief Functions to compute PLL factors and read back bus frequencies
+ * @author Eng.Gemy
+ ******************************************************************************/
+
+/**
+ * @brief Compute PLL factors for a target system clock
+ * @details Searches M/N/P/Q so that (InputHz / M) * N / P == TargetHz exactly
+ *          while respecting the STM32F401 PLL constraints
+ * 
+ * @param[in]  InputHz   PLL input clock frequency (HSI or HSE value) in Hz
+ * @param[in]  TargetHz  Desired SYSCLK frequency in Hz (max 84 MHz)
+ * @param[out] Factors   Pointer to store the computed factors
+ * 
+ * @return RCC_Status_t Status of the operation
+ * @retval RCC_OK                Factors found
+ * @retval RCC_NOT_OK            Null pointer passed
+ * @retval RCC_WRONG_PLL_CONFIG  No exact solution within the constraints
+ * 
+ * @note Constraints: VCO input 1-2 MHz, VCO output 192-432 MHz,
+ *       SYSCLK <= 84 MHz, PLL48CK <= 48 MHz
+ * @note Highest VCO input is preferred (lowest jitter), then an exact 48 MHz
+ *       PLL48CK output when one exists
+ * 
+ * @example 84 MHz from 25 MHz HSE:
+ *          RCC_PLLFactors_t f;
+ *          RCC_SolvePLL(25000000UL, 84000000UL, &f);  // M=25 N=336 P=4 Q=7
+ */
+RCC_Status_t RCC_SolvePLL(uint32_t InputHz, uint32_t TargetHz, RCC_PLLFactors_t* Factors);
+
+/**
+ * @brief Check the bus clocks of a clock tree before it is programmed
+ * @details Divides SysclkHz by the AHB, APB1 and APB2 prescalers and compares
+ *          PCLK1 and PCLK2 with their datasheet limits
+ * 
+ * @param[in] SysclkHz  SYSCLK frequency the tree will run at in Hz
+ * @param[in] AHB       AHB prescaler of the tree
+ * @param[in] APB1      APB1 prescaler of the tree
+ * @param[in] APB2      APB2 prescaler of the tree
+ * 
+ * @return RCC_Status_t Status of the operation
+ * @retval RCC_OK                   Every bus is within its limit
+ * @retval RCC_WRONG_CLOCK_SOURCE   SysclkHz is 0 or above 84 MHz
+ * @retval RCC_WRONG_APB_PRESCALER  PCLK1 above 42 MHz or PCLK2 above 84 MHz
+ * 
+ * @note Nothing is written, so the check can run before any clock switch
+ * 
+ * @example 84 MHz PLL needs APB1 divided by 2:
+ *          RCC_CheckBusClocks(84000000UL, RCC_AHB_NO_DIVISION,
+ *                             RCC_APB1_DIVIDED_BY_2, RCC_APB2_NO_DIVISION);  // RCC_OK
+ */
+RCC_Status_t RCC_CheckBusClocks(uint32_t SysclkHz, RCC_AHPPrescaler_t AHB,
+                                RCC_APB1Prescaler_t APB1, RCC_APB2Prescaler_t APB2);
+
+/**
+ * @brief Get the current clock frequency of a bus
+ * @details Computes the frequency from the hardware registers (SWS, PLLCFGR,
+ *          HPRE, PPRE1, PPRE2), so it is always in sync with the clock tree
+ * 
+ * @param[in]  bus      Bus identifier (RCC_AHB1_BUS/AHB2_BUS/APB1_BUS/APB2_BUS)
+ * @param[out] clockHz  Pointer to store the frequency in Hz
+ * 
+ * @return RCC_Status_t Status of the operation
+ * @retval RCC_OK                   Frequency read successfully
+ * @retval RCC_NOT_OK               Null pointer passed
+ * @retval RCC_WRONG_BUS_SELECTION  Invalid bus identifier
+ * 
+ * @note AHB1/AHB2 return HCLK (also the CPU and SysTick clock)
+ * @note APB timers run at 2 x PCLK when the APB prescaler is not 1
+ */
+RCC_Status_t RCC_GetClockHz(uint8_t bus, uint32_t* clockHz);
+
+/**
+ * @brief Get the PLL input clock source
+ * 
+ * @param[out] pllSource  Pointer to store RCC_PLL_SOURCE_HSI or RCC_PLL_SOURCE_HSE
+ * 
+ * @return RCC_Status_t RCC_OK, RCC_NOT_OK for a null pointer
+ * 
+ * @note PLLCFGR is kept in STOP mode, used to restart the same PLL on wake-up
+ */
+RCC_Status_t RCC_GetPLLSource(uint8_t* pllSource);
+
+/******************************************************************************
+ *                   LOW-SPEED CLOCK FUNCTIONS
+ * @brief LSI oscillator and RTC clock, both keep running in STOP mode
+ * @author Eng.Gemy
+ ******************************************************************************/
+
+/**
+ * @brief Enable the Low-Speed Internal (LSI) oscillator
+ * 
+ * @return RCC_Status_t Status of the operation
+ * @retval RCC_OK       LSI is ready
+ * @retval RCC_TIMEOUT  LSIRDY not set in time
+ * 
+ * @note LSI is only 17-47 kHz accurate, calibrate it before using it as a time base
+ */
+RCC_Status_t RCC_EnableLSI(void);
+
+/**
+ * @brief Select the RTC clock source and enable the RTC clock
+ * 
+ * @param[in] rtcSource  RCC_RTC_SOURCE_LSE or RCC_RTC_SOURCE_LSI
+ * 
+ * @return RCC_Status_t Status of the operation
+ * @retval RCC_OK                 RTC clock running from the source
+ * @retval RCC_ERROR              Unknown source
+ * 
+ * @warning Backup domain write access (PWR_CR DBP) must be enabled first
+ * @warning RTCSEL can only change through a backup domain reset, which is
+ *          done when another source was already selected (RTC registers lost)
+ */
+RCC_Status_t RCC_SetRTCClock(uint8_t rtcSource);
+
 
 
 
@@ -532,6 +778,7 @@ RCC_Status_t RCC_ResetPeripheralClock(uint8_t bus,uint64_t PeripheralClockMask);
  *       ✓ AHB/APB1/APB2 prescaler configuration
  *       ✓ Peripheral clock enable/disable
  *       ✓ Peripheral reset functionality
+ *       ✓ Reference counted on-demand peripheral clocks
  *       ✓ Comprehensive error checking
  * 
  * @warning Important Clock Configuration Rules:
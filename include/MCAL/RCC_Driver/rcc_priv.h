@@ -24,6 +24,19 @@
 #define HSE_TIMEOUT_VALUE   100000U   /**< HSE stabilization timeout count (external crystal startup time) */
 #define HSI_TIMEOUT_VALUE   50000U    /**< HSI stabilization timeout count (internal oscillator startup time) */
 #define PLL_TIMEOUT_VALUE   1000000U  /**< PLL lock timeout count (PLL stabilization time) */
+#define LSI_TIMEOUT_VALUE   50000U    /**< LSI stabilization timeout count (32 kHz internal RC) */
+
+/******************************************************************************
+ *                        CSR / BDCR MASKS
+ * @brief Low-speed oscillator and RTC clock bits
+ * @details CSR : LSION bit 0, LSIRDY bit 1
+ *          BDCR: RTCSEL[9:8], RTCEN bit 15, BDRST bit 16
+ * @note The CSR bit-field names above RMVF do not match the reference
+ *       manual, the raw masks below are used instead
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define RCC_CSR_LSION_MASK      (0x00000001UL)  /**< LSI oscillator enable */
+#define RCC_CSR_LSIRDY_MASK     (0x00000002UL)  /**< LSI oscillator ready */
 
 /******************************************************************************
  *                        RCC BASE ADDRESS
@@ -76,6 +89,36 @@
 
 
 
+/******************************************************************************
+ *                   CLOCK TREE LIMITS
+ * @brief STM32F401 PLL and clock limits used by the solver and the query
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define RCC_HSI_DEFAULT_VALUE       (16000000UL)   /**< HSI frequency when the application never set it */
+#define RCC_VCO_IN_MIN              (1000000UL)    /**< Minimum VCO input frequency */
+#define RCC_VCO_IN_MAX              (2000000UL)    /**< Maximum VCO input frequency */
+#define RCC_VCO_OUT_MIN             (192000000UL)  /**< Minimum VCO output frequency */
+#define RCC_VCO_OUT_MAX             (432000000UL)  /**< Maximum VCO output frequency */
+#define RCC_SYSCLK_MAX              (84000000UL)   /**< Maximum SYSCLK (STM32F401) */
+#define RCC_APB1_MAX                (42000000UL)   /**< Maximum PCLK1 (STM32F401) */
+#define RCC_APB2_MAX                (84000000UL)   /**< Maximum PCLK2 (STM32F401) */
+#define RCC_PLL48_FREQUENCY         (48000000UL)   /**< USB/SDIO/RNG clock target */
+#define RCC_PLLM_MIN                (2U)
+#define RCC_PLLM_MAX                (63U)
+#define RCC_PLLN_MIN                (192U)
+#define RCC_PLLN_MAX                (432U)
+#define RCC_PLLQ_MIN                (2U)
+#define RCC_PLLQ_MAX                (15U)
+
+/******************************************************************************
+ *                   PERIPHERAL CLOCK MANAGER LIMITS
+ * @brief Sizes used by the reference counted peripheral clock manager
+ * @author Eng.Gemy
+ ******************************************************************************/
+#define RCC_NUMBER_OF_BUSES         (4U)           /**< AHB1, AHB2, APB1, APB2 */
+#define RCC_ENABLE_REG_BITS         (32U)          /**< Enable bits per xxxENR register */
+#define RCC_MAX_CLOCK_OWNERS        (255U)         /**< Owners per peripheral clock, further acquires are refused */
+
 /******************************************************************************
  *                   RCC CONTROL REGISTER (CR) STRUCTURES
  * @brief RCC Control Register bit fields
@@ -59,6 +59,7 @@ typedef enum {
     SPI_ERROR_SELECTING_SLAVE,
     SPI_STATUS_IS_BUSY,
     SPI_WRONG_FLAG_VALUE,
+    SPI_CLOCK_ERROR,
 } SPI_Status_t;
 
 typedef enum {
@@ -239,7 +240,86 @@ typedef struct {
 }SPI_Config_t;
 
 
+/*******************************************************************************
+ * BUILD-TIME IMAGE (SPI_IMAGE_DECLARE)
+ ******************************************************************************/
+// Pins an image drives, bit order of Init_SPI_Pins (MISO, MOSI, SCK, NSS)
+#define SPI_IMAGE_PIN_MISO      (1U << 0)
+#define SPI_IMAGE_PIN_MOSI      (1U << 1)
+#define SPI_IMAGE_PIN_SCK       (1U << 2)
+#define SPI_IMAGE_PIN_NSS       (1U << 3)
+
+// Pins used by a mode / communication mode / NSS management, as chosen by SPI_enuInit
+#define SPI_IMAGE_PINS(mode, communicationMode, nssManagement) \
+    (SPI_IMAGE_PIN_SCK \
+    | ((((uint32_t)(mode) == SPI_MASTER) \
+        ? (((uint32_t)(communicationMode) != SPI_HALF_DUPLEX_2LINES_RX_ONLY) ? SPI_IMAGE_PIN_MOSI : 0U) \
+        : (((uint32_t)(communicationMode) == SPI_FULL_DUPLEX) ? SPI_IMAGE_PIN_MOSI : 0U))) \
+    | ((((uint32_t)(mode) == SPI_MASTER) \
+        ? ((((uint32_t)(communicationMode) == SPI_FULL_DUPLEX) \
+            || ((uint32_t)(communicationMode) == SPI_HALF_DUPLEX_2LINES_RX_ONLY)) ? SPI_IMAGE_PIN_MISO : 0U) \
+        : SPI_IMAGE_PIN_MISO)) \
+    | ((((uint32_t)(mode) == SPI_MASTER) \
+        ? ((((uint32_t)(nssManagement) == SPI_NSS_MASTER_HW_OUTPUT) \
+            || ((uint32_t)(nssManagement) == SPI_NSS_MASTER_HW_INPUT)) ? SPI_IMAGE_PIN_NSS : 0U) \
+        : (((uint32_t)(nssManagement) == SPI_NSS_SLAVE_HW) ? SPI_IMAGE_PIN_NSS : 0U))))
+
+// Registers folded at build time by SPI_IMAGE_DECLARE (CR1 without SPE)
+typedef struct {
+    SPI_Number_t    spiNumber;
+    uint32_t        CR1;
+    uint32_t        CR2;
+    uint32_t        CRCPR;
+    uint32_t        pins;             // SPI_IMAGE_PIN_x set to alternate function
+} SPI_Image_t;
+
+// Checked SPI image in flash, the fields in the order of SPI_Config_t :
+//   [static] SPI_IMAGE_DECLARE(name, spiNumber, communicationMode, mode, crcState, dataLength,
+//                              dataOrder, baudRate, polarityPhase, frameFormat, dmaState,
+//                              nssManagement, crcPolynomial);
+// Every check of SPI_enuInit and of Init_SPI_Pins (NSS management of the mode) runs as
+// _Static_assert. Slave select pins of SPI_NSS_MASTER_SW are not part of the image,
+// configure them with GPIO_enuApplyImage
+#define SPI_IMAGE_DECLARE(name, number, communicationMode, mode, crcState, dataLength, \
+                          dataOrder, baudRate, polarityPhase, frameFormat, dmaState, \
+                          nssManagement, crcPolynomial) \
+    const SPI_Image_t name = { \
+        .spiNumber = (number), \
+        .CR1 = (uint32_t)(communicationMode) | (uint32_t)(mode) | (uint32_t)(crcState) | (uint32_t)(dataLength) \
+             | (uint32_t)(dataOrder) | (uint32_t)(baudRate) | (uint32_t)(polarityPhase) \
+             | ((uint32_t)(nssManagement) & (uint32_t)SPI_NSS_MASTER_SW), \
+        .CR2 = (uint32_t)(frameFormat) | (uint32_t)(dmaState) | ((uint32_t)(nssManagement) & (uint32_t)SPI_NSS_MASTER_HW_OUTPUT), \
+        .CRCPR = (uint32_t)(crcPolynomial), \
+        .pins = SPI_IMAGE_PINS(mode, communicationMode, nssManagement) }; \
+    _Static_assert((uint32_t)(number) <= (uint32_t)SPI4, #name ": wrong SPI number"); \
+    _Static_assert(((uint32_t)(communicationMode) == SPI_FULL_DUPLEX) \
+                   || ((uint32_t)(communicationMode) == SPI_HALF_DUPLEX_2LINES_RX_ONLY) \
+                   || ((uint32_t)(communicationMode) == SPI_HALF_DUPLEX_1LINE_RX_ONLY) \
+                   || ((uint32_t)(communicationMode) == SPI_HALF_DUPLEX_1LINE_TX_ONLY), #name ": wrong communication mode"); \
+    _Static_assert(((uint32_t)(mode) == SPI_SLAVE) || ((uint32_t)(mode) == SPI_MASTER), #name ": wrong mode"); \
+    _Static_assert(((uint32_t)(crcState) & ~(uint32_t)SPI_CRC_ENABLED) == 0U, #name ": wrong CRC state"); \
+    _Static_assert(((uint32_t)(dataLength) & ~(uint32_t)SPI_16_BIT_DATA) == 0U, #name ": wrong data length"); \
+    _Static_assert(((uint32_t)(dataOrder) & ~(uint32_t)SPI_LSB_FIRST) == 0U, #name ": wrong data order"); \
+    _Static_assert(((uint32_t)(baudRate) & ~(uint32_t)SPI_BAUDRATE_DIV256) == 0U, #name ": wrong baud rate"); \
+    _Static_assert(((uint32_t)(polarityPhase) & ~(uint32_t)SPI_ONE_IDLE_SECOND_EDGE) == 0U, #name ": wrong polarity / phase"); \
+    _Static_assert(((uint32_t)(frameFormat) & ~(uint32_t)SPI_TI_MODE) == 0U, #name ": wrong frame format"); \
+    _Static_assert(((uint32_t)(dmaState) & ~(uint32_t)SPI_DMA_TX_RX_ENABLE) == 0U, #name ": wrong DMA state"); \
+    _Static_assert((((uint32_t)(mode) == SPI_MASTER) \
+                    && (((uint32_t)(nssManagement) == SPI_NSS_MASTER_HW_OUTPUT) \
+                        || ((uint32_t)(nssManagement) == SPI_NSS_MASTER_HW_INPUT) \
+                        || ((uint32_t)(nssManagement) == SPI_NSS_MASTER_SW))) \
+                   || (((uint32_t)(mode) == SPI_SLAVE) \
+                    && (((uint32_t)(nssManagement) == SPI_NSS_SLAVE_HW) \
+                        || ((uint32_t)(nssManagement) == SPI_NSS_SLAVE_SW))), #name ": wrong NSS management for the mode"); \
+    _Static_assert((uint32_t)(crcPolynomial) <= 0xFFFFU, #name ": wrong CRC polynomial")
+
 SPI_Status_t SPI_enuInit(SPI_Config_t* SpiConfig);
+// Clocks the SPI and its port(s), applies the pin images and stores an image built by
+// SPI_IMAGE_DECLARE : no field checks at run time (they ran at build time)
+SPI_Status_t SPI_enuInitImage(const SPI_Image_t* SpiImage);
+// Disables the SPI and releases its peripheral and GPIO port clocks
+// (the clocks are acquired by SPI_enuInit and gated off when no other owner uses them)
+SPI_Status_t SPI_enuDeInit(SPI_Number_t spiNumber);
 SPI_Status_t SPI_enuMasterSyncTransmitReceive(SPI_Number_t spiNumber, uint16_t TxData, uint16_t *RxData);
 SPI_Status_t SPI_enuMasterSyncTransmit(SPI_Number_t spiNumber, uint16_t TxData);
 SPI_Status_t SPI_enuMasterSyncReceive(SPI_Number_t spiNumber ,uint16_t *RxData);
@@ -260,4 +340,21 @@ SPI_Status_t SPI_enuDisableInterrupt(SPI_Number_t spiNumber, SPI_Flag_t flag);
 SPI_Status_t SPI_enuRegisterCallback(SPI_Number_t spiNumber, SPI_Flag_t flag, SPI_Callback_t callback);
 uint8_t SPI_u8ReadFlag(SPI_Number_t spiNumber,SPI_Flag_t flag);
 
+// Picks the smallest prescaler giving SCK <= maxSckHz from the live APB clock
+// (APB2 for SPI1/SPI4, APB1 for SPI2/SPI3), result goes to SPI_Config_t.baudRate
+SPI_Status_t SPI_enuCalculateBaudRate(SPI_Number_t spiNumber, uint32_t maxSckHz, SPI_BaudRate_t* baudRate);
+
+// Address of the data register, for a DMA stream driven by the SPI requests
+// (SPI_DMA_TX_ENABLE / SPI_DMA_RX_ENABLE in SPI_Config_t.dmaState)
+SPI_Status_t SPI_enuGetDataRegisterAddress(SPI_Number_t spiNumber, uint32_t* address);
+
+// Time one frame spends on the wire, in ns, from the live CR1 (BR prescaler, DFF)
+// and APB clock : 8 or 16 SCK periods, the gap between back-to-back frames not included
+SPI_Status_t SPI_enuGetFrameTime(SPI_Number_t spiNumber, uint32_t* frameNs);
+
+// Clock change notifier, registered with MCU_enuRegisterClockNotifier by SPI_enuInit / SPI_enuInitImage
+// RCC_CLOCK_PRE_CHANGE  : waits until every master SPI finished its frame (TXE set, BSY cleared)
+// RCC_CLOCK_POST_CHANGE : picks the prescaler keeping SCK at or below the SCK set at init
+void SPI_vdClockChangeNotifier(uint8_t phase);
+
 #endif // SPI_H_
\ No newline at end of file
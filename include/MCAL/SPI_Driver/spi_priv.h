@@ -35,6 +35,9 @@
 #define SPI_GET_FIRST_BIT_MASK       (0x01UL)
 
 #define SPI_NUMBER                   (4UL)
+#define SPI_CLOCK_CHANGE_TIMEOUT     (1000000UL)  // Max polling loops to drain a frame before a clock change
+#define SPI_BUSY_FLAG_MASK           (0b00000000000000000000000010000000UL)
+#define SPI_TXE_FLAG_MASK            (0b00000000000000000000000000000010UL)
 #define NUMBER_OF_FLAGS              (9UL)
 
 //                                            0b10987654321098765432109876543210
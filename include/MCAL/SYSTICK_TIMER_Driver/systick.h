@@ -36,10 +36,15 @@ typedef enum {
 }SYSTICK_Prescaller_t;
 
 
+/* 
+ * ClockValue asking SYSTICK_Init to read HCLK from RCC instead of a hard-coded frequency
+ */
+#define SYSTICK_CLOCK_AUTO    (0UL)
+
 /* 
  * Initializes the SysTick timer with specified clock frequency and prescaler
  * Parameters:
- *   - ClockValue: The system clock frequency in Hz
+ *   - ClockValue: The system clock frequency in Hz (or SYSTICK_CLOCK_AUTO)
  *   - Prescaler: Clock source selection (no prescaler or divide by 8)
  * Returns: SYSTICK_Status_t indicating success or failure reason
  */
@@ -92,4 +97,34 @@ SYSTICK_Status_t SYSTICK_Wait_ms(uint32_t);
  */
 SYSTICK_Status_t SYSTICK_GetCurrentCount(uint32_t *);
 
+/* 
+ * Retrieves the reload value of the SysTick timer
+ * Parameters:
+ *   - Pointer to uint32_t where the reload value will be stored
+ * Returns: SYSTICK_Status_t indicating success or error (e.g., NULL pointer)
+ * Note: One period is (reload value + 1) counts, used to measure time across a wrap
+ */
+SYSTICK_Status_t SYSTICK_GetStartValue(uint32_t *);
+
+/* 
+ * Retrieves the period between two SysTick exceptions, in ns
+ * Parameters:
+ *   - Pointer to uint32_t where the period will be stored
+ * Returns: SYSTICK_Status_t indicating success or error (NULL pointer, zero reload value,
+ *          SYSTICK_WRONG_STARTVALUE for a period above 32-bit ns,
+ *          SYSTICK_NOT_OK when the clock tree gives no HCLK)
+ * Note: Modelled from the live registers : (STK_LOAD + 1) counts of HCLK, or of
+ *       HCLK / 8 when CLKSOURCE is clear, HCLK read from the clock tree
+ */
+SYSTICK_Status_t SYSTICK_GetPeriod(uint32_t *);
+
+/* 
+ * Clock change notifier (register it with MCU_enuRegisterClockNotifier)
+ * Parameters:
+ *   - phase: RCC_CLOCK_PRE_CHANGE or RCC_CLOCK_POST_CHANGE
+ * Note: On RCC_CLOCK_POST_CHANGE the stored clock value is refreshed from RCC
+ *       and the reload value is rescaled so the tick period stays the same
+ */
+void SYSTICK_vdClockChangeNotifier(uint8_t phase);
+
 #endif /* SYSTICK_H */
\ No newline at end of file
@@ -33,6 +33,15 @@
 /* Bit position of the COUNTFLAG in the STK_CTRL register */
 #define SYSTICK_COUNT_FLAG_POS          (16UL)
 
+/* SCB System Handler Priority Register 3 - byte 3 (bits 31:24) holds the SysTick priority */
+#define SYSTICK_SCB_SHPR3               (*(volatile uint32_t *)0xE000ED20)
+
+/* Mask of the SysTick priority field in SHPR3 */
+#define SYSTICK_PRIORITY_CLEAR_MASK     (0x00FFFFFFUL)
+
+/* Lowest priority (0xF0) placed in the SysTick field - keeps SysTick maskable by BASEPRI critical sections */
+#define SYSTICK_LOWEST_PRIORITY         (0xF0000000UL)
+
 
 /* 
  * Structure representing the SysTick timer peripheral registers
@@ -64,6 +64,7 @@ typedef enum {
     UART_GPIO_ERROR,
     UART_TX_BUSY,
     UART_WRONG_DMA_ENABLE,
+    UART_CLOCK_ERROR,
 } UART_Status_t;
 
 typedef enum {
@@ -109,8 +110,12 @@ typedef enum {
     UART_NOT_INIT
 }UART_InitState_t;
 
+// PeripheralClock value asking the driver to read the UART bus clock from RCC
+// (APB2 for UART1/UART6, APB1 for UART2) instead of a hard-coded frequency
+#define UART_PERIPHERAL_CLOCK_AUTO   (0UL)
+
 typedef struct {
-    uint32_t PeripheralClock;          // Peripheral clock frequency in Hz
+    uint32_t PeripheralClock;          // Peripheral clock frequency in Hz (or UART_PERIPHERAL_CLOCK_AUTO)
     UART_Number_t UART_Number;            // Select UART peripheral
     // baude rate in bps
     uint32_t BaudRate;                  // Set baud rate
@@ -132,12 +137,87 @@ typedef struct {
     uint32_t InterruptFlags;             // Enable or disable interrupt flags
 } UART_Config_t;
 
+// Registers folded at build time by UART_IMAGE_DECLARE (CR1 without UE)
+typedef struct {
+    UART_Number_t UART_Number;
+    uint32_t CR1;
+    uint32_t CR2;
+    uint32_t CR3;
+    uint32_t BRR;
+    uint32_t PclkHz;                    // APB clock BRR was computed for
+    uint32_t BaudRate;                  // Kept to re-time BRR when the APB clock differs
+} UART_Image_t;
+
+// USARTDIV in 1/16 (OVER8 = 0) or 1/8 (OVER8 = 1) bit units, rounded : fck / baud in both cases
+#define UART_IMAGE_DIV(pclkHz, baudRate) \
+    (((uint32_t)(baudRate) == 0U) ? 0UL : (((uint32_t)(pclkHz) + ((uint32_t)(baudRate) >> 1U)) / (uint32_t)(baudRate)))
+#define UART_IMAGE_BRR(pclkHz, baudRate, overSampling) \
+    (((uint32_t)(overSampling) == UART_OVERSAMPLING_8) \
+        ? (((UART_IMAGE_DIV(pclkHz, baudRate) >> 3U) << 4U) | (UART_IMAGE_DIV(pclkHz, baudRate) & 0x07U)) \
+        : UART_IMAGE_DIV(pclkHz, baudRate))
+// Baud rate error of a divider in per mille : |fck - div * baud| * 1000 / (div * baud)
+#define UART_IMAGE_ERROR_PERMILLE(pclkHz, baudRate) \
+    ((((uint64_t)(pclkHz) > ((uint64_t)UART_IMAGE_DIV(pclkHz, baudRate) * (uint32_t)(baudRate))) \
+        ? ((uint64_t)(pclkHz) - ((uint64_t)UART_IMAGE_DIV(pclkHz, baudRate) * (uint32_t)(baudRate))) \
+        : (((uint64_t)UART_IMAGE_DIV(pclkHz, baudRate) * (uint32_t)(baudRate)) - (uint64_t)(pclkHz))) * 1000ULL \
+     / (((uint64_t)UART_IMAGE_DIV(pclkHz, baudRate) * (uint32_t)(baudRate)) + 1ULL))
+// Largest baud rate error accepted by UART_IMAGE_DECLARE (both ends off by 2 % still sample right)
+#define UART_IMAGE_MAX_ERROR_PERMILLE   (20U)
+#define UART_IMAGE_INTERRUPTS           (UART_INTERRUPT_ERROR | UART_INTERRUPT_RXNE | UART_INTERRUPT_TC | UART_INTERRUPT_PE)
+
+// Checked UART image in flash, BRR computed for the APB clock pclkHz (a constant) :
+//   [static] UART_IMAGE_DECLARE(name, UART_Number, pclkHz, BaudRate, Parity, OverSampling,
+//                               StopBits, WordLength, Sample, UartEnabled, InterruptFlags);
+// Every check of UART_enuInit, plus the BRR range and the baud rate error, runs as
+// _Static_assert : a wrong configuration stops the build
+#define UART_IMAGE_DECLARE(name, uartNumber, pclkHz, baudRate, parity, overSampling, \
+                           stopBits, wordLength, sample, uartEnabled, interruptFlags) \
+    const UART_Image_t name = { \
+        .UART_Number = (uartNumber), \
+        .CR1 = (uint32_t)(overSampling) | (uint32_t)(parity) | (uint32_t)(wordLength) | (uint32_t)(uartEnabled) \
+             | ((uint32_t)(interruptFlags) & (UART_INTERRUPT_RXNE | UART_INTERRUPT_TC | UART_INTERRUPT_PE)), \
+        .CR2 = (uint32_t)(stopBits), \
+        .CR3 = (uint32_t)(sample) | ((uint32_t)(interruptFlags) & UART_INTERRUPT_ERROR), \
+        .BRR = UART_IMAGE_BRR(pclkHz, baudRate, overSampling), \
+        .PclkHz = (pclkHz), \
+        .BaudRate = (baudRate) }; \
+    _Static_assert((uint32_t)(uartNumber) <= (uint32_t)UART_6, #name ": wrong UART number"); \
+    _Static_assert(((uint32_t)(uartEnabled) & ~(uint32_t)(UART_ENABLE_TRANSMITE | UART_ENABLE_RECEIVE)) == 0U, #name ": wrong UART enable"); \
+    _Static_assert(((uint32_t)(parity) == UART_PARITY_NONE) || ((uint32_t)(parity) == UART_PARITY_EVEN) \
+                   || ((uint32_t)(parity) == UART_PARITY_ODD), #name ": wrong parity"); \
+    _Static_assert(((uint32_t)(overSampling) == UART_OVERSAMPLING_16) || ((uint32_t)(overSampling) == UART_OVERSAMPLING_8), \
+                   #name ": wrong oversampling"); \
+    _Static_assert(((uint32_t)(stopBits) & UART_STOPBITS_MASK) == 0U, #name ": wrong stop bits"); \
+    _Static_assert(((uint32_t)(wordLength) == UART_WORDLENGTH_8B) || ((uint32_t)(wordLength) == UART_WORDLENGTH_9B), \
+                   #name ": wrong word length"); \
+    _Static_assert(((uint32_t)(sample) == UART_THREE_SAMPLE) || ((uint32_t)(sample) == UART_ONE_SAMPLE), #name ": wrong sample"); \
+    _Static_assert(((uint32_t)(interruptFlags) & ~(uint32_t)UART_IMAGE_INTERRUPTS) == 0U, #name ": wrong interrupt flags"); \
+    _Static_assert(((uint32_t)(pclkHz) != 0U) && ((uint32_t)(baudRate) != 0U), #name ": peripheral clock and baud rate needed"); \
+    _Static_assert(UART_IMAGE_DIV(pclkHz, baudRate) >= (((uint32_t)(overSampling) == UART_OVERSAMPLING_8) ? 8U : 16U), \
+                   #name ": baud rate too high for the peripheral clock"); \
+    _Static_assert(UART_IMAGE_DIV(pclkHz, baudRate) <= (((uint32_t)(overSampling) == UART_OVERSAMPLING_8) ? 0x7FFFU : 0xFFFFU), \
+                   #name ": baud rate too low for the peripheral clock"); \
+    _Static_assert(UART_IMAGE_ERROR_PERMILLE(pclkHz, baudRate) <= UART_IMAGE_MAX_ERROR_PERMILLE, #name ": baud rate error above 2 %")
+
+// Returns UART_CLOCK_ERROR, BRR left untouched, when the peripheral clock cannot be read
 UART_Status_t UART_enuInit(UART_Config_t* config);
+// Clocks the UART and its port, applies the TX / RX pin images and stores an image built by
+// UART_IMAGE_DECLARE : no field checks at run time (they ran at build time)
+// BRR is recomputed only when the live APB clock is not the one of the image,
+// UART_CLOCK_ERROR when the live APB clock cannot be read
+UART_Status_t UART_enuInitImage(const UART_Image_t* image);
+// Disables the UART and releases its peripheral and GPIO port clocks
+// (the clocks are acquired by UART_enuInit and gated off when no other owner uses them)
+UART_Status_t UART_enuDeInit(UART_Number_t uartNumber);
 
 UART_Status_t UART_enuSynTransmitBuffer(UART_Number_t uartNumber, const uint8_t* txBuffer, uint16_t size);
 UART_Status_t UART_enuSynReceiveBuffer(UART_Number_t uartNumber, uint8_t* rxBuffer, uint16_t size);
 UART_Status_t UART_enuAsynTransmitBuffer(UART_Number_t uartNumber, UART_AsynBuffer_t* txBuffer);
 UART_Status_t UART_enuAsynReceiveBuffer(UART_Number_t uartNumber, UART_AsynBuffer_t* rxBuffer);
+// Ends a UART_enuAsynReceiveBuffer that will not complete (bytes lost to overruns,
+// a silent peer) : RXNE interrupt off, receiver ready again, the callback is not called
+// receivedCount gets the bytes stored before the abort (0 when no reception was running)
+UART_Status_t UART_enuAbortAsynReceive(UART_Number_t uartNumber, uint16_t* receivedCount);
 
 UART_Status_t UART_enuActivateDMA(UART_Number_t uartNumber, uint32_t enableDmaFlag);
 
@@ -155,5 +235,21 @@ UART_Status_t UART_enuClearFlags(UART_Number_t uartNumber,uint32_t interruptFlag
 
 UART_Status_t UART_enuRegisterCallbacks(UART_Number_t uartNumber, UART_Callbacks_t* callbacks);
 
+// Time one frame spends on the wire, in ns, from the live BRR, CR1 (OVER8, M) and CR2 (STOP)
+// and the APB clock : start bit, data bits (parity included) and stop bits, idle time not included
+UART_Status_t UART_enuGetFrameTime(UART_Number_t uartNumber, uint32_t* frameNs);
+
+// Clock change notifier, registered with MCU_enuRegisterClockNotifier by UART_enuInit / UART_enuInitImage
+// RCC_CLOCK_PRE_CHANGE  : waits until every initialized UART finished its transmission
+// RCC_CLOCK_POST_CHANGE : recomputes BRR from the new APB clock keeping the same baud rate
+//                         when the clock cannot be read, the transfer calls return UART_CLOCK_ERROR
+//                         until the next successful re-time or init
+void UART_vdClockChangeNotifier(uint8_t phase);
+
+// Clock change guard (register it with MCU_enuRegisterClockGuard)
+// Returns 1 while an interrupt-driven buffer or a DMA transmission is still running on
+// an initialized UART, the DMA frame is not fed by the CPU and cannot be re-timed mid-frame
+uint8_t UART_u8ClockChangeBusy(void);
+
 
 #endif // UART_H
\ No newline at end of file
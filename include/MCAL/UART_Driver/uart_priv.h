@@ -32,6 +32,8 @@
 
 
 
+#define UART_CLOCK_CHANGE_TIMEOUT   (1000000UL) // Max polling loops to drain a frame before a clock change
+
 #define UART_TXE_FLAG_POSITION      (7UL)
 #define UART_TC_FLAG_POSITION       (6UL)
 #define UART_RXNE_FLAG_POSITION     (5UL)
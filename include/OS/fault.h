@@ -0,0 +1,106 @@
+#ifndef FAULT_H
+#define FAULT_H
+
+#include "LIB/stdtypes.h"
+
+#define FAULT_DISABLED              (0U)
+#define FAULT_ENABLED               (1U)
+
+#include "OS/fault_cfg.h"
+
+/*
+ * Injection points : where a driver asks whether to behave as if the
+ * hardware reported the error
+ */
+typedef enum {
+    FAULT_POINT_UART_PARITY,        /* USART ISR sees PE, instance = UART_Number_t */
+    FAULT_POINT_UART_FRAMING,       /* USART ISR sees FE */
+    FAULT_POINT_UART_NOISE,         /* USART ISR sees NF */
+    FAULT_POINT_UART_OVERRUN,       /* USART ISR sees ORE */
+    FAULT_POINT_UART_RX_STALL,      /* USART ISR waits FAULT_STALL_CYCLES before reading DR :
+                                       a slow consumer, the next frames overrun for real */
+    FAULT_POINT_SPI_OVERRUN,        /* SPI ISR sees OVR, instance = SPI_Number_t */
+    FAULT_POINT_SPI_MODE_FAULT,     /* SPI ISR sees MODF */
+    FAULT_POINT_SPI_CRC,            /* SPI ISR sees CRCERR
+                                       SPI points call the error callback only : no clear
+                                       sequence runs, DR and SR are left to the transfer */
+    FAULT_POINT_DMA_TRANSFER,       /* DMA ISR sees TEIF, instance = controller << 3 | stream */
+    FAULT_POINT_DMA_FIFO,           /* DMA ISR sees FEIF */
+    FAULT_POINT_CLOCK_READY,        /* Oscillator / PLL never ready : the enable times out,
+                                       instance = FAULT_CLOCK_HSE or FAULT_CLOCK_PLL */
+    FAULT_POINTS
+}FAULT_Point_t;
+
+/* Instances of FAULT_POINT_CLOCK_READY */
+#define FAULT_CLOCK_HSE             (1U)
+#define FAULT_CLOCK_PLL             (2U)
+
+/* Instance mask of a point : bit n = instance n */
+#define FAULT_INSTANCE(instance)    (1UL << (instance))
+#define FAULT_ALL_INSTANCES         (0xFFFFFFFFUL)
+
+/*
+ * Enumeration of possible return status codes for FAULT functions
+ */
+typedef enum {
+    FAULT_NOT_OK,                   /* General error or operation failed */
+    FAULT_OK,                       /* Operation completed successfully */
+    FAULT_NULL_PTR,                 /* Null pointer passed as parameter */
+    FAULT_WRONG_POINT,              /* Not a FAULT_Point_t */
+}FAULT_Status_t;
+
+/*
+ * Injection points in the drivers, compiled out with FAULT_DISABLED
+ */
+#if FAULT == FAULT_ENABLED
+#define FAULT_INJECT(point, instance)   FAULT_u8Hit((point), (uint8_t)(instance))
+#define FAULT_STALL(point, instance)    FAULT_vdStall((point), (uint8_t)(instance))
+#else
+#define FAULT_INJECT(point, instance)   (0U)
+#define FAULT_STALL(point, instance)
+#endif
+
+/*
+ * Function: FAULT_enuConfigure
+ * Description: Sets how often a point injects its fault
+ * Parameters:
+ *   - point: FAULT_Point_t
+ *   - instanceMask: FAULT_INSTANCE(n) of the instances concerned, or FAULT_ALL_INSTANCES
+ *   - oneIn: On average one injection every oneIn passes (1 = every pass, 0 = never)
+ * Returns: FAULT_Status_t (FAULT_OK, FAULT_WRONG_POINT)
+ */
+FAULT_Status_t FAULT_enuConfigure(FAULT_Point_t point, uint32_t instanceMask, uint32_t oneIn);
+
+/*
+ * Function: FAULT_vdReset
+ * Description: Turns every point off, clears the counters and restarts the
+ *              pseudo-random sequence from FAULT_SEED
+ */
+void FAULT_vdReset(void);
+
+/*
+ * Function: FAULT_u8Hit
+ * Description: Decides whether this pass of the point injects its fault
+ * Parameters:
+ *   - point: FAULT_Point_t
+ *   - instance: Peripheral instance passing the point
+ * Returns: 1 to inject, 0 otherwise
+ * Note: Called through FAULT_INJECT from any context, runs from RAM
+ */
+uint8_t FAULT_u8Hit(FAULT_Point_t point, uint8_t instance);
+
+/*
+ * Function: FAULT_vdStall
+ * Description: Busy waits FAULT_STALL_CYCLES when the point hits
+ * Note: Called through FAULT_STALL, inside the ISR being slowed down
+ */
+void FAULT_vdStall(FAULT_Point_t point, uint8_t instance);
+
+/*
+ * Function: FAULT_enuGetInjected
+ * Description: Faults injected by a point since the last reset
+ * Returns: FAULT_Status_t (FAULT_OK, FAULT_NULL_PTR, FAULT_WRONG_POINT)
+ */
+FAULT_Status_t FAULT_enuGetInjected(FAULT_Point_t point, uint32_t *count);
+
+#endif /* FAULT_H */
@@ -0,0 +1,20 @@
+#ifndef FAULT_CFG_H
+#define FAULT_CFG_H
+
+/*  Fault injection at the driver error paths (FAULT_INJECT / FAULT_STALL in the drivers)
+    *   FAULT_DISABLED  (FAULT_INJECT expands to 0, FAULT_STALL to nothing)
+    *   FAULT_ENABLED   (~20 cycles per injection point passed, from RAM)
+    Test builds only : an injected error runs the driver and application error
+    handling as a real one would
+*/
+#define FAULT                       FAULT_DISABLED
+
+/*  Busy loop of an injected RX stall, in CPU cycles
+    At least two frames at the baud rate under test for the next byte to
+    overrun the one in DR (2 x 10 bits at 115200 : ~15000 cycles at 84 MHz) */
+#define FAULT_STALL_CYCLES          (20000UL)
+
+/*  Seed of the pseudo-random sequence, the same faults on every run */
+#define FAULT_SEED                  (0x2545F491UL)
+
+#endif /* FAULT_CFG_H */
@@ -0,0 +1,128 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include "LIB/stdtypes.h"
+#include "MCAL/UART_Driver/uart.h"
+#include "MCAL/PWR_Driver/pwr.h"
+
+/*
+ * Enumeration of possible return status codes for power manager functions
+ */
+typedef enum {
+    PWRM_NOT_OK,                    /* General error or operation failed */
+    PWRM_OK,                        /* Operation completed successfully */
+    PWRM_NULL_PTR,                  /* Null pointer passed as parameter */
+    PWRM_NOT_INIT,                  /* PWRM_enuInit() was not called (only Sleep is used) */
+    PWRM_PWR_ERROR,                 /* Power controller, RTC or EXTI configuration failed */
+    PWRM_CLOCK_ERROR,               /* Clock tree could not be restored after STOP */
+    PWRM_WRONG_MODE,                /* Unknown low-power mode */
+    PWRM_WRONG_UART,                /* Unknown UART number */
+    PWRM_STOP_NOT_LOCKED,           /* PWRM_enuUnlockStop() without a matching lock */
+}PWRM_Status_t;
+
+/*
+ * Low-power modes chosen by the power manager, lightest first
+ * Values match PWR_Mode_t of the PWR driver
+ */
+typedef enum {
+    PWRM_MODE_SLEEP = 0,            /* WFI, peripherals and SysTick keep running */
+    PWRM_MODE_STOP,                 /* STOP, main regulator, flash powered down */
+    PWRM_MODE_STOP_LP,              /* STOP, low-power regulator, flash powered down */
+}PWRM_Mode_t;
+
+#define PWRM_NUMBER_OF_MODES        (3U)
+
+/*
+ * Residency report of one low-power mode
+ */
+typedef struct {
+    uint32_t PWRM_Entries;          /* Number of times the mode was entered */
+    uint32_t PWRM_EarlyWakeups;     /* STOP left by an interrupt before the RTC wake-up */
+    uint64_t PWRM_Residency_us;     /* Total time spent in the mode in microseconds */
+}PWRM_Residency_t;
+
+/*
+ * Function: PWRM_enuInit
+ * Description: Initializes the power controller and the RTC wake-up time base
+ * Returns: PWRM_OK or PWRM_PWR_ERROR
+ * Note: Without it PWRM_enuIdle() only uses Sleep mode
+ *       Call it after MCU_enuInit (the LSI calibration uses HCLK)
+ */
+PWRM_Status_t PWRM_enuInit(void);
+
+/*
+ * Function: PWRM_enuIdle
+ * Description: Puts the MCU in the deepest safe low-power mode until the next interrupt
+ * Parameters:
+ *   - idleTime_ms: Time until the next scheduler deadline
+ *   - sleptTime_ms: Pointer to store the time spent in STOP (SysTick frozen), 0 after Sleep
+ * Returns: PWRM_Status_t (PWRM_OK, PWRM_NULL_PTR, PWRM_CLOCK_ERROR)
+ * Note: Must be called with interrupts masked (NVIC_DisableAllIRQ), the wake-up
+ *       interrupt runs once they are unmasked again, after the clocks are restored
+ *       Mode selection:
+ *       - STOP is only used when idleTime_ms is at least PWRM_STOP_MIN_IDLE_MS,
+ *         no stop lock is held and no peripheral that STOP would break has its
+ *         clock acquired (UART, SPI, DMA, I2C, ADC, timers)
+ *       - The low-power regulator is only used from PWRM_STOP_LP_MIN_IDLE_MS
+ *       - Otherwise Sleep : SysTick wakes the core at the next tick
+ */
+PWRM_Status_t PWRM_enuIdle(uint32_t idleTime_ms, uint32_t *sleptTime_ms);
+
+/*
+ * Function: PWRM_enuLockStop / PWRM_enuUnlockStop
+ * Description: Forbids STOP mode while at least one lock is held (nested)
+ * Returns: PWRM_OK, PWRM_STOP_NOT_LOCKED for an unlock without lock
+ * Note: For work the clock refcounts do not show (ex: a GPIO bit-banged protocol)
+ */
+PWRM_Status_t PWRM_enuLockStop(void);
+PWRM_Status_t PWRM_enuUnlockStop(void);
+
+/*
+ * Function: PWRM_enuEnableUartRxWakeup
+ * Description: Wakes the MCU from STOP on the start bit of a received frame
+ * Parameters:
+ *   - uartNumber: UART_1 (PA10), UART_2 (PA3) or UART_6 (PC7)
+ * Returns: PWRM_Status_t (PWRM_OK, PWRM_WRONG_UART, PWRM_PWR_ERROR)
+ * Note: USART clocks stop in STOP mode, the RX pin is watched by EXTI (falling edge)
+ *       instead. While enabled, an initialized UART with nothing left to transmit
+ *       no longer prevents STOP
+ * Warning: The first frame is received while the clock restarts : at high baud
+ *          rates it is lost, the sender should start with a wake-up byte
+ */
+PWRM_Status_t PWRM_enuEnableUartRxWakeup(UART_Number_t uartNumber);
+
+/*
+ * Function: PWRM_enuDisableUartRxWakeup
+ * Description: Removes the RX pin of a UART from the wake-up sources
+ * Returns: PWRM_Status_t (PWRM_OK, PWRM_WRONG_UART)
+ */
+PWRM_Status_t PWRM_enuDisableUartRxWakeup(UART_Number_t uartNumber);
+
+/*
+ * Function: PWRM_enuEnablePinWakeup
+ * Description: Wakes the MCU from STOP on an edge of a GPIO pin (button, sensor IRQ)
+ * Parameters:
+ *   - port: GPIO_PORT_A .. GPIO_PORT_H
+ *   - pin: GPIO_PIN_0 .. GPIO_PIN_15 (one port per pin number)
+ *   - edge: PWR_EDGE_RISING, PWR_EDGE_FALLING or PWR_EDGE_BOTH
+ * Returns: PWRM_OK or PWRM_PWR_ERROR
+ */
+PWRM_Status_t PWRM_enuEnablePinWakeup(uint8_t port, uint8_t pin, PWR_Edge_t edge);
+
+/*
+ * Function: PWRM_enuGetResidency
+ * Description: Returns the residency report of one low-power mode
+ * Parameters:
+ *   - mode: PWRM_MODE_SLEEP, PWRM_MODE_STOP or PWRM_MODE_STOP_LP
+ *   - residency: Pointer to store the report
+ * Returns: PWRM_Status_t (PWRM_OK, PWRM_NULL_PTR, PWRM_WRONG_MODE)
+ */
+PWRM_Status_t PWRM_enuGetResidency(PWRM_Mode_t mode, PWRM_Residency_t *residency);
+
+/*
+ * Function: PWRM_enuResetResidency
+ * Description: Clears the residency report of every mode
+ */
+PWRM_Status_t PWRM_enuResetResidency(void);
+
+#endif /* POWER_H */
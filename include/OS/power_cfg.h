@@ -0,0 +1,23 @@
+#ifndef POWER_CFG_H
+#define POWER_CFG_H
+
+/*  Deepest mode the power manager may use
+    *   PWRM_MODE_SLEEP     (default, debug sessions : the SWD link is lost in STOP)
+    *   PWRM_MODE_STOP
+    *   PWRM_MODE_STOP_LP
+*/
+#define PWRM_DEEPEST_MODE           PWRM_MODE_SLEEP
+
+/*  Shortest idle time worth a STOP mode (ms)
+    below it the wake-up and clock restart cost more than Sleep saves */
+#define PWRM_STOP_MIN_IDLE_MS       (5UL)
+
+/*  Shortest idle time worth the low-power regulator (ms)
+    it adds ~100 us to the wake-up */
+#define PWRM_STOP_LP_MIN_IDLE_MS    (20UL)
+
+/*  Time kept between the RTC wake-up and the deadline (ms)
+    covers HSE start-up + PLL lock and the 0.5 ms wake-up timer resolution */
+#define PWRM_STOP_WAKEUP_MARGIN_MS  (2UL)
+
+#endif /* POWER_CFG_H */
@@ -23,6 +23,7 @@ typedef enum {
     SCHED_SYSTICK_FAILED_TO_SET_CALLBACK,       /* Failed to register SysTick callback function */
     SCHED_NULL_PTR,                             /* Null pointer passed as parameter */
     SCHED_ERROR_RUNNABLE_STORED_BEFORE,         /* Attempted to register a runnable that already exists in scheduler */
+    SCHED_WRONG_TICK_PERIOD,                    /* Clock of 0 Hz, tick of 0 ms or tick longer than the 24-bit SysTick reload */
 }SCHED_Status_t;
 
 /*
@@ -37,14 +38,34 @@ typedef struct {
     uint32_t Priority;              /* Task priority - higher values indicate higher priority (used for execution ordering) */
 }SCHED_Runnable_t;
 
+/*
+ * Clock value asking SCHED_enuInit to read the current HCLK instead of a hard-coded frequency
+ */
+#define SCHED_CLOCK_AUTO        (0UL)
+
+/*
+ * Idle behaviour of the scheduler main loop between ticks (SCHED_IDLE_MODE in schedule_cfg.h)
+ * SCHED_IDLE_BUSY_WAIT : polls the tick flag
+ * SCHED_IDLE_LOW_POWER : Sleep or STOP through the power manager (OS/power.h)
+ */
+#define SCHED_IDLE_BUSY_WAIT    (0U)
+#define SCHED_IDLE_LOW_POWER    (1U)
+
+/*
+ * Per-runnable stack attribution (SCHED_STACK_MONITOR in schedule_cfg.h)
+ */
+#define SCHED_STACK_MONITOR_DISABLED    (0U)
+#define SCHED_STACK_MONITOR_ENABLED     (1U)
+
 /*
  * Function: SCHED_enuInit
  * Description: Initializes the scheduler system and underlying SysTick timer
  *              Sets up the time base for task scheduling and prepares data structures
  *              Must be called before registering any runnables or starting the scheduler
  * Parameters:
- *   - uint32_t: System clock frequency in Hz (used to calculate SysTick timing)
  *   - uint32_t: Scheduler tick period in milliseconds (time quantum for task scheduling)
+ *   - uint32_t: System clock frequency in Hz (used to calculate SysTick timing)
+ *               SCHED_CLOCK_AUTO reads the current HCLK from the MCU driver
  * Returns: SCHED_Status_t indicating success or specific error condition
  * Note: This function configures the SysTick timer as the time base for the scheduler
  *       All runnable periodicities must be multiples of the tick period
@@ -100,4 +121,16 @@ SCHED_Status_t SCHED_enuRemoveRunnable(SCHED_Runnable_t *);
  */
 void SCHED_enuStart();
 
+/*
+ * Function: SCHED_enuGetRunnableStackUsage
+ * Description: Returns the deepest stack point reached while a runnable was executing
+ * Parameters:
+ *   - uint32_t: Priority of the runnable (its slot in the scheduler)
+ *   - uint32_t*: Pointer to store the depth in bytes from the top of the stack
+ *                (scheduler frames and interrupts taken during the runnable included)
+ * Returns: SCHED_Status_t (SCHED_OK, SCHED_NULL_PTR, SCHED_NOT_OK for a wrong priority)
+ * Note: Stays 0 when SCHED_STACK_MONITOR is disabled or STACK_vdPaint() was not called
+ */
+SCHED_Status_t SCHED_enuGetRunnableStackUsage(uint32_t, uint32_t *);
+
 #endif /* SCHEDULE_H */
\ No newline at end of file
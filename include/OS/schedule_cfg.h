@@ -3,5 +3,20 @@
 
 #define MAX_RUNNABLES       (10)
 
+/*  Idle behaviour between ticks
+    *   SCHED_IDLE_BUSY_WAIT
+    *   SCHED_IDLE_LOW_POWER    (STOP needs PWRM_enuInit(), Sleep only without it)
+*/
+#define SCHED_IDLE_MODE     SCHED_IDLE_BUSY_WAIT
+
+/*  Longest time handed to the power manager in one idle call (ms) */
+#define SCHED_MAX_IDLE_MS   (60000UL)
+
+/*  Stack usage attributed to each runnable (OS/stack.h, needs STACK_vdPaint() in main)
+    *   SCHED_STACK_MONITOR_DISABLED
+    *   SCHED_STACK_MONITOR_ENABLED     (repaint + scan of the free stack around every call)
+*/
+#define SCHED_STACK_MONITOR SCHED_STACK_MONITOR_DISABLED
+
 
 #endif /* SCHEDULE_CFG_H */
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef SDLOG_H
+#define SDLOG_H
+
+#include "LIB/stdtypes.h"
+#include "OS/sdlog_cfg.h"
+
+/* Largest record : a block less its 12-byte header and the 2-byte record length */
+#define SDLOG_MAX_RECORD_SIZE       (498U)
+
+/*
+ * Enumeration of possible return status codes for SDLOG functions
+ */
+typedef enum {
+    SDLOG_NOT_OK,                   /* General error or operation failed */
+    SDLOG_OK,                       /* Operation completed successfully */
+    SDLOG_NULL_PTR,                 /* Null pointer passed as parameter */
+    SDLOG_NOT_INIT,                 /* SDLOG_enuInit() was not called or failed */
+    SDLOG_WRONG_LENGTH,             /* Record length 0 or above SDLOG_MAX_RECORD_SIZE */
+    SDLOG_OVERRUN,                  /* Both blocks wait for the card, the record is dropped */
+    SDLOG_FULL,                     /* No block left in the log area, the record is dropped */
+    SDLOG_SD_ERROR,                 /* Card read failed while looking for the end of the log */
+}SDLOG_Status_t;
+
+/*
+ * Logger statistics
+ */
+typedef struct {
+    uint32_t SDLOG_NextBlock;       /* Log block being filled (0 = SDLOG_FIRST_BLOCK) */
+    uint32_t SDLOG_BlocksWritten;   /* Blocks programmed since SDLOG_enuInit */
+    uint32_t SDLOG_BytesLogged;     /* Record bytes accepted since SDLOG_enuInit */
+    uint32_t SDLOG_RecordsDropped;  /* Records refused with SDLOG_OVERRUN or SDLOG_FULL */
+    uint32_t SDLOG_WriteErrors;     /* Blocks rejected by the card (written again) and failed stream opens */
+    bool_t   SDLOG_Idle;            /* Nothing sealed left to write and the stop token sent */
+}SDLOG_Stats_t;
+
+/*
+ * Function: SDLOG_enuInit
+ * Description: Finds the end of the log with a binary search on the block headers
+ *              and starts filling the block after it
+ * Parameters: None (area from sdlog_cfg.h)
+ * Returns: SDLOG_Status_t (SDLOG_OK, SDLOG_NOT_INIT = SD_enuInit not done, SDLOG_SD_ERROR)
+ * Note: ~20 block reads, call it at boot after SD_enuInit
+ */
+SDLOG_Status_t SDLOG_enuInit(void);
+
+/*
+ * Function: SDLOG_enuAppend
+ * Description: Copies a record into the block being filled, a full block is
+ *              sealed and handed to SDLOG_vdRunnable
+ * Parameters:
+ *   - record: Data
+ *   - length: 1 .. SDLOG_MAX_RECORD_SIZE bytes, a record never spans two blocks
+ * Returns: SDLOG_Status_t (SDLOG_OK, SDLOG_NULL_PTR, SDLOG_NOT_INIT,
+ *          SDLOG_WRONG_LENGTH, SDLOG_OVERRUN, SDLOG_FULL)
+ * Note: Never touches the card : a copy and, once per block, a 12-byte header
+ *       Single producer : call SDLOG_enuAppend and SDLOG_enuFlush from one context
+ *       (a runnable or one interrupt)
+ */
+SDLOG_Status_t SDLOG_enuAppend(const void *record, uint16_t length);
+
+/*
+ * Function: SDLOG_enuFlush
+ * Description: Seals the partly filled block and asks SDLOG_vdRunnable to close
+ *              the stream once it is written (SDLOG_Idle becomes TRUE)
+ * Returns: SDLOG_Status_t (SDLOG_OK, SDLOG_NOT_INIT, SDLOG_OVERRUN = no free
+ *          block yet, call it again)
+ */
+SDLOG_Status_t SDLOG_enuFlush(void);
+
+/*
+ * Function: SDLOG_vdRunnable
+ * Description: Writes the sealed blocks through a CMD25 stream
+ * Parameters: args: Not used (SCHED_Runnable_t.Args)
+ * Note: Register it with the scheduler, every 1 ms for ~500 KB/s : each call
+ *       polls the card once and starts at most one block (a 512-byte DMA),
+ *       opening a stream costs ~20 bytes of commands
+ */
+void SDLOG_vdRunnable(void *args);
+
+/*
+ * Function: SDLOG_enuGetStats
+ * Description: Returns the logger counters
+ * Returns: SDLOG_Status_t (SDLOG_OK, SDLOG_NULL_PTR, SDLOG_NOT_INIT)
+ */
+SDLOG_Status_t SDLOG_enuGetStats(SDLOG_Stats_t *stats);
+
+#endif /* SDLOG_H */
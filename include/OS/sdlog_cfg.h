@@ -0,0 +1,15 @@
+#ifndef SDLOG_CFG_H
+#define SDLOG_CFG_H
+
+/*  Card area holding the log, in 512-byte blocks
+    The log is written once from SDLOG_FIRST_BLOCK upward, SDLOG_enuInit
+    resumes after the last block found there (start from an erased area) */
+#define SDLOG_FIRST_BLOCK           (8192UL)
+#define SDLOG_BLOCK_COUNT           (1048576UL)
+
+/*  Blocks announced to the card per CMD25 stream (ACMD23 pre-erase)
+    The stream is closed and reopened after that many blocks
+    (4 MB : one close / open every ~10 s at 400 KB/s) */
+#define SDLOG_STREAM_BLOCKS         (8192UL)
+
+#endif /* SDLOG_CFG_H */
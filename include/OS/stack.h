@@ -0,0 +1,63 @@
+#ifndef STACK_H
+#define STACK_H
+
+#include "LIB/stdtypes.h"
+
+/*
+ * Enumeration of possible return status codes for stack monitor functions
+ */
+typedef enum {
+    STACK_NOT_OK,                   /* General error or operation failed */
+    STACK_OK,                       /* Operation completed successfully */
+    STACK_NULL_PTR,                 /* Null pointer passed as parameter */
+    STACK_NOT_PAINTED,              /* STACK_vdPaint() was not called */
+    STACK_OVERFLOW,                 /* Lowest word of the reserved stack was written */
+}STACK_Status_t;
+
+/*
+ * Stack usage report in bytes, measured from the top of RAM (_estack)
+ */
+typedef struct {
+    uint32_t STACK_Size;            /* Reserved stack (_Min_Stack_Size of the linker script) */
+    uint32_t STACK_Current;         /* Depth at the time of the call */
+    uint32_t STACK_HighWater;       /* Deepest point reached since STACK_vdPaint() */
+}STACK_Usage_t;
+
+/*
+ * Function: STACK_vdPaint
+ * Description: Fills the unused part of the reserved stack with STACK_PAINT_PATTERN
+ * Note: Call it first in main, before any driver init
+ *       The stack region is _sstack .. _estack from the linker script
+ */
+void STACK_vdPaint(void);
+
+/*
+ * Function: STACK_enuGetUsage
+ * Description: Reads the current depth and scans the painted area for the high-water mark
+ * Parameters:
+ *   - usage: Pointer to store the report
+ * Returns: STACK_Status_t (STACK_OK, STACK_NULL_PTR, STACK_NOT_PAINTED,
+ *          STACK_OVERFLOW with the report filled, high-water = whole stack)
+ * Note: The scan walks the untouched words from the bottom : its cost is the free stack
+ */
+STACK_Status_t STACK_enuGetUsage(STACK_Usage_t *usage);
+
+/*
+ * Function: STACK_u32GetDepth
+ * Description: Returns the current stack depth in bytes (_estack - MSP)
+ */
+uint32_t STACK_u32GetDepth(void);
+
+/*
+ * Function: STACK_vdWindowBegin / STACK_u32WindowEnd
+ * Description: Measures the deepest point reached by a piece of code
+ *              Begin records the high-water mark so far, then repaints the stack
+ *              below the caller; End returns the deepest point reached since Begin
+ * Returns: STACK_u32WindowEnd : depth in bytes from _estack (0 if not painted)
+ * Note: Interrupts taken inside the window are counted with the code they preempted
+ *       Used by the scheduler to attribute stack usage to each runnable
+ */
+void STACK_vdWindowBegin(void);
+uint32_t STACK_u32WindowEnd(void);
+
+#endif /* STACK_H */
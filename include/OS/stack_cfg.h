@@ -0,0 +1,12 @@
+#ifndef STACK_CFG_H
+#define STACK_CFG_H
+
+/*  Word written over the unused stack by STACK_vdPaint()
+    chosen so it is neither a valid RAM / flash address nor a small integer */
+#define STACK_PAINT_PATTERN         (0xC5C5C5C5UL)
+
+/*  Bytes kept untouched below the stack pointer of the painting function
+    covers its own frame and an exception frame (8 words, 26 with FPU context) */
+#define STACK_PAINT_GUARD_BYTES     (128UL)
+
+#endif /* STACK_CFG_H */
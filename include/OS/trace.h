@@ -0,0 +1,137 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "LIB/stdtypes.h"
+
+#define TRACE_DISABLED              (0U)
+#define TRACE_ENABLED               (1U)
+
+#include "OS/trace_cfg.h"
+
+/*
+ * Wire format : the ring is sent as it is, records of 8 bytes, little endian
+ * +-----------+-------+---------+-----+
+ * | timestamp | event | context | arg |
+ * |     4     |   1   |    1    |  2  |
+ * +-----------+-------+---------+-----+
+ *   timestamp : DWT cycle counter, wraps every 2^32 cycles (~51 s at 84 MHz),
+ *               records leave in order so a host unwraps it on every decrease
+ *   event     : TRACE_Event_t
+ *   context   : exception number from IPSR (0 = thread, 15 = SysTick, 16 + n = IRQ n)
+ *   arg       : depends on the event, see TRACE_Event_t
+ *
+ * Every stream starts with TRACE_EVENT_START then TRACE_EVENT_CLOCK (arg = HCLK
+ * in MHz) : microseconds are timestamp / arg
+ *
+ * Chrome trace / Perfetto JSON from a capture : one "tid" per context,
+ * RUNNABLE_START/END and ISR_ENTER/EXIT as "B"/"E" pairs, the rest as
+ * instant ("i") events with arg in "args"
+ */
+
+/*
+ * Events recorded, the values are part of the wire format
+ */
+typedef enum {
+    TRACE_EVENT_START           = 0,    /* TRACE_enuStart, arg 0 */
+    TRACE_EVENT_CLOCK           = 1,    /* arg = HCLK in MHz */
+    TRACE_EVENT_OVERFLOW        = 2,    /* arg = records dropped on a full ring since the last one */
+    TRACE_EVENT_TICK            = 3,    /* Scheduler tick, arg 0 */
+    TRACE_EVENT_RUNNABLE_START  = 4,    /* arg = runnable priority */
+    TRACE_EVENT_RUNNABLE_END    = 5,    /* arg = runnable priority */
+    TRACE_EVENT_ISR_ENTER       = 6,    /* arg = TRACE_SOURCE_xxx | instance */
+    TRACE_EVENT_ISR_EXIT        = 7,    /* arg = as its ISR_ENTER */
+    TRACE_EVENT_LCD_STATE       = 8,    /* arg = LCD operation << 8 | step reached */
+    TRACE_EVENT_DMA_COMPLETE    = 9,    /* arg = controller << 3 | stream */
+    TRACE_EVENT_DMA_HALF        = 10,   /* arg = controller << 3 | stream */
+    TRACE_EVENT_HSERIAL_TX      = 11,   /* Transfer started, arg = size */
+    TRACE_EVENT_HSERIAL_RX      = 12,   /* Reception started, arg = size */
+    TRACE_EVENT_UART_TX_DONE    = 13,   /* TC interrupt, arg = UART_Number_t */
+    TRACE_EVENT_UART_RX_DONE    = 14,   /* Buffer received, arg = UART_Number_t */
+    TRACE_EVENT_USER            = 15,   /* Application, arg free */
+}TRACE_Event_t;
+
+/* ISR_ENTER / ISR_EXIT sources, the low byte of arg is the instance */
+#define TRACE_SOURCE_SYSTICK        (0x0000U)
+#define TRACE_SOURCE_UART           (0x0100U)   /* | UART_Number_t */
+#define TRACE_SOURCE_DMA            (0x0200U)   /* | controller << 3 | stream */
+
+/*
+ * Enumeration of possible return status codes for TRACE functions
+ */
+typedef enum {
+    TRACE_NOT_OK,                   /* General error or operation failed */
+    TRACE_OK,                       /* Operation completed successfully */
+    TRACE_NULL_PTR,                 /* Null pointer passed as parameter */
+}TRACE_Status_t;
+
+/*
+ * Trace statistics
+ */
+typedef struct {
+    uint32_t TRACE_Recorded;        /* Records written to the ring since boot */
+    uint32_t TRACE_Dropped;         /* Records lost on a full ring */
+    uint32_t TRACE_Sent;            /* Records sent since boot */
+    uint32_t TRACE_Pending;         /* Records in the ring, the transfer in progress included */
+}TRACE_Stats_t;
+
+/*
+ * Instrumentation point, compiled out with TRACE_DISABLED
+ */
+#if TRACE == TRACE_ENABLED
+#define TRACE_EVENT(event, arg)     TRACE_vdRecord((event), (uint16_t)(arg))
+#else
+#define TRACE_EVENT(event, arg)
+#endif
+
+/*
+ * Function: TRACE_enuStart
+ * Description: Enables the DWT cycle counter, empties the ring and records
+ *              TRACE_EVENT_START and TRACE_EVENT_CLOCK
+ * Returns: TRACE_Status_t (TRACE_OK, TRACE_NOT_OK = clock not readable)
+ * Note: Call it after MCU_enuInit (the clock record) and HSERIAL_enuInit,
+ *       events before it are ignored
+ */
+TRACE_Status_t TRACE_enuStart(void);
+
+/*
+ * Function: TRACE_vdStop
+ * Description: Stops recording, what is in the ring is still sent
+ */
+void TRACE_vdStop(void);
+
+/*
+ * Function: TRACE_vdRecord
+ * Description: Appends one record to the ring
+ * Parameters:
+ *   - event: TRACE_Event_t
+ *   - arg: Event argument
+ * Note: Called through TRACE_EVENT, from any context (interrupts masked
+ *       for ~15 cycles), runs from RAM
+ *       On a full ring the record is counted and dropped
+ */
+void TRACE_vdRecord(TRACE_Event_t event, uint16_t arg);
+
+/*
+ * Function: TRACE_vdRunnable
+ * Description: Starts a DMA transfer of the oldest records once TRACE_MIN_CHUNK
+ *              are waiting (or after TRACE_FLUSH_CALLS calls), one at a time
+ * Parameters: args: Not used (SCHED_Runnable_t.Args)
+ * Note: Register it with the scheduler at the lowest priority, every 10 ms
+ */
+void TRACE_vdRunnable(void *args);
+
+/*
+ * Function: TRACE_vdTxComplete
+ * Description: Frees the records of the finished transfer
+ * Note: HSERIAL_UartTxCompleteCallback of TRACE_HSERIAL_CHANNEL (hserial_cfg.c)
+ */
+void TRACE_vdTxComplete(void);
+
+/*
+ * Function: TRACE_enuGetStats
+ * Description: Returns the trace counters
+ * Returns: TRACE_Status_t (TRACE_OK, TRACE_NULL_PTR)
+ */
+TRACE_Status_t TRACE_enuGetStats(TRACE_Stats_t *stats);
+
+#endif /* TRACE_H */
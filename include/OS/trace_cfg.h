@@ -0,0 +1,32 @@
+#ifndef TRACE_CFG_H
+#define TRACE_CFG_H
+
+/*  Event recording at the instrumented points (TRACE_EVENT in the drivers)
+    *   TRACE_DISABLED  (TRACE_EVENT expands to nothing)
+    *   TRACE_ENABLED   (~20 cycles per event, from RAM)
+*/
+#define TRACE                       TRACE_DISABLED
+
+/*  Records held in RAM (8 bytes each), a power of two
+    512 records : 4 KB, ~0.5 s of scheduler and SysTick events at a 1 ms tick */
+#define TRACE_RING_LENGTH           (512U)
+
+/*  Channel the ring is drained on
+    HSERIAL_CHANNEL_TRACE exists with TRACE_ENABLED only (hserial_cfg.h) : USART6 TX
+    (PC6) in HSERIAL_MODE_UART_DMA at 921600 baud, TRACE_vdTxComplete as its
+    HSERIAL_UartTxCompleteCallback, enough for a 1 ms tick (~90 KB/s)
+    Another channel must be HSERIAL_MODE_UART_DMA with the same callback */
+#define TRACE_HSERIAL_CHANNEL       HSERIAL_CHANNEL_TRACE
+
+/*  Records waiting before TRACE_vdRunnable starts a transfer
+    Each transfer adds its own UART and DMA events to the ring : small chunks
+    would mostly trace the tracer */
+#define TRACE_MIN_CHUNK             (64U)
+
+/*  Largest transfer, in records (the rest goes with the next call) */
+#define TRACE_MAX_CHUNK             (256U)
+
+/*  TRACE_vdRunnable calls after which fewer than TRACE_MIN_CHUNK records are sent anyway */
+#define TRACE_FLUSH_CALLS           (50U)
+
+#endif /* TRACE_CFG_H */
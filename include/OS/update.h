@@ -0,0 +1,126 @@
+#ifndef UPDATE_H
+#define UPDATE_H
+
+#include "LIB/stdtypes.h"
+#include "OS/update_cfg.h"
+
+/*
+ * Enumeration of possible return status codes for update service functions
+ */
+typedef enum {
+    UPD_NOT_OK,                     /* General error or operation failed */
+    UPD_OK,                         /* Image received, verified and committed to the slot */
+    UPD_NULL_PTR,                   /* Null pointer passed as parameter */
+    UPD_BUSY,                       /* Reception in progress */
+    UPD_NOT_STARTED,                /* UPD_enuStart() was not called or the update ended */
+    UPD_WRONG_HEADER,               /* Bad magic or image size (0 or above UPD_APP_SIZE) */
+    UPD_OVERRUN,                    /* A chunk was overwritten before being programmed */
+    UPD_CRC_ERROR,                  /* CRC32 of the received image differs from the header */
+    UPD_FLASH_ERROR,                /* Erase, program or read-back verify failed */
+    UPD_SERIAL_ERROR,               /* HSERIAL stream could not be started or a reply sent */
+    UPD_NO_IMAGE,                   /* No committed image waiting for installation */
+}UPD_Status_t;
+
+/*
+ * Image header, first 16 bytes sent by the host (little endian)
+ * Followed by the image, the stream is padded with 0xFF to a multiple of UPD_CHUNK_SIZE
+ */
+typedef struct {
+    uint32_t UPD_Magic;             /* UPD_HEADER_MAGIC */
+    uint32_t UPD_ImageSize;         /* Image bytes, 1 .. UPD_APP_SIZE */
+    uint32_t UPD_ImageCrc;          /* CRC32 (IEEE 802.3, reflected, init and xorout 0xFFFFFFFF) of the image */
+    uint32_t UPD_Version;           /* Free for the application, kept in the trailer */
+}UPD_Header_t;
+
+/*
+ * Slot trailer, last UPD_TRAILER_SIZE bytes of the download slot
+ * The header words are programmed once the image CRC matched, then UPD_Pending :
+ * that single word commits the image. The bootloader programs UPD_Installed
+ * after the copy, a copy interrupted by a reset is started again
+ */
+typedef struct {
+    uint32_t UPD_Magic;
+    uint32_t UPD_ImageSize;
+    uint32_t UPD_ImageCrc;
+    uint32_t UPD_Version;
+    uint32_t UPD_Pending;           /* UPD_STATE_MARK once committed, erased before */
+    uint32_t UPD_Installed;         /* UPD_STATE_MARK once copied to the application sector */
+    uint32_t UPD_Reserved[2];
+}UPD_Trailer_t;
+
+#define UPD_HEADER_MAGIC        (0x31445055UL)  /* "UPD1" */
+#define UPD_STATE_MARK          (0x00000000UL)
+#define UPD_TRAILER_SIZE        (32U)
+#define UPD_TRAILER_ADDRESS     (UPD_SLOT_ADDRESS + UPD_SLOT_SIZE - UPD_TRAILER_SIZE)
+
+/*
+ * Bytes sent back to the host
+ */
+#define UPD_REPLY_READY         ((uint8_t)'R')  /* Slot erased, the host may start streaming */
+#define UPD_REPLY_DONE          ((uint8_t)'K')  /* Image committed */
+#define UPD_REPLY_ERROR         ((uint8_t)'E')  /* Update aborted, the slot is not committed */
+
+/*
+ * Function: UPD_enuStart
+ * Description: Erases the download slot, starts the ring reception and sends UPD_REPLY_READY
+ * Returns: UPD_Status_t (UPD_OK, UPD_BUSY, UPD_FLASH_ERROR, UPD_SERIAL_ERROR)
+ * Note: The slot erase takes 1 to 2 s. Code fetches stall while the flash is busy :
+ *       interrupts and scheduler ticks are delayed, not lost (SysTick keeps one pending)
+ */
+UPD_Status_t UPD_enuStart(void);
+
+/*
+ * Function: UPD_enuProcess
+ * Description: Programs the chunks received since the last call, checks the CRC and
+ *              commits the image after the last one
+ * Returns: UPD_BUSY while receiving, UPD_OK once committed (UPD_REPLY_DONE sent),
+ *          UPD_NOT_STARTED, or the error that ended the update (UPD_REPLY_ERROR sent)
+ * Note: Call it at least once per chunk time (10 ms at 1 Mbaud), from the main loop
+ *       or a scheduler runnable. The DMA interrupts only count the filled halves
+ */
+UPD_Status_t UPD_enuProcess(void);
+
+/*
+ * Function: UPD_enuAbort
+ * Description: Stops the reception, the slot stays uncommitted
+ * Returns: UPD_OK or UPD_SERIAL_ERROR
+ */
+UPD_Status_t UPD_enuAbort(void);
+
+/*
+ * Function: UPD_enuGetProgress
+ * Description: Reports the image bytes programmed so far
+ * Parameters:
+ *   - receivedBytes: Pointer to store the bytes programmed in the slot
+ *   - imageSize: Pointer to store the image size (0 until the header is received)
+ * Returns: UPD_Status_t (UPD_OK, UPD_NULL_PTR)
+ */
+UPD_Status_t UPD_enuGetProgress(uint32_t *receivedBytes, uint32_t *imageSize);
+
+/*
+ * Function: UPD_enuInstall
+ * Description: Resets the MCU so the bootloader copies the committed image
+ * Returns: UPD_NO_IMAGE when the slot holds no committed image, does not return otherwise
+ */
+UPD_Status_t UPD_enuInstall(void);
+
+/*
+ * Function: UPD_u32Crc32
+ * Description: Continues a CRC32 over length bytes
+ * Parameters:
+ *   - crc: 0xFFFFFFFF for the first block, then the previous result
+ *   - data: Bytes to add
+ *   - length: Number of bytes
+ * Returns: The running CRC, XOR it with 0xFFFFFFFF after the last block
+ */
+uint32_t UPD_u32Crc32(uint32_t crc, const uint8_t *data, uint32_t length);
+
+/*
+ * Function: BOOT_vdReset
+ * Description: Reset entry of the bootloader (sectors 0-1, .boot section)
+ *              Installs a committed image, then starts the application of sector UPD_APP_SECTOR
+ * Note: Runs before the startup code : no initialized data, no call outside .boot
+ */
+void BOOT_vdReset(void);
+
+#endif /* UPDATE_H */
@@ -0,0 +1,23 @@
+#ifndef UPDATE_CFG_H
+#define UPDATE_CFG_H
+
+/*  HSERIAL channel receiving the image
+    Must be a HSERIAL_MODE_UART_DMA channel with reception and transmission enabled */
+#define UPD_HSERIAL_CHANNEL     HSERIAL_CHANNEL_1
+
+/*  Bytes programmed at once, half of the DMA ring (the ring takes 2 x UPD_CHUNK_SIZE of RAM)
+    Multiple of 4. Programming a chunk (~16 us per word) must end before the next one
+    is received : 1024 bytes take 10.2 ms at 1 Mbaud and ~4.5 ms to program */
+#define UPD_CHUNK_SIZE          (1024U)
+
+/*  Application and download slot (FLASH and UPD_SLOT regions of the linker script)
+    The slot is larger than the application : its last UPD_TRAILER_SIZE bytes hold the trailer */
+#define UPD_APP_SECTOR          (4U)
+#define UPD_APP_ADDRESS         (0x08010000UL)
+#define UPD_APP_SIZE            (0x00010000UL)
+
+#define UPD_SLOT_SECTOR         (5U)
+#define UPD_SLOT_ADDRESS        (0x08020000UL)
+#define UPD_SLOT_SIZE           (0x00020000UL)
+
+#endif /* UPDATE_CFG_H */
@@ -0,0 +1,128 @@
+#ifndef WAVE_H
+#define WAVE_H
+
+#include "LIB/stdtypes.h"
+#include "MCAL/GPIO_Driver/gpio_int.h"
+
+#define WAVE_DISABLED               (0U)
+#define WAVE_ENABLED                (1U)
+
+#include "OS/wave_cfg.h"
+
+/*
+ * GPIO waveform capture : every GPIO_enuSetPinVal / GPIO_enuFlipPinVal on a
+ * captured port stores the port ODR with the DWT cycle counter when it changed.
+ * The capture is exported as a VCD file (GTKWave, sigrok, PulseView) or
+ * measured on target with WAVE_enuMeasure :
+ *
+ *   $timescale 1 ns $end
+ *   $scope module gpio $end
+ *   $var wire 1 ! LCD_E $end
+ *   ...
+ *   #0
+ *   0!
+ *   #1250
+ *   1!
+ *
+ * Pins written with their registers directly (alternate functions, BSRR
+ * outside the GPIO driver) are not seen
+ */
+
+/*
+ * Enumeration of possible return status codes for WAVE functions
+ */
+typedef enum {
+    WAVE_NOT_OK,                    /* General error or operation failed */
+    WAVE_OK,                        /* Operation completed successfully */
+    WAVE_NULL_PTR,                  /* Null pointer passed as parameter */
+    WAVE_WRONG_SIGNAL,              /* 0 or above WAVE_MAX_SIGNALS signals, or a wrong port / pin */
+    WAVE_RUNNING,                   /* Capture still running, call WAVE_vdStop first */
+    WAVE_NO_CAPTURE,                /* WAVE_enuStart was never called */
+}WAVE_Status_t;
+
+/*
+ * One captured pin, the name is the VCD variable name (no spaces)
+ */
+typedef struct {
+    const char *WAVE_Name;
+    GPIO_Port_t WAVE_Port;
+    GPIO_Pin_t WAVE_Pin;
+}WAVE_Signal_t;
+
+/*
+ * Timing of one signal over the capture, in ns
+ * A pulse counts once both of its edges are in the capture
+ */
+typedef struct {
+    uint32_t WAVE_Edges;            /* Rising and falling edges */
+    uint32_t WAVE_MinHighNs;        /* Shortest high pulse (0xFFFFFFFF = none) */
+    uint32_t WAVE_MaxHighNs;        /* Longest high pulse */
+    uint32_t WAVE_MinLowNs;         /* Shortest low pulse (0xFFFFFFFF = none) */
+    uint32_t WAVE_MaxLowNs;         /* Longest low pulse */
+    uint32_t WAVE_PeriodNs;         /* Last rising edge to the one before (0 = fewer than two) */
+    uint32_t WAVE_HighNs;           /* High time within that period : duty = High / Period */
+}WAVE_Measure_t;
+
+/* Receives the VCD text, line by line (newline terminated) */
+typedef void (*WAVE_Output_t)(const uint8_t *line, uint16_t length);
+
+/*
+ * Capture point, compiled out with WAVE_DISABLED
+ */
+#if WAVE == WAVE_ENABLED
+#define WAVE_GPIO(port, odr)        WAVE_vdRecord((uint8_t)(port), (uint16_t)(odr))
+#else
+#define WAVE_GPIO(port, odr)
+#endif
+
+/*
+ * Function: WAVE_enuStart
+ * Description: Enables the DWT cycle counter and starts a new capture of the
+ *              ports of the signals, from their present ODR
+ * Parameters:
+ *   - signals: Pins captured, the table must stay valid until the export
+ *   - count: 1 .. WAVE_MAX_SIGNALS
+ * Returns: WAVE_Status_t (WAVE_OK, WAVE_NULL_PTR, WAVE_WRONG_SIGNAL,
+ *          WAVE_NOT_OK = clock not readable)
+ * Note: Call it after MCU_enuInit (the time base) and after the pins are initialized
+ */
+WAVE_Status_t WAVE_enuStart(const WAVE_Signal_t *signals, uint8_t count);
+
+/*
+ * Function: WAVE_vdStop
+ * Description: Ends the capture, it can be measured or exported after this
+ */
+void WAVE_vdStop(void);
+
+/*
+ * Function: WAVE_vdRecord
+ * Description: Stores the port output when it differs from the last one stored
+ * Parameters:
+ *   - port: GPIO_Port_t written
+ *   - odr: Port ODR after the write
+ * Note: Called through WAVE_GPIO from any context (interrupts masked for a
+ *       few cycles), runs from RAM
+ *       On a full buffer the change is counted as dropped
+ */
+void WAVE_vdRecord(uint8_t port, uint16_t odr);
+
+/*
+ * Function: WAVE_enuMeasure
+ * Description: Pulse widths and last period of one signal of the capture
+ * Parameters:
+ *   - signalIndex: Index in the table given to WAVE_enuStart
+ *   - measure: Pointer to store the timing
+ * Returns: WAVE_Status_t (WAVE_OK, WAVE_NULL_PTR, WAVE_WRONG_SIGNAL,
+ *          WAVE_RUNNING, WAVE_NO_CAPTURE)
+ */
+WAVE_Status_t WAVE_enuMeasure(uint8_t signalIndex, WAVE_Measure_t *measure);
+
+/*
+ * Function: WAVE_enuExportVcd
+ * Description: Sends the capture as a VCD file to output, one line per call
+ * Returns: WAVE_Status_t (WAVE_OK, WAVE_NULL_PTR, WAVE_RUNNING, WAVE_NO_CAPTURE)
+ * Note: Changes dropped on a full buffer are reported in a $comment line
+ */
+WAVE_Status_t WAVE_enuExportVcd(WAVE_Output_t output);
+
+#endif /* WAVE_H */
@@ -0,0 +1,20 @@
+#ifndef WAVE_CFG_H
+#define WAVE_CFG_H
+
+/*  GPIO output capture (WAVE_GPIO in GPIO_enuSetPinVal / GPIO_enuFlipPinVal)
+    *   WAVE_DISABLED  (WAVE_GPIO expands to nothing)
+    *   WAVE_ENABLED   (~25 cycles per GPIO write, from RAM)
+*/
+#define WAVE                        WAVE_DISABLED
+
+/*  Output changes held in RAM (8 bytes each), the capture ends when it is full
+    1024 changes : 8 KB, ~100 LCD characters (E, RS and D0..D7 toggles) */
+#define WAVE_BUFFER_LENGTH          (1024U)
+
+/*  Most signals in one capture (one VCD variable each) */
+#define WAVE_MAX_SIGNALS            (16U)
+
+/*  Longest VCD line handed to the output, the newline included */
+#define WAVE_LINE_SIZE              (64U)
+
+#endif /* WAVE_CFG_H */
@@ -2,14 +2,59 @@
 #ifndef TEST_H_
 #define TEST_H_
 
+#include "LIB/stdtypes.h"
+
+/* Done flag of a test : 0 while it runs, then its verdict */
+#define TEST_RUNNING                (0U)
+#define TEST_PASSED                 (1U)
+#define TEST_FAILED                 (2U)
+
+/*
+ * Shared fixture of the measuring tests (testFixture.c)
+ *   TEST_u32Setup          clock tree of MCU_Configs, BENCH time base started, returns HCLK in Hz
+ *   TEST_vdDone            stores TEST_PASSED / TEST_FAILED in the flag the debugger waits for
+ *                          and parks the core
+ *   TEST_u32CyclesToNs/Us  BENCH_u32Stop cycles at clockHz to time
+ *   TEST_s32ErrorPermille  (measured - reference) * 1000 / reference, 0 for a 0 reference
+ */
+uint32_t TEST_u32Setup(void);
+void TEST_vdDone(volatile uint8_t *doneFlag, bool_t passed);
+uint32_t TEST_u32CyclesToNs(uint32_t cycles, uint32_t clockHz);
+uint32_t TEST_u32CyclesToUs(uint32_t cycles, uint32_t clockHz);
+sint32_t TEST_s32ErrorPermille(uint32_t measured, uint32_t reference);
+
 void LcdTest();
 int gpioTest(void);
 void SwitchTest();
 void sevsegTest();
 void nvicTest();
+void nvicVectorTest();
 void testLinkerScript();
+void flashAcceleratorBenchmark(void);
+void ramFuncLatencyTest(void);
+void fastBootTest(void);
+void lowPowerSchedulerTest(void);
+void stackMonitorTest(void);
+void nvmStoreTest(void);
+void flashProtectionTest(void);
+void firmwareUpdateTest(void);
+void adcScanTest(void);
+void i2cQueueTest(void);
+void sdLogTest(void);
+void traceTest(void);
+void dspBenchmarkTest(void);
+void driverBenchmarkTest(void);
+void timingModelTest(void);
+void hserialThroughputTest(void);
+void waveTest(void);
+void faultTest(void);
+void configImageTest(void);
+void boardTest(void);
+void bitsTest(void);
 void AsynchLcdTest();
 void uartTest();
+void uartClockScalingTest();
+void uartClockGatingTest();
 void DMA_Test_Transmit(void);
 void DMA_Test_Receive(void);
 
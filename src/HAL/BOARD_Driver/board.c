@@ -0,0 +1,62 @@
+
+#include "LIB/stdtypes.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "MCAL/GPIO_Driver/gpio_int.h"
+
+#include "HAL/BOARD_Driver/board_cfg.h"
+#include "HAL/BOARD_Driver/board.h"
+
+#define BOARD_PORTS                 (6U)
+
+/* Every field of every described pin, fitted or not */
+BOARD_ALL_PINS(BOARD_X_CHECK, 0)
+
+/* Two fitted lists sharing a pin */
+BOARD_PORT_CHECK(GPIO_PORT_A, BOARD_FITTED_PINS);
+BOARD_PORT_CHECK(GPIO_PORT_B, BOARD_FITTED_PINS);
+BOARD_PORT_CHECK(GPIO_PORT_C, BOARD_FITTED_PINS);
+BOARD_PORT_CHECK(GPIO_PORT_D, BOARD_FITTED_PINS);
+BOARD_PORT_CHECK(GPIO_PORT_E, BOARD_FITTED_PINS);
+BOARD_PORT_CHECK(GPIO_PORT_H, BOARD_FITTED_PINS);
+
+/* One image per port, all the fitted pins of the port folded together */
+static const GPIO_Image_t BoardImages[BOARD_PORTS] = {
+    BOARD_PORT_IMAGE_INITIALIZER(GPIO_PORT_A, BOARD_FITTED_PINS),
+    BOARD_PORT_IMAGE_INITIALIZER(GPIO_PORT_B, BOARD_FITTED_PINS),
+    BOARD_PORT_IMAGE_INITIALIZER(GPIO_PORT_C, BOARD_FITTED_PINS),
+    BOARD_PORT_IMAGE_INITIALIZER(GPIO_PORT_D, BOARD_FITTED_PINS),
+    BOARD_PORT_IMAGE_INITIALIZER(GPIO_PORT_E, BOARD_FITTED_PINS),
+    BOARD_PORT_IMAGE_INITIALIZER(GPIO_PORT_H, BOARD_FITTED_PINS),
+};
+
+BOARD_Status_t BOARD_enuInit(void){
+    BOARD_Status_t retStatus = BOARD_OK;
+
+    for(uint8_t i = 0; i < BOARD_PORTS; i++){
+        /* Ports without fitted pins are left at their reset state */
+        if(BoardImages[i].PinMask != 0UL){
+            if(GPIO_OK != GPIO_enuApplyImage(&BoardImages[i])){
+                retStatus = BOARD_GPIO_ERROR;
+                break;
+            }else{
+                // continue
+            }
+        }else{
+            // nothing fitted on this port
+        }
+    }
+
+    return retStatus;
+}
+
+bool_t BOARD_boolIsFitted(GPIO_Port_t port, GPIO_Pin_t pin){
+    bool_t fitted = FALSE;
+
+    if(((uint32_t)port < BOARD_PORTS) && ((BoardImages[port].PinMask & GPIO_IMAGE_PIN_MASK(pin)) != 0UL)){
+        fitted = TRUE;
+    }else{
+        // not fitted, or port out of range
+    }
+
+    return fitted;
+}
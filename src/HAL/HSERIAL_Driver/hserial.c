@@ -3,11 +3,20 @@
 #include "LIB/stdtypes.h"
 #include "MCAL/UART_Driver/uart.h"
 #include "MCAL/NVIC_Driver/nvic_stm32f401cc.h"
+#include "MCAL/NVIC_Driver/nvic_cfg.h"
 #include "MCAL/DMA_Driver/dma.h"
 #include "MCAL/SPI_Driver/spi.h"
+#include "HAL/MCU_Driver/mcu.h"
 
 #include "HAL/HSERIAL_Driver/hserial.h"
 #include "HAL/HSERIAL_Driver/hserial_cfg.h"
+#include "OS/trace.h"
+
+// The USART, DMA and SPI handlers share driver state with NVIC_EnterCritical() sections,
+// a priority more urgent than the critical threshold is lowered to it so BASEPRI can mask them
+#define HSERIAL_MASKABLE_PRIORITY(priority) \
+    ((NVIC_BP_Priority_t)(((uint32_t)(priority) < (uint32_t)NVIC_CRITICAL_BASEPRI_THRESHOLD) ? (uint32_t)NVIC_CRITICAL_BASEPRI_THRESHOLD : (uint32_t)(priority)))
+
 typedef struct {
     HSERIAL_Spi_Mode_t         HSERIAL_SpiMode;
     uint16_t* Buffer;
@@ -55,7 +64,7 @@ static const H_Dma_info_t HSERIAL_UART_TX_DMA_Map[] = {
     },
     [HSERIAL_UART_6] = {
         .DMA_Controller = DMA2,
-        .DMA_Stream     = DMA_STREAM1,
+        .DMA_Stream     = DMA_STREAM6,   // stream 1 channel 5 is USART6_RX
         .DMA_Channel    = DMA_CHANNEL5
     }
 };
@@ -93,7 +102,7 @@ static const HSERIAL_Spi_Number_t HSERIAL_SPI_NVIC_IRQ_Map[] = {
 static const HSERIAL_Uart_Number_t HSERIAL_DMA_NVIC_IRQ_Map[] = {
     NVIC_DMA2_STREAM5_IRQ, // for USART1 RX
     NVIC_DMA1_STREAM5_IRQ, // for USART2 RX
-    NVIC_DMA2_STREAM1_IRQ  // for USART6 RX
+    NVIC_DMA2_STREAM2_IRQ  // for USART6 RX
 };
 extern const HSERIAL_Config_t HSERIAL_Configurations[HSERIAL_CHANNEL_LENGTH];
 
@@ -116,6 +125,9 @@ static HSERIAL_Status_t HSERIAL_enuUARTAsyncReceiveBuffer(HSERIAL_Channel_t chan
 static HSERIAL_Status_t HSERIAL_enuSPISyncReceiveBuffer(HSERIAL_Channel_t channel, uint8_t* dataBuffer, uint16_t size);
 static HSERIAL_Status_t HSERIAL_enuSPIAsyncReceiveBuffer(HSERIAL_Channel_t channel, uint8_t* dataBuffer, uint16_t size);
 
+static HSERIAL_Status_t HSERIAL_enuConfigUartRxDma(HSERIAL_Channel_t channel, uint8_t* dataBuffer, uint16_t size,
+                                                   HSERIAL_Callback_t halfCallback, HSERIAL_Callback_t fullCallback, bool_t circular);
+
 static void HSERIAL_SpiCallBackHandler_1_Tx(void);
 static void HSERIAL_SpiCallBackHandler_2_Tx(void);
 static void HSERIAL_SpiCallBackHandler_3_Tx(void);
@@ -181,6 +193,7 @@ HSERIAL_Status_t HSERIAL_enuTransmitBuffer(HSERIAL_Channel_t channel, const uint
     }else{
     
         const HSERIAL_Config_t* config = &HSERIAL_Configurations[channel];
+        TRACE_EVENT(TRACE_EVENT_HSERIAL_TX, size);
         switch(config->HSERIAL_Mode){
             case HSERIAL_MODE_UART_ASYNC:
                 retStatus = HSERIAL_enuUARTAsyncTransmitBuffer(channel, dataBuffer, size);
@@ -217,6 +230,7 @@ HSERIAL_Status_t HSERIAL_enuReceiveBuffer(HSERIAL_Channel_t channel,uint8_t* dat
     }else{
     
         const HSERIAL_Config_t* config = &HSERIAL_Configurations[channel];
+        TRACE_EVENT(TRACE_EVENT_HSERIAL_RX, size);
         switch(config->HSERIAL_Mode){
             case HSERIAL_MODE_UART_ASYNC:
                 retStatus = HSERIAL_enuUARTAsyncReceiveBuffer(channel, dataBuffer, size);
@@ -241,6 +255,82 @@ HSERIAL_Status_t HSERIAL_enuReceiveBuffer(HSERIAL_Channel_t channel,uint8_t* dat
     return retStatus;
 }
 
+HSERIAL_Status_t HSERIAL_enuStartReceiveStream(HSERIAL_Channel_t channel, uint8_t* ringBuffer, uint16_t size,
+                                               HSERIAL_Callback_t halfCallback, HSERIAL_Callback_t fullCallback){
+    HSERIAL_Status_t retStatus = HSERIAL_NOT_OK;
+
+    if(channel >= HSERIAL_CHANNEL_LENGTH){
+        retStatus = HSERIAL_WRONG_CHANNEL;
+    }else if ((ringBuffer == NULL) || (halfCallback == NULL) || (fullCallback == NULL)){
+        retStatus = HSERIAL_NULL_POINTER;
+    }else if ((size < 2) || ((size % 2) != 0)){
+        retStatus = HSERIAL_INVALID_SIZE;
+    }else if ((HSERIAL_Configurations[channel].HSERIAL_Mode != HSERIAL_MODE_UART_DMA) ||
+              ((HSERIAL_Configurations[channel].UART_Dma_Config.HSERIAL_UartEnable & HSERIAL_ENABLE_UART_RECEIVE) != HSERIAL_ENABLE_UART_RECEIVE)){
+        retStatus = HSERIAL_WRONG_MODE;
+    }else{
+        retStatus = HSERIAL_enuConfigUartRxDma(channel, ringBuffer, size, halfCallback, fullCallback, TRUE);
+    }
+    return retStatus;
+}
+
+HSERIAL_Status_t HSERIAL_enuStopReceiveStream(HSERIAL_Channel_t channel){
+    HSERIAL_Status_t retStatus = HSERIAL_NOT_OK;
+
+    if(channel >= HSERIAL_CHANNEL_LENGTH){
+        retStatus = HSERIAL_WRONG_CHANNEL;
+    }else if ((HSERIAL_Configurations[channel].HSERIAL_Mode != HSERIAL_MODE_UART_DMA) ||
+              ((HSERIAL_Configurations[channel].UART_Dma_Config.HSERIAL_UartEnable & HSERIAL_ENABLE_UART_RECEIVE) != HSERIAL_ENABLE_UART_RECEIVE)){
+        retStatus = HSERIAL_WRONG_MODE;
+    }else{
+        // Back to the one-shot configuration of HSERIAL_enuDmaInitUart, the buffer is set by the next receive
+        retStatus = HSERIAL_enuConfigUartRxDma(channel, NULL, 1, NULL,
+                                               HSERIAL_Configurations[channel].UART_Dma_Config.HSERIAL_UartRxCompleteCallback, FALSE);
+    }
+    return retStatus;
+}
+
+
+HSERIAL_Status_t HSERIAL_enuGetTransferTime(HSERIAL_Channel_t channel, uint16_t size, uint32_t* transferUs){
+    HSERIAL_Status_t retStatus = HSERIAL_NOT_OK;
+    uint32_t frameNs = 0;
+
+    if(channel >= HSERIAL_CHANNEL_LENGTH){
+        retStatus = HSERIAL_WRONG_CHANNEL;
+    }else if (transferUs == NULL){
+        retStatus = HSERIAL_NULL_POINTER;
+    }else{
+        const HSERIAL_Config_t* config = &HSERIAL_Configurations[channel];
+        switch(config->HSERIAL_Mode){
+            case HSERIAL_MODE_UART_SYNC:
+            case HSERIAL_MODE_UART_ASYNC:
+            case HSERIAL_MODE_UART_DMA:
+                // The three UART configurations start with the same fields
+                if(UART_enuGetFrameTime((UART_Number_t)config->UART_Sync_Config.HSERIAL_UartChannel, &frameNs) != UART_OK){
+                    retStatus = HSERIAL_ERROR_INIT_UART;
+                }else{
+                    retStatus = HSERIAL_OK;
+                }
+                break;
+            case HSERIAL_MODE_SPI_SYNC:
+            case HSERIAL_MODE_SPI_ASYNC:
+                // One SPI frame per byte of the buffer
+                if(SPI_enuGetFrameTime((SPI_Number_t)config->SPI_Sync_Config.HSERIAL_SpiChannel, &frameNs) != SPI_OK){
+                    retStatus = HSERIAL_ERROR_INIT_SPI;
+                }else{
+                    retStatus = HSERIAL_OK;
+                }
+                break;
+            default:
+                retStatus = HSERIAL_WRONG_MODE;
+                break;
+        }
+        if(retStatus == HSERIAL_OK){
+            *transferUs = (uint32_t)(((uint64_t)frameNs * size + 999U) / 1000U);
+        }
+    }
+    return retStatus;
+}
 
 static HSERIAL_Status_t HSERIAL_enuSyncInitUart(HSERIAL_Channel_t channel){
     HSERIAL_Status_t status = HSERIAL_NOT_OK;
@@ -294,7 +384,7 @@ static HSERIAL_Status_t HSERIAL_enuAsyncInitUart(HSERIAL_Channel_t channel){
         if( nvicStatus != NVIC_BP_OK ){
             status = HSERIAL_ERROR_NVIC;
         }else{
-            nvicStatus = NVIC_BP_SetPriority(HSERIAL_UART_NVIC_IRQ_Map[H_uartConfig->HSERIAL_UartChannel], H_uartConfig->HSERIAL_UartInterruptPriority);
+            nvicStatus = NVIC_BP_SetPriority(HSERIAL_UART_NVIC_IRQ_Map[H_uartConfig->HSERIAL_UartChannel], HSERIAL_MASKABLE_PRIORITY(H_uartConfig->HSERIAL_UartInterruptPriority));
             if( nvicStatus != NVIC_BP_OK ){
                 status = HSERIAL_ERROR_NVIC;
             }else{
@@ -335,7 +425,7 @@ static HSERIAL_Status_t HSERIAL_enuDmaInitUart(HSERIAL_Channel_t channel){
             if( nvicStatus != NVIC_BP_OK ){
                 status = HSERIAL_ERROR_NVIC;
             }else{
-                nvicStatus = NVIC_BP_SetPriority(HSERIAL_UART_NVIC_IRQ_Map[H_uartConfig->HSERIAL_UartChannel], H_uartConfig->HSERIAL_UartInterruptPriority);
+                nvicStatus = NVIC_BP_SetPriority(HSERIAL_UART_NVIC_IRQ_Map[H_uartConfig->HSERIAL_UartChannel], HSERIAL_MASKABLE_PRIORITY(H_uartConfig->HSERIAL_UartInterruptPriority));
                 if( nvicStatus != NVIC_BP_OK ){
                     status = HSERIAL_ERROR_NVIC;
                 }else{
@@ -379,6 +469,9 @@ static HSERIAL_Status_t HSERIAL_enuDmaInitUart(HSERIAL_Channel_t channel){
                             uartStatus = UART_enuRegisterCallbacks(H_uartConfig->HSERIAL_UartChannel, &uartCallbacks);
                             if(uartStatus != UART_OK){
                                 status = HSERIAL_ERROR_INIT_DMA;
+                            }else if(MCU_enuRegisterClockGuard(UART_u8ClockChangeBusy) != MCU_OK){
+                                // A clock switch must not re-time the baud rate mid DMA frame
+                                status = HSERIAL_ERROR_INIT_DMA;
                             }else{
                                 status = HSERIAL_OK;
                             }
@@ -397,7 +490,7 @@ static HSERIAL_Status_t HSERIAL_enuDmaInitUart(HSERIAL_Channel_t channel){
                 if( nvicStatus != NVIC_BP_OK ){
                     status = HSERIAL_ERROR_NVIC;
                 }else{
-                    nvicStatus = NVIC_BP_SetPriority(HSERIAL_DMA_NVIC_IRQ_Map[H_uartConfig->HSERIAL_UartChannel], H_uartConfig->HSERIAL_UartInterruptPriority);
+                    nvicStatus = NVIC_BP_SetPriority(HSERIAL_DMA_NVIC_IRQ_Map[H_uartConfig->HSERIAL_UartChannel], HSERIAL_MASKABLE_PRIORITY(H_uartConfig->HSERIAL_UartInterruptPriority));
                     if( nvicStatus != NVIC_BP_OK ){
                         status = HSERIAL_ERROR_NVIC;
                     }else{
@@ -514,7 +607,7 @@ static HSERIAL_Status_t HSERIAL_enuAsyncInitSpi(HSERIAL_Channel_t channel){
         if( nvicStatus != NVIC_BP_OK ){
             status = HSERIAL_ERROR_NVIC;
         }else{
-            nvicStatus = NVIC_BP_SetPriority(HSERIAL_SPI_NVIC_IRQ_Map[H_spiConfig->HSERIAL_SpiChannel], H_spiConfig->HSERIAL_SpiInterruptPriority);
+            nvicStatus = NVIC_BP_SetPriority(HSERIAL_SPI_NVIC_IRQ_Map[H_spiConfig->HSERIAL_SpiChannel], HSERIAL_MASKABLE_PRIORITY(H_spiConfig->HSERIAL_SpiInterruptPriority));
             if( nvicStatus != NVIC_BP_OK ){
                 status = HSERIAL_ERROR_NVIC;
             }else{
@@ -725,6 +818,81 @@ static HSERIAL_Status_t HSERIAL_enuUARTDmaReceiveBuffer(HSERIAL_Channel_t channe
 }
 
 
+/*
+ * Reprograms the RX stream of a UART DMA channel
+ * circular = TRUE  : ring of size bytes, half-transfer and transfer-complete interrupts, started here
+ * circular = FALSE : one-shot reception as configured by HSERIAL_enuDmaInitUart, not started
+ * The stream is de-initialized first : DMA_enuInit only ORs the new bits into SCR
+ */
+static HSERIAL_Status_t HSERIAL_enuConfigUartRxDma(HSERIAL_Channel_t channel, uint8_t* dataBuffer, uint16_t size,
+                                                   HSERIAL_Callback_t halfCallback, HSERIAL_Callback_t fullCallback, bool_t circular){
+    HSERIAL_Status_t retStatus = HSERIAL_NOT_OK;
+    const H_UART_Dma_Config_t* config = &HSERIAL_Configurations[channel].UART_Dma_Config;
+    DMA_Controller_t dmaController = HSERIAL_UART_RX_DMA_Map[config->HSERIAL_UartChannel].DMA_Controller;
+    DMA_Stream_t dmaStream = HSERIAL_UART_RX_DMA_Map[config->HSERIAL_UartChannel].DMA_Stream;
+
+    DMA_Config_t dmaConfig;
+    dmaConfig.DMAx               = dmaController;
+    dmaConfig.Streamx            = dmaStream;
+    dmaConfig.Channel            = HSERIAL_UART_RX_DMA_Map[config->HSERIAL_UartChannel].DMA_Channel;
+    dmaConfig.MBurst             = DMA_MBurst_SINGLE;
+    dmaConfig.PBurst             = DMA_PBurst_SINGLE;
+    dmaConfig.DoubleBuffer       = DMA_DISABLE_DOUBLE_BUFFER;
+    dmaConfig.Priority           = DMA_PRIORITY_HIGH;
+    dmaConfig.MSize              = DMA_MSIZE_BYTE;
+    dmaConfig.PSize              = DMA_PSIZE_BYTE;
+    dmaConfig.MemoryInc          = DMA_MINC_AUTO_INCREMENT;
+    dmaConfig.PeripheralInc      = DMA_PINC_FIXED;
+    dmaConfig.Direction          = DMA_DIRECTION_P2M;
+    dmaConfig.PeripheralFlowCtrl = DMA_FLOW_CONTROL_USING_DMA;
+    dmaConfig.Mode               = DMA_MODE_DIRECT;
+    dmaConfig.FifoThreshold      = DMA_FIFO_THRESHOLD_FULL; // Not important at direct mode
+    dmaConfig.PeripheralAddress  = UART_ADDRESSS[config->HSERIAL_UartChannel] + 0x04;
+    dmaConfig.Memory0Address     = (uint32_t)dataBuffer;
+    dmaConfig.Memory1Address     = 0; // Not used in normal mode
+    dmaConfig.NumberOfData       = size;
+    if(circular == TRUE){
+        dmaConfig.CircularMode   = DMA_CIRCULAR_MODE_ENABLE;
+        dmaConfig.Interrupts     = DMA_INTERRUPT_HALF_TRANSFER_ENABLE | DMA_INTERRUPT_TRANSFER_COMPLETE_ENABLE;
+    }else{
+        dmaConfig.CircularMode   = DMA_CIRCULAR_MODE_DISABLE;
+        dmaConfig.Interrupts     = DMA_INTERRUPT_TRANSFER_COMPLETE_ENABLE;
+    }
+
+    DMA_Status_t dmaStatus = DMA_enuDeInit(dmaController, dmaStream);
+    if((dmaStatus != DMA_OK) && (dmaStatus != DMA_STREAM_NOT_INIT)){
+        retStatus = HSERIAL_ERROR_INIT_DMA;
+    }else{
+        dmaStatus = DMA_enuInit(&dmaConfig);
+        if(dmaStatus != DMA_OK){
+            retStatus = HSERIAL_ERROR_INIT_DMA;
+        }else{
+            // Flags left by the previous transfer would call the new callbacks at once
+            (void)DMA_enuClearFlag(dmaController, dmaStream, DMA_INTERRUPT_HALF_TRANSFER);
+            (void)DMA_enuClearFlag(dmaController, dmaStream, DMA_INTERRUPT_TRANSMISSION_COMPLETE);
+
+            dmaStatus = DMA_enuRegisterCallback(dmaController, dmaStream, DMA_INTERRUPT_HALF_TRANSFER, halfCallback);
+            if(dmaStatus == DMA_OK){
+                dmaStatus = DMA_enuRegisterCallback(dmaController, dmaStream, DMA_INTERRUPT_TRANSMISSION_COMPLETE, fullCallback);
+            }
+            if(dmaStatus != DMA_OK){
+                retStatus = HSERIAL_ERROR_INIT_DMA;
+            }else if(circular == TRUE){
+                dmaStatus = DMA_enuStartTransfer(dmaController, dmaStream);
+                if(dmaStatus != DMA_OK){
+                    retStatus = HSERIAL_ERROR_INIT_DMA;
+                }else{
+                    retStatus = HSERIAL_OK;
+                }
+            }else{
+                retStatus = HSERIAL_OK;
+            }
+        }
+    }
+    return retStatus;
+}
+
+
 static HSERIAL_Status_t HSERIAL_enuSPISyncReceiveBuffer(HSERIAL_Channel_t channel, uint8_t* dataBuffer, uint16_t size){
     HSERIAL_Status_t retStatus = HSERIAL_NOT_OK;
 
@@ -5,6 +5,7 @@
 
 #include "HAL/HSERIAL_Driver/hserial.h"
 #include "HAL/HSERIAL_Driver/hserial_cfg.h"
+#include "OS/trace.h"
 
 extern void TxCallback(void);
 extern void RxCallback(void);
@@ -14,7 +15,7 @@ const HSERIAL_Config_t HSERIAL_Configurations[HSERIAL_CHANNEL_LENGTH] = {
     //     .HSERIAL_Mode = HSERIAL_MODE_UART_DMA,
     //     .UART_Dma_Config = {
     //         .HSERIAL_UartChannel         = HSERIAL_UART_1,
-    //         .HSERIAL_UartPeripheralClock = 16000000UL,
+    //         .HSERIAL_UartPeripheralClock = HSERIAL_UART_PERIPHERAL_CLOCK_AUTO,
     //         .HSERIAL_UartBaudRate        = 9600UL,
     //         .HSERIAL_UartParity          = HSERIAL_UART_PARITY_NONE,
     //         .HSERIAL_UartOverSampling    = HSERIAL_UART_OVERSAMPLING_16,
@@ -24,13 +25,13 @@ const HSERIAL_Config_t HSERIAL_Configurations[HSERIAL_CHANNEL_LENGTH] = {
     //         .HSERIAL_UartEnable          = HSERIAL_ENABLE_UART_BOTH,
     //         .HSERIAL_UartTxCompleteCallback = TxCallback,
     //         .HSERIAL_UartRxCompleteCallback = RxCallback,
-    //         .HSERIAL_UartInterruptPriority  = HSERIAL_PRIORITY_2
+    //         .HSERIAL_UartInterruptPriority  = HSERIAL_PRIORITY_5
     //     }
     // },
     [HSERIAL_CHANNEL_1] = {
         .HSERIAL_Mode = HSERIAL_MODE_UART_ASYNC,
         .UART_Async_Config = {
-            .HSERIAL_UartPeripheralClock    = 16000000UL,
+            .HSERIAL_UartPeripheralClock    = HSERIAL_UART_PERIPHERAL_CLOCK_AUTO,
             .HSERIAL_UartChannel            = HSERIAL_UART_1,
             .HSERIAL_UartBaudRate           = 9600UL,
             .HSERIAL_UartParity             = HSERIAL_UART_PARITY_NONE,
@@ -41,9 +42,29 @@ const HSERIAL_Config_t HSERIAL_Configurations[HSERIAL_CHANNEL_LENGTH] = {
             .HSERIAL_UartEnable             = HSERIAL_ENABLE_UART_BOTH,
             .HSERIAL_UartTxCompleteCallback = TxCallback,
             .HSERIAL_UartRxCompleteCallback = RxCallback,
-            .HSERIAL_UartInterruptPriority  = HSERIAL_PRIORITY_2
+            .HSERIAL_UartInterruptPriority  = HSERIAL_PRIORITY_5
         },
     },
+#if (TRACE == TRACE_ENABLED)
+    // Trace stream : transmit only, 921600 baud is 0.2 % off from an 84MHZ PCLK2 (2 % from the 16MHZ HSI)
+    [HSERIAL_CHANNEL_TRACE] = {
+        .HSERIAL_Mode = HSERIAL_MODE_UART_DMA,
+        .UART_Dma_Config = {
+            .HSERIAL_UartPeripheralClock    = HSERIAL_UART_PERIPHERAL_CLOCK_AUTO,
+            .HSERIAL_UartChannel            = HSERIAL_UART_6,
+            .HSERIAL_UartBaudRate           = 921600UL,
+            .HSERIAL_UartParity             = HSERIAL_UART_PARITY_NONE,
+            .HSERIAL_UartOverSampling       = HSERIAL_UART_OVERSAMPLING_16,
+            .HSERIAL_UartStopBits           = HSERIAL_UART_STOPBITS_1,
+            .HSERIAL_UartWordLength         = HSERIAL_UART_WORDLENGTH_8B,
+            .HSERIAL_UartSample             = HSERIAL_UART_ONE_SAMPLE,
+            .HSERIAL_UartEnable             = HSERIAL_ENABLE_UART_TRANSMITE,
+            .HSERIAL_UartTxCompleteCallback = TRACE_vdTxComplete,
+            .HSERIAL_UartRxCompleteCallback = NULL,
+            .HSERIAL_UartInterruptPriority  = HSERIAL_PRIORITY_5
+        },
+    },
+#endif
 
     // [HSERIAL_CHANNEL_2] ={
     //     .HSERIAL_Mode = HSERIAL_MODE_UART_ASYNC,
@@ -12,7 +12,10 @@
 #include "LIB/stdtypes.h"
 #include <string.h>
 #include "OS/schedule.h"
+#include "OS/trace.h"
 #include "MCAL/GPIO_Driver/gpio_int.h"
+#include "HAL/BOARD_Driver/board_cfg.h"
+#include "HAL/BOARD_Driver/board.h"
 #include "MCAL/SYSTICK_TIMER_Driver/systick.h"
 #include "HAL/LCD_Driver/lcd_queue.h"
 #include "HAL/LCD_Driver/lcd.h"
@@ -223,6 +226,30 @@ const GPIO_Val_t LCDpinVAl[] = {
     GPIO_HIGH,  /* Index 1 - Logic 1 */
 };
 
+/* The pin images and the data tables below need one port per pin list */
+_Static_assert(BOARD_PINS_ON_PORT(BOARD_LCD_DB4_PORT, BOARD_LCD_PINS), "LCD: BOARD_LCD_PINS must share one port");
+_Static_assert(BOARD_PINS_ON_PORT(BOARD_LCD_DB4_PORT, BOARD_LCD_LOW_PINS), "LCD: BOARD_LCD_LOW_PINS must sit on the port of DB4");
+
+/**
+ * @brief LCD pin images, folded from board_cfg.h
+ * @details LcdPinImage: RS, RW, EN and DB4-DB7 (both modes)
+ *          LcdLowPinImage: DB0-DB3 (8-bit mode only)
+ */
+static const GPIO_Image_t LcdPinImage = BOARD_PORT_IMAGE_INITIALIZER(BOARD_LCD_DB4_PORT, BOARD_LCD_PINS);
+static const GPIO_Image_t LcdLowPinImage = BOARD_PORT_IMAGE_INITIALIZER(BOARD_LCD_DB4_PORT, BOARD_LCD_LOW_PINS);
+
+/* TRUE when an image is part of the fitted pins, BOARD_enuInit applied it at boot */
+static const bool_t LcdPinsFitted = BOARD_PINS_FITTED(BOARD_LCD_DB4_PORT, BOARD_LCD_PINS) ? TRUE : FALSE;
+static const bool_t LcdLowPinsFitted = BOARD_PINS_FITTED(BOARD_LCD_DB4_PORT, BOARD_LCD_LOW_PINS) ? TRUE : FALSE;
+
+/**
+ * @brief BSRR word of every nibble value on the data lines
+ * @details LcdHighNibbleBsrr: value on DB4-DB7, LcdLowNibbleBsrr: value on DB0-DB3
+ *          Each word sets the ones and resets the zeros, a byte is one store
+ */
+static const uint32_t LcdHighNibbleBsrr[16] = BOARD_NIBBLE_TABLE(BOARD_LCD_DB4_PIN, BOARD_LCD_DB5_PIN, BOARD_LCD_DB6_PIN, BOARD_LCD_DB7_PIN);
+static const uint32_t LcdLowNibbleBsrr[16] = BOARD_NIBBLE_TABLE(BOARD_LCD_DB0_PIN, BOARD_LCD_DB1_PIN, BOARD_LCD_DB2_PIN, BOARD_LCD_DB3_PIN);
+
 /******************************************************************************
  * PRIVATE STATIC VARIABLES
  ******************************************************************************/
@@ -533,82 +560,32 @@ static LCD_Status_t LCD_InitSequence_8BitMode(void)
 
 /**
  * @brief Write a byte to LCD data lines (DB0-DB7)
- * @details Writes 8 bits to data pins, generates enable pulse
- *          Timing: Enable pulse width = 1ms (>450ns required)
- * @param byte: 8-bit data to write (0x00 to 0xFF)
+ * @details Puts the data on the bus with one BSRR write (LcdLowNibbleBsrr /
+ *          LcdHighNibbleBsrr), the enable pulse is generated by the caller
+ * @param byte: 8-bit data in 8-bit mode, nibble (bits 0-3) in 4-bit mode
  * @return LCD_Status_t:
  *         - LCD_OK: Write successful
  *         - LCD_GPIO_ERROR: GPIO operation failed
- *         - LCD_TIMER_ERROR: Timer operation failed
- * @note This function handles the low-level LCD write protocol
+ * @note In 4-bit mode the nibble goes to DB4-DB7, bits 4-7 are ignored
  */
 static LCD_Status_t LCD_WriteByte(uint8_t byte){
     LCD_Status_t retStatus = LCD_OK;        /* Function return status */
-    GPIO_Status_t gpioStatus = GPIO_NOT_OK; /* GPIO operation status */
+    uint32_t bsrr = 0;                      /* Set and reset bits of the data lines */
 
-    uint8_t bitIndex = 0;
     if(LcdCong.BitOperation == LCD_8_BIT_OPERATION){
-        /* Write bit 0 to DB0 pin */
-        gpioStatus = GPIO_enuSetPinVal(LcdPinout.DB0.port, LcdPinout.DB0.pin,LCDpinVAl[(byte >> (bitIndex++)) & 1]);
-
-        if (gpioStatus != GPIO_OK){
-            retStatus = LCD_GPIO_ERROR;
-        }else{
-            /* Write bit 1 to DB1 pin */
-            gpioStatus = GPIO_enuSetPinVal(LcdPinout.DB1.port, LcdPinout.DB1.pin,LCDpinVAl[(byte >>  (bitIndex++)) & 1]);
-            if (gpioStatus != GPIO_OK){
-                retStatus = LCD_GPIO_ERROR;
-            }else{
-                /* Write bit 2 to DB2 pin */
-                gpioStatus = GPIO_enuSetPinVal(LcdPinout.DB2.port, LcdPinout.DB2.pin,LCDpinVAl[(byte >>  (bitIndex++)) & 1]);
-                if (gpioStatus != GPIO_OK){
-                    retStatus = LCD_GPIO_ERROR;
-                }else{
-                    /* Write bit 3 to DB3 pin */
-                    gpioStatus = GPIO_enuSetPinVal(LcdPinout.DB3.port, LcdPinout.DB3.pin,LCDpinVAl[(byte >>  (bitIndex++)) & 1]);
-
-                    if (gpioStatus != GPIO_OK){
-                        retStatus = LCD_GPIO_ERROR;
-                    }else{
-                        retStatus = LCD_OK;   /* First 4 bits written successfully */
-                    }
-                }
-            }
-        }
+        /* Bits 0-3 to DB0-DB3, bits 4-7 to DB4-DB7 */
+        bsrr = LcdLowNibbleBsrr[byte & 0x0FU] | LcdHighNibbleBsrr[(byte >> 4) & 0x0FU];
     }else{
-        // continue with 4-bit mode
+        /* Bits 0-3 to DB4-DB7 */
+        bsrr = LcdHighNibbleBsrr[byte & 0x0FU];
     }
-    if (retStatus == LCD_OK){
-        /* Continue with bits 4-7 */
-        /* Write bit 4 to DB4 pin */
-       gpioStatus = GPIO_enuSetPinVal(LcdPinout.DB4.port, LcdPinout.DB4.pin,LCDpinVAl[(byte >>  (bitIndex++)) & 1]);
-       if (gpioStatus != GPIO_OK){
-           retStatus = LCD_GPIO_ERROR;
-       }else{
-           /* Write bit 5 to DB5 pin */
-           gpioStatus = GPIO_enuSetPinVal(LcdPinout.DB5.port, LcdPinout.DB5.pin,LCDpinVAl[(byte >>  (bitIndex++)) & 1]);
-           if (gpioStatus != GPIO_OK){
-               retStatus = LCD_GPIO_ERROR;
-           }else{
-               /* Write bit 6 to DB6 pin */
-               gpioStatus = GPIO_enuSetPinVal(LcdPinout.DB6.port, LcdPinout.DB6.pin,LCDpinVAl[(byte >>  (bitIndex++)) & 1]);
-               if (gpioStatus != GPIO_OK){
-                   retStatus = LCD_GPIO_ERROR;
-               }else{
-                   /* Write bit 7 to DB7 pin */
-                   gpioStatus = GPIO_enuSetPinVal(LcdPinout.DB7.port, LcdPinout.DB7.pin,LCDpinVAl[(byte >>  (bitIndex++)) & 1]);
-                   if (gpioStatus != GPIO_OK){
-                       retStatus = LCD_GPIO_ERROR;
-                   }else{
-                       retStatus = LCD_OK;   /* All operations successful */
-                   }
-               }
-            }
-        }
+
+    if (GPIO_OK != GPIO_enuSetResetPins((GPIO_Port_t)BOARD_LCD_DB4_PORT, bsrr)){
+        retStatus = LCD_GPIO_ERROR;
     }else{
-        // retStatus = retStatus;  /* Preserve error status */
+        retStatus = LCD_OK;
     }
-    
+
     return retStatus;  /* Single exit point - MISRA C compliant */
 }
 
@@ -1975,9 +1952,12 @@ LCD_Status_t LCD_enuAsynCreateCustomChar(uint8_t location, const uint8_t charmap
 static void lcdRunnableCBF(){
     /* Dispatch to appropriate state machine based on current operation */
     switch(lcdState){
-        case LCD_INIT         : ExecuteInitSeq();break;           /* Initialization in progress */
-        case LCD_WRITE_STRING : ExecuteWriteString();break;       /* String writing in progress */
-        case LCD_CREATE_CUSTOM_CHAR : ExecutCreateCustomChar();break; /* Custom char creation in progress */
+        case LCD_INIT         : ExecuteInitSeq();                 /* Initialization in progress */
+                                TRACE_EVENT(TRACE_EVENT_LCD_STATE, (LCD_INIT << 8) | initSeq);break;
+        case LCD_WRITE_STRING : ExecuteWriteString();             /* String writing in progress */
+                                TRACE_EVENT(TRACE_EVENT_LCD_STATE, (LCD_WRITE_STRING << 8) | writeStringSeq);break;
+        case LCD_CREATE_CUSTOM_CHAR : ExecutCreateCustomChar();   /* Custom char creation in progress */
+                                TRACE_EVENT(TRACE_EVENT_LCD_STATE, (LCD_CREATE_CUSTOM_CHAR << 8) | createCustomCharSeq);break;
         case LCD_NO_ACTION    : /* Do nothing */ break;           /* Idle state */
         default               : /* Do nothing */ break;           /* Invalid state */
     }
@@ -3099,31 +3079,19 @@ static void ExecuteWriteString(){
 
 /**
  * @brief Initialize GPIO pins for LCD interface
- * @details Configures all GPIO pins required for LCD communication
- *          Pins initialized depend on bit operation mode:
- *          - 8-bit mode: 11 pins (DB0-DB7, RS, RW, EN)
- *          - 4-bit mode: 7 pins (DB4-DB7, RS, RW, EN)
- * 
- * GPIO Configuration:
- *   - Mode: Output (GPIO_MODE_OUTPUT)
- *   - Type: Push-pull (GPIO_OUTPUT_TYPE_PUSH_PULL)
- *   - Pull: No pull resistor (GPIO_NO_PULL)
- *   - Speed: Default speed (GPIO_SPEED_DEFAULT)
- *   - Alternate Function: None (GPIO_AF0)
- * 
- * Pin Initialization Order:
- *   8-bit mode: DB4, DB5, DB6, DB7, EN, RW, RS, DB0, DB1, DB2, DB3
- *   4-bit mode: DB4, DB5, DB6, DB7, EN, RW, RS
+ * @details Applies the pin images folded from board_cfg.h:
+ *          - 4-bit mode: LcdPinImage (DB4-DB7, RS, RW, EN)
+ *          - 8-bit mode: LcdPinImage then LcdLowPinImage (DB0-DB3)
+ *          Six read-modify-writes per image instead of one GPIO_enuInit per pin
+ *          An image of fitted pins (board_cfg.h) is skipped, the boot applied it
  * 
  * @return LCD_Status_t:
  *         - LCD_OK: All pins initialized successfully
  *         - LCD_WRONG_BIT_OPERATION: Invalid bit operation mode in configuration
- *         - LCD_INIT_ERROR: GPIO initialization failed for one or more pins
+ *         - LCD_INIT_ERROR: GPIO initialization failed
  * 
  * @note Must be called before any LCD operations
  *       Uses LcdCong.BitOperation to determine which pins to initialize
- *       Uses LcdPinout structure for port/pin information
- *       Stops initialization and returns error on first failure
  */
 static LCD_Status_t LCD_enuInitGpioPins(){
     LCD_Status_t retStatus = LCD_OK;                            /* Function return status */
@@ -3132,40 +3100,13 @@ static LCD_Status_t LCD_enuInitGpioPins(){
     if ((LcdCong.BitOperation != LCD_4_BIT_OPERATION)&&(LcdCong.BitOperation != LCD_8_BIT_OPERATION)){
         retStatus = LCD_WRONG_BIT_OPERATION;  /* Invalid bit operation mode */
     }else{
-        uint8_t totalPins = 0;  /* Total number of pins to initialize */
-        
-        /* Determine number of pins based on operation mode */
-        if(LcdCong.BitOperation == LCD_8_BIT_OPERATION){
-            totalPins = 11;  /* 8 data pins + RS + RW + EN */
+        if ((FALSE == LcdPinsFitted) && (GPIO_OK != GPIO_enuApplyImage(&LcdPinImage))){
+            retStatus = LCD_INIT_ERROR;
+        }else if ((LcdCong.BitOperation == LCD_8_BIT_OPERATION) && (FALSE == LcdLowPinsFitted)
+                  && (GPIO_OK != GPIO_enuApplyImage(&LcdLowPinImage))){
+            retStatus = LCD_INIT_ERROR;
         }else{
-            totalPins = 7;   /* 4 data pins (DB4-DB7) + RS + RW + EN */
-        }
-        
-        /* Configure GPIO pin settings for LCD pins */
-        GPIO_cfg_t gpioCfg = {
-            .alternateFunction = GPIO_AF0,                      /* No alternate function */
-            .mode = GPIO_MODE_OUTPUT,                           /* Output mode for LCD control */
-            .outputType = GPIO_OUTPUT_TYPE_PUSH_PULL,          /* Push-pull output */
-            .pull = GPIO_NO_PULL,                              /* No pull-up/down resistor */
-            .speed = GPIO_SPEED_DEFAULT                        /* Default speed */
-        };
-
-        GPIO_Status_t gpioStat = GPIO_NOT_OK;                  /* GPIO operation status */
-        const LCD_PinInfo_t *ptr = &(LcdPinout.DB4);          /* Pointer to first pin (DB4) */
-
-        /* Initialize all pins in sequence */
-        /* Note: In 8-bit mode, structure is: DB4-DB7, EN, RW, RS, DB0-DB3 */
-        /*       In 4-bit mode, only first 7 are used: DB4-DB7, EN, RW, RS */
-        for (uint8_t i = 0; i < totalPins; i++){
-            gpioCfg.port = (ptr + i)->port;  /* Get port from pin structure */
-            gpioCfg.pin = (ptr + i)->pin;    /* Get pin number from pin structure */
-            gpioStat = GPIO_enuInit(&gpioCfg);  /* Initialize GPIO pin */
-
-            /* Check if GPIO initialization failed */
-            if (GPIO_OK != gpioStat){
-                retStatus = LCD_INIT_ERROR;  /* Set error status */
-                break;  /* Stop on first error */
-            }
+            retStatus = LCD_OK;
         }
     }
     return retStatus;  /* Single exit point - MISRA C compliant */
@@ -8,6 +8,9 @@
  ******************************************************************************/
 
 #include "LIB/stdtypes.h"
+#include "MCAL/GPIO_Driver/gpio_int.h"
+#include "HAL/BOARD_Driver/board_cfg.h"
+#include "HAL/BOARD_Driver/board.h"
 #include "HAL/LCD_Driver/lcd.h"
 
 /******************************************************************************
@@ -15,11 +18,8 @@
  * 
  * @brief Hardware pin assignments for LCD connections (11 pins total)
  * 
- * Available Ports:
- *    LCD_PORT_A, LCD_PORT_B, LCD_PORT_C, LCD_PORT_D, LCD_PORT_E, LCD_PORT_H
- * 
- * Available Pins (per port):
- *    LCD_PIN_0 through LCD_PIN_15 (16 pins per port)
+ * The pins are set in board_cfg.h (BOARD_LCD_PINS, BOARD_LCD_LOW_PINS),
+ * the driver folds its pin images and data tables from the same lists
  * 
  * Pin Functions:
  *    RS  : Register Select (0=Command, 1=Data)
@@ -28,17 +28,17 @@
  *    DB0-DB7 : 8-bit data bus (DB0=LSB, DB7=MSB)
  ******************************************************************************/
 const LCD_Pinout_8BitMode_t LcdPinout = {
-    .RS  = {.port = LCD_PORT_A, .pin = LCD_PIN_0},   /* Register Select pin */
-    .RW  = {.port = LCD_PORT_A, .pin = LCD_PIN_1},   /* Read/Write control pin */
-    .EN  = {.port = LCD_PORT_A, .pin = LCD_PIN_2},   /* Enable (latch) signal */
-    .DB0 = {.port = LCD_PORT_A, .pin = LCD_PIN_3},   /* Data bit 0 (LSB) */
-    .DB1 = {.port = LCD_PORT_A, .pin = LCD_PIN_4},   /* Data bit 1 */
-    .DB2 = {.port = LCD_PORT_A, .pin = LCD_PIN_5},   /* Data bit 2 */
-    .DB3 = {.port = LCD_PORT_A, .pin = LCD_PIN_6},   /* Data bit 3 */
-    .DB4 = {.port = LCD_PORT_A, .pin = LCD_PIN_7},   /* Data bit 4 */
-    .DB5 = {.port = LCD_PORT_A, .pin = LCD_PIN_8},   /* Data bit 5 */
-    .DB6 = {.port = LCD_PORT_A, .pin = LCD_PIN_9},   /* Data bit 6 */
-    .DB7 = {.port = LCD_PORT_A, .pin = LCD_PIN_10},  /* Data bit 7 (MSB) */
+    .RS  = {.port = (LCD_Port_t)BOARD_LCD_RS_PORT, .pin = (LCD_Pin_t)BOARD_LCD_RS_PIN},   /* Register Select pin */
+    .RW  = {.port = (LCD_Port_t)BOARD_LCD_RW_PORT, .pin = (LCD_Pin_t)BOARD_LCD_RW_PIN},   /* Read/Write control pin */
+    .EN  = {.port = (LCD_Port_t)BOARD_LCD_EN_PORT, .pin = (LCD_Pin_t)BOARD_LCD_EN_PIN},   /* Enable (latch) signal */
+    .DB0 = {.port = (LCD_Port_t)BOARD_LCD_DB0_PORT, .pin = (LCD_Pin_t)BOARD_LCD_DB0_PIN},   /* Data bit 0 (LSB) */
+    .DB1 = {.port = (LCD_Port_t)BOARD_LCD_DB1_PORT, .pin = (LCD_Pin_t)BOARD_LCD_DB1_PIN},   /* Data bit 1 */
+    .DB2 = {.port = (LCD_Port_t)BOARD_LCD_DB2_PORT, .pin = (LCD_Pin_t)BOARD_LCD_DB2_PIN},   /* Data bit 2 */
+    .DB3 = {.port = (LCD_Port_t)BOARD_LCD_DB3_PORT, .pin = (LCD_Pin_t)BOARD_LCD_DB3_PIN},   /* Data bit 3 */
+    .DB4 = {.port = (LCD_Port_t)BOARD_LCD_DB4_PORT, .pin = (LCD_Pin_t)BOARD_LCD_DB4_PIN},   /* Data bit 4 */
+    .DB5 = {.port = (LCD_Port_t)BOARD_LCD_DB5_PORT, .pin = (LCD_Pin_t)BOARD_LCD_DB5_PIN},   /* Data bit 5 */
+    .DB6 = {.port = (LCD_Port_t)BOARD_LCD_DB6_PORT, .pin = (LCD_Pin_t)BOARD_LCD_DB6_PIN},   /* Data bit 6 */
+    .DB7 = {.port = (LCD_Port_t)BOARD_LCD_DB7_PORT, .pin = (LCD_Pin_t)BOARD_LCD_DB7_PIN},  /* Data bit 7 (MSB) */
 };
 
 /******************************************************************************
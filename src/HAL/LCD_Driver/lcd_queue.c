@@ -1,10 +1,11 @@
 #include <string.h>
 #include "./HAL/LCD_Driver/lcd_queue.h"
+#include "./MCAL/NVIC_Driver/nvic.h"
 
 static LCD_DataBuffer_t queue[QUEUE_SIZE];
 static uint8_t front;
 static uint8_t rear;
-static uint8_t count;
+static volatile uint8_t count;
 
 void Queue_Init(void)
 {
@@ -21,9 +22,13 @@ Queue_Status_t Queue_Push(const LCD_DataBuffer_t *data)
         return QUEUE_NULL_PTR;
     }
     
+    /* Indices and count are shared between the LCD task and its producers */
+    NVIC_EnterCritical();
+
     /* Check if queue is full */
     if (count >= QUEUE_SIZE)
     {
+        NVIC_ExitCritical();
         return QUEUE_FULL;
     }
     
@@ -35,6 +40,8 @@ Queue_Status_t Queue_Push(const LCD_DataBuffer_t *data)
     /* Update rear index (circular) */
     rear = (rear + 1) % QUEUE_SIZE;
     count++;
+
+    NVIC_ExitCritical();
     
     return QUEUE_OK;
 }
@@ -52,15 +59,20 @@ LCD_DataBuffer_t* Queue_Top(void)
 
 void Queue_Pop(void)
 {
+    NVIC_EnterCritical();
+
     /* Check if queue is empty */
     if (count == 0)
     {
+        NVIC_ExitCritical();
         return;
     }
     
     /* Update front index (circular) */
     front = (front + 1) % QUEUE_SIZE;
     count--;
+
+    NVIC_ExitCritical();
 }
 
 bool Queue_IsEmpty(void)
@@ -1,7 +1,10 @@
 
 #include "./LIB/stdtypes.h"
 
+#include "./MCAL/RCC_Driver/rcc_int.h"
 #include "./MCAL/GPIO_Driver/gpio_int.h"
+#include "./HAL/BOARD_Driver/board_cfg.h"
+#include "./HAL/BOARD_Driver/board.h"
 
 #include "./HAL/LED_Driver/led_cfg.h"
 #include "./HAL/LED_Driver/led.h"
@@ -23,6 +26,10 @@ LED_Status_t LED_vdInit(){
     GPIO_cfg_t cfg;
 
     for(uint8_t i = 0;i<LED_LEN;i++){
+        /* Fitted LEDs are already set up by BOARD_enuInit at boot */
+        if(TRUE == BOARD_boolIsFitted((GPIO_Port_t)LedConfigArr[i].port, (GPIO_Pin_t)LedConfigArr[i].pin)){
+            continue;
+        }
         cfg.mode = GPIO_MODE_OUTPUT;
         cfg.port = LedConfigArr[i].port;
         cfg.outputType = LedConfigArr[i].outputType;
@@ -1,3 +1,7 @@
+#include "./LIB/stdtypes.h"
+#include "./MCAL/GPIO_Driver/gpio_int.h"
+#include "./HAL/BOARD_Driver/board_cfg.h"
+#include "./HAL/BOARD_Driver/board.h"
 #include "./HAL/LED_Driver/led.h"
 
 /*
@@ -10,68 +14,69 @@
  * - BLACK_PILL_LED: On-board LED, active-low (illuminates when pin is LOW)
  * - KIT_LED_1 to KIT_LED_8: External LEDs, active-high (illuminate when pin is HIGH)
  * - All LEDs use push-pull output for strong drive capability
+ * - Port and pin of each LED come from board_cfg.h (BOARD_LED_PINS, BOARD_KIT_LED_PINS)
  */
 const LED_cfg_t LedConfigArr[LED_LEN] = {
     /* On-board LED on BlackPill - Port C, Pin 13, Active Low, Push-Pull */
     [BLACK_PILL_LED] = {
-        .port = PORT_C,
-        .pin  = PIN_13,
+        .port = (LED_Port_t)BOARD_LED_BLACK_PILL_PORT,
+        .pin  = (LED_Pin_t)BOARD_LED_BLACK_PILL_PIN,
         .activeState = LED_ACTIVE_LOW,
         .outputType  = LED_OUTPUT_TYPE_PUSH_PULL
     },
     /* External Kit LED 1 - Port B, Pin 0, Active High, Push-Pull */
     [KIT_LED_1_LED] = {
-        .port = PORT_B,
-        .pin  = PIN_0,
+        .port = (LED_Port_t)BOARD_LED_KIT_1_PORT,
+        .pin  = (LED_Pin_t)BOARD_LED_KIT_1_PIN,
         .activeState = LED_ACTIVE_HIGH,
         .outputType  = LED_OUTPUT_TYPE_PUSH_PULL
     },
     /* External Kit LED 2 - Port B, Pin 1, Active High, Push-Pull */
     [KIT_LED_2_LED] = {
-        .port = PORT_B,
-        .pin  = PIN_1,
+        .port = (LED_Port_t)BOARD_LED_KIT_2_PORT,
+        .pin  = (LED_Pin_t)BOARD_LED_KIT_2_PIN,
         .activeState = LED_ACTIVE_HIGH,
         .outputType  = LED_OUTPUT_TYPE_PUSH_PULL
     },
     /* External Kit LED 3 - Port A, Pin 2, Active High, Push-Pull */
     [KIT_LED_3_LED] = {
-        .port = PORT_A,
-        .pin  = PIN_2,
+        .port = (LED_Port_t)BOARD_LED_KIT_3_PORT,
+        .pin  = (LED_Pin_t)BOARD_LED_KIT_3_PIN,
         .activeState = LED_ACTIVE_HIGH,
         .outputType  = LED_OUTPUT_TYPE_PUSH_PULL
     },
     /* External Kit LED 4 - Port A, Pin 3, Active High, Push-Pull */
     [KIT_LED_4_LED] = {
-        .port = PORT_A,
-        .pin  = PIN_3,
+        .port = (LED_Port_t)BOARD_LED_KIT_4_PORT,
+        .pin  = (LED_Pin_t)BOARD_LED_KIT_4_PIN,
         .activeState = LED_ACTIVE_HIGH,
         .outputType  = LED_OUTPUT_TYPE_PUSH_PULL
     },
     /* External Kit LED 5 - Port A, Pin 4, Active High, Push-Pull */
     [KIT_LED_5_LED] = {
-        .port = PORT_A,
-        .pin  = PIN_4,
+        .port = (LED_Port_t)BOARD_LED_KIT_5_PORT,
+        .pin  = (LED_Pin_t)BOARD_LED_KIT_5_PIN,
         .activeState = LED_ACTIVE_HIGH,
         .outputType  = LED_OUTPUT_TYPE_PUSH_PULL
     },
     /* External Kit LED 6 - Port A, Pin 5, Active High, Push-Pull */
     [KIT_LED_6_LED] = {
-        .port = PORT_A,
-        .pin  = PIN_5,
+        .port = (LED_Port_t)BOARD_LED_KIT_6_PORT,
+        .pin  = (LED_Pin_t)BOARD_LED_KIT_6_PIN,
         .activeState = LED_ACTIVE_HIGH,
         .outputType  = LED_OUTPUT_TYPE_PUSH_PULL
     },
     /* External Kit LED 7 - Port A, Pin 6, Active High, Push-Pull */
     [KIT_LED_7_LED] = {
-        .port = PORT_A,
-        .pin  = PIN_6,
+        .port = (LED_Port_t)BOARD_LED_KIT_7_PORT,
+        .pin  = (LED_Pin_t)BOARD_LED_KIT_7_PIN,
         .activeState = LED_ACTIVE_HIGH,
         .outputType  = LED_OUTPUT_TYPE_PUSH_PULL
     },
     /* External Kit LED 8 - Port A, Pin 7, Active High, Push-Pull */
     [KIT_LED_8_LED] = {
-        .port = PORT_A,
-        .pin  = PIN_7,
+        .port = (LED_Port_t)BOARD_LED_KIT_8_PORT,
+        .pin  = (LED_Pin_t)BOARD_LED_KIT_8_PIN,
         .activeState = LED_ACTIVE_HIGH,
         .outputType  = LED_OUTPUT_TYPE_PUSH_PULL
     }
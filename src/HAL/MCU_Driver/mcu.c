@@ -1,9 +1,85 @@
 #include "./LIB/stdtypes.h"
+#include "./LIB/dwt.h"
 #include "./MCAL/RCC_Driver/rcc_int.h"
+#include "./MCAL/NVIC_Driver/nvic.h"
+#include "./MCAL/FLASH_Driver/flash.h"
+#include "./MCAL/GPIO_Driver/gpio_int.h"
+#include "./HAL/BOARD_Driver/board_cfg.h"
+#include "./HAL/BOARD_Driver/board.h"
 
 #include "./HAL/MCU_Driver/mcu_cfg.h"
 #include "./HAL/MCU_Driver/mcu.h"
 
+/* Drivers to re-time when the clock tree changes at runtime */
+static MCU_ClockNotifier_t ClockNotifiers[MCU_MAX_CLOCK_NOTIFIERS] = {NULL};
+
+/* Drivers that can refuse a runtime clock change while a transfer is in flight */
+static MCU_ClockGuard_t ClockGuards[MCU_MAX_CLOCK_GUARDS] = {NULL};
+
+/* Calls every registered notifier with the given clock change phase */
+static void MCU_vdNotifyClockChange(uint8_t phase);
+
+/* Returns 1 when one of the registered guards refuses the clock change */
+static uint8_t MCU_u8ClockChangeBlocked(void);
+
+/* Supply voltage range used for flash wait states, kept for runtime clock changes */
+static FLASH_VoltageRange_t FlashVoltageRange = FLASH_VOLTAGE_2V7_TO_3V6;
+
+/* SYSCLK source and PLL input running before STOP mode, restored on wake-up */
+static RCC_ClockSrc_t SuspendedClockSource = RCC_SYSCLK_HSI;
+static uint8_t SuspendedPLLSource = RCC_PLL_SOURCE_HSI;
+
+/* One notified switch: sources started with interrupts enabled, SYSCLK switched masked */
+static MCU_Status_t MCU_enuSwitchClock(const MCU_ClockProfile_t *profile);
+
+/* Starts the oscillators and locks the PLL of a profile, called with interrupts enabled */
+static MCU_Status_t MCU_enuStartClockSource(const MCU_ClockProfile_t *profile);
+
+/* Switches SYSCLK and the prescalers, called with interrupts masked */
+static MCU_Status_t MCU_enuApplyClockProfile(const MCU_ClockProfile_t *profile);
+
+/* Fills a configuration from the mcu_cfg.h macros */
+static void MCU_vdLoadStaticConfig(MCU_Config_t *config);
+
+/* Rejects a configuration whose PCLK1/PCLK2 would be above the datasheet limits */
+static MCU_Status_t MCU_enuCheckBusClocks(const MCU_Config_t *config);
+
+/* Sets the wait states needed at the maximum HCLK, safe before any clock switch */
+static MCU_Status_t MCU_enuPrepareFlash(void);
+
+/* Trims the wait states to the running HCLK once the clock tree is settled */
+static MCU_Status_t MCU_enuTrimFlash(void);
+
+/* Internal boot phases, removed at compile time when the profiler is disabled */
+#if (MCU_BOOT_PROFILER == MCU_BOOT_PROFILER_ENABLED)
+#define MCU_BOOT_MARK(name)         ((void)MCU_enuBootMark(name))
+#else
+#define MCU_BOOT_MARK(name)
+#endif
+
+/* Boot-time report */
+static MCU_BootPhase_t BootPhases[MCU_BOOT_MAX_PHASES];
+static uint8_t  BootPhaseCount = 0;
+static uint32_t BootLastCycles = 0;
+static uint32_t BootLastHclk = 0;
+static uint32_t BootTotalMicroseconds = 0;
+static bool_t   BootProfilerRunning = FALSE;
+
+/* Fast-start sequence state */
+typedef enum{
+    MCU_FAST_START_IDLE = 0,
+    MCU_FAST_START_WAIT_HSE,
+    MCU_FAST_START_WAIT_PLL,
+    MCU_FAST_START_SWITCH,
+    MCU_FAST_START_DONE,
+    MCU_FAST_START_FAILED
+}MCU_FastStartState_t;
+
+static MCU_FastStartState_t FastStartState = MCU_FAST_START_IDLE;
+static MCU_Config_t FastStartConfig;
+static uint32_t FastStartBeginCycles = 0;
+static uint32_t FastStartTimeoutCycles = 0;
+
 /*
  * Function: MCU_enuInit
  * Description: Initializes the MCU clock system and peripheral clocks
@@ -22,8 +98,9 @@
  * 3. Configures PLL parameters if PLL is selected
  * 4. Sets AHB, APB1, and APB2 bus prescalers
  * 5. Enables peripheral clocks for requested peripherals on all buses
+ * 6. Applies the fitted board pins (BOARD_enuInit, board_cfg.h)
  */
-MCU_Status_t MCU_enuInit(MCU_Config_t *localMcuConfig) {
+MCU_Status_t MCU_enuInit(const MCU_Config_t *localMcuConfig) {
 
     /* 
      * BRANCH 1: Compile-time configuration mode
@@ -40,6 +117,24 @@ MCU_Status_t MCU_enuInit(MCU_Config_t *localMcuConfig) {
         /* Set the HSE clock source frequency value for RCC driver calculations */
         RCC_HSE_ClockSourceValue = MCU_HSE_CLOCK_SOURCE_VALUE;
 
+        /* Bus limits are checked before anything is switched */
+        {
+            MCU_Config_t staticConfig;
+            MCU_Status_t busStatus;
+
+            MCU_vdLoadStaticConfig(&staticConfig);
+            busStatus = MCU_enuCheckBusClocks(&staticConfig);
+            if (MCU_OK != busStatus) {
+                return busStatus;
+            }
+        }
+
+        /* Flash must be slow enough for the fastest clock before any switch */
+        FlashVoltageRange = MCU_FLASH_VOLTAGE_RANGE;
+        if (MCU_OK != MCU_enuPrepareFlash()) {
+            return MCU_FLASH_ERROR;
+        }
+
         /* 
          * Configure system clock source based on compile-time setting
          * Three possible sources: HSI (internal), HSE (external), or PLL (multiplied)
@@ -80,8 +175,21 @@ MCU_Status_t MCU_enuInit(MCU_Config_t *localMcuConfig) {
             /* Configure PLL with multiplication and division factors
              * Formula: PLL_output = (Input_clock / PLLM) × PLLN / PLLP
              * PLLQ is used for USB/SDIO/RNG peripherals (48 MHz target) */
+#if (MCU_PLL_FACTORS_MODE == MCU_PLL_AUTO_FACTORS)
+            /* Solve M/N/P/Q from the PLL input clock and the target frequency */
+            RCC_PLLFactors_t pllFactors;
+            uint32_t pllInput = (MCU_PLL_SOURCE == MCU_PLL_SOURCE_HSE) ? MCU_HSE_CLOCK_SOURCE_VALUE : MCU_HSI_CLOCK_SOURCE_VALUE;
+            status = RCC_SolvePLL(pllInput, MCU_PLL_TARGET_FREQUENCY, &pllFactors);
+            if (RCC_OK != status) {
+                /* Return error if the target cannot be reached exactly */
+                return (MCU_Status_t)status;
+            }
+            status = RCC_ConfigurePLL(pllFactors.PLLM, pllFactors.PLLN, pllFactors.PLLP,
+                                       pllFactors.PLLQ, MCU_PLL_SOURCE);
+#else
             status = RCC_ConfigurePLL(MCU_PLL_M, MCU_PLL_N, MCU_PLL_P,
                                        MCU_PLL_Q, MCU_PLL_SOURCE);
+#endif
             if (RCC_OK != status) {
                 /* Return error if PLL parameters are invalid */
                 return (MCU_Status_t)status;
@@ -106,32 +214,42 @@ MCU_Status_t MCU_enuInit(MCU_Config_t *localMcuConfig) {
             return (MCU_WRONG_SYSCLK_SOURCE);
         }
 
+        MCU_BOOT_MARK("MCU clock source");
+
         /* 
          * Configure bus prescalers to divide system clock for different buses
          * This ensures peripheral buses don't exceed their maximum frequencies
          */
         
         /* Set AHB prescaler (divides SYSCLK to generate HCLK for CPU, memory, DMA) */
-        status = RCC_SetAHBPrescaler(MCU_AHB_PRESCALER);
+        status = RCC_SetAHBPrescaler((RCC_AHPPrescaler_t)MCU_AHB_PRESCALER);
         if (RCC_OK != status) {
             /* Return error if prescaler value is invalid */
             return (MCU_Status_t)status;
         }
 
         /* Set APB1 prescaler (divides HCLK to generate PCLK1, max 42 MHz) */
-        status = RCC_SetAPB1Prescaler(MCU_APB1_PRESCALER);
+        status = RCC_SetAPB1Prescaler((RCC_APB1Prescaler_t)MCU_APB1_PRESCALER);
         if (RCC_OK != status) {
             /* Return error if prescaler value is invalid */
             return (MCU_Status_t)status;
         }
 
         /* Set APB2 prescaler (divides HCLK to generate PCLK2, max 84 MHz) */
-        status = RCC_SetAPB2Prescaler(MCU_APB2_PRESCALER);
+        status = RCC_SetAPB2Prescaler((RCC_APB2Prescaler_t)MCU_APB2_PRESCALER);
         if (RCC_OK != status) {
             /* Return error if prescaler value is invalid */
             return (MCU_Status_t)status;
         }
 
+        /* Lowest wait states for the final HCLK, then prefetch and ART caches */
+        if (MCU_OK != MCU_enuTrimFlash()) {
+            return MCU_FLASH_ERROR;
+        }
+        if (FLASH_OK != FLASH_enuConfigureAccelerator(MCU_FLASH_ACCELERATOR, FlashVoltageRange)) {
+            return MCU_FLASH_ERROR;
+        }
+
         /*
          * Enable peripheral clocks on each bus
          * Only enable if at least one peripheral is requested
@@ -174,6 +292,14 @@ MCU_Status_t MCU_enuInit(MCU_Config_t *localMcuConfig) {
             }
         }
         
+        MCU_BOOT_MARK("MCU bus and peripheral clocks");
+
+        /* Fitted board pins, one image per port, now that the GPIO clocks are on */
+        if (BOARD_OK != BOARD_enuInit()) {
+            return MCU_BOARD_ERROR;
+        }
+        MCU_BOOT_MARK("MCU board pins");
+
         /* Return final status (should be RCC_OK if all operations succeeded) */
         return status;
 
@@ -192,7 +318,22 @@ MCU_Status_t MCU_enuInit(MCU_Config_t *localMcuConfig) {
         RCC_HSI_ClockSourceValue = MCU_Configs.MCU_HSI_ClockSource;
         
         /* Set the HSE clock source frequency value from configuration structure */
-        RCC_HSE_ClockSourceValue = MCU_Configs.MCU_HSI_ClockSource;
+        RCC_HSE_ClockSourceValue = MCU_Configs.MCU_HSE_ClockSource;
+
+        /* Bus limits are checked before anything is switched */
+        {
+            MCU_Status_t busStatus = MCU_enuCheckBusClocks(&MCU_Configs);
+
+            if (MCU_OK != busStatus) {
+                return busStatus;
+            }
+        }
+
+        /* Flash must be slow enough for the fastest clock before any switch */
+        FlashVoltageRange = (FLASH_VoltageRange_t)MCU_Configs.MCU_FlashVoltageRange;
+        if (MCU_OK != MCU_enuPrepareFlash()) {
+            return MCU_FLASH_ERROR;
+        }
 
         /* 
          * Configure system clock source based on runtime configuration
@@ -235,8 +376,26 @@ MCU_Status_t MCU_enuInit(MCU_Config_t *localMcuConfig) {
             /* Configure PLL with multiplication and division factors from config structure
              * Formula: PLL_output = (Input_clock / PLLM) × PLLN / PLLP
              * PLLQ is used for USB/SDIO/RNG peripherals (48 MHz target) */
-            status = RCC_ConfigurePLL(MCU_Configs.MCU_PLLM, MCU_Configs.MCU_PLLN, MCU_Configs.MCU_PLLP,
-                                    MCU_Configs.MCU_PLLQ, MCU_Configs.MCU_PLLClockSource);
+            RCC_PLLFactors_t pllFactors = {
+                .PLLM = MCU_Configs.MCU_PLLM,
+                .PLLN = MCU_Configs.MCU_PLLN,
+                .PLLP = MCU_Configs.MCU_PLLP,
+                .PLLQ = MCU_Configs.MCU_PLLQ
+            };
+
+            /* A non-zero target frequency asks the solver to compute M/N/P/Q */
+            if (0 != MCU_Configs.MCU_PLLTargetFrequency) {
+                uint32_t pllInput = (MCU_Configs.MCU_PLLClockSource == MCU_PLL_SOURCE_HSE) ?
+                                     MCU_Configs.MCU_HSE_ClockSource : MCU_Configs.MCU_HSI_ClockSource;
+                status = RCC_SolvePLL(pllInput, MCU_Configs.MCU_PLLTargetFrequency, &pllFactors);
+                if (RCC_OK != status) {
+                    /* Return error if the target cannot be reached exactly */
+                    return (MCU_Status_t)status;
+                }
+            }
+
+            status = RCC_ConfigurePLL(pllFactors.PLLM, pllFactors.PLLN, pllFactors.PLLP,
+                                    pllFactors.PLLQ, MCU_Configs.MCU_PLLClockSource);
             if (RCC_OK != status) {
                 /* Return error if PLL parameters are invalid */
                 return (MCU_Status_t)status;
@@ -261,32 +420,42 @@ MCU_Status_t MCU_enuInit(MCU_Config_t *localMcuConfig) {
             return MCU_WRONG_SYSCLK_SOURCE;
          }
 
+        MCU_BOOT_MARK("MCU clock source");
+
         /* 
          * Configure bus prescalers from configuration structure
          * This ensures peripheral buses don't exceed their maximum frequencies
          */
         
         /* Set AHB prescaler from configuration (divides SYSCLK to generate HCLK) */
-        status = RCC_SetAHBPrescaler(MCU_Configs.MCU_AHP_Prescaler);
+        status = RCC_SetAHBPrescaler((RCC_AHPPrescaler_t)MCU_Configs.MCU_AHP_Prescaler);
         if (RCC_OK != status) {
             /* Return error if prescaler value is invalid */
             return (MCU_Status_t)status;
         }
 
         /* Set APB1 prescaler from configuration (divides HCLK to generate PCLK1, max 42 MHz) */
-        status = RCC_SetAPB1Prescaler(MCU_Configs.MCU_APB1_Prescaler);
+        status = RCC_SetAPB1Prescaler((RCC_APB1Prescaler_t)MCU_Configs.MCU_APB1_Prescaler);
         if (RCC_OK != status) {
             /* Return error if prescaler value is invalid */
             return (MCU_Status_t)status;
         }
 
         /* Set APB2 prescaler from configuration (divides HCLK to generate PCLK2, max 84 MHz) */
-        status = RCC_SetAPB2Prescaler(MCU_Configs.MCU_APB2_Prescaler);
+        status = RCC_SetAPB2Prescaler((RCC_APB2Prescaler_t)MCU_Configs.MCU_APB2_Prescaler);
         if (RCC_OK != status) {
             /* Return error if prescaler value is invalid */
             return (MCU_Status_t)status;
         }
 
+        /* Lowest wait states for the final HCLK, then prefetch and ART caches */
+        if (MCU_OK != MCU_enuTrimFlash()) {
+            return MCU_FLASH_ERROR;
+        }
+        if (FLASH_OK != FLASH_enuConfigureAccelerator(MCU_Configs.MCU_FlashAccelerator, FlashVoltageRange)) {
+            return MCU_FLASH_ERROR;
+        }
+
         /*
          * Enable peripheral clocks on each bus based on configuration structure
          * Only enable if at least one peripheral is requested
@@ -329,6 +498,14 @@ MCU_Status_t MCU_enuInit(MCU_Config_t *localMcuConfig) {
             }
         }
         
+        MCU_BOOT_MARK("MCU bus and peripheral clocks");
+
+        /* Fitted board pins, one image per port, now that the GPIO clocks are on */
+        if (BOARD_OK != BOARD_enuInit()) {
+            return MCU_BOARD_ERROR;
+        }
+        MCU_BOOT_MARK("MCU board pins");
+
         /* Return final status (should be RCC_OK if all operations succeeded) */
         return status;
     
@@ -340,4 +517,737 @@ MCU_Status_t MCU_enuInit(MCU_Config_t *localMcuConfig) {
     else{
         return (MCU_WRONG_CONFIG);
     }
-}
\ No newline at end of file
+}
+
+/*
+ * Function: MCU_enuFastStartInit
+ * Description: Starts the clock tree of MCU_enuInit without waiting for it
+ * Parameters:
+ *   - localMcuConfig: NULL for the compile-time configuration, &MCU_Configs otherwise
+ * Returns: MCU_Status_t indicating success or specific error condition
+ *
+ * Function performs the following steps:
+ * 1. Flash wait states for the maximum HCLK (the clock only gets faster later)
+ * 2. Static peripheral clocks and the fitted board pins (BOARD_enuInit)
+ * 3. PLL factors are written, HSE and/or the PLL are switched on
+ * Prescalers and SYSCLK are applied by MCU_enuPollInit once the clock is stable
+ */
+MCU_Status_t MCU_enuFastStartInit(const MCU_Config_t *localMcuConfig) {
+    RCC_Status_t status = RCC_NOT_OK;
+
+    /* Both configuration modes end up in the same structure */
+    if (NULL == localMcuConfig) {
+        MCU_vdLoadStaticConfig(&FastStartConfig);
+    }
+    else if (&MCU_Configs == localMcuConfig) {
+        FastStartConfig = MCU_Configs;
+    }
+    else {
+        return MCU_WRONG_CONFIG;
+    }
+
+    RCC_HSI_ClockSourceValue = FastStartConfig.MCU_HSI_ClockSource;
+    RCC_HSE_ClockSourceValue = FastStartConfig.MCU_HSE_ClockSource;
+
+    /* Bus limits are checked before anything is switched */
+    {
+        MCU_Status_t busStatus = MCU_enuCheckBusClocks(&FastStartConfig);
+
+        if (MCU_OK != busStatus) {
+            return busStatus;
+        }
+    }
+
+    /* Step 1: flash must be slow enough for the fastest clock before any switch */
+    FlashVoltageRange = (FLASH_VoltageRange_t)FastStartConfig.MCU_FlashVoltageRange;
+    if (MCU_OK != MCU_enuPrepareFlash()) {
+        return MCU_FLASH_ERROR;
+    }
+
+    /* Step 2: peripheral clocks first, drivers can be initialized from HSI */
+    if (MCU_AHB1_NO_PERIPHERAL != FastStartConfig.MCU_AHB1_PrephralEnable) {
+        status = RCC_EnablePeripheralClock(RCC_AHB1_BUS, FastStartConfig.MCU_AHB1_PrephralEnable);
+        if (RCC_OK != status) {
+            return (MCU_Status_t)status;
+        }
+    }
+    if (MCU_AHB2_NO_PERIPHERAL != FastStartConfig.MCU_AHB2_PrephralEnable) {
+        status = RCC_EnablePeripheralClock(RCC_AHB2_BUS, FastStartConfig.MCU_AHB2_PrephralEnable);
+        if (RCC_OK != status) {
+            return (MCU_Status_t)status;
+        }
+    }
+    if (MCU_APB1_NO_PERIPHERAL != FastStartConfig.MCU_APB1_PrephralEnable) {
+        status = RCC_EnablePeripheralClock(RCC_APB1_BUS, FastStartConfig.MCU_APB1_PrephralEnable);
+        if (RCC_OK != status) {
+            return (MCU_Status_t)status;
+        }
+    }
+    if (MCU_APB2_NO_PERIPHERAL != FastStartConfig.MCU_APB2_PrephralEnable) {
+        status = RCC_EnablePeripheralClock(RCC_APB2_BUS, FastStartConfig.MCU_APB2_PrephralEnable);
+        if (RCC_OK != status) {
+            return (MCU_Status_t)status;
+        }
+    }
+
+    /* Fitted board pins, the GPIO clocks are on */
+    if (BOARD_OK != BOARD_enuInit()) {
+        return MCU_BOARD_ERROR;
+    }
+
+    /* Step 3: kick the oscillator and the PLL */
+    if (MCU_SYSCLK_HSI == FastStartConfig.MCU_SystemClockSource) {
+        /* HSI is running since reset */
+        FastStartState = MCU_FAST_START_SWITCH;
+    }
+    else if (MCU_SYSCLK_HSE == FastStartConfig.MCU_SystemClockSource) {
+        (void)RCC_StartHSE();
+        FastStartState = MCU_FAST_START_WAIT_HSE;
+    }
+    else if (MCU_SYSCLK_PLL == FastStartConfig.MCU_SystemClockSource) {
+        RCC_PLLFactors_t pllFactors = {
+            .PLLM = FastStartConfig.MCU_PLLM,
+            .PLLN = FastStartConfig.MCU_PLLN,
+            .PLLP = FastStartConfig.MCU_PLLP,
+            .PLLQ = FastStartConfig.MCU_PLLQ
+        };
+
+        if (0 != FastStartConfig.MCU_PLLTargetFrequency) {
+            uint32_t pllInput = (MCU_PLL_SOURCE_HSE == FastStartConfig.MCU_PLLClockSource) ?
+                                 FastStartConfig.MCU_HSE_ClockSource : FastStartConfig.MCU_HSI_ClockSource;
+            status = RCC_SolvePLL(pllInput, FastStartConfig.MCU_PLLTargetFrequency, &pllFactors);
+            if (RCC_OK != status) {
+                return (MCU_Status_t)status;
+            }
+        }
+
+        /* PLLCFGR can be written while the input oscillator is still starting */
+        status = RCC_ConfigurePLL(pllFactors.PLLM, pllFactors.PLLN, pllFactors.PLLP,
+                                  pllFactors.PLLQ, FastStartConfig.MCU_PLLClockSource);
+        if (RCC_OK != status) {
+            return (MCU_Status_t)status;
+        }
+
+        if (MCU_PLL_SOURCE_HSE == FastStartConfig.MCU_PLLClockSource) {
+            (void)RCC_StartHSE();
+            FastStartState = MCU_FAST_START_WAIT_HSE;
+        }
+        else {
+            (void)RCC_StartPLL();
+            FastStartState = MCU_FAST_START_WAIT_PLL;
+        }
+    }
+    else {
+        return MCU_WRONG_SYSCLK_SOURCE;
+    }
+
+    /* Timeout is counted in HSI cycles, the CPU runs from HSI until the switch */
+    /* CYCCNT is not reset, a running boot profile is kept */
+    DWT_vdStart();
+    FastStartBeginCycles = DWT_CYCCNT;
+    FastStartTimeoutCycles = (FastStartConfig.MCU_HSI_ClockSource / 1000000UL) * MCU_FAST_START_TIMEOUT_US;
+
+    MCU_BOOT_MARK("MCU fast-start kick");
+
+    return MCU_OK;
+}
+
+/*
+ * Function: MCU_enuPollInit
+ * Description: Moves the fast-start sequence forward as far as the hardware allows
+ *              HSE ready -> PLL started -> PLL locked -> prescalers, SYSCLK, flash
+ *              Several steps can complete in the same call
+ * Returns: MCU_BOOT_PENDING, MCU_OK, MCU_TIMEOUT, or the error of the failing step
+ */
+MCU_Status_t MCU_enuPollInit(void) {
+    RCC_Status_t status = RCC_NOT_OK;
+
+    if (MCU_FAST_START_IDLE == FastStartState) {
+        return MCU_NOT_OK;
+    }
+    if (MCU_FAST_START_DONE == FastStartState) {
+        return MCU_OK;
+    }
+    if (MCU_FAST_START_FAILED == FastStartState) {
+        return MCU_TIMEOUT;
+    }
+
+    if ((MCU_FAST_START_WAIT_HSE == FastStartState) && (0 != RCC_IsHSEReady())) {
+        MCU_BOOT_MARK("MCU HSE start-up");
+        if (MCU_SYSCLK_HSE == FastStartConfig.MCU_SystemClockSource) {
+            FastStartState = MCU_FAST_START_SWITCH;
+        }
+        else {
+            (void)RCC_StartPLL();
+            FastStartState = MCU_FAST_START_WAIT_PLL;
+        }
+    }
+
+    if ((MCU_FAST_START_WAIT_PLL == FastStartState) && (0 != RCC_IsPLLReady())) {
+        MCU_BOOT_MARK("MCU PLL lock");
+        FastStartState = MCU_FAST_START_SWITCH;
+    }
+
+    if (MCU_FAST_START_SWITCH != FastStartState) {
+        if ((DWT_CYCCNT - FastStartBeginCycles) > FastStartTimeoutCycles) {
+            FastStartState = MCU_FAST_START_FAILED;
+            return MCU_TIMEOUT;
+        }
+        return MCU_BOOT_PENDING;
+    }
+
+    /* Prescalers are applied while still on HSI, no bus can overshoot its limit */
+    status = RCC_SetAHBPrescaler((RCC_AHPPrescaler_t)FastStartConfig.MCU_AHP_Prescaler);
+    if (RCC_OK != status) {
+        return (MCU_Status_t)status;
+    }
+    status = RCC_SetAPB1Prescaler((RCC_APB1Prescaler_t)FastStartConfig.MCU_APB1_Prescaler);
+    if (RCC_OK != status) {
+        return (MCU_Status_t)status;
+    }
+    status = RCC_SetAPB2Prescaler((RCC_APB2Prescaler_t)FastStartConfig.MCU_APB2_Prescaler);
+    if (RCC_OK != status) {
+        return (MCU_Status_t)status;
+    }
+
+    status = RCC_SetSysClock((RCC_ClockSrc_t)FastStartConfig.MCU_SystemClockSource);
+    if (RCC_OK != status) {
+        return (MCU_Status_t)status;
+    }
+
+    if (MCU_OK != MCU_enuTrimFlash()) {
+        return MCU_FLASH_ERROR;
+    }
+    if (FLASH_OK != FLASH_enuConfigureAccelerator(FastStartConfig.MCU_FlashAccelerator, FlashVoltageRange)) {
+        return MCU_FLASH_ERROR;
+    }
+
+    FastStartState = MCU_FAST_START_DONE;
+    MCU_BOOT_MARK("MCU clock switch");
+
+    return MCU_OK;
+}
+
+/*
+ * Function: MCU_vdBootProfilerStart
+ * Description: Restarts the DWT cycle counter from 0 and clears the boot report
+ */
+void MCU_vdBootProfilerStart(void) {
+    DWT_vdRestart();
+
+    BootPhaseCount = 0;
+    BootTotalMicroseconds = 0;
+    BootLastCycles = 0;
+    if (RCC_OK != RCC_GetClockHz(RCC_AHB1_BUS, &BootLastHclk)) {
+        BootLastHclk = 0;
+    }
+    BootProfilerRunning = TRUE;
+}
+
+/*
+ * Function: MCU_enuBootMark
+ * Description: Stores the cycles elapsed since the previous mark under phaseName
+ *              The HCLK read here is used to convert the NEXT phase, a phase
+ *              that contains a clock switch is converted with the old clock
+ */
+MCU_Status_t MCU_enuBootMark(const char *phaseName) {
+    uint32_t now = DWT_CYCCNT;
+    uint32_t cycles = 0;
+
+    if ((FALSE == BootProfilerRunning) || (NULL == phaseName)) {
+        return MCU_NOT_OK;
+    }
+    if (BootPhaseCount >= MCU_BOOT_MAX_PHASES) {
+        return MCU_BOOT_REPORT_FULL;
+    }
+
+    cycles = now - BootLastCycles;
+    BootPhases[BootPhaseCount].MCU_PhaseName = phaseName;
+    BootPhases[BootPhaseCount].MCU_PhaseCycles = cycles;
+    BootPhases[BootPhaseCount].MCU_PhaseMicroseconds =
+        (0 != BootLastHclk) ? (uint32_t)(((uint64_t)cycles * 1000000ULL) / BootLastHclk) : 0;
+    BootTotalMicroseconds += BootPhases[BootPhaseCount].MCU_PhaseMicroseconds;
+    BootPhaseCount++;
+
+    BootLastCycles = now;
+    if (RCC_OK != RCC_GetClockHz(RCC_AHB1_BUS, &BootLastHclk)) {
+        BootLastHclk = 0;
+    }
+
+    return MCU_OK;
+}
+
+/*
+ * Function: MCU_enuGetBootReport
+ * Description: Gives access to the boot phases recorded so far
+ */
+MCU_Status_t MCU_enuGetBootReport(const MCU_BootPhase_t **phases, uint8_t *phaseCount, uint32_t *totalMicroseconds) {
+    if ((NULL == phases) || (NULL == phaseCount) || (NULL == totalMicroseconds)) {
+        return MCU_NOT_OK;
+    }
+
+    *phases = BootPhases;
+    *phaseCount = BootPhaseCount;
+    *totalMicroseconds = BootTotalMicroseconds;
+
+    return MCU_OK;
+}
+
+/*
+ * Function: MCU_GetClockHz
+ * Description: Returns the current clock frequency of a bus
+ *              The value is read back from the RCC registers, so it always
+ *              matches the clock tree programmed by MCU_enuInit
+ * Parameters:
+ *   - bus: MCU_AHB1_BUS, MCU_AHB2_BUS, MCU_APB1_BUS or MCU_APB2_BUS
+ *   - clockHz: Pointer to store the frequency in Hz
+ * Returns: MCU_Status_t indicating success or specific error condition
+ */
+MCU_Status_t MCU_GetClockHz(uint8_t bus, uint32_t *clockHz) {
+    return (MCU_Status_t)RCC_GetClockHz(bus, clockHz);
+}
+
+/*
+ * Function: MCU_enuRegisterClockNotifier
+ * Description: Stores a driver callback in the first free notifier slot
+ * Parameters:
+ *   - notifier: Callback receiving MCU_CLOCK_PRE_CHANGE / MCU_CLOCK_POST_CHANGE
+ * Returns: MCU_OK, MCU_NOT_OK (NULL notifier) or MCU_CLOCK_NOTIFIERS_FULL
+ */
+MCU_Status_t MCU_enuRegisterClockNotifier(MCU_ClockNotifier_t notifier) {
+    uint8_t index;
+
+    if (NULL == notifier) {
+        return MCU_NOT_OK;
+    }
+
+    /* Already registered : nothing to do */
+    for (index = 0; index < MCU_MAX_CLOCK_NOTIFIERS; index++) {
+        if (ClockNotifiers[index] == notifier) {
+            return MCU_OK;
+        }
+    }
+
+    /* Take the first free slot */
+    for (index = 0; index < MCU_MAX_CLOCK_NOTIFIERS; index++) {
+        if (NULL == ClockNotifiers[index]) {
+            ClockNotifiers[index] = notifier;
+            return MCU_OK;
+        }
+    }
+
+    return MCU_CLOCK_NOTIFIERS_FULL;
+}
+
+/*
+ * Function: MCU_enuRegisterClockGuard
+ * Description: Stores a driver guard in the first free guard slot
+ * Parameters:
+ *   - guard: Callback returning 1 while the clock must not change
+ * Returns: MCU_OK, MCU_NOT_OK (NULL guard) or MCU_CLOCK_NOTIFIERS_FULL
+ */
+MCU_Status_t MCU_enuRegisterClockGuard(MCU_ClockGuard_t guard) {
+    uint8_t index;
+
+    if (NULL == guard) {
+        return MCU_NOT_OK;
+    }
+
+    /* Already registered : nothing to do */
+    for (index = 0; index < MCU_MAX_CLOCK_GUARDS; index++) {
+        if (ClockGuards[index] == guard) {
+            return MCU_OK;
+        }
+    }
+
+    /* Take the first free slot */
+    for (index = 0; index < MCU_MAX_CLOCK_GUARDS; index++) {
+        if (NULL == ClockGuards[index]) {
+            ClockGuards[index] = guard;
+            return MCU_OK;
+        }
+    }
+
+    return MCU_CLOCK_NOTIFIERS_FULL;
+}
+
+/*
+ * Function: MCU_enuSetClockProfile
+ * Description: Switches the clock tree to a new operating point at runtime
+ *              and re-times every registered driver around the switch
+ * Parameters:
+ *   - profile: Pointer to the clock profile to apply
+ * Returns: MCU_Status_t indicating success or specific error condition
+ *
+ * Function performs the following steps:
+ * 1. A PLL that clocks SYSCLK cannot take new factors, SYSCLK first moves to
+ *    HSI with the target prescalers (a complete switch of its own)
+ * 2. The target oscillators are started and the PLL locked with interrupts
+ *    enabled, so the lock time never adds to the interrupt latency
+ * 3. The switch itself (see MCU_enuSwitchClock) only holds the critical section
+ *    for the SW, prescaler and flash latency writes
+ * 4. The PLL is stopped once SYSCLK no longer needs it
+ */
+MCU_Status_t MCU_enuSetClockProfile(const MCU_ClockProfile_t *profile) {
+    MCU_Status_t status = MCU_OK;
+    RCC_ClockSrc_t runningSource = RCC_SYSCLK_HSI;
+    uint32_t sysclkHz = 0;
+
+    if (NULL == profile) {
+        return MCU_NOT_OK;
+    }
+
+    /* A profile that overclocks a bus is refused before any driver is notified */
+    if (MCU_SYSCLK_HSI == profile->MCU_SystemClockSource) {
+        sysclkHz = RCC_HSI_ClockSourceValue;
+    } else if (MCU_SYSCLK_HSE == profile->MCU_SystemClockSource) {
+        sysclkHz = RCC_HSE_ClockSourceValue;
+    } else {
+        sysclkHz = profile->MCU_PLLTargetFrequency;
+    }
+    status = (MCU_Status_t)RCC_CheckBusClocks(sysclkHz,
+                                              (RCC_AHPPrescaler_t)profile->MCU_AHP_Prescaler,
+                                              (RCC_APB1Prescaler_t)profile->MCU_APB1_Prescaler,
+                                              (RCC_APB2Prescaler_t)profile->MCU_APB2_Prescaler);
+    if (MCU_OK != status) {
+        return status;
+    }
+
+    /* Step 1: get off the PLL before its factors change */
+    if ((MCU_SYSCLK_PLL == profile->MCU_SystemClockSource) &&
+        (RCC_OK == RCC_GetSystemClockSource(&runningSource)) &&
+        (RCC_SYSCLK_PLL == runningSource)) {
+        MCU_ClockProfile_t hsiStep = *profile;
+
+        hsiStep.MCU_SystemClockSource = MCU_SYSCLK_HSI;
+        status = MCU_enuSwitchClock(&hsiStep);
+    }
+
+    /* Step 2 and 3: lock the target sources, then switch */
+    if (MCU_OK == status) {
+        status = MCU_enuSwitchClock(profile);
+    }
+
+    /* Step 4: SYSCLK runs from HSI or HSE, the PLL has nothing left to clock */
+    if ((MCU_OK == status) && (MCU_SYSCLK_PLL != profile->MCU_SystemClockSource)) {
+        status = (MCU_Status_t)RCC_DisablePLL();
+    }
+
+    return status;
+}
+
+/*
+ * Function: MCU_enuSuspendClock
+ * Description: Records the running clock source before STOP mode
+ *              Nothing is changed in the clock tree, the hardware itself
+ *              falls back to HSI when it wakes up
+ */
+MCU_Status_t MCU_enuSuspendClock(void) {
+    RCC_Status_t status = RCC_GetSystemClockSource(&SuspendedClockSource);
+
+    if (RCC_OK != status) {
+        return (MCU_Status_t)status;
+    }
+    return (MCU_Status_t)RCC_GetPLLSource(&SuspendedPLLSource);
+}
+
+/*
+ * Function: MCU_enuResumeClock
+ * Description: Restarts the oscillators stopped by STOP mode and switches SYSCLK back
+ * Function performs the following steps (MCU_enuInit order):
+ * 1. HSE is enabled when it was SYSCLK or the PLL input
+ * 2. The PLL is enabled with the factors kept in PLLCFGR
+ * 3. SYSCLK is switched back to the recorded source
+ * Note: Flash wait states were never lowered, they already fit the restored HCLK
+ */
+MCU_Status_t MCU_enuResumeClock(void) {
+    RCC_Status_t status = RCC_OK;
+
+    if (RCC_SYSCLK_HSI == SuspendedClockSource) {
+        /* STOP wake-up already runs from HSI */
+        return MCU_OK;
+    }
+
+    if ((RCC_SYSCLK_HSE == SuspendedClockSource) || (RCC_PLL_SOURCE_HSE == SuspendedPLLSource)) {
+        status = RCC_EnableHSE();
+        if (RCC_OK != status) {
+            return (MCU_Status_t)status;
+        }
+    }
+
+    if (RCC_SYSCLK_PLL == SuspendedClockSource) {
+        status = RCC_EnablePLL();
+        if (RCC_OK != status) {
+            return (MCU_Status_t)status;
+        }
+    }
+
+    return (MCU_Status_t)RCC_SetSysClock(SuspendedClockSource);
+}
+
+/*
+ * Function: MCU_vdNotifyClockChange
+ * Description: Calls every registered notifier with the given phase
+ */
+static void MCU_vdNotifyClockChange(uint8_t phase) {
+    uint8_t index;
+
+    for (index = 0; index < MCU_MAX_CLOCK_NOTIFIERS; index++) {
+        if (NULL != ClockNotifiers[index]) {
+            ClockNotifiers[index](phase);
+        }
+    }
+}
+
+/*
+ * Function: MCU_u8ClockChangeBlocked
+ * Description: Asks every registered guard, called with interrupts masked
+ * Returns: 1 when at least one guard is busy, 0 otherwise
+ */
+static uint8_t MCU_u8ClockChangeBlocked(void) {
+    uint8_t index;
+    uint8_t blocked = 0U;
+
+    for (index = 0; index < MCU_MAX_CLOCK_GUARDS; index++) {
+        if ((NULL != ClockGuards[index]) && (0U != ClockGuards[index]())) {
+            blocked = 1U;
+        }
+    }
+    return blocked;
+}
+
+/*
+ * Function: MCU_enuSwitchClock
+ * Description: Moves SYSCLK to the profile source and re-times every registered driver
+ * Function performs the following steps:
+ * 1. PRE notification with interrupts enabled so drivers can drain ongoing transfers
+ * 2. Target oscillators are started and locked, interrupts still enabled
+ * 3. Guards are checked inside a critical section, a transfer that did not drain
+ *    (ex: a DMA frame the CPU does not feed) leaves the clock untouched
+ * 4. Clock tree is reprogrammed inside the same critical section
+ * 5. POST notification inside the same critical section, so no ISR ever runs
+ *    with a divider computed for the old clock
+ * Note: POST is sent even when the switch failed or was refused, drivers then
+ *       re-time to whatever clock is actually running
+ */
+static MCU_Status_t MCU_enuSwitchClock(const MCU_ClockProfile_t *profile) {
+    MCU_Status_t status = MCU_NOT_OK;
+
+    /* Step 1: let drivers finish frames that are on the wire */
+    MCU_vdNotifyClockChange(MCU_CLOCK_PRE_CHANGE);
+
+    /* Step 2: oscillator start-up and PLL lock are the long waits */
+    status = MCU_enuStartClockSource(profile);
+
+    /* Step 3 to 5: check, switch and re-time atomically */
+    NVIC_EnterCritical();
+    if (MCU_OK != status) {
+        /* Nothing was switched, drivers keep the running clock */
+    } else if (0U != MCU_u8ClockChangeBlocked()) {
+        status = MCU_CLOCK_BUSY;
+    } else {
+        status = MCU_enuApplyClockProfile(profile);
+    }
+    MCU_vdNotifyClockChange(MCU_CLOCK_POST_CHANGE);
+    NVIC_ExitCritical();
+
+    return status;
+}
+
+/*
+ * Function: MCU_enuStartClockSource
+ * Description: Starts HSI, the HSE when the profile needs it and locks the PLL
+ *              on the profile factors, called with interrupts enabled
+ *              SYSCLK must not be running from the PLL when the profile selects it
+ * Returns: MCU_Status_t of the first failing step, MCU_OK otherwise
+ */
+static MCU_Status_t MCU_enuStartClockSource(const MCU_ClockProfile_t *profile) {
+    RCC_Status_t status = RCC_NOT_OK;
+
+    /* HSI is the parking clock of every switch */
+    status = RCC_EnableHSI();
+    if (RCC_OK != status) {
+        return (MCU_Status_t)status;
+    }
+
+    if (MCU_SYSCLK_HSI == profile->MCU_SystemClockSource) {
+        return MCU_OK;
+    }
+    else if (MCU_SYSCLK_HSE == profile->MCU_SystemClockSource) {
+        return (MCU_Status_t)RCC_EnableHSE();
+    }
+    else if (MCU_SYSCLK_PLL == profile->MCU_SystemClockSource) {
+        RCC_PLLFactors_t pllFactors;
+        uint32_t pllInput = RCC_HSI_ClockSourceValue;
+
+        if (MCU_PLL_SOURCE_HSE == profile->MCU_PLLClockSource) {
+            status = RCC_EnableHSE();
+            if (RCC_OK != status) {
+                return (MCU_Status_t)status;
+            }
+            pllInput = RCC_HSE_ClockSourceValue;
+        }
+
+        status = RCC_SolvePLL(pllInput, profile->MCU_PLLTargetFrequency, &pllFactors);
+        if (RCC_OK != status) {
+            return (MCU_Status_t)status;
+        }
+
+        /* PLL factors can only be written while the PLL is off */
+        status = RCC_DisablePLL();
+        if (RCC_OK != status) {
+            return (MCU_Status_t)status;
+        }
+        status = RCC_ConfigurePLL(pllFactors.PLLM, pllFactors.PLLN, pllFactors.PLLP,
+                                  pllFactors.PLLQ, profile->MCU_PLLClockSource);
+        if (RCC_OK != status) {
+            return (MCU_Status_t)status;
+        }
+        return (MCU_Status_t)RCC_EnablePLL();
+    }
+    else {
+        return MCU_WRONG_SYSCLK_SOURCE;
+    }
+}
+
+/*
+ * Function: MCU_enuApplyClockProfile
+ * Description: Switches SYSCLK to the profile source, already started and locked
+ *              SYSCLK is parked on HSI (16 MHz) while the prescalers are changed,
+ *              so no bus ever runs above its limit during the switch
+ *              Flash wait states are raised to the maximum first and trimmed last
+ * Returns: MCU_Status_t of the first failing step, MCU_OK otherwise
+ */
+static MCU_Status_t MCU_enuApplyClockProfile(const MCU_ClockProfile_t *profile) {
+    RCC_Status_t status = RCC_NOT_OK;
+
+    if (MCU_OK != MCU_enuPrepareFlash()) {
+        return MCU_FLASH_ERROR;
+    }
+
+    /* Park SYSCLK on HSI, the safe clock for every prescaler setting */
+    status = RCC_SetSysClock(RCC_SYSCLK_HSI);
+    if (RCC_OK != status) {
+        return (MCU_Status_t)status;
+    }
+
+    /* Apply the target prescalers while running slow */
+    status = RCC_SetAHBPrescaler((RCC_AHPPrescaler_t)profile->MCU_AHP_Prescaler);
+    if (RCC_OK != status) {
+        return (MCU_Status_t)status;
+    }
+    status = RCC_SetAPB1Prescaler((RCC_APB1Prescaler_t)profile->MCU_APB1_Prescaler);
+    if (RCC_OK != status) {
+        return (MCU_Status_t)status;
+    }
+    status = RCC_SetAPB2Prescaler((RCC_APB2Prescaler_t)profile->MCU_APB2_Prescaler);
+    if (RCC_OK != status) {
+        return (MCU_Status_t)status;
+    }
+
+    if (MCU_SYSCLK_HSE == profile->MCU_SystemClockSource) {
+        status = RCC_SetSysClock(RCC_SYSCLK_HSE);
+    }
+    else if (MCU_SYSCLK_PLL == profile->MCU_SystemClockSource) {
+        status = RCC_SetSysClock(RCC_SYSCLK_PLL);
+    }
+
+    if (RCC_OK != status) {
+        return (MCU_Status_t)status;
+    }
+
+    return MCU_enuTrimFlash();
+}
+
+/*
+ * Function: MCU_vdLoadStaticConfig
+ * Description: Copies the compile-time configuration of mcu_cfg.h into a structure
+ */
+static void MCU_vdLoadStaticConfig(MCU_Config_t *config) {
+    config->MCU_AHB1_PrephralEnable = MCU_AHB1_PERIPHERALS_ENABLE;
+    config->MCU_AHB2_PrephralEnable = MCU_AHB2_PERIPHERALS_ENABLE;
+    config->MCU_APB1_PrephralEnable = MCU_APB1_PERIPHERALS_ENABLE;
+    config->MCU_APB2_PrephralEnable = MCU_APB2_PERIPHERALS_ENABLE;
+    config->MCU_SystemClockSource   = MCU_SYSCLK_SOURCE;
+    config->MCU_AHP_Prescaler       = MCU_AHB_PRESCALER;
+    config->MCU_APB1_Prescaler      = MCU_APB1_PRESCALER;
+    config->MCU_APB2_Prescaler      = MCU_APB2_PRESCALER;
+    config->MCU_HSI_ClockSource     = MCU_HSI_CLOCK_SOURCE_VALUE;
+    config->MCU_HSE_ClockSource     = MCU_HSE_CLOCK_SOURCE_VALUE;
+    config->MCU_PLLClockSource      = MCU_PLL_SOURCE;
+    config->MCU_PLLM                = MCU_PLL_M;
+    config->MCU_PLLN                = MCU_PLL_N;
+    config->MCU_PLLP                = MCU_PLL_P;
+    config->MCU_PLLQ                = MCU_PLL_Q;
+#if (MCU_PLL_FACTORS_MODE == MCU_PLL_AUTO_FACTORS)
+    config->MCU_PLLTargetFrequency  = MCU_PLL_TARGET_FREQUENCY;
+#else
+    config->MCU_PLLTargetFrequency  = 0;
+#endif
+    config->MCU_FlashVoltageRange   = MCU_FLASH_VOLTAGE_RANGE;
+    config->MCU_FlashAccelerator    = MCU_FLASH_ACCELERATOR;
+}
+
+/*
+ * Function: MCU_enuCheckBusClocks
+ * Description: Computes the SYSCLK of a configuration (target frequency or the
+ *              manual PLL factors) and checks PCLK1 <= 42 MHz, PCLK2 <= 84 MHz
+ * Returns: MCU_OK, MCU_WRONG_APB_PRESCALER when a bus would be overclocked,
+ *          MCU_WRONG_CONFIG (RCC_WRONG_CLOCK_SOURCE) when SYSCLK is 0 or above 84 MHz
+ */
+static MCU_Status_t MCU_enuCheckBusClocks(const MCU_Config_t *config) {
+    uint32_t sysclkHz = 0;
+
+    if (MCU_SYSCLK_HSI == config->MCU_SystemClockSource) {
+        sysclkHz = config->MCU_HSI_ClockSource;
+    }
+    else if (MCU_SYSCLK_HSE == config->MCU_SystemClockSource) {
+        sysclkHz = config->MCU_HSE_ClockSource;
+    }
+    else if (0 != config->MCU_PLLTargetFrequency) {
+        sysclkHz = config->MCU_PLLTargetFrequency;
+    }
+    else if ((0 != config->MCU_PLLM) && (0 != config->MCU_PLLP)) {
+        uint32_t pllInput = (MCU_PLL_SOURCE_HSE == config->MCU_PLLClockSource) ?
+                            config->MCU_HSE_ClockSource : config->MCU_HSI_ClockSource;
+        sysclkHz = (uint32_t)(((uint64_t)pllInput * config->MCU_PLLN) /
+                              ((uint64_t)config->MCU_PLLM * config->MCU_PLLP));
+    }
+
+    return (MCU_Status_t)RCC_CheckBusClocks(sysclkHz,
+                                            (RCC_AHPPrescaler_t)config->MCU_AHP_Prescaler,
+                                            (RCC_APB1Prescaler_t)config->MCU_APB1_Prescaler,
+                                            (RCC_APB2Prescaler_t)config->MCU_APB2_Prescaler);
+}
+
+/*
+ * Function: MCU_enuPrepareFlash
+ * Description: Programs the wait states required at the maximum HCLK (84 MHz)
+ *              Must run before SYSCLK or the AHB prescaler can make HCLK faster
+ * Returns: MCU_OK or MCU_FLASH_ERROR
+ */
+static MCU_Status_t MCU_enuPrepareFlash(void) {
+    if (FLASH_OK != FLASH_enuSetLatency(MCU_FLASH_HCLK_MAX, FlashVoltageRange)) {
+        return MCU_FLASH_ERROR;
+    }
+    return MCU_OK;
+}
+
+/*
+ * Function: MCU_enuTrimFlash
+ * Description: Lowers the wait states to the minimum allowed by the running HCLK
+ *              Called once the clock tree is final, so HCLK can only be equal
+ *              to what the new latency was computed for
+ * Returns: MCU_OK or MCU_FLASH_ERROR
+ */
+static MCU_Status_t MCU_enuTrimFlash(void) {
+    uint32_t hclk = 0;
+
+    if (RCC_OK != RCC_GetClockHz(RCC_AHB1_BUS, &hclk)) {
+        return MCU_FLASH_ERROR;
+    }
+    if (FLASH_OK != FLASH_enuSetLatency(hclk, FlashVoltageRange)) {
+        return MCU_FLASH_ERROR;
+    }
+    return MCU_OK;
+}
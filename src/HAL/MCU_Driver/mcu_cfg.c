@@ -2,15 +2,19 @@
 
 #include "LIB/stdtypes.h"
 #include "MCAL/RCC_Driver/rcc_int.h"
+#include "MCAL/FLASH_Driver/flash.h"
+#include "MCAL/GPIO_Driver/gpio_int.h"
+#include "HAL/BOARD_Driver/board_cfg.h"
+#include "HAL/BOARD_Driver/board.h"
 
 #include "HAL/MCU_Driver/mcu_cfg.h"
 #include "HAL/MCU_Driver/mcu.h"
 
 const MCU_Config_t MCU_Configs = {
-    .MCU_AHB1_PrephralEnable = MCU_AHB1_GPIOA_CLOCK|MCU_AHB1_GPIOB_CLOCK|MCU_AHB1_GPIOC_CLOCK|MCU_AHB1_DMA2_CLOCK,
+    .MCU_AHB1_PrephralEnable = BOARD_AHB1_CLOCKS,              //GPIO ports of the fitted pins (board_cfg.h)
     .MCU_AHB2_PrephralEnable = MCU_AHB2_NO_PERIPHERAL,
-    .MCU_APB1_PrephralEnable = MCU_APB1_USART2_CLOCK,
-    .MCU_APB2_PrephralEnable = MCU_APB2_USART1_CLOCK|MCU_APB2_USART6_CLOCK|MCU_APB2_SPI1_CLOCK,
+    .MCU_APB1_PrephralEnable = MCU_APB1_NO_PERIPHERAL,
+    .MCU_APB2_PrephralEnable = MCU_APB2_NO_PERIPHERAL,
     .MCU_SystemClockSource   = MCU_SYSCLK_HSI,
     .MCU_AHP_Prescaler       = MCU_AHB_NO_DIVISION,
     .MCU_APB1_Prescaler      = MCU_APB1_NO_DIVISION,
@@ -20,11 +24,23 @@ const MCU_Config_t MCU_Configs = {
     .MCU_PLLN                = 336,
     .MCU_PLLM                = 16,
     .MCU_PLLP                = 4,  
-    .MCU_PLLQ                = 7  
+    .MCU_PLLQ                = 7,
+    .MCU_PLLTargetFrequency  = 0,                       //manual factors
+    .MCU_FlashVoltageRange   = MCU_FLASH_VOLTAGE_2V7_TO_3V6,
+    .MCU_FlashAccelerator    = MCU_FLASH_PREFETCH_ENABLE|MCU_FLASH_ICACHE_ENABLE|MCU_FLASH_DCACHE_ENABLE
 };
 
 
 
+/*  Peripheral clocks enabled here are always on (pinned)
+    *   UART, SPI and DMA clocks are acquired by their drivers at init and
+    *   released at deinit, do not list them here or they never gate off
+    *   GPIO ports used directly by the application (LEDs, switches, LCD...)
+    *   are still enabled here, BOARD_AHB1_CLOCKS folds them from board_cfg.h
+    *   so the UART / SPI port acquires only count an owner on those ports,
+    *   a port is gated off only when it is left out of board_cfg.h
+*/
+
 // this vlaue is used to check in the PLL user selection values (ex: PLL_M,PLL_N,...etc)
 // be carful when you put wrong values it may cause wrong system behavior
 // .MCU_HSI_ClockSource = (16000000UL)   // 16MHZ
@@ -51,6 +67,29 @@ const MCU_Config_t MCU_Configs = {
 //  .MCU_PLLP = 4
 //  .MCU_PLLQ = 7
 
+/*  PLL target frequency for the clock tree solver
+    *   0                 -> MCU_PLLM/N/P/Q are used as written
+    *   up to 84000000UL  -> MCU_PLLM/N/P/Q are computed automatically
+*/
+// ex >> .MCU_PLLTargetFrequency = 84000000UL
+
+/*  The available values for MCU_FlashVoltageRange are 
+    *   MCU_FLASH_VOLTAGE_2V7_TO_3V6
+    *   MCU_FLASH_VOLTAGE_2V4_TO_2V7
+    *   MCU_FLASH_VOLTAGE_2V1_TO_2V4
+    *   MCU_FLASH_VOLTAGE_1V8_TO_2V1      (prefetch not allowed)
+*/
+// ex >> .MCU_FlashVoltageRange = MCU_FLASH_VOLTAGE_2V7_TO_3V6
+
+/*  The available values for MCU_FlashAccelerator are 
+  --->> YOU CAN or more than value as this example
+    *   MCU_FLASH_NO_FEATURE
+    *   MCU_FLASH_PREFETCH_ENABLE
+    *   MCU_FLASH_ICACHE_ENABLE
+    *   MCU_FLASH_DCACHE_ENABLE
+*/
+// ex >> .MCU_FlashAccelerator = MCU_FLASH_PREFETCH_ENABLE | MCU_FLASH_ICACHE_ENABLE
+
 /*  The available values for MCU_AHP_Prescaler are 
     *   MCU_AHB_NO_DIVISION
     *   MCU_AHB_DIVIDED_BY_2
@@ -0,0 +1,480 @@
+#include "LIB/stdtypes.h"
+#include "MCAL/FLASH_Driver/flash.h"
+
+#include "HAL/NVM_Driver/nvm_cfg.h"
+#include "HAL/NVM_Driver/nvm.h"
+
+/*
+ * Sector layout
+ * +---------------------------+ sector start
+ * | state | magic | gen | --- |   header (4 words)
+ * +---------------------------+
+ * | record | record | ...     |   log, written upward
+ * | 0xFFFFFFFF ...            |   free space
+ * +---------------------------+ sector end
+ *
+ * The state word only loses bits : ERASED -> COPY -> ACTIVE -> OBSOLETE
+ */
+#define NVM_STATE_ERASED            (0xFFFFFFFFUL)  /* Blank sector */
+#define NVM_STATE_COPY              (0xFFFFA5A5UL)  /* Compaction target being filled */
+#define NVM_STATE_ACTIVE            (0x0000A5A5UL)  /* Sector holding the store */
+#define NVM_STATE_OBSOLETE          (0x00000000UL)  /* Source of a finished compaction */
+#define NVM_MAGIC                   (0x314D564EUL)  /* "NVM1" */
+#define NVM_HEADER_SIZE             (16UL)
+
+/*
+ * Record layout (words)
+ * [0]       key << 16 | length in bytes (0 = tombstone)
+ * [1 .. n]  value, padded with 0xFF to a word
+ * [n + 1]   crc16 << 16 | NVM_RECORD_COMMIT, programmed last
+ * A record without a valid commit word was cut by a reset and is skipped
+ */
+#define NVM_RECORD_COMMIT           (0x5AA5UL)
+#define NVM_DATA_WORDS(length)      (((uint32_t)(length) + 3UL) / 4UL)
+#define NVM_RECORD_WORDS(length)    (2UL + NVM_DATA_WORDS(length))
+#define NVM_RECORD_KEY(header)      ((uint16_t)((header) >> 16))
+#define NVM_RECORD_LENGTH(header)   ((uint16_t)((header) & 0xFFFFUL))
+
+#define NVM_WORD(address)           (*(volatile const uint32_t *)(address))
+
+/* TRUE once NVM_enuInit() found or formatted a store */
+static bool_t NvmInitialized = FALSE;
+
+/* Sector numbers and addresses, [0] = NVM_SECTOR_A, [1] = NVM_SECTOR_B */
+static const uint8_t NvmSectors[2] = {NVM_SECTOR_A, NVM_SECTOR_B};
+static uint32_t NvmStart[2] = {0};
+static uint32_t NvmEnd[2] = {0};
+
+/* Index in NvmSectors of the active sector */
+static uint8_t ActiveSector = 0;
+
+/* First free word of the active sector */
+static uint32_t WriteAddress = 0;
+
+/* Compactions since the last format */
+static uint32_t Generation = 0;
+
+/* Set when the scan met a damaged record : the rest of the sector is not usable */
+static bool_t CompactionNeeded = FALSE;
+
+/* RAM index : address of the latest record of each key, 0 = no value */
+static uint32_t Index[NVM_MAX_KEYS];
+
+static uint16_t localCrc16(const uint8_t *data, uint32_t length);
+static void localScan(void);
+static NVM_Status_t localFormat(void);
+static NVM_Status_t localStartSector(uint8_t sector, uint32_t generation);
+static NVM_Status_t localSetState(uint8_t sector, uint32_t state);
+static NVM_Status_t localCompact(void);
+static NVM_Status_t localAppend(uint16_t key, const uint8_t *data, uint16_t length);
+
+/*
+ * Function: NVM_enuInit
+ * Description: Picks the active sector and builds the RAM index
+ *
+ * Recovery after a reset:
+ * - one ACTIVE sector           : used, the other one is redone at the next compaction
+ * - two ACTIVE sectors          : reset between the two state changes of a compaction
+ *                                 (only possible if OBSOLETE failed), the newest wins
+ * - COPY and no ACTIVE          : compaction finished but not promoted, COPY becomes ACTIVE
+ * - anything else               : blank or foreign content, both sectors formatted
+ */
+NVM_Status_t NVM_enuInit(void){
+    NVM_Status_t retStatus = NVM_OK;
+    uint32_t size = 0;
+    uint32_t state[2];
+    bool_t valid[2];
+    uint8_t sector;
+
+    NvmInitialized = FALSE;
+
+    for(sector = 0; sector < 2; sector++){
+        if(FLASH_OK != FLASH_enuGetSectorInfo(NvmSectors[sector], &NvmStart[sector], &size)){
+            retStatus = NVM_FLASH_ERROR;
+            break;
+        }
+        NvmEnd[sector] = NvmStart[sector] + size;
+        state[sector] = NVM_WORD(NvmStart[sector]);
+        valid[sector] = (NVM_MAGIC == NVM_WORD(NvmStart[sector] + 4UL)) ? TRUE : FALSE;
+    }
+
+    if(NVM_OK != retStatus){
+        // Sector map unknown, nothing is read or written
+    }else if((TRUE == valid[0]) && (TRUE == valid[1]) &&
+       (NVM_STATE_ACTIVE == state[0]) && (NVM_STATE_ACTIVE == state[1])){
+        ActiveSector = (NVM_WORD(NvmStart[1] + 8UL) > NVM_WORD(NvmStart[0] + 8UL)) ? 1 : 0;
+        retStatus = localSetState(1 - ActiveSector, NVM_STATE_OBSOLETE);
+    }else if((TRUE == valid[0]) && (NVM_STATE_ACTIVE == state[0])){
+        ActiveSector = 0;
+    }else if((TRUE == valid[1]) && (NVM_STATE_ACTIVE == state[1])){
+        ActiveSector = 1;
+    }else if((TRUE == valid[0]) && (NVM_STATE_COPY == state[0])){
+        ActiveSector = 0;
+        retStatus = localSetState(0, NVM_STATE_ACTIVE);
+    }else if((TRUE == valid[1]) && (NVM_STATE_COPY == state[1])){
+        ActiveSector = 1;
+        retStatus = localSetState(1, NVM_STATE_ACTIVE);
+    }else{
+        retStatus = localFormat();
+    }
+
+    if(NVM_OK == retStatus){
+        Generation = NVM_WORD(NvmStart[ActiveSector] + 8UL);
+        localScan();
+        NvmInitialized = TRUE;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: NVM_enuRead
+ * Description: Copies the latest value of a key, the index gives its record directly
+ */
+NVM_Status_t NVM_enuRead(uint16_t key, void *buffer, uint16_t bufferSize, uint16_t *length){
+    NVM_Status_t retStatus = NVM_NOT_OK;
+    const volatile uint8_t *value;
+    uint8_t *destination = (uint8_t*)buffer;
+    uint16_t valueLength;
+    uint16_t index;
+
+    if((NULL == buffer) || (NULL == length)){
+        retStatus = NVM_NULL_PTR;
+    }else if(FALSE == NvmInitialized){
+        retStatus = NVM_NOT_INIT;
+    }else if(key >= NVM_MAX_KEYS){
+        retStatus = NVM_WRONG_KEY;
+    }else if(0 == Index[key]){
+        retStatus = NVM_KEY_NOT_FOUND;
+    }else{
+        valueLength = NVM_RECORD_LENGTH(NVM_WORD(Index[key]));
+        *length = valueLength;
+
+        if(valueLength > bufferSize){
+            retStatus = NVM_BUFFER_TOO_SMALL;
+        }else{
+            value = (const volatile uint8_t*)(Index[key] + 4UL);
+            for(index = 0; index < valueLength; index++){
+                destination[index] = value[index];
+            }
+            retStatus = NVM_OK;
+        }
+    }
+    return retStatus;
+}
+
+/*
+ * Function: NVM_enuWrite
+ * Description: Appends a record unless the same value is already stored
+ */
+NVM_Status_t NVM_enuWrite(uint16_t key, const void *data, uint16_t length){
+    NVM_Status_t retStatus = NVM_NOT_OK;
+    const volatile uint8_t *stored;
+    const uint8_t *value = (const uint8_t*)data;
+    bool_t same = FALSE;
+    uint16_t index;
+
+    if(NULL == data){
+        retStatus = NVM_NULL_PTR;
+    }else if(FALSE == NvmInitialized){
+        retStatus = NVM_NOT_INIT;
+    }else if(key >= NVM_MAX_KEYS){
+        retStatus = NVM_WRONG_KEY;
+    }else if((0 == length) || (length > NVM_MAX_VALUE_SIZE)){
+        retStatus = NVM_WRONG_SIZE;
+    }else{
+        /* Same value already stored : no flash write */
+        if((0 != Index[key]) && (length == NVM_RECORD_LENGTH(NVM_WORD(Index[key])))){
+            stored = (const volatile uint8_t*)(Index[key] + 4UL);
+            same = TRUE;
+            for(index = 0; (index < length) && (TRUE == same); index++){
+                if(stored[index] != value[index]){
+                    same = FALSE;
+                }
+            }
+        }
+
+        retStatus = (TRUE == same) ? NVM_OK : localAppend(key, value, length);
+    }
+    return retStatus;
+}
+
+/*
+ * Function: NVM_enuDelete
+ * Description: Appends a tombstone for the key
+ */
+NVM_Status_t NVM_enuDelete(uint16_t key){
+    NVM_Status_t retStatus = NVM_NOT_OK;
+
+    if(FALSE == NvmInitialized){
+        retStatus = NVM_NOT_INIT;
+    }else if(key >= NVM_MAX_KEYS){
+        retStatus = NVM_WRONG_KEY;
+    }else if(0 == Index[key]){
+        retStatus = NVM_KEY_NOT_FOUND;
+    }else{
+        retStatus = localAppend(key, NULL, 0);
+    }
+    return retStatus;
+}
+
+/*
+ * Function: NVM_enuGetStats
+ * Description: Generation, fill level and number of live keys
+ */
+NVM_Status_t NVM_enuGetStats(NVM_Stats_t *stats){
+    NVM_Status_t retStatus = NVM_NOT_OK;
+    uint16_t key;
+
+    if(NULL == stats){
+        retStatus = NVM_NULL_PTR;
+    }else if(FALSE == NvmInitialized){
+        retStatus = NVM_NOT_INIT;
+    }else{
+        stats->NVM_Generation = Generation;
+        stats->NVM_UsedBytes = WriteAddress - NvmStart[ActiveSector];
+        stats->NVM_FreeBytes = (TRUE == CompactionNeeded) ? 0 : (NvmEnd[ActiveSector] - WriteAddress);
+        stats->NVM_Keys = 0;
+        for(key = 0; key < NVM_MAX_KEYS; key++){
+            if(0 != Index[key]){
+                stats->NVM_Keys++;
+            }
+        }
+        retStatus = NVM_OK;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: NVM_enuFormat
+ * Description: Erases both sectors and starts an empty store in sector A
+ */
+NVM_Status_t NVM_enuFormat(void){
+    NVM_Status_t retStatus = NVM_NOT_OK;
+
+    if(0 == NvmEnd[0]){
+        /* Sector addresses not read yet */
+        retStatus = NVM_enuInit();
+    }
+
+    if(NVM_FLASH_ERROR != retStatus){
+        retStatus = localFormat();
+        if(NVM_OK == retStatus){
+            Generation = 0;
+            localScan();
+            NvmInitialized = TRUE;
+        }
+    }
+    return retStatus;
+}
+
+/*
+ * Function: localCrc16
+ * Description: CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) of a record
+ */
+static uint16_t localCrc16(const uint8_t *data, uint32_t length){
+    uint16_t crc = 0xFFFFU;
+    uint32_t index;
+    uint8_t bit;
+
+    for(index = 0; index < length; index++){
+        crc ^= (uint16_t)((uint16_t)data[index] << 8);
+        for(bit = 0; bit < 8; bit++){
+            crc = (crc & 0x8000U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/*
+ * Function: localScan
+ * Description: Walks the log of the active sector once
+ *              A committed record updates the index of its key (tombstone clears it)
+ *              A record without commit is skipped, its length is still valid
+ *              A header that cannot be a record stops the walk : the rest of the
+ *              sector is only reused after a compaction
+ */
+static void localScan(void){
+    uint32_t address = NvmStart[ActiveSector] + NVM_HEADER_SIZE;
+    uint32_t end = NvmEnd[ActiveSector];
+    uint32_t header;
+    uint32_t commit;
+    uint32_t words;
+    uint16_t key;
+    uint16_t length;
+
+    for(key = 0; key < NVM_MAX_KEYS; key++){
+        Index[key] = 0;
+    }
+    CompactionNeeded = FALSE;
+
+    while((address + 8UL) <= end){
+        header = NVM_WORD(address);
+        if(FLASH_ERASED_WORD == header){
+            break;
+        }
+
+        key = NVM_RECORD_KEY(header);
+        length = NVM_RECORD_LENGTH(header);
+        words = NVM_RECORD_WORDS(length);
+
+        if((key >= NVM_MAX_KEYS) || (length > NVM_MAX_VALUE_SIZE) || ((address + (words * 4UL)) > end)){
+            CompactionNeeded = TRUE;
+            break;
+        }
+
+        commit = NVM_WORD(address + ((words - 1UL) * 4UL));
+        if(commit == (((uint32_t)localCrc16((const uint8_t*)address, (words - 1UL) * 4UL) << 16) | NVM_RECORD_COMMIT)){
+            Index[key] = (0 == length) ? 0 : address;
+        }
+
+        address += words * 4UL;
+    }
+
+    WriteAddress = address;
+}
+
+/*
+ * Function: localFormat
+ * Description: Erases sector B if needed and starts an empty ACTIVE store in sector A
+ */
+static NVM_Status_t localFormat(void){
+    NVM_Status_t retStatus = NVM_FLASH_ERROR;
+
+    if((NVM_STATE_ERASED == NVM_WORD(NvmStart[1])) || (FLASH_OK == FLASH_enuEraseSector(NvmSectors[1]))){
+        retStatus = localStartSector(0, 0);
+        if(NVM_OK == retStatus){
+            retStatus = localSetState(0, NVM_STATE_ACTIVE);
+            ActiveSector = 0;
+        }
+    }
+    return retStatus;
+}
+
+/*
+ * Function: localStartSector
+ * Description: Blank check (erase if needed), then header with state COPY
+ */
+static NVM_Status_t localStartSector(uint8_t sector, uint32_t generation){
+    NVM_Status_t retStatus = NVM_OK;
+    uint32_t header[3] = {NVM_STATE_COPY, NVM_MAGIC, generation};
+    uint32_t address;
+
+    for(address = NvmStart[sector]; address < NvmEnd[sector]; address += 4UL){
+        if(FLASH_ERASED_WORD != NVM_WORD(address)){
+            if(FLASH_OK != FLASH_enuEraseSector(NvmSectors[sector])){
+                retStatus = NVM_FLASH_ERROR;
+            }
+            break;
+        }
+    }
+
+    if((NVM_OK == retStatus) && (FLASH_OK != FLASH_enuProgram(NvmStart[sector], header, 3))){
+        retStatus = NVM_FLASH_ERROR;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: localSetState
+ * Description: Programs the state word again (only clears bits)
+ */
+static NVM_Status_t localSetState(uint8_t sector, uint32_t state){
+    return (FLASH_OK == FLASH_enuProgram(NvmStart[sector], &state, 1)) ? NVM_OK : NVM_FLASH_ERROR;
+}
+
+/*
+ * Function: localCompact
+ * Description: Copies the live records to the other sector
+ *
+ * Sequence (a reset at any step keeps a complete store, see NVM_enuInit):
+ * 1. Other sector blank checked / erased, header COPY with generation + 1
+ * 2. Latest record of every key copied (stale records and tombstones dropped)
+ * 3. Old sector marked OBSOLETE
+ * 4. New sector marked ACTIVE
+ * The two sectors take turns, so both see the same number of erases
+ */
+static NVM_Status_t localCompact(void){
+    NVM_Status_t retStatus = NVM_OK;
+    uint8_t target = 1 - ActiveSector;
+    uint32_t record[NVM_RECORD_WORDS(NVM_MAX_VALUE_SIZE)];
+    uint32_t newIndex[NVM_MAX_KEYS];
+    uint32_t address;
+    uint32_t words;
+    uint32_t word;
+    uint16_t key;
+
+    retStatus = localStartSector(target, Generation + 1UL);
+    address = NvmStart[target] + NVM_HEADER_SIZE;
+
+    for(key = 0; (key < NVM_MAX_KEYS) && (NVM_OK == retStatus); key++){
+        newIndex[key] = 0;
+        if(0 != Index[key]){
+            words = NVM_RECORD_WORDS(NVM_RECORD_LENGTH(NVM_WORD(Index[key])));
+            for(word = 0; word < words; word++){
+                record[word] = NVM_WORD(Index[key] + (word * 4UL));
+            }
+            if(FLASH_OK != FLASH_enuProgram(address, record, words)){
+                retStatus = NVM_FLASH_ERROR;
+            }else{
+                newIndex[key] = address;
+                address += words * 4UL;
+            }
+        }
+    }
+
+    if(NVM_OK == retStatus){
+        retStatus = localSetState(ActiveSector, NVM_STATE_OBSOLETE);
+    }
+    if(NVM_OK == retStatus){
+        retStatus = localSetState(target, NVM_STATE_ACTIVE);
+    }
+
+    if(NVM_OK == retStatus){
+        for(key = 0; key < NVM_MAX_KEYS; key++){
+            Index[key] = newIndex[key];
+        }
+        ActiveSector = target;
+        WriteAddress = address;
+        Generation++;
+        CompactionNeeded = FALSE;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: localAppend
+ * Description: Builds the record in RAM and programs it in one pass, commit word last
+ *              Compacts first when the record does not fit
+ */
+static NVM_Status_t localAppend(uint16_t key, const uint8_t *data, uint16_t length){
+    NVM_Status_t retStatus = NVM_OK;
+    uint32_t record[NVM_RECORD_WORDS(NVM_MAX_VALUE_SIZE)];
+    uint32_t words = NVM_RECORD_WORDS(length);
+    uint8_t *bytes = (uint8_t*)&record[1];
+    uint16_t index;
+
+    if((TRUE == CompactionNeeded) || ((WriteAddress + (words * 4UL)) > NvmEnd[ActiveSector])){
+        retStatus = localCompact();
+        if((NVM_OK == retStatus) && ((WriteAddress + (words * 4UL)) > NvmEnd[ActiveSector])){
+            retStatus = NVM_FULL;
+        }
+    }
+
+    if(NVM_OK == retStatus){
+        record[0] = ((uint32_t)key << 16) | length;
+        for(index = 0; index < (NVM_DATA_WORDS(length) * 4UL); index++){
+            bytes[index] = (index < length) ? data[index] : 0xFFU;
+        }
+        record[words - 1UL] = ((uint32_t)localCrc16((const uint8_t*)record, (words - 1UL) * 4UL) << 16) | NVM_RECORD_COMMIT;
+
+        if(FLASH_OK != FLASH_enuProgram(WriteAddress, record, words)){
+            /* Partly written record : skipped by the next scan, never written over */
+            CompactionNeeded = TRUE;
+            retStatus = NVM_FLASH_ERROR;
+        }else{
+            Index[key] = (0 == length) ? 0 : WriteAddress;
+            WriteAddress += words * 4UL;
+        }
+    }
+    return retStatus;
+}
@@ -0,0 +1,697 @@
+#include "LIB/stdtypes.h"
+#include "MCAL/GPIO_Driver/gpio_int.h"
+#include "MCAL/SPI_Driver/spi.h"
+#include "MCAL/DMA_Driver/dma.h"
+#include "MCAL/NVIC_Driver/nvic_stm32f401cc.h"
+
+#include "HAL/SD_Driver/sd_cfg.h"
+#include "HAL/SD_Driver/sd.h"
+
+/* Commands used in SPI mode (ACMDs follow a CMD55) */
+#define SD_CMD0                     (0U)    /* GO_IDLE_STATE */
+#define SD_CMD8                     (8U)    /* SEND_IF_COND */
+#define SD_CMD16                    (16U)   /* SET_BLOCKLEN */
+#define SD_CMD17                    (17U)   /* READ_SINGLE_BLOCK */
+#define SD_CMD24                    (24U)   /* WRITE_BLOCK */
+#define SD_CMD25                    (25U)   /* WRITE_MULTIPLE_BLOCK */
+#define SD_CMD55                    (55U)   /* APP_CMD */
+#define SD_CMD58                    (58U)   /* READ_OCR */
+#define SD_ACMD23                   (23U)   /* SET_WR_BLK_ERASE_COUNT */
+#define SD_ACMD41                   (41U)   /* SD_SEND_OP_COND */
+
+/* Arguments */
+#define SD_CMD8_PATTERN             (0x000001AAUL)  /* 2.7 - 3.6 V, check pattern 0xAA */
+#define SD_ACMD41_HCS               (0x40000000UL)  /* Host supports high capacity */
+#define SD_ACMD23_MAX               (0x007FFFFFUL)
+#define SD_OCR_CCS                  (0x40U)         /* Card capacity status, first OCR byte */
+
+/* Only CMD0 and CMD8 are checked in SPI mode, the other commands take any CRC */
+#define SD_CMD0_CRC                 (0x95U)
+#define SD_CMD8_CRC                 (0x87U)
+#define SD_DUMMY_CRC                (0x01U)
+
+/* R1 */
+#define SD_R1_READY                 (0x00U)
+#define SD_R1_IDLE                  (0x01U)
+#define SD_R1_ILLEGAL_COMMAND       (0x04U)
+#define SD_R1_NO_RESPONSE           (0xFFU)
+
+/* Data tokens */
+#define SD_TOKEN_START_BLOCK        (0xFEU) /* CMD17, CMD24 */
+#define SD_TOKEN_START_MULTIPLE     (0xFCU) /* CMD25 */
+#define SD_TOKEN_STOP_MULTIPLE      (0xFDU) /* CMD25 */
+#define SD_DATA_RESPONSE_MASK       (0x1FU)
+#define SD_DATA_ACCEPTED            (0x05U)
+
+#define SD_IDLE_BYTE                (0xFFU)
+#define SD_POWER_UP_BYTES           (10U)   /* >= 74 clocks with CS high */
+#define SD_NCR_BYTES                (8U)    /* Command to response delay */
+#define SD_CMD0_RETRIES             (10U)
+
+/* Loop turns waiting for a DMA interrupt in the blocking calls (a block is ~0.2 ms) */
+#define SD_DMA_TIMEOUT              (1000000UL)
+
+typedef enum {
+    SD_STREAM_CLOSED = 0,           /* No multi-block write, CS high */
+    SD_STREAM_READY,                /* CMD25 accepted, the card waits for a block */
+    SD_STREAM_DMA,                  /* Block data going out by DMA */
+    SD_STREAM_PROGRAMMING,          /* Block accepted, card busy */
+    SD_STREAM_STOPPING,             /* Stop token sent, card busy */
+}SD_StreamState_t;
+
+/* TRUE once SD_enuInit() identified the card */
+static bool_t SdInitialized = FALSE;
+static SD_CardType_t SdCardType = SD_CARD_NONE;
+
+/* Moved from SD_STREAM_DMA by the transmit interrupt */
+static volatile SD_StreamState_t SdStreamState = SD_STREAM_CLOSED;
+
+/* Block rejected by the card, reported once by SD_enuStreamPoll */
+static volatile bool_t SdStreamRejected = FALSE;
+
+/* Set by the DMA transfer complete interrupts (single block calls) */
+static volatile bool_t SdTxDone = FALSE;
+static volatile bool_t SdRxDone = FALSE;
+
+/* Address of the SPI data register for the two DMA streams */
+static uint32_t SdDataRegister = 0;
+
+/* Mode 0, 8 bits, MSB first, chip select driven here */
+static SPI_Config_t SdSpiConfig = {
+    .spiNumber          = SD_SPI_NUMBER,
+    .communicationMode  = SPI_FULL_DUPLEX,
+    .mode               = SPI_MASTER,
+    .crcState           = SPI_CRC_DISABLED,
+    .dataLength         = SPI_8_BIT_DATA,
+    .dataOrder          = SPI_MSB_FIRST,
+    .baudRate           = SPI_BAUDRATE_DIV256,
+    .polarityPhase      = SPI_ZERO_IDLE_FIRST_EDGE,
+    .frameFormat        = SPI_MOTOROLA,
+    .dmaState           = SPI_DMA_TX_RX_ENABLE,
+    .nssManagement      = SPI_NSS_MASTER_SW,
+    .crcPolynomial      = 7,
+    .slavesConfig       = {
+        .slaves         = {{(SPI_Port_t)SD_CS_PORT, (SPI_Pin_t)SD_CS_PIN}},
+        .numberOfSlaves = 1
+    }
+};
+
+/* One byte each way on the bus */
+static uint8_t localExchange(uint8_t data);
+
+/* CS low / CS high followed by one byte so the card releases MISO */
+static void localSelect(void);
+static void localDeselect(void);
+
+/* Clocks bytes until the card stops holding MISO low, FALSE after SD_WAIT_BYTES */
+static bool_t localWaitReady(void);
+
+/* Sends a command frame and returns R1 (SD_R1_NO_RESPONSE on timeout) */
+static uint8_t localCommand(uint8_t index, uint32_t argument);
+static uint8_t localAppCommand(uint8_t index, uint32_t argument);
+
+/* R1 of a command expected to return SD_R1_READY */
+static SD_Status_t localCheckR1(uint8_t r1);
+
+/* Re-initializes the SPI with the largest SCK not above sckHz */
+static SD_Status_t localSetSpeed(uint32_t sckHz);
+
+/* Both streams in normal byte mode, addresses and lengths set per block */
+static SD_Status_t localSetupDma(void);
+
+/* Drops the byte left in DR by a transmit-only DMA and clears OVR */
+static void localFlushRx(void);
+
+/* Starts the transmit-only DMA of one block */
+static void localStartTxDma(const uint8_t *buffer);
+
+/* CRC and data response of a block, stop token if the card rejected it */
+static void localEndStreamBlock(void);
+
+/* TRUE once the last byte of the transmit DMA left the shift register */
+static bool_t localTxFinished(void);
+
+/* Card sector address of a block number */
+static uint32_t localAddress(uint32_t block);
+
+static void localTxComplete(void);
+static void localRxComplete(void);
+
+/*
+ * Function: SD_enuInit
+ * Description: Identifies the card and prepares the DMA streams
+ *
+ * Implementation notes:
+ * - CMD8 separates version 1 cards (illegal command) from version 2 ones,
+ *   CMD58 after ACMD41 gives the addressing mode (CCS) of a version 2 card
+ * - Byte addressed cards get CMD16 so every card uses 512-byte blocks
+ * - The SPI is re-initialized for the data speed : SPI_enuInit only ORs bits
+ */
+SD_Status_t SD_enuInit(void){
+    SD_Status_t retStatus = SD_NOT_OK;
+    SD_CardType_t type = SD_CARD_NONE;
+    uint8_t r1 = SD_R1_NO_RESPONSE;
+    uint8_t response[4] = {0};
+    uint32_t i;
+
+    SdInitialized = FALSE;
+    SdCardType = SD_CARD_NONE;
+    SdStreamState = SD_STREAM_CLOSED;
+
+    retStatus = localSetSpeed(SD_INIT_SCK_HZ);
+    if(retStatus == SD_OK){
+        // Power-up clocks with CS high, then CMD0 with CS low enters SPI mode
+        (void)GPIO_enuSetPinVal(SD_CS_PORT, SD_CS_PIN, GPIO_HIGH);
+        for(i = 0; i < SD_POWER_UP_BYTES; i++){
+            (void)localExchange(SD_IDLE_BYTE);
+        }
+
+        localSelect();
+        for(i = 0; (i < SD_CMD0_RETRIES) && (r1 != SD_R1_IDLE); i++){
+            r1 = localCommand(SD_CMD0, 0);
+        }
+        if(r1 != SD_R1_IDLE){
+            retStatus = SD_NO_CARD;
+        }
+    }
+
+    if(retStatus == SD_OK){
+        r1 = localCommand(SD_CMD8, SD_CMD8_PATTERN);
+        if(r1 == SD_R1_IDLE){
+            for(i = 0; i < 4U; i++){
+                response[i] = localExchange(SD_IDLE_BYTE);
+            }
+            if(((response[2] & 0x0FU) != 0x01U) || (response[3] != (uint8_t)SD_CMD8_PATTERN)){
+                retStatus = SD_UNSUPPORTED_CARD;
+            }else{
+                type = SD_CARD_V2_SC;
+            }
+        }else if((r1 != SD_R1_NO_RESPONSE) && ((r1 & SD_R1_ILLEGAL_COMMAND) != 0)){
+            type = SD_CARD_V1;
+        }else{
+            retStatus = SD_COMMAND_ERROR;
+        }
+    }
+
+    if(retStatus == SD_OK){
+        uint32_t argument = (type == SD_CARD_V1) ? 0UL : SD_ACMD41_HCS;
+        r1 = SD_R1_IDLE;
+        for(i = 0; (i < SD_INIT_RETRIES) && (r1 == SD_R1_IDLE); i++){
+            r1 = localAppCommand(SD_ACMD41, argument);
+        }
+        if(r1 == SD_R1_IDLE){
+            retStatus = SD_TIMEOUT;
+        }else{
+            retStatus = localCheckR1(r1);
+        }
+    }
+
+    if((retStatus == SD_OK) && (type == SD_CARD_V2_SC)){
+        retStatus = localCheckR1(localCommand(SD_CMD58, 0));
+        if(retStatus == SD_OK){
+            for(i = 0; i < 4U; i++){
+                response[i] = localExchange(SD_IDLE_BYTE);
+            }
+            if((response[0] & SD_OCR_CCS) != 0){
+                type = SD_CARD_V2_HC;
+            }
+        }
+    }
+
+    if((retStatus == SD_OK) && (type != SD_CARD_V2_HC)){
+        retStatus = localCheckR1(localCommand(SD_CMD16, SD_BLOCK_SIZE));
+    }
+
+    localDeselect();
+
+    if(retStatus == SD_OK){
+        retStatus = localSetSpeed(SD_DATA_SCK_HZ);
+    }
+    if(retStatus == SD_OK){
+        retStatus = localSetupDma();
+    }
+    if(retStatus == SD_OK){
+        SdCardType = type;
+        SdInitialized = TRUE;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: SD_enuGetCardType
+ * Description: Returns the card version found by SD_enuInit
+ */
+SD_Status_t SD_enuGetCardType(SD_CardType_t *type){
+    SD_Status_t retStatus = SD_NOT_OK;
+
+    if(NULL == type){
+        retStatus = SD_NULL_PTR;
+    }else{
+        *type = SdCardType;
+        retStatus = (SdInitialized == TRUE) ? SD_OK : SD_NOT_INIT;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: SD_enuReadBlock
+ * Description: Reads one block, the data phase by DMA
+ *
+ * Implementation notes:
+ * - The buffer is filled with 0xFF and is both the transmit source and the
+ *   receive destination : the transmit stream reads byte n before the receive
+ *   stream writes it, so no 512-byte dummy buffer is needed
+ */
+SD_Status_t SD_enuReadBlock(uint32_t block, uint8_t *buffer){
+    SD_Status_t retStatus = SD_NOT_OK;
+    uint8_t token = SD_IDLE_BYTE;
+    uint32_t i;
+
+    if(NULL == buffer){
+        retStatus = SD_NULL_PTR;
+    }else if(SdInitialized == FALSE){
+        retStatus = SD_NOT_INIT;
+    }else if(SdStreamState != SD_STREAM_CLOSED){
+        retStatus = SD_WRONG_STATE;
+    }else{
+        localSelect();
+        retStatus = localCheckR1(localCommand(SD_CMD17, localAddress(block)));
+
+        if(retStatus == SD_OK){
+            for(i = 0; (i < SD_WAIT_BYTES) && (token == SD_IDLE_BYTE); i++){
+                token = localExchange(SD_IDLE_BYTE);
+            }
+            if(token == SD_IDLE_BYTE){
+                retStatus = SD_TIMEOUT;
+            }else if(token != SD_TOKEN_START_BLOCK){
+                retStatus = SD_DATA_ERROR;  // Error token
+            }else{
+                // Continue below
+            }
+        }
+
+        if(retStatus == SD_OK){
+            for(i = 0; i < SD_BLOCK_SIZE; i++){
+                buffer[i] = SD_IDLE_BYTE;
+            }
+            localFlushRx();
+            SdRxDone = FALSE;
+            (void)DMA_enuClearFlag(DMA2, SD_DMA_RX_STREAM, DMA_INTERRUPT_TRANSMISSION_COMPLETE);
+            (void)DMA_enuSetMemoryAddress(DMA2, SD_DMA_RX_STREAM, (uint32_t)buffer);
+            (void)DMA_enuSetNumberOfData(DMA2, SD_DMA_RX_STREAM, (uint16_t)SD_BLOCK_SIZE);
+            (void)DMA_enuStartTransfer(DMA2, SD_DMA_RX_STREAM);
+            localStartTxDma(buffer);
+
+            for(i = 0; (i < SD_DMA_TIMEOUT) && (SdRxDone == FALSE); i++);
+            if(SdRxDone == FALSE){
+                (void)DMA_enuStopTransfer(DMA2, SD_DMA_TX_STREAM);
+                (void)DMA_enuStopTransfer(DMA2, SD_DMA_RX_STREAM);
+                retStatus = SD_TIMEOUT;
+            }else{
+                // CRC, not checked
+                (void)localExchange(SD_IDLE_BYTE);
+                (void)localExchange(SD_IDLE_BYTE);
+            }
+        }
+        localDeselect();
+    }
+    return retStatus;
+}
+
+/*
+ * Function: SD_enuWriteBlock
+ * Description: Writes one block and waits for the end of programming
+ */
+SD_Status_t SD_enuWriteBlock(uint32_t block, const uint8_t *buffer){
+    SD_Status_t retStatus = SD_NOT_OK;
+    uint32_t i;
+
+    if(NULL == buffer){
+        retStatus = SD_NULL_PTR;
+    }else if(SdInitialized == FALSE){
+        retStatus = SD_NOT_INIT;
+    }else if(SdStreamState != SD_STREAM_CLOSED){
+        retStatus = SD_WRONG_STATE;
+    }else{
+        localSelect();
+        retStatus = localCheckR1(localCommand(SD_CMD24, localAddress(block)));
+
+        if(retStatus == SD_OK){
+            (void)localExchange(SD_IDLE_BYTE);
+            (void)localExchange(SD_TOKEN_START_BLOCK);
+            localStartTxDma(buffer);
+
+            for(i = 0; (i < SD_DMA_TIMEOUT) && (localTxFinished() == FALSE); i++);
+            if(localTxFinished() == FALSE){
+                (void)DMA_enuStopTransfer(DMA2, SD_DMA_TX_STREAM);
+                retStatus = SD_TIMEOUT;
+            }
+        }
+
+        if(retStatus == SD_OK){
+            localFlushRx();
+            (void)localExchange(SD_IDLE_BYTE);
+            (void)localExchange(SD_IDLE_BYTE);
+            if((localExchange(SD_IDLE_BYTE) & SD_DATA_RESPONSE_MASK) != SD_DATA_ACCEPTED){
+                retStatus = SD_DATA_ERROR;
+            }else if(localWaitReady() == FALSE){
+                retStatus = SD_TIMEOUT;
+            }else{
+                // Programmed
+            }
+        }
+        localDeselect();
+    }
+    return retStatus;
+}
+
+/*
+ * Function: SD_enuStreamOpen
+ * Description: ACMD23 then CMD25, the card waits for the first block
+ * Note: ACMD23 does not exist on version 1 cards, they get CMD25 alone
+ */
+SD_Status_t SD_enuStreamOpen(uint32_t firstBlock, uint32_t eraseCount){
+    SD_Status_t retStatus = SD_NOT_OK;
+
+    if(SdInitialized == FALSE){
+        retStatus = SD_NOT_INIT;
+    }else if(SdStreamState != SD_STREAM_CLOSED){
+        retStatus = SD_WRONG_STATE;
+    }else{
+        localSelect();
+        retStatus = SD_OK;
+
+        if((SdCardType != SD_CARD_V1) && (eraseCount != 0)){
+            if(eraseCount > SD_ACMD23_MAX){
+                eraseCount = SD_ACMD23_MAX;
+            }
+            retStatus = localCheckR1(localAppCommand(SD_ACMD23, eraseCount));
+        }
+        if(retStatus == SD_OK){
+            retStatus = localCheckR1(localCommand(SD_CMD25, localAddress(firstBlock)));
+        }
+
+        if(retStatus == SD_OK){
+            // One byte between the response and the first start token
+            (void)localExchange(SD_IDLE_BYTE);
+            SdStreamState = SD_STREAM_READY;
+        }else{
+            localDeselect();
+        }
+    }
+    return retStatus;
+}
+
+/*
+ * Function: SD_enuStreamWrite
+ * Description: Start token then the block by DMA, the transmit interrupt and
+ *              SD_enuStreamPoll do the rest
+ */
+SD_Status_t SD_enuStreamWrite(const uint8_t *buffer){
+    SD_Status_t retStatus = SD_NOT_OK;
+
+    if(NULL == buffer){
+        retStatus = SD_NULL_PTR;
+    }else if(SdStreamState == SD_STREAM_READY){
+        (void)localExchange(SD_TOKEN_START_MULTIPLE);
+        SdStreamState = SD_STREAM_DMA;
+        localStartTxDma(buffer);
+        retStatus = SD_OK;
+    }else if((SdStreamState == SD_STREAM_DMA) || (SdStreamState == SD_STREAM_PROGRAMMING)){
+        retStatus = SD_BUSY;
+    }else{
+        retStatus = SD_WRONG_STATE;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: SD_enuStreamPoll
+ * Description: Advances the block in progress
+ *
+ * Implementation notes:
+ * - The CRC and the data response are exchanged by the transmit interrupt
+ *   (3 bytes, ~2 us) : the block reaches SD_STREAM_PROGRAMMING without a poll
+ * - A rejected block ends the stream with a stop token : the caller opens a
+ *   new stream at the same block to retry
+ * - The card holds MISO low while it programs, one byte per call is enough
+ *   to see the end and keeps the call short
+ */
+SD_Status_t SD_enuStreamPoll(void){
+    SD_Status_t retStatus = SD_BUSY;
+
+    if(SdInitialized == FALSE){
+        retStatus = SD_NOT_INIT;
+    }else if(SdStreamRejected == TRUE){
+        SdStreamRejected = FALSE;
+        retStatus = SD_DATA_ERROR;
+    }else{
+        switch(SdStreamState){
+            case SD_STREAM_DMA:
+                // Transmit interrupt not there yet
+                break;
+            case SD_STREAM_PROGRAMMING:
+                if(localExchange(SD_IDLE_BYTE) == SD_IDLE_BYTE){
+                    SdStreamState = SD_STREAM_READY;
+                    retStatus = SD_OK;
+                }
+                break;
+            case SD_STREAM_STOPPING:
+                if(localExchange(SD_IDLE_BYTE) == SD_IDLE_BYTE){
+                    localDeselect();
+                    SdStreamState = SD_STREAM_CLOSED;
+                    retStatus = SD_OK;
+                }
+                break;
+            default:
+                // SD_STREAM_READY, SD_STREAM_CLOSED
+                retStatus = SD_OK;
+                break;
+        }
+    }
+    return retStatus;
+}
+
+/*
+ * Function: SD_enuStreamClose
+ * Description: Stop token, the byte after it comes before the card busy signal
+ */
+SD_Status_t SD_enuStreamClose(void){
+    SD_Status_t retStatus = SD_NOT_OK;
+
+    if(SdStreamState == SD_STREAM_READY){
+        (void)localExchange(SD_TOKEN_STOP_MULTIPLE);
+        (void)localExchange(SD_IDLE_BYTE);
+        SdStreamState = SD_STREAM_STOPPING;
+        retStatus = SD_OK;
+    }else if((SdStreamState == SD_STREAM_DMA) || (SdStreamState == SD_STREAM_PROGRAMMING)){
+        retStatus = SD_BUSY;
+    }else{
+        retStatus = SD_WRONG_STATE;
+    }
+    return retStatus;
+}
+
+static uint8_t localExchange(uint8_t data){
+    uint16_t received = 0;
+    (void)SPI_enuMasterSyncTransmitReceive(SD_SPI_NUMBER, data, &received);
+    return (uint8_t)received;
+}
+
+static void localSelect(void){
+    (void)GPIO_enuSetPinVal(SD_CS_PORT, SD_CS_PIN, GPIO_LOW);
+}
+
+static void localDeselect(void){
+    (void)GPIO_enuSetPinVal(SD_CS_PORT, SD_CS_PIN, GPIO_HIGH);
+    (void)localExchange(SD_IDLE_BYTE);
+}
+
+static bool_t localWaitReady(void){
+    uint32_t i;
+    uint8_t data = 0;
+
+    for(i = 0; (i < SD_WAIT_BYTES) && (data != SD_IDLE_BYTE); i++){
+        data = localExchange(SD_IDLE_BYTE);
+    }
+    return (data == SD_IDLE_BYTE) ? TRUE : FALSE;
+}
+
+static uint8_t localCommand(uint8_t index, uint32_t argument){
+    uint8_t r1 = SD_R1_NO_RESPONSE;
+    uint8_t crc = SD_DUMMY_CRC;
+    uint32_t i;
+
+    if(index == SD_CMD0){
+        crc = SD_CMD0_CRC;
+    }else if(index == SD_CMD8){
+        crc = SD_CMD8_CRC;
+    }else{
+        // Any CRC
+    }
+
+    if(localWaitReady() == TRUE){
+        (void)localExchange((uint8_t)(0x40U | index));
+        (void)localExchange((uint8_t)(argument >> 24));
+        (void)localExchange((uint8_t)(argument >> 16));
+        (void)localExchange((uint8_t)(argument >> 8));
+        (void)localExchange((uint8_t)argument);
+        (void)localExchange(crc);
+
+        // R1 starts with a 0 bit
+        for(i = 0; (i < SD_NCR_BYTES) && ((r1 & 0x80U) != 0); i++){
+            r1 = localExchange(SD_IDLE_BYTE);
+        }
+    }
+    return r1;
+}
+
+static uint8_t localAppCommand(uint8_t index, uint32_t argument){
+    uint8_t r1 = localCommand(SD_CMD55, 0);
+
+    if(r1 <= SD_R1_IDLE){
+        r1 = localCommand(index, argument);
+    }
+    return r1;
+}
+
+static SD_Status_t localCheckR1(uint8_t r1){
+    SD_Status_t retStatus = SD_COMMAND_ERROR;
+
+    if(r1 == SD_R1_READY){
+        retStatus = SD_OK;
+    }else if(r1 == SD_R1_NO_RESPONSE){
+        retStatus = SD_TIMEOUT;
+    }else{
+        // Error bits
+    }
+    return retStatus;
+}
+
+static SD_Status_t localSetSpeed(uint32_t sckHz){
+    SD_Status_t retStatus = SD_SPI_ERROR;
+    SPI_BaudRate_t baudRate = SPI_BAUDRATE_DIV256;
+
+    // Not initialized yet at the first call
+    (void)SPI_enuDeInit(SD_SPI_NUMBER);
+
+    if(SPI_enuCalculateBaudRate(SD_SPI_NUMBER, sckHz, &baudRate) == SPI_OK){
+        SdSpiConfig.baudRate = baudRate;
+        if(SPI_enuInit(&SdSpiConfig) == SPI_OK){
+            retStatus = SD_OK;
+        }
+    }
+    return retStatus;
+}
+
+static SD_Status_t localSetupDma(void){
+    SD_Status_t retStatus = SD_DMA_ERROR;
+    DMA_Config_t dmaConfig;
+    DMA_Status_t txStatus;
+    DMA_Status_t rxStatus;
+
+    if(SPI_enuGetDataRegisterAddress(SD_SPI_NUMBER, &SdDataRegister) != SPI_OK){
+        retStatus = SD_SPI_ERROR;
+    }else{
+        dmaConfig.DMAx               = DMA2;
+        dmaConfig.Channel            = DMA_CHANNEL3;
+        dmaConfig.MBurst             = DMA_MBurst_SINGLE;
+        dmaConfig.PBurst             = DMA_PBurst_SINGLE;
+        dmaConfig.DoubleBuffer       = DMA_DISABLE_DOUBLE_BUFFER;
+        dmaConfig.Priority           = DMA_PRIORITY_HIGH;
+        dmaConfig.MSize              = DMA_MSIZE_BYTE;
+        dmaConfig.PSize              = DMA_PSIZE_BYTE;
+        dmaConfig.MemoryInc          = DMA_MINC_AUTO_INCREMENT;
+        dmaConfig.PeripheralInc      = DMA_PINC_FIXED;
+        dmaConfig.PeripheralFlowCtrl = DMA_FLOW_CONTROL_USING_DMA;
+        dmaConfig.Mode               = DMA_MODE_DIRECT;
+        dmaConfig.FifoThreshold      = DMA_FIFO_THRESHOLD_FULL; // Not important at direct mode
+        dmaConfig.PeripheralAddress  = SdDataRegister;
+        dmaConfig.Memory1Address     = 0; // Not used in normal mode
+        dmaConfig.CircularMode       = DMA_CIRCULAR_MODE_DISABLE;
+        dmaConfig.Interrupts         = DMA_INTERRUPT_TRANSFER_COMPLETE_ENABLE;
+        dmaConfig.NumberOfData       = (uint16_t)SD_BLOCK_SIZE;
+
+        // Memory address set per block
+        dmaConfig.Memory0Address     = 0;
+
+        dmaConfig.Streamx            = SD_DMA_TX_STREAM;
+        dmaConfig.Direction          = DMA_DIRECTION_M2P;
+        txStatus = DMA_enuDeInit(DMA2, SD_DMA_TX_STREAM);
+        if((txStatus == DMA_OK) || (txStatus == DMA_STREAM_NOT_INIT)){
+            txStatus = DMA_enuInit(&dmaConfig);
+        }
+
+        dmaConfig.Streamx            = SD_DMA_RX_STREAM;
+        dmaConfig.Direction          = DMA_DIRECTION_P2M;
+        rxStatus = DMA_enuDeInit(DMA2, SD_DMA_RX_STREAM);
+        if((rxStatus == DMA_OK) || (rxStatus == DMA_STREAM_NOT_INIT)){
+            rxStatus = DMA_enuInit(&dmaConfig);
+        }
+
+        if((txStatus == DMA_OK) && (rxStatus == DMA_OK)){
+            (void)DMA_enuRegisterCallback(DMA2, SD_DMA_TX_STREAM, DMA_INTERRUPT_TRANSMISSION_COMPLETE, localTxComplete);
+            (void)DMA_enuRegisterCallback(DMA2, SD_DMA_RX_STREAM, DMA_INTERRUPT_TRANSMISSION_COMPLETE, localRxComplete);
+            (void)NVIC_BP_SetPriority(SD_DMA_TX_IRQ, SD_INTERRUPT_PRIORITY);
+            (void)NVIC_BP_SetPriority(SD_DMA_RX_IRQ, SD_INTERRUPT_PRIORITY);
+            (void)NVIC_BP_EnableIRQ(SD_DMA_TX_IRQ);
+            (void)NVIC_BP_EnableIRQ(SD_DMA_RX_IRQ);
+            retStatus = SD_OK;
+        }
+    }
+    return retStatus;
+}
+
+static void localFlushRx(void){
+    // DR then SR : clears RXNE and OVR
+    (void)*(volatile uint32_t *)SdDataRegister;
+    (void)SPI_u8ReadFlag(SD_SPI_NUMBER, SPI_FLAG_OVERRUN_ERROR);
+}
+
+static void localStartTxDma(const uint8_t *buffer){
+    SdTxDone = FALSE;
+    (void)DMA_enuClearFlag(DMA2, SD_DMA_TX_STREAM, DMA_INTERRUPT_TRANSMISSION_COMPLETE);
+    (void)DMA_enuSetMemoryAddress(DMA2, SD_DMA_TX_STREAM, (uint32_t)buffer);
+    (void)DMA_enuSetNumberOfData(DMA2, SD_DMA_TX_STREAM, (uint16_t)SD_BLOCK_SIZE);
+    (void)DMA_enuStartTransfer(DMA2, SD_DMA_TX_STREAM);
+}
+
+static void localEndStreamBlock(void){
+    uint32_t i;
+
+    // Last byte still in the shift register : ~2 bytes at most
+    for(i = 0; (i < SD_DMA_TIMEOUT) && (localTxFinished() == FALSE); i++);
+
+    localFlushRx();
+    (void)localExchange(SD_IDLE_BYTE);
+    (void)localExchange(SD_IDLE_BYTE);
+    if((localExchange(SD_IDLE_BYTE) & SD_DATA_RESPONSE_MASK) != SD_DATA_ACCEPTED){
+        (void)localExchange(SD_TOKEN_STOP_MULTIPLE);
+        (void)localExchange(SD_IDLE_BYTE);
+        SdStreamRejected = TRUE;
+        SdStreamState = SD_STREAM_STOPPING;
+    }else{
+        SdStreamState = SD_STREAM_PROGRAMMING;
+    }
+}
+
+static bool_t localTxFinished(void){
+    return ((SdTxDone == TRUE) &&
+            (SPI_u8ReadFlag(SD_SPI_NUMBER, SPI_FLAG_TXE) == 1U) &&
+            (SPI_u8ReadFlag(SD_SPI_NUMBER, SPI_FLAG_BUSY) == 0U)) ? TRUE : FALSE;
+}
+
+static uint32_t localAddress(uint32_t block){
+    return (SdCardType == SD_CARD_V2_HC) ? block : (block * SD_BLOCK_SIZE);
+}
+
+static void localTxComplete(void){
+    SdTxDone = TRUE;
+    if(SdStreamState == SD_STREAM_DMA){
+        localEndStreamBlock();
+    }
+}
+
+static void localRxComplete(void){
+    SdRxDone = TRUE;
+}
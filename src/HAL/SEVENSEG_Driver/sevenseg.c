@@ -1,33 +1,12 @@
 #include "./LIB/stdtypes.h"
 
 #include "./MCAL/GPIO_Driver/gpio_int.h"
+#include "./HAL/BOARD_Driver/board_cfg.h"
+#include "./HAL/BOARD_Driver/board.h"
 
 #include "./HAL/SEVENSEG_Driver/sevenseg_cfg.h"
 #include "./HAL/SEVENSEG_Driver/sevenseg.h"
 
-/* Logical high level constant for readability */
-#define HIGH    (1UL)
-
-/* Logical low level constant for readability */
-#define LOW     (0UL)
-
-/* 
- * External declaration of the seven-segment display configuration structure
- * Defined in sevenseg_cfg.c, contains hardware pin mapping and electrical settings
- */
-extern const SEVSEG_cfg_t SevSegConfigration;
-
-/*
- * Lookup table mapping logical levels (LOW/HIGH) to GPIO driver values
- * Used for converting between application logic and GPIO driver enums
- * Index 0 (LOW)  → GPIO_LOW
- * Index 1 (HIGH) → GPIO_HIGH
- */
-const GPIO_Val_t SevenSegLevel[2] = {
-    GPIO_LOW,
-    GPIO_HIGH,
-};
-
 /*
  * Segment pattern lookup table for decimal digits 0-9
  * Each byte represents which segments should be illuminated for that digit
@@ -48,36 +27,67 @@ const GPIO_Val_t SevenSegLevel[2] = {
  * 
  * Index corresponds to the decimal value to display (0-9)
  */
-const uint8_t SevenSegValues[10] = {
-    0b0111111,   // 0: A,B,C,D,E,F    (all except G - forms '0')
-    0b0000110,   // 1: B,C            (right side only - forms '1')
-    0b1011011,   // 2: A,B,D,E,G      (top, right-top, middle, left-bottom, bottom - forms '2')
-    0b1001111,   // 3: A,B,C,D,G      (top, right side, middle, bottom - forms '3')
-    0b1100110,   // 4: B,C,F,G        (left-top, right side, middle - forms '4')
-    0b1101101,   // 5: A,C,D,F,G      (top, right-bottom, bottom, left-top, middle - forms '5')
-    0b1111101,   // 6: A,C,D,E,F,G    (all except B - forms '6')
-    0b0000111,   // 7: A,B,C          (top and right side - forms '7')
-    0b1111111,   // 8: A,B,C,D,E,F,G  (all segments - forms '8')
-    0b1101111    // 9: A,B,C,D,F,G    (all except E - forms '9')
+#define SEVSEG_DIGITS(DIGIT) \
+    DIGIT(0b0111111)   /* 0: A,B,C,D,E,F    (all except G - forms '0') */ \
+    DIGIT(0b0000110)   /* 1: B,C            (right side only - forms '1') */ \
+    DIGIT(0b1011011)   /* 2: A,B,D,E,G      (top, right-top, middle, left-bottom, bottom - forms '2') */ \
+    DIGIT(0b1001111)   /* 3: A,B,C,D,G      (top, right side, middle, bottom - forms '3') */ \
+    DIGIT(0b1100110)   /* 4: B,C,F,G        (left-top, right side, middle - forms '4') */ \
+    DIGIT(0b1101101)   /* 5: A,C,D,F,G      (top, right-bottom, bottom, left-top, middle - forms '5') */ \
+    DIGIT(0b1111101)   /* 6: A,C,D,E,F,G    (all except B - forms '6') */ \
+    DIGIT(0b0000111)   /* 7: A,B,C          (top and right side - forms '7') */ \
+    DIGIT(0b1111111)   /* 8: A,B,C,D,E,F,G  (all segments - forms '8') */ \
+    DIGIT(0b1101111)   /* 9: A,B,C,D,F,G    (all except E - forms '9') */
+
+#define SEVSEG_DIGITS_COUNT     (10U)
+#define SEVSEG_ALL_OFF          (0U)
+
+#define SEVSEG_X_PATTERN(pattern)   (pattern),
+
+const uint8_t SevenSegValues[SEVSEG_DIGITS_COUNT] = {
+    SEVSEG_DIGITS(SEVSEG_X_PATTERN)
+};
+
+/*
+ * Segment pins of board_cfg.h (BOARD_SEVSEG_PINS), one port so that a digit
+ * is a single BSRR write
+ */
+_Static_assert(BOARD_PINS_ON_PORT(BOARD_SEVSEG_A_PORT, BOARD_SEVSEG_PINS), "SEVSEG: BOARD_SEVSEG_PINS must share one port");
+
+static const GPIO_Image_t SevSegPinImage = BOARD_PORT_IMAGE_INITIALIZER(BOARD_SEVSEG_A_PORT, BOARD_SEVSEG_PINS);
+
+/*
+ * BSRR word of a segment pattern: each segment pin is set or reset to
+ * (segment bit ^ BOARD_SEVSEG_ACTIVE_STATE), the active-low inversion is
+ * folded at build time
+ */
+#define SEVSEG_SEGMENT_BSRR(pin, pattern, segment) \
+    BOARD_BSRR(pin, (((uint32_t)(pattern) >> (segment)) & 1U) ^ BOARD_SEVSEG_ACTIVE_STATE)
+
+#define SEVSEG_BSRR(pattern) \
+    (SEVSEG_SEGMENT_BSRR(BOARD_SEVSEG_A_PIN, pattern, 0U) | SEVSEG_SEGMENT_BSRR(BOARD_SEVSEG_B_PIN, pattern, 1U) | \
+     SEVSEG_SEGMENT_BSRR(BOARD_SEVSEG_C_PIN, pattern, 2U) | SEVSEG_SEGMENT_BSRR(BOARD_SEVSEG_D_PIN, pattern, 3U) | \
+     SEVSEG_SEGMENT_BSRR(BOARD_SEVSEG_E_PIN, pattern, 4U) | SEVSEG_SEGMENT_BSRR(BOARD_SEVSEG_F_PIN, pattern, 5U) | \
+     SEVSEG_SEGMENT_BSRR(BOARD_SEVSEG_G_PIN, pattern, 6U))
+
+#define SEVSEG_X_BSRR(pattern)      SEVSEG_BSRR(pattern),
+
+/* BSRR word of every digit, index = displayed value */
+static const uint32_t SevenSegBsrr[SEVSEG_DIGITS_COUNT] = {
+    SEVSEG_DIGITS(SEVSEG_X_BSRR)
 };
 
 
 /*
  * Function: SEVSEG_enuInit
- * Description: Initializes the seven-segment display by configuring all segment GPIO pins
- *              Sets up 7 GPIO pins (A through G) as outputs and turns all segments OFF
- * Parameters: None (uses configuration from SevSegConfigration)
- * Returns: SEVSEG_Status_t indicating success or first error encountered
+ * Description: Initializes the seven-segment display pins and turns all segments OFF
+ * Parameters: None (pins from BOARD_SEVSEG_PINS in board_cfg.h)
+ * Returns: SEVSEG_Status_t indicating success or the GPIO error
  * 
  * Implementation details:
- * 1. Configure common GPIO settings (output mode, push-pull, no pull, default speed)
- * 2. Iterate through all 7 segment pins (A-G)
- * 3. Initialize each pin as GPIO output
- * 4. Set each pin to OFF state (respecting active high/low configuration)
- * 5. Stop and return error if any GPIO operation fails
- * 
- * The function uses pointer arithmetic to iterate through segment pins in the
- * configuration structure (PinA through PinG are sequential in memory)
+ * 1. Drive all segments to their OFF level (one BSRR write, ODR is kept
+ *    while the pins are still inputs so they come up dark)
+ * 2. Apply the segment pin image (six read-modify-writes for the 7 pins)
  */
 SEVSEG_Status_t SEVSEG_enuInit(){
     /* Initialize return status as successful */
@@ -85,63 +95,20 @@ SEVSEG_Status_t SEVSEG_enuInit(){
     
     /* Variable to store GPIO operation status */
     GPIO_Status_t gpioStatus;
-    
-    /* GPIO configuration structure for segment pins */
-    GPIO_cfg_t cfg;
-
-    /* Configure common GPIO settings for all segment pins */
-    cfg.mode = GPIO_MODE_OUTPUT;                            /* Output mode for driving segments */
-    cfg.outputType = SevSegConfigration.outputType;         /* Push-pull or open-drain from config */
-    cfg.alternateFunction = GPIO_AF0;                       /* No alternate function (basic GPIO) */
-    cfg.pull = GPIO_NO_PULL;                                /* No pull resistors needed for outputs */
-    cfg.speed = GPIO_SPEED_DEFAULT;                         /* Default speed sufficient for static display */
-
-    /*
-     * Pointer to first segment pin configuration (PinA)
-     * Used for pointer arithmetic to iterate through all 7 segment pins
-     * Assumes PinA through PinG are sequential in memory (guaranteed by struct layout)
-     */
-    const SEVSEG_Pinout_t *ptr = &SevSegConfigration.PinA;
-    
-    /* Iterate through all 7 segments (A through G) */
-    for(uint8_t i = 0;i<7;i++){
-        /* Set port and pin for current segment using pointer arithmetic */
-        cfg.port = (ptr+i)->port;
-        cfg.pin = (ptr+i)->pin;
-        
-        /* Initialize GPIO pin with configured settings */
-        gpioStatus = GPIO_enuInit(&cfg);
-
-        /* Check if GPIO initialization was successful */
-        if(GPIO_OK != gpioStatus)
-        {
-            /* Cast GPIO error status to SEVSEG status and exit loop */
-            retStatus = (SEVSEG_Status_t)gpioStatus;
-            break;
-        }else{
-            /*
-             * Set segment to OFF state
-             * 
-             * Logic explanation:
-             * - LOW = 0, HIGH = 1
-             * - If activeState is ACTIVE_HIGH (0): LOW^0 = 0 (GPIO_LOW = OFF)
-             * - If activeState is ACTIVE_LOW (1):  LOW^1 = 1 (GPIO_HIGH = OFF)
-             * 
-             * XOR operation automatically inverts the level for active-low displays
-             * This ensures segments are OFF regardless of active state configuration
-             */
-            gpioStatus = GPIO_enuSetPinVal(cfg.port,cfg.pin,SevenSegLevel[(LOW^SevSegConfigration.activeState)]);
-
-            /* Check if setting pin value was successful */
-            if(GPIO_OK != gpioStatus)
-            {
-                /* Cast GPIO error status to SEVSEG status and exit loop */
-                retStatus = (SEVSEG_Status_t)gpioStatus;
-                break;
-            }else{
-                /* Continue to next segment */
-            }
-        }
+
+    gpioStatus = GPIO_enuSetResetPins((GPIO_Port_t)BOARD_SEVSEG_A_PORT, SEVSEG_BSRR(SEVSEG_ALL_OFF));
+    if(GPIO_OK == gpioStatus){
+        gpioStatus = GPIO_enuApplyImage(&SevSegPinImage);
+    }else{
+        /* keep the error */
+    }
+
+    if(GPIO_OK != gpioStatus)
+    {
+        /* Cast GPIO error status to SEVSEG status */
+        retStatus = (SEVSEG_Status_t)gpioStatus;
+    }else{
+        retStatus = SEVSEG_OK;
     }
 
     /* Return final initialization status */
@@ -151,90 +118,25 @@ SEVSEG_Status_t SEVSEG_enuInit(){
 /*
  * Function: SEVSEG_enuDisplayValue
  * Description: Displays a decimal digit (0-9) on the seven-segment display
- *              Looks up segment pattern and applies it to all segment pins
- *              Automatically handles active high/low logic
+ *              All segments change together with one precomputed BSRR write
  * Parameters:
  *   - Displayedvalue: Decimal digit to display (0-9)
  * Returns: SEVSEG_Status_t indicating success or error
  * 
- * Implementation algorithm:
- * 1. Look up segment pattern from SevenSegValues array
- * 2. For each segment (A through G):
- *    a. Extract bit value for current segment (LSB)
- *    b. XOR with activeState to handle active high/low
- *    c. Set GPIO pin to calculated value
- *    d. Right-shift pattern to process next segment
- * 3. Return error if any GPIO operation fails
- * 
- * The XOR logic ensures correct segment control for both common anode and common cathode:
- * - Common Cathode (ACTIVE_HIGH): bit=1, activeState=0 → 1^0=1 → HIGH (ON)
- * - Common Anode (ACTIVE_LOW):    bit=1, activeState=1 → 1^1=0 → LOW (ON)
+ * The active high/low handling is already in SevenSegBsrr:
+ * - Common Cathode (ACTIVE_HIGH): bit=1 → pin set   (ON)
+ * - Common Anode (ACTIVE_LOW):    bit=1 → pin reset (ON)
  */
 SEVSEG_Status_t SEVSEG_enuDisplayValue(uint8_t Displayedvalue){
     /* Initialize return status as successful */
     SEVSEG_Status_t retStatus = SEVSEG_OK;
-    
-    /* Variable to store GPIO operation status */
-    GPIO_Status_t gpioStatus;
-    
-    /*
-     * Pointer to first segment pin configuration (PinA)
-     * Used for pointer arithmetic to iterate through all 7 segment pins
-     */
-    const SEVSEG_Pinout_t *ptr = &SevSegConfigration.PinA;
-    
-    /*
-     * Look up segment pattern for the requested digit
-     * ActualDisplayedValue holds the bit pattern where:
-     * - bit 0 = Segment A state
-     * - bit 1 = Segment B state
-     * - ...
-     * - bit 6 = Segment G state
-     * Value of 1 means segment should be ON, 0 means OFF
-     */
-    uint8_t ActualDisplayedValue = SevenSegValues[Displayedvalue];
-    
-    /* Iterate through all 7 segments (A through G) */
-    for(uint8_t i = 0;i<7;i++){
-        /*
-         * Set GPIO pin value for current segment
-         * 
-         * Logic breakdown:
-         * 1. (ActualDisplayedValue&0b1): Extract LSB (current segment state, 0 or 1)
-         * 2. XOR with activeState: Invert if active-low configuration
-         *    - If bit=1 (segment should be ON):
-         *      * Active-high: 1^0=1 → HIGH (ON)
-         *      * Active-low:  1^1=0 → LOW (ON)
-         *    - If bit=0 (segment should be OFF):
-         *      * Active-high: 0^0=0 → LOW (OFF)
-         *      * Active-low:  0^1=1 → HIGH (OFF)
-         * 3. Use result as index into SevenSegLevel[] to get GPIO_Val_t
-         * 4. Set GPIO pin to calculated value
-         */
-        gpioStatus = GPIO_enuSetPinVal((ptr+i)->port,(ptr+i)->pin,SevenSegLevel[(ActualDisplayedValue&0b1)^(SevSegConfigration.activeState)]);
-        
-        /* Check if GPIO set operation was successful */
-        if(GPIO_OK != gpioStatus)
-        {
-            /* Cast GPIO error status to SEVSEG status and exit loop */
-            retStatus = (SEVSEG_Status_t)gpioStatus;
-            break;
-        }else{
-            /* Continue to next segment */
-        }
-        
-        /*
-         * Right-shift the pattern by 1 bit to process next segment
-         * This moves bit 1 (Segment B) to bit 0 position for next iteration
-         * Example:
-         * - Initial:      0b1011011 (digit '2')
-         * - After shift:  0b0101101 (now bit 0 = Segment B state)
-         * - After shift:  0b0010110 (now bit 0 = Segment C state)
-         * - etc.
-         */
-        ActualDisplayedValue = ActualDisplayedValue>>1;
+
+    if(Displayedvalue >= SEVSEG_DIGITS_COUNT){
+        retStatus = SEVSEG_NOT_OK;
+    }else{
+        retStatus = (SEVSEG_Status_t)GPIO_enuSetResetPins((GPIO_Port_t)BOARD_SEVSEG_A_PORT, SevenSegBsrr[Displayedvalue]);
     }
 
     /* Return final operation status */
     return retStatus;
-}
\ No newline at end of file
+}
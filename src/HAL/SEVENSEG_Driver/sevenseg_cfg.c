@@ -1,9 +1,16 @@
+#include "./LIB/stdtypes.h"
+#include "./MCAL/GPIO_Driver/gpio_int.h"
+#include "./HAL/BOARD_Driver/board_cfg.h"
+#include "./HAL/BOARD_Driver/board.h"
 #include "./HAL/SEVENSEG_Driver/sevenseg.h"
 
 /*
  * Seven-Segment Display Configuration Structure
  * Defines the complete hardware configuration for a single 7-segment display
  * 
+ * Pins and active level come from board_cfg.h (BOARD_SEVSEG_PINS,
+ * BOARD_SEVSEG_ACTIVE_STATE), the driver folds its BSRR table from there
+ * 
  * Hardware Configuration:
  * - All segments connected to GPIO Port A
  * - Sequential pin assignment (PA0 through PA6)
@@ -46,29 +53,29 @@
  */
 const SEVSEG_cfg_t SevSegConfigration = {
     /* Segment A - Top horizontal bar */
-    .PinA = {.port = SEVSEG_PORT_A,.pin = SEVSEG_PIN_0},
+    .PinA = {.port = (SEVSEG_Port_t)BOARD_SEVSEG_A_PORT,.pin = (SEVSEG_Pin_t)BOARD_SEVSEG_A_PIN},
     
     /* Segment B - Top-right vertical bar */
-    .PinB = {.port = SEVSEG_PORT_A,.pin = SEVSEG_PIN_1},
+    .PinB = {.port = (SEVSEG_Port_t)BOARD_SEVSEG_B_PORT,.pin = (SEVSEG_Pin_t)BOARD_SEVSEG_B_PIN},
     
     /* Segment C - Bottom-right vertical bar */
-    .PinC = {.port = SEVSEG_PORT_A,.pin = SEVSEG_PIN_2},
+    .PinC = {.port = (SEVSEG_Port_t)BOARD_SEVSEG_C_PORT,.pin = (SEVSEG_Pin_t)BOARD_SEVSEG_C_PIN},
     
     /* Segment D - Bottom horizontal bar */
-    .PinD = {.port = SEVSEG_PORT_A,.pin = SEVSEG_PIN_3},
+    .PinD = {.port = (SEVSEG_Port_t)BOARD_SEVSEG_D_PORT,.pin = (SEVSEG_Pin_t)BOARD_SEVSEG_D_PIN},
     
     /* Segment E - Bottom-left vertical bar */
-    .PinE = {.port = SEVSEG_PORT_A,.pin = SEVSEG_PIN_4},
+    .PinE = {.port = (SEVSEG_Port_t)BOARD_SEVSEG_E_PORT,.pin = (SEVSEG_Pin_t)BOARD_SEVSEG_E_PIN},
     
     /* Segment F - Top-left vertical bar */
-    .PinF = {.port = SEVSEG_PORT_A,.pin = SEVSEG_PIN_5},
+    .PinF = {.port = (SEVSEG_Port_t)BOARD_SEVSEG_F_PORT,.pin = (SEVSEG_Pin_t)BOARD_SEVSEG_F_PIN},
     
     /* Segment G - Middle horizontal bar */
-    .PinG = {.port = SEVSEG_PORT_A,.pin = SEVSEG_PIN_6},
+    .PinG = {.port = (SEVSEG_Port_t)BOARD_SEVSEG_G_PORT,.pin = (SEVSEG_Pin_t)BOARD_SEVSEG_G_PIN},
     
     /* Push-pull output mode for active drive capability */
     .outputType  = SEVSEG_OUTPUT_TYPE_PUSH_PULL,
     
     /* Active low for common anode display (segment ON when pin is LOW) */
-    .activeState = SEVSEG_ACTIVE_LOW,
+    .activeState = (SEVSEG_ActiveState_t)BOARD_SEVSEG_ACTIVE_STATE,
 };
\ No newline at end of file
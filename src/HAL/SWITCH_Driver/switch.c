@@ -1,6 +1,9 @@
 #include "./LIB/stdtypes.h"
 
+#include "./MCAL/RCC_Driver/rcc_int.h"
 #include "./MCAL/GPIO_Driver/gpio_int.h"
+#include "./HAL/BOARD_Driver/board_cfg.h"
+#include "./HAL/BOARD_Driver/board.h"
 #include "./OS/schedule.h"
 
 #include "HAL/SWITCH_Driver/switch_cfg.h"
@@ -98,6 +101,11 @@ SWITCH_Status_t SWITCH_enuInit(){
     
     /* Iterate through all configured switches to initialize their GPIO pins */
     for(uint8_t i = 0;i<SWITCH_LEN;i++){
+        /* Fitted switches are already set up by BOARD_enuInit at boot */
+        if(TRUE == BOARD_boolIsFitted((GPIO_Port_t)SWITCHConfigArr[i].port, (GPIO_Pin_t)SWITCHConfigArr[i].pin)){
+            continue;
+        }
+
         /* Set GPIO mode to input (switches require input mode for reading) */
         cfg.mode = GPIO_MODE_INPUT;
         
@@ -1,4 +1,8 @@
 
+#include "./LIB/stdtypes.h"
+#include "./MCAL/GPIO_Driver/gpio_int.h"
+#include "./HAL/BOARD_Driver/board_cfg.h"
+#include "./HAL/BOARD_Driver/board.h"
 #include "./HAL/SWITCH_Driver/switch.h"
 
 /*
@@ -10,12 +14,13 @@
  * Configuration details:
  * - SWITCH1_ON_KIT: External switch on kit, uses internal pull-up resistor
  *   When switch is pressed, pin reads LOW; when released, pin reads HIGH
+ * - Port and pin come from board_cfg.h (BOARD_SWITCH_PINS)
  */
 const SWITCH_cfg_t SWITCHConfigArr[SWITCH_LEN] = {
     /* External Kit Switch 1 - Port B, Pin 4, Internal Pull-Up */
     [SWITCH1_ON_KIT] = {
-        .port = SWITCH_PORT_B,
-        .pin  = SWITCH_PIN_4,
+        .port = (SWITCH_Port_t)BOARD_SWITCH_KIT_1_PORT,
+        .pin  = (SWITCH_Pin_t)BOARD_SWITCH_KIT_1_PIN,
         .connection = SWITCH_INTERNAL_PULLUP
     }
 };
\ No newline at end of file
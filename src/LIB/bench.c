@@ -0,0 +1,210 @@
+/*****************************************************
+ * File: bench.c
+ * Description: Microbenchmark harness
+ *****************************************************/
+
+#include "LIB/stdtypes.h"
+#include "LIB/bench_cfg.h"
+#include "LIB/bench.h"
+
+#if defined(__arm__)
+#include "LIB/dwt.h"
+#define BENCH_UNIT                  "cycles"
+#else
+#include <time.h>
+#define BENCH_UNIT                  "ns"
+#endif
+
+/* TRUE once BENCH_enuInit() measured the overhead */
+static bool_t BenchInitialized = FALSE;
+
+/* Time of an empty case, taken off every sample */
+static uint32_t BenchOverhead = 0;
+
+/* Samples of the case being run */
+static uint32_t BenchSamples[BENCH_MAX_REPETITIONS];
+
+/* Empty body of the calibration, called through a volatile pointer like a real case */
+static void localEmpty(void *args);
+static BENCH_Function_t volatile BenchEmptyBody = localEmpty;
+
+/* Cycle counter (target) or monotonic ns (host), wraps at 2^32 */
+static inline uint32_t localNow(void);
+
+/* Insertion sort, the samples are mostly equal */
+static void localSort(uint32_t *samples, uint16_t count);
+
+/* Appends text / a decimal number / the final newline to a line, returns the new length */
+static uint16_t localAppendText(uint8_t *line, uint16_t length, const char *text);
+static uint16_t localAppendNumber(uint8_t *line, uint16_t length, uint32_t number);
+static uint16_t localEndLine(uint8_t *line, uint16_t length);
+
+BENCH_Status_t BENCH_enuInit(void){
+    uint32_t start;
+    uint32_t elapsed;
+    uint32_t run;
+    BENCH_Function_t body = BenchEmptyBody;
+
+#if defined(__arm__)
+    DWT_vdStart();
+#endif
+
+    BenchOverhead = 0xFFFFFFFFUL;
+    for(run = 0; run < BENCH_CALIBRATION_RUNS; run++){
+        start = localNow();
+        body(NULL);
+        elapsed = localNow() - start;
+        if(elapsed < BenchOverhead){
+            BenchOverhead = elapsed;
+        }
+    }
+    BenchInitialized = TRUE;
+    return BENCH_OK;
+}
+
+BENCH_Status_t BENCH_enuRun(const BENCH_Case_t *benchCase, BENCH_Result_t *result){
+    BENCH_Status_t retStatus = BENCH_NOT_OK;
+    uint32_t start;
+    uint32_t elapsed;
+    uint16_t run;
+    uint16_t count;
+
+    if((NULL == benchCase) || (NULL == result) || (NULL == benchCase->BENCH_Body)){
+        retStatus = BENCH_NULL_PTR;
+    }else if(BenchInitialized == FALSE){
+        retStatus = BENCH_NOT_INIT;
+    }else if((benchCase->BENCH_Repetitions == 0) || (benchCase->BENCH_Repetitions > BENCH_MAX_REPETITIONS)){
+        retStatus = BENCH_WRONG_REPETITIONS;
+    }else{
+        count = benchCase->BENCH_Repetitions;
+
+        if(NULL != benchCase->BENCH_Setup){
+            benchCase->BENCH_Setup(benchCase->BENCH_Args);
+        }
+        for(run = 0; run < benchCase->BENCH_Warmup; run++){
+            benchCase->BENCH_Body(benchCase->BENCH_Args);
+        }
+
+        for(run = 0; run < count; run++){
+            start = localNow();
+            benchCase->BENCH_Body(benchCase->BENCH_Args);
+            elapsed = localNow() - start;
+            BenchSamples[run] = (elapsed > BenchOverhead) ? (elapsed - BenchOverhead) : 0;
+        }
+
+        localSort(BenchSamples, count);
+        result->BENCH_Min = BenchSamples[0];
+        result->BENCH_Median = BenchSamples[count / 2U];
+        // Smallest sample with at least 99 % of the samples at or below it
+        result->BENCH_P99 = BenchSamples[((99UL * count) + 99UL) / 100UL - 1U];
+        result->BENCH_Max = BenchSamples[count - 1U];
+        result->BENCH_Repetitions = count;
+        retStatus = BENCH_OK;
+    }
+    return retStatus;
+}
+
+BENCH_Status_t BENCH_enuRunAll(const BENCH_Case_t *const *cases, uint16_t count, BENCH_Output_t output){
+    BENCH_Status_t retStatus = BENCH_OK;
+    BENCH_Status_t caseStatus;
+    BENCH_Result_t result;
+    uint8_t line[BENCH_LINE_SIZE];
+    uint16_t length;
+    uint16_t index;
+
+    if((NULL == cases) || (NULL == output)){
+        retStatus = BENCH_NULL_PTR;
+    }else{
+        length = localAppendText(line, 0, "name,unit,reps,min,median,p99,max");
+        length = localEndLine(line, length);
+        output(line, length);
+
+        for(index = 0; index < count; index++){
+            caseStatus = BENCH_enuRun(cases[index], &result);
+            if(caseStatus == BENCH_OK){
+                length = localAppendText(line, 0, cases[index]->BENCH_Name);
+                length = localAppendText(line, length, "," BENCH_UNIT ",");
+                length = localAppendNumber(line, length, result.BENCH_Repetitions);
+                length = localAppendText(line, length, ",");
+                length = localAppendNumber(line, length, result.BENCH_Min);
+                length = localAppendText(line, length, ",");
+                length = localAppendNumber(line, length, result.BENCH_Median);
+                length = localAppendText(line, length, ",");
+                length = localAppendNumber(line, length, result.BENCH_P99);
+                length = localAppendText(line, length, ",");
+                length = localAppendNumber(line, length, result.BENCH_Max);
+                length = localEndLine(line, length);
+                output(line, length);
+            }else if(retStatus == BENCH_OK){
+                retStatus = caseStatus;
+            }else{
+                // Keep the first failure
+            }
+        }
+    }
+    return retStatus;
+}
+
+uint32_t BENCH_u32Start(void){
+    return localNow();
+}
+
+uint32_t BENCH_u32Stop(uint32_t start){
+    return localNow() - start;
+}
+
+static void localEmpty(void *args){
+    (void)args;
+}
+
+static inline uint32_t localNow(void){
+#if defined(__arm__)
+    return DWT_CYCCNT;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec);
+#endif
+}
+
+static void localSort(uint32_t *samples, uint16_t count){
+    uint16_t i;
+    uint16_t j;
+    uint32_t value;
+
+    for(i = 1; i < count; i++){
+        value = samples[i];
+        j = i;
+        while((j > 0) && (samples[j - 1U] > value)){
+            samples[j] = samples[j - 1U];
+            j--;
+        }
+        samples[j] = value;
+    }
+}
+
+static uint16_t localAppendText(uint8_t *line, uint16_t length, const char *text){
+    // One byte kept for the newline
+    while((*text != '\0') && (length < (BENCH_LINE_SIZE - 1U))){
+        line[length++] = (uint8_t)*text++;
+    }
+    return length;
+}
+
+static uint16_t localEndLine(uint8_t *line, uint16_t length){
+    line[length++] = '\n';
+    return length;
+}
+
+static uint16_t localAppendNumber(uint8_t *line, uint16_t length, uint32_t number){
+    char digits[11];
+    uint8_t index = sizeof(digits) - 1U;
+
+    digits[index] = '\0';
+    do{
+        digits[--index] = (char)('0' + (number % 10U));
+        number /= 10U;
+    }while(number != 0);
+
+    return localAppendText(line, length, &digits[index]);
+}
@@ -0,0 +1,354 @@
+/*****************************************************
+ * File: dsp.c
+ * Description: Fixed-point Q15 / Q31 filters and vector kernels
+ *****************************************************/
+
+#include "LIB/stdtypes.h"
+#include <string.h>
+#include "LIB/dsp.h"
+
+#if defined(__ARM_FEATURE_DSP) && !defined(DSP_PORTABLE)
+#define DSP_SIMD
+#endif
+
+/*
+ * Two Q15 samples as one word, first sample in the low half (little endian)
+ * memcpy compiles to a single LDR / STR on the M4 (unaligned access allowed
+ * for LDR / STR, the delay lines move by one sample)
+ */
+static inline uint32_t localLoadPair(const sint16_t *samples){
+    uint32_t pair;
+    memcpy(&pair, samples, sizeof(pair));
+    return pair;
+}
+
+static inline void localStorePair(sint16_t *samples, uint32_t pair){
+    memcpy(samples, &pair, sizeof(pair));
+}
+
+/* acc + x.lo * y.lo + x.hi * y.hi, 64-bit (SMLALD) */
+static inline sint64_t localSmlald(uint32_t x, uint32_t y, sint64_t acc){
+#ifdef DSP_SIMD
+    __asm ("SMLALD %Q0, %R0, %1, %2" : "+r" (acc) : "r" (x), "r" (y));
+    return acc;
+#else
+    return acc + (sint64_t)((sint32_t)(sint16_t)x * (sint32_t)(sint16_t)y)
+               + (sint64_t)((sint32_t)(sint16_t)(x >> 16) * (sint32_t)(sint16_t)(y >> 16));
+#endif
+}
+
+/* Saturated add of both halves (QADD16) */
+static inline uint32_t localQadd16(uint32_t x, uint32_t y){
+#ifdef DSP_SIMD
+    uint32_t result;
+    __asm ("QADD16 %0, %1, %2" : "=r" (result) : "r" (x), "r" (y));
+    return result;
+#else
+    uint16_t low = (uint16_t)DSP_s16SaturateQ15((sint32_t)(sint16_t)x + (sint32_t)(sint16_t)y);
+    uint16_t high = (uint16_t)DSP_s16SaturateQ15((sint32_t)(sint16_t)(x >> 16) + (sint32_t)(sint16_t)(y >> 16));
+    return ((uint32_t)high << 16) | low;
+#endif
+}
+
+/* 64-bit accumulator to Q15 : both clamps give the same result as one to 16 bits */
+static inline sint16_t localAccToQ15(sint64_t acc, uint8_t shift){
+    return DSP_s16SaturateQ15(DSP_s32SaturateQ31(acc >> shift));
+}
+
+DSP_Status_t DSP_enuFirInitQ15(DSP_FirQ15_t *fir, const sint16_t *coeffs, sint16_t *state, uint16_t taps){
+    DSP_Status_t retStatus = DSP_NOT_OK;
+
+    if((NULL == fir) || (NULL == coeffs) || (NULL == state)){
+        retStatus = DSP_NULL_PTR;
+    }else if((taps == 0) || (taps > 32767U)){
+        retStatus = DSP_WRONG_LENGTH;
+    }else{
+        fir->DSP_Coeffs = coeffs;
+        fir->DSP_State = state;
+        fir->DSP_Taps = taps;
+        fir->DSP_Index = 0;
+        memset(state, 0, 2U * taps * sizeof(sint16_t));
+        retStatus = DSP_OK;
+    }
+    return retStatus;
+}
+
+DSP_Status_t DSP_enuFirInitQ31(DSP_FirQ31_t *fir, const sint32_t *coeffs, sint32_t *state, uint16_t taps){
+    DSP_Status_t retStatus = DSP_NOT_OK;
+
+    if((NULL == fir) || (NULL == coeffs) || (NULL == state)){
+        retStatus = DSP_NULL_PTR;
+    }else if((taps == 0) || (taps > 32767U)){
+        retStatus = DSP_WRONG_LENGTH;
+    }else{
+        fir->DSP_Coeffs = coeffs;
+        fir->DSP_State = state;
+        fir->DSP_Taps = taps;
+        fir->DSP_Index = 0;
+        memset(state, 0, 2U * taps * sizeof(sint32_t));
+        retStatus = DSP_OK;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: DSP_vdFirQ15
+ * Description: Each sample is written at Index and Index + Taps, so the last
+ *              Taps samples are always State[Index .. Index + Taps - 1],
+ *              oldest first, and the sum is one straight dot product
+ */
+void DSP_vdFirQ15(DSP_FirQ15_t *fir, const sint16_t *input, sint16_t *output, uint32_t count){
+    sint16_t *state = fir->DSP_State;
+    uint16_t taps = fir->DSP_Taps;
+    uint16_t index = fir->DSP_Index;
+    sint16_t sample;
+    uint32_t n;
+
+    for(n = 0; n < count; n++){
+        sample = input[n];
+        state[index] = sample;
+        state[index + taps] = sample;
+        index++;
+        if(index == taps){
+            index = 0;
+        }
+        output[n] = localAccToQ15(DSP_s64DotQ15(&state[index], fir->DSP_Coeffs, taps), 15U);
+    }
+    fir->DSP_Index = index;
+}
+
+void DSP_vdFirQ31(DSP_FirQ31_t *fir, const sint32_t *input, sint32_t *output, uint32_t count){
+    sint32_t *state = fir->DSP_State;
+    uint16_t taps = fir->DSP_Taps;
+    uint16_t index = fir->DSP_Index;
+    sint32_t sample;
+    uint32_t n;
+
+    for(n = 0; n < count; n++){
+        sample = input[n];
+        state[index] = sample;
+        state[index + taps] = sample;
+        index++;
+        if(index == taps){
+            index = 0;
+        }
+        output[n] = DSP_s32SaturateQ31(DSP_s64DotQ31(&state[index], fir->DSP_Coeffs, taps) >> 31);
+    }
+    fir->DSP_Index = index;
+}
+
+DSP_Status_t DSP_enuBiquadInitQ15(DSP_BiquadQ15_t *biquad, const sint16_t *coeffs, sint16_t *state,
+                                  uint8_t stages, uint8_t postShift){
+    DSP_Status_t retStatus = DSP_NOT_OK;
+
+    if((NULL == biquad) || (NULL == coeffs) || (NULL == state)){
+        retStatus = DSP_NULL_PTR;
+    }else if((stages == 0) || (postShift > 14U)){
+        retStatus = DSP_WRONG_LENGTH;
+    }else{
+        biquad->DSP_Coeffs = coeffs;
+        biquad->DSP_State = state;
+        biquad->DSP_Stages = stages;
+        biquad->DSP_PostShift = postShift;
+        memset(state, 0, (uint32_t)stages * DSP_BIQUAD_STATE * sizeof(sint16_t));
+        retStatus = DSP_OK;
+    }
+    return retStatus;
+}
+
+DSP_Status_t DSP_enuBiquadInitQ31(DSP_BiquadQ31_t *biquad, const sint32_t *coeffs, sint32_t *state,
+                                  uint8_t stages, uint8_t postShift){
+    DSP_Status_t retStatus = DSP_NOT_OK;
+
+    if((NULL == biquad) || (NULL == coeffs) || (NULL == state)){
+        retStatus = DSP_NULL_PTR;
+    }else if((stages == 0) || (postShift > 30U)){
+        retStatus = DSP_WRONG_LENGTH;
+    }else{
+        biquad->DSP_Coeffs = coeffs;
+        biquad->DSP_State = state;
+        biquad->DSP_Stages = stages;
+        biquad->DSP_PostShift = postShift;
+        memset(state, 0, (uint32_t)stages * DSP_BIQUAD_STATE * sizeof(sint32_t));
+        retStatus = DSP_OK;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: DSP_vdBiquadQ15
+ * Description: Stage by stage over the whole block, the state pairs { x1, x2 }
+ *              and { y1, y2 } stay in registers and shift by 16 bits per sample
+ */
+void DSP_vdBiquadQ15(DSP_BiquadQ15_t *biquad, const sint16_t *input, sint16_t *output, uint32_t count){
+    const sint16_t *coeffs = biquad->DSP_Coeffs;
+    sint16_t *state = biquad->DSP_State;
+    const sint16_t *source = input;
+    uint8_t shift = 15U - biquad->DSP_PostShift;
+    uint8_t stage;
+    uint32_t n;
+
+    for(stage = 0; stage < biquad->DSP_Stages; stage++){
+        sint32_t b0 = coeffs[0];
+        uint32_t b12 = localLoadPair(&coeffs[1]);
+        uint32_t a12 = localLoadPair(&coeffs[3]);
+        uint32_t x12 = localLoadPair(&state[0]);
+        uint32_t y12 = localLoadPair(&state[2]);
+
+        for(n = 0; n < count; n++){
+            sint16_t x = source[n];
+            sint64_t acc = (sint64_t)(b0 * x);
+            acc = localSmlald(b12, x12, acc);
+            acc = localSmlald(a12, y12, acc);
+            sint16_t y = localAccToQ15(acc, shift);
+
+            x12 = (x12 << 16) | (uint16_t)x;
+            y12 = (y12 << 16) | (uint16_t)y;
+            output[n] = y;
+        }
+
+        localStorePair(&state[0], x12);
+        localStorePair(&state[2], y12);
+        coeffs += DSP_BIQUAD_COEFFS;
+        state += DSP_BIQUAD_STATE;
+        source = output;
+    }
+}
+
+void DSP_vdBiquadQ31(DSP_BiquadQ31_t *biquad, const sint32_t *input, sint32_t *output, uint32_t count){
+    const sint32_t *coeffs = biquad->DSP_Coeffs;
+    sint32_t *state = biquad->DSP_State;
+    const sint32_t *source = input;
+    uint8_t shift = 31U - biquad->DSP_PostShift;
+    uint8_t stage;
+    uint32_t n;
+
+    for(stage = 0; stage < biquad->DSP_Stages; stage++){
+        sint32_t x1 = state[0];
+        sint32_t x2 = state[1];
+        sint32_t y1 = state[2];
+        sint32_t y2 = state[3];
+
+        for(n = 0; n < count; n++){
+            sint32_t x = source[n];
+            sint64_t acc = (sint64_t)coeffs[0] * x;
+            acc += (sint64_t)coeffs[1] * x1;
+            acc += (sint64_t)coeffs[2] * x2;
+            acc += (sint64_t)coeffs[3] * y1;
+            acc += (sint64_t)coeffs[4] * y2;
+            sint32_t y = DSP_s32SaturateQ31(acc >> shift);
+
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            output[n] = y;
+        }
+
+        state[0] = x1;
+        state[1] = x2;
+        state[2] = y1;
+        state[3] = y2;
+        coeffs += DSP_BIQUAD_COEFFS;
+        state += DSP_BIQUAD_STATE;
+        source = output;
+    }
+}
+
+DSP_Status_t DSP_enuMovingAverageInitQ15(DSP_MovingAverageQ15_t *average, sint16_t *buffer, uint8_t shift){
+    DSP_Status_t retStatus = DSP_NOT_OK;
+
+    if((NULL == average) || (NULL == buffer)){
+        retStatus = DSP_NULL_PTR;
+    }else if(shift > 15U){
+        retStatus = DSP_WRONG_LENGTH;
+    }else{
+        average->DSP_Buffer = buffer;
+        average->DSP_Sum = 0;
+        average->DSP_Index = 0;
+        average->DSP_Shift = shift;
+        memset(buffer, 0, (1UL << shift) * sizeof(sint16_t));
+        retStatus = DSP_OK;
+    }
+    return retStatus;
+}
+
+void DSP_vdMovingAverageQ15(DSP_MovingAverageQ15_t *average, const sint16_t *input, sint16_t *output, uint32_t count){
+    sint16_t *buffer = average->DSP_Buffer;
+    uint16_t mask = (uint16_t)((1UL << average->DSP_Shift) - 1U);
+    uint16_t index = average->DSP_Index;
+    sint32_t sum = average->DSP_Sum;
+    uint32_t n;
+
+    for(n = 0; n < count; n++){
+        sint16_t sample = input[n];
+        sum += sample - buffer[index];
+        buffer[index] = sample;
+        index = (index + 1U) & mask;
+        output[n] = (sint16_t)(sum >> average->DSP_Shift);
+    }
+    average->DSP_Index = index;
+    average->DSP_Sum = sum;
+}
+
+sint64_t DSP_s64DotQ15(const sint16_t *a, const sint16_t *b, uint32_t count){
+    sint64_t acc = 0;
+    uint32_t i = 0;
+
+    // Four products per iteration : two SMLALD on target
+    for(; (i + 4U) <= count; i += 4U){
+        acc = localSmlald(localLoadPair(&a[i]), localLoadPair(&b[i]), acc);
+        acc = localSmlald(localLoadPair(&a[i + 2U]), localLoadPair(&b[i + 2U]), acc);
+    }
+    for(; i < count; i++){
+        acc += (sint32_t)a[i] * b[i];
+    }
+    return acc;
+}
+
+sint64_t DSP_s64DotQ31(const sint32_t *a, const sint32_t *b, uint32_t count){
+    sint64_t acc = 0;
+    uint32_t i;
+
+    for(i = 0; i < count; i++){
+        acc += (sint64_t)a[i] * b[i];
+    }
+    return acc;
+}
+
+void DSP_vdAddQ15(const sint16_t *a, const sint16_t *b, sint16_t *output, uint32_t count){
+    uint32_t i = 0;
+
+    for(; (i + 2U) <= count; i += 2U){
+        localStorePair(&output[i], localQadd16(localLoadPair(&a[i]), localLoadPair(&b[i])));
+    }
+    if(i < count){
+        output[i] = DSP_s16SaturateQ15((sint32_t)a[i] + b[i]);
+    }
+}
+
+void DSP_vdScaleQ15(const sint16_t *input, sint16_t scale, uint8_t shift, sint16_t *output, uint32_t count){
+    uint8_t right = 15U - shift;
+    uint32_t i;
+
+    for(i = 0; i < count; i++){
+        output[i] = DSP_s16SaturateQ15(((sint32_t)input[i] * scale) >> right);
+    }
+}
+
+void DSP_vdScaleQ31(const sint32_t *input, sint32_t scale, uint8_t shift, sint32_t *output, uint32_t count){
+    uint8_t right = 31U - shift;
+    uint32_t i;
+
+    for(i = 0; i < count; i++){
+        output[i] = DSP_s32SaturateQ31(((sint64_t)input[i] * scale) >> right);
+    }
+}
+
+void DSP_vdQ31ToQ15(const sint32_t *input, sint16_t *output, uint32_t count){
+    uint32_t i;
+
+    for(i = 0; i < count; i++){
+        output[i] = localAccToQ15((sint64_t)input[i] + 0x8000L, 16U);
+    }
+}
@@ -0,0 +1,649 @@
+/******************************************************************************
+ * @file    ADC.C
+ * @author  Eng.Gemy
+ * @brief   ADC Driver Implementation File
+ *          Scan sequences of ADC1 started by TIM2 TRGO, samples moved by
+ *          DMA2 stream 0 (channel 0) in circular mode, per-block averaging
+ *          on the half-transfer and transfer-complete interrupts
+ ******************************************************************************/
+
+#include "LIB/stdtypes.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "HAL/MCU_Driver/mcu.h"
+#include "MCAL/GPIO_Driver/gpio_int.h"
+#include "MCAL/NVIC_Driver/nvic_stm32f401cc.h"
+#include "MCAL/DMA_Driver/dma.h"
+
+#include "MCAL/ADC_Driver/adc_priv.h"
+#include "MCAL/ADC_Driver/adc_cfg.h"
+#include "MCAL/ADC_Driver/adc.h"
+
+#define ADC_DMA_CONTROLLER      DMA2
+#define ADC_DMA_STREAM          DMA_STREAM0
+#define ADC_DMA_CHANNEL         DMA_CHANNEL0
+#define ADC_DMA_MAX_DATA        (65535UL)
+
+/* Sampling cycles indexed by ADC_SampleTime_t, conversion cycles indexed by ADC_Resolution_t */
+static const uint16_t ADC_SampleCycles[] = {3U, 15U, 28U, 56U, 84U, 112U, 144U, 480U};
+static const uint8_t ADC_ResolutionCycles[] = {12U, 10U, 8U, 6U};
+
+static const ADC_Config_t *AdcConfig = NULL;
+static bool_t AdcRunning = FALSE;
+static bool_t AdcClocksAcquired = FALSE;
+static uint64_t AdcGpioClocks = 0;
+static volatile uint32_t AdcOverruns = 0;
+
+/* ADC_WRONG_SAMPLE_RATE or ADC_CLOCK_ERROR when the last clock change broke the trigger */
+static ADC_Status_t AdcClockStatus = ADC_OK;
+
+/* Means of the last completed block, one per sequence slot */
+static uint16_t AdcAverages[ADC_MAX_SEQUENCE_LENGTH];
+
+static ADC_Status_t ADC_enuCheckConfig(const ADC_Config_t *config);
+static ADC_Status_t ADC_enuSetupClocks(const ADC_Config_t *config);
+static ADC_Status_t ADC_enuSetupPrescaler(void);
+static void ADC_vdSetupSequence(const ADC_Config_t *config);
+static ADC_Status_t ADC_enuSetupTimer(const ADC_Config_t *config);
+static ADC_Status_t ADC_enuStartDma(void);
+static void ADC_vdSetSampleTime(uint8_t channel, ADC_SampleTime_t sampleTime);
+static void ADC_vdProcessBlock(uint8_t half);
+static void ADC_vdHalfTransferCallback(void);
+static void ADC_vdTransferCompleteCallback(void);
+
+/**
+ * @brief Configure ADC1, the TIM2 trigger and the DMA stream
+ *
+ * The ADC is switched on here (ADON, tSTAB) so ADC_enuStart() only arms the
+ * DMA and starts the timer. The stream itself is configured at each start:
+ * an overrun or a stop leaves it in an unknown position.
+ *
+ * @author Eng.Gemy
+ */
+ADC_Status_t ADC_enuInit(const ADC_Config_t *config)
+{
+    ADC_Status_t status = ADC_enuCheckConfig(config);
+
+    if (ADC_OK == status)
+    {
+        status = ADC_enuSetupClocks(config);
+    }
+
+    if (ADC_OK == status)
+    {
+        ADC1_Registers->CR2 = 0;
+        ADC1_Registers->CR1 = ((uint32_t)config->ADC_Resolution << ADC_CR1_RES_POS) | ADC_CR1_OVRIE |
+                              ((config->ADC_SequenceLength > 1U) ? ADC_CR1_SCAN : 0UL);
+        ADC_vdSetupSequence(config);
+
+        status = ADC_enuSetupTimer(config);
+    }
+
+    if (ADC_OK == status)
+    {
+        ADC1_Registers->SR = 0;
+        ADC1_Registers->CR2 = ADC_CR2_ADON | ADC_CR2_EXTSEL_TIM2_TRGO | ADC_CR2_EXTEN_RISING;
+        for (volatile uint32_t i = 0; i < ADC_STABILIZATION_LOOPS; i++);
+
+        (void)NVIC_BP_SetPriority(NVIC_ADC_IRQ, ADC_INTERRUPT_PRIORITY);
+        (void)NVIC_BP_SetPriority(NVIC_DMA2_STREAM0_IRQ, ADC_INTERRUPT_PRIORITY);
+        (void)NVIC_BP_EnableIRQ(NVIC_ADC_IRQ);
+        (void)NVIC_BP_EnableIRQ(NVIC_DMA2_STREAM0_IRQ);
+
+        AdcConfig = config;
+        AdcOverruns = 0;
+        AdcClockStatus = ADC_OK;
+
+        (void)MCU_enuRegisterClockNotifier(ADC_vdClockChangeNotifier);
+        (void)MCU_enuRegisterClockGuard(ADC_u8ClockChangeBusy);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Start the triggered sampling
+ *
+ * The counter restarts from 0 so the first trigger comes one full period
+ * after the call.
+ *
+ * @author Eng.Gemy
+ */
+ADC_Status_t ADC_enuStart(void)
+{
+    ADC_Status_t status = ADC_NOT_OK;
+
+    if (NULL == AdcConfig)
+    {
+        status = ADC_NOT_INIT;
+    }
+    else if (TRUE == AdcRunning)
+    {
+        status = ADC_BUSY;
+    }
+    else if (ADC_OK != AdcClockStatus)
+    {
+        status = AdcClockStatus;
+    }
+    else
+    {
+        AdcOverruns = 0;
+        status = ADC_enuStartDma();
+        if (ADC_OK == status)
+        {
+            ADC1_Registers->SR = 0;
+            ADC1_Registers->CR2 |= ADC_CR2_DMA | ADC_CR2_DDS;
+
+            TIM2_Registers->CNT = 0;
+            TIM2_Registers->CR1 |= TIM_CR1_CEN;
+            AdcRunning = TRUE;
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Stop the timer, the ADC DMA requests and the DMA stream
+ * @details A conversion started by the last trigger ends on its own, its
+ *          result stays in DR and is dropped
+ * @author Eng.Gemy
+ */
+ADC_Status_t ADC_enuStop(void)
+{
+    ADC_Status_t status = ADC_NOT_OK;
+
+    if (NULL == AdcConfig)
+    {
+        status = ADC_NOT_INIT;
+    }
+    else
+    {
+        TIM2_Registers->CR1 &= ~TIM_CR1_CEN;
+        ADC1_Registers->CR2 &= ~(ADC_CR2_DMA | ADC_CR2_DDS);
+        (void)DMA_enuDeInit(ADC_DMA_CONTROLLER, ADC_DMA_STREAM);
+        ADC1_Registers->SR = 0;
+        AdcRunning = FALSE;
+        status = ADC_OK;
+    }
+
+    return status;
+}
+
+/**
+ * @brief One software-started conversion, polled
+ *
+ * The regular sequence is replaced by the requested channel alone, then put
+ * back: the triggered sampling can be started again without a new init.
+ *
+ * @author Eng.Gemy
+ */
+ADC_Status_t ADC_enuReadChannel(uint8_t channel, uint16_t *value)
+{
+    ADC_Status_t status = ADC_NOT_OK;
+
+    if (NULL == value)
+    {
+        status = ADC_NULL_PTR;
+    }
+    else if (NULL == AdcConfig)
+    {
+        status = ADC_NOT_INIT;
+    }
+    else if (TRUE == AdcRunning)
+    {
+        status = ADC_BUSY;
+    }
+    else if (channel > ADC_CHANNEL_VBAT)
+    {
+        status = ADC_WRONG_CHANNEL;
+    }
+    else
+    {
+        uint32_t savedCR1  = ADC1_Registers->CR1;
+        uint32_t savedCR2  = ADC1_Registers->CR2;
+        uint32_t savedSQR1 = ADC1_Registers->SQR1;
+        uint32_t savedSQR3 = ADC1_Registers->SQR3;
+        uint32_t timeout = ADC_TIMEOUT_VALUE;
+
+        if (channel >= ADC_CHANNEL_TEMPERATURE)
+        {
+            ADC_CommonRegisters->CCR |= (ADC_CHANNEL_VBAT == channel) ? ADC_CCR_VBATE : ADC_CCR_TSVREFE;
+        }
+        ADC_vdSetSampleTime(channel, AdcConfig->ADC_SampleTime);
+
+        ADC1_Registers->CR1  = savedCR1 & ~(ADC_CR1_SCAN | ADC_CR1_OVRIE);
+        ADC1_Registers->CR2  = ADC_CR2_ADON;
+        ADC1_Registers->SQR1 = 0;
+        ADC1_Registers->SQR3 = channel;
+        ADC1_Registers->SR   = 0;
+        ADC1_Registers->CR2 |= ADC_CR2_SWSTART;
+
+        while (((ADC1_Registers->SR & ADC_SR_EOC) == 0) && (timeout > 0U))
+        {
+            timeout--;
+        }
+
+        if (0U == timeout)
+        {
+            status = ADC_TIMEOUT;
+        }
+        else
+        {
+            *value = (uint16_t)ADC1_Registers->DR;
+            status = ADC_OK;
+        }
+
+        ADC1_Registers->SQR3 = savedSQR3;
+        ADC1_Registers->SQR1 = savedSQR1;
+        ADC1_Registers->CR2  = savedCR2;
+        ADC1_Registers->SR   = 0;
+        ADC1_Registers->CR1  = savedCR1;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Number of overruns since ADC_enuStart()
+ * @author Eng.Gemy
+ */
+ADC_Status_t ADC_enuGetOverruns(uint32_t *overruns)
+{
+    ADC_Status_t status = ADC_NOT_OK;
+
+    if (NULL == overruns)
+    {
+        status = ADC_NULL_PTR;
+    }
+    else
+    {
+        *overruns = AdcOverruns;
+        status = ADC_OK;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Overrun recovery (RM0368 11.8.1)
+ *
+ * OVR stops the DMA requests. The stream is configured again from the start
+ * of the buffer, OVR is cleared and the DMA bit toggled: the next trigger
+ * starts a new sequence at SQ1, so samples stay aligned on channels.
+ *
+ * @author Eng.Gemy
+ */
+void ADC_IRQHandler(void)
+{
+    if ((ADC1_Registers->SR & ADC_SR_OVR) != 0)
+    {
+        AdcOverruns++;
+        ADC1_Registers->CR2 &= ~ADC_CR2_DMA;
+        (void)ADC_enuStartDma();
+        ADC1_Registers->SR = (uint32_t)(~ADC_SR_OVR);
+        ADC1_Registers->CR2 |= ADC_CR2_DMA;
+    }
+}
+
+/**
+ * @brief Clock change notifier, registered by ADC_enuInit()
+ *
+ * TIM2 ARR comes from PCLK1 and the sequence time from PCLK2: both are
+ * computed again after the switch. The guard keeps the sampling stopped
+ * during a switch, a refused switch (POST with the old clock) recomputes
+ * the same values. A rate the new clock cannot reach is returned by the
+ * next ADC_enuStart().
+ *
+ * @author Eng.Gemy
+ */
+void ADC_vdClockChangeNotifier(uint8_t phase)
+{
+    if ((MCU_CLOCK_POST_CHANGE == phase) && (NULL != AdcConfig) && (FALSE == AdcRunning))
+    {
+        AdcClockStatus = ADC_enuSetupPrescaler();
+        if (ADC_OK == AdcClockStatus)
+        {
+            AdcClockStatus = ADC_enuSetupTimer(AdcConfig);
+        }
+    }
+}
+
+/**
+ * @brief Clock change guard, registered by ADC_enuInit()
+ * @details The trigger period cannot change under a running DMA block
+ * @author Eng.Gemy
+ */
+uint8_t ADC_u8ClockChangeBusy(void)
+{
+    return (TRUE == AdcRunning) ? 1U : 0U;
+}
+
+/******************************************************************************
+ *                        STATIC FUNCTIONS
+ ******************************************************************************/
+
+static ADC_Status_t ADC_enuCheckConfig(const ADC_Config_t *config)
+{
+    ADC_Status_t status = ADC_OK;
+
+    if ((NULL == config) || (NULL == config->ADC_Sequence) || (NULL == config->ADC_Buffer))
+    {
+        status = ADC_NULL_PTR;
+    }
+    else if (TRUE == AdcRunning)
+    {
+        status = ADC_BUSY;
+    }
+    else if ((0U == config->ADC_SequenceLength) || (config->ADC_SequenceLength > ADC_MAX_SEQUENCE_LENGTH))
+    {
+        status = ADC_WRONG_SEQUENCE_LENGTH;
+    }
+    else if (config->ADC_SampleTime > ADC_SAMPLE_480_CYCLES)
+    {
+        status = ADC_WRONG_SAMPLE_TIME;
+    }
+    else if (config->ADC_Resolution > ADC_RESOLUTION_6_BIT)
+    {
+        status = ADC_WRONG_RESOLUTION;
+    }
+    else if (0U == config->ADC_SampleRate_Hz)
+    {
+        status = ADC_WRONG_SAMPLE_RATE;
+    }
+    else if ((0U == config->ADC_BlockLength) ||
+             ((2UL * config->ADC_BlockLength * config->ADC_SequenceLength) > ADC_DMA_MAX_DATA))
+    {
+        status = ADC_WRONG_BLOCK_LENGTH;
+    }
+    else
+    {
+        for (uint8_t i = 0; i < config->ADC_SequenceLength; i++)
+        {
+            if (config->ADC_Sequence[i] > ADC_CHANNEL_VBAT)
+            {
+                status = ADC_WRONG_CHANNEL;
+            }
+        }
+    }
+
+    return status;
+}
+
+/**
+ * ADC1 and TIM2 clocks once, GPIO ports each time a new one is used
+ * (the RCC refcount would grow at every init otherwise)
+ */
+static ADC_Status_t ADC_enuSetupClocks(const ADC_Config_t *config)
+{
+    ADC_Status_t status = ADC_OK;
+    uint64_t gpioClocks = 0;
+
+    if (FALSE == AdcClocksAcquired)
+    {
+        if ((RCC_AcquirePeripheralClock(RCC_APB2_BUS, RCC_APB2_ADC1_CLOCK) != RCC_OK) ||
+            (RCC_AcquirePeripheralClock(RCC_APB1_BUS, RCC_APB1_TIMER2_CLOCK) != RCC_OK))
+        {
+            status = ADC_CLOCK_ERROR;
+        }
+        else
+        {
+            AdcClocksAcquired = TRUE;
+        }
+    }
+
+    for (uint8_t i = 0; (i < config->ADC_SequenceLength) && (ADC_OK == status); i++)
+    {
+        uint8_t channel = config->ADC_Sequence[i];
+
+        if (channel < 8U)
+        {
+            gpioClocks |= RCC_AHB1_GPIOA_CLOCK;
+        }
+        else if (channel < 10U)
+        {
+            gpioClocks |= RCC_AHB1_GPIOB_CLOCK;
+        }
+        else if (channel < ADC_CHANNEL_TEMPERATURE)
+        {
+            gpioClocks |= RCC_AHB1_GPIOC_CLOCK;
+        }
+        else
+        {
+            // Internal channel, no pin
+        }
+    }
+
+    gpioClocks &= ~AdcGpioClocks;
+    if ((ADC_OK == status) && (gpioClocks != 0U))
+    {
+        if (RCC_AcquirePeripheralClock(RCC_AHB1_BUS, gpioClocks) != RCC_OK)
+        {
+            status = ADC_CLOCK_ERROR;
+        }
+        else
+        {
+            AdcGpioClocks |= gpioClocks;
+        }
+    }
+
+    if (ADC_OK == status)
+    {
+        status = ADC_enuSetupPrescaler();
+    }
+
+    return status;
+}
+
+/* ADCCLK = PCLK2 / ADC_CLOCK_DIVIDER, checked again after each clock change */
+static ADC_Status_t ADC_enuSetupPrescaler(void)
+{
+    ADC_Status_t status = ADC_OK;
+    uint32_t pclk2 = 0;
+
+    if ((RCC_GetClockHz(RCC_APB2_BUS, &pclk2) != RCC_OK) ||
+        ((pclk2 / ADC_CLOCK_DIVIDER) > ADC_MAX_CLOCK_HZ))
+    {
+        status = ADC_CLOCK_ERROR;
+    }
+    else
+    {
+        ADC_CommonRegisters->CCR = (ADC_CommonRegisters->CCR & ~ADC_CCR_ADCPRE_MASK) |
+                                   ((uint32_t)((ADC_CLOCK_DIVIDER / 2U) - 1U) << ADC_CCR_ADCPRE_POS);
+    }
+
+    return status;
+}
+
+/* Pins in analog mode, sampling times, SQ1..SQn and L */
+static void ADC_vdSetupSequence(const ADC_Config_t *config)
+{
+    volatile uint32_t *sqr[3] = {&ADC1_Registers->SQR3, &ADC1_Registers->SQR2, &ADC1_Registers->SQR1};
+    uint32_t sqrValue[3] = {0, 0, 0};
+
+    for (uint8_t i = 0; i < config->ADC_SequenceLength; i++)
+    {
+        uint8_t channel = config->ADC_Sequence[i];
+
+        if (channel < ADC_CHANNEL_TEMPERATURE)
+        {
+            GPIO_cfg_t pin = {
+                .port = (channel < 8U) ? GPIO_PORT_A : ((channel < 10U) ? GPIO_PORT_B : GPIO_PORT_C),
+                .pin = (GPIO_Pin_t)((channel < 8U) ? channel : ((channel < 10U) ? (channel - 8U) : (channel - 10U))),
+                .mode = GPIO_MODE_ANALOG,
+                .outputType = GPIO_OUTPUT_TYPE_PUSH_PULL,
+                .speed = GPIO_SPEED_LOW,
+                .pull = GPIO_NO_PULL,
+                .alternateFunction = GPIO_AF0
+            };
+            (void)GPIO_enuInit(&pin);
+        }
+        else
+        {
+            ADC_CommonRegisters->CCR |= (ADC_CHANNEL_VBAT == channel) ? ADC_CCR_VBATE : ADC_CCR_TSVREFE;
+        }
+
+        ADC_vdSetSampleTime(channel, config->ADC_SampleTime);
+        sqrValue[i / ADC_SQR_PER_REGISTER] |= (uint32_t)channel << ((i % ADC_SQR_PER_REGISTER) * ADC_SQR_BITS);
+    }
+
+    sqrValue[2] |= (uint32_t)(config->ADC_SequenceLength - 1U) << ADC_SQR1_L_POS;
+    for (uint8_t r = 0; r < 3U; r++)
+    {
+        *sqr[r] = sqrValue[r];
+    }
+}
+
+/**
+ * TIM2 overflows at ADC_SampleRate_Hz, its update event is TRGO
+ * The timer clock is PCLK1, doubled by the RCC when the APB1 prescaler is not 1
+ * The whole sequence must end before the next trigger or every trigger overruns
+ */
+static ADC_Status_t ADC_enuSetupTimer(const ADC_Config_t *config)
+{
+    ADC_Status_t status = ADC_OK;
+    uint32_t hclk = 0;
+    uint32_t pclk1 = 0;
+    uint32_t pclk2 = 0;
+
+    if ((RCC_GetClockHz(RCC_AHB1_BUS, &hclk) != RCC_OK) ||
+        (RCC_GetClockHz(RCC_APB1_BUS, &pclk1) != RCC_OK) ||
+        (RCC_GetClockHz(RCC_APB2_BUS, &pclk2) != RCC_OK))
+    {
+        status = ADC_CLOCK_ERROR;
+    }
+    else
+    {
+        uint32_t timerClock = (pclk1 == hclk) ? pclk1 : (2U * pclk1);
+        uint64_t sequenceCycles = (uint64_t)config->ADC_SequenceLength *
+                                  (ADC_SampleCycles[config->ADC_SampleTime] + ADC_ResolutionCycles[config->ADC_Resolution]);
+
+        if ((config->ADC_SampleRate_Hz > (timerClock / 2U)) ||
+            ((sequenceCycles * config->ADC_SampleRate_Hz) >= (uint64_t)(pclk2 / ADC_CLOCK_DIVIDER)))
+        {
+            status = ADC_WRONG_SAMPLE_RATE;
+        }
+        else
+        {
+            // 32-bit counter : no prescaler needed down to 1 Hz
+            TIM2_Registers->CR1 = TIM_CR1_URS;
+            TIM2_Registers->CR2 = 0;
+            TIM2_Registers->PSC = 0;
+            TIM2_Registers->ARR = (timerClock / config->ADC_SampleRate_Hz) - 1U;
+            TIM2_Registers->EGR = TIM_EGR_UG;    // Load PSC, before TRGO is routed to the ADC
+            TIM2_Registers->SR = 0;
+            TIM2_Registers->CR2 = TIM_CR2_MMS_UPDATE;
+        }
+    }
+
+    return status;
+}
+
+/* Circular stream over the whole buffer, a block per half */
+static ADC_Status_t ADC_enuStartDma(void)
+{
+    ADC_Status_t status = ADC_DMA_ERROR;
+    DMA_Config_t dmaConfig;
+
+    dmaConfig.DMAx               = ADC_DMA_CONTROLLER;
+    dmaConfig.Streamx            = ADC_DMA_STREAM;
+    dmaConfig.Channel            = ADC_DMA_CHANNEL;
+    dmaConfig.MBurst             = DMA_MBurst_SINGLE;
+    dmaConfig.PBurst             = DMA_PBurst_SINGLE;
+    dmaConfig.DoubleBuffer       = DMA_DISABLE_DOUBLE_BUFFER;
+    dmaConfig.Priority           = DMA_PRIORITY_VERY_HIGH;
+    dmaConfig.MSize              = DMA_MSIZE_HALFWORD;
+    dmaConfig.PSize              = DMA_PSIZE_HALFWORD;
+    dmaConfig.MemoryInc          = DMA_MINC_AUTO_INCREMENT;
+    dmaConfig.PeripheralInc      = DMA_PINC_FIXED;
+    dmaConfig.Direction          = DMA_DIRECTION_P2M;
+    dmaConfig.PeripheralFlowCtrl = DMA_FLOW_CONTROL_USING_DMA;
+    dmaConfig.Mode               = DMA_MODE_DIRECT;
+    dmaConfig.FifoThreshold      = DMA_FIFO_THRESHOLD_FULL; // Not important at direct mode
+    dmaConfig.PeripheralAddress  = (uint32_t)&ADC1_Registers->DR;
+    dmaConfig.Memory0Address     = (uint32_t)AdcConfig->ADC_Buffer;
+    dmaConfig.Memory1Address     = 0; // Not used in normal mode
+    dmaConfig.CircularMode       = DMA_CIRCULAR_MODE_ENABLE;
+    dmaConfig.Interrupts         = DMA_INTERRUPT_HALF_TRANSFER_ENABLE | DMA_INTERRUPT_TRANSFER_COMPLETE_ENABLE;
+    dmaConfig.NumberOfData       = (uint16_t)(2U * AdcConfig->ADC_BlockLength * AdcConfig->ADC_SequenceLength);
+
+    DMA_Status_t dmaStatus = DMA_enuDeInit(ADC_DMA_CONTROLLER, ADC_DMA_STREAM);
+    if ((DMA_OK == dmaStatus) || (DMA_STREAM_NOT_INIT == dmaStatus))
+    {
+        dmaStatus = DMA_enuInit(&dmaConfig);
+    }
+    if (DMA_OK == dmaStatus)
+    {
+        (void)DMA_enuClearFlag(ADC_DMA_CONTROLLER, ADC_DMA_STREAM, DMA_INTERRUPT_HALF_TRANSFER);
+        (void)DMA_enuClearFlag(ADC_DMA_CONTROLLER, ADC_DMA_STREAM, DMA_INTERRUPT_TRANSMISSION_COMPLETE);
+        dmaStatus = DMA_enuRegisterCallback(ADC_DMA_CONTROLLER, ADC_DMA_STREAM, DMA_INTERRUPT_HALF_TRANSFER, ADC_vdHalfTransferCallback);
+    }
+    if (DMA_OK == dmaStatus)
+    {
+        dmaStatus = DMA_enuRegisterCallback(ADC_DMA_CONTROLLER, ADC_DMA_STREAM, DMA_INTERRUPT_TRANSMISSION_COMPLETE, ADC_vdTransferCompleteCallback);
+    }
+    if (DMA_OK == dmaStatus)
+    {
+        dmaStatus = DMA_enuStartTransfer(ADC_DMA_CONTROLLER, ADC_DMA_STREAM);
+    }
+    if (DMA_OK == dmaStatus)
+    {
+        status = ADC_OK;
+    }
+
+    return status;
+}
+
+/* SMPR2 holds channels 0-9, SMPR1 channels 10-18 */
+static void ADC_vdSetSampleTime(uint8_t channel, ADC_SampleTime_t sampleTime)
+{
+    volatile uint32_t *smpr = (channel < ADC_SMPR2_CHANNELS) ? &ADC1_Registers->SMPR2 : &ADC1_Registers->SMPR1;
+    uint32_t shift = (uint32_t)((channel < ADC_SMPR2_CHANNELS) ? channel : (channel - ADC_SMPR2_CHANNELS)) * ADC_SMPR_BITS;
+
+    *smpr = (*smpr & ~(7UL << shift)) | ((uint32_t)sampleTime << shift);
+}
+
+/**
+ * Runs while the DMA fills the other half : one block time to average and
+ * call back. Sums are 32-bit : 65535 samples of 12 bits cannot overflow them
+ */
+static void ADC_vdProcessBlock(uint8_t half)
+{
+    const ADC_Config_t *config = AdcConfig;
+    uint32_t blockSize = (uint32_t)config->ADC_BlockLength * config->ADC_SequenceLength;
+    const uint16_t *block = config->ADC_Buffer + (half * blockSize);
+    const uint16_t *averages = NULL;
+
+    if (ADC_AVERAGING_ENABLED == config->ADC_Averaging)
+    {
+        uint32_t sums[ADC_MAX_SEQUENCE_LENGTH] = {0};
+        const uint16_t *sample = block;
+
+        for (uint16_t s = 0; s < config->ADC_BlockLength; s++)
+        {
+            for (uint8_t i = 0; i < config->ADC_SequenceLength; i++)
+            {
+                sums[i] += *sample++;
+            }
+        }
+        for (uint8_t i = 0; i < config->ADC_SequenceLength; i++)
+        {
+            AdcAverages[i] = (uint16_t)((sums[i] + (config->ADC_BlockLength / 2U)) / config->ADC_BlockLength);
+        }
+        averages = AdcAverages;
+    }
+
+    if (NULL != config->ADC_BlockCallback)
+    {
+        config->ADC_BlockCallback(block, averages);
+    }
+}
+
+static void ADC_vdHalfTransferCallback(void)
+{
+    ADC_vdProcessBlock(0);
+}
+
+static void ADC_vdTransferCompleteCallback(void)
+{
+    ADC_vdProcessBlock(1);
+}
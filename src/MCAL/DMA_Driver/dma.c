@@ -1,7 +1,12 @@
 
 
+#include "LIB/stdtypes.h"
+#include "LIB/bits.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
 #include "MCAL/DMA_Driver/dma_priv.h"
 #include "MCAL/DMA_Driver/dma.h"
+#include "OS/trace.h"
+#include "OS/fault.h"
 
 static void DMA_Local_Handler(DMA_Controller_t dmaController, DMA_Stream_t stream);
 
@@ -9,12 +14,11 @@ static DMA_Register_t* dmaRegisters[] = {
     DMA1_BASE_ADDR,
     DMA2_BASE_ADDR
 };
-const uint8_t flagsOffsetTable[] = {
-    0,          // Stream 0,4
-    6,          // Stream 1,5
-    16,         // Stream 2,6
-    22,         // Stream 3,7
-};
+// Offset of the stream flags in xISR / xIFCR : 0, 6, 16, 22 for streams 0..3 (4..7)
+#define DMA_FLAGS_OFFSET(stream)    ((((uint32_t)(stream) & 1U) * 6U) + (((uint32_t)(stream) & 2U) * 8U))
+
+// The 5 flags of a stream at bit 0 (bit 1 is reserved)
+#define DMA_STREAM_FLAGS_MASK       (0x3DUL)
 
 const uint8_t flagsPositions[] = {
     0,          // FIFO Error
@@ -24,9 +28,26 @@ const uint8_t flagsPositions[] = {
     5           // Transmission Complete
 };
 
+// Interrupt of each flag bit, flagsPositions reversed (bit 1 unused)
+static const DMA_Interrupts_t flagsInterrupts[] = {
+    DMA_INTERRUPT_FIFO_ERROR,
+    DMA_INTERRUPT_FIFO_ERROR,
+    DMA_INTERRUPT_DIRECT_MODE_ERROR,
+    DMA_INTERRUPT_TRANSFER_ERROR,
+    DMA_INTERRUPT_HALF_TRANSFER,
+    DMA_INTERRUPT_TRANSMISSION_COMPLETE
+};
+
 
 static DMA_CallBack_t dmaCallbacks[2][8][5] = { { {0} } };
 
+// Every initialized stream is one owner of its controller clock
+static const uint64_t dmaClockMasks[] = {
+    RCC_AHB1_DMA1_CLOCK,
+    RCC_AHB1_DMA2_CLOCK
+};
+static bool_t dmaStreamOwned[2][8] = { {FALSE} };
+
 DMA_Status_t DMA_enuInit(const DMA_Config_t* ConfigPtr){
     DMA_Status_t retStatus = DMA_NOT_OK;
     if(NULL == ConfigPtr){
@@ -85,43 +106,52 @@ DMA_Status_t DMA_enuInit(const DMA_Config_t* ConfigPtr){
                                                                         if(ConfigPtr->NumberOfData == 0){
                                                                             retStatus = DMA_WRONG_ZERO_NUMBER_OF_DATA;
                                                                         }else{
-                                                                            // All parameters are valid, proceed with configuration
-                                                                            DMA_StreamRegs_t* streamRegs = &dmaRegisters[ConfigPtr->DMAx]->STREAM[ConfigPtr->Streamx];
-
-                                                                            // Disable the stream before configuration
-                                                                            streamRegs->SCR &= DMA_DISABLE;
-
-                                                                            // Configure the stream
-                                                                            uint32_t scrValue = 0;
-                                                                            scrValue |= ConfigPtr->Channel;
-                                                                            scrValue |= ConfigPtr->MBurst;
-                                                                            scrValue |= ConfigPtr->PBurst;
-                                                                            scrValue |= ConfigPtr->DoubleBuffer;
-                                                                            scrValue |= ConfigPtr->Priority;
-                                                                            scrValue |= ConfigPtr->MSize;
-                                                                            scrValue |= ConfigPtr->PSize;
-                                                                            scrValue |= ConfigPtr->MemoryInc;
-                                                                            scrValue |= ConfigPtr->PeripheralInc;
-                                                                            scrValue |= ConfigPtr->CircularMode;
-                                                                            scrValue |= ConfigPtr->Direction;
-                                                                            scrValue |= ConfigPtr->PeripheralFlowCtrl;                                                                            
-                                                                            scrValue |= (ConfigPtr->Interrupts & DMA_INTERRUPT_SCR_REG);
-                                                                            streamRegs->SCR |= scrValue;
-
-                                                                            streamRegs->SNDTR = ConfigPtr->NumberOfData;
-                                                                            streamRegs->SPAR = ConfigPtr->PeripheralAddress;
-                                                                            streamRegs->SM0AR = ConfigPtr->Memory0Address;
-                                                                            if(ConfigPtr->DoubleBuffer == DMA_ENABLE_DOUBLE_BUFFER){
-                                                                                streamRegs->SM1AR = ConfigPtr->Memory1Address;
-                                                                            }else{
-                                                                                // If double buffer is not enabled, SM1AR is not used
+                                                                            // All parameters are valid, clock the controller then proceed with configuration
+                                                                            if(dmaStreamOwned[ConfigPtr->DMAx][ConfigPtr->Streamx] == FALSE){
+                                                                                if(RCC_AcquirePeripheralClock(RCC_AHB1_BUS, dmaClockMasks[ConfigPtr->DMAx]) == RCC_OK){
+                                                                                    dmaStreamOwned[ConfigPtr->DMAx][ConfigPtr->Streamx] = TRUE;
+                                                                                }
                                                                             }
+                                                                            if(dmaStreamOwned[ConfigPtr->DMAx][ConfigPtr->Streamx] == FALSE){
+                                                                                retStatus = DMA_CLOCK_ERROR;
+                                                                            }else{
+                                                                                DMA_StreamRegs_t* streamRegs = &dmaRegisters[ConfigPtr->DMAx]->STREAM[ConfigPtr->Streamx];
+
+                                                                                // Disable the stream before configuration
+                                                                                streamRegs->SCR &= DMA_DISABLE;
+
+                                                                                // Configure the stream
+                                                                                uint32_t scrValue = 0;
+                                                                                scrValue |= ConfigPtr->Channel;
+                                                                                scrValue |= ConfigPtr->MBurst;
+                                                                                scrValue |= ConfigPtr->PBurst;
+                                                                                scrValue |= ConfigPtr->DoubleBuffer;
+                                                                                scrValue |= ConfigPtr->Priority;
+                                                                                scrValue |= ConfigPtr->MSize;
+                                                                                scrValue |= ConfigPtr->PSize;
+                                                                                scrValue |= ConfigPtr->MemoryInc;
+                                                                                scrValue |= ConfigPtr->PeripheralInc;
+                                                                                scrValue |= ConfigPtr->CircularMode;
+                                                                                scrValue |= ConfigPtr->Direction;
+                                                                                scrValue |= ConfigPtr->PeripheralFlowCtrl;                                                                            
+                                                                                scrValue |= (ConfigPtr->Interrupts & DMA_INTERRUPT_SCR_REG);
+                                                                                streamRegs->SCR |= scrValue;
+
+                                                                                streamRegs->SNDTR = ConfigPtr->NumberOfData;
+                                                                                streamRegs->SPAR = ConfigPtr->PeripheralAddress;
+                                                                                streamRegs->SM0AR = ConfigPtr->Memory0Address;
+                                                                                if(ConfigPtr->DoubleBuffer == DMA_ENABLE_DOUBLE_BUFFER){
+                                                                                    streamRegs->SM1AR = ConfigPtr->Memory1Address;
+                                                                                }else{
+                                                                                    // If double buffer is not enabled, SM1AR is not used
+                                                                                }
                                                                         
-                                                                            streamRegs->SFCR |= ConfigPtr->Mode;
-                                                                            streamRegs->SFCR |= ConfigPtr->FifoThreshold;
-                                                                            streamRegs->SFCR |= (ConfigPtr->Interrupts & DMA_INTERRUPT_SFCR_REG);
+                                                                                streamRegs->SFCR |= ConfigPtr->Mode;
+                                                                                streamRegs->SFCR |= ConfigPtr->FifoThreshold;
+                                                                                streamRegs->SFCR |= (ConfigPtr->Interrupts & DMA_INTERRUPT_SFCR_REG);
                                                                         
-                                                                            retStatus = DMA_OK;
+                                                                                retStatus = DMA_OK;
+                                                                            }
                                                                         }
                                                                     }
                                                                 }
@@ -144,6 +174,67 @@ DMA_Status_t DMA_enuInit(const DMA_Config_t* ConfigPtr){
 }
 
 
+DMA_Status_t DMA_enuInitImage(const DMA_Image_t* Image){
+    DMA_Status_t retStatus = DMA_NOT_OK;
+    if(NULL == Image){
+        retStatus = DMA_NULL_PTR;
+    }else if(Image->DMAx > DMA2){
+        retStatus = DMA_WRONG_DMA_CONTROLLER;
+    }else if((Image->Streamx > DMA_STREAM7)){
+        retStatus = DMA_WRONG_STREAM;
+    }else{
+        // The fields were checked by DMA_IMAGE_DECLARE, clock the controller then store the image
+        if(dmaStreamOwned[Image->DMAx][Image->Streamx] == FALSE){
+            if(RCC_AcquirePeripheralClock(RCC_AHB1_BUS, dmaClockMasks[Image->DMAx]) == RCC_OK){
+                dmaStreamOwned[Image->DMAx][Image->Streamx] = TRUE;
+            }
+        }
+        if(dmaStreamOwned[Image->DMAx][Image->Streamx] == FALSE){
+            retStatus = DMA_CLOCK_ERROR;
+        }else{
+            DMA_StreamRegs_t* streamRegs = &dmaRegisters[Image->DMAx]->STREAM[Image->Streamx];
+
+            // Disable the stream, the registers are written only once EN reads back 0
+            streamRegs->SCR = 0;
+            while((streamRegs->SCR & DMA_ENABLE) != 0);
+
+            streamRegs->SNDTR = Image->SNDTR;
+            streamRegs->SPAR = Image->SPAR;
+            streamRegs->SM0AR = Image->SM0AR;
+            streamRegs->SM1AR = Image->SM1AR;
+            streamRegs->SFCR = Image->SFCR;
+            streamRegs->SCR = Image->SCR;
+
+            retStatus = DMA_OK;
+        }
+    }
+    return retStatus;
+}
+
+DMA_Status_t DMA_enuDeInit(DMA_Controller_t DMAx, DMA_Stream_t Streamx){
+    DMA_Status_t retStatus = DMA_NOT_OK;
+    if(DMAx > DMA2){
+        retStatus = DMA_WRONG_DMA_CONTROLLER;
+    }else if((Streamx > DMA_STREAM7)){
+        retStatus = DMA_WRONG_STREAM;
+    }else if(dmaStreamOwned[DMAx][Streamx] == FALSE){
+        retStatus = DMA_STREAM_NOT_INIT;
+    }else{
+        DMA_StreamRegs_t* streamRegs = &dmaRegisters[DMAx]->STREAM[Streamx];
+        // Disable the stream and its interrupts, the hardware clears EN at the end of the current beat
+        streamRegs->SCR = 0;
+        while((streamRegs->SCR & DMA_ENABLE) != 0);
+
+        dmaStreamOwned[DMAx][Streamx] = FALSE;
+        if(RCC_ReleasePeripheralClock(RCC_AHB1_BUS, dmaClockMasks[DMAx]) != RCC_OK){
+            retStatus = DMA_CLOCK_ERROR;
+        }else{
+            retStatus = DMA_OK;
+        }
+    }
+    return retStatus;
+}
+
 DMA_Status_t DMA_enuStartTransfer(DMA_Controller_t DMAx, DMA_Stream_t Streamx){
     DMA_Status_t retStatus = DMA_NOT_OK;
     if(DMAx > DMA2){
@@ -228,7 +319,7 @@ DMA_Status_t DMA_enuRegisterCallback(DMA_Controller_t DMAx, DMA_Stream_t Streamx
 }
 
 
-uint8_t DMA_u8ReadFlag(DMA_Controller_t DMAx, DMA_Stream_t Streamx, DMA_Interrupts_t Interrupt){
+RAMFUNC uint8_t DMA_u8ReadFlag(DMA_Controller_t DMAx, DMA_Stream_t Streamx, DMA_Interrupts_t Interrupt){
     uint8_t flagStatus = 0;
     if(DMAx > DMA2){
         // Invalid DMA controller
@@ -243,7 +334,7 @@ uint8_t DMA_u8ReadFlag(DMA_Controller_t DMAx, DMA_Stream_t Streamx, DMA_Interrup
         }else{
             DMA_Register_t* dmaReg = dmaRegisters[DMAx];
             uint8_t flagindex;
-            flagindex = flagsPositions[Interrupt] + (flagsOffsetTable[Streamx % 4]);
+            flagindex = flagsPositions[Interrupt] + DMA_FLAGS_OFFSET(Streamx);
             if(Streamx < DMA_STREAM4){
                 // Low interrupt status register
                 flagStatus = (dmaReg->LISR >> flagindex) & 0x1;
@@ -256,7 +347,7 @@ uint8_t DMA_u8ReadFlag(DMA_Controller_t DMAx, DMA_Stream_t Streamx, DMA_Interrup
     return flagStatus;
 }
 
-DMA_Status_t DMA_enuClearFlag(DMA_Controller_t DMAx, DMA_Stream_t Streamx, DMA_Interrupts_t Interrupt){
+RAMFUNC DMA_Status_t DMA_enuClearFlag(DMA_Controller_t DMAx, DMA_Stream_t Streamx, DMA_Interrupts_t Interrupt){
     DMA_Status_t retStatus = DMA_NOT_OK;
     if(DMAx > DMA2){
         retStatus = DMA_WRONG_DMA_CONTROLLER;
@@ -268,7 +359,7 @@ DMA_Status_t DMA_enuClearFlag(DMA_Controller_t DMAx, DMA_Stream_t Streamx, DMA_I
         }else{
             DMA_Register_t* dmaReg = dmaRegisters[DMAx];
             uint8_t flagindex;
-            flagindex = flagsPositions[Interrupt] + (flagsOffsetTable[Streamx % 4]);
+            flagindex = flagsPositions[Interrupt] + DMA_FLAGS_OFFSET(Streamx);
             if(Streamx < DMA_STREAM4){
                 // Clear flag in Low interrupt flag clear register
                 dmaReg->LIFCR |= (1 << flagindex);
@@ -282,129 +373,131 @@ DMA_Status_t DMA_enuClearFlag(DMA_Controller_t DMAx, DMA_Stream_t Streamx, DMA_I
     return retStatus;
 }
 
-static void DMA_Local_Handler(DMA_Controller_t dmaController, DMA_Stream_t stream) {
-    // Check which interrupt occurred and call the corresponding callback
-    if(DMA_u8ReadFlag(dmaController, stream, DMA_INTERRUPT_TRANSMISSION_COMPLETE) == 1){
-        // Clear the transmission complete flag
-        DMA_enuClearFlag(dmaController, stream, DMA_INTERRUPT_TRANSMISSION_COMPLETE);
+RAMFUNC static void DMA_Local_Handler(DMA_Controller_t dmaController, DMA_Stream_t stream) {
+    DMA_Register_t* dmaReg = dmaRegisters[dmaController];
+    uint32_t offset = DMA_FLAGS_OFFSET(stream);
+    uint32_t pending;
+    uint32_t flag;
+    DMA_Interrupts_t interrupt;
 
-        // Call the registered callback function
-        if(dmaCallbacks[dmaController][stream][DMA_INTERRUPT_TRANSMISSION_COMPLETE] != 0){
-            dmaCallbacks[dmaController][stream][DMA_INTERRUPT_TRANSMISSION_COMPLETE]();
-        }
-    }
+    TRACE_EVENT(TRACE_EVENT_ISR_ENTER, TRACE_SOURCE_DMA | (dmaController << 3) | stream);
 
-    if(DMA_u8ReadFlag(dmaController, stream, DMA_INTERRUPT_HALF_TRANSFER) == 1){
-        // Clear the half transfer flag
-        DMA_enuClearFlag(dmaController, stream, DMA_INTERRUPT_HALF_TRANSFER);
-
-        // Call the registered callback function
-        if(dmaCallbacks[dmaController][stream][DMA_INTERRUPT_HALF_TRANSFER] != 0){
-            dmaCallbacks[dmaController][stream][DMA_INTERRUPT_HALF_TRANSFER]();
-        }
+    // One read of the status register, the stream flags brought to bit 0
+    if(stream < DMA_STREAM4){
+        pending = (dmaReg->LISR >> offset) & DMA_STREAM_FLAGS_MASK;
+    }else{
+        pending = (dmaReg->HISR >> offset) & DMA_STREAM_FLAGS_MASK;
     }
 
-    if(DMA_u8ReadFlag(dmaController, stream, DMA_INTERRUPT_TRANSFER_ERROR) == 1){
-        // Clear the transfer error flag
-        DMA_enuClearFlag(dmaController, stream, DMA_INTERRUPT_TRANSFER_ERROR);
+    if((0U == (pending & BITS_MASK(flagsPositions[DMA_INTERRUPT_TRANSFER_ERROR])))
+       && (FAULT_INJECT(FAULT_POINT_DMA_TRANSFER, (dmaController << 3) | stream) != 0)){
+        pending |= BITS_MASK(flagsPositions[DMA_INTERRUPT_TRANSFER_ERROR]);
+    }
+    if((0U == (pending & BITS_MASK(flagsPositions[DMA_INTERRUPT_FIFO_ERROR])))
+       && (FAULT_INJECT(FAULT_POINT_DMA_FIFO, (dmaController << 3) | stream) != 0)){
+        pending |= BITS_MASK(flagsPositions[DMA_INTERRUPT_FIFO_ERROR]);
+    }
 
-        // Call the registered callback function
-        if(dmaCallbacks[dmaController][stream][DMA_INTERRUPT_TRANSFER_ERROR] != 0){
-            dmaCallbacks[dmaController][stream][DMA_INTERRUPT_TRANSFER_ERROR]();
-        }
+    // Clear every raised flag with one store (the clear register reads as 0)
+    if(stream < DMA_STREAM4){
+        dmaReg->LIFCR = pending << offset;
+    }else{
+        dmaReg->HIFCR = pending << offset;
     }
 
-    if(DMA_u8ReadFlag(dmaController, stream, DMA_INTERRUPT_DIRECT_MODE_ERROR) == 1){
-        // Clear the direct mode error flag
-        DMA_enuClearFlag(dmaController, stream, DMA_INTERRUPT_DIRECT_MODE_ERROR);
+    // Highest flag first : transmission complete, half transfer, transfer error, direct mode error, FIFO error
+    while(0U != pending){
+        flag = 31U - BITS_u32Clz(pending);
+        pending &= ~BITS_MASK(flag);
+        interrupt = flagsInterrupts[flag];
 
-        // Call the registered callback function
-        if(dmaCallbacks[dmaController][stream][DMA_INTERRUPT_DIRECT_MODE_ERROR] != 0){
-            dmaCallbacks[dmaController][stream][DMA_INTERRUPT_DIRECT_MODE_ERROR]();
+        if(DMA_INTERRUPT_TRANSMISSION_COMPLETE == interrupt){
+            TRACE_EVENT(TRACE_EVENT_DMA_COMPLETE, (dmaController << 3) | stream);
+        }else if(DMA_INTERRUPT_HALF_TRANSFER == interrupt){
+            TRACE_EVENT(TRACE_EVENT_DMA_HALF, (dmaController << 3) | stream);
+        }else{
+            // no trace event for the error flags
         }
-    }
-
-    if(DMA_u8ReadFlag(dmaController, stream, DMA_INTERRUPT_FIFO_ERROR) == 1){
-        // Clear the FIFO error flag
-        DMA_enuClearFlag(dmaController, stream, DMA_INTERRUPT_FIFO_ERROR);
 
         // Call the registered callback function
-        if(dmaCallbacks[dmaController][stream][DMA_INTERRUPT_FIFO_ERROR] != 0){
-            dmaCallbacks[dmaController][stream][DMA_INTERRUPT_FIFO_ERROR]();
+        if(dmaCallbacks[dmaController][stream][interrupt] != 0){
+            dmaCallbacks[dmaController][stream][interrupt]();
         }
     }
+
+    TRACE_EVENT(TRACE_EVENT_ISR_EXIT, TRACE_SOURCE_DMA | (dmaController << 3) | stream);
 }
 
-void DMA1_Stream0_IRQHandler(void) {
+RAMFUNC void DMA1_Stream0_IRQHandler(void) {
     DMA_Local_Handler(DMA1, DMA_STREAM0);
 }
 
 
-void DMA2_Stream0_IRQHandler(void) {
+RAMFUNC void DMA2_Stream0_IRQHandler(void) {
     DMA_Local_Handler(DMA2, DMA_STREAM0);
 }
 
-void DMA1_Stream1_IRQHandler(void) {
+RAMFUNC void DMA1_Stream1_IRQHandler(void) {
     DMA_Local_Handler(DMA1, DMA_STREAM1);
 }
 
-void DMA2_Stream1_IRQHandler(void) {
+RAMFUNC void DMA2_Stream1_IRQHandler(void) {
     DMA_Local_Handler(DMA2, DMA_STREAM1);
 }
 
-void DMA1_Stream2_IRQHandler(void) {
+RAMFUNC void DMA1_Stream2_IRQHandler(void) {
     DMA_Local_Handler(DMA1, DMA_STREAM2);
 }
 
 
-void DMA2_Stream2_IRQHandler(void) {
+RAMFUNC void DMA2_Stream2_IRQHandler(void) {
     DMA_Local_Handler(DMA2, DMA_STREAM2);
 }
 
 
-void DMA1_Stream3_IRQHandler(void) {
+RAMFUNC void DMA1_Stream3_IRQHandler(void) {
     DMA_Local_Handler(DMA1, DMA_STREAM3);
 }
 
 
-void DMA2_Stream3_IRQHandler(void) {
+RAMFUNC void DMA2_Stream3_IRQHandler(void) {
     DMA_Local_Handler(DMA2, DMA_STREAM3);
 }
 
 
-void DMA1_Stream4_IRQHandler(void) {
+RAMFUNC void DMA1_Stream4_IRQHandler(void) {
     DMA_Local_Handler(DMA1, DMA_STREAM4);
 }
 
 
-void DMA2_Stream4_IRQHandler(void) {
+RAMFUNC void DMA2_Stream4_IRQHandler(void) {
     DMA_Local_Handler(DMA2, DMA_STREAM4);
 }
 
 
-void DMA1_Stream5_IRQHandler(void) {
+RAMFUNC void DMA1_Stream5_IRQHandler(void) {
     DMA_Local_Handler(DMA1, DMA_STREAM5);
 }
 
 
-void DMA2_Stream5_IRQHandler(void) {
+RAMFUNC void DMA2_Stream5_IRQHandler(void) {
     DMA_Local_Handler(DMA2, DMA_STREAM5);
 }
 
 
-void DMA1_Stream6_IRQHandler(void) {
+RAMFUNC void DMA1_Stream6_IRQHandler(void) {
     DMA_Local_Handler(DMA1, DMA_STREAM6);
 }
 
-void DMA2_Stream6_IRQHandler(void) {
+RAMFUNC void DMA2_Stream6_IRQHandler(void) {
     DMA_Local_Handler(DMA2, DMA_STREAM6);
 }
 
-void DMA1_Stream7_IRQHandler(void) {
+RAMFUNC void DMA1_Stream7_IRQHandler(void) {
     DMA_Local_Handler(DMA1, DMA_STREAM7);
 }
 
-void DMA2_Stream7_IRQHandler(void) {
+RAMFUNC void DMA2_Stream7_IRQHandler(void) {
     DMA_Local_Handler(DMA2, DMA_STREAM7);
 }
 
@@ -0,0 +1,400 @@
+/******************************************************************************
+ * @file    FLASH.C
+ * @author  Eng.Gemy
+ * @brief   FLASH Interface Driver Implementation File
+ *          Wait states, prefetch buffer and ART accelerator configuration,
+ *          sector erase and word programming
+ ******************************************************************************/
+
+#include "LIB/stdtypes.h"
+
+#include "MCAL/FLASH_Driver/flash_priv.h"
+#include "MCAL/FLASH_Driver/flash.h"
+
+/*
+ * Linker script symbol
+ * _sapp : first address of the application image (ORIGIN(FLASH))
+ */
+extern uint32_t _sapp;
+
+/* HCLK covered by one wait state, indexed by FLASH_VoltageRange_t */
+static const uint32_t FLASH_WaitStateStep[] = {30000000UL, 24000000UL, 18000000UL, 16000000UL};
+
+/* First address and size of each sector */
+static const uint32_t FLASH_SectorAddress[FLASH_NUMBER_OF_SECTORS] = {
+    0x08000000UL, 0x08004000UL, 0x08008000UL, 0x0800C000UL, 0x08010000UL, 0x08020000UL
+};
+static const uint32_t FLASH_SectorSize[FLASH_NUMBER_OF_SECTORS] = {
+    0x4000UL, 0x4000UL, 0x4000UL, 0x4000UL, 0x10000UL, 0x20000UL
+};
+
+static void FLASH_vdUnlock(void);
+static void FLASH_vdLock(void);
+static FLASH_Status_t FLASH_enuWaitReady(uint32_t timeout);
+static void FLASH_vdFlushDataCache(void);
+static uint8_t FLASH_u8GetSector(uint32_t address);
+static bool_t FLASH_boolIsProtected(uint8_t firstSector, uint8_t lastSector);
+
+/**
+ * @brief Compute the wait states needed for a given HCLK
+ *
+ * WS = ceil(HCLK / step) - 1 where step is the HCLK range covered by one
+ * wait state at the given supply voltage.
+ *
+ * @author Eng.Gemy
+ */
+FLASH_Status_t FLASH_enuCalculateLatency(uint32_t hclkHz, FLASH_VoltageRange_t voltageRange, uint8_t* waitStates)
+{
+    FLASH_Status_t status = FLASH_NOT_OK;
+
+    if (NULL == waitStates)
+    {
+        status = FLASH_NULL_PTR;
+    }
+    else if (voltageRange > FLASH_VOLTAGE_1V8_TO_2V1)
+    {
+        status = FLASH_WRONG_VOLTAGE_RANGE;
+    }
+    else if ((0 == hclkHz) || (hclkHz > FLASH_HCLK_MAX))
+    {
+        status = FLASH_WRONG_FREQUENCY;
+    }
+    else
+    {
+        uint32_t step = FLASH_WaitStateStep[voltageRange];
+        *waitStates = (uint8_t)(((hclkHz + step - 1) / step) - 1);
+        status = FLASH_OK;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Program the wait states for a given HCLK
+ *
+ * LATENCY is read back: the new value only applies once the read returns it,
+ * and the clock must not be raised before that.
+ *
+ * @author Eng.Gemy
+ */
+FLASH_Status_t FLASH_enuSetLatency(uint32_t hclkHz, FLASH_VoltageRange_t voltageRange)
+{
+    uint8_t waitStates = 0;
+    FLASH_Status_t status = FLASH_enuCalculateLatency(hclkHz, voltageRange, &waitStates);
+
+    if (FLASH_OK == status)
+    {
+        FLASH_Registers->ACR = (FLASH_Registers->ACR & ~FLASH_ACR_LATENCY_MASK) | waitStates;
+
+        if ((FLASH_Registers->ACR & FLASH_ACR_LATENCY_MASK) != waitStates)
+        {
+            status = FLASH_LATENCY_NOT_APPLIED;
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Read the current number of wait states
+ * @author Eng.Gemy
+ */
+FLASH_Status_t FLASH_enuGetLatency(uint8_t* waitStates)
+{
+    FLASH_Status_t status = FLASH_NOT_OK;
+
+    if (NULL == waitStates)
+    {
+        status = FLASH_NULL_PTR;
+    }
+    else
+    {
+        *waitStates = (uint8_t)(FLASH_Registers->ACR & FLASH_ACR_LATENCY_MASK);
+        status = FLASH_OK;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Enable the selected accelerator features and disable the others
+ *
+ * Sequence: disable all features, reset both caches (reset bits only work
+ * while the cache is disabled), release the resets, enable the features.
+ *
+ * @author Eng.Gemy
+ */
+FLASH_Status_t FLASH_enuConfigureAccelerator(uint32_t features, FLASH_VoltageRange_t voltageRange)
+{
+    FLASH_Status_t status = FLASH_NOT_OK;
+
+    if (0 != (features & ~FLASH_ALL_FEATURES))
+    {
+        status = FLASH_WRONG_FEATURES;
+    }
+    else if (voltageRange > FLASH_VOLTAGE_1V8_TO_2V1)
+    {
+        status = FLASH_WRONG_VOLTAGE_RANGE;
+    }
+    else if ((FLASH_VOLTAGE_1V8_TO_2V1 == voltageRange) && (0 != (features & FLASH_PREFETCH_ENABLE)))
+    {
+        status = FLASH_PREFETCH_NOT_ALLOWED;
+    }
+    else
+    {
+        /* Caches off, then flush them */
+        FLASH_Registers->ACR &= ~FLASH_ACR_FEATURES_MASK;
+        FLASH_Registers->ACR |= (FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+        FLASH_Registers->ACR &= ~(FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+
+        /* Enable the requested features */
+        FLASH_Registers->ACR |= features;
+        status = FLASH_OK;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Get the start address and size of a sector
+ * @author Eng.Gemy
+ */
+FLASH_Status_t FLASH_enuGetSectorInfo(uint8_t sector, uint32_t* address, uint32_t* size)
+{
+    FLASH_Status_t status = FLASH_NOT_OK;
+
+    if ((NULL == address) || (NULL == size))
+    {
+        status = FLASH_NULL_PTR;
+    }
+    else if (sector >= FLASH_NUMBER_OF_SECTORS)
+    {
+        status = FLASH_WRONG_SECTOR;
+    }
+    else
+    {
+        *address = FLASH_SectorAddress[sector];
+        *size = FLASH_SectorSize[sector];
+        status = FLASH_OK;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Erase one sector
+ *
+ * Sequence: unlock CR, wait for BSY = 0, clear old error flags, select
+ * the sector with SER + SNB at x32 parallelism, STRT, wait for BSY = 0,
+ * check the error flags, clear SER and lock CR again.
+ *
+ * @author Eng.Gemy
+ */
+FLASH_Status_t FLASH_enuEraseSector(uint8_t sector)
+{
+    FLASH_Status_t status = FLASH_NOT_OK;
+
+    if (sector >= FLASH_NUMBER_OF_SECTORS)
+    {
+        status = FLASH_WRONG_SECTOR;
+    }
+    else if (TRUE == FLASH_boolIsProtected(sector, sector))
+    {
+        status = FLASH_SECTOR_PROTECTED;
+    }
+    else
+    {
+        FLASH_vdUnlock();
+        status = FLASH_enuWaitReady(FLASH_PROGRAM_TIMEOUT);
+
+        if (FLASH_OK == status)
+        {
+            FLASH_Registers->SR = FLASH_SR_ERRORS | FLASH_SR_EOP;
+            FLASH_Registers->CR = (FLASH_Registers->CR & ~(FLASH_CR_PSIZE_MASK | FLASH_CR_SNB_MASK | FLASH_CR_PG))
+                                | FLASH_CR_PSIZE_X32 | FLASH_CR_SER | ((uint32_t)sector << FLASH_CR_SNB_POS);
+            FLASH_Registers->CR |= FLASH_CR_STRT;
+
+            status = FLASH_enuWaitReady(FLASH_ERASE_TIMEOUT);
+            FLASH_Registers->CR &= ~(FLASH_CR_SER | FLASH_CR_SNB_MASK);
+        }
+
+        FLASH_vdLock();
+        FLASH_vdFlushDataCache();
+    }
+
+    return status;
+}
+
+/**
+ * @brief Program words and verify them
+ *
+ * PG stays set for the whole buffer, each word write starts one program
+ * operation that has to end (BSY = 0) before the next one.
+ *
+ * @author Eng.Gemy
+ */
+FLASH_Status_t FLASH_enuProgram(uint32_t address, const uint32_t* data, uint32_t wordCount)
+{
+    FLASH_Status_t status = FLASH_NOT_OK;
+    volatile uint32_t* destination = (volatile uint32_t*)address;
+    uint32_t index;
+
+    if (NULL == data)
+    {
+        status = FLASH_NULL_PTR;
+    }
+    else if ((0 != (address & 0x3UL)) || (address < FLASH_MAIN_MEMORY_START) || (address >= FLASH_MAIN_MEMORY_END) ||
+             (wordCount > ((FLASH_MAIN_MEMORY_END - address) / 4UL)))
+    {
+        status = FLASH_WRONG_ADDRESS;
+    }
+    else if ((0UL != wordCount) &&
+             (TRUE == FLASH_boolIsProtected(FLASH_u8GetSector(address), FLASH_u8GetSector(address + (wordCount * 4UL) - 1UL))))
+    {
+        status = FLASH_SECTOR_PROTECTED;
+    }
+    else
+    {
+        FLASH_vdUnlock();
+        status = FLASH_enuWaitReady(FLASH_PROGRAM_TIMEOUT);
+
+        if (FLASH_OK == status)
+        {
+            FLASH_Registers->SR = FLASH_SR_ERRORS | FLASH_SR_EOP;
+            FLASH_Registers->CR = (FLASH_Registers->CR & ~(FLASH_CR_PSIZE_MASK | FLASH_CR_SER | FLASH_CR_SNB_MASK))
+                                | FLASH_CR_PSIZE_X32 | FLASH_CR_PG;
+
+            for (index = 0; (index < wordCount) && (FLASH_OK == status); index++)
+            {
+                destination[index] = data[index];
+                __asm volatile ("DSB" ::: "memory");
+                status = FLASH_enuWaitReady(FLASH_PROGRAM_TIMEOUT);
+            }
+
+            FLASH_Registers->CR &= ~FLASH_CR_PG;
+        }
+
+        FLASH_vdLock();
+        FLASH_vdFlushDataCache();
+
+        /* Read back through the flushed cache */
+        for (index = 0; (index < wordCount) && (FLASH_OK == status); index++)
+        {
+            if (destination[index] != data[index])
+            {
+                status = FLASH_VERIFY_ERROR;
+            }
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Write the key sequence if CR is locked
+ * @author Eng.Gemy
+ */
+static void FLASH_vdUnlock(void)
+{
+    if (0 != (FLASH_Registers->CR & FLASH_CR_LOCK))
+    {
+        FLASH_Registers->KEYR = FLASH_KEY1;
+        FLASH_Registers->KEYR = FLASH_KEY2;
+    }
+}
+
+/**
+ * @brief Lock CR until the next key sequence
+ * @author Eng.Gemy
+ */
+static void FLASH_vdLock(void)
+{
+    FLASH_Registers->CR |= FLASH_CR_LOCK;
+}
+
+/**
+ * @brief Wait for the end of the running operation and check its error flags
+ * @author Eng.Gemy
+ */
+static FLASH_Status_t FLASH_enuWaitReady(uint32_t timeout)
+{
+    FLASH_Status_t status = FLASH_OK;
+
+    while ((0 != (FLASH_Registers->SR & FLASH_SR_BSY)) && (0 != timeout))
+    {
+        timeout--;
+    }
+
+    if (0 != (FLASH_Registers->SR & FLASH_SR_BSY))
+    {
+        status = FLASH_TIMEOUT;
+    }
+    else if (0 != (FLASH_Registers->SR & FLASH_SR_ERRORS))
+    {
+        FLASH_Registers->SR = FLASH_SR_ERRORS;
+        status = FLASH_PROGRAM_ERROR;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Drop the ART data cache lines so reads see the new flash content
+ * @details DCRST only works while DCEN = 0, DCEN is restored afterwards
+ * @author Eng.Gemy
+ */
+static void FLASH_vdFlushDataCache(void)
+{
+    if (0 != (FLASH_Registers->ACR & FLASH_DCACHE_ENABLE))
+    {
+        FLASH_Registers->ACR &= ~FLASH_DCACHE_ENABLE;
+        FLASH_Registers->ACR |= FLASH_ACR_DCRST;
+        FLASH_Registers->ACR &= ~FLASH_ACR_DCRST;
+        FLASH_Registers->ACR |= FLASH_DCACHE_ENABLE;
+    }
+}
+
+/**
+ * @brief Sector holding an address of the main memory
+ * @details Addresses below the main memory give sector 0, above it the last sector
+ * @author Eng.Gemy
+ */
+static uint8_t FLASH_u8GetSector(uint32_t address)
+{
+    uint8_t sector = 0;
+
+    while (((sector + 1U) < FLASH_NUMBER_OF_SECTORS) && (address >= FLASH_SectorAddress[sector + 1U]))
+    {
+        sector++;
+    }
+
+    return sector;
+}
+
+/**
+ * @brief Check a range of sectors against the bootloader and the running application
+ * @details The running application is the image whose vector table VTOR points to.
+ *          A table outside the main memory (copied to SRAM by NVIC_RelocateVectorTable,
+ *          or the alias at 0) does not tell where the image is : the linked image (_sapp)
+ *          is protected instead
+ * @author Eng.Gemy
+ */
+static bool_t FLASH_boolIsProtected(uint8_t firstSector, uint8_t lastSector)
+{
+    uint32_t vectorTable = FLASH_SCB_VTOR;
+    uint8_t runningSector;
+    bool_t protectedSector = FALSE;
+
+    if ((vectorTable < FLASH_MAIN_MEMORY_START) || (vectorTable >= FLASH_MAIN_MEMORY_END))
+    {
+        vectorTable = (uint32_t)&_sapp;
+    }
+    runningSector = FLASH_u8GetSector(vectorTable);
+
+    if ((firstSector < FLASH_BOOT_SECTORS) || ((firstSector <= runningSector) && (runningSector <= lastSector)))
+    {
+        protectedSector = TRUE;
+    }
+
+    return protectedSector;
+}
@@ -13,6 +13,7 @@
 #include "./MCAL/GPIO_Driver/gpio_cfg.h"
 #include "./MCAL/GPIO_Driver/gpio_priv.h"
 #include "./MCAL/GPIO_Driver/gpio_int.h"
+#include "./OS/wave.h"
 
 /******************************************************************************
  * @brief GPIO Base Addresses Array
@@ -175,6 +176,7 @@ GPIO_Status_t GPIO_enuSetPinVal(GPIO_Port_t port,GPIO_Pin_t pin,GPIO_Val_t val){
                  * If val=GPIO_LOW (16): (1<<pin)<<16 sets BR[pin] -> resets pin LOW
                  */
                 ((GPIO_Registers_t *)(GPIO_Base_Addreses[port]))->BSRR.ALL_FIELDS  |= ((1 << pin) << val);
+                WAVE_GPIO(port, ((GPIO_Registers_t *)(GPIO_Base_Addreses[port]))->ODR.ALL_FIELDS);
                 status = GPIO_OK;
             }
         }
@@ -218,6 +220,7 @@ GPIO_Status_t GPIO_enuFlipPinVal(GPIO_Port_t port,GPIO_Pin_t pin){
              * XOR with 1 flips the bit: 0^1=1, 1^1=0
              */  
             ((GPIO_Registers_t *)(GPIO_Base_Addreses[port]))->ODR.ALL_FIELDS  ^= (1 << pin);
+            WAVE_GPIO(port, ((GPIO_Registers_t *)(GPIO_Base_Addreses[port]))->ODR.ALL_FIELDS);
         }
     }
 
@@ -553,6 +556,89 @@ GPIO_Status_t GPIO_enuSetPinSpeed(GPIO_Port_t port,GPIO_Pin_t pin,GPIO_Speed_t s
     return status; 
 }
 
+/******************************************************************************
+ * @brief Apply a build-time checked port image
+ * @details The image comes from GPIO_IMAGE_DECLARE : its fields were checked
+ *          by _Static_assert and folded into register values, so applying it
+ *          is one read-modify-write per register for all its pins at once
+ *
+ * @param[in] image Pointer to the port image
+ *
+ * @return GPIO_Status_t Status of the operation
+ * @retval GPIO_OK              Image applied
+ * @retval GPIO_NULL_PTR        Null pointer passed
+ * @retval GPIO_WRONG_PORT      Invalid port value
+ *
+ * @note Unlike GPIO_enuInit the fields of the pins are cleared before being
+ *       set, re-applying an image over another configuration is safe
+ * @warning Ensure GPIO clock is enabled before calling this function
+ * @author Eng.Gemy
+ ******************************************************************************/
+GPIO_Status_t GPIO_enuApplyImage(const GPIO_Image_t * image){
+
+    /* Local variable to hold function return status */
+    GPIO_Status_t status = GPIO_NOT_OK;
+
+    /* Check if image pointer is NULL */
+    if(NULL == image){
+        status = GPIO_NULL_PTR;
+    }else{
+        /* Validate port parameter (the image may be a RAM copy) */
+        if(image->Port > GPIO_PORT_MASK_CHECK){
+            status = GPIO_WRONG_PORT;
+        }else{
+            GPIO_Registers_t * regs = (GPIO_Registers_t *)(GPIO_Base_Addreses[image->Port]);
+
+            /* Clear the fields of the image pins, then set their values */
+            regs->MODER.ALL_FIELDS   = (regs->MODER.ALL_FIELDS   & ~(image->WideMask)) | image->MODER;
+            regs->OTYPER.ALL_FIELDS  = (regs->OTYPER.ALL_FIELDS  & ~(image->PinMask))  | image->OTYPER;
+            regs->OSPEEDR.ALL_FIELDS = (regs->OSPEEDR.ALL_FIELDS & ~(image->WideMask)) | image->OSPEEDR;
+            regs->PUPDR.ALL_FIELDS   = (regs->PUPDR.ALL_FIELDS   & ~(image->WideMask)) | image->PUPDR;
+            regs->AFRL.ALL_FIELDS    = (regs->AFRL.ALL_FIELDS    & ~(image->AfrlMask)) | image->AFRL;
+            regs->AFRH.ALL_FIELDS    = (regs->AFRH.ALL_FIELDS    & ~(image->AfrhMask)) | image->AFRH;
+            status = GPIO_OK;
+        }
+    }
+
+    /* Return status of operation */
+    return status;
+}
+
+/******************************************************************************
+ * @brief Set and reset several pins of a port with one BSRR write
+ * @details The lower half of the word sets pins, the upper half resets them,
+ *          a precomputed word (see BOARD_NIBBLE_BSRR) drives a whole data bus
+ *          in one store instead of one GPIO_enuSetPinVal per line
+ *
+ * @param[in] port GPIO port (GPIO_PORT_A to GPIO_PORT_H)
+ * @param[in] bsrr BSRR word : BS[15:0] set, BR[31:16] reset
+ *
+ * @return GPIO_Status_t Status of the operation
+ * @retval GPIO_OK          Operation successful
+ * @retval GPIO_WRONG_PORT  Invalid port
+ *
+ * @note A pin both set and reset in the same word ends up set (BS wins)
+ * @author Eng.Gemy
+ ******************************************************************************/
+GPIO_Status_t GPIO_enuSetResetPins(GPIO_Port_t port, uint32_t bsrr){
+
+    /* Local variable to hold function return status */
+    GPIO_Status_t status = GPIO_NOT_OK;
+
+    /* Validate port parameter */
+    if(port > GPIO_PORT_MASK_CHECK){
+        status = GPIO_WRONG_PORT;
+    }else{
+        /* Plain store : BSRR reads as zero and only the written ones act */
+        ((GPIO_Registers_t *)(GPIO_Base_Addreses[port]))->BSRR.ALL_FIELDS = bsrr;
+        WAVE_GPIO(port, ((GPIO_Registers_t *)(GPIO_Base_Addreses[port]))->ODR.ALL_FIELDS);
+        status = GPIO_OK;
+    }
+
+    /* Return status of operation */
+    return status;
+}
+
 /******************************************************************************
  *                           END OF FILE
  * @author Eng.Gemy
@@ -0,0 +1,874 @@
+/******************************************************************************
+ * @file    I2C.C
+ * @author  Eng.Gemy
+ * @brief   I2C Master Driver Implementation File
+ *          Transaction queue per bus, event / error interrupt sequencing
+ *          (RM0368 18.3.3) and DMA phases on DMA1
+ ******************************************************************************/
+
+#include "LIB/stdtypes.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "HAL/MCU_Driver/mcu.h"
+#include "MCAL/GPIO_Driver/gpio_int.h"
+#include "MCAL/NVIC_Driver/nvic.h"
+#include "MCAL/NVIC_Driver/nvic_stm32f401cc.h"
+#include "MCAL/DMA_Driver/dma.h"
+
+#include "MCAL/I2C_Driver/i2c_priv.h"
+#include "MCAL/I2C_Driver/i2c.h"
+#include "MCAL/I2C_Driver/i2c_cfg.h"
+
+#if (I2C1_DMA == I2C_DMA_ENABLED) && (I2C2_DMA == I2C_DMA_ENABLED)
+#error "I2C1 and I2C2 share DMA1 stream 7 : enable DMA on one of them only"
+#endif
+
+typedef enum {
+    I2C_PHASE_IDLE = 0,
+    I2C_PHASE_WRITE,                /**< START or repeated START not sent yet, or TxBuffer on the bus */
+    I2C_PHASE_READ,                 /**< After the repeated START (or the START of a read alone) */
+}I2C_Phase_t;
+
+typedef struct {
+    I2C_Transaction_t  *Queue[I2C_QUEUE_LENGTH];
+    uint8_t             Head;       /**< Transaction on the bus when Current is not NULL */
+    uint8_t             Count;
+    I2C_Transaction_t  *Current;
+    uint16_t            Index;      /**< Bytes written or read in the current phase */
+    I2C_Phase_t         Phase;
+    bool_t              Addressed;  /**< ADDR of the current phase cleared */
+    bool_t              Initialized;
+    bool_t              ClocksOwned;
+    I2C_Speed_t         Speed;      /**< Kept to compute CCR / TRISE again after a clock change */
+    I2C_Status_t        ClockStatus;/**< I2C_CLOCK_ERROR when the running PCLK1 does not fit Speed */
+}I2C_Bus_t;
+
+typedef struct {
+    GPIO_Port_t                 SclPort;
+    GPIO_Pin_t                  SclPin;
+    GPIO_Port_t                 SdaPort;
+    GPIO_Pin_t                  SdaPin;
+    GPIO_AlternateFunction_t    AlternateFunction;
+}I2C_Pins_t;
+
+typedef struct {
+    DMA_Stream_t    Stream;
+    DMA_Channel_t   Channel;
+    NVIC_BP_IRQ_t   Irq;
+}I2C_DmaStream_t;
+
+static I2C_Bus_t I2C_Buses[I2C_NUMBER_OF_BUSES];
+
+static const I2C_Pins_t I2C_PinMap[I2C_NUMBER_OF_BUSES] = {
+    {GPIO_PORT_B, GPIO_PIN_6,  GPIO_PORT_B, GPIO_PIN_7, GPIO_AF4},
+    {GPIO_PORT_B, GPIO_PIN_10, GPIO_PORT_B, GPIO_PIN_3, GPIO_AF9},
+    {GPIO_PORT_A, GPIO_PIN_8,  GPIO_PORT_B, GPIO_PIN_4, GPIO_AF9},
+};
+
+static const uint64_t I2C_ClockMask[I2C_NUMBER_OF_BUSES] = {
+    RCC_APB1_I2C1_CLOCK, RCC_APB1_I2C2_CLOCK, RCC_APB1_I2C3_CLOCK
+};
+static const uint64_t I2C_PortClockMask[I2C_NUMBER_OF_BUSES] = {
+    RCC_AHB1_GPIOB_CLOCK, RCC_AHB1_GPIOB_CLOCK, RCC_AHB1_GPIOA_CLOCK | RCC_AHB1_GPIOB_CLOCK
+};
+
+static const NVIC_BP_IRQ_t I2C_EventIrq[I2C_NUMBER_OF_BUSES] = {NVIC_I2C1_EV_IRQ, NVIC_I2C2_EV_IRQ, NVIC_I2C3_EV_IRQ};
+static const NVIC_BP_IRQ_t I2C_ErrorIrq[I2C_NUMBER_OF_BUSES] = {NVIC_I2C1_ER_IRQ, NVIC_I2C2_ER_IRQ, NVIC_I2C3_ER_IRQ};
+
+static const uint8_t I2C_DmaEnabled[I2C_NUMBER_OF_BUSES] = {I2C1_DMA, I2C2_DMA, I2C3_DMA};
+static const I2C_DmaStream_t I2C_DmaTx[I2C_NUMBER_OF_BUSES] = {
+    {DMA_STREAM7, DMA_CHANNEL1, NVIC_DMA1_STREAM7_IRQ},
+    {DMA_STREAM7, DMA_CHANNEL7, NVIC_DMA1_STREAM7_IRQ},
+    {DMA_STREAM4, DMA_CHANNEL3, NVIC_DMA1_STREAM4_IRQ},
+};
+static const I2C_DmaStream_t I2C_DmaRx[I2C_NUMBER_OF_BUSES] = {
+    {DMA_STREAM0, DMA_CHANNEL1, NVIC_DMA1_STREAM0_IRQ},
+    {DMA_STREAM3, DMA_CHANNEL7, NVIC_DMA1_STREAM3_IRQ},
+    {DMA_STREAM2, DMA_CHANNEL3, NVIC_DMA1_STREAM2_IRQ},
+};
+
+static I2C_Status_t I2C_enuSetTiming(I2C_Regs_t *regs, I2C_Speed_t speed);
+static I2C_Status_t I2C_enuInitPins(I2C_Number_t bus);
+static I2C_Status_t I2C_enuInitDma(I2C_Number_t bus);
+static void I2C_vdStartDma(const I2C_DmaStream_t *dma, uint32_t memoryAddress, uint16_t length);
+static bool_t I2C_boolUseDma(I2C_Number_t bus, uint16_t length);
+static void I2C_vdStartNext(I2C_Number_t bus);
+static void I2C_vdAddressAcknowledged(I2C_Number_t bus);
+static void I2C_vdFinish(I2C_Number_t bus, I2C_Result_t result);
+static void I2C_vdEventHandler(I2C_Number_t bus);
+static void I2C_vdErrorHandler(I2C_Number_t bus);
+static void I2C_vdDmaTxComplete(I2C_Number_t bus);
+static void I2C_vdDmaRxComplete(I2C_Number_t bus);
+
+/* DMA callbacks carry no argument : one per bus and direction */
+static void I2C1_vdDmaTxCallback(void) { I2C_vdDmaTxComplete(I2C_1); }
+static void I2C2_vdDmaTxCallback(void) { I2C_vdDmaTxComplete(I2C_2); }
+static void I2C3_vdDmaTxCallback(void) { I2C_vdDmaTxComplete(I2C_3); }
+static void I2C1_vdDmaRxCallback(void) { I2C_vdDmaRxComplete(I2C_1); }
+static void I2C2_vdDmaRxCallback(void) { I2C_vdDmaRxComplete(I2C_2); }
+static void I2C3_vdDmaRxCallback(void) { I2C_vdDmaRxComplete(I2C_3); }
+
+static const DMA_CallBack_t I2C_DmaTxCallbacks[I2C_NUMBER_OF_BUSES] = {
+    I2C1_vdDmaTxCallback, I2C2_vdDmaTxCallback, I2C3_vdDmaTxCallback
+};
+static const DMA_CallBack_t I2C_DmaRxCallbacks[I2C_NUMBER_OF_BUSES] = {
+    I2C1_vdDmaRxCallback, I2C2_vdDmaRxCallback, I2C3_vdDmaRxCallback
+};
+
+/**
+ * @brief Configure a bus as master
+ *
+ * The peripheral is reset first (SWRST): a BUSY flag left by a glitch or a
+ * debugger halt mid-transfer would otherwise block every START.
+ *
+ * @author Eng.Gemy
+ */
+I2C_Status_t I2C_enuInit(const I2C_Config_t *config)
+{
+    I2C_Status_t status = I2C_NOT_OK;
+
+    if (NULL == config)
+    {
+        status = I2C_NULL_PTR;
+    }
+    else if (config->I2C_Number > I2C_3)
+    {
+        status = I2C_WRONG_I2C_NUMBER;
+    }
+    else if (config->I2C_Speed > I2C_SPEED_FAST_400K)
+    {
+        status = I2C_WRONG_SPEED;
+    }
+    else
+    {
+        I2C_Number_t bus = config->I2C_Number;
+        I2C_Regs_t *regs = I2C_Registers[bus];
+
+        status = I2C_OK;
+        if (FALSE == I2C_Buses[bus].ClocksOwned)
+        {
+            if (RCC_AcquirePeripheralClock(RCC_AHB1_BUS, I2C_PortClockMask[bus]) != RCC_OK)
+            {
+                status = I2C_CLOCK_ERROR;
+            }
+            else if (RCC_AcquirePeripheralClock(RCC_APB1_BUS, I2C_ClockMask[bus]) != RCC_OK)
+            {
+                (void)RCC_ReleasePeripheralClock(RCC_AHB1_BUS, I2C_PortClockMask[bus]);
+                status = I2C_CLOCK_ERROR;
+            }
+            else
+            {
+                I2C_Buses[bus].ClocksOwned = TRUE;
+            }
+        }
+
+        if (I2C_OK == status)
+        {
+            status = I2C_enuInitPins(bus);
+        }
+
+        if (I2C_OK == status)
+        {
+            regs->CR1 = I2C_CR1_SWRST;
+            regs->CR1 = 0;
+            status = I2C_enuSetTiming(regs, config->I2C_Speed);
+        }
+
+        if ((I2C_OK == status) && (I2C_DMA_ENABLED == I2C_DmaEnabled[bus]))
+        {
+            status = I2C_enuInitDma(bus);
+        }
+
+        if (I2C_OK == status)
+        {
+            I2C_Buses[bus].Head = 0;
+            I2C_Buses[bus].Count = 0;
+            I2C_Buses[bus].Current = NULL;
+            I2C_Buses[bus].Phase = I2C_PHASE_IDLE;
+            I2C_Buses[bus].Speed = config->I2C_Speed;
+            I2C_Buses[bus].ClockStatus = I2C_OK;
+            regs->CR1 = I2C_CR1_PE;
+
+            (void)NVIC_BP_SetPriority(I2C_EventIrq[bus], I2C_INTERRUPT_PRIORITY);
+            (void)NVIC_BP_SetPriority(I2C_ErrorIrq[bus], I2C_INTERRUPT_PRIORITY);
+            (void)NVIC_BP_EnableIRQ(I2C_EventIrq[bus]);
+            (void)NVIC_BP_EnableIRQ(I2C_ErrorIrq[bus]);
+            I2C_Buses[bus].Initialized = TRUE;
+
+            (void)MCU_enuRegisterClockNotifier(I2C_vdClockChangeNotifier);
+            (void)MCU_enuRegisterClockGuard(I2C_u8ClockChangeBusy);
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Queue a transaction, it starts at once when the bus is idle
+ *
+ * The queue is shared with the interrupts that pop it: it is only touched
+ * inside NVIC_EnterCritical(), which also works from a completion callback.
+ *
+ * @author Eng.Gemy
+ */
+I2C_Status_t I2C_enuSubmit(I2C_Number_t bus, I2C_Transaction_t *transaction)
+{
+    I2C_Status_t status = I2C_NOT_OK;
+
+    if (NULL == transaction)
+    {
+        status = I2C_NULL_PTR;
+    }
+    else if (bus > I2C_3)
+    {
+        status = I2C_WRONG_I2C_NUMBER;
+    }
+    else if (FALSE == I2C_Buses[bus].Initialized)
+    {
+        status = I2C_NOT_INIT;
+    }
+    else if (I2C_OK != I2C_Buses[bus].ClockStatus)
+    {
+        status = I2C_Buses[bus].ClockStatus;
+    }
+    else if (transaction->I2C_Address > 0x7FU)
+    {
+        status = I2C_WRONG_ADDRESS;
+    }
+    else if ((0U == transaction->I2C_TxLength) && (0U == transaction->I2C_RxLength))
+    {
+        status = I2C_WRONG_LENGTH;
+    }
+    else if (((0U != transaction->I2C_TxLength) && (NULL == transaction->I2C_TxBuffer)) ||
+             ((0U != transaction->I2C_RxLength) && (NULL == transaction->I2C_RxBuffer)))
+    {
+        status = I2C_NULL_PTR;
+    }
+    else
+    {
+        I2C_Bus_t *state = &I2C_Buses[bus];
+
+        NVIC_EnterCritical();
+        if (state->Count >= I2C_QUEUE_LENGTH)
+        {
+            status = I2C_QUEUE_FULL;
+        }
+        else
+        {
+            transaction->I2C_Result = I2C_RESULT_PENDING;
+            state->Queue[(state->Head + state->Count) % I2C_QUEUE_LENGTH] = transaction;
+            state->Count++;
+            if (NULL == state->Current)
+            {
+                I2C_vdStartNext(bus);
+            }
+            status = I2C_OK;
+        }
+        NVIC_ExitCritical();
+    }
+
+    return status;
+}
+
+/**
+ * @brief Queue a transaction and wait for its end
+ * @author Eng.Gemy
+ */
+I2C_Status_t I2C_enuTransferSync(I2C_Number_t bus, I2C_Transaction_t *transaction)
+{
+    I2C_Status_t status = I2C_enuSubmit(bus, transaction);
+
+    if (I2C_OK == status)
+    {
+        while (I2C_RESULT_PENDING == transaction->I2C_Result);
+        if (I2C_RESULT_OK != transaction->I2C_Result)
+        {
+            status = I2C_TRANSFER_ERROR;
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Drop every queued transaction and reset the bus peripheral
+ *
+ * SWRST clears the timing registers too: they are saved and written back.
+ * Only the transactions queued on entry are dropped, a callback may queue
+ * a new one.
+ *
+ * @author Eng.Gemy
+ */
+I2C_Status_t I2C_enuAbort(I2C_Number_t bus)
+{
+    I2C_Status_t status = I2C_NOT_OK;
+
+    if (bus > I2C_3)
+    {
+        status = I2C_WRONG_I2C_NUMBER;
+    }
+    else if (FALSE == I2C_Buses[bus].Initialized)
+    {
+        status = I2C_NOT_INIT;
+    }
+    else
+    {
+        I2C_Bus_t *state = &I2C_Buses[bus];
+        I2C_Regs_t *regs = I2C_Registers[bus];
+
+        NVIC_EnterCritical();
+
+        uint32_t cr2 = regs->CR2 & I2C_CR2_FREQ_MASK;
+        uint32_t ccr = regs->CCR;
+        uint32_t trise = regs->TRISE;
+        uint8_t dropped = state->Count;
+        I2C_Transaction_t *aborted[I2C_QUEUE_LENGTH];
+
+        regs->CR2 = cr2;
+        if (I2C_DMA_ENABLED == I2C_DmaEnabled[bus])
+        {
+            (void)DMA_enuStopTransfer(DMA1, I2C_DmaTx[bus].Stream);
+            (void)DMA_enuStopTransfer(DMA1, I2C_DmaRx[bus].Stream);
+        }
+        regs->CR1 = I2C_CR1_SWRST;
+        regs->CR1 = 0;
+        regs->CR2 = cr2;
+        regs->CCR = ccr;
+        regs->TRISE = trise;
+        regs->CR1 = I2C_CR1_PE;
+
+        state->Current = NULL;
+        state->Phase = I2C_PHASE_IDLE;
+        for (uint8_t i = 0; i < dropped; i++)
+        {
+            aborted[i] = state->Queue[state->Head];
+            state->Head = (uint8_t)((state->Head + 1U) % I2C_QUEUE_LENGTH);
+            state->Count--;
+        }
+
+        // Queue already emptied : a callback submitting again starts a new transaction
+        for (uint8_t i = 0; i < dropped; i++)
+        {
+            aborted[i]->I2C_Result = I2C_RESULT_ABORTED;
+            if (NULL != aborted[i]->I2C_Callback)
+            {
+                aborted[i]->I2C_Callback(aborted[i]);
+            }
+        }
+        if ((NULL == state->Current) && (0U != state->Count))
+        {
+            I2C_vdStartNext(bus);
+        }
+
+        NVIC_ExitCritical();
+        status = I2C_OK;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Clock change notifier, registered by I2C_enuInit()
+ *
+ * CCR and TRISE are only written with PE cleared (RM0368 18.6.8), the guard
+ * keeps the queue empty during a switch. A bus whose speed does not fit the
+ * new PCLK1 refuses transactions until a clock that fits is back.
+ *
+ * @author Eng.Gemy
+ */
+void I2C_vdClockChangeNotifier(uint8_t phase)
+{
+    if (MCU_CLOCK_POST_CHANGE == phase)
+    {
+        for (uint8_t bus = 0; bus < I2C_NUMBER_OF_BUSES; bus++)
+        {
+            I2C_Bus_t *state = &I2C_Buses[bus];
+            I2C_Regs_t *regs = I2C_Registers[bus];
+
+            if ((TRUE == state->Initialized) && (0U == state->Count))
+            {
+                regs->CR1 = 0;
+                state->ClockStatus = I2C_enuSetTiming(regs, state->Speed);
+                regs->CR1 = I2C_CR1_PE;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Clock change guard, registered by I2C_enuInit()
+ * @details A transaction on the bus or in the queue was timed for the running PCLK1
+ * @author Eng.Gemy
+ */
+uint8_t I2C_u8ClockChangeBusy(void)
+{
+    uint8_t busy = 0U;
+
+    for (uint8_t bus = 0; bus < I2C_NUMBER_OF_BUSES; bus++)
+    {
+        if ((TRUE == I2C_Buses[bus].Initialized) && (0U != I2C_Buses[bus].Count))
+        {
+            busy = 1U;
+        }
+    }
+
+    return busy;
+}
+
+/******************************************************************************
+ *                        INTERRUPT HANDLERS
+ ******************************************************************************/
+void I2C1_EV_IRQHandler(void) { I2C_vdEventHandler(I2C_1); }
+void I2C1_ER_IRQHandler(void) { I2C_vdErrorHandler(I2C_1); }
+void I2C2_EV_IRQHandler(void) { I2C_vdEventHandler(I2C_2); }
+void I2C2_ER_IRQHandler(void) { I2C_vdErrorHandler(I2C_2); }
+void I2C3_EV_IRQHandler(void) { I2C_vdEventHandler(I2C_3); }
+void I2C3_ER_IRQHandler(void) { I2C_vdErrorHandler(I2C_3); }
+
+/******************************************************************************
+ *                        STATIC FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * FREQ = PCLK1 in MHz, CCR rounded up so the bus never runs above its rate
+ * Standard : PCLK1 / (2 x CCR)     Fast (DUTY = 0) : PCLK1 / (3 x CCR)
+ */
+static I2C_Status_t I2C_enuSetTiming(I2C_Regs_t *regs, I2C_Speed_t speed)
+{
+    I2C_Status_t status = I2C_OK;
+    uint32_t pclk1 = 0;
+    uint32_t freqMHz = 0;
+
+    if (RCC_GetClockHz(RCC_APB1_BUS, &pclk1) != RCC_OK)
+    {
+        status = I2C_CLOCK_ERROR;
+    }
+    else
+    {
+        freqMHz = pclk1 / 1000000UL;
+        if ((freqMHz > I2C_MAX_FREQ_MHZ) ||
+            (freqMHz < ((I2C_SPEED_FAST_400K == speed) ? I2C_MIN_FREQ_FAST_MHZ : I2C_MIN_FREQ_MHZ)))
+        {
+            status = I2C_CLOCK_ERROR;
+        }
+    }
+
+    if (I2C_OK == status)
+    {
+        uint32_t ccr;
+        uint32_t trise;
+
+        if (I2C_SPEED_STANDARD_100K == speed)
+        {
+            ccr = (pclk1 + (2UL * 100000UL) - 1UL) / (2UL * 100000UL);
+            if (ccr < I2C_STANDARD_MIN_CCR)
+            {
+                ccr = I2C_STANDARD_MIN_CCR;
+            }
+            trise = ((freqMHz * I2C_STANDARD_RISE_NS) / 1000UL) + 1UL;
+        }
+        else
+        {
+            ccr = (pclk1 + (3UL * 400000UL) - 1UL) / (3UL * 400000UL);
+            ccr |= I2C_CCR_FS;
+            trise = ((freqMHz * I2C_FAST_RISE_NS) / 1000UL) + 1UL;
+        }
+
+        regs->CR2 = freqMHz;
+        regs->CCR = ccr;
+        regs->TRISE = trise;
+    }
+
+    return status;
+}
+
+static I2C_Status_t I2C_enuInitPins(I2C_Number_t bus)
+{
+    I2C_Status_t status = I2C_OK;
+    GPIO_cfg_t gpioConfig = {
+        .mode = GPIO_MODE_ALTERNATE_FUNCTION,
+        .outputType = GPIO_OUTPUT_TYPE_OPEN_DRAIN,
+        .speed = GPIO_SPEED_MEDIUM,
+        .pull = GPIO_NO_PULL,
+        .alternateFunction = I2C_PinMap[bus].AlternateFunction
+    };
+
+    gpioConfig.port = I2C_PinMap[bus].SclPort;
+    gpioConfig.pin = I2C_PinMap[bus].SclPin;
+    if (GPIO_enuInit(&gpioConfig) != GPIO_OK)
+    {
+        status = I2C_GPIO_ERROR;
+    }
+    else
+    {
+        gpioConfig.port = I2C_PinMap[bus].SdaPort;
+        gpioConfig.pin = I2C_PinMap[bus].SdaPin;
+        if (GPIO_enuInit(&gpioConfig) != GPIO_OK)
+        {
+            status = I2C_GPIO_ERROR;
+        }
+    }
+
+    return status;
+}
+
+/* Both streams configured once (byte, normal mode, TC interrupt), only address and length change per phase */
+static I2C_Status_t I2C_enuInitDma(I2C_Number_t bus)
+{
+    I2C_Status_t status = I2C_OK;
+    DMA_Config_t dmaConfig;
+    const I2C_DmaStream_t *streams[2] = {&I2C_DmaTx[bus], &I2C_DmaRx[bus]};
+    const DMA_CallBack_t callbacks[2] = {I2C_DmaTxCallbacks[bus], I2C_DmaRxCallbacks[bus]};
+
+    dmaConfig.DMAx               = DMA1;
+    dmaConfig.MBurst             = DMA_MBurst_SINGLE;
+    dmaConfig.PBurst             = DMA_PBurst_SINGLE;
+    dmaConfig.DoubleBuffer       = DMA_DISABLE_DOUBLE_BUFFER;
+    dmaConfig.Priority           = DMA_PRIORITY_MEDIUM;
+    dmaConfig.MSize              = DMA_MSIZE_BYTE;
+    dmaConfig.PSize              = DMA_PSIZE_BYTE;
+    dmaConfig.MemoryInc          = DMA_MINC_AUTO_INCREMENT;
+    dmaConfig.PeripheralInc      = DMA_PINC_FIXED;
+    dmaConfig.PeripheralFlowCtrl = DMA_FLOW_CONTROL_USING_DMA;
+    dmaConfig.Mode               = DMA_MODE_DIRECT;
+    dmaConfig.FifoThreshold      = DMA_FIFO_THRESHOLD_FULL; // Not important at direct mode
+    dmaConfig.CircularMode       = DMA_CIRCULAR_MODE_DISABLE;
+    dmaConfig.Interrupts         = DMA_INTERRUPT_TRANSFER_COMPLETE_ENABLE;
+    dmaConfig.PeripheralAddress  = (uint32_t)&I2C_Registers[bus]->DR;
+    dmaConfig.Memory0Address     = 0; // Set by I2C_vdStartDma
+    dmaConfig.Memory1Address     = 0; // Not used in normal mode
+    dmaConfig.NumberOfData       = 1;
+
+    for (uint8_t i = 0; (i < 2U) && (I2C_OK == status); i++)
+    {
+        dmaConfig.Streamx   = streams[i]->Stream;
+        dmaConfig.Channel   = streams[i]->Channel;
+        dmaConfig.Direction = (0U == i) ? DMA_DIRECTION_M2P : DMA_DIRECTION_P2M;
+
+        DMA_Status_t dmaStatus = DMA_enuDeInit(DMA1, streams[i]->Stream);
+        if ((DMA_OK == dmaStatus) || (DMA_STREAM_NOT_INIT == dmaStatus))
+        {
+            dmaStatus = DMA_enuInit(&dmaConfig);
+        }
+        if (DMA_OK == dmaStatus)
+        {
+            dmaStatus = DMA_enuRegisterCallback(DMA1, streams[i]->Stream, DMA_INTERRUPT_TRANSMISSION_COMPLETE, callbacks[i]);
+        }
+        if (DMA_OK != dmaStatus)
+        {
+            status = I2C_DMA_ERROR;
+        }
+        else
+        {
+            (void)NVIC_BP_SetPriority(streams[i]->Irq, I2C_INTERRUPT_PRIORITY);
+            (void)NVIC_BP_EnableIRQ(streams[i]->Irq);
+        }
+    }
+
+    return status;
+}
+
+static void I2C_vdStartDma(const I2C_DmaStream_t *dma, uint32_t memoryAddress, uint16_t length)
+{
+    (void)DMA_enuClearFlag(DMA1, dma->Stream, DMA_INTERRUPT_TRANSMISSION_COMPLETE);
+    (void)DMA_enuSetMemoryAddress(DMA1, dma->Stream, memoryAddress);
+    (void)DMA_enuSetNumberOfData(DMA1, dma->Stream, length);
+    (void)DMA_enuStartTransfer(DMA1, dma->Stream);
+}
+
+static bool_t I2C_boolUseDma(I2C_Number_t bus, uint16_t length)
+{
+    return ((I2C_DMA_ENABLED == I2C_DmaEnabled[bus]) && (length >= I2C_DMA_MIN_LENGTH) && (length > 2U)) ? TRUE : FALSE;
+}
+
+/**
+ * Called with the queue protected (critical section or I2C interrupt)
+ * A START requested while the STOP of the previous transaction is still
+ * pending would be lost : wait for the hardware to clear STOP (a few us)
+ */
+static void I2C_vdStartNext(I2C_Number_t bus)
+{
+    I2C_Bus_t *state = &I2C_Buses[bus];
+    I2C_Regs_t *regs = I2C_Registers[bus];
+    uint32_t timeout = I2C_STOP_TIMEOUT;
+
+    if (0U == state->Count)
+    {
+        state->Current = NULL;
+        state->Phase = I2C_PHASE_IDLE;
+    }
+    else
+    {
+        state->Current = state->Queue[state->Head];
+        state->Index = 0;
+        state->Addressed = FALSE;
+        state->Phase = (0U != state->Current->I2C_TxLength) ? I2C_PHASE_WRITE : I2C_PHASE_READ;
+
+        while (((regs->CR1 & I2C_CR1_STOP) != 0) && (timeout > 0U))
+        {
+            timeout--;
+        }
+        regs->CR1 &= ~I2C_CR1_POS;
+        regs->CR2 |= I2C_CR2_ITEVTEN | I2C_CR2_ITERREN;
+        regs->CR1 |= I2C_CR1_START;
+    }
+}
+
+/**
+ * EV6 : ADDR set, SCL stretched until it is cleared (SR1 then SR2 read)
+ * Everything that must happen before the first data byte is set here:
+ * - 1-byte read  : NACK, then STOP right after ADDR is cleared
+ * - 2-byte read  : NACK with POS (applies to the second byte), wait for BTF
+ * - DMA phases   : stream armed and DMAEN set before ADDR is cleared, the
+ *                  event interrupt is off until the DMA completes
+ */
+static void I2C_vdAddressAcknowledged(I2C_Number_t bus)
+{
+    I2C_Bus_t *state = &I2C_Buses[bus];
+    I2C_Regs_t *regs = I2C_Registers[bus];
+    I2C_Transaction_t *transaction = state->Current;
+
+    state->Addressed = TRUE;
+
+    if (I2C_PHASE_WRITE == state->Phase)
+    {
+        if (TRUE == I2C_boolUseDma(bus, transaction->I2C_TxLength))
+        {
+            I2C_vdStartDma(&I2C_DmaTx[bus], (uint32_t)transaction->I2C_TxBuffer, transaction->I2C_TxLength);
+            regs->CR2 = (regs->CR2 & ~I2C_CR2_ITEVTEN) | I2C_CR2_DMAEN;
+        }
+        else
+        {
+            regs->CR2 |= I2C_CR2_ITBUFEN;
+        }
+        (void)regs->SR2;
+    }
+    else if (1U == transaction->I2C_RxLength)
+    {
+        regs->CR1 &= ~I2C_CR1_ACK;
+        (void)regs->SR2;
+        regs->CR1 |= I2C_CR1_STOP;
+        regs->CR2 |= I2C_CR2_ITBUFEN;
+    }
+    else if (2U == transaction->I2C_RxLength)
+    {
+        regs->CR1 = (regs->CR1 & ~I2C_CR1_ACK) | I2C_CR1_POS;
+        (void)regs->SR2;
+    }
+    else if (TRUE == I2C_boolUseDma(bus, transaction->I2C_RxLength))
+    {
+        regs->CR1 |= I2C_CR1_ACK;
+        I2C_vdStartDma(&I2C_DmaRx[bus], (uint32_t)transaction->I2C_RxBuffer, transaction->I2C_RxLength);
+        regs->CR2 = (regs->CR2 & ~I2C_CR2_ITEVTEN) | I2C_CR2_DMAEN | I2C_CR2_LAST;
+        (void)regs->SR2;
+    }
+    else
+    {
+        // 3 bytes or more : RXNE until 3 are left, then BTF (EV7_2)
+        regs->CR1 |= I2C_CR1_ACK;
+        if (transaction->I2C_RxLength > 3U)
+        {
+            regs->CR2 |= I2C_CR2_ITBUFEN;
+        }
+        (void)regs->SR2;
+    }
+}
+
+/* Ends the transaction on the bus, calls back and starts the next one */
+static void I2C_vdFinish(I2C_Number_t bus, I2C_Result_t result)
+{
+    I2C_Bus_t *state = &I2C_Buses[bus];
+    I2C_Regs_t *regs = I2C_Registers[bus];
+    I2C_Transaction_t *transaction = state->Current;
+
+    regs->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_DMAEN | I2C_CR2_LAST);
+    regs->CR1 &= ~I2C_CR1_POS;
+    if (I2C_DMA_ENABLED == I2C_DmaEnabled[bus])
+    {
+        (void)DMA_enuStopTransfer(DMA1, I2C_DmaTx[bus].Stream);
+        (void)DMA_enuStopTransfer(DMA1, I2C_DmaRx[bus].Stream);
+    }
+
+    state->Head = (uint8_t)((state->Head + 1U) % I2C_QUEUE_LENGTH);
+    state->Count--;
+    state->Current = NULL;
+    state->Phase = I2C_PHASE_IDLE;
+
+    transaction->I2C_Result = result;
+    if (NULL != transaction->I2C_Callback)
+    {
+        transaction->I2C_Callback(transaction);
+    }
+
+    // The callback may have submitted (and so started) a transaction already
+    if (NULL == state->Current)
+    {
+        I2C_vdStartNext(bus);
+    }
+}
+
+/**
+ * Master sequencing (RM0368 18.3.3, EV5 .. EV8_2)
+ * BTF stays set until START / STOP is generated : the Addressed flag keeps
+ * the BTF of the write phase from being taken for one of the read phase
+ */
+static void I2C_vdEventHandler(I2C_Number_t bus)
+{
+    I2C_Bus_t *state = &I2C_Buses[bus];
+    I2C_Regs_t *regs = I2C_Registers[bus];
+    I2C_Transaction_t *transaction = state->Current;
+    uint32_t sr1 = regs->SR1;
+
+    if (NULL == transaction)
+    {
+        // Event left by an abort
+        regs->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN);
+    }
+    else if ((sr1 & I2C_SR1_SB) != 0)
+    {
+        // EV5 : address byte, SB cleared by this write
+        regs->DR = ((uint32_t)transaction->I2C_Address << 1) | ((I2C_PHASE_READ == state->Phase) ? 1UL : 0UL);
+    }
+    else if ((sr1 & I2C_SR1_ADDR) != 0)
+    {
+        I2C_vdAddressAcknowledged(bus);
+    }
+    else if (FALSE == state->Addressed)
+    {
+        // Repeated START requested, waiting for SB
+    }
+    else if (I2C_PHASE_WRITE == state->Phase)
+    {
+        if (((sr1 & I2C_SR1_TXE) != 0) && (state->Index < transaction->I2C_TxLength))
+        {
+            regs->DR = transaction->I2C_TxBuffer[state->Index++];
+            if (state->Index == transaction->I2C_TxLength)
+            {
+                regs->CR2 &= ~I2C_CR2_ITBUFEN;
+            }
+        }
+        else if (((sr1 & I2C_SR1_BTF) != 0) && (state->Index == transaction->I2C_TxLength))
+        {
+            // EV8_2 : last byte shifted out
+            if (0U != transaction->I2C_RxLength)
+            {
+                state->Phase = I2C_PHASE_READ;
+                state->Index = 0;
+                state->Addressed = FALSE;
+                regs->CR1 |= I2C_CR1_START;
+            }
+            else
+            {
+                regs->CR1 |= I2C_CR1_STOP;
+                I2C_vdFinish(bus, I2C_RESULT_OK);
+            }
+        }
+        else
+        {
+            // Nothing to do
+        }
+    }
+    else
+    {
+        uint16_t remaining = transaction->I2C_RxLength - state->Index;
+
+        if (1U == transaction->I2C_RxLength)
+        {
+            if ((sr1 & I2C_SR1_RXNE) != 0)
+            {
+                transaction->I2C_RxBuffer[state->Index++] = (uint8_t)regs->DR;
+                I2C_vdFinish(bus, I2C_RESULT_OK);
+            }
+        }
+        else if (((sr1 & I2C_SR1_BTF) != 0) && (2U == remaining))
+        {
+            // N-1 in DR, N in the shift register : STOP before reading them
+            regs->CR1 |= I2C_CR1_STOP;
+            transaction->I2C_RxBuffer[state->Index++] = (uint8_t)regs->DR;
+            transaction->I2C_RxBuffer[state->Index++] = (uint8_t)regs->DR;
+            I2C_vdFinish(bus, I2C_RESULT_OK);
+        }
+        else if (((sr1 & I2C_SR1_BTF) != 0) && (3U == remaining))
+        {
+            // EV7_2 : N-2 in DR, N-1 in the shift register, NACK the last byte
+            regs->CR1 &= ~I2C_CR1_ACK;
+            transaction->I2C_RxBuffer[state->Index++] = (uint8_t)regs->DR;
+        }
+        else if (((sr1 & I2C_SR1_RXNE) != 0) && (remaining > 3U))
+        {
+            transaction->I2C_RxBuffer[state->Index++] = (uint8_t)regs->DR;
+            if (3U == (remaining - 1U))
+            {
+                regs->CR2 &= ~I2C_CR2_ITBUFEN;
+            }
+        }
+        else
+        {
+            // Wait for BTF
+        }
+    }
+}
+
+/**
+ * AF (NACK), BERR and OVR end the transaction with a STOP; after ARLO the
+ * interface is already back in slave mode and must not send one
+ */
+static void I2C_vdErrorHandler(I2C_Number_t bus)
+{
+    I2C_Regs_t *regs = I2C_Registers[bus];
+    uint32_t errors = regs->SR1 & I2C_SR1_ERRORS;
+    I2C_Result_t result = I2C_RESULT_BUS_ERROR;
+
+    // rc_w0 flags : writing 1 to the others leaves them untouched
+    regs->SR1 = (uint32_t)(~errors);
+
+    if ((errors & I2C_SR1_ARLO) != 0)
+    {
+        result = I2C_RESULT_ARBITRATION_LOST;
+    }
+    else
+    {
+        if ((errors & I2C_SR1_AF) != 0)
+        {
+            result = I2C_RESULT_NACK;
+        }
+        else if ((errors & I2C_SR1_OVR) != 0)
+        {
+            result = I2C_RESULT_OVERRUN;
+        }
+        else
+        {
+            result = I2C_RESULT_BUS_ERROR;
+        }
+        regs->CR1 |= I2C_CR1_STOP;
+    }
+
+    if (NULL != I2C_Buses[bus].Current)
+    {
+        I2C_vdFinish(bus, result);
+    }
+}
+
+/* Last byte in DR, not shifted out yet : BTF (event interrupt) ends the write phase */
+static void I2C_vdDmaTxComplete(I2C_Number_t bus)
+{
+    I2C_Regs_t *regs = I2C_Registers[bus];
+
+    if (NULL != I2C_Buses[bus].Current)
+    {
+        I2C_Buses[bus].Index = I2C_Buses[bus].Current->I2C_TxLength;
+        regs->CR2 = (regs->CR2 & ~I2C_CR2_DMAEN) | I2C_CR2_ITEVTEN;
+    }
+}
+
+/* LAST made the interface NACK the last byte, it is already in memory */
+static void I2C_vdDmaRxComplete(I2C_Number_t bus)
+{
+    I2C_Regs_t *regs = I2C_Registers[bus];
+
+    if (NULL != I2C_Buses[bus].Current)
+    {
+        regs->CR1 |= I2C_CR1_STOP;
+        I2C_Buses[bus].Index = I2C_Buses[bus].Current->I2C_RxLength;
+        I2C_vdFinish(bus, I2C_RESULT_OK);
+    }
+}
@@ -9,10 +9,53 @@
  ******************************************************************************/
 
 #include "LIB/stdtypes.h"
+#include "LIB/dwt.h"
 
+#include "MCAL/NVIC_Driver/nvic_cfg.h"
 #include "MCAL/NVIC_Driver/nvic_priv.h"
 #include "MCAL/NVIC_Driver/nvic.h"
 
+/******************************************************************************
+ *                        CRITICAL SECTION STATE
+ * @brief Private state of the BASEPRI critical section API
+ * @note CriticalNesting is only modified with BASEPRI already raised, so any
+ *       ISR that may touch it is masked while it changes
+ * @author Eng.Gemy
+ ******************************************************************************/
+static uint8_t  CriticalThreshold    = NVIC_CRITICAL_BASEPRI_THRESHOLD;  /**< BASEPRI value written on entry */
+static uint32_t CriticalNesting      = 0;                                /**< Current nesting depth */
+static uint32_t CriticalSavedBasepri = 0;                                /**< BASEPRI before outermost entry */
+static uint32_t CriticalStartCycles  = 0;                                /**< DWT_CYCCNT at outermost entry */
+static uint32_t CriticalMaxCycles    = 0;                                /**< Longest section measured (cycles) */
+
+/******************************************************************************
+ *                        RAM VECTOR TABLE
+ * @brief RAM copy of the vector table, pointed to by VTOR after relocation
+ * @note Lives in .bss, aligned as required by VTOR
+ * @author Eng.Gemy
+ ******************************************************************************/
+static NVIC_Handler_t RamVectorTable[NVIC_CORE_EXCEPTIONS + NVIC_RAM_VECTOR_IRQS] __attribute__((aligned(NVIC_RAM_VECTOR_ALIGNMENT)));
+static bool_t VectorTableRelocated = FALSE;     /**< TRUE once VTOR points to RamVectorTable */
+
+/* Read current BASEPRI special register */
+static inline uint32_t NVIC_GetBASEPRI(void){
+    uint32_t value;
+    __asm volatile ("MRS %0, basepri" : "=r" (value) :: "memory");
+    return value;
+}
+
+/* Write BASEPRI unconditionally (used to restore the saved value) */
+static inline void NVIC_SetBASEPRI(uint32_t value){
+    __asm volatile ("MSR basepri, %0" :: "r" (value) : "memory");
+    __asm volatile ("ISB" ::: "memory");
+}
+
+/* Write BASEPRI_MAX : hardware only accepts the value if it raises the mask */
+static inline void NVIC_RaiseBASEPRI(uint32_t value){
+    __asm volatile ("MSR basepri_max, %0" :: "r" (value) : "memory");
+    __asm volatile ("ISB" ::: "memory");
+}
+
 
 
 /******************************************************************************
@@ -374,4 +417,307 @@ NVIC_Status_t NVIC_SetPriorityGrouping(uint32_t priority_grouping){
     // Write VECTKEY (0x5FA) + PRIGROUP field
     SCB_AIRCR = AIRCR_VECTKEY_MASK | (priority_grouping << 8);
     return NVIC_OK;
-}
\ No newline at end of file
+}
+
+/******************************************************************************
+ * @brief Request a system reset through AIRCR.SYSRESETREQ
+ * 
+ * @return NVIC_Status_t Never returns, the core waits for the reset
+ * 
+ * @note DSB before the write so pending memory accesses (a flash program,
+ *       a UART byte in the write buffer) complete first
+ * @note PRIGROUP is written back unchanged, VECTKEY unlocks the write
+ * 
+ * @author Eng.Gemy
+ ******************************************************************************/
+NVIC_Status_t NVIC_SystemReset (void){
+
+    __asm volatile ("DSB" ::: "memory");
+    // Write VECTKEY (0x5FA) + the current PRIGROUP + SYSRESETREQ
+    SCB_AIRCR = AIRCR_VECTKEY_MASK | (SCB_AIRCR & AIRCR_PRIGROUP_MASK) | AIRCR_SYSRESETREQ_MASK;
+    __asm volatile ("DSB" ::: "memory");
+
+    // The reset is asserted a few cycles after the write
+    while(1);
+
+    return NVIC_NOT_OK;
+}
+
+/******************************************************************************
+ * @brief Copy the vector table to RAM and point VTOR at the copy
+ * 
+ * @details Copies the active vector table (core exceptions + configured IRQs)
+ *          into RamVectorTable then writes its address to VTOR. After this
+ *          call NVIC_SetVector() can replace any IRQ entry at runtime.
+ * 
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK  Vector table relocated
+ * 
+ * @note VTOR = 0 after reset means the flash table aliased at 0x00000000,
+ *       it is read from its real flash address instead
+ * @note PRIMASK is set during the copy so no interrupt fetches a half
+ *       written table, DSB/ISB make the new VTOR visible before returning
+ * 
+ * @author Eng.Gemy
+ ******************************************************************************/
+NVIC_Status_t NVIC_RelocateVectorTable(void){
+    uint32_t primask;
+    uint32_t index;
+    const NVIC_Handler_t* activeTable;
+
+    if(VectorTableRelocated == FALSE){
+        /* Source table : current VTOR, or flash when VTOR still holds reset value */
+        if(SCB_VTOR == 0){
+            activeTable = (const NVIC_Handler_t*)VTOR_FLASH_BOOT_ADDRESS;
+        }else{
+            activeTable = (const NVIC_Handler_t*)SCB_VTOR;
+        }
+
+        __asm volatile ("MRS %0, primask" : "=r" (primask) :: "memory");
+        __asm volatile ("CPSID i" ::: "memory");
+
+        for(index = 0; index < (NVIC_CORE_EXCEPTIONS + NVIC_RAM_VECTOR_IRQS); index++){
+            RamVectorTable[index] = activeTable[index];
+        }
+
+        SCB_VTOR = (uint32_t)RamVectorTable;
+        __asm volatile ("DSB" ::: "memory");
+        __asm volatile ("ISB" ::: "memory");
+
+        VectorTableRelocated = TRUE;
+
+        __asm volatile ("MSR primask, %0" :: "r" (primask) : "memory");
+    }else{
+        // do nothing - already relocated, keep installed handlers
+    }
+    return NVIC_OK;
+}
+
+/******************************************************************************
+ * @brief Install an interrupt handler directly in the RAM vector table
+ * 
+ * @param[in] IRQn     Interrupt request number
+ * @param[in] Handler  Function executed by the core on this interrupt
+ * 
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK        Handler installed
+ * @retval NVIC_NOT_OK    Table not relocated or IRQ outside the table
+ * @retval NVIC_NULL_PTR  Null handler passed
+ * 
+ * @note Entry index = 16 core exceptions + IRQn
+ * @note A single aligned word write, safe while the IRQ is enabled
+ * 
+ * @author Eng.Gemy
+ ******************************************************************************/
+NVIC_Status_t NVIC_SetVector(NVIC_IRQ_t IRQn, NVIC_Handler_t Handler){
+    NVIC_Status_t status = NVIC_NOT_OK;
+
+    if(Handler == NULL){
+        status = NVIC_NULL_PTR;
+    }else if((VectorTableRelocated == FALSE) || ((uint32_t)IRQn >= NVIC_RAM_VECTOR_IRQS)){
+        status = NVIC_NOT_OK;
+    }else{
+        RamVectorTable[NVIC_CORE_EXCEPTIONS + IRQn] = Handler;
+        __asm volatile ("DSB" ::: "memory");
+        status = NVIC_OK;
+    }
+    return status;
+}
+
+/******************************************************************************
+ * @brief Read the handler currently installed for an interrupt
+ * 
+ * @param[in]  IRQn     Interrupt request number
+ * @param[out] Handler  Pointer to store the handler address
+ * 
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK        Handler read successfully
+ * @retval NVIC_NOT_OK    IRQ outside the table
+ * @retval NVIC_NULL_PTR  Null pointer passed
+ * 
+ * @author Eng.Gemy
+ ******************************************************************************/
+NVIC_Status_t NVIC_GetVector(NVIC_IRQ_t IRQn, NVIC_Handler_t* Handler){
+    NVIC_Status_t status = NVIC_NOT_OK;
+
+    if(Handler == NULL){
+        status = NVIC_NULL_PTR;
+    }else if((uint32_t)IRQn >= NVIC_RAM_VECTOR_IRQS){
+        status = NVIC_NOT_OK;
+    }else if(VectorTableRelocated == TRUE){
+        *Handler = RamVectorTable[NVIC_CORE_EXCEPTIONS + IRQn];
+        status = NVIC_OK;
+    }else if(SCB_VTOR == 0){
+        *Handler = ((const NVIC_Handler_t*)VTOR_FLASH_BOOT_ADDRESS)[NVIC_CORE_EXCEPTIONS + IRQn];
+        status = NVIC_OK;
+    }else{
+        *Handler = ((const NVIC_Handler_t*)SCB_VTOR)[NVIC_CORE_EXCEPTIONS + IRQn];
+        status = NVIC_OK;
+    }
+    return status;
+}
+
+/******************************************************************************
+ * @brief Enter a BASEPRI critical section
+ * 
+ * @details Raises BASEPRI to the configured threshold using BASEPRI_MAX so the
+ *          mask is never weakened. The outermost entry saves the previous
+ *          BASEPRI value and starts the DWT cycle measurement.
+ * 
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK  Critical section entered
+ * 
+ * @note Interrupts with priority value below the threshold are not masked,
+ *       so their latency is unaffected by the critical section
+ * @note Nesting is supported, only the outermost exit restores BASEPRI
+ * 
+ * @author Eng.Gemy
+ ******************************************************************************/
+NVIC_Status_t NVIC_EnterCritical(void){
+    /* Read BASEPRI before raising it, an ISR preempting between these two
+     * instructions always restores BASEPRI before returning
+     */
+    uint32_t previousBasepri = NVIC_GetBASEPRI();
+
+    NVIC_RaiseBASEPRI(CriticalThreshold);
+
+    if(CriticalNesting == 0){
+        CriticalSavedBasepri = previousBasepri;
+#if NVIC_CRITICAL_MEASURE_ENABLE == 1
+        /* Start the DWT cycle counter on first use */
+        DWT_vdStart();
+        CriticalStartCycles = DWT_CYCCNT;
+#endif
+    }
+    CriticalNesting++;
+    return NVIC_OK;
+}
+
+/******************************************************************************
+ * @brief Exit a BASEPRI critical section
+ * 
+ * @details Decrements the nesting counter. The outermost exit updates the
+ *          longest measured section and restores the BASEPRI value saved at
+ *          entry.
+ * 
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK      Critical section exited
+ * @retval NVIC_NOT_OK  No critical section is active
+ * 
+ * @note DWT_CYCCNT wraps at 2^32, unsigned subtraction handles one wrap
+ * 
+ * @author Eng.Gemy
+ ******************************************************************************/
+NVIC_Status_t NVIC_ExitCritical(void){
+    NVIC_Status_t status = NVIC_NOT_OK;
+
+    if(CriticalNesting == 0){
+        status = NVIC_NOT_OK;
+    }else{
+        CriticalNesting--;
+        if(CriticalNesting == 0){
+#if NVIC_CRITICAL_MEASURE_ENABLE == 1
+            uint32_t elapsed = DWT_CYCCNT - CriticalStartCycles;
+            if(elapsed > CriticalMaxCycles){
+                CriticalMaxCycles = elapsed;
+            }
+#endif
+            NVIC_SetBASEPRI(CriticalSavedBasepri);
+        }
+        status = NVIC_OK;
+    }
+    return status;
+}
+
+/******************************************************************************
+ * @brief Change the BASEPRI threshold used by NVIC_EnterCritical()
+ * 
+ * @param[in] Priority  Raw 8-bit priority value, only bits [7:4] are kept
+ * 
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK      Threshold changed
+ * @retval NVIC_NOT_OK  Threshold is 0 or a critical section is active
+ * 
+ * @note A threshold of 0 is rejected : BASEPRI = 0 means no masking at all
+ * 
+ * @author Eng.Gemy
+ ******************************************************************************/
+NVIC_Status_t NVIC_SetCriticalThreshold(uint8_t Priority){
+    NVIC_Status_t status = NVIC_NOT_OK;
+
+    if((Priority & BASEPRI_IMPLEMENTED_MASK) == 0){
+        status = NVIC_NOT_OK;
+    }else if(CriticalNesting != 0){
+        status = NVIC_NOT_OK;
+    }else{
+        CriticalThreshold = (uint8_t)(Priority & BASEPRI_IMPLEMENTED_MASK);
+        status = NVIC_OK;
+    }
+    return status;
+}
+
+/******************************************************************************
+ * @brief Get the longest critical section measured so far
+ * 
+ * @param[out] Cycles  Pointer to store the duration in CPU cycles
+ * 
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK        Value read successfully
+ * @retval NVIC_NULL_PTR  Null pointer passed
+ * 
+ * @author Eng.Gemy
+ ******************************************************************************/
+NVIC_Status_t NVIC_GetMaxCriticalTime(uint32_t* Cycles){
+    NVIC_Status_t status = NVIC_NOT_OK;
+
+    if(Cycles == NULL){
+        status = NVIC_NULL_PTR;
+    }else{
+        *Cycles = CriticalMaxCycles;
+        status = NVIC_OK;
+    }
+    return status;
+}
+
+/******************************************************************************
+ * @brief Reset the longest critical section measurement
+ * 
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK  Measurement cleared
+ * 
+ * @author Eng.Gemy
+ ******************************************************************************/
+NVIC_Status_t NVIC_ResetMaxCriticalTime(void){
+    CriticalMaxCycles = 0;
+    return NVIC_OK;
+}
+
+/******************************************************************************
+ * @brief Mask every configurable interrupt with PRIMASK
+ * 
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK  PRIMASK set
+ * 
+ * @note A pending interrupt still wakes the core from WFI while PRIMASK is
+ *       set, it is only taken after NVIC_EnableAllIRQ()
+ * 
+ * @author Eng.Gemy
+ ******************************************************************************/
+NVIC_Status_t NVIC_DisableAllIRQ(void){
+    __asm volatile ("CPSID i" ::: "memory");
+    return NVIC_OK;
+}
+
+/******************************************************************************
+ * @brief Clear PRIMASK, pending interrupts are taken at once
+ * 
+ * @return NVIC_Status_t Status of the operation
+ * @retval NVIC_OK  PRIMASK cleared
+ * 
+ * @author Eng.Gemy
+ ******************************************************************************/
+NVIC_Status_t NVIC_EnableAllIRQ(void){
+    __asm volatile ("CPSIE i" ::: "memory");
+    __asm volatile ("ISB" ::: "memory");
+    return NVIC_OK;
+}
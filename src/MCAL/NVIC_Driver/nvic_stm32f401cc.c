@@ -391,6 +391,39 @@ NVIC_BP_Status_t NVIC_BP_SetPriorityGrouping(NVIC_BP_PriorityGroupBits_t groupBi
     return status;
 }
 
+/******************************************************************************
+ * @brief Install an interrupt handler in the RAM vector table (Black Pill wrapper)
+ * 
+ * @details This function validates the IRQ number before writing the vector
+ * 
+ * @param[in] IRQn     Interrupt request number from NVIC_BP_IRQ_t enum
+ * @param[in] Handler  Function executed directly by the core on this interrupt
+ * 
+ * @return NVIC_BP_Status_t Status of the operation
+ * @retval NVIC_BP_OK        Handler installed successfully
+ * @retval NVIC_BP_WRONG_IRQ Invalid IRQ number
+ * @retval NVIC_BP_NULL_PTR  Null handler passed (checked in generic driver)
+ * @retval NVIC_BP_NOT_OK    Vector table not relocated to RAM
+ * 
+ * @author Eng.Gemy
+ ******************************************************************************/
+NVIC_BP_Status_t NVIC_BP_SetVector(NVIC_BP_IRQ_t IRQn, void (*Handler)(void)){
+    /* Local variable to hold function return status */
+    NVIC_BP_Status_t status = NVIC_BP_NOT_OK;
+
+    /* Validate IRQ number against STM32F401CC valid interrupts */
+    if(FALSE == IsValidIRQ(IRQn)){
+        /* IRQ number is not valid for STM32F401CC Black Pill */
+        status = NVIC_BP_WRONG_IRQ;
+    }else{
+        /* IRQ is valid - call generic NVIC driver function
+         * Cast return status to Black Pill status type
+         */
+        status = (NVIC_BP_Status_t)NVIC_SetVector((NVIC_IRQ_t)IRQn,Handler);
+    }
+    return status;
+}
+
 /******************************************************************************
  * @brief Validate IRQ number for STM32F401CC Black Pill
  * 
@@ -0,0 +1,614 @@
+/******************************************************************************
+ * @file    PWR.C
+ * @author  Eng.Gemy
+ * @brief   PWR Driver Implementation File
+ *          Sleep / STOP entry, RTC wake-up timer and EXTI wake-up lines
+ ******************************************************************************/
+
+#include "LIB/stdtypes.h"
+#include "LIB/dwt.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "MCAL/GPIO_Driver/gpio_int.h"
+#include "MCAL/NVIC_Driver/nvic_stm32f401cc.h"
+
+#include "MCAL/PWR_Driver/pwr_cfg.h"
+#include "MCAL/PWR_Driver/pwr_priv.h"
+#include "MCAL/PWR_Driver/pwr.h"
+
+/* Interrupt handlers of the wake-up lines (vector table names) */
+void RTC_WKUP_IRQHandler(void);
+void EXTI0_IRQHandler(void);
+void EXTI1_IRQHandler(void);
+void EXTI2_IRQHandler(void);
+void EXTI3_IRQHandler(void);
+void EXTI4_IRQHandler(void);
+void EXTI9_5_IRQHandler(void);
+void EXTI15_10_IRQHandler(void);
+
+/* TRUE once the PWR clock is on and the RTC time base is running */
+static bool_t PwrInitialized = FALSE;
+
+/* TRUE once SYSCFG clock was acquired for the EXTI routing */
+static bool_t SyscfgClockOwned = FALSE;
+
+/* LSI frequency used for every RTC conversion, trimmed by the calibration */
+static uint32_t LsiFrequency = PWR_LSI_NOMINAL_HZ;
+
+/* PREDIV_S + 1 : sub-second ticks per RTC second (~1000, one per ms) */
+static uint32_t RtcSubSecondTicks = PWR_LSI_NOMINAL_HZ / (RTC_PREDIV_A + 1UL);
+
+/* Lines that fired since the last PWR_u32GetWakeupLines() */
+static volatile uint32_t WakeupLines = 0;
+
+static PWR_WakeupCallback_t WakeupCallback = NULL;
+
+/* NVIC line of each EXTI GPIO line */
+static const NVIC_BP_IRQ_t PWR_ExtiIrq[EXTI_GPIO_LINES] = {
+    NVIC_EXTI0_IRQ, NVIC_EXTI1_IRQ, NVIC_EXTI2_IRQ, NVIC_EXTI3_IRQ, NVIC_EXTI4_IRQ,
+    NVIC_EXTI9_5_IRQ, NVIC_EXTI9_5_IRQ, NVIC_EXTI9_5_IRQ, NVIC_EXTI9_5_IRQ, NVIC_EXTI9_5_IRQ,
+    NVIC_EXTI15_10_IRQ, NVIC_EXTI15_10_IRQ, NVIC_EXTI15_10_IRQ,
+    NVIC_EXTI15_10_IRQ, NVIC_EXTI15_10_IRQ, NVIC_EXTI15_10_IRQ
+};
+
+static void PWR_vdRtcUnlock(void);
+static void PWR_vdRtcLock(void);
+static PWR_Status_t PWR_enuRtcSetPrescaler(uint32_t subSecondTicks);
+static uint32_t PWR_u32ReadRtcTicks(void);
+static void PWR_vdCalibrateLsi(void);
+static void PWR_vdExtiHandler(uint32_t lines);
+
+/**
+ * @brief Initialize the power controller and the RTC time base
+ *
+ * Steps:
+ * 1. PWR clock is acquired (kept for life, PWR_CR is needed for every STOP)
+ * 2. Backup domain write access, LSI on, RTC clocked from LSI
+ * 3. RTC prescalers set for a nominal 1 ms sub-second tick, shadow registers bypassed
+ * 4. LSI measured against HCLK and PREDIV_S trimmed (optional)
+ * 5. Wake-up timer routed to EXTI line 22, rising edge, interrupt enabled
+ *
+ * @author Eng.Gemy
+ */
+PWR_Status_t PWR_enuInit(void)
+{
+    PWR_Status_t status = PWR_NOT_OK;
+
+    if (RCC_OK != RCC_AcquirePeripheralClock(RCC_APB1_BUS, RCC_APB1_PWR_CLOCK))
+    {
+        status = PWR_CLOCK_ERROR;
+    }
+    else
+    {
+        PWR_Registers->CR |= PWR_CR_DBP;
+
+        if ((RCC_OK != RCC_EnableLSI()) || (RCC_OK != RCC_SetRTCClock(RCC_RTC_SOURCE_LSI)))
+        {
+            status = PWR_CLOCK_ERROR;
+        }
+        else
+        {
+            status = PWR_enuRtcSetPrescaler(PWR_LSI_NOMINAL_HZ / (RTC_PREDIV_A + 1UL));
+
+#if (PWR_LSI_CALIBRATION == PWR_LSI_CALIBRATION_ENABLED)
+            if (PWR_OK == status)
+            {
+                PWR_vdCalibrateLsi();
+                status = PWR_enuRtcSetPrescaler(LsiFrequency / (RTC_PREDIV_A + 1UL));
+            }
+#endif
+            if (PWR_OK == status)
+            {
+                EXTI_Registers->RTSR |= PWR_RTC_WAKEUP_MASK;
+                EXTI_Registers->IMR |= PWR_RTC_WAKEUP_MASK;
+                EXTI_Registers->PR = PWR_RTC_WAKEUP_MASK;
+                NVIC_BP_EnableIRQ(NVIC_EXTI22_RTC_WKUP_IRQ);
+
+                PwrInitialized = TRUE;
+            }
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Enter a low-power mode and wait for an interrupt (WFI)
+ *
+ * SLEEPDEEP is cleared again right after WFI so a later plain WFI
+ * (or SLEEPONEXIT) never ends up in STOP by accident.
+ *
+ * @author Eng.Gemy
+ */
+PWR_Status_t PWR_enuEnterMode(PWR_Mode_t mode)
+{
+    PWR_Status_t status = PWR_OK;
+
+    if (PWR_MODE_SLEEP == mode)
+    {
+        SCB_SCR &= ~SCB_SCR_SLEEPDEEP;
+    }
+    else if ((PWR_MODE_STOP_FLASH_PD == mode) || (PWR_MODE_STOP_LP_FLASH_PD == mode))
+    {
+        if (FALSE == PwrInitialized)
+        {
+            status = PWR_NOT_INIT;
+        }
+        else
+        {
+            uint32_t regulator = (PWR_MODE_STOP_LP_FLASH_PD == mode) ? PWR_CR_LPDS : 0UL;
+
+            PWR_Registers->CR = (PWR_Registers->CR & ~(PWR_CR_PDDS | PWR_CR_LPDS)) |
+                                regulator | PWR_CR_FPDS | PWR_CR_CWUF;
+            SCB_SCR |= SCB_SCR_SLEEPDEEP;
+        }
+    }
+    else
+    {
+        status = PWR_WRONG_MODE;
+    }
+
+    if (PWR_OK == status)
+    {
+        __asm volatile ("DSB" ::: "memory");
+        __asm volatile ("WFI" ::: "memory");
+        __asm volatile ("ISB" ::: "memory");
+
+        SCB_SCR &= ~SCB_SCR_SLEEPDEEP;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Program the RTC wake-up timer
+ *
+ * The counter runs from LSI / 16 : counts = time_ms * LSI / 16000.
+ * WUTR may only be written while WUTE = 0 and WUTWF = 1.
+ *
+ * @author Eng.Gemy
+ */
+PWR_Status_t PWR_enuStartWakeupTimer(uint32_t time_ms)
+{
+    PWR_Status_t status = PWR_NOT_OK;
+    uint32_t counts = (uint32_t)(((uint64_t)time_ms * LsiFrequency) / (RTC_WAKEUP_DIVIDER * 1000UL));
+
+    if (FALSE == PwrInitialized)
+    {
+        status = PWR_NOT_INIT;
+    }
+    else if ((0 == counts) || (counts > RTC_WUTR_MAX))
+    {
+        status = PWR_WRONG_WAKEUP_TIME;
+    }
+    else
+    {
+        uint32_t timeout = RTC_TIMEOUT_VALUE;
+
+        PWR_vdRtcUnlock();
+        RTC_Registers->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+
+        while ((0 == (RTC_Registers->ISR & RTC_ISR_WUTWF)) && (timeout-- > 0))
+            ;
+
+        if (0 == (RTC_Registers->ISR & RTC_ISR_WUTWF))
+        {
+            status = PWR_TIMEOUT;
+        }
+        else
+        {
+            RTC_Registers->WUTR = counts - 1UL;
+            RTC_Registers->ISR = RTC_ISR_CLEAR_WUTF;
+            EXTI_Registers->PR = PWR_RTC_WAKEUP_MASK;
+            RTC_Registers->CR = (RTC_Registers->CR & ~RTC_CR_WUCKSEL_MASK) | RTC_CR_WUTIE | RTC_CR_WUTE;
+            status = PWR_OK;
+        }
+        PWR_vdRtcLock();
+    }
+
+    return status;
+}
+
+/**
+ * @brief Stop the RTC wake-up timer and clear its flag
+ * @author Eng.Gemy
+ */
+PWR_Status_t PWR_enuStopWakeupTimer(void)
+{
+    PWR_Status_t status = PWR_NOT_INIT;
+
+    if (TRUE == PwrInitialized)
+    {
+        PWR_vdRtcUnlock();
+        RTC_Registers->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+        RTC_Registers->ISR = RTC_ISR_CLEAR_WUTF;
+        PWR_vdRtcLock();
+        EXTI_Registers->PR = PWR_RTC_WAKEUP_MASK;
+        status = PWR_OK;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Longest time accepted by PWR_enuStartWakeupTimer()
+ * @author Eng.Gemy
+ */
+PWR_Status_t PWR_enuGetMaxWakeupTime(uint32_t* time_ms)
+{
+    PWR_Status_t status = PWR_NOT_OK;
+
+    if (NULL == time_ms)
+    {
+        status = PWR_NULL_PTR;
+    }
+    else if (FALSE == PwrInitialized)
+    {
+        status = PWR_NOT_INIT;
+    }
+    else
+    {
+        *time_ms = (uint32_t)(((uint64_t)RTC_WUTR_MAX * RTC_WAKEUP_DIVIDER * 1000UL) / LsiFrequency);
+        status = PWR_OK;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Read the RTC time base in milliseconds
+ * @author Eng.Gemy
+ */
+PWR_Status_t PWR_enuGetTime_ms(uint32_t* time_ms)
+{
+    PWR_Status_t status = PWR_NOT_OK;
+
+    if (NULL == time_ms)
+    {
+        status = PWR_NULL_PTR;
+    }
+    else if (FALSE == PwrInitialized)
+    {
+        status = PWR_NOT_INIT;
+    }
+    else
+    {
+        *time_ms = (uint32_t)(((uint64_t)PWR_u32ReadRtcTicks() * 1000UL) / RtcSubSecondTicks);
+        status = PWR_OK;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Read the LSI frequency used by the RTC time base
+ * @author Eng.Gemy
+ */
+PWR_Status_t PWR_enuGetLsiFrequency(uint32_t* lsiHz)
+{
+    PWR_Status_t status = PWR_NOT_OK;
+
+    if (NULL == lsiHz)
+    {
+        status = PWR_NULL_PTR;
+    }
+    else if (FALSE == PwrInitialized)
+    {
+        status = PWR_NOT_INIT;
+    }
+    else
+    {
+        *lsiHz = LsiFrequency;
+        status = PWR_OK;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Make a GPIO pin a wake-up source
+ *
+ * SYSCFG EXTICR routes the port to the line, the line is unmasked with the
+ * requested edges and its NVIC interrupt is enabled so WFI returns.
+ *
+ * @author Eng.Gemy
+ */
+PWR_Status_t PWR_enuEnableExtiWakeup(uint8_t port, uint8_t pin, PWR_Edge_t edge)
+{
+    PWR_Status_t status = PWR_NOT_OK;
+
+    if ((port > GPIO_PORT_H) || (pin >= EXTI_GPIO_LINES))
+    {
+        status = PWR_WRONG_EXTI_LINE;
+    }
+    else if ((edge < PWR_EDGE_RISING) || (edge > PWR_EDGE_BOTH))
+    {
+        status = PWR_WRONG_EDGE;
+    }
+    else if ((FALSE == SyscfgClockOwned) &&
+             (RCC_OK != RCC_AcquirePeripheralClock(RCC_APB2_BUS, RCC_APB2_SYSCFG_CLOCK)))
+    {
+        status = PWR_CLOCK_ERROR;
+    }
+    else
+    {
+        uint32_t lineMask = (1UL << pin);
+        uint32_t portCode = (GPIO_PORT_H == port) ? SYSCFG_EXTICR_PORT_H : (uint32_t)port;
+        uint32_t shift = (pin % 4U) * SYSCFG_EXTICR_FIELD_BITS;
+
+        SyscfgClockOwned = TRUE;
+
+        EXTI_Registers->IMR &= ~lineMask;
+        SYSCFG_Registers->EXTICR[pin / 4U] = (SYSCFG_Registers->EXTICR[pin / 4U] & ~(SYSCFG_EXTICR_FIELD_MASK << shift)) |
+                                             (portCode << shift);
+
+        if (PWR_EDGE_FALLING != edge)
+        {
+            EXTI_Registers->RTSR |= lineMask;
+        }
+        else
+        {
+            EXTI_Registers->RTSR &= ~lineMask;
+        }
+        if (PWR_EDGE_RISING != edge)
+        {
+            EXTI_Registers->FTSR |= lineMask;
+        }
+        else
+        {
+            EXTI_Registers->FTSR &= ~lineMask;
+        }
+
+        EXTI_Registers->PR = lineMask;
+        EXTI_Registers->IMR |= lineMask;
+        NVIC_BP_EnableIRQ(PWR_ExtiIrq[pin]);
+        status = PWR_OK;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Remove a GPIO pin from the wake-up sources
+ *
+ * Shared NVIC lines (EXTI9_5, EXTI15_10) stay enabled, the handler only
+ * serves unmasked lines.
+ *
+ * @author Eng.Gemy
+ */
+PWR_Status_t PWR_enuDisableExtiWakeup(uint8_t pin)
+{
+    PWR_Status_t status = PWR_NOT_OK;
+
+    if (pin >= EXTI_GPIO_LINES)
+    {
+        status = PWR_WRONG_EXTI_LINE;
+    }
+    else
+    {
+        uint32_t lineMask = (1UL << pin);
+
+        EXTI_Registers->IMR &= ~lineMask;
+        EXTI_Registers->RTSR &= ~lineMask;
+        EXTI_Registers->FTSR &= ~lineMask;
+        EXTI_Registers->PR = lineMask;
+
+        if (PWR_ExtiIrq[pin] <= NVIC_EXTI4_IRQ)
+        {
+            NVIC_BP_DisableIRQ(PWR_ExtiIrq[pin]);
+        }
+        status = PWR_OK;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Register the wake-up callback
+ * @author Eng.Gemy
+ */
+PWR_Status_t PWR_enuRegisterWakeupCallback(PWR_WakeupCallback_t callback)
+{
+    WakeupCallback = callback;
+    return PWR_OK;
+}
+
+/**
+ * @brief Read and clear the lines that fired since the last call
+ * @author Eng.Gemy
+ */
+uint32_t PWR_u32GetWakeupLines(void)
+{
+    uint32_t lines = WakeupLines;
+
+    WakeupLines &= ~lines;
+    return lines;
+}
+
+/******************************************************************************
+ *                        PRIVATE FUNCTIONS
+ * @author Eng.Gemy
+ ******************************************************************************/
+
+/* Remove the RTC write protection (two keys in a row) */
+static void PWR_vdRtcUnlock(void)
+{
+    RTC_Registers->WPR = RTC_WPR_KEY1;
+    RTC_Registers->WPR = RTC_WPR_KEY2;
+}
+
+/* Restore the RTC write protection */
+static void PWR_vdRtcLock(void)
+{
+    RTC_Registers->WPR = RTC_WPR_LOCK;
+}
+
+/**
+ * @brief Program the RTC prescalers and restart the calendar at 00:00:00
+ *
+ * PRER is written in two accesses (PREDIV_S then PREDIV_A) in init mode.
+ * BYPSHAD lets SSR/TR be read without waiting for RSF after a STOP wake-up.
+ *
+ * @author Eng.Gemy
+ */
+static PWR_Status_t PWR_enuRtcSetPrescaler(uint32_t subSecondTicks)
+{
+    PWR_Status_t status = PWR_TIMEOUT;
+    uint32_t timeout = RTC_TIMEOUT_VALUE;
+
+    PWR_vdRtcUnlock();
+    RTC_Registers->ISR |= RTC_ISR_INIT;
+
+    while ((0 == (RTC_Registers->ISR & RTC_ISR_INITF)) && (timeout-- > 0))
+        ;
+
+    if (0 != (RTC_Registers->ISR & RTC_ISR_INITF))
+    {
+        RTC_Registers->PRER = subSecondTicks - 1UL;
+        RTC_Registers->PRER = (RTC_PREDIV_A << RTC_PREDIV_A_POS) | (subSecondTicks - 1UL);
+        RTC_Registers->TR = 0;
+        RTC_Registers->CR = (RTC_Registers->CR & ~RTC_CR_FMT) | RTC_CR_BYPSHAD;
+
+        RtcSubSecondTicks = subSecondTicks;
+        status = PWR_OK;
+    }
+
+    RTC_Registers->ISR &= ~RTC_ISR_INIT;
+    PWR_vdRtcLock();
+
+    return status;
+}
+
+/**
+ * @brief Sub-second ticks since midnight
+ *
+ * Shadow registers are bypassed, so SSR is read before and after TR : a
+ * different value means the second rolled over in between, read again.
+ * SSR counts down from PREDIV_S.
+ *
+ * @author Eng.Gemy
+ */
+static uint32_t PWR_u32ReadRtcTicks(void)
+{
+    uint32_t ssr;
+    uint32_t tr;
+
+    do
+    {
+        ssr = RTC_Registers->SSR;
+        tr = RTC_Registers->TR;
+    } while (ssr != RTC_Registers->SSR);
+
+    return ((RTC_TR_HOURS(tr) * 3600UL) + (RTC_TR_MINUTES(tr) * 60UL) + RTC_TR_SECONDS(tr)) * RtcSubSecondTicks +
+           ((RtcSubSecondTicks - 1UL) - ssr);
+}
+
+/**
+ * @brief Measure LSI with the DWT cycle counter
+ *
+ * One sub-second tick lasts (PREDIV_A + 1) LSI periods. The HCLK cycles of
+ * PWR_LSI_CALIBRATION_TICKS ticks are counted between two SSR edges:
+ * LSI = HCLK * (PREDIV_A + 1) * ticks / cycles.
+ * The nominal value is kept when the result is outside the 17-47 kHz spec.
+ *
+ * @author Eng.Gemy
+ */
+static void PWR_vdCalibrateLsi(void)
+{
+    uint32_t hclk = 0;
+    uint32_t startCycles;
+    uint32_t ssr;
+    uint32_t ticks;
+    uint32_t measured;
+
+    if ((RCC_OK == RCC_GetClockHz(RCC_AHB1_BUS, &hclk)) && (0 != hclk))
+    {
+        DWT_vdStart();
+
+        /* Synchronise on an SSR edge */
+        ssr = RTC_Registers->SSR;
+        while (ssr == RTC_Registers->SSR)
+            ;
+        startCycles = DWT_CYCCNT;
+
+        for (ticks = 0; ticks < PWR_LSI_CALIBRATION_TICKS; ticks++)
+        {
+            ssr = RTC_Registers->SSR;
+            while (ssr == RTC_Registers->SSR)
+                ;
+        }
+
+        measured = (uint32_t)(((uint64_t)hclk * (RTC_PREDIV_A + 1UL) * PWR_LSI_CALIBRATION_TICKS) /
+                              (DWT_CYCCNT - startCycles));
+
+        if ((measured >= 17000UL) && (measured <= 47000UL))
+        {
+            LsiFrequency = measured;
+        }
+    }
+}
+
+/**
+ * @brief Common part of the wake-up interrupt handlers
+ *
+ * Clears the pending lines (and the RTC WUTF flag, otherwise line 22 would
+ * never rise again), records them and calls the wake-up callback.
+ *
+ * @author Eng.Gemy
+ */
+static void PWR_vdExtiHandler(uint32_t lines)
+{
+    uint32_t pending = EXTI_Registers->PR & EXTI_Registers->IMR & lines;
+
+    if (0 != (pending & PWR_RTC_WAKEUP_MASK))
+    {
+        /* WUTF is in ISR[13:8], writable without removing the write protection */
+        RTC_Registers->ISR = RTC_ISR_CLEAR_WUTF;
+    }
+    EXTI_Registers->PR = pending;
+
+    WakeupLines |= pending;
+    if ((0 != pending) && (NULL != WakeupCallback))
+    {
+        WakeupCallback(pending);
+    }
+}
+
+void RTC_WKUP_IRQHandler(void)
+{
+    PWR_vdExtiHandler(PWR_RTC_WAKEUP_MASK);
+}
+
+void EXTI0_IRQHandler(void)
+{
+    PWR_vdExtiHandler(1UL << 0);
+}
+
+void EXTI1_IRQHandler(void)
+{
+    PWR_vdExtiHandler(1UL << 1);
+}
+
+void EXTI2_IRQHandler(void)
+{
+    PWR_vdExtiHandler(1UL << 2);
+}
+
+void EXTI3_IRQHandler(void)
+{
+    PWR_vdExtiHandler(1UL << 3);
+}
+
+void EXTI4_IRQHandler(void)
+{
+    PWR_vdExtiHandler(1UL << 4);
+}
+
+void EXTI9_5_IRQHandler(void)
+{
+    PWR_vdExtiHandler(EXTI_LINES_9_5_MASK);
+}
+
+void EXTI15_10_IRQHandler(void)
+{
+    PWR_vdExtiHandler(EXTI_LINES_15_10_MASK);
+}
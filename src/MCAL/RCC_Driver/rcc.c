@@ -13,6 +13,34 @@
 #include "MCAL/RCC_Driver/rcc_cfg.h"
 #include "MCAL/RCC_Driver/rcc_priv.h"
 #include "MCAL/RCC_Driver/rcc_int.h"
+#include "MCAL/NVIC_Driver/nvic.h"
+#include "OS/fault.h"
+
+/******************************************************************************
+ *                   GLOBAL CLOCK FREQUENCY VARIABLES
+ * @brief Definition of the clock source frequencies declared in rcc_int.h
+ * @author Eng.Gemy
+ ******************************************************************************/
+uint32_t RCC_HSI_ClockSourceValue = 0;
+uint32_t RCC_HSE_ClockSourceValue = 0;
+
+/* AHB prescaler lookup indexed by HPRE[3:0] (0xxx = not divided, no /32 step) */
+static const uint16_t AHBPrescalerTable[16] = {1,1,1,1,1,1,1,1,2,4,8,16,64,128,256,512};
+
+/* APB prescaler lookup indexed by PPREx[2:0] (0xx = not divided) */
+static const uint8_t APBPrescalerTable[8] = {1,1,1,1,2,4,8,16};
+
+/* Owners of every enable bit, indexed by [bus index][bit] (AHB1, AHB2, APB1, APB2) */
+static uint8_t PeripheralClockRefCount[RCC_NUMBER_OF_BUSES][RCC_ENABLE_REG_BITS] = {{0}};
+
+/* Enable bits that were already set when their first owner acquired them */
+static uint32_t PeripheralClockPinned[RCC_NUMBER_OF_BUSES] = {0};
+
+/* Gate on / gate off transitions written by the clock manager */
+static uint32_t PeripheralClockTransitions = 0;
+
+static RCC_Status_t RCC_CheckPeripheralClockMask(uint8_t bus, uint64_t PeripheralClockMask,
+                                                 uint8_t *busIndex, volatile uint32_t **enableReg);
 
 /******************************************************************************
  *                   HSI (HIGH SPEED INTERNAL) OSCILLATOR FUNCTIONS
@@ -49,7 +77,8 @@ RCC_Status_t RCC_EnableHSI(void)
         ;
 
     // HSI is ready
-    if (0 != timeout)
+    // (the counter wraps on timeout, so the ready flag itself is checked)
+    if (0 != RCC_Registers->CR.BIT_FIELDS.HSIRDY)
     {
         status = RCC_OK;
     }
@@ -111,13 +140,17 @@ RCC_Status_t RCC_EnableHSE(void)
     // timout counter to prevent infinite loop
     uint32_t timeout = HSE_TIMEOUT_VALUE;
 
+    // Test builds can hold HSERDY low for the whole timeout (fault.h)
+    uint8_t notReady = FAULT_INJECT(FAULT_POINT_CLOCK_READY, FAULT_CLOCK_HSE);
+
     // Wait until HSE is ready or timeout occurs
     // HSERDY flag is set by hardware when HSE oscillator is stable
-    while ((0 == RCC_Registers->CR.BIT_FIELDS.HSERDY) && (timeout-- > 0))
+    while (((0 == RCC_Registers->CR.BIT_FIELDS.HSERDY) || (0 != notReady)) && (timeout-- > 0))
         ;
 
     // HSE is ready (check if timeout didn't expire)
-    if (1 != timeout)
+    // (the counter wraps on timeout, so the ready flag itself is checked)
+    if ((0 != RCC_Registers->CR.BIT_FIELDS.HSERDY) && (0 == notReady))
     {
         status = RCC_OK;
     }
@@ -149,6 +182,23 @@ uint8_t RCC_IsHSEReady(void)
     return (uint8_t)(RCC_Registers->CR.BIT_FIELDS.HSERDY);
 }
 
+/**
+ * @brief Start the High-Speed External (HSE) oscillator without waiting
+ *
+ * Sets HSEON and returns at once, the crystal start-up time (up to a few ms)
+ * can then be used for other work, poll RCC_IsHSEReady() before using HSE.
+ *
+ * @return RCC_Status_t RCC_OK
+ * @author Eng.Gemy
+ */
+RCC_Status_t RCC_StartHSE(void)
+{
+    // Enable HSE oscillator by setting HSEON bit in RCC_CR register
+    RCC_Registers->CR.BIT_FIELDS.HSEON = 1;
+
+    return RCC_OK;
+}
+
 /******************************************************************************
  *                   HSI DISABLE FUNCTION
  * @brief Function to disable HSI oscillator
@@ -328,12 +378,15 @@ RCC_Status_t RCC_EnablePLL(void)
 
     // Wait until PLL is ready (locked) or timeout occurs
     uint32_t timeout = PLL_TIMEOUT_VALUE;
+    // Test builds can hold PLLRDY low for the whole timeout (fault.h)
+    uint8_t notReady = FAULT_INJECT(FAULT_POINT_CLOCK_READY, FAULT_CLOCK_PLL);
     // PLLRDY flag is set by hardware when PLL output is stable
-    while ((0 == RCC_Registers->CR.BIT_FIELDS.PLLRDY) && (timeout-- > 0))
+    while (((0 == RCC_Registers->CR.BIT_FIELDS.PLLRDY) || (0 != notReady)) && (timeout-- > 0))
         ;
 
     // PLL is ready (locked)
-    if (1 != timeout)
+    // (the counter wraps on timeout, so the ready flag itself is checked)
+    if ((0 != RCC_Registers->CR.BIT_FIELDS.PLLRDY) && (0 == notReady))
     {
         status = RCC_OK;
     }
@@ -370,6 +423,11 @@ RCC_Status_t RCC_DisablePLL(void)
     // Disable PLL by clearing PLLON bit in RCC_CR register
     RCC_Registers->CR.BIT_FIELDS.PLLON = 0;
 
+    // PLLRDY is cleared by hardware a few cycles after PLLON
+    uint32_t timeout = PLL_TIMEOUT_VALUE;
+    while ((0 != RCC_Registers->CR.BIT_FIELDS.PLLRDY) && (timeout-- > 0))
+        ;
+
     // Check if PLL is disabled
     // PLL is disabled - PLLRDY flag should be 0
     if (0 == RCC_Registers->CR.BIT_FIELDS.PLLRDY)
@@ -406,6 +464,24 @@ uint8_t RCC_IsPLLReady(void)
     return (uint8_t)(RCC_Registers->CR.BIT_FIELDS.PLLRDY);
 }
 
+/**
+ * @brief Start the PLL without waiting for the lock
+ *
+ * Sets PLLON and returns at once, poll RCC_IsPLLReady() before selecting
+ * the PLL as system clock.
+ *
+ * @return RCC_Status_t RCC_OK
+ * @note PLL must be configured before starting
+ * @author Eng.Gemy
+ */
+RCC_Status_t RCC_StartPLL(void)
+{
+    // Enable PLL by setting PLLON bit in RCC_CR register
+    RCC_Registers->CR.BIT_FIELDS.PLLON = 1;
+
+    return RCC_OK;
+}
+
 /******************************************************************************
  *                   PLL CONFIGURATION FUNCTION
  * @brief Comprehensive PLL configuration with parameter validation
@@ -460,7 +536,7 @@ uint8_t RCC_IsPLLReady(void)
  * 
  * @note PLL must be disabled before calling this function
  * @note This function validates all PLL parameters before configuration
- * @note Flash latency is automatically adjusted for 84 MHz operation
+ * @note Flash latency is not touched here, raise it (FLASH_enuSetLatency) before switching SYSCLK to the PLL
  * @warning Incorrect PLL configuration can cause system instability
  * 
  * @example Configure PLL for 84 MHz from 16 MHz HSI:
@@ -592,17 +668,6 @@ RCC_Status_t RCC_ConfigurePLL(uint8_t Copy_PLLM, uint16_t Copy_PLLN,
                             /* Set PLL source (PLLSRC bit: 0=HSI, 1=HSE) */
                             RCC_Registers->PLLCFGR.BIT_FIELDS.PLLSRC = Copy_PLLSource;
 
-                            /* ===== Configure Flash Latency ===== */
-                            // I added them from chatGPT because when i set pll to high speed the system crashes
-                            // this will enable flash latency for 84MHz operation
-                            /* Flash latency must be adjusted when operating at high frequencies
-                             * For 84 MHz operation with 3.3V, 2 wait states are required
-                             * Flash ACR register address: 0x40023C00
-                             * Bits 2:0 = LATENCY (000=0WS, 001=1WS, 010=2WS, etc.)
-                             */
-                            *(uint32_t*)((0x40000000UL + 0x00020000UL) + 0x3C00UL) &= ~0b111;
-                            *(uint32_t*)((0x40000000UL + 0x00020000UL) + 0x3C00UL) |= (2 & 0b111);
-
                             // Configuration successful
                             status = RCC_OK;
                         }
@@ -691,9 +756,9 @@ RCC_Status_t RCC_SetAHBPrescaler(RCC_AHPPrescaler_t AHBPrescaler)
 
         /* Set AHB prescaler in CFGR register
          * HPRE bits[7:4] control AHB prescaler
-         * OR operation applies the prescaler value
+         * Clear the old field first so the prescaler can also be lowered at runtime
          */
-        RCC_Registers->CFGR.ALL_FIELDS |= AHBPrescaler;
+        RCC_Registers->CFGR.ALL_FIELDS = (RCC_Registers->CFGR.ALL_FIELDS & (uint32_t)AHB_PRESCALER_CORRECTION_MASK) | AHBPrescaler;
         status = RCC_OK;
     }
 
@@ -741,9 +806,9 @@ RCC_Status_t RCC_SetAPB1Prescaler(RCC_APB1Prescaler_t APB1Prescaler)
 
         /* Set APB1 prescaler in CFGR register
          * PPRE1 bits[12:10] control APB1 prescaler
-         * OR operation applies the prescaler value
+         * Clear the old field first so the prescaler can also be lowered at runtime
          */
-        RCC_Registers->CFGR.ALL_FIELDS |= APB1Prescaler;
+        RCC_Registers->CFGR.ALL_FIELDS = (RCC_Registers->CFGR.ALL_FIELDS & (uint32_t)APB1_PRESCALER_CORRECTION_MASK) | APB1Prescaler;
         status = RCC_OK;
     }
 
@@ -791,9 +856,9 @@ RCC_Status_t RCC_SetAPB2Prescaler(RCC_APB2Prescaler_t APB2Prescaler)
 
         /* Set APB2 prescaler in CFGR register
          * PPRE2 bits[15:13] control APB2 prescaler
-         * OR operation applies the prescaler value
+         * Clear the old field first so the prescaler can also be lowered at runtime
          */
-        RCC_Registers->CFGR.ALL_FIELDS |= APB2Prescaler;
+        RCC_Registers->CFGR.ALL_FIELDS = (RCC_Registers->CFGR.ALL_FIELDS & (uint32_t)APB2_PRESCALER_CORRECTION_MASK) | APB2Prescaler;
         status = RCC_OK;
     }
 
@@ -1273,4 +1338,540 @@ void RCC_ResetALLPeripheralClock(void)
 
 /******************************************************************************
  *                           END OF FILE
-******************************************************************************/
\ No newline at end of file
+******************************************************************************/
+
+/******************************************************************************
+ *                   CLOCK TREE SOLVER AND QUERY FUNCTIONS
+ * @brief Functions to compute PLL factors and read back bus frequencies
+ * @author Eng.Gemy
+ ******************************************************************************/
+
+/**
+ * @brief Compute PLL factors for a target system clock
+ *
+ * For every P (2,4,6,8) the required VCO output is TargetHz * P. M is then
+ * scanned from the smallest value (highest VCO input) and N is accepted only
+ * when it is an exact integer inside its range. Q is the smallest divider
+ * keeping PLL48CK <= 48 MHz; a solution giving exactly 48 MHz wins over one
+ * that does not.
+ *
+ * @param[in]  InputHz   PLL input clock frequency in Hz
+ * @param[in]  TargetHz  Desired SYSCLK frequency in Hz
+ * @param[out] Factors   Pointer to store the computed factors
+ *
+ * @return RCC_Status_t Status of the operation (RCC_OK, RCC_NOT_OK, RCC_WRONG_PLL_CONFIG)
+ * @author Eng.Gemy
+ */
+RCC_Status_t RCC_SolvePLL(uint32_t InputHz, uint32_t TargetHz, RCC_PLLFactors_t* Factors)
+{
+    RCC_Status_t status = RCC_NOT_OK;
+    bool_t found = FALSE;
+    bool_t exactUsb = FALSE;
+    uint8_t p;
+    uint8_t m;
+
+    if (NULL == Factors)
+    {
+        status = RCC_NOT_OK;
+    }
+    else if ((0 == InputHz) || (0 == TargetHz) || (TargetHz > RCC_SYSCLK_MAX))
+    {
+        status = RCC_WRONG_PLL_CONFIG;
+    }
+    else
+    {
+        for (p = 2; (p <= 8) && (FALSE == exactUsb); p += 2)
+        {
+            uint64_t vcoOut = (uint64_t)TargetHz * p;
+
+            if ((vcoOut < RCC_VCO_OUT_MIN) || (vcoOut > RCC_VCO_OUT_MAX))
+            {
+                continue;
+            }
+
+            for (m = RCC_PLLM_MIN; m <= RCC_PLLM_MAX; m++)
+            {
+                uint32_t vcoIn = InputHz / m;
+                uint64_t nScaled = vcoOut * m;
+                uint32_t n;
+                uint32_t q;
+
+                /* VCO input falls with M : skip too high, stop once too low */
+                if (vcoIn > RCC_VCO_IN_MAX)
+                {
+                    continue;
+                }
+                if (vcoIn < RCC_VCO_IN_MIN)
+                {
+                    break;
+                }
+
+                /* N = vcoOut * M / InputHz must be an exact integer */
+                if (0 != (nScaled % InputHz))
+                {
+                    continue;
+                }
+                n = (uint32_t)(nScaled / InputHz);
+                if ((n < RCC_PLLN_MIN) || (n > RCC_PLLN_MAX))
+                {
+                    continue;
+                }
+
+                /* Smallest Q keeping PLL48CK at or below 48 MHz */
+                q = (uint32_t)((vcoOut + RCC_PLL48_FREQUENCY - 1) / RCC_PLL48_FREQUENCY);
+                if (q < RCC_PLLQ_MIN)
+                {
+                    q = RCC_PLLQ_MIN;
+                }
+                if (q > RCC_PLLQ_MAX)
+                {
+                    continue;
+                }
+
+                if ((FALSE == found) || ((vcoOut / q) == RCC_PLL48_FREQUENCY))
+                {
+                    Factors->PLLM = m;
+                    Factors->PLLN = (uint16_t)n;
+                    Factors->PLLP = p;
+                    Factors->PLLQ = (uint8_t)q;
+                    found = TRUE;
+                    if (((vcoOut % q) == 0) && ((vcoOut / q) == RCC_PLL48_FREQUENCY))
+                    {
+                        exactUsb = TRUE;
+                        break;
+                    }
+                }
+            }
+        }
+
+        status = (TRUE == found) ? RCC_OK : RCC_WRONG_PLL_CONFIG;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Check the bus clocks of a clock tree before it is programmed
+ *
+ * The prescaler enums carry the CFGR field encoding, so HPRE, PPRE1 and PPRE2
+ * are extracted and divided with the same tables as RCC_GetClockHz.
+ *
+ * @param[in] SysclkHz  SYSCLK frequency in Hz
+ * @param[in] AHB       AHB prescaler
+ * @param[in] APB1      APB1 prescaler
+ * @param[in] APB2      APB2 prescaler
+ *
+ * @return RCC_Status_t Status of the operation (RCC_OK, RCC_WRONG_CLOCK_SOURCE, RCC_WRONG_APB_PRESCALER)
+ * @author Eng.Gemy
+ */
+RCC_Status_t RCC_CheckBusClocks(uint32_t SysclkHz, RCC_AHPPrescaler_t AHB,
+                                RCC_APB1Prescaler_t APB1, RCC_APB2Prescaler_t APB2)
+{
+    RCC_Status_t status = RCC_NOT_OK;
+    uint32_t hclk;
+
+    if ((0 == SysclkHz) || (SysclkHz > RCC_SYSCLK_MAX))
+    {
+        status = RCC_WRONG_CLOCK_SOURCE;
+    }
+    else
+    {
+        hclk = SysclkHz / AHBPrescalerTable[((uint32_t)AHB >> 4) & 0xFU];
+
+        if (((hclk / APBPrescalerTable[((uint32_t)APB1 >> 10) & 0x7U]) > RCC_APB1_MAX) ||
+            ((hclk / APBPrescalerTable[((uint32_t)APB2 >> 13) & 0x7U]) > RCC_APB2_MAX))
+        {
+            status = RCC_WRONG_APB_PRESCALER;
+        }
+        else
+        {
+            status = RCC_OK;
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Get the current clock frequency of a bus
+ *
+ * SYSCLK is derived from SWS (and PLLCFGR when the PLL is selected), then
+ * divided by HPRE for AHB and by PPRE1/PPRE2 for the APB buses.
+ *
+ * @param[in]  bus      Bus identifier (RCC_AHB1_BUS/AHB2_BUS/APB1_BUS/APB2_BUS)
+ * @param[out] clockHz  Pointer to store the frequency in Hz
+ *
+ * @return RCC_Status_t Status of the operation (RCC_OK, RCC_NOT_OK, RCC_WRONG_BUS_SELECTION)
+ * @author Eng.Gemy
+ */
+RCC_Status_t RCC_GetClockHz(uint8_t bus, uint32_t* clockHz)
+{
+    RCC_Status_t status = RCC_NOT_OK;
+    uint32_t hsi = (0 != RCC_HSI_ClockSourceValue) ? RCC_HSI_ClockSourceValue : RCC_HSI_DEFAULT_VALUE;
+    uint32_t sysclk;
+    uint32_t hclk;
+
+    if (NULL == clockHz)
+    {
+        status = RCC_NOT_OK;
+    }
+    else if ((bus != RCC_AHB1_BUS) && (bus != RCC_AHB2_BUS) &&
+             (bus != RCC_APB1_BUS) && (bus != RCC_APB2_BUS))
+    {
+        status = RCC_WRONG_BUS_SELECTION;
+    }
+    else
+    {
+        switch (RCC_Registers->CFGR.BIT_FIELDS.SWS)
+        {
+        case RCC_SYSCLK_HSE:
+            sysclk = RCC_HSE_ClockSourceValue;
+            break;
+        case RCC_SYSCLK_PLL:
+        {
+            uint32_t pllInput = (RCC_PLL_SOURCE_HSE == RCC_Registers->PLLCFGR.BIT_FIELDS.PLLSRC) ? RCC_HSE_ClockSourceValue : hsi;
+            uint32_t pllm = RCC_Registers->PLLCFGR.BIT_FIELDS.PLLM;
+            uint32_t plln = RCC_Registers->PLLCFGR.BIT_FIELDS.PLLN;
+            uint32_t pllp = ((uint32_t)RCC_Registers->PLLCFGR.BIT_FIELDS.PLLP + 1U) * 2U;
+            sysclk = (0 != pllm) ? (uint32_t)(((uint64_t)pllInput * plln) / ((uint64_t)pllm * pllp)) : 0;
+            break;
+        }
+        default:
+            sysclk = hsi;
+            break;
+        }
+
+        hclk = sysclk / AHBPrescalerTable[RCC_Registers->CFGR.BIT_FIELDS.HPRE];
+
+        if (bus == RCC_APB1_BUS)
+        {
+            *clockHz = hclk / APBPrescalerTable[RCC_Registers->CFGR.BIT_FIELDS.PPRE1];
+        }
+        else if (bus == RCC_APB2_BUS)
+        {
+            *clockHz = hclk / APBPrescalerTable[RCC_Registers->CFGR.BIT_FIELDS.PPRE2];
+        }
+        else
+        {
+            *clockHz = hclk;
+        }
+        status = RCC_OK;
+    }
+
+    return status;
+}
+
+/******************************************************************************
+ *                   ON-DEMAND PERIPHERAL CLOCK MANAGER
+ * @brief Reference counted peripheral clock gating
+ * @author Eng.Gemy
+ ******************************************************************************/
+
+/**
+ * @brief Validate a peripheral mask and locate its enable register
+ *
+ * @param[in]  bus                  Bus identifier
+ * @param[in]  PeripheralClockMask  64-bit mask containing bus and peripheral information
+ * @param[out] busIndex             Row of the bus in the reference count table
+ * @param[out] enableReg            Address of the xxxENR register of the bus
+ *
+ * @return RCC_Status_t Same validation results as RCC_EnablePeripheralClock
+ */
+static RCC_Status_t RCC_CheckPeripheralClockMask(uint8_t bus, uint64_t PeripheralClockMask,
+                                                 uint8_t *busIndex, volatile uint32_t **enableReg)
+{
+    RCC_Status_t status = RCC_NOT_OK;
+
+    if (0 != (bus & BUS_MASK))
+    {
+        status = RCC_WRONG_BUS_SELECTION;
+    }
+    else if (bus != (PeripheralClockMask >> 32))
+    {
+        status = RCC_WRONG_PEREPHRAL_WITHBUS_SELECTION;
+    }
+    else
+    {
+        status = RCC_OK;
+        switch (bus)
+        {
+        case RCC_AHB1_BUS:
+            *busIndex = 0;
+            *enableReg = &RCC_Registers->AHB1ENR.ALL_FIELDS;
+            if (0 != (PeripheralClockMask & AHB1_PERPHRALS_MASK))
+            {
+                status = RCC_WRONG_PEREPHRAL_SELECTION;
+            }
+            break;
+        case RCC_AHB2_BUS:
+            *busIndex = 1;
+            *enableReg = &RCC_Registers->AHB2ENR.ALL_FIELDS;
+            if (0 != (PeripheralClockMask & AHB2_PERPHRALS_MASK))
+            {
+                status = RCC_WRONG_PEREPHRAL_SELECTION;
+            }
+            break;
+        case RCC_APB1_BUS:
+            *busIndex = 2;
+            *enableReg = &RCC_Registers->APB1ENR.ALL_FIELDS;
+            if (0 != (PeripheralClockMask & APB1_PERPHRALS_MASK))
+            {
+                status = RCC_WRONG_PEREPHRAL_SELECTION;
+            }
+            break;
+        case RCC_APB2_BUS:
+            *busIndex = 3;
+            *enableReg = &RCC_Registers->APB2ENR.ALL_FIELDS;
+            if (0 != (PeripheralClockMask & APB2_PERPHRALS_MASK))
+            {
+                status = RCC_WRONG_PEREPHRAL_SELECTION;
+            }
+            break;
+        default:
+            status = RCC_WRONG_BUS_SELECTION;
+            break;
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Acquire peripheral clock(s)
+ * @details The first owner of a bit sets it in the xxxENR register, a bit
+ *          that is already set at that moment belongs to a static owner
+ *          (MCU_Configs) and is pinned on
+ */
+RCC_Status_t RCC_AcquirePeripheralClock(uint8_t bus, uint64_t PeripheralClockMask)
+{
+    RCC_Status_t status = RCC_NOT_OK;
+    volatile uint32_t *enableReg = NULL;
+    uint8_t busIndex = 0;
+    uint32_t bits = (uint32_t)(PeripheralClockMask & 0xFFFFFFFF);
+    uint32_t gateOn = 0;
+    uint8_t bit;
+
+    status = RCC_CheckPeripheralClockMask(bus, PeripheralClockMask, &busIndex, &enableReg);
+    if (RCC_OK == status)
+    {
+        NVIC_EnterCritical();
+        /* A count at its maximum cannot be released correctly : refuse the whole mask */
+        for (bit = 0; bit < RCC_ENABLE_REG_BITS; bit++)
+        {
+            if ((0 != (bits & (1UL << bit))) && (RCC_MAX_CLOCK_OWNERS == PeripheralClockRefCount[busIndex][bit]))
+            {
+                status = RCC_CLOCK_OWNERS_FULL;
+            }
+        }
+        if (RCC_OK == status)
+        {
+            for (bit = 0; bit < RCC_ENABLE_REG_BITS; bit++)
+            {
+                if (0 != (bits & (1UL << bit)))
+                {
+                    if (0 == PeripheralClockRefCount[busIndex][bit])
+                    {
+                        if (0 != (*enableReg & (1UL << bit)))
+                        {
+                            PeripheralClockPinned[busIndex] |= (1UL << bit);
+                        }
+                        else
+                        {
+                            gateOn |= (1UL << bit);
+                            PeripheralClockTransitions++;
+                        }
+                    }
+                    PeripheralClockRefCount[busIndex][bit]++;
+                }
+            }
+            if (0 != gateOn)
+            {
+                *enableReg |= gateOn;
+                /* Read back : the peripheral is usable 2 AHB/APB cycles after its enable bit is set */
+                (void)*enableReg;
+            }
+        }
+        NVIC_ExitCritical();
+    }
+
+    return status;
+}
+
+/**
+ * @brief Release peripheral clock(s)
+ * @details The last owner of a bit clears it in the xxxENR register unless
+ *          the bit is pinned by a static owner
+ */
+RCC_Status_t RCC_ReleasePeripheralClock(uint8_t bus, uint64_t PeripheralClockMask)
+{
+    RCC_Status_t status = RCC_NOT_OK;
+    volatile uint32_t *enableReg = NULL;
+    uint8_t busIndex = 0;
+    uint32_t bits = (uint32_t)(PeripheralClockMask & 0xFFFFFFFF);
+    uint32_t gateOff = 0;
+    uint8_t bit;
+
+    status = RCC_CheckPeripheralClockMask(bus, PeripheralClockMask, &busIndex, &enableReg);
+    if (RCC_OK == status)
+    {
+        NVIC_EnterCritical();
+        /* Unbalanced release leaves every count untouched */
+        for (bit = 0; bit < RCC_ENABLE_REG_BITS; bit++)
+        {
+            if ((0 != (bits & (1UL << bit))) && (0 == PeripheralClockRefCount[busIndex][bit]))
+            {
+                status = RCC_PERIPHERAL_NOT_ACQUIRED;
+            }
+        }
+        if (RCC_OK == status)
+        {
+            for (bit = 0; bit < RCC_ENABLE_REG_BITS; bit++)
+            {
+                if (0 != (bits & (1UL << bit)))
+                {
+                    PeripheralClockRefCount[busIndex][bit]--;
+                    if (0 == PeripheralClockRefCount[busIndex][bit])
+                    {
+                        if (0 != (PeripheralClockPinned[busIndex] & (1UL << bit)))
+                        {
+                            PeripheralClockPinned[busIndex] &= ~(1UL << bit);
+                        }
+                        else
+                        {
+                            gateOff |= (1UL << bit);
+                            PeripheralClockTransitions++;
+                        }
+                    }
+                }
+            }
+            *enableReg &= ~gateOff;
+        }
+        NVIC_ExitCritical();
+    }
+
+    return status;
+}
+
+/**
+ * @brief Get the number of owners of one peripheral clock
+ */
+RCC_Status_t RCC_GetPeripheralClockRefCount(uint8_t bus, uint64_t PeripheralClockMask, uint8_t *refCount)
+{
+    RCC_Status_t status = RCC_NOT_OK;
+    volatile uint32_t *enableReg = NULL;
+    uint8_t busIndex = 0;
+    uint32_t bits = (uint32_t)(PeripheralClockMask & 0xFFFFFFFF);
+    uint8_t bit = 0;
+
+    if (NULL == refCount)
+    {
+        status = RCC_NOT_OK;
+    }
+    else if ((0 == bits) || (0 != (bits & (bits - 1UL))))
+    {
+        status = RCC_WRONG_PEREPHRAL_SELECTION;
+    }
+    else
+    {
+        status = RCC_CheckPeripheralClockMask(bus, PeripheralClockMask, &busIndex, &enableReg);
+        if (RCC_OK == status)
+        {
+            while (0 == (bits & (1UL << bit)))
+            {
+                bit++;
+            }
+            *refCount = PeripheralClockRefCount[busIndex][bit];
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Get the number of clock gate transitions done by the manager
+ */
+uint32_t RCC_GetPeripheralClockTransitions(void)
+{
+    return PeripheralClockTransitions;
+}
+
+/**
+ * @brief Get the PLL input clock source
+ * @author Eng.Gemy
+ */
+RCC_Status_t RCC_GetPLLSource(uint8_t* pllSource)
+{
+    RCC_Status_t status = RCC_NOT_OK;
+
+    if (NULL != pllSource)
+    {
+        *pllSource = (uint8_t)(RCC_Registers->PLLCFGR.BIT_FIELDS.PLLSRC);
+        status = RCC_OK;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Enable the Low-Speed Internal (LSI) oscillator
+ *
+ * Sets LSION and waits for LSIRDY, same pattern as RCC_EnableHSI().
+ *
+ * @return RCC_Status_t Status of the operation (RCC_OK, RCC_TIMEOUT)
+ * @author Eng.Gemy
+ */
+RCC_Status_t RCC_EnableLSI(void)
+{
+    RCC_Status_t status = RCC_NOT_OK;
+    uint32_t timeout = LSI_TIMEOUT_VALUE;
+
+    RCC_Registers->CSR.ALL_FIELDS |= RCC_CSR_LSION_MASK;
+
+    while ((0 == (RCC_Registers->CSR.ALL_FIELDS & RCC_CSR_LSIRDY_MASK)) && (timeout-- > 0))
+        ;
+
+    if (0 != (RCC_Registers->CSR.ALL_FIELDS & RCC_CSR_LSIRDY_MASK))
+    {
+        status = RCC_OK;
+    }
+    else
+    {
+        status = RCC_TIMEOUT;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Select the RTC clock source and enable the RTC clock
+ *
+ * RTCSEL is write-once until the next backup domain reset: when another
+ * source is already selected, BDRST is pulsed before writing the new one.
+ *
+ * @return RCC_Status_t Status of the operation (RCC_OK, RCC_ERROR)
+ * @author Eng.Gemy
+ */
+RCC_Status_t RCC_SetRTCClock(uint8_t rtcSource)
+{
+    RCC_Status_t status = RCC_NOT_OK;
+
+    if ((RCC_RTC_SOURCE_LSE != rtcSource) && (RCC_RTC_SOURCE_LSI != rtcSource))
+    {
+        status = RCC_ERROR;
+    }
+    else
+    {
+        if ((0 != RCC_Registers->BDCR.BIT_FIELDS.RTCSEL) &&
+            (rtcSource != RCC_Registers->BDCR.BIT_FIELDS.RTCSEL))
+        {
+            RCC_Registers->BDCR.BIT_FIELDS.BDRST = 1;
+            RCC_Registers->BDCR.BIT_FIELDS.BDRST = 0;
+        }
+
+        RCC_Registers->BDCR.BIT_FIELDS.RTCSEL = rtcSource;
+        RCC_Registers->BDCR.BIT_FIELDS.RTCEN = 1;
+        status = RCC_OK;
+    }
+
+    return status;
+}
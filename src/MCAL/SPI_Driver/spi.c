@@ -2,9 +2,12 @@
 
 #include "LIB/stdtypes.h"
 #include "MCAL/GPIO_Driver/gpio_int.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "HAL/MCU_Driver/mcu.h"
 
 #include "MCAL/SPI_Driver/spi_priv.h"
 #include "MCAL/SPI_Driver/spi.h"
+#include "OS/fault.h"
 
 // for each spi number , for each flag , store its callback
 // 0 > RXNE_COMPLETED
@@ -46,7 +49,43 @@ static const volatile SPI_Registers_t* SPI_Instances[] = {
 
 static uint16_t *SPIReceivedData[SPI_NUMBER] = {NULL,NULL,NULL,NULL};
 
+// SCK frequency of each master SPI at init, kept to re-time BR after a clock change (0 = not a master)
+static uint32_t SPI_SckHz[SPI_NUMBER] = {0,0,0,0};
+
+// Clocks owned by each SPI : the peripheral itself and the GPIO port(s) of its pins
+static const uint8_t SPI_ClockBus[SPI_NUMBER] = {RCC_APB2_BUS, RCC_APB1_BUS, RCC_APB1_BUS, RCC_APB2_BUS};
+static const uint64_t SPI_ClockMask[SPI_NUMBER] = {
+    RCC_APB2_SPI1_CLOCK,
+    RCC_APB1_SPI2_CLOCK,
+    RCC_APB1_SPI3_CLOCK,
+    RCC_APB2_SPI4_CLOCK
+};
+static const uint64_t SPI_PortClockMask[SPI_NUMBER] = {
+    RCC_AHB1_GPIOA_CLOCK,                           // SPI1 : PA4..PA7
+    RCC_AHB1_GPIOB_CLOCK,                           // SPI2 : PB12..PB15
+    RCC_AHB1_GPIOC_CLOCK | RCC_AHB1_GPIOA_CLOCK,    // SPI3 : PC10..PC12, NSS on PA15
+    RCC_AHB1_GPIOE_CLOCK                            // SPI4 : PE11..PE14
+};
+static bool_t SPI_ClockOwned[SPI_NUMBER] = {FALSE,FALSE,FALSE,FALSE};
+
+// Pins of each SPI as port images, applied by SPI_enuInitImage (same settings as Init_SPI_Pins)
+// Order of SPI_IMAGE_PIN_x : MISO, MOSI, SCK, NSS
+#define SPI_PIN_IMAGE(port, pin, af) \
+    GPIO_IMAGE_PIN_INITIALIZER(port, pin, GPIO_MODE_ALTERNATE_FUNCTION, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_VERY_HIGH, GPIO_NO_PULL, af)
+static const GPIO_Image_t SPI_PinImages[SPI_NUMBER][4] = {
+    { SPI_PIN_IMAGE(GPIO_PORT_A, GPIO_PIN_6,  GPIO_AF5), SPI_PIN_IMAGE(GPIO_PORT_A, GPIO_PIN_7,  GPIO_AF5),
+      SPI_PIN_IMAGE(GPIO_PORT_A, GPIO_PIN_5,  GPIO_AF5), SPI_PIN_IMAGE(GPIO_PORT_A, GPIO_PIN_4,  GPIO_AF5) },
+    { SPI_PIN_IMAGE(GPIO_PORT_B, GPIO_PIN_14, GPIO_AF5), SPI_PIN_IMAGE(GPIO_PORT_B, GPIO_PIN_15, GPIO_AF5),
+      SPI_PIN_IMAGE(GPIO_PORT_B, GPIO_PIN_13, GPIO_AF5), SPI_PIN_IMAGE(GPIO_PORT_B, GPIO_PIN_12, GPIO_AF5) },
+    { SPI_PIN_IMAGE(GPIO_PORT_C, GPIO_PIN_11, GPIO_AF6), SPI_PIN_IMAGE(GPIO_PORT_C, GPIO_PIN_12, GPIO_AF6),
+      SPI_PIN_IMAGE(GPIO_PORT_C, GPIO_PIN_10, GPIO_AF6), SPI_PIN_IMAGE(GPIO_PORT_A, GPIO_PIN_15, GPIO_AF6) },
+    { SPI_PIN_IMAGE(GPIO_PORT_E, GPIO_PIN_14, GPIO_AF5), SPI_PIN_IMAGE(GPIO_PORT_E, GPIO_PIN_13, GPIO_AF5),
+      SPI_PIN_IMAGE(GPIO_PORT_E, GPIO_PIN_12, GPIO_AF5), SPI_PIN_IMAGE(GPIO_PORT_E, GPIO_PIN_11, GPIO_AF5) }
+};
+
 static SPI_Status_t Init_SPI_Pins(SPI_Config_t* config);
+static SPI_Status_t AcquireSpiClocks(SPI_Number_t spiNumber);
+static SPI_Status_t ReleaseSpiClocks(SPI_Number_t spiNumber);
 
 SPI_Status_t SPI_enuInit(SPI_Config_t* SpiConfig){
     SPI_Status_t retStatus = SPI_NOT_OK;
@@ -77,7 +116,11 @@ SPI_Status_t SPI_enuInit(SPI_Config_t* SpiConfig){
         retStatus = SPI_WRONG_NSS_MANAGEMENT;
     }else{
 
-        retStatus = Init_SPI_Pins(SpiConfig);
+        // Clock the SPI and its GPIO port(s) before touching any register
+        retStatus = AcquireSpiClocks(SpiConfig->spiNumber);
+        if(retStatus == SPI_OK){
+            retStatus = Init_SPI_Pins(SpiConfig);
+        }
         if(retStatus == SPI_OK){
             
             volatile SPI_Registers_t* SPIx = (volatile SPI_Registers_t*)SPI_Instances[SpiConfig->spiNumber];
@@ -105,19 +148,101 @@ SPI_Status_t SPI_enuInit(SPI_Config_t* SpiConfig){
             // Enable SPI after configuration
             SPIx->CR1 |= ENABLE_SPI;
 
+            // Remember the SCK frequency so it can be kept across clock changes
+            if(SpiConfig->mode == SPI_MASTER){
+                uint8_t bus = ((SpiConfig->spiNumber == SPI1) || (SpiConfig->spiNumber == SPI4)) ? RCC_APB2_BUS : RCC_APB1_BUS;
+                uint32_t pclk = 0;
+                if(RCC_GetClockHz(bus, &pclk) == RCC_OK){
+                    SPI_SckHz[SpiConfig->spiNumber] = pclk >> ((SpiConfig->baudRate >> 3) + 1);
+                }
+            }
+            MCU_enuRegisterClockNotifier(SPI_vdClockChangeNotifier);
+
             if(SpiConfig->dataLength == SPI_16_BIT_DATA){
                 SPI_MaskData[SpiConfig->spiNumber] = 0xFFFF;
             } else {
                 SPI_MaskData[SpiConfig->spiNumber] = 0x00FF;
             }
             retStatus = SPI_OK;
-        } else {
+        } else if(retStatus != SPI_CLOCK_ERROR){
             retStatus = SPI_GPIO_NOT_INITIALIZED;
+        } else {
+            // Clock manager refused the SPI clocks
         }
     }
     return retStatus;
 }
 
+SPI_Status_t SPI_enuInitImage(const SPI_Image_t* SpiImage){
+    SPI_Status_t retStatus = SPI_NOT_OK;
+    uint8_t i;
+
+    if(SpiImage == NULL){
+        retStatus = SPI_NULL_POINTER;
+    } else if(SpiImage->spiNumber > SPI_NUMBER_MASK){
+        retStatus = SPI_WRONG_SPI_NUMBER;
+    }else{
+        // The fields were checked by SPI_IMAGE_DECLARE, clock the SPI and its port(s) then apply the pins
+        retStatus = AcquireSpiClocks(SpiImage->spiNumber);
+        for(i = 0; (i < 4) && (retStatus == SPI_OK); i++){
+            if(((SpiImage->pins & (1U << i)) != 0)
+               && (GPIO_enuApplyImage(&SPI_PinImages[SpiImage->spiNumber][i]) != GPIO_OK)){
+                retStatus = SPI_GPIO_NOT_INITIALIZED;
+            }
+        }
+        if(retStatus == SPI_OK){
+            volatile SPI_Registers_t* SPIx = (volatile SPI_Registers_t*)SPI_Instances[SpiImage->spiNumber];
+
+            // Disabled while the image is stored, then enabled as SPI_enuInit does
+            SPIx->CR1 = 0;
+            SPIx->CR2 = SpiImage->CR2;
+            SPIx->CRCPR = SpiImage->CRCPR;
+            SPIx->CR1 = SpiImage->CR1;
+            SPIx->CR1 |= ENABLE_SPI;
+
+            // Remember the SCK frequency so it can be kept across clock changes
+            if((SpiImage->CR1 & SPI_MASTER) != 0){
+                uint8_t bus = ((SpiImage->spiNumber == SPI1) || (SpiImage->spiNumber == SPI4)) ? RCC_APB2_BUS : RCC_APB1_BUS;
+                uint32_t pclk = 0;
+                if(RCC_GetClockHz(bus, &pclk) == RCC_OK){
+                    SPI_SckHz[SpiImage->spiNumber] = pclk >> (((SpiImage->CR1 & ~SPI_BAUDRATE_MASK) >> 3) + 1);
+                }
+            }
+            MCU_enuRegisterClockNotifier(SPI_vdClockChangeNotifier);
+
+            SPI_MaskData[SpiImage->spiNumber] = ((SpiImage->CR1 & SPI_16_BIT_DATA) != 0) ? 0xFFFF : 0x00FF;
+        }
+    }
+    return retStatus;
+}
+
+SPI_Status_t SPI_enuDeInit(SPI_Number_t spiNumber){
+    SPI_Status_t retStatus = SPI_NOT_OK;
+
+    if(spiNumber > SPI_NUMBER_MASK){
+        retStatus = SPI_WRONG_SPI_NUMBER;
+    }else if(SPI_ClockOwned[spiNumber] == FALSE){
+        retStatus = SPI_NOT_OK;
+    }else{
+        volatile SPI_Registers_t* SPIx = (volatile SPI_Registers_t*)SPI_Instances[spiNumber];
+        uint32_t timeout = SPI_CLOCK_CHANGE_TIMEOUT;
+
+        // Wait for the last data to leave the shift register
+        while(((SPIx->SR & SPI_TXE_FLAG_MASK) == 0) && (timeout-- > 0));
+        while(((SPIx->SR & SPI_BUSY_FLAG_MASK) != 0) && (timeout-- > 0));
+
+        // Disable SPI, its interrupts and its DMA requests
+        SPIx->CR1 = 0;
+        SPIx->CR2 = 0;
+
+        SPI_SckHz[spiNumber] = 0;   // no more clock change re-timing
+        SPI_State[spiNumber] = SPI_NOT_BUSY;
+
+        retStatus = ReleaseSpiClocks(spiNumber);
+    }
+    return retStatus;
+}
+
 
 SPI_Status_t SPI_enuMasterSyncTransmitReceive(SPI_Number_t spiNumber, uint16_t TxData, uint16_t* RxData){
     SPI_Status_t retStatus = SPI_NOT_OK;
@@ -501,7 +626,139 @@ SPI_Status_t SPI_enuRegisterCallback(SPI_Number_t spiNumber, SPI_Flag_t flag, SP
 }
 
 
+SPI_Status_t SPI_enuCalculateBaudRate(SPI_Number_t spiNumber, uint32_t maxSckHz, SPI_BaudRate_t* baudRate){
+    SPI_Status_t retStatus = SPI_NOT_OK;
+    uint32_t pclk = 0;
 
+    if(spiNumber > SPI_NUMBER_MASK){
+        retStatus = SPI_WRONG_SPI_NUMBER; // Indicate error for invalid SPI number
+    }else if(baudRate == NULL){
+        retStatus = SPI_NULL_POINTER; // Indicate null pointer error
+    }else if(maxSckHz == 0){
+        retStatus = SPI_WRONG_BAUDRATE; // Indicate error for invalid SCK frequency
+    }else{
+        // SPI1 and SPI4 sit on APB2, SPI2 and SPI3 sit on APB1
+        uint8_t bus = ((spiNumber == SPI1) || (spiNumber == SPI4)) ? RCC_APB2_BUS : RCC_APB1_BUS;
+        if(RCC_GetClockHz(bus, &pclk) != RCC_OK){
+            retStatus = SPI_NOT_OK;
+        }else{
+            // BR = 0 > DIV2 ... BR = 7 > DIV256 , take the first one not exceeding maxSckHz
+            uint32_t br = 0;
+            while((br < 7) && ((pclk >> (br + 1)) > maxSckHz)){
+                br++;
+            }
+            if((pclk >> (br + 1)) > maxSckHz){
+                retStatus = SPI_WRONG_BAUDRATE; // Even DIV256 is faster than requested
+            }else{
+                *baudRate = (SPI_BaudRate_t)(br << 3);
+                retStatus = SPI_OK;
+            }
+        }
+    }
+    return retStatus;
+}
+
+SPI_Status_t SPI_enuGetDataRegisterAddress(SPI_Number_t spiNumber, uint32_t* address){
+    SPI_Status_t retStatus = SPI_NOT_OK;
+
+    if(spiNumber > SPI_NUMBER_MASK){
+        retStatus = SPI_WRONG_SPI_NUMBER; // Indicate error for invalid SPI number
+    }else if(address == NULL){
+        retStatus = SPI_NULL_POINTER; // Indicate null pointer error
+    }else{
+        *address = (uint32_t)&SPI_Instances[spiNumber]->DR;
+        retStatus = SPI_OK;
+    }
+    return retStatus;
+}
+
+SPI_Status_t SPI_enuGetFrameTime(SPI_Number_t spiNumber, uint32_t* frameNs){
+    SPI_Status_t retStatus = SPI_NOT_OK;
+    uint32_t pclk = 0;
+
+    if(spiNumber > SPI_NUMBER_MASK){
+        retStatus = SPI_WRONG_SPI_NUMBER; // Indicate error for invalid SPI number
+    }else if(frameNs == NULL){
+        retStatus = SPI_NULL_POINTER; // Indicate null pointer error
+    }else if(SPI_ClockOwned[spiNumber] == FALSE){
+        retStatus = SPI_NOT_OK; // Registers not clocked, nothing configured
+    }else{
+        uint8_t bus = ((spiNumber == SPI1) || (spiNumber == SPI4)) ? RCC_APB2_BUS : RCC_APB1_BUS;
+        if((RCC_GetClockHz(bus, &pclk) != RCC_OK) || (pclk == 0)){
+            retStatus = SPI_NOT_OK;
+        }else{
+            uint32_t cr1 = SPI_Instances[spiNumber]->CR1;
+            // BR = 0 > DIV2 ... BR = 7 > DIV256, one SCK period per bit
+            uint32_t divider = 2UL << ((cr1 & ~SPI_BAUDRATE_MASK) >> 3);
+            uint32_t bits = ((cr1 & ~SPI_DATA_LENGTH_MASK) != 0) ? 16UL : 8UL;
+            *frameNs = (uint32_t)(((uint64_t)bits * divider * 1000000000ULL) / pclk);
+            retStatus = SPI_OK;
+        }
+    }
+    return retStatus;
+}
+
+void SPI_vdClockChangeNotifier(uint8_t phase){
+    uint8_t spiIndex;
+
+    for(spiIndex = 0; spiIndex < SPI_NUMBER; spiIndex++){
+        if(SPI_SckHz[spiIndex] == 0){
+            continue; // Not initialized as master
+        }
+        volatile SPI_Registers_t* SPIx = (volatile SPI_Registers_t*)SPI_Instances[spiIndex];
+
+        if(phase == RCC_CLOCK_PRE_CHANGE){
+            // Wait for the last data to leave the shift register
+            uint32_t timeout = SPI_CLOCK_CHANGE_TIMEOUT;
+            while(((SPIx->SR & SPI_TXE_FLAG_MASK) == 0) && (timeout-- > 0));
+            while(((SPIx->SR & SPI_BUSY_FLAG_MASK) != 0) && (timeout-- > 0));
+        }else if(phase == RCC_CLOCK_POST_CHANGE){
+            SPI_BaudRate_t baudRate;
+            if(SPI_enuCalculateBaudRate((SPI_Number_t)spiIndex, SPI_SckHz[spiIndex], &baudRate) != SPI_OK){
+                baudRate = SPI_BAUDRATE_DIV256; // Slowest possible when the old SCK cannot be kept
+            }
+            // BR must not change while SPI is enabled
+            SPIx->CR1 &= DISABLE_SPI;
+            SPIx->CR1 = (SPIx->CR1 & SPI_BAUDRATE_MASK) | baudRate;
+            SPIx->CR1 |= ENABLE_SPI;
+        }else{
+            // Unknown phase, nothing to do
+        }
+    }
+}
+
+
+// Acquires the SPI and GPIO port clocks once per SPI (a second init keeps the same owner)
+static SPI_Status_t AcquireSpiClocks(SPI_Number_t spiNumber){
+    SPI_Status_t status = SPI_CLOCK_ERROR;
+
+    if(SPI_ClockOwned[spiNumber] == TRUE){
+        status = SPI_OK;
+    }else if(RCC_AcquirePeripheralClock(RCC_AHB1_BUS, SPI_PortClockMask[spiNumber]) != RCC_OK){
+        status = SPI_CLOCK_ERROR;
+    }else if(RCC_AcquirePeripheralClock(SPI_ClockBus[spiNumber], SPI_ClockMask[spiNumber]) != RCC_OK){
+        RCC_ReleasePeripheralClock(RCC_AHB1_BUS, SPI_PortClockMask[spiNumber]);
+        status = SPI_CLOCK_ERROR;
+    }else{
+        SPI_ClockOwned[spiNumber] = TRUE;
+        status = SPI_OK;
+    }
+    return status;
+}
+
+// Releases the clocks taken by AcquireSpiClocks, they are gated off when this was the last owner
+static SPI_Status_t ReleaseSpiClocks(SPI_Number_t spiNumber){
+    SPI_Status_t status = SPI_OK;
+
+    if(RCC_ReleasePeripheralClock(SPI_ClockBus[spiNumber], SPI_ClockMask[spiNumber]) != RCC_OK){
+        status = SPI_CLOCK_ERROR;
+    }
+    if(RCC_ReleasePeripheralClock(RCC_AHB1_BUS, SPI_PortClockMask[spiNumber]) != RCC_OK){
+        status = SPI_CLOCK_ERROR;
+    }
+    SPI_ClockOwned[spiNumber] = FALSE;
+    return status;
+}
 
 static SPI_Status_t Init_SPI_Pins(SPI_Config_t* config) {
     SPI_Status_t status = SPI_NOT_OK;
@@ -731,6 +988,11 @@ static void SPI_Private_IRQHandler(SPI_Number_t spiNumber){
             SPI_Tx_Callbacks[spiNumber][SPI_FLAG_OVERRUN_ERROR]();
         }
         SPI_enuClearFlag(spiNumber,SPI_FLAG_OVERRUN_ERROR);
+    }else if(FAULT_INJECT(FAULT_POINT_SPI_OVERRUN, spiNumber) != 0){
+        // Injected : the callback only, no clear sequence on a flag that is not set
+        if(SPI_Tx_Callbacks[spiNumber][SPI_FLAG_OVERRUN_ERROR] != NULL){
+            SPI_Tx_Callbacks[spiNumber][SPI_FLAG_OVERRUN_ERROR]();
+        }
     }
 
     if(SPI_u8ReadFlag(spiNumber,SPI_FLAG_UNDERRUN_ERROR) == 1){
@@ -747,6 +1009,11 @@ static void SPI_Private_IRQHandler(SPI_Number_t spiNumber){
             SPI_Tx_Callbacks[spiNumber][SPI_FLAG_CRC_ERROR]();
         }
         SPI_enuClearFlag(spiNumber,SPI_FLAG_CRC_ERROR);
+    }else if(FAULT_INJECT(FAULT_POINT_SPI_CRC, spiNumber) != 0){
+        // Injected : the callback only, no clear sequence on a flag that is not set
+        if(SPI_Tx_Callbacks[spiNumber][SPI_FLAG_CRC_ERROR] != NULL){
+            SPI_Tx_Callbacks[spiNumber][SPI_FLAG_CRC_ERROR]();
+        }
     }
 
     if(SPI_u8ReadFlag(spiNumber,SPI_FLAG_MODE_FAULT) == 1){
@@ -755,6 +1022,11 @@ static void SPI_Private_IRQHandler(SPI_Number_t spiNumber){
             SPI_Tx_Callbacks[spiNumber][SPI_FLAG_MODE_FAULT]();
         }
         SPI_enuClearFlag(spiNumber,SPI_FLAG_MODE_FAULT);
+    }else if(FAULT_INJECT(FAULT_POINT_SPI_MODE_FAULT, spiNumber) != 0){
+        // Injected : the callback only, no clear sequence on a flag that is not set
+        if(SPI_Tx_Callbacks[spiNumber][SPI_FLAG_MODE_FAULT] != NULL){
+            SPI_Tx_Callbacks[spiNumber][SPI_FLAG_MODE_FAULT]();
+        }
     }
 
     if(SPI_u8ReadFlag(spiNumber,SPI_FLAG_FRAME_FORMAT_ERROR) == 1){
@@ -1,7 +1,9 @@
 #include "LIB/stdtypes.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
 
 #include "MCAL/SYSTICK_TIMER_Driver/systick_priv.h"
 #include "MCAL/SYSTICK_TIMER_Driver/systick.h"
+#include "OS/trace.h"
 
 /* Forward declaration of the SysTick interrupt handler */
 void SysTick_Handler(void);
@@ -20,6 +22,7 @@ static uint32_t clockSourceValue=0;
  * Description: Initializes the SysTick timer with the specified clock frequency and prescaler
  * Parameters:
  *   - ClockValue: System clock frequency in Hz
+ *                 SYSTICK_CLOCK_AUTO reads the current HCLK from the RCC driver
  *   - prescaller: Clock source selection (processor clock or AHB/8)
  * Returns: Status code indicating success or specific error condition
  */
@@ -30,14 +33,24 @@ SYSTICK_Status_t SYSTICK_Init(uint32_t ClockValue,SYSTICK_Prescaller_t prescalle
     if((SYSTICK_NO_PRESCALLER!= prescaller)&&(SYSTICK_PRESCALLER_8!= prescaller)){
         status = SYSTICK_WRONG_PRESCALLER;
     }else{
-        /* Set the clock source bit in the control register */
-        SYSTICK_Registers->STK_CTRL |= prescaller;
+        /* Set the clock source bit in the control register, cleared first so a second init can select AHB/8 */
+        SYSTICK_Registers->STK_CTRL = (SYSTICK_Registers->STK_CTRL & ~SYSTICK_PRESCALLER_MASK_CHECK) | prescaller;
         
+        /* Give SysTick the lowest priority so BASEPRI critical sections can mask it */
+        SYSTICK_SCB_SHPR3 = (SYSTICK_SCB_SHPR3 & SYSTICK_PRIORITY_CLEAR_MASK) | SYSTICK_LOWEST_PRIORITY;
+
         /* Enable SysTick exception (interrupt) by setting bit 1 */
         SYSTICK_Registers->STK_CTRL |= SYSTICK_ENABLE_EXCEPTION;
         
         /* Store the clock frequency for later calculations */
         clockSourceValue = ClockValue;
+
+        /* Resolve the processor clock from the clock tree when asked to */
+        if(SYSTICK_CLOCK_AUTO == ClockValue){
+            if(RCC_OK != RCC_GetClockHz(RCC_AHB1_BUS, &clockSourceValue)){
+                clockSourceValue = 0;
+            }
+        }
         
         status = SYSTICK_OK;
     }
@@ -187,6 +200,67 @@ SYSTICK_Status_t SYSTICK_GetCurrentCount(uint32_t *currentCount){
     return status;
 }
 
+/*
+ * Function: SYSTICK_GetStartValue
+ * Description: Reads the reload value of the SysTick counter
+ * Parameters:
+ *   - startValue: Pointer to store the STK_LOAD value
+ * Returns: Status code indicating success or NULL pointer error
+ */
+SYSTICK_Status_t SYSTICK_GetStartValue(uint32_t *startValue){
+    SYSTICK_Status_t status = SYSTICK_NOT_OK;
+
+    /* Validate the pointer parameter */
+    if(NULL == startValue){
+        status = SYSTICK_NULL_PTR;
+    }else{
+        /* Read the reload value from the STK_LOAD register */
+        *startValue = SYSTICK_Registers->STK_LOAD;
+        status = SYSTICK_OK;
+    }
+    return status;
+}
+
+/*
+ * Function: SYSTICK_GetPeriod
+ * Description: Computes the SysTick period from STK_LOAD, CLKSOURCE and the current HCLK
+ * Parameters:
+ *   - periodNs: Pointer to store the period in ns
+ * Returns: Status code indicating success, NULL pointer, zero reload value or no clock
+ * Note: The clock is read from RCC, not from the value given to SYSTICK_Init,
+ *       so the model follows a runtime clock profile switch
+ */
+SYSTICK_Status_t SYSTICK_GetPeriod(uint32_t *periodNs){
+    SYSTICK_Status_t status = SYSTICK_NOT_OK;
+    uint32_t clockSource = 0;
+
+    /* Validate the pointer parameter */
+    if(NULL == periodNs){
+        status = SYSTICK_NULL_PTR;
+    }else if(0 == (SYSTICK_Registers->STK_LOAD)){
+        status = SYSTICK_ZERO_STARTVALUE;
+    }else if((RCC_OK != RCC_GetClockHz(RCC_AHB1_BUS, &clockSource)) || (0 == clockSource)){
+        status = SYSTICK_NOT_OK;
+    }else{
+        /* External clock (AHB/8) when the CLKSOURCE bit (bit 2) is clear */
+        if(0 == (SYSTICK_Registers->STK_CTRL & SYSTICK_PRESCALLER_MASK_CHECK)){
+            clockSource = clockSource / 8;
+        }
+
+        /* One period is LOAD + 1 counts, 64-bit product so a full 24-bit reload cannot overflow */
+        uint64_t period = (((uint64_t)SYSTICK_Registers->STK_LOAD + 1U) * 1000000000ULL) / clockSource;
+
+        /* Above ~4.29 s (long reload on HCLK / 8) the period does not fit the result */
+        if(period > 0xFFFFFFFFULL){
+            status = SYSTICK_WRONG_STARTVALUE;
+        }else{
+            *periodNs = (uint32_t)period;
+            status = SYSTICK_OK;
+        }
+    }
+    return status;
+}
+
 /*
  * Function: SYSTICK_GetCounterFlag
  * Description: Reads the COUNTFLAG bit which indicates if timer counted to 0 since last read
@@ -209,6 +283,34 @@ SYSTICK_Status_t SYSTICK_GetCounterFlag(uint8_t *CounterFlag){
     return status;
 }
 
+/*
+ * Function: SYSTICK_vdClockChangeNotifier
+ * Description: Keeps SysTick timing correct across a runtime clock change
+ * Parameters:
+ *   - phase: RCC_CLOCK_PRE_CHANGE or RCC_CLOCK_POST_CHANGE
+ * Returns: None
+ * Note: On RCC_CLOCK_POST_CHANGE the reload value is scaled by newClock/oldClock
+ *       so the tick period is unchanged, and the stored clock used by
+ *       SYSTICK_Wait_ms is refreshed. Nothing is needed before the change.
+ */
+void SYSTICK_vdClockChangeNotifier(uint8_t phase){
+    uint32_t newClockValue = 0;
+
+    if((RCC_CLOCK_POST_CHANGE == phase) && (RCC_OK == RCC_GetClockHz(RCC_AHB1_BUS, &newClockValue))){
+        if((0 != clockSourceValue) && (0 != newClockValue)){
+            /* Same period in the new clock : (LOAD + 1) scales with the frequency */
+            uint64_t newLoad = (((uint64_t)SYSTICK_Registers->STK_LOAD + 1U) * newClockValue) / clockSourceValue;
+
+            if((newLoad > 1U) && (0 == ((newLoad - 1U) & SYSTICK_STARTVALUE_MASK))){
+                SYSTICK_Registers->STK_LOAD = (uint32_t)(newLoad - 1U);
+                /* Restart the current period with the new reload value */
+                SYSTICK_Registers->STK_VAL = 0;
+            }
+        }
+        clockSourceValue = newClockValue;
+    }
+}
+
 /*
  * Function: SysTick_Handler
  * Description: SysTick interrupt service routine (ISR)
@@ -216,8 +318,11 @@ SYSTICK_Status_t SYSTICK_GetCounterFlag(uint8_t *CounterFlag){
  * Parameters: None
  * Returns: None
  * Note: This is the actual interrupt handler that executes on every SysTick exception
+ *       Runs from RAM (RAMFUNC) : no flash wait states on every tick
  */
-void SysTick_Handler(void){
+RAMFUNC void SysTick_Handler(void){
+    TRACE_EVENT(TRACE_EVENT_ISR_ENTER, TRACE_SOURCE_SYSTICK);
+
     /* Increment the interrupt counter used by SYSTICK_Wait_ms */
     systick_counter++;
 
@@ -225,4 +330,6 @@ void SysTick_Handler(void){
     if(NULL != callback){
         callback();
     }
+
+    TRACE_EVENT(TRACE_EVENT_ISR_EXIT, TRACE_SOURCE_SYSTICK);
 }
\ No newline at end of file
@@ -1,16 +1,27 @@
 #include "LIB/stdtypes.h"
 #include <string.h>
 #include "MCAL/GPIO_Driver/gpio_int.h"
+#include "MCAL/NVIC_Driver/nvic.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "HAL/MCU_Driver/mcu.h"
+#include "HAL/BOARD_Driver/board_cfg.h"
+#include "HAL/BOARD_Driver/board.h"
 #include "MCAL/UART_Driver/uart_priv.h"
 #include "MCAL/UART_Driver/uart.h"
+#include "OS/trace.h"
+#include "OS/fault.h"
 
 
 void USART1_IRQHandler(void);
 void USART2_IRQHandler(void);
 void USART6_IRQHandler(void);
 static uint16_t CalculateBaudRate(uint32_t peripheralClock, uint32_t baudRate, UART_OverSampling_t oversampling) ;
-static UART_Status_t Init_UART_Pins(UART_Config_t* config);
+static uint32_t GetPeripheralClock(UART_Number_t uartNumber, uint32_t configuredClock);
+static UART_Status_t Init_UART_Pins(UART_Number_t uartNumber, uint32_t uartEnabled);
 static void USART_LocalHandler(UART_Number_t uartNumber);
+static UART_Status_t AcquireUartClocks(UART_Number_t uartNumber);
+static UART_Status_t ReleaseUartClocks(UART_Number_t uartNumber);
+static uint8_t IsDmaTxPending(volatile UARTRegs_t* uart);
 
 static LocalFlags_t LocalFlags = {0};
 static UART_InitState_t UART_InitState = UART_NOT_INIT;
@@ -36,6 +47,37 @@ static UART_Callbacks_t UartCallbacks[3] = {
 };
 static UART_AsynBuffer_t TxBuffers[3] = {0};
 static UART_AsynBuffer_t RxBuffers[3] = {0};
+// Baud rate settings kept per UART to re-time BRR after a clock change (0 = not initialized)
+static uint32_t UART_BaudRates[3] = {0};
+static UART_OverSampling_t UART_OverSamplings[3] = {UART_OVERSAMPLING_16, UART_OVERSAMPLING_16, UART_OVERSAMPLING_16};
+// UART_CLOCK_ERROR when BRR could not be re-timed after a clock change, the old BRR is kept
+static UART_Status_t UART_ClockStatus[3] = {UART_OK, UART_OK, UART_OK};
+// Clocks owned by each UART : the peripheral itself and the GPIO port of its TX/RX pins
+static const uint8_t UART_ClockBus[3] = {RCC_APB2_BUS, RCC_APB1_BUS, RCC_APB2_BUS};
+static const uint64_t UART_ClockMask[3] = {RCC_APB2_USART1_CLOCK, RCC_APB1_USART2_CLOCK, RCC_APB2_USART6_CLOCK};
+static const uint64_t UART_PortClockMask[3] = {
+    BOARD_PORT_CLOCK(BOARD_UART1_TX_PORT) | BOARD_PORT_CLOCK(BOARD_UART1_RX_PORT),
+    BOARD_PORT_CLOCK(BOARD_UART2_TX_PORT) | BOARD_PORT_CLOCK(BOARD_UART2_RX_PORT),
+    BOARD_PORT_CLOCK(BOARD_UART6_TX_PORT) | BOARD_PORT_CLOCK(BOARD_UART6_RX_PORT)
+};
+static bool_t UART_ClockOwned[3] = {FALSE, FALSE, FALSE};
+// TX / RX pins of each UART as port images, folded from board_cfg.h (BOARD_UARTx_TX_PINS / _RX_PINS)
+static const GPIO_Image_t UART_TxPinImage[3] = {
+    BOARD_PORT_IMAGE_INITIALIZER(BOARD_UART1_TX_PORT, BOARD_UART1_TX_PINS),
+    BOARD_PORT_IMAGE_INITIALIZER(BOARD_UART2_TX_PORT, BOARD_UART2_TX_PINS),
+    BOARD_PORT_IMAGE_INITIALIZER(BOARD_UART6_TX_PORT, BOARD_UART6_TX_PINS)
+};
+static const GPIO_Image_t UART_RxPinImage[3] = {
+    BOARD_PORT_IMAGE_INITIALIZER(BOARD_UART1_RX_PORT, BOARD_UART1_RX_PINS),
+    BOARD_PORT_IMAGE_INITIALIZER(BOARD_UART2_RX_PORT, BOARD_UART2_RX_PINS),
+    BOARD_PORT_IMAGE_INITIALIZER(BOARD_UART6_RX_PORT, BOARD_UART6_RX_PINS)
+};
+// TRUE when the UART pins are part of the fitted set, BOARD_enuInit applied them at boot
+static const bool_t UART_PinsFitted[3] = {
+    (BOARD_PINS_FITTED(BOARD_UART1_TX_PORT, BOARD_UART1_TX_PINS) && BOARD_PINS_FITTED(BOARD_UART1_RX_PORT, BOARD_UART1_RX_PINS)) ? TRUE : FALSE,
+    (BOARD_PINS_FITTED(BOARD_UART2_TX_PORT, BOARD_UART2_TX_PINS) && BOARD_PINS_FITTED(BOARD_UART2_RX_PORT, BOARD_UART2_RX_PINS)) ? TRUE : FALSE,
+    (BOARD_PINS_FITTED(BOARD_UART6_TX_PORT, BOARD_UART6_TX_PINS) && BOARD_PINS_FITTED(BOARD_UART6_RX_PORT, BOARD_UART6_RX_PINS)) ? TRUE : FALSE
+};
 UART_Status_t UART_enuInit(UART_Config_t* config) {
     
     UART_Status_t status = UART_NOT_OK;
@@ -67,8 +109,15 @@ UART_Status_t UART_enuInit(UART_Config_t* config) {
                                     if((config->InterruptFlags & UART_INTERRUPT_MASK) != 0){
                                         status = UART_WRONG_INTERRUPT_FLAGS;
                                     }else{
-                                        // Initialize UART pins
-                                        status = Init_UART_Pins(config);
+                                        // Clock the UART and its GPIO port, then initialize UART pins
+                                        status = AcquireUartClocks(config->UART_Number);
+                                        if(status == UART_OK){
+                                            status = Init_UART_Pins(config->UART_Number, config->UartEnabled);
+                                        }
+                                        if((status == UART_OK) && (GetPeripheralClock(config->UART_Number, config->PeripheralClock) == 0)){
+                                            // Unknown APB clock : BRR would be 0 and the UART silent
+                                            status = UART_CLOCK_ERROR;
+                                        }
                                         if(status == UART_OK){
 
                                             volatile UARTRegs_t* uart = UART_Registers[config->UART_Number];
@@ -84,15 +133,24 @@ UART_Status_t UART_enuInit(UART_Config_t* config) {
                                             uart->CR3 |= (config->InterruptFlags & UART_CR3_FLAGS_MASK);
 
                                             // Calculate and set baud rate
-                                            uart->BRR = CalculateBaudRate(config->PeripheralClock, config->BaudRate, config->OverSampling);
+                                            uart->BRR = CalculateBaudRate(GetPeripheralClock(config->UART_Number, config->PeripheralClock),
+                                                                          config->BaudRate, config->OverSampling);
 
                                             uart->CR1 |= UART_ENABLE; // Enable UART
 
+                                            // Keep the timing settings for clock change notifications
+                                            UART_BaudRates[config->UART_Number] = config->BaudRate;
+                                            UART_OverSamplings[config->UART_Number] = config->OverSampling;
+                                            UART_ClockStatus[config->UART_Number] = UART_OK;
+                                            MCU_enuRegisterClockNotifier(UART_vdClockChangeNotifier);
+
                                             UART_InitState = UART_INIT;
                                             status = UART_OK;
-                                        }else{
+                                        }else if(status != UART_CLOCK_ERROR){
                                             // GPIO error
                                             status = UART_GPIO_ERROR;
+                                        }else{
+                                            // Clock manager refused the UART clocks
                                         }
                                     }
                                 }
@@ -107,6 +165,86 @@ UART_Status_t UART_enuInit(UART_Config_t* config) {
 }
 
 
+UART_Status_t UART_enuInitImage(const UART_Image_t* image) {
+    UART_Status_t status = UART_NOT_OK;
+
+    if (image == NULL) {
+        status = UART_NULL_PTR;
+    } else if (image->UART_Number > UART_6) {
+        status = UART_WRONG_UART_NUMBER;
+    } else {
+        // The fields were checked by UART_IMAGE_DECLARE, clock the UART and its port then apply the pins
+        status = AcquireUartClocks(image->UART_Number);
+        if (status == UART_OK) {
+            status = Init_UART_Pins(image->UART_Number, image->CR1);
+        }
+        if ((status == UART_OK) && (GetPeripheralClock(image->UART_Number, UART_PERIPHERAL_CLOCK_AUTO) == 0)) {
+            // Unknown APB clock : the image BRR cannot be checked against it
+            status = UART_CLOCK_ERROR;
+        }
+        if (status == UART_OK) {
+            volatile UARTRegs_t* uart = UART_Registers[image->UART_Number];
+            UART_OverSampling_t overSampling = (UART_OverSampling_t)(image->CR1 & ~UART_OVERSAMPLING_MASK);
+            uint32_t fck = GetPeripheralClock(image->UART_Number, UART_PERIPHERAL_CLOCK_AUTO);
+
+            uart->CR1 = image->CR1;
+            uart->CR2 = image->CR2;
+            uart->CR3 = image->CR3;
+
+            // The image BRR holds for the APB clock it was built for, re-timed for any other
+            if (fck != image->PclkHz) {
+                uart->BRR = CalculateBaudRate(fck, image->BaudRate, overSampling);
+            } else {
+                uart->BRR = image->BRR;
+            }
+
+            uart->CR1 |= UART_ENABLE; // Enable UART
+
+            // Keep the timing settings for clock change notifications
+            UART_BaudRates[image->UART_Number] = image->BaudRate;
+            UART_OverSamplings[image->UART_Number] = overSampling;
+            UART_ClockStatus[image->UART_Number] = UART_OK;
+            MCU_enuRegisterClockNotifier(UART_vdClockChangeNotifier);
+
+            UART_InitState = UART_INIT;
+        }
+    }
+    return status;
+}
+
+UART_Status_t UART_enuDeInit(UART_Number_t uartNumber) {
+    UART_Status_t status = UART_NOT_OK;
+
+    if (uartNumber > UART_6) {
+        status = UART_WRONG_UART_NUMBER;
+    } else if (UART_ClockOwned[uartNumber] == FALSE) {
+        status = UART_NOT_INIT_SUCCESSFULLY;
+    } else {
+        volatile UARTRegs_t* uart = UART_Registers[uartNumber];
+        uint32_t timeout = UART_CLOCK_CHANGE_TIMEOUT;
+
+        // Let the last frame leave the shift register
+        while (((uart->SR & (1UL << UART_TC_FLAG_POSITION)) == 0) && (timeout-- > 0));
+
+        // Disable the UART, its interrupts and its DMA requests
+        uart->CR1 = 0;
+        uart->CR2 = 0;
+        uart->CR3 = 0;
+
+        UART_BaudRates[uartNumber] = 0;   // no more clock change re-timing
+        UART_Tx_State[uartNumber] = UART_READY;
+        UART_Rx_State[uartNumber] = UART_READY;
+
+        status = ReleaseUartClocks(uartNumber);
+
+        // The init state is shared : it is cleared with the last initialized UART
+        if ((UART_ClockOwned[UART_1] == FALSE) && (UART_ClockOwned[UART_2] == FALSE) && (UART_ClockOwned[UART_6] == FALSE)) {
+            UART_InitState = UART_NOT_INIT;
+        }
+    }
+    return status;
+}
+
 UART_Status_t UART_enuSynTransmitBuffer(UART_Number_t uartNumber, const uint8_t* txBuffer, uint16_t size) {
     UART_Status_t status = UART_NOT_OK;
 
@@ -118,6 +256,9 @@ UART_Status_t UART_enuSynTransmitBuffer(UART_Number_t uartNumber, const uint8_t*
         }else{
             if(UART_InitState != UART_INIT) {
                 status = UART_NOT_INIT_SUCCESSFULLY;
+            }else if(UART_ClockStatus[uartNumber] != UART_OK) {
+                // The baud rate does not match the running APB clock
+                status = UART_CLOCK_ERROR;
             }else{
 
                 UARTRegs_t* uart = UART_Registers[uartNumber];
@@ -148,7 +289,13 @@ UART_Status_t UART_enuAsynTransmitBuffer(UART_Number_t uartNumber, UART_AsynBuff
         }else{
             if(UART_InitState != UART_INIT) {
                 status = UART_NOT_INIT_SUCCESSFULLY;
+            }else if(UART_ClockStatus[uartNumber] != UART_OK) {
+                // The baud rate does not match the running APB clock
+                status = UART_CLOCK_ERROR;
             }else{
+                // TxBuffers and the Tx state are shared with the USART ISR :
+                // only the claim of the channel is done with the ISR masked
+                NVIC_EnterCritical();
                 if(UART_Tx_State[uartNumber] == UART_BUSY) {
                     status = UART_TX_BUSY; // UART is busy
                 } else {
@@ -160,6 +307,12 @@ UART_Status_t UART_enuAsynTransmitBuffer(UART_Number_t uartNumber, UART_AsynBuff
                     TxBuffers[uartNumber].callback = txBuffer->callback;
                     TxBuffers[uartNumber].index = 0;
 
+                    status = UART_OK;
+                }
+                NVIC_ExitCritical();
+
+                // The channel is ours and TXE interrupt is still off, the ISR does not touch TxBuffers
+                if(status == UART_OK) {
                     // Start transmission by sending the first byte
                     UARTRegs_t* uart = UART_Registers[uartNumber];
 
@@ -172,8 +325,8 @@ UART_Status_t UART_enuAsynTransmitBuffer(UART_Number_t uartNumber, UART_AsynBuff
 
                     // Enable TXE interrupt
                     uart->CR1 |= UART_INTERRUPT_TXE_LOCAL_ENABLE;
-
-                    status = UART_OK;
+                }else{
+                    // channel busy
                 }
             }
         }
@@ -195,6 +348,9 @@ UART_Status_t UART_enuSynReceiveBuffer(UART_Number_t uartNumber, uint8_t* rxBuff
         }else{
             if(UART_InitState != UART_INIT) {
                 status = UART_NOT_INIT_SUCCESSFULLY;
+            }else if(UART_ClockStatus[uartNumber] != UART_OK) {
+                // The baud rate does not match the running APB clock
+                status = UART_CLOCK_ERROR;
             }else{
 
                 UARTRegs_t* uart = UART_Registers[uartNumber];
@@ -225,6 +381,9 @@ UART_Status_t UART_enuAsynReceiveBuffer(UART_Number_t uartNumber, UART_AsynBuffe
         }else{
             if(UART_InitState != UART_INIT) {
                 status = UART_NOT_INIT_SUCCESSFULLY;
+            }else if(UART_ClockStatus[uartNumber] != UART_OK) {
+                // The baud rate does not match the running APB clock
+                status = UART_CLOCK_ERROR;
             }else{
                 if(UART_Rx_State[uartNumber] == UART_BUSY) {
                     status = UART_TX_BUSY; // UART is busy
@@ -253,6 +412,31 @@ UART_Status_t UART_enuAsynReceiveBuffer(UART_Number_t uartNumber, UART_AsynBuffe
     return status;
 }
 
+UART_Status_t UART_enuAbortAsynReceive(UART_Number_t uartNumber, uint16_t* receivedCount) {
+    UART_Status_t status = UART_NOT_OK;
+
+    if (receivedCount == NULL) {
+        status = UART_NULL_PTR;
+    } else if (uartNumber > UART_6) {
+        status = UART_WRONG_UART_NUMBER;
+    } else if (UART_InitState != UART_INIT) {
+        status = UART_NOT_INIT_SUCCESSFULLY;
+    } else {
+        UARTRegs_t* uart = UART_Registers[uartNumber];
+
+        // RxBuffers and the Rx state are shared with the USART ISR
+        NVIC_EnterCritical();
+        uart->CR1 &= UART_INTERRUPT_RXNE_LOCAL_DISABLE;
+        *receivedCount = (UART_Rx_State[uartNumber] == UART_BUSY) ? RxBuffers[uartNumber].index : 0;
+        RxBuffers[uartNumber].buffer = NULL;
+        UART_Rx_State[uartNumber] = UART_READY;
+        NVIC_ExitCritical();
+
+        status = UART_OK;
+    }
+    return status;
+}
+
 UART_Status_t UART_enuActivateDMA(UART_Number_t uartNumber, uint32_t enableDmaFlag){
     UART_Status_t status = UART_NOT_OK;
 
@@ -343,7 +527,7 @@ UART_Status_t UART_enuRegisterCallbacks(UART_Number_t uartNumber, UART_Callbacks
     return status;
 }
 
-UART_Status_t UART_enuClearFlags(UART_Number_t uartNumber,uint32_t interruptFlags) {
+RAMFUNC UART_Status_t UART_enuClearFlags(UART_Number_t uartNumber,uint32_t interruptFlags) {
     UART_Status_t status = UART_NOT_OK;
 
     if(uartNumber > UART_6){
@@ -361,38 +545,38 @@ UART_Status_t UART_enuClearFlags(UART_Number_t uartNumber,uint32_t interruptFlag
     return status;
 }
 
-uint8_t UART_u8ReadTXEFlag(UART_Number_t uartNumber) {
+RAMFUNC uint8_t UART_u8ReadTXEFlag(UART_Number_t uartNumber) {
     UARTRegs_t* uart = UART_Registers[uartNumber];
     return ((uart->SR >> UART_TXE_FLAG_POSITION) & 1); 
 }
 
 
-uint8_t UART_u8ReadTCFlag(UART_Number_t uartNumber) {
+RAMFUNC uint8_t UART_u8ReadTCFlag(UART_Number_t uartNumber) {
     UARTRegs_t* uart = UART_Registers[uartNumber];
     return ((uart->SR >> UART_TC_FLAG_POSITION) & 1);
 }
 
-uint8_t UART_u8ReadRXNEFlag(UART_Number_t uartNumber) {
+RAMFUNC uint8_t UART_u8ReadRXNEFlag(UART_Number_t uartNumber) {
     UARTRegs_t* uart = UART_Registers[uartNumber];
     return ((uart->SR >> UART_RXNE_FLAG_POSITION) & 1);
 }
 
-uint8_t UART_u8ReadOREFlag(UART_Number_t uartNumber) {
+RAMFUNC uint8_t UART_u8ReadOREFlag(UART_Number_t uartNumber) {
     UARTRegs_t* uart = UART_Registers[uartNumber];
     return ((uart->SR >> UART_ORE_FLAG_POSITION) & 1);
 }
 
-uint8_t UART_u8ReadNoiseFlag(UART_Number_t uartNumber) {
+RAMFUNC uint8_t UART_u8ReadNoiseFlag(UART_Number_t uartNumber) {
     UARTRegs_t* uart = UART_Registers[uartNumber];
     return ((uart->SR >> UART_NOISE_FLAG_POSITION) & 1);
 }
 
-uint8_t UART_u8ReadFEFlag(UART_Number_t uartNumber) {
+RAMFUNC uint8_t UART_u8ReadFEFlag(UART_Number_t uartNumber) {
     UARTRegs_t* uart = UART_Registers[uartNumber];
     return ((uart->SR >> UART_FE_FLAG_POSITION) & 1);
 }
 
-uint8_t UART_u8ReadPEFlag(UART_Number_t uartNumber) {
+RAMFUNC uint8_t UART_u8ReadPEFlag(UART_Number_t uartNumber) {
     UARTRegs_t* uart = UART_Registers[uartNumber];
     return ((uart->SR >> UART_PE_FLAG_POSITION) & 1);
 }
@@ -421,105 +605,160 @@ static uint16_t CalculateBaudRate(uint32_t peripheralClock, uint32_t baudRate, U
     return brr;
 }
 
-static UART_Status_t Init_UART_Pins(UART_Config_t* config) {
+UART_Status_t UART_enuGetFrameTime(UART_Number_t uartNumber, uint32_t* frameNs) {
     UART_Status_t status = UART_NOT_OK;
-    GPIO_Status_t gpioStatus = GPIO_OK;
-
-    GPIO_cfg_t gpioConfig = {
-        .mode = GPIO_MODE_ALTERNATE_FUNCTION,
-        .outputType = GPIO_OUTPUT_TYPE_PUSH_PULL,
-        .speed = GPIO_SPEED_DEFAULT,
-        .pull = GPIO_NO_PULL,
-    };
-    
-    switch (config->UART_Number) {
-        case UART_1:
-        if((config->UartEnabled & UART_ENABLE_TRANSMITE) != 0){
-            // Initialize GPIO pins for UART1 (PA9 - TX, PA10 - RX)
-            gpioConfig.port = GPIO_PORT_A;
-            gpioConfig.pin = GPIO_PIN_9;
-            gpioConfig.alternateFunction = GPIO_AF7;
-            gpioStatus = GPIO_enuInit(&gpioConfig);  
-        }else{
-            // continue
-        }
-        if(gpioStatus != GPIO_OK){
-            status = UART_GPIO_ERROR;
-        }else{
-            if((config->UartEnabled & UART_ENABLE_RECEIVE) != 0){
-                gpioConfig.port = GPIO_PORT_A;
-                gpioConfig.pin = GPIO_PIN_10;
-                gpioConfig.alternateFunction = GPIO_AF7;
-                gpioStatus = GPIO_enuInit(&gpioConfig);
-            }else{
-                // continue
+
+    if (frameNs == NULL) {
+        status = UART_NULL_PTR;
+    } else if (uartNumber > UART_6) {
+        status = UART_WRONG_UART_NUMBER;
+    } else if (UART_BaudRates[uartNumber] == 0) {
+        status = UART_NOT_INIT_SUCCESSFULLY;
+    } else {
+        volatile UARTRegs_t* uart = UART_Registers[uartNumber];
+        uint32_t fck = GetPeripheralClock(uartNumber, UART_PERIPHERAL_CLOCK_AUTO);
+        uint32_t brr = uart->BRR;
+        uint32_t cr1 = uart->CR1;
+        uint32_t divider;
+        uint32_t halfBits;
+
+        if (fck == 0) {
+            status = UART_CLOCK_ERROR;
+        } else {
+            // Bit time = divider / fck : BRR as is with OVER8 = 0, mantissa * 8 + fraction (3 bits) with OVER8 = 1
+            if ((cr1 & ~UART_OVERSAMPLING_MASK) != 0) {
+                divider = ((brr >> 4U) << 3U) | (brr & 0x07U);
+            } else {
+                divider = brr;
             }
-            if(gpioStatus != GPIO_OK){
-                status = UART_GPIO_ERROR;
-            }else{
-                status = UART_OK;
+            // Start bit + 8 or 9 data bits (parity included), counted in half bits for 0.5 / 1.5 stop bits
+            halfBits = 2U * (((cr1 & ~UART_WORDLENGTH_MASK) != 0) ? 10U : 9U);
+            switch (uart->CR2 & ~UART_STOPBITS_MASK) {
+                case UART_STOPBITS_0_5: halfBits += 1U; break;
+                case UART_STOPBITS_2:   halfBits += 4U; break;
+                case UART_STOPBITS_1_5: halfBits += 3U; break;
+                default:                halfBits += 2U; break;
             }
+            *frameNs = (uint32_t)(((uint64_t)halfBits * divider * 1000000000ULL) / (2ULL * fck));
+            status = UART_OK;
         }
-            break;
-        case UART_2:
-        if((config->UartEnabled & UART_ENABLE_TRANSMITE) != 0){
-            // Initialize GPIO pins for UART2 (PA2 - TX, PA3 - RX)
-            gpioConfig.port = GPIO_PORT_A;
-            gpioConfig.pin = GPIO_PIN_2;
-            gpioConfig.alternateFunction = GPIO_AF7;
-            gpioStatus = GPIO_enuInit(&gpioConfig);  
-        }else{
-            // continue
+    }
+    return status;
+}
+
+void UART_vdClockChangeNotifier(uint8_t phase) {
+    uint8_t uartIndex;
+
+    for (uartIndex = 0; uartIndex < 3; uartIndex++) {
+        if (UART_BaudRates[uartIndex] == 0) {
+            continue; // UART not initialized
         }
-        if(gpioStatus != GPIO_OK){
-            status = UART_GPIO_ERROR;
-        }else{
-            if((config->UartEnabled & UART_ENABLE_RECEIVE) != 0){
-                gpioConfig.port = GPIO_PORT_A;
-                gpioConfig.pin = GPIO_PIN_3;
-                gpioConfig.alternateFunction = GPIO_AF7;
-                gpioStatus = GPIO_enuInit(&gpioConfig);
-            }else{
-                // continue
-            }
-            if(gpioStatus != GPIO_OK){
-                status = UART_GPIO_ERROR;
-            }else{
-                status = UART_OK;
+        volatile UARTRegs_t* uart = UART_Registers[uartIndex];
+
+        if (phase == RCC_CLOCK_PRE_CHANGE) {
+            // Let the buffered transmission and the frame on the wire complete
+            uint32_t timeout = UART_CLOCK_CHANGE_TIMEOUT;
+            while ((UART_Tx_State[uartIndex] == UART_BUSY) && (timeout-- > 0));
+            while ((IsDmaTxPending(uart) != 0) && (timeout-- > 0));
+            while (((uart->SR & (1UL << UART_TC_FLAG_POSITION)) == 0) && (timeout-- > 0));
+        } else if (phase == RCC_CLOCK_POST_CHANGE) {
+            // Same baud rate from the new APB clock, transfers are refused when it cannot be read
+            uint32_t fck = GetPeripheralClock((UART_Number_t)uartIndex, UART_PERIPHERAL_CLOCK_AUTO);
+            if (fck == 0) {
+                UART_ClockStatus[uartIndex] = UART_CLOCK_ERROR;
+            } else {
+                uart->BRR = CalculateBaudRate(fck, UART_BaudRates[uartIndex], UART_OverSamplings[uartIndex]);
+                UART_ClockStatus[uartIndex] = UART_OK;
             }
+        } else {
+            // Unknown phase, nothing to do
         }
-            break;
-        case UART_6:
-        if((config->UartEnabled & UART_ENABLE_TRANSMITE) != 0){
-            // Initialize GPIO pins for UART6 (PC6 - TX, PC7 - RX)
-            gpioConfig.port = GPIO_PORT_C;
-            gpioConfig.pin = GPIO_PIN_6;
-            gpioConfig.alternateFunction = GPIO_AF8;
-            gpioStatus = GPIO_enuInit(&gpioConfig);  
-        }else{
-            // continue
+    }
+}
+
+uint8_t UART_u8ClockChangeBusy(void) {
+    uint8_t uartIndex;
+    uint8_t busy = 0;
+
+    for (uartIndex = 0; uartIndex < 3; uartIndex++) {
+        if (UART_BaudRates[uartIndex] == 0) {
+            continue; // UART not initialized
+        }
+        if ((UART_Tx_State[uartIndex] == UART_BUSY) || (IsDmaTxPending(UART_Registers[uartIndex]) != 0)) {
+            busy = 1;
+        }
+    }
+    return busy;
+}
+
+// A DMA transmission keeps TCIE set until the TC interrupt of its last frame
+static uint8_t IsDmaTxPending(volatile UARTRegs_t* uart) {
+    return (((uart->CR3 & UART_DMA_TRANSMIT_ENABLE) != 0) && ((uart->CR1 & UART_INTERRUPT_TC_LOCAL_ENABLE) != 0)) ? 1 : 0;
+}
+
+// Acquires the UART and GPIO port clocks once per UART (a second init keeps the same owner)
+static UART_Status_t AcquireUartClocks(UART_Number_t uartNumber) {
+    UART_Status_t status = UART_CLOCK_ERROR;
+
+    if (UART_ClockOwned[uartNumber] == TRUE) {
+        status = UART_OK;
+    } else if (RCC_AcquirePeripheralClock(RCC_AHB1_BUS, UART_PortClockMask[uartNumber]) != RCC_OK) {
+        status = UART_CLOCK_ERROR;
+    } else if (RCC_AcquirePeripheralClock(UART_ClockBus[uartNumber], UART_ClockMask[uartNumber]) != RCC_OK) {
+        RCC_ReleasePeripheralClock(RCC_AHB1_BUS, UART_PortClockMask[uartNumber]);
+        status = UART_CLOCK_ERROR;
+    } else {
+        UART_ClockOwned[uartNumber] = TRUE;
+        status = UART_OK;
+    }
+    return status;
+}
+
+// Releases the clocks taken by AcquireUartClocks, they are gated off when this was the last owner
+static UART_Status_t ReleaseUartClocks(UART_Number_t uartNumber) {
+    UART_Status_t status = UART_OK;
+
+    if (RCC_ReleasePeripheralClock(UART_ClockBus[uartNumber], UART_ClockMask[uartNumber]) != RCC_OK) {
+        status = UART_CLOCK_ERROR;
+    }
+    if (RCC_ReleasePeripheralClock(RCC_AHB1_BUS, UART_PortClockMask[uartNumber]) != RCC_OK) {
+        status = UART_CLOCK_ERROR;
+    }
+    UART_ClockOwned[uartNumber] = FALSE;
+    return status;
+}
+
+// Returns the configured clock, or the live APB clock when UART_PERIPHERAL_CLOCK_AUTO is used
+static uint32_t GetPeripheralClock(UART_Number_t uartNumber, uint32_t configuredClock) {
+    uint32_t clockHz = configuredClock;
+
+    if (configuredClock == UART_PERIPHERAL_CLOCK_AUTO) {
+        // UART1 and UART6 sit on APB2, UART2 sits on APB1
+        uint8_t bus = (uartNumber == UART_2) ? RCC_APB1_BUS : RCC_APB2_BUS;
+        if (RCC_GetClockHz(bus, &clockHz) != RCC_OK) {
+            clockHz = 0;
+        }
+    }
+    return clockHz;
+}
+
+// TX / RX images of board_cfg.h, nothing to do when the boot already applied them
+static UART_Status_t Init_UART_Pins(UART_Number_t uartNumber, uint32_t uartEnabled) {
+    UART_Status_t status = UART_OK;
+
+    if (uartNumber > UART_6) {
+        status = UART_WRONG_UART_NUMBER;
+    } else if (UART_PinsFitted[uartNumber] == TRUE) {
+        // Fitted pins, set up by BOARD_enuInit
+    } else {
+        if (((uartEnabled & UART_ENABLE_TRANSMITE) != 0)
+            && (GPIO_enuApplyImage(&UART_TxPinImage[uartNumber]) != GPIO_OK)) {
+            status = UART_GPIO_ERROR;
         }
-        if(gpioStatus != GPIO_OK){  
+        if ((status == UART_OK) && ((uartEnabled & UART_ENABLE_RECEIVE) != 0)
+            && (GPIO_enuApplyImage(&UART_RxPinImage[uartNumber]) != GPIO_OK)) {
             status = UART_GPIO_ERROR;
-        }else{
-            if((config->UartEnabled & UART_ENABLE_RECEIVE) != 0){
-                gpioConfig.port = GPIO_PORT_C;
-                gpioConfig.pin = GPIO_PIN_7;
-                gpioConfig.alternateFunction = GPIO_AF8;
-                gpioStatus = GPIO_enuInit(&gpioConfig);
-            }else{
-                // continue
-            }
-            if(gpioStatus != GPIO_OK){  
-                status = UART_GPIO_ERROR;
-            }else{
-                status = UART_OK;
-            }
         }
-            break;
-        default:
-            status = UART_WRONG_UART_NUMBER;
-            break;
     }
 
     return status;
@@ -527,12 +766,22 @@ static UART_Status_t Init_UART_Pins(UART_Config_t* config) {
 
 
 
-static void USART_LocalHandler(UART_Number_t uartNumber) {
+RAMFUNC static void USART_LocalHandler(UART_Number_t uartNumber) {
     UARTRegs_t* uart = UART_Registers[uartNumber];
 
+    TRACE_EVENT(TRACE_EVENT_ISR_ENTER, TRACE_SOURCE_UART | uartNumber);
+
+    // Test builds : errors as if the status register reported them (fault.h)
+    LocalFlags.ParityErrorFlag  |= FAULT_INJECT(FAULT_POINT_UART_PARITY, uartNumber);
+    LocalFlags.FramingErrorFlag |= FAULT_INJECT(FAULT_POINT_UART_FRAMING, uartNumber);
+    LocalFlags.NoiseErrorFlag   |= FAULT_INJECT(FAULT_POINT_UART_NOISE, uartNumber);
+    LocalFlags.OverrunErrorFlag |= FAULT_INJECT(FAULT_POINT_UART_OVERRUN, uartNumber);
+
         if(LocalFlags.RXNE_Flag== 1) {
         if(RxBuffers[uartNumber].buffer != NULL) {
             if(RxBuffers[uartNumber].index < RxBuffers[uartNumber].size) {
+                // Test builds : a slow consumer, the frames behind this one overrun
+                FAULT_STALL(FAULT_POINT_UART_RX_STALL, uartNumber);
                 // Read received byte
                 RxBuffers[uartNumber].buffer[RxBuffers[uartNumber].index++] = (uint8_t)(uart->DR & 0xFF);
             } 
@@ -542,6 +791,7 @@ static void USART_LocalHandler(UART_Number_t uartNumber) {
                 uart->CR1 &= UART_INTERRUPT_RXNE_LOCAL_DISABLE;
 
                 UART_Rx_State[uartNumber] = UART_READY;
+                TRACE_EVENT(TRACE_EVENT_UART_RX_DONE, uartNumber);
 
                 // Call the callback function if set
                 if(RxBuffers[uartNumber].callback != NULL) {
@@ -602,15 +852,22 @@ static void USART_LocalHandler(UART_Number_t uartNumber) {
 
     if(LocalFlags.TC_Flag == 1) {
         // Transmission Complete
+        if((uart->CR3 & UART_DMA_TRANSMIT_ENABLE) != 0) {
+            // End of the DMA frame : the next DMA transmission enables TC again
+            uart->CR1 &= UART_INTERRUPT_TC_LOCAL_DISABLE;
+        }
         if(UartCallbacks[uartNumber].TC_Callback != NULL) {
             UART_enuClearFlags(uartNumber, UART_INTERRUPT_TC_LOCAL_ENABLE);
+            TRACE_EVENT(TRACE_EVENT_UART_TX_DONE, uartNumber);
             UartCallbacks[uartNumber].TC_Callback();
         }
     }
+
+    TRACE_EVENT(TRACE_EVENT_ISR_EXIT, TRACE_SOURCE_UART | uartNumber);
 }
 
 
-void USART1_IRQHandler(void) {
+RAMFUNC void USART1_IRQHandler(void) {
 
     // i put this part here because the debugger when read the Dr register it will clear some flags
     // so i need to read the flags first before calling the local handler
@@ -627,7 +884,7 @@ void USART1_IRQHandler(void) {
     USART_LocalHandler(UART_1);
 }
 
-void USART2_IRQHandler(void) {
+RAMFUNC void USART2_IRQHandler(void) {
 
     // i put this part here because the debugger when read the Dr register it will clear some flags
     // so i need to read the flags first before calling the local handler
@@ -643,7 +900,7 @@ void USART2_IRQHandler(void) {
     USART_LocalHandler(UART_2);
 }
 
-void USART6_IRQHandler(void) {
+RAMFUNC void USART6_IRQHandler(void) {
     
     // i put this part here because the debugger when read the Dr register it will clear some flags
     // so i need to read the flags first before calling the local handler
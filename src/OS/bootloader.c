@@ -0,0 +1,176 @@
+
+#include "LIB/stdtypes.h"
+
+#include "OS/update_cfg.h"
+#include "OS/update.h"
+
+/*
+ * Everything here is linked in .boot (sectors 0-1, never updated) and runs
+ * before the startup code of the application : no initialized or zeroed
+ * data, registers through constant addresses only, no call leaving .boot
+ * (no switch either, its jump table would go to .rodata)
+ */
+#define BOOTFUNC                __attribute__((section(".boot"), noinline))
+
+/* Flash interface (same values as MCAL/FLASH_Driver/flash_priv.h) */
+#define BOOT_FLASH_KEYR         (*(volatile uint32_t *)0x40023C04UL)
+#define BOOT_FLASH_SR           (*(volatile uint32_t *)0x40023C0CUL)
+#define BOOT_FLASH_CR           (*(volatile uint32_t *)0x40023C10UL)
+#define BOOT_FLASH_KEY1         (0x45670123UL)
+#define BOOT_FLASH_KEY2         (0xCDEF89ABUL)
+#define BOOT_FLASH_SR_ERRORS    (0x000000F2UL)
+#define BOOT_FLASH_SR_BSY       (0x00010000UL)
+#define BOOT_FLASH_CR_PG        (0x00000001UL)
+#define BOOT_FLASH_CR_SER       (0x00000002UL)
+#define BOOT_FLASH_CR_SNB_POS   (3UL)
+#define BOOT_FLASH_CR_PSIZE_X32 (0x00000200UL)
+#define BOOT_FLASH_CR_STRT      (0x00010000UL)
+#define BOOT_FLASH_CR_LOCK      (0x80000000UL)
+#define BOOT_ERASED_WORD        (0xFFFFFFFFUL)
+
+/* Vector table offset register */
+#define BOOT_SCB_VTOR           (*(volatile uint32_t *)0xE000ED08UL)
+
+/* Range of a valid initial stack pointer */
+#define BOOT_RAM_START          (0x20000000UL)
+#define BOOT_RAM_END            (0x20010000UL)
+
+#define BOOT_CRC32_POLYNOMIAL   (0xEDB88320UL)
+#define BOOT_CRC32_INIT         (0xFFFFFFFFUL)
+
+extern uint32_t _estack;
+
+static void BOOT_vdFault(void);
+
+/*
+ * Vector table at 0x08000000 : only what the core needs until the application
+ * table is installed in VTOR
+ */
+__attribute__((section(".boot_vector"), used))
+void (* const BOOT_Vectors[4])(void) = {
+    (void (*)(void))&_estack,
+    BOOT_vdReset,
+    BOOT_vdFault,   /* NMI */
+    BOOT_vdFault    /* HardFault */
+};
+
+BOOTFUNC static void BOOT_vdFault(void){
+    while(1);
+}
+
+/* Waits for the end of the operation, FALSE on an error flag */
+BOOTFUNC static bool_t BOOT_boolWaitReady(void){
+    bool_t ok = TRUE;
+    while((BOOT_FLASH_SR & BOOT_FLASH_SR_BSY) != 0);
+    if((BOOT_FLASH_SR & BOOT_FLASH_SR_ERRORS) != 0){
+        BOOT_FLASH_SR = BOOT_FLASH_SR_ERRORS;
+        ok = FALSE;
+    }
+    return ok;
+}
+
+BOOTFUNC static bool_t BOOT_boolEraseSector(uint8_t sector){
+    BOOT_FLASH_CR = BOOT_FLASH_CR_PSIZE_X32 | BOOT_FLASH_CR_SER | ((uint32_t)sector << BOOT_FLASH_CR_SNB_POS);
+    BOOT_FLASH_CR |= BOOT_FLASH_CR_STRT;
+    return BOOT_boolWaitReady();
+}
+
+BOOTFUNC static bool_t BOOT_boolProgramWord(uint32_t address, uint32_t word){
+    BOOT_FLASH_CR = BOOT_FLASH_CR_PSIZE_X32 | BOOT_FLASH_CR_PG;
+    *(volatile uint32_t *)address = word;
+    return (BOOT_boolWaitReady() == TRUE) && (*(volatile uint32_t *)address == word);
+}
+
+/* Same CRC as UPD_u32Crc32, complete (init and final XOR included) */
+BOOTFUNC static uint32_t BOOT_u32Crc32(const uint8_t *data, uint32_t length){
+    uint32_t crc = BOOT_CRC32_INIT;
+    for(uint32_t i = 0; i < length; i++){
+        crc ^= data[i];
+        for(uint8_t bit = 0; bit < 8U; bit++){
+            if((crc & 1UL) != 0){
+                crc = (crc >> 1) ^ BOOT_CRC32_POLYNOMIAL;
+            }else{
+                crc >>= 1;
+            }
+        }
+    }
+    return crc ^ BOOT_CRC32_INIT;
+}
+
+/* Initial SP in RAM and a Thumb reset handler inside the application sector */
+BOOTFUNC static bool_t BOOT_boolIsApplicationValid(void){
+    const volatile uint32_t *appVectors = (const volatile uint32_t *)UPD_APP_ADDRESS;
+    uint32_t stackPointer = appVectors[0];
+    uint32_t resetHandler = appVectors[1];
+
+    return (stackPointer > BOOT_RAM_START) && (stackPointer <= BOOT_RAM_END) &&
+           ((resetHandler & 1UL) != 0) &&
+           (resetHandler > UPD_APP_ADDRESS) && (resetHandler < (UPD_APP_ADDRESS + UPD_APP_SIZE));
+}
+
+/*
+ * Copies the committed image to the application sector
+ * Idempotent : a reset at any point leaves UPD_Installed erased and the copy
+ * starts over at the next boot, from the slot that is never written here
+ * except for that last word
+ */
+BOOTFUNC static void BOOT_vdInstall(const volatile UPD_Trailer_t *trailer){
+    bool_t ok = TRUE;
+    uint32_t words = (trailer->UPD_ImageSize + 3U) / 4U;
+
+    if((BOOT_FLASH_CR & BOOT_FLASH_CR_LOCK) != 0){
+        BOOT_FLASH_KEYR = BOOT_FLASH_KEY1;
+        BOOT_FLASH_KEYR = BOOT_FLASH_KEY2;
+    }
+    BOOT_FLASH_SR = BOOT_FLASH_SR_ERRORS;
+
+    ok = BOOT_boolEraseSector(UPD_APP_SECTOR);
+    for(uint32_t i = 0; (i < words) && (ok == TRUE); i++){
+        ok = BOOT_boolProgramWord(UPD_APP_ADDRESS + (i * 4U), ((const volatile uint32_t *)UPD_SLOT_ADDRESS)[i]);
+    }
+    if(ok == TRUE){
+        ok = (BOOT_u32Crc32((const uint8_t *)UPD_APP_ADDRESS, trailer->UPD_ImageSize) == trailer->UPD_ImageCrc);
+    }
+    if(ok == TRUE){
+        (void)BOOT_boolProgramWord((uint32_t)&trailer->UPD_Installed, UPD_STATE_MARK);
+    }
+
+    BOOT_FLASH_CR = BOOT_FLASH_CR_LOCK;
+}
+
+/*
+ * Function: BOOT_vdReset
+ * Description: Reset entry of the bootloader
+ *
+ * Implementation notes:
+ * - The copy runs when the slot holds a committed image not installed yet, or
+ *   an installed one while the application sector is not valid (copy cut by
+ *   a reset after its last word was written but before UPD_Installed)
+ * - The slot CRC is checked again first : nothing is erased for a damaged slot
+ * - Normal boots only read the trailer and two vectors, no CRC
+ */
+BOOTFUNC void BOOT_vdReset(void){
+    const volatile UPD_Trailer_t *trailer = (const volatile UPD_Trailer_t *)UPD_TRAILER_ADDRESS;
+    const volatile uint32_t *appVectors = (const volatile uint32_t *)UPD_APP_ADDRESS;
+
+    if((trailer->UPD_Magic == UPD_HEADER_MAGIC) &&
+       (trailer->UPD_Pending == UPD_STATE_MARK) &&
+       (trailer->UPD_ImageSize != 0) && (trailer->UPD_ImageSize <= UPD_APP_SIZE) &&
+       ((trailer->UPD_Installed == BOOT_ERASED_WORD) || (BOOT_boolIsApplicationValid() == FALSE))){
+        if(BOOT_u32Crc32((const uint8_t *)UPD_SLOT_ADDRESS, trailer->UPD_ImageSize) == trailer->UPD_ImageCrc){
+            BOOT_vdInstall(trailer);
+        }
+    }
+
+    if(BOOT_boolIsApplicationValid() == FALSE){
+        // Nothing to run : wait for a debugger
+        BOOT_vdFault();
+    }
+
+    BOOT_SCB_VTOR = UPD_APP_ADDRESS;
+    __asm volatile ("dsb\n"
+                    "isb\n"
+                    "msr msp, %0\n"
+                    "bx %1\n"
+                    : : "r" (appVectors[0]), "r" (appVectors[1]) : "memory");
+}
@@ -0,0 +1,128 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/dwt.h"
+
+#include "OS/fault_cfg.h"
+#include "OS/fault.h"
+
+typedef struct {
+    uint32_t FAULT_InstanceMask;
+    uint32_t FAULT_OneIn;           /* 0 = point off */
+    uint32_t FAULT_Injected;
+}FAULT_PointState_t;
+
+static FAULT_PointState_t FaultPoints[FAULT_POINTS] = {0};
+
+/* xorshift32 state, one sequence shared by every point */
+static uint32_t FaultRandom = FAULT_SEED;
+
+/*
+ * Function: FAULT_enuConfigure
+ * Description: Sets the instances and the rate of a point
+ */
+FAULT_Status_t FAULT_enuConfigure(FAULT_Point_t point, uint32_t instanceMask, uint32_t oneIn){
+    FAULT_Status_t retStatus = FAULT_NOT_OK;
+    uint32_t primask;
+
+    if(point >= FAULT_POINTS){
+        retStatus = FAULT_WRONG_POINT;
+    }else{
+        // The stall is timed with the cycle counter
+        DWT_vdStart();
+
+        __asm volatile ("MRS %0, primask" : "=r" (primask) :: "memory");
+        __asm volatile ("CPSID i" ::: "memory");
+
+        FaultPoints[point].FAULT_InstanceMask = instanceMask;
+        FaultPoints[point].FAULT_OneIn = oneIn;
+
+        __asm volatile ("MSR primask, %0" :: "r" (primask) : "memory");
+        retStatus = FAULT_OK;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: FAULT_vdReset
+ * Description: Every point off, counters cleared, sequence restarted
+ */
+void FAULT_vdReset(void){
+    uint32_t primask;
+    uint8_t point;
+
+    __asm volatile ("MRS %0, primask" : "=r" (primask) :: "memory");
+    __asm volatile ("CPSID i" ::: "memory");
+
+    for(point = 0; point < FAULT_POINTS; point++){
+        FaultPoints[point].FAULT_InstanceMask = 0;
+        FaultPoints[point].FAULT_OneIn = 0;
+        FaultPoints[point].FAULT_Injected = 0;
+    }
+    FaultRandom = FAULT_SEED;
+
+    __asm volatile ("MSR primask, %0" :: "r" (primask) : "memory");
+}
+
+/*
+ * Function: FAULT_u8Hit
+ * Description: Draws the next pseudo-random number for a point that is on
+ *              for this instance
+ * Note: Points that are off cost the check only and leave the sequence
+ *       untouched, so enabling one point does not shift the faults of another
+ *       run for run
+ */
+RAMFUNC uint8_t FAULT_u8Hit(FAULT_Point_t point, uint8_t instance){
+    uint8_t hit = 0;
+    uint32_t primask;
+    uint32_t value;
+
+    if((point < FAULT_POINTS) && (FaultPoints[point].FAULT_OneIn != 0) && (instance < 32U)
+       && ((FaultPoints[point].FAULT_InstanceMask & (1UL << instance)) != 0)){
+        __asm volatile ("MRS %0, primask" : "=r" (primask) :: "memory");
+        __asm volatile ("CPSID i" ::: "memory");
+
+        value = FaultRandom;
+        value ^= value << 13;
+        value ^= value >> 17;
+        value ^= value << 5;
+        FaultRandom = value;
+        if((value % FaultPoints[point].FAULT_OneIn) == 0){
+            FaultPoints[point].FAULT_Injected++;
+            hit = 1;
+        }
+
+        __asm volatile ("MSR primask, %0" :: "r" (primask) : "memory");
+    }
+    return hit;
+}
+
+/*
+ * Function: FAULT_vdStall
+ * Description: Busy waits FAULT_STALL_CYCLES when the point hits
+ */
+RAMFUNC void FAULT_vdStall(FAULT_Point_t point, uint8_t instance){
+    uint32_t start;
+
+    if(FAULT_u8Hit(point, instance) == 1){
+        start = DWT_CYCCNT;
+        while((DWT_CYCCNT - start) < FAULT_STALL_CYCLES);
+    }
+}
+
+/*
+ * Function: FAULT_enuGetInjected
+ * Description: Returns the injection counter of a point
+ */
+FAULT_Status_t FAULT_enuGetInjected(FAULT_Point_t point, uint32_t *count){
+    FAULT_Status_t retStatus = FAULT_NOT_OK;
+
+    if(NULL == count){
+        retStatus = FAULT_NULL_PTR;
+    }else if(point >= FAULT_POINTS){
+        retStatus = FAULT_WRONG_POINT;
+    }else{
+        *count = FaultPoints[point].FAULT_Injected;
+        retStatus = FAULT_OK;
+    }
+    return retStatus;
+}
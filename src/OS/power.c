@@ -0,0 +1,359 @@
+#include "LIB/stdtypes.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "MCAL/GPIO_Driver/gpio_int.h"
+#include "MCAL/SYSTICK_TIMER_Driver/systick.h"
+#include "MCAL/UART_Driver/uart.h"
+#include "MCAL/PWR_Driver/pwr.h"
+#include "HAL/MCU_Driver/mcu.h"
+
+#include "OS/power_cfg.h"
+#include "OS/power.h"
+
+/*
+ * Peripheral clock that STOP mode would break while it is acquired
+ * (clock frozen in the middle of a frame, a conversion or a transfer)
+ */
+typedef struct {
+    uint8_t  Bus;
+    uint64_t ClockMask;
+}PWRM_StopBlocker_t;
+
+static const PWRM_StopBlocker_t StopBlockers[] = {
+    {RCC_AHB1_BUS, RCC_AHB1_DMA1_CLOCK},
+    {RCC_AHB1_BUS, RCC_AHB1_DMA2_CLOCK},
+    {RCC_APB1_BUS, RCC_APB1_SPI2_CLOCK},
+    {RCC_APB1_BUS, RCC_APB1_SPI3_CLOCK},
+    {RCC_APB1_BUS, RCC_APB1_I2C1_CLOCK},
+    {RCC_APB1_BUS, RCC_APB1_I2C2_CLOCK},
+    {RCC_APB1_BUS, RCC_APB1_I2C3_CLOCK},
+    {RCC_APB1_BUS, RCC_APB1_TIMER2_CLOCK},
+    {RCC_APB1_BUS, RCC_APB1_TIMER3_CLOCK},
+    {RCC_APB1_BUS, RCC_APB1_TIMER4_CLOCK},
+    {RCC_APB1_BUS, RCC_APB1_TIMER5_CLOCK},
+    {RCC_APB2_BUS, RCC_APB2_SPI1_CLOCK},
+    {RCC_APB2_BUS, RCC_APB2_SPI4_CLOCK},
+    {RCC_APB2_BUS, RCC_APB2_ADC1_CLOCK},
+    {RCC_APB2_BUS, RCC_APB2_TIMER1_CLOCK},
+};
+
+#define PWRM_NUMBER_OF_STOP_BLOCKERS    (sizeof(StopBlockers) / sizeof(StopBlockers[0]))
+
+/*
+ * UART clocks and RX pins, indexed by UART_Number_t
+ * A UART only blocks STOP when its RX pin is not a wake-up source or a frame is still on the wire
+ */
+#define PWRM_NUMBER_OF_UARTS            (3U)
+
+static const uint8_t  UartClockBus[PWRM_NUMBER_OF_UARTS]  = {RCC_APB2_BUS, RCC_APB1_BUS, RCC_APB2_BUS};
+static const uint64_t UartClockMask[PWRM_NUMBER_OF_UARTS] = {RCC_APB2_USART1_CLOCK, RCC_APB1_USART2_CLOCK, RCC_APB2_USART6_CLOCK};
+static const uint8_t  UartRxPort[PWRM_NUMBER_OF_UARTS]    = {GPIO_PORT_A, GPIO_PORT_A, GPIO_PORT_C};
+static const uint8_t  UartRxPin[PWRM_NUMBER_OF_UARTS]     = {GPIO_PIN_10, GPIO_PIN_3, GPIO_PIN_7};
+
+/* TRUE for each UART whose RX start bit wakes the MCU */
+static bool_t UartRxWakeup[PWRM_NUMBER_OF_UARTS] = {FALSE, FALSE, FALSE};
+
+/* TRUE once the PWR driver and the RTC time base are running */
+static bool_t PwrmInitialized = FALSE;
+
+/* Number of PWRM_enuLockStop() calls without matching unlock */
+static uint32_t StopLocks = 0;
+
+/* Residency report, indexed by PWRM_Mode_t */
+static PWRM_Residency_t Residency[PWRM_NUMBER_OF_MODES];
+
+/* Picks the deepest mode allowed for the given idle time */
+static PWRM_Mode_t localSelectMode(uint32_t idleTime_ms);
+
+/* TRUE when an acquired peripheral clock forbids STOP */
+static bool_t localIsStopBlocked(void);
+
+/* Sleep mode, residency measured with the SysTick counter */
+static void localSleep(void);
+
+/* STOP mode with an RTC wake-up before the deadline */
+static PWRM_Status_t localStop(PWRM_Mode_t mode, uint32_t idleTime_ms, uint32_t *sleptTime_ms);
+
+/*
+ * Function: PWRM_enuInit
+ * Description: Initializes the PWR driver (PWR clock, LSI, RTC time base)
+ * Returns: PWRM_OK or PWRM_PWR_ERROR
+ */
+PWRM_Status_t PWRM_enuInit(void){
+    PWRM_Status_t retStatus = PWRM_NOT_OK;
+
+    if(PWR_OK != PWR_enuInit()){
+        retStatus = PWRM_PWR_ERROR;
+    }else{
+        PwrmInitialized = TRUE;
+        retStatus = PWRM_OK;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: PWRM_enuIdle
+ * Description: Enters the deepest safe low-power mode until the next interrupt
+ * Parameters:
+ *   - idleTime_ms: Time until the next scheduler deadline
+ *   - sleptTime_ms: Pointer to store the time spent in STOP
+ * Returns: PWRM_Status_t
+ *
+ * Implementation notes:
+ * - Interrupts are masked by the caller : a wake-up interrupt ends WFI but its
+ *   handler only runs after the caller unmasks, so it always sees the full clock
+ * - Sleep leaves SysTick running : the scheduler keeps its own time, 0 is reported
+ */
+PWRM_Status_t PWRM_enuIdle(uint32_t idleTime_ms, uint32_t *sleptTime_ms){
+    PWRM_Status_t retStatus = PWRM_NOT_OK;
+    PWRM_Mode_t mode;
+
+    if(NULL == sleptTime_ms){
+        retStatus = PWRM_NULL_PTR;
+    }else{
+        *sleptTime_ms = 0;
+        mode = localSelectMode(idleTime_ms);
+
+        if(PWRM_MODE_SLEEP == mode){
+            localSleep();
+            retStatus = PWRM_OK;
+        }else{
+            retStatus = localStop(mode, idleTime_ms, sleptTime_ms);
+        }
+    }
+    return retStatus;
+}
+
+/*
+ * Function: PWRM_enuLockStop
+ * Description: Forbids STOP mode until the matching PWRM_enuUnlockStop()
+ */
+PWRM_Status_t PWRM_enuLockStop(void){
+    StopLocks++;
+    return PWRM_OK;
+}
+
+/*
+ * Function: PWRM_enuUnlockStop
+ * Description: Releases one stop lock
+ */
+PWRM_Status_t PWRM_enuUnlockStop(void){
+    PWRM_Status_t retStatus = PWRM_NOT_OK;
+
+    if(0 == StopLocks){
+        retStatus = PWRM_STOP_NOT_LOCKED;
+    }else{
+        StopLocks--;
+        retStatus = PWRM_OK;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: PWRM_enuEnableUartRxWakeup
+ * Description: Watches the RX pin of a UART with EXTI (falling edge = start bit)
+ * Note: The pin stays in alternate function mode, EXTI only listens to it
+ */
+PWRM_Status_t PWRM_enuEnableUartRxWakeup(UART_Number_t uartNumber){
+    PWRM_Status_t retStatus = PWRM_NOT_OK;
+
+    if(uartNumber >= PWRM_NUMBER_OF_UARTS){
+        retStatus = PWRM_WRONG_UART;
+    }else if(PWR_OK != PWR_enuEnableExtiWakeup(UartRxPort[uartNumber], UartRxPin[uartNumber], PWR_EDGE_FALLING)){
+        retStatus = PWRM_PWR_ERROR;
+    }else{
+        UartRxWakeup[uartNumber] = TRUE;
+        retStatus = PWRM_OK;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: PWRM_enuDisableUartRxWakeup
+ * Description: Stops watching the RX pin of a UART
+ */
+PWRM_Status_t PWRM_enuDisableUartRxWakeup(UART_Number_t uartNumber){
+    PWRM_Status_t retStatus = PWRM_NOT_OK;
+
+    if(uartNumber >= PWRM_NUMBER_OF_UARTS){
+        retStatus = PWRM_WRONG_UART;
+    }else{
+        PWR_enuDisableExtiWakeup(UartRxPin[uartNumber]);
+        UartRxWakeup[uartNumber] = FALSE;
+        retStatus = PWRM_OK;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: PWRM_enuEnablePinWakeup
+ * Description: Makes a GPIO pin edge a wake-up source
+ */
+PWRM_Status_t PWRM_enuEnablePinWakeup(uint8_t port, uint8_t pin, PWR_Edge_t edge){
+    PWRM_Status_t retStatus = PWRM_NOT_OK;
+
+    if(PWR_OK != PWR_enuEnableExtiWakeup(port, pin, edge)){
+        retStatus = PWRM_PWR_ERROR;
+    }else{
+        retStatus = PWRM_OK;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: PWRM_enuGetResidency
+ * Description: Copies the residency report of one mode
+ */
+PWRM_Status_t PWRM_enuGetResidency(PWRM_Mode_t mode, PWRM_Residency_t *residency){
+    PWRM_Status_t retStatus = PWRM_NOT_OK;
+
+    if(NULL == residency){
+        retStatus = PWRM_NULL_PTR;
+    }else if(mode >= PWRM_NUMBER_OF_MODES){
+        retStatus = PWRM_WRONG_MODE;
+    }else{
+        *residency = Residency[mode];
+        retStatus = PWRM_OK;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: PWRM_enuResetResidency
+ * Description: Clears the residency report of every mode
+ */
+PWRM_Status_t PWRM_enuResetResidency(void){
+    uint8_t index;
+
+    for(index = 0; index < PWRM_NUMBER_OF_MODES; index++){
+        Residency[index].PWRM_Entries = 0;
+        Residency[index].PWRM_EarlyWakeups = 0;
+        Residency[index].PWRM_Residency_us = 0;
+    }
+    return PWRM_OK;
+}
+
+/*
+ * Function: localSelectMode
+ * Description: Deepest mode allowed by the configuration, the idle time and the active peripherals
+ */
+static PWRM_Mode_t localSelectMode(uint32_t idleTime_ms){
+    PWRM_Mode_t mode = PWRM_MODE_SLEEP;
+
+    if((TRUE == PwrmInitialized) && (PWRM_MODE_SLEEP != PWRM_DEEPEST_MODE) &&
+       (idleTime_ms >= PWRM_STOP_MIN_IDLE_MS) && (0 == StopLocks) && (FALSE == localIsStopBlocked())){
+
+        if((PWRM_MODE_STOP_LP == PWRM_DEEPEST_MODE) && (idleTime_ms >= PWRM_STOP_LP_MIN_IDLE_MS)){
+            mode = PWRM_MODE_STOP_LP;
+        }else{
+            mode = PWRM_MODE_STOP;
+        }
+    }
+    return mode;
+}
+
+/*
+ * Function: localIsStopBlocked
+ * Description: Reads the RCC clock refcounts of every peripheral STOP would break
+ * Note: A UART is not blocking when its RX wake-up is enabled and its last frame
+ *       has left the shift register (TC set)
+ */
+static bool_t localIsStopBlocked(void){
+    bool_t blocked = FALSE;
+    uint8_t refCount = 0;
+    uint8_t index;
+
+    for(index = 0; (index < PWRM_NUMBER_OF_STOP_BLOCKERS) && (FALSE == blocked); index++){
+        if((RCC_OK == RCC_GetPeripheralClockRefCount(StopBlockers[index].Bus, StopBlockers[index].ClockMask, &refCount)) &&
+           (0 != refCount)){
+            blocked = TRUE;
+        }
+    }
+
+    for(index = 0; (index < PWRM_NUMBER_OF_UARTS) && (FALSE == blocked); index++){
+        if((RCC_OK == RCC_GetPeripheralClockRefCount(UartClockBus[index], UartClockMask[index], &refCount)) &&
+           (0 != refCount) &&
+           ((FALSE == UartRxWakeup[index]) || (0 == UART_u8ReadTCFlag((UART_Number_t)index)))){
+            blocked = TRUE;
+        }
+    }
+    return blocked;
+}
+
+/*
+ * Function: localSleep
+ * Description: WFI in Sleep mode, the time asleep is the SysTick distance between before and after
+ * Note: The scheduler runs SysTick from the processor clock, so counts / (HCLK / 1 MHz) gives microseconds
+ *       A wrap means SysTick itself woke the core (at most one wrap : its interrupt is the wake-up)
+ */
+static void localSleep(void){
+    uint32_t before = 0;
+    uint32_t after = 0;
+    uint32_t reload = 0;
+    uint32_t hclk = 0;
+    uint32_t counts;
+
+    SYSTICK_GetCurrentCount(&before);
+    PWR_enuEnterMode(PWR_MODE_SLEEP);
+    SYSTICK_GetCurrentCount(&after);
+    SYSTICK_GetStartValue(&reload);
+
+    counts = (after <= before) ? (before - after) : (before + (reload + 1UL) - after);
+
+    Residency[PWRM_MODE_SLEEP].PWRM_Entries++;
+    if((MCU_OK == MCU_GetClockHz(MCU_AHB1_BUS, &hclk)) && (hclk >= 1000000UL)){
+        Residency[PWRM_MODE_SLEEP].PWRM_Residency_us += counts / (hclk / 1000000UL);
+    }
+}
+
+/*
+ * Function: localStop
+ * Description: STOP mode until the RTC wake-up or an earlier EXTI line
+ *
+ * Sequence:
+ * 1. RTC wake-up programmed PWRM_STOP_WAKEUP_MARGIN_MS before the deadline
+ *    (capped to the longest wake-up the RTC counter can do)
+ * 2. Running clock source recorded, STOP entered
+ * 3. On wake-up (SYSCLK = HSI) : HSE / PLL restarted and SYSCLK switched back,
+ *    same path as MCU_enuInit
+ * 4. Time asleep read from the RTC (it kept running from LSI)
+ */
+static PWRM_Status_t localStop(PWRM_Mode_t mode, uint32_t idleTime_ms, uint32_t *sleptTime_ms){
+    PWRM_Status_t retStatus = PWRM_OK;
+    uint32_t wakeupTime = idleTime_ms - PWRM_STOP_WAKEUP_MARGIN_MS;
+    uint32_t maxWakeupTime = 0;
+    uint32_t before = 0;
+    uint32_t after = 0;
+    uint32_t elapsed;
+
+    PWR_enuGetMaxWakeupTime(&maxWakeupTime);
+    if(wakeupTime > maxWakeupTime){
+        wakeupTime = maxWakeupTime;
+    }
+
+    if((PWR_OK != PWR_enuGetTime_ms(&before)) || (PWR_OK != PWR_enuStartWakeupTimer(wakeupTime)) ||
+       (MCU_OK != MCU_enuSuspendClock())){
+        /* RTC not usable : fall back to Sleep, SysTick still wakes the core */
+        PWR_enuStopWakeupTimer();
+        localSleep();
+        retStatus = PWRM_PWR_ERROR;
+    }else{
+        PWR_enuEnterMode((PWR_Mode_t)mode);
+
+        if(MCU_OK != MCU_enuResumeClock()){
+            retStatus = PWRM_CLOCK_ERROR;
+        }
+        PWR_enuStopWakeupTimer();
+        PWR_enuGetTime_ms(&after);
+
+        elapsed = (after >= before) ? (after - before) : (after + PWR_TIME_WRAP_MS - before);
+        *sleptTime_ms = elapsed;
+
+        Residency[mode].PWRM_Entries++;
+        Residency[mode].PWRM_Residency_us += (uint64_t)elapsed * 1000UL;
+        if(elapsed < wakeupTime){
+            Residency[mode].PWRM_EarlyWakeups++;
+        }
+    }
+
+    return retStatus;
+}
@@ -1,7 +1,14 @@
+#include "LIB/bits.h"
 #include "MCAL/SYSTICK_TIMER_Driver/systick.h"
+#include "MCAL/NVIC_Driver/nvic.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "HAL/MCU_Driver/mcu.h"
 
 #include "OS/schedule_cfg.h"
 #include "OS/schedule.h"
+#include "OS/power.h"
+#include "OS/stack.h"
+#include "OS/trace.h"
 
 /*
  * Static variable storing the scheduler tick time in milliseconds
@@ -16,7 +23,7 @@ static uint32_t TickTime = 0;
  * Cleared by scheduler main loop after processing tick
  * Used for synchronization between ISR and main scheduler loop
  */
-static bool_t Systick_triggered = FALSE;
+static volatile bool_t Systick_triggered = FALSE;
 
 /*
  * Static array of pointers to registered runnable tasks
@@ -26,6 +33,33 @@ static bool_t Systick_triggered = FALSE;
  */
 static SCHED_Runnable_t* savedRunnbles[MAX_RUNNABLES];
 
+/*
+ * Static bitmap of the occupied priority slots (bit index = slot of savedRunnbles)
+ * Kept with savedRunnbles by register / remove, the tick and idle loops visit
+ * only the set bits (lowest first, CTZ) instead of every slot
+ */
+static uint32_t registeredRunnables = 0;
+
+/*
+ * Largest value of the 24-bit SysTick reload register (STK_LOAD)
+ */
+#define SCHED_SYSTICK_MAX_RELOAD    (0x00FFFFFFUL)
+
+_Static_assert(MAX_RUNNABLES <= 32, "Scheduler: MAX_RUNNABLES must fit the 32-bit slot bitmap");
+
+/*
+ * Static tick counter maintains total elapsed time in milliseconds
+ * Incremented by TickTime at end of each scheduler tick
+ * Advanced by the idle hook for the ticks skipped while SysTick was frozen in STOP
+ */
+static uint64_t tickCounters = 0;
+
+/*
+ * Static array of the deepest stack point reached by each runnable (bytes from _estack)
+ * Indexed like savedRunnbles, filled when SCHED_STACK_MONITOR is enabled
+ */
+static uint32_t runnableStackUsage[MAX_RUNNABLES];
+
 /*
  * Forward declaration of SysTick callback function
  * Called by SysTick ISR on every timer overflow
@@ -40,6 +74,27 @@ static void SCHED_vdExec();
  */
 static void localExecuteRunnables();
 
+/*
+ * Forward declaration of clock change notifier
+ * Registered with the MCU driver in SCHED_enuInit()
+ * Recomputes the SysTick reload value after a runtime frequency change
+ */
+static void SCHED_vdClockChangeNotifier(uint8_t phase);
+
+/*
+ * Forward declaration of reload value computation
+ * Used by SCHED_enuInit() and the clock change notifier
+ * Rejects a reload that would underflow or not fit STK_LOAD
+ */
+static SCHED_Status_t localReloadValue(uint32_t clockHz, uint32_t tickTime_ms, uint32_t *loadValue);
+
+/*
+ * Forward declaration of idle hook
+ * Called from scheduler main loop while no tick is pending
+ * Hands the time until the next due runnable to the power manager
+ */
+static void localIdle(void);
+
 /*
  * Function: SCHED_enuInit
  * Description: Initializes the scheduler system and configures SysTick timer
@@ -48,12 +103,14 @@ static void localExecuteRunnables();
  * Parameters:
  *   - copyTickTime_ms: Scheduler tick period in milliseconds (time quantum)
  *   - copyClockSourceVAlue_hz: System clock frequency in Hz (used for SysTick calculation)
+ *                              SCHED_CLOCK_AUTO reads the current HCLK from the MCU driver
  * Returns: SCHED_Status_t indicating success or specific error condition
  * 
  * Implementation steps:
- * 1. Store tick time for later use
- * 2. Initialize SysTick with clock frequency and no prescaler
- * 3. Calculate SysTick reload value: (TickTime_ms × Clock_Hz / 1000) - 1
+ * 1. Store tick time for later use (and resolve the clock frequency if SCHED_CLOCK_AUTO)
+ * 2. Calculate SysTick reload value: (Clock_Hz / 1000 × TickTime_ms) - 1
+ *    SCHED_WRONG_TICK_PERIOD without touching SysTick if it underflows or exceeds 24 bits
+ * 3. Initialize SysTick with clock frequency and no prescaler
  * 4. Set SysTick reload value
  * 5. Register scheduler tick callback with SysTick
  */
@@ -64,37 +121,45 @@ SCHED_Status_t SCHED_enuInit(uint32_t copyTickTime_ms,uint32_t copyClockSourceVA
     
     /* Variable to track SysTick driver operation status */
     SYSTICK_Status_t systickStatus = SYSTICK_NOT_OK;
+
+    /* Variable to store calculated SysTick reload value */
+    uint32_t loadValue = 0;
     
     /* Store the tick time for use in runnable execution timing */
     TickTime = copyTickTime_ms;
 
-    /* 
-     * Initialize SysTick timer with system clock and no prescaler
-     * Uses full processor clock frequency for maximum timing accuracy
+    /* Read the processor clock from the clock tree when no frequency is given */
+    if(SCHED_CLOCK_AUTO == copyClockSourceVAlue_hz){
+        if(MCU_OK != MCU_GetClockHz(MCU_AHB1_BUS, &copyClockSourceVAlue_hz)){
+            copyClockSourceVAlue_hz = 0;
+        }
+    }
+
+    /*
+     * Calculate SysTick reload value for desired tick period
+     * Formula: LoadValue = (ClockFrequency_Hz / 1000 × TickTime_ms) - 1
+     * Checked before SysTick is touched : a 0 Hz clock or 0 ms tick would
+     * underflow to 0xFFFFFFFF, a long tick would not fit the 24-bit STK_LOAD
      */
-    systickStatus = SYSTICK_Init(copyClockSourceVAlue_hz,SYSTICK_NO_PRESCALLER);
+    retStatus = localReloadValue(copyClockSourceVAlue_hz, copyTickTime_ms, &loadValue);
+
+    if(SCHED_OK != retStatus){
+        /* Keep SysTick as it is */
+    }else{
+        /* 
+         * Initialize SysTick timer with system clock and no prescaler
+         * Uses full processor clock frequency for maximum timing accuracy
+         */
+        systickStatus = SYSTICK_Init(copyClockSourceVAlue_hz,SYSTICK_NO_PRESCALLER);
+    }
 
     /* Check if SysTick initialization was successful */
-    if(SYSTICK_OK!=systickStatus){
+    if(SCHED_OK != retStatus){
+        /* Reload value rejected above */
+    }else if(SYSTICK_OK!=systickStatus){
         /* Return error if SysTick failed to initialize */
         retStatus = SCHED_SYSTICK_ERROR;
     }else{
-        /* Variable to store calculated SysTick reload value */
-        uint32_t loadValue;
-        
-        /*
-         * Calculate SysTick reload value for desired tick period
-         * Formula: LoadValue = (TickTime_ms × ClockFrequency_Hz / 1000) - 1
-         * 
-         * Explanation:
-         * - Multiply tick time by clock frequency to get total clock cycles
-         * - Divide by 1000 to convert milliseconds to seconds
-         * - Subtract 1 because SysTick counts from LOAD to 0 (inclusive)
-         * 
-         * Example: For 1ms tick at 84MHz: (1 × 84,000,000 / 1000) - 1 = 83,999
-         */
-        loadValue = ((copyTickTime_ms * copyClockSourceVAlue_hz) / 1000) - 1;
-
         /* Set the calculated reload value in SysTick timer */
         systickStatus = SYSTICK_SetStartValue(loadValue);
         
@@ -114,6 +179,9 @@ SCHED_Status_t SCHED_enuInit(uint32_t copyTickTime_ms,uint32_t copyClockSourceVA
                 /* Return error if callback registration failed */
                 retStatus = SCHED_SYSTICK_FAILED_TO_SET_CALLBACK;
             }else{
+                /* Keep the tick period when the clock is changed at runtime */
+                MCU_enuRegisterClockNotifier(SCHED_vdClockChangeNotifier);
+
                 /* All initialization steps completed successfully */
                 retStatus = SCHED_OK;
             }
@@ -139,9 +207,10 @@ SCHED_Status_t SCHED_enuInit(uint32_t copyTickTime_ms,uint32_t copyClockSourceVA
  * - This design separates ISR context from task execution context
  * - Prevents long-running tasks from blocking interrupts
  */
-static void SCHED_vdExec(){
+RAMFUNC static void SCHED_vdExec(){
     /* Set flag to indicate SysTick interrupt occurred */
     Systick_triggered = TRUE;
+    TRACE_EVENT(TRACE_EVENT_TICK, 0);
 }
 
 
@@ -173,6 +242,9 @@ SCHED_Status_t SCHED_enuRegisterRunnable(SCHED_Runnable_t * runnabelPtr){
     if(NULL == runnabelPtr){
         retStatus = SCHED_NULL_PTR;
     }else{
+        /* Slot and bitmap updated together, registration may come from an ISR callback */
+        NVIC_EnterCritical();
+
         /* Check if priority slot is already occupied */
         if(NULL != savedRunnbles[runnabelPtr->Priority]){
             /* Return error if another runnable already registered at this priority */
@@ -180,8 +252,11 @@ SCHED_Status_t SCHED_enuRegisterRunnable(SCHED_Runnable_t * runnabelPtr){
         }else{
             /* Store runnable pointer at its priority index in the array */
             savedRunnbles[runnabelPtr->Priority] = runnabelPtr;
+            registeredRunnables |= BITS_MASK(runnabelPtr->Priority);
             retStatus = SCHED_OK;
         }
+
+        NVIC_ExitCritical();
     }
     
     /* Return registration status */
@@ -212,7 +287,10 @@ SCHED_Status_t SCHED_enuRemoveRunnable(SCHED_Runnable_t *runnabelPtr){
         retStatus = SCHED_NULL_PTR;
     }else{
         /* Clear the runnable pointer at its priority index */
+        NVIC_EnterCritical();
         savedRunnbles[runnabelPtr->Priority] = NULL;
+        registeredRunnables &= ~BITS_MASK(runnabelPtr->Priority);
+        NVIC_ExitCritical();
         retStatus = SCHED_OK;
     }
     
@@ -240,28 +318,66 @@ SCHED_Status_t SCHED_enuRemoveRunnable(SCHED_Runnable_t *runnabelPtr){
  * - Runnable execution happens in main context, not ISR context
  * - Allows long-running tasks without blocking interrupts
  * - Simple cooperative scheduling (no preemption within a tick)
+ * - Between ticks the idle hook sleeps (SCHED_IDLE_MODE in schedule_cfg.h)
  */
 void SCHED_enuStart(){
+    /* Tick flag taken from the ISR */
+    bool_t tickPending;
+
     /* Start the SysTick timer - begins generating periodic interrupts */
     SYSTICK_StartCount();
 
     /* Infinite main scheduler loop */
     while(1){
+        /*
+         * Read and clear the tick flag in one critical section
+         * A tick landing between a plain read and clear would be lost
+         * (SysTick runs at the lowest priority, below the BASEPRI threshold)
+         */
+        NVIC_EnterCritical();
+        tickPending = Systick_triggered;
+        Systick_triggered = FALSE;
+        NVIC_ExitCritical();
+
         /* Check if SysTick interrupt has occurred */
-        if(Systick_triggered == TRUE){
-            /* Clear the flag to acknowledge this tick */
-            Systick_triggered = FALSE;
-            
+        if(tickPending == TRUE){
             /* Execute all runnables that are ready to run */
             localExecuteRunnables();
         }else{
             /* No tick occurred yet - wait for next interrupt */
-            /* NOP (No Operation) - could implement idle/sleep mode here */
+            localIdle();
         }
     }
     
 }
 
+/*
+ * Function: SCHED_enuGetRunnableStackUsage
+ * Description: Returns the stack peak recorded for the runnable at a priority slot
+ * Parameters:
+ *   - priority: Priority (slot index) of the runnable
+ *   - stackUsage: Pointer to store the depth in bytes
+ * Returns: SCHED_Status_t indicating success or error
+ */
+SCHED_Status_t SCHED_enuGetRunnableStackUsage(uint32_t priority, uint32_t *stackUsage){
+    /* Initialize return status as not OK */
+    SCHED_Status_t retStatus = SCHED_NOT_OK;
+
+    /* Validate pointer parameter */
+    if(NULL == stackUsage){
+        retStatus = SCHED_NULL_PTR;
+    }else if(priority >= MAX_RUNNABLES){
+        /* No slot at this priority */
+        retStatus = SCHED_NOT_OK;
+    }else{
+        *stackUsage = runnableStackUsage[priority];
+        retStatus = SCHED_OK;
+    }
+
+    /* Return query status */
+    return retStatus;
+}
+
 /*
  * Function: localExecuteRunnables
  * Description: Iterates through all registered runnables and executes those that are ready
@@ -272,32 +388,40 @@ void SCHED_enuStart(){
  * 
  * Scheduling algorithm:
  * 1. Maintain a tick counter (increments by TickTime each call)
- * 2. For each priority level (0 to MAX_RUNNABLES-1):
- *    a. Check if runnable is registered at this priority
+ * 2. For each occupied priority level (set bits of registeredRunnables, lowest first):
+ *    a. Check if runnable is still registered at this priority
  *    b. Check if callback function is valid
  *    c. Check if enough time has elapsed (tickCounters % Periodicity == 0)
  *    d. If ready, execute callback with its arguments
  * 3. Increment tick counter
  * 
  * Implementation notes:
- * - Uses static variable to maintain tick count across calls
+ * - Uses file static tickCounters to maintain tick count across calls
  * - Modulo operation determines if periodicity has elapsed
  * - Does NOT handle FirstDelay_ms (bug/missing feature)
  * - Executes runnables in priority order (lower index = higher priority)
+ * - The bitmap is read once per tick, a runnable removed by an earlier one
+ *   of the same tick is skipped by the NULL check
  * - All ready runnables execute within single tick (cooperative multitasking)
+ * - Runs from RAM (RAMFUNC) with SCHED_vdExec, the runnables themselves stay in flash
+ * - With SCHED_STACK_MONITOR enabled each call is wrapped in a stack window
  */
-static void localExecuteRunnables(){
+RAMFUNC static void localExecuteRunnables(){
 
-    /*
-     * Static tick counter maintains total elapsed time in milliseconds
-     * Persists across function calls to track time for all runnables
-     * Incremented by TickTime at end of each scheduler tick
-     */
-    static uint64_t tickCounters = 0;
+#if SCHED_STACK_MONITOR == SCHED_STACK_MONITOR_ENABLED
+    /* Deepest stack point of the runnable just executed */
+    uint32_t stackDepth;
+#endif
+
+    /* Occupied priority levels, lowest index first */
+    uint32_t pending = registeredRunnables;
+    uint32_t index;
+
+    while(0U != pending){
+        index = BITS_u32Ctz(pending);
+        pending &= (pending - 1U);
 
-    /* Iterate through all possible priority levels */
-    for(uint32_t index = 0;index<MAX_RUNNABLES;index++){
-        /* Check if a runnable is registered at this priority level */
+        /* Check if a runnable is (still) registered at this priority level */
         if(NULL != savedRunnbles[index]){
             /* Check if the runnable has a valid callback function */
             if(NULL != savedRunnbles[index]->CBF){
@@ -315,8 +439,22 @@ static void localExecuteRunnables(){
                 if(tickCounters >= savedRunnbles[index]->FirstDalay_ms){
 
                     if(0 == ((tickCounters-savedRunnbles[index]->FirstDalay_ms)%savedRunnbles[index]->Periodicity_ms)){
+#if SCHED_STACK_MONITOR == SCHED_STACK_MONITOR_ENABLED
+                        /* Repaint below the scheduler frame, the runnable's peak is read back after it */
+                        STACK_vdWindowBegin();
+                        TRACE_EVENT(TRACE_EVENT_RUNNABLE_START, index);
+                        savedRunnbles[index]->CBF(savedRunnbles[index]->Args);
+                        TRACE_EVENT(TRACE_EVENT_RUNNABLE_END, index);
+                        stackDepth = STACK_u32WindowEnd();
+                        if(stackDepth > runnableStackUsage[index]){
+                            runnableStackUsage[index] = stackDepth;
+                        }
+#else
                         /* Execute the runnable's callback function with its arguments */
+                        TRACE_EVENT(TRACE_EVENT_RUNNABLE_START, index);
                         savedRunnbles[index]->CBF(savedRunnbles[index]->Args);
+                        TRACE_EVENT(TRACE_EVENT_RUNNABLE_END, index);
+#endif
                     }else{
                         /* Not yet time to execute this runnable - skip to next */
                     }
@@ -337,4 +475,127 @@ static void localExecuteRunnables(){
      * Tracks total elapsed time for all runnable timing calculations
      */
     tickCounters+=TickTime;
-}
\ No newline at end of file
+}
+
+/*
+ * Function: SCHED_vdClockChangeNotifier
+ * Description: Clock change notifier registered by SCHED_enuInit()
+ *              Called by MCU_enuSetClockProfile() with interrupts masked
+ * Parameters:
+ *   - phase: MCU_CLOCK_PRE_CHANGE or MCU_CLOCK_POST_CHANGE
+ * Returns: None
+ * 
+ * Implementation notes:
+ * - Nothing to do before the change
+ * - After the change the SysTick driver refreshes its clock value, then the
+ *   reload value is recomputed exactly from TickTime and the new HCLK
+ * - A pending tick flag is kept so no runnable period is lost
+ */
+static void SCHED_vdClockChangeNotifier(uint8_t phase){
+    uint32_t clockValue = 0;
+    uint32_t loadValue = 0;
+
+    if(MCU_CLOCK_POST_CHANGE == phase){
+        SYSTICK_vdClockChangeNotifier(phase);
+
+        /* A tick that no longer fits the new clock keeps the previous reload */
+        if((MCU_OK == MCU_GetClockHz(MCU_AHB1_BUS, &clockValue)) &&
+           (SCHED_OK == localReloadValue(clockValue, TickTime, &loadValue))){
+            SYSTICK_SetStartValue(loadValue);
+        }
+    }
+}
+
+/*
+ * Function: localReloadValue
+ * Description: Computes the SysTick reload value of a tick period
+ *              LoadValue = (Clock_Hz / 1000 × TickTime_ms) - 1
+ * Parameters:
+ *   - clockHz: SysTick clock in Hz
+ *   - tickTime_ms: Tick period in milliseconds
+ *   - loadValue: Pointer to store the reload value
+ * Returns: SCHED_OK, or SCHED_WRONG_TICK_PERIOD when the cycle count is 0
+ *          (would underflow) or the reload exceeds the 24-bit STK_LOAD
+ *
+ * Implementation notes:
+ * - Dividing first keeps the cycles per millisecond exact at whole-kHz clocks
+ * - The product is formed on 64 bits so a long tick cannot wrap into range
+ */
+static SCHED_Status_t localReloadValue(uint32_t clockHz, uint32_t tickTime_ms, uint32_t *loadValue){
+    SCHED_Status_t retStatus = SCHED_NOT_OK;
+    uint64_t cycles = (uint64_t)(clockHz / 1000) * tickTime_ms;
+
+    if((0 == cycles) || ((cycles - 1) > SCHED_SYSTICK_MAX_RELOAD)){
+        retStatus = SCHED_WRONG_TICK_PERIOD;
+    }else{
+        *loadValue = (uint32_t)(cycles - 1);
+        retStatus = SCHED_OK;
+    }
+
+    return retStatus;
+}
+
+/*
+ * Function: localIdle
+ * Description: Idle hook of the scheduler main loop
+ *              Computes how many ticks can pass before a runnable is due and
+ *              lets the power manager pick Sleep or STOP for that time
+ * Parameters: None
+ * Returns: None
+ *
+ * Implementation notes:
+ * - Interrupts are masked around the check of Systick_triggered so a tick that
+ *   fires between the check and WFI still wakes the core (WFI ignores PRIMASK)
+ * - In STOP SysTick is frozen : the ticks that fit in the reported sleep time
+ *   are added to tickCounters, never more than the ticks before the next due
+ *   runnable, so no release is skipped
+ * - With SCHED_IDLE_MODE = SCHED_IDLE_BUSY_WAIT the hook does nothing (old behaviour)
+ */
+static void localIdle(void){
+#if SCHED_IDLE_MODE == SCHED_IDLE_LOW_POWER
+    uint64_t idleTicks = (0 == TickTime) ? 0 : (SCHED_MAX_IDLE_MS / TickTime);
+    uint64_t waitTime;
+    uint64_t sinceFirst;
+    uint32_t sleptTime = 0;
+    uint64_t sleptTicks;
+    uint32_t pending;
+    uint32_t index;
+
+    NVIC_DisableAllIRQ();
+
+    if(Systick_triggered == FALSE){
+        /* Smallest distance from the next tick to a release, in whole ticks */
+        pending = registeredRunnables;
+        while(0U != pending){
+            index = BITS_u32Ctz(pending);
+            pending &= (pending - 1U);
+
+            if((NULL != savedRunnbles[index]) && (NULL != savedRunnbles[index]->CBF) &&
+               (0 != savedRunnbles[index]->Periodicity_ms)){
+
+                if(tickCounters < savedRunnbles[index]->FirstDalay_ms){
+                    waitTime = savedRunnbles[index]->FirstDalay_ms - tickCounters;
+                }else{
+                    sinceFirst = (tickCounters - savedRunnbles[index]->FirstDalay_ms) % savedRunnbles[index]->Periodicity_ms;
+                    waitTime = (0 == sinceFirst) ? 0 : (savedRunnbles[index]->Periodicity_ms - sinceFirst);
+                }
+
+                if((waitTime / TickTime) < idleTicks){
+                    idleTicks = waitTime / TickTime;
+                }
+            }
+        }
+
+        PWRM_enuIdle((uint32_t)(idleTicks * TickTime), &sleptTime);
+
+        /* Catch up with the ticks SysTick missed while frozen in STOP */
+        sleptTicks = sleptTime / TickTime;
+        if(sleptTicks > idleTicks){
+            sleptTicks = idleTicks;
+        }
+        tickCounters += sleptTicks * TickTime;
+    }
+
+    NVIC_EnableAllIRQ();
+#endif
+}
@@ -0,0 +1,309 @@
+
+#include "LIB/stdtypes.h"
+#include "HAL/SD_Driver/sd.h"
+
+#include "OS/sdlog_cfg.h"
+#include "OS/sdlog.h"
+
+/*
+ * Block layout
+ * +----------------------------------------+
+ * | magic | block | used | records |  header (12 bytes)
+ * +----------------------------------------+
+ * | length (2) | data | length | data ...   |  records, never split
+ * | unused up to 512                       |
+ * +----------------------------------------+
+ *
+ * block is the index of the block in the log area : a stale block left by an
+ * older log at another index, or an erased one, is not taken as part of the log
+ */
+#define SDLOG_MAGIC                 (0x31474C53UL)  /* "SLG1" */
+#define SDLOG_HEADER_SIZE           (12U)
+#define SDLOG_LENGTH_SIZE           (2U)
+
+typedef struct {
+    uint32_t SDLOG_Magic;
+    uint32_t SDLOG_Block;
+    uint16_t SDLOG_Used;            /* Header included */
+    uint16_t SDLOG_Records;
+}SDLOG_BlockHeader_t;
+
+/* TRUE once SDLOG_enuInit() found the end of the log */
+static bool_t LogInitialized = FALSE;
+
+/*
+ * Double buffer : the producer fills LogBuffers[LogFill], the runnable writes
+ * LogBuffers[LogSend]. LogSealed hands a block over (set by the producer,
+ * cleared by the runnable once programmed), nothing else is shared
+ */
+static uint32_t LogBuffers[2][SD_BLOCK_SIZE / 4U];
+static volatile bool_t LogSealed[2] = {FALSE, FALSE};
+
+/* Producer side */
+static uint8_t LogFill = 0;
+static uint16_t LogFillBytes = SDLOG_HEADER_SIZE;
+static uint16_t LogFillRecords = 0;
+static uint32_t LogFillBlock = 0;
+static uint32_t LogBytesLogged = 0;
+static uint32_t LogRecordsDropped = 0;
+static volatile bool_t LogCloseRequested = FALSE;
+
+/* Runnable side */
+static uint8_t LogSend = 0;
+static bool_t LogStreamOpen = FALSE;
+static bool_t LogInFlight = FALSE;
+static uint32_t LogStreamLeft = 0;
+static uint32_t LogBlocksWritten = 0;
+static uint32_t LogWriteErrors = 0;
+
+/* TRUE if the card block holds the log block of this index */
+static bool_t localIsLogBlock(uint32_t index, SDLOG_Status_t *status);
+
+/* Writes the header and hands the block to the runnable */
+static void localSeal(void);
+
+/*
+ * Function: SDLOG_enuInit
+ * Description: Binary search of the first log block not written yet
+ * Note: Valid because the log is written in order from the first block :
+ *       blocks 0 .. n - 1 carry their own index, block n does not
+ */
+SDLOG_Status_t SDLOG_enuInit(void){
+    SDLOG_Status_t retStatus = SDLOG_OK;
+    SD_CardType_t type = SD_CARD_NONE;
+    uint32_t low = 0;
+    uint32_t high = SDLOG_BLOCK_COUNT;
+
+    LogInitialized = FALSE;
+
+    if(SD_enuGetCardType(&type) != SD_OK){
+        retStatus = SDLOG_NOT_INIT;
+    }else{
+        while((low < high) && (retStatus == SDLOG_OK)){
+            uint32_t middle = low + ((high - low) / 2U);
+            if(localIsLogBlock(middle, &retStatus) == TRUE){
+                low = middle + 1U;
+            }else{
+                high = middle;
+            }
+        }
+    }
+
+    if(retStatus == SDLOG_OK){
+        LogSealed[0] = FALSE;
+        LogSealed[1] = FALSE;
+        LogFill = 0;
+        LogFillBytes = SDLOG_HEADER_SIZE;
+        LogFillRecords = 0;
+        LogFillBlock = low;
+        LogBytesLogged = 0;
+        LogRecordsDropped = 0;
+        LogCloseRequested = FALSE;
+
+        LogSend = 0;
+        LogStreamOpen = FALSE;
+        LogInFlight = FALSE;
+        LogStreamLeft = 0;
+        LogBlocksWritten = 0;
+        LogWriteErrors = 0;
+
+        LogInitialized = TRUE;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: SDLOG_enuAppend
+ * Description: Copies a record, seals the block first when the record does not fit
+ */
+SDLOG_Status_t SDLOG_enuAppend(const void *record, uint16_t length){
+    SDLOG_Status_t retStatus = SDLOG_OK;
+
+    if(NULL == record){
+        retStatus = SDLOG_NULL_PTR;
+    }else if(LogInitialized == FALSE){
+        retStatus = SDLOG_NOT_INIT;
+    }else if((length == 0) || (length > SDLOG_MAX_RECORD_SIZE)){
+        retStatus = SDLOG_WRONG_LENGTH;
+    }else if(LogFillBlock >= SDLOG_BLOCK_COUNT){
+        retStatus = SDLOG_FULL;
+    }else{
+        if((LogFillBytes + SDLOG_LENGTH_SIZE + length) > SD_BLOCK_SIZE){
+            if(LogSealed[LogFill ^ 1U] == TRUE){
+                retStatus = SDLOG_OVERRUN;
+            }else{
+                localSeal();
+                if(LogFillBlock >= SDLOG_BLOCK_COUNT){
+                    retStatus = SDLOG_FULL;
+                }
+            }
+        }
+
+        if(retStatus == SDLOG_OK){
+            uint8_t *destination = (uint8_t*)LogBuffers[LogFill] + LogFillBytes;
+            const uint8_t *source = (const uint8_t*)record;
+            uint16_t i;
+
+            destination[0] = (uint8_t)length;
+            destination[1] = (uint8_t)(length >> 8);
+            for(i = 0; i < length; i++){
+                destination[SDLOG_LENGTH_SIZE + i] = source[i];
+            }
+            LogFillBytes += SDLOG_LENGTH_SIZE + length;
+            LogFillRecords++;
+            LogBytesLogged += length;
+        }else{
+            LogRecordsDropped++;
+        }
+    }
+    return retStatus;
+}
+
+/*
+ * Function: SDLOG_enuFlush
+ * Description: Seals a partly filled block and requests the stream close
+ */
+SDLOG_Status_t SDLOG_enuFlush(void){
+    SDLOG_Status_t retStatus = SDLOG_OK;
+
+    if(LogInitialized == FALSE){
+        retStatus = SDLOG_NOT_INIT;
+    }else if(LogFillRecords != 0){
+        if(LogSealed[LogFill ^ 1U] == TRUE){
+            retStatus = SDLOG_OVERRUN;
+        }else{
+            localSeal();
+        }
+    }else{
+        // Nothing to seal
+    }
+
+    if(retStatus == SDLOG_OK){
+        LogCloseRequested = TRUE;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: SDLOG_vdRunnable
+ * Description: One step of the write stream
+ *
+ * Implementation notes:
+ * - The address of a block comes from its header : a block rejected by the
+ *   card stays sealed and is written again by the next stream
+ * - A stream is reopened every SDLOG_STREAM_BLOCKS blocks so the ACMD23
+ *   pre-erase count stays what the card really receives
+ * - Nothing here waits for the card : SD_enuStreamPoll returns SD_BUSY while
+ *   it programs and the step is retried at the next call
+ */
+void SDLOG_vdRunnable(void *args){
+    SD_Status_t sdStatus = SD_NOT_OK;
+    const SDLOG_BlockHeader_t *header = (const SDLOG_BlockHeader_t*)LogBuffers[LogSend];
+
+    (void)args;
+
+    if(LogInitialized == TRUE){
+        sdStatus = SD_enuStreamPoll();
+
+        if(sdStatus == SD_DATA_ERROR){
+            // The driver closes the stream, the block is written again
+            LogWriteErrors++;
+            LogInFlight = FALSE;
+            LogStreamOpen = FALSE;
+        }else if(sdStatus == SD_OK){
+            if(LogInFlight == TRUE){
+                LogInFlight = FALSE;
+                LogSealed[LogSend] = FALSE;
+                LogSend ^= 1U;
+                header = (const SDLOG_BlockHeader_t*)LogBuffers[LogSend];
+                LogBlocksWritten++;
+                LogStreamLeft--;
+            }
+
+            if((LogStreamOpen == FALSE) && (LogSealed[LogSend] == TRUE)){
+                uint32_t eraseCount = SDLOG_BLOCK_COUNT - header->SDLOG_Block;
+                if(eraseCount > SDLOG_STREAM_BLOCKS){
+                    eraseCount = SDLOG_STREAM_BLOCKS;
+                }
+                if(SD_enuStreamOpen(SDLOG_FIRST_BLOCK + header->SDLOG_Block, eraseCount) == SD_OK){
+                    LogStreamOpen = TRUE;
+                    LogStreamLeft = eraseCount;
+                }else{
+                    LogWriteErrors++;
+                }
+            }
+
+            if(LogStreamOpen == TRUE){
+                if((LogSealed[LogSend] == TRUE) && (LogStreamLeft != 0)){
+                    if(SD_enuStreamWrite((const uint8_t*)LogBuffers[LogSend]) == SD_OK){
+                        LogInFlight = TRUE;
+                    }
+                }else if((LogStreamLeft == 0) ||
+                         ((LogCloseRequested == TRUE) && (LogSealed[LogSend] == FALSE))){
+                    if(SD_enuStreamClose() == SD_OK){
+                        LogStreamOpen = FALSE;
+                        LogCloseRequested = FALSE;
+                    }
+                }else{
+                    // Wait for the producer
+                }
+            }
+        }else{
+            // Card busy
+        }
+    }
+}
+
+/*
+ * Function: SDLOG_enuGetStats
+ * Description: Returns the logger counters
+ */
+SDLOG_Status_t SDLOG_enuGetStats(SDLOG_Stats_t *stats){
+    SDLOG_Status_t retStatus = SDLOG_NOT_OK;
+
+    if(NULL == stats){
+        retStatus = SDLOG_NULL_PTR;
+    }else if(LogInitialized == FALSE){
+        retStatus = SDLOG_NOT_INIT;
+    }else{
+        stats->SDLOG_NextBlock = LogFillBlock;
+        stats->SDLOG_BlocksWritten = LogBlocksWritten;
+        stats->SDLOG_BytesLogged = LogBytesLogged;
+        stats->SDLOG_RecordsDropped = LogRecordsDropped;
+        stats->SDLOG_WriteErrors = LogWriteErrors;
+        stats->SDLOG_Idle = ((LogSealed[0] == FALSE) && (LogSealed[1] == FALSE) &&
+                             (LogStreamOpen == FALSE)) ? TRUE : FALSE;
+        retStatus = SDLOG_OK;
+    }
+    return retStatus;
+}
+
+static bool_t localIsLogBlock(uint32_t index, SDLOG_Status_t *status){
+    const SDLOG_BlockHeader_t *header = (const SDLOG_BlockHeader_t*)LogBuffers[0];
+    bool_t isLogBlock = FALSE;
+
+    if(SD_enuReadBlock(SDLOG_FIRST_BLOCK + index, (uint8_t*)LogBuffers[0]) != SD_OK){
+        *status = SDLOG_SD_ERROR;
+    }else if((header->SDLOG_Magic == SDLOG_MAGIC) && (header->SDLOG_Block == index) &&
+             (header->SDLOG_Used >= SDLOG_HEADER_SIZE) && (header->SDLOG_Used <= SD_BLOCK_SIZE)){
+        isLogBlock = TRUE;
+    }else{
+        // Erased or foreign block
+    }
+    return isLogBlock;
+}
+
+static void localSeal(void){
+    SDLOG_BlockHeader_t *header = (SDLOG_BlockHeader_t*)LogBuffers[LogFill];
+
+    header->SDLOG_Magic = SDLOG_MAGIC;
+    header->SDLOG_Block = LogFillBlock;
+    header->SDLOG_Used = LogFillBytes;
+    header->SDLOG_Records = LogFillRecords;
+
+    LogSealed[LogFill] = TRUE;
+    LogFill ^= 1U;
+    LogFillBytes = SDLOG_HEADER_SIZE;
+    LogFillRecords = 0;
+    LogFillBlock++;
+}
@@ -0,0 +1,148 @@
+#include "LIB/stdtypes.h"
+
+#include "OS/stack_cfg.h"
+#include "OS/stack.h"
+
+/*
+ * Linker script symbols
+ * _estack : top of RAM, initial MSP
+ * _sstack : bottom of the reserved stack (_estack - _Min_Stack_Size)
+ */
+extern uint32_t _estack;
+extern uint32_t _sstack;
+
+/* TRUE once STACK_vdPaint() has run */
+static bool_t StackPainted = FALSE;
+
+/*
+ * Deepest point seen by a previous scan, in bytes from _estack
+ * Kept because STACK_vdWindowBegin() repaints the area it was measured on
+ */
+static uint32_t HighWater = 0;
+
+/* Lowest address written since the last scan (first non-pattern word) */
+static uint32_t* localFindLowestUsed(void);
+
+/* Paints from the bottom of the stack to the guard below the caller */
+static void localPaint(void);
+
+/* Current main stack pointer */
+static inline uint32_t localGetMSP(void){
+    uint32_t msp;
+    __asm volatile ("MRS %0, msp" : "=r" (msp));
+    return msp;
+}
+
+/*
+ * Function: STACK_vdPaint
+ * Description: Fills the unused part of the reserved stack with STACK_PAINT_PATTERN
+ */
+void STACK_vdPaint(void){
+    localPaint();
+    HighWater = STACK_u32GetDepth();
+    StackPainted = TRUE;
+}
+
+/*
+ * Function: STACK_enuGetUsage
+ * Description: Fills the usage report, the high-water mark comes from a scan of the painted area
+ *
+ * Implementation notes:
+ * - The first non-pattern word from the bottom is the deepest point ever written
+ * - The bottom word itself written means the stack went past _sstack into the heap
+ */
+STACK_Status_t STACK_enuGetUsage(STACK_Usage_t *usage){
+    STACK_Status_t retStatus = STACK_NOT_OK;
+    uint32_t *lowestUsed;
+    uint32_t depth;
+
+    if(NULL == usage){
+        retStatus = STACK_NULL_PTR;
+    }else if(FALSE == StackPainted){
+        retStatus = STACK_NOT_PAINTED;
+    }else{
+        lowestUsed = localFindLowestUsed();
+        depth = (uint32_t)&_estack - (uint32_t)lowestUsed;
+        if(depth > HighWater){
+            HighWater = depth;
+        }
+
+        usage->STACK_Size = (uint32_t)&_estack - (uint32_t)&_sstack;
+        usage->STACK_Current = STACK_u32GetDepth();
+        usage->STACK_HighWater = HighWater;
+
+        retStatus = (lowestUsed == &_sstack) ? STACK_OVERFLOW : STACK_OK;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: STACK_u32GetDepth
+ * Description: Current stack depth in bytes
+ */
+uint32_t STACK_u32GetDepth(void){
+    return (uint32_t)&_estack - localGetMSP();
+}
+
+/*
+ * Function: STACK_vdWindowBegin
+ * Description: Saves the high-water mark, then repaints below the caller
+ */
+void STACK_vdWindowBegin(void){
+    uint32_t depth;
+
+    if(TRUE == StackPainted){
+        depth = (uint32_t)&_estack - (uint32_t)localFindLowestUsed();
+        if(depth > HighWater){
+            HighWater = depth;
+        }
+        localPaint();
+    }
+}
+
+/*
+ * Function: STACK_u32WindowEnd
+ * Description: Deepest point reached since STACK_vdWindowBegin()
+ */
+uint32_t STACK_u32WindowEnd(void){
+    uint32_t depth = 0;
+
+    if(TRUE == StackPainted){
+        depth = (uint32_t)&_estack - (uint32_t)localFindLowestUsed();
+        if(depth > HighWater){
+            HighWater = depth;
+        }
+    }
+    return depth;
+}
+
+/*
+ * Function: localFindLowestUsed
+ * Description: Walks up from _sstack while the words still hold the pattern
+ * Note: Stops at the current MSP, everything above it is live
+ */
+static uint32_t* localFindLowestUsed(void){
+    uint32_t *word = &_sstack;
+    uint32_t *msp = (uint32_t*)localGetMSP();
+
+    while((word < msp) && (STACK_PAINT_PATTERN == *word)){
+        word++;
+    }
+    return word;
+}
+
+/*
+ * Function: localPaint
+ * Description: Writes the pattern from _sstack up to STACK_PAINT_GUARD_BYTES below MSP
+ * Note: An interrupt taken while painting only leaves a dead frame behind,
+ *       its words are painted again or counted as used (over-estimate, never under)
+ */
+static void localPaint(void){
+    uint32_t *word = &_sstack;
+    uint32_t *limit = (uint32_t*)(localGetMSP() - STACK_PAINT_GUARD_BYTES);
+
+    while(word < limit){
+        *word = STACK_PAINT_PATTERN;
+        word++;
+    }
+}
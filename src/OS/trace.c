@@ -0,0 +1,234 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/dwt.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "HAL/HSERIAL_Driver/hserial.h"
+#include "HAL/HSERIAL_Driver/hserial_cfg.h"
+
+#include "OS/trace_cfg.h"
+#include "OS/trace.h"
+
+#define TRACE_RING_MASK             (TRACE_RING_LENGTH - 1U)
+#define TRACE_RECORD_SIZE           (8U)
+
+#if (TRACE_RING_LENGTH & TRACE_RING_MASK) != 0
+#error "TRACE_RING_LENGTH must be a power of two"
+#endif
+
+typedef struct {
+    uint32_t TRACE_Timestamp;
+    uint8_t  TRACE_Event;
+    uint8_t  TRACE_Context;
+    uint16_t TRACE_Arg;
+}TRACE_Record_t;
+
+/*
+ * Ring of records : TraceHead and TraceTail run freely, the slot is the low bits
+ * TraceHead moves in TRACE_vdRecord (interrupts masked), TraceTail only in
+ * TRACE_vdTxComplete once the records left the UART
+ */
+static TRACE_Record_t TraceRing[TRACE_RING_LENGTH];
+static volatile uint32_t TraceHead = 0;
+static volatile uint32_t TraceTail = 0;
+
+/* Records in the DMA transfer in progress, 0 = no transfer */
+static volatile uint32_t TraceTxCount = 0;
+
+/* Records dropped on a full ring : total and since the last OVERFLOW record */
+static volatile uint32_t TraceDropped = 0;
+static volatile uint32_t TraceDroppedToReport = 0;
+
+/* TRUE between TRACE_enuStart and TRACE_vdStop */
+static volatile bool_t TraceRunning = FALSE;
+
+/* TRACE_vdRunnable calls since the last transfer */
+static uint32_t TraceCalls = 0;
+
+/* Writes one record, interrupts masked and a free slot checked by the caller */
+static inline void localWrite(TRACE_Event_t event, uint16_t arg);
+
+/*
+ * Every writer of TraceHead masks with PRIMASK, not NVIC_EnterCritical (BASEPRI) :
+ * TRACE_vdRecord is called from interrupts above the BASEPRI threshold too, one of
+ * them must not split a record, the masked window is a few loads and stores
+ */
+static inline uint32_t localMaskAll(void);
+static inline void localRestore(uint32_t primask);
+
+/*
+ * Function: TRACE_enuStart
+ * Description: Starts the cycle counter and a new stream
+ * Note: Records not yet sent are discarded, a transfer in progress ends normally
+ *       (TraceTail catches up with TraceHead in TRACE_vdTxComplete)
+ */
+TRACE_Status_t TRACE_enuStart(void){
+    TRACE_Status_t retStatus = TRACE_NOT_OK;
+    uint32_t hclk = 0;
+    uint32_t primask;
+
+    if(RCC_GetClockHz(RCC_AHB1_BUS, &hclk) == RCC_OK){
+        DWT_vdStart();
+
+        primask = localMaskAll();
+
+        TraceHead = TraceTail + TraceTxCount;
+        TraceDropped = 0;
+        TraceDroppedToReport = 0;
+        TraceCalls = 0;
+        localWrite(TRACE_EVENT_START, 0);
+        localWrite(TRACE_EVENT_CLOCK, (uint16_t)(hclk / 1000000UL));
+        TraceRunning = TRUE;
+
+        localRestore(primask);
+        retStatus = TRACE_OK;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: TRACE_vdStop
+ * Description: Stops recording
+ */
+void TRACE_vdStop(void){
+    TraceRunning = FALSE;
+}
+
+/*
+ * Function: TRACE_vdRecord
+ * Description: Appends one record, or counts it as dropped on a full ring
+ */
+RAMFUNC void TRACE_vdRecord(TRACE_Event_t event, uint16_t arg){
+    uint32_t primask;
+
+    if(TraceRunning == TRUE){
+        primask = localMaskAll();
+
+        if((TraceHead - TraceTail) < TRACE_RING_LENGTH){
+            localWrite(event, arg);
+        }else{
+            TraceDropped++;
+            TraceDroppedToReport++;
+        }
+
+        localRestore(primask);
+    }
+}
+
+/*
+ * Function: TRACE_vdRunnable
+ * Description: Reports drops, then sends the oldest contiguous records
+ *
+ * Implementation notes:
+ * - A transfer never wraps around the end of the ring : the part after the
+ *   wrap goes with the next call
+ * - The records stay in the ring while the DMA reads them, TraceTail moves
+ *   only in TRACE_vdTxComplete so TRACE_vdRecord cannot overwrite them
+ */
+void TRACE_vdRunnable(void *args){
+    uint32_t primask;
+    uint32_t pending;
+    uint32_t first;
+    uint32_t count;
+
+    (void)args;
+
+    if(TraceDroppedToReport != 0){
+        primask = localMaskAll();
+
+        if((TraceHead - TraceTail) < TRACE_RING_LENGTH){
+            count = (TraceDroppedToReport > 0xFFFFUL) ? 0xFFFFUL : TraceDroppedToReport;
+            TraceDroppedToReport -= count;
+            localWrite(TRACE_EVENT_OVERFLOW, (uint16_t)count);
+        }
+
+        localRestore(primask);
+    }
+
+#if (TRACE == TRACE_ENABLED)
+    if(TraceTxCount == 0){
+        pending = TraceHead - TraceTail;
+        if(pending != 0){
+            TraceCalls++;
+            if((pending >= TRACE_MIN_CHUNK) || (TraceCalls >= TRACE_FLUSH_CALLS)){
+                first = TraceTail & TRACE_RING_MASK;
+                count = pending;
+                if(count > (TRACE_RING_LENGTH - first)){
+                    count = TRACE_RING_LENGTH - first;
+                }
+                if(count > TRACE_MAX_CHUNK){
+                    count = TRACE_MAX_CHUNK;
+                }
+
+                // Set before the start : the completion may come from the DMA at once
+                TraceTxCount = count;
+                if(HSERIAL_enuTransmitBuffer(TRACE_HSERIAL_CHANNEL, (const uint8_t*)&TraceRing[first],
+                                             (uint16_t)(count * TRACE_RECORD_SIZE)) == HSERIAL_OK){
+                    TraceCalls = 0;
+                }else{
+                    TraceTxCount = 0;
+                }
+            }
+        }
+    }
+#else
+    /* HSERIAL_CHANNEL_TRACE is not configured, the records stay in the ring */
+    (void)pending;
+    (void)first;
+#endif
+}
+
+/*
+ * Function: TRACE_vdTxComplete
+ * Description: Releases the records of the finished transfer
+ */
+RAMFUNC void TRACE_vdTxComplete(void){
+    TraceTail += TraceTxCount;
+    TraceTxCount = 0;
+}
+
+/*
+ * Function: TRACE_enuGetStats
+ * Description: Returns the trace counters
+ */
+TRACE_Status_t TRACE_enuGetStats(TRACE_Stats_t *stats){
+    TRACE_Status_t retStatus = TRACE_NOT_OK;
+
+    if(NULL == stats){
+        retStatus = TRACE_NULL_PTR;
+    }else{
+        uint32_t tail = TraceTail;
+        uint32_t head = TraceHead;
+
+        stats->TRACE_Recorded = head;
+        stats->TRACE_Dropped = TraceDropped;
+        stats->TRACE_Sent = tail;
+        stats->TRACE_Pending = head - tail;
+        retStatus = TRACE_OK;
+    }
+    return retStatus;
+}
+
+static inline void localWrite(TRACE_Event_t event, uint16_t arg){
+    TRACE_Record_t *record = &TraceRing[TraceHead & TRACE_RING_MASK];
+    uint32_t ipsr;
+
+    __asm volatile ("MRS %0, ipsr" : "=r" (ipsr));
+
+    record->TRACE_Timestamp = DWT_CYCCNT;
+    record->TRACE_Event = (uint8_t)event;
+    record->TRACE_Context = (uint8_t)ipsr;
+    record->TRACE_Arg = arg;
+    TraceHead++;
+}
+
+static inline uint32_t localMaskAll(void){
+    uint32_t primask;
+
+    __asm volatile ("MRS %0, primask" : "=r" (primask) :: "memory");
+    __asm volatile ("CPSID i" ::: "memory");
+    return primask;
+}
+
+static inline void localRestore(uint32_t primask){
+    __asm volatile ("MSR primask, %0" :: "r" (primask) : "memory");
+}
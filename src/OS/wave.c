@@ -0,0 +1,353 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/dwt.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "MCAL/GPIO_Driver/gpio_int.h"
+
+#include "OS/wave_cfg.h"
+#include "OS/wave.h"
+
+#define WAVE_PORTS                  (6U)
+#define WAVE_NO_PULSE               (0xFFFFFFFFUL)
+
+typedef struct {
+    uint32_t WAVE_Timestamp;
+    uint8_t  WAVE_Port;
+    uint8_t  WAVE_Reserved;
+    uint16_t WAVE_Odr;
+}WAVE_Record_t;
+
+/* Changes since WAVE_enuStart, the buffer is filled once (no wrap) */
+static WAVE_Record_t WaveBuffer[WAVE_BUFFER_LENGTH];
+static volatile uint32_t WaveCount = 0;
+static volatile uint32_t WaveDropped = 0;
+
+/* Signals of the capture, and the pins captured on each port */
+static const WAVE_Signal_t *WaveSignals = NULL;
+static uint8_t WaveSignalCount = 0;
+static uint16_t WavePortPins[WAVE_PORTS] = {0};
+
+/* Port outputs at the start, and the last ones stored */
+static uint16_t WaveInitial[WAVE_PORTS] = {0};
+static uint16_t WaveLast[WAVE_PORTS] = {0};
+
+/* Cycle counter at the start, HCLK to turn cycles into ns */
+static uint32_t WaveStart = 0;
+static uint32_t WaveClockHz = 0;
+
+/* TRUE between WAVE_enuStart and WAVE_vdStop */
+static volatile bool_t WaveRunning = FALSE;
+
+/* Cycles from the start to the record, the counter unwrapped record after record */
+static uint64_t localElapsed(uint32_t index, uint64_t *elapsed, uint32_t *previous);
+static uint64_t localToNs(uint64_t cycles);
+
+/* Appends text / a decimal number / the final newline to a line, returns the new length */
+static uint16_t localAppendText(uint8_t *line, uint16_t length, const char *text);
+static uint16_t localAppendNumber(uint8_t *line, uint16_t length, uint64_t number);
+static uint16_t localEndLine(uint8_t *line, uint16_t length);
+
+/*
+ * Function: WAVE_enuStart
+ * Description: Checks the signals, reads their present level and starts the capture
+ */
+WAVE_Status_t WAVE_enuStart(const WAVE_Signal_t *signals, uint8_t count){
+    WAVE_Status_t retStatus = WAVE_NOT_OK;
+    uint32_t primask;
+    uint8_t level;
+    uint8_t index;
+
+    if(NULL == signals){
+        retStatus = WAVE_NULL_PTR;
+    }else if((count == 0) || (count > WAVE_MAX_SIGNALS)){
+        retStatus = WAVE_WRONG_SIGNAL;
+    }else if(RCC_GetClockHz(RCC_AHB1_BUS, &WaveClockHz) != RCC_OK){
+        retStatus = WAVE_NOT_OK;
+    }else{
+        WaveRunning = FALSE;
+        retStatus = WAVE_OK;
+        for(index = 0; index < WAVE_PORTS; index++){
+            WavePortPins[index] = 0;
+            WaveInitial[index] = 0;
+        }
+        for(index = 0; (index < count) && (retStatus == WAVE_OK); index++){
+            if(GPIO_enuReadPinVal(signals[index].WAVE_Port, signals[index].WAVE_Pin, &level) != GPIO_OK){
+                retStatus = WAVE_WRONG_SIGNAL;
+            }else{
+                WavePortPins[signals[index].WAVE_Port] |= (uint16_t)(1U << signals[index].WAVE_Pin);
+                if(level != 0){
+                    WaveInitial[signals[index].WAVE_Port] |= (uint16_t)(1U << signals[index].WAVE_Pin);
+                }
+            }
+        }
+
+        if(retStatus == WAVE_OK){
+            DWT_vdStart();
+
+            __asm volatile ("MRS %0, primask" : "=r" (primask) :: "memory");
+            __asm volatile ("CPSID i" ::: "memory");
+
+            for(index = 0; index < WAVE_PORTS; index++){
+                WaveLast[index] = WaveInitial[index];
+            }
+            WaveSignals = signals;
+            WaveSignalCount = count;
+            WaveCount = 0;
+            WaveDropped = 0;
+            WaveStart = DWT_CYCCNT;
+            WaveRunning = TRUE;
+
+            __asm volatile ("MSR primask, %0" :: "r" (primask) : "memory");
+        }
+    }
+    return retStatus;
+}
+
+/*
+ * Function: WAVE_vdStop
+ * Description: Ends the capture
+ */
+void WAVE_vdStop(void){
+    WaveRunning = FALSE;
+}
+
+/*
+ * Function: WAVE_vdRecord
+ * Description: Stores the port output when a captured pin changed
+ * Note: Writes to pins not captured, or leaving the captured pins as they
+ *       were, cost the port check only
+ */
+RAMFUNC void WAVE_vdRecord(uint8_t port, uint16_t odr){
+    uint32_t primask;
+    uint16_t pins;
+
+    if((WaveRunning == TRUE) && (port < WAVE_PORTS)){
+        pins = WavePortPins[port];
+        if(((odr ^ WaveLast[port]) & pins) != 0){
+            __asm volatile ("MRS %0, primask" : "=r" (primask) :: "memory");
+            __asm volatile ("CPSID i" ::: "memory");
+
+            if(WaveCount < WAVE_BUFFER_LENGTH){
+                WaveBuffer[WaveCount].WAVE_Timestamp = DWT_CYCCNT;
+                WaveBuffer[WaveCount].WAVE_Port = port;
+                WaveBuffer[WaveCount].WAVE_Odr = odr & pins;
+                WaveLast[port] = odr & pins;
+                WaveCount++;
+            }else{
+                WaveDropped++;
+            }
+
+            __asm volatile ("MSR primask, %0" :: "r" (primask) : "memory");
+        }
+    }
+}
+
+/*
+ * Function: WAVE_enuMeasure
+ * Description: Walks the changes of the signal port and times its edges
+ */
+WAVE_Status_t WAVE_enuMeasure(uint8_t signalIndex, WAVE_Measure_t *measure){
+    WAVE_Status_t retStatus = WAVE_NOT_OK;
+    uint64_t elapsed = 0;
+    uint32_t previous = WaveStart;
+    uint64_t now;
+    uint64_t lastEdge = 0;
+    uint64_t lastRise = 0;
+    uint64_t lastFall = 0;
+    uint32_t width;
+    bool_t haveEdge = FALSE;
+    bool_t haveRise = FALSE;
+    uint16_t mask;
+    uint16_t level;
+    uint32_t index;
+    uint8_t port;
+
+    if(NULL == measure){
+        retStatus = WAVE_NULL_PTR;
+    }else if(NULL == WaveSignals){
+        retStatus = WAVE_NO_CAPTURE;
+    }else if(WaveRunning == TRUE){
+        retStatus = WAVE_RUNNING;
+    }else if(signalIndex >= WaveSignalCount){
+        retStatus = WAVE_WRONG_SIGNAL;
+    }else{
+        port = (uint8_t)WaveSignals[signalIndex].WAVE_Port;
+        mask = (uint16_t)(1U << WaveSignals[signalIndex].WAVE_Pin);
+        level = WaveInitial[port] & mask;
+
+        measure->WAVE_Edges = 0;
+        measure->WAVE_MinHighNs = WAVE_NO_PULSE;
+        measure->WAVE_MaxHighNs = 0;
+        measure->WAVE_MinLowNs = WAVE_NO_PULSE;
+        measure->WAVE_MaxLowNs = 0;
+        measure->WAVE_PeriodNs = 0;
+        measure->WAVE_HighNs = 0;
+
+        for(index = 0; index < WaveCount; index++){
+            now = localElapsed(index, &elapsed, &previous);
+            if((WaveBuffer[index].WAVE_Port != port) || ((WaveBuffer[index].WAVE_Odr & mask) == level)){
+                continue; // Another port, or another pin of this port changed
+            }
+            level = WaveBuffer[index].WAVE_Odr & mask;
+            measure->WAVE_Edges++;
+
+            if(haveEdge == TRUE){
+                // The pulse that just ended : high if this edge is falling
+                width = (uint32_t)localToNs(now - lastEdge);
+                if(level == 0){
+                    measure->WAVE_MinHighNs = (width < measure->WAVE_MinHighNs) ? width : measure->WAVE_MinHighNs;
+                    measure->WAVE_MaxHighNs = (width > measure->WAVE_MaxHighNs) ? width : measure->WAVE_MaxHighNs;
+                }else{
+                    measure->WAVE_MinLowNs = (width < measure->WAVE_MinLowNs) ? width : measure->WAVE_MinLowNs;
+                    measure->WAVE_MaxLowNs = (width > measure->WAVE_MaxLowNs) ? width : measure->WAVE_MaxLowNs;
+                }
+            }
+            if(level != 0){
+                if(haveRise == TRUE){
+                    measure->WAVE_PeriodNs = (uint32_t)localToNs(now - lastRise);
+                    measure->WAVE_HighNs = (uint32_t)localToNs(lastFall - lastRise);
+                }
+                lastRise = now;
+                haveRise = TRUE;
+            }else{
+                lastFall = now;
+            }
+            lastEdge = now;
+            haveEdge = TRUE;
+        }
+        retStatus = WAVE_OK;
+    }
+    return retStatus;
+}
+
+/*
+ * Function: WAVE_enuExportVcd
+ * Description: Header, initial values, then one time line per change
+ *
+ * Implementation notes:
+ * - Identifiers are '!' + signal index, printable for WAVE_MAX_SIGNALS up to 94
+ * - Changes landing on the same ns share one time line
+ */
+WAVE_Status_t WAVE_enuExportVcd(WAVE_Output_t output){
+    WAVE_Status_t retStatus = WAVE_NOT_OK;
+    uint8_t line[WAVE_LINE_SIZE];
+    char identifier[2] = {0, 0};
+    uint64_t elapsed = 0;
+    uint32_t previous = WaveStart;
+    uint64_t timeNs;
+    uint64_t lastTimeNs = 0;
+    uint16_t state[WAVE_PORTS];
+    uint16_t changed;
+    uint16_t length;
+    uint16_t mask;
+    uint32_t index;
+    uint8_t signal;
+    uint8_t port;
+
+    if(NULL == output){
+        retStatus = WAVE_NULL_PTR;
+    }else if(NULL == WaveSignals){
+        retStatus = WAVE_NO_CAPTURE;
+    }else if(WaveRunning == TRUE){
+        retStatus = WAVE_RUNNING;
+    }else{
+        length = localAppendText(line, 0, "$timescale 1 ns $end");
+        output(line, localEndLine(line, length));
+        if(WaveDropped != 0){
+            length = localAppendText(line, 0, "$comment ");
+            length = localAppendNumber(line, length, WaveDropped);
+            length = localAppendText(line, length, " changes dropped, buffer full $end");
+            output(line, localEndLine(line, length));
+        }
+        length = localAppendText(line, 0, "$scope module gpio $end");
+        output(line, localEndLine(line, length));
+        for(signal = 0; signal < WaveSignalCount; signal++){
+            identifier[0] = (char)('!' + signal);
+            length = localAppendText(line, 0, "$var wire 1 ");
+            length = localAppendText(line, length, identifier);
+            length = localAppendText(line, length, " ");
+            length = localAppendText(line, length, WaveSignals[signal].WAVE_Name);
+            length = localAppendText(line, length, " $end");
+            output(line, localEndLine(line, length));
+        }
+        length = localAppendText(line, 0, "$upscope $end");
+        output(line, localEndLine(line, length));
+        length = localAppendText(line, 0, "$enddefinitions $end");
+        output(line, localEndLine(line, length));
+
+        length = localAppendText(line, 0, "#0");
+        output(line, localEndLine(line, length));
+        for(signal = 0; signal < WaveSignalCount; signal++){
+            identifier[0] = (char)('!' + signal);
+            mask = (uint16_t)(1U << WaveSignals[signal].WAVE_Pin);
+            length = localAppendText(line, 0, ((WaveInitial[WaveSignals[signal].WAVE_Port] & mask) != 0) ? "1" : "0");
+            length = localAppendText(line, length, identifier);
+            output(line, localEndLine(line, length));
+        }
+
+        for(port = 0; port < WAVE_PORTS; port++){
+            state[port] = WaveInitial[port];
+        }
+        for(index = 0; index < WaveCount; index++){
+            timeNs = localToNs(localElapsed(index, &elapsed, &previous));
+            port = WaveBuffer[index].WAVE_Port;
+            changed = state[port] ^ WaveBuffer[index].WAVE_Odr;
+            state[port] = WaveBuffer[index].WAVE_Odr;
+
+            if(timeNs != lastTimeNs){
+                length = localAppendText(line, 0, "#");
+                length = localAppendNumber(line, length, timeNs);
+                output(line, localEndLine(line, length));
+                lastTimeNs = timeNs;
+            }
+            for(signal = 0; signal < WaveSignalCount; signal++){
+                mask = (uint16_t)(1U << WaveSignals[signal].WAVE_Pin);
+                if(((uint8_t)WaveSignals[signal].WAVE_Port == port) && ((changed & mask) != 0)){
+                    identifier[0] = (char)('!' + signal);
+                    length = localAppendText(line, 0, ((state[port] & mask) != 0) ? "1" : "0");
+                    length = localAppendText(line, length, identifier);
+                    output(line, localEndLine(line, length));
+                }
+            }
+        }
+        retStatus = WAVE_OK;
+    }
+    return retStatus;
+}
+
+static uint64_t localElapsed(uint32_t index, uint64_t *elapsed, uint32_t *previous){
+    // Records are in order and less than 2^32 cycles apart (~51 s at 84 MHz)
+    *elapsed += (uint32_t)(WaveBuffer[index].WAVE_Timestamp - *previous);
+    *previous = WaveBuffer[index].WAVE_Timestamp;
+    return *elapsed;
+}
+
+static uint64_t localToNs(uint64_t cycles){
+    return (WaveClockHz != 0) ? ((cycles * 1000000000ULL) / WaveClockHz) : 0;
+}
+
+static uint16_t localAppendText(uint8_t *line, uint16_t length, const char *text){
+    // One byte kept for the newline
+    while((*text != '\0') && (length < (WAVE_LINE_SIZE - 1U))){
+        line[length++] = (uint8_t)*text++;
+    }
+    return length;
+}
+
+static uint16_t localEndLine(uint8_t *line, uint16_t length){
+    line[length++] = '\n';
+    return length;
+}
+
+static uint16_t localAppendNumber(uint8_t *line, uint16_t length, uint64_t number){
+    char digits[21];
+    uint8_t index = sizeof(digits) - 1U;
+
+    digits[index] = '\0';
+    do{
+        digits[--index] = (char)('0' + (number % 10U));
+        number /= 10U;
+    }while(number != 0);
+
+    return localAppendText(line, length, &digits[index]);
+}
@@ -0,0 +1,103 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/bench.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "HAL/MCU_Driver/mcu.h"
+#include "MCAL/ADC_Driver/adc.h"
+
+#include "test.h"
+
+#define ADC_TEST_CHANNELS       (8U)
+#define ADC_TEST_RATE_HZ        (10000UL)
+#define ADC_TEST_BLOCK_LENGTH   (100U)      // 10 ms blocks
+#define ADC_TEST_MIN_BLOCKS     (95U)
+#define ADC_TEST_MAX_BLOCKS     (105U)
+#define ADC_TEST_MAX_LOAD       (50U)       // per mille
+#define ADC_TEST_VREFINT_MIN    (1300U)     // 1.05 V at 3.3 V
+#define ADC_TEST_VREFINT_MAX    (1700U)     // 1.37 V at 3.3 V
+
+static const uint8_t adcTestSequence[ADC_TEST_CHANNELS] = {0, 1, 2, 3, 4, 5, 6, 7};
+static uint16_t adcTestBuffer[2U * ADC_TEST_BLOCK_LENGTH * ADC_TEST_CHANNELS];
+
+/**
+ * PA0-PA7 sampled at 10 kHz per channel, 100-sequence blocks averaged.
+ * Tie the inputs to known voltages (ex: PA0 to GND, PA1 to 3V3, a divider on PA2)
+ * Read the results from the debugger once adcTestDone is set:
+ *   adcStatus          ADC_OK (1)
+ *   adcBlocks          ~100 (one second of blocks)
+ *   adcOverruns        0
+ *   adcAverages        mean of each channel over the last block (0-4095)
+ *   adcVrefint         raw VREFINT (~1500 at 3.3 V)
+ *   adcLoadPermille    CPU time taken by the DMA interrupts, from the idle
+ *                      loop count with and without sampling (~1 per mille expected)
+ * Passes when adcStatus is ADC_OK, there was no overrun, the block count and VREFINT
+ * are within the ADC_TEST_ bounds and the load is at most ADC_TEST_MAX_LOAD.
+ */
+volatile uint8_t adcTestDone = TEST_RUNNING;
+volatile ADC_Status_t adcStatus = ADC_NOT_OK;
+volatile uint32_t adcBlocks = 0;
+volatile uint32_t adcOverruns = 0;
+volatile uint16_t adcAverages[ADC_TEST_CHANNELS];
+volatile uint16_t adcVrefint = 0;
+volatile uint32_t adcLoadPermille = 0;
+
+static void adcTestBlockCallback(const uint16_t *block, const uint16_t *averages){
+    (void)block;
+    for (uint8_t i = 0; i < ADC_TEST_CHANNELS; i++) {
+        adcAverages[i] = averages[i];
+    }
+    adcBlocks++;
+}
+
+// Idle loop iterations during one second of HCLK cycles
+static uint32_t adcTestIdleLoops(uint32_t hclk){
+    uint32_t loops = 0;
+    uint32_t start = BENCH_u32Start();
+    while (BENCH_u32Stop(start) < hclk) {
+        loops++;
+    }
+    return loops;
+}
+
+void adcScanTest(void){
+    uint32_t hclk = 0;
+    uint32_t idleLoops = 0;
+    uint32_t busyLoops = 0;
+    uint16_t vrefint = 0;
+    ADC_Config_t config = {
+        .ADC_Sequence       = adcTestSequence,
+        .ADC_SequenceLength = ADC_TEST_CHANNELS,
+        .ADC_SampleTime     = ADC_SAMPLE_56_CYCLES,
+        .ADC_Resolution     = ADC_RESOLUTION_12_BIT,
+        .ADC_SampleRate_Hz  = ADC_TEST_RATE_HZ,
+        .ADC_Buffer         = adcTestBuffer,
+        .ADC_BlockLength    = ADC_TEST_BLOCK_LENGTH,
+        .ADC_Averaging      = ADC_AVERAGING_ENABLED,
+        .ADC_BlockCallback  = adcTestBlockCallback
+    };
+
+    hclk = TEST_u32Setup();
+
+    adcStatus = ADC_enuInit(&config);
+    if (adcStatus == ADC_OK) {
+        adcStatus = ADC_enuReadChannel(ADC_CHANNEL_VREFINT, &vrefint);
+        adcVrefint = vrefint;
+    }
+    if (adcStatus == ADC_OK) {
+        idleLoops = adcTestIdleLoops(hclk);
+        adcStatus = ADC_enuStart();
+    }
+    if (adcStatus == ADC_OK) {
+        busyLoops = adcTestIdleLoops(hclk);
+        adcStatus = ADC_enuStop();
+        ADC_enuGetOverruns((uint32_t*)&adcOverruns);
+    }
+    if ((idleLoops != 0) && (busyLoops <= idleLoops)) {
+        adcLoadPermille = (uint32_t)(((uint64_t)(idleLoops - busyLoops) * 1000U) / idleLoops);
+    }
+
+    TEST_vdDone(&adcTestDone, ((adcStatus == ADC_OK) && (adcOverruns == 0U)
+                               && (adcBlocks >= ADC_TEST_MIN_BLOCKS) && (adcBlocks <= ADC_TEST_MAX_BLOCKS)
+                               && (adcVrefint >= ADC_TEST_VREFINT_MIN) && (adcVrefint <= ADC_TEST_VREFINT_MAX)
+                               && (busyLoops <= idleLoops) && (adcLoadPermille <= ADC_TEST_MAX_LOAD)) ? TRUE : FALSE);
+}
@@ -30,7 +30,7 @@ void AsynchLcdTest()
 {
     MCU_Status_t mcuStatus = MCU_enuInit(NULL);
 
-    SCHED_enuInit(1,16000000UL);
+    SCHED_enuInit(1,SCHED_CLOCK_AUTO);
 
     LCD_Status_t lcdStat = LCD_enuAsynInit();
 
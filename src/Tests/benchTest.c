@@ -0,0 +1,201 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/bench.h"
+#include "MCAL/GPIO_Driver/gpio_int.h"
+#include "MCAL/UART_Driver/uart.h"
+#include "MCAL/SPI_Driver/spi.h"
+#include "MCAL/DMA_Driver/dma.h"
+#include "HAL/LCD_Driver/lcd.h"
+#include "HAL/HSERIAL_Driver/hserial.h"
+#include "OS/schedule.h"
+
+#include "test.h"
+
+// SCB ICSR : PENDSTSET pends SysTick from software
+#define BENCH_TEST_SCB_ICSR         (*(volatile uint32_t *)0xE000ED04UL)
+#define BENCH_TEST_ICSR_PENDSTSET   (0x04000000UL)
+
+#define BENCH_TEST_DMA_WORDS        (16U)
+#define BENCH_TEST_REPORT_SIZE      (1024U)
+
+/**
+ * Driver hot paths through the BENCH harness, results in cycles at 84 MHz:
+ *   gpio_set_pin      GPIO_enuSetPinVal on PC13
+ *   lcd_write_char    LCD_enuSyncWriteCharacter (LCD on PA0..PA10, enable pulse
+ *                     and busy delay included)
+ *   sched_tick        pended SysTick : SysTick_Handler + SCHED_vdExec, entry and return
+ *   uart_tx_byte      UART_enuSynTransmitBuffer of 1 byte on USART6 at 2 Mbaud
+ *                     (the shift register is free again after 5 us)
+ *   spi_transfer      SPI_enuMasterSyncTransmitReceive of 1 byte on SPI2, fPCLK/2
+ *   dma_m2m_64        64-byte memory to memory transfer on DMA2 stream 1, start to TC
+ * benchReport holds the CSV report (benchReportLength bytes) once benchTestDone is set,
+ * it is also sent on HSERIAL_CHANNEL_1 (PA9 is given back to USART1 after the LCD case).
+ * Passes when every case ran (BENCH_OK) and the whole report, newline ended, fit in benchReport.
+ */
+volatile uint8_t benchTestDone = 0;
+volatile BENCH_Status_t benchStatus = BENCH_NOT_OK;
+uint8_t benchReport[BENCH_TEST_REPORT_SIZE];
+volatile uint16_t benchReportLength = 0;
+
+static uint32_t benchDmaSource[BENCH_TEST_DMA_WORDS];
+static uint32_t benchDmaDestination[BENCH_TEST_DMA_WORDS];
+static const uint8_t benchUartByte = 0x55;
+
+static void benchTestOutput(const uint8_t *line, uint16_t length){
+    for (uint16_t i = 0; (i < length) && (benchReportLength < BENCH_TEST_REPORT_SIZE); i++) {
+        benchReport[benchReportLength++] = line[i];
+    }
+}
+
+static void benchGpioSetup(void *args){
+    GPIO_cfg_t pin = {
+        .port = GPIO_PORT_C,
+        .pin = GPIO_PIN_13,
+        .mode = GPIO_MODE_OUTPUT,
+        .outputType = GPIO_OUTPUT_TYPE_PUSH_PULL,
+        .speed = GPIO_SPEED_HIGH,
+        .pull = GPIO_NO_PULL,
+        .alternateFunction = GPIO_AF0
+    };
+    (void)args;
+    (void)GPIO_enuInit(&pin);
+}
+
+static void benchGpioBody(void *args){
+    (void)args;
+    (void)GPIO_enuSetPinVal(GPIO_PORT_C, GPIO_PIN_13, GPIO_HIGH);
+}
+
+static void benchLcdSetup(void *args){
+    (void)args;
+    (void)LCD_enuSynInit();
+}
+
+static void benchLcdBody(void *args){
+    (void)args;
+    (void)LCD_enuSyncWriteCharacter('A');
+}
+
+static void benchTickSetup(void *args){
+    (void)args;
+    // Registers SCHED_vdExec as the SysTick callback, SysTick itself is not started
+    (void)SCHED_enuInit(1, SCHED_CLOCK_AUTO);
+}
+
+static void benchTickBody(void *args){
+    (void)args;
+    BENCH_TEST_SCB_ICSR = BENCH_TEST_ICSR_PENDSTSET;
+    __asm volatile ("dsb\n isb" ::: "memory");
+}
+
+static void benchUartSetup(void *args){
+    UART_Config_t uartConfig;
+
+    (void)args;
+    uartConfig.UART_Number = UART_6;
+    uartConfig.UartEnabled = UART_ENABLE_TRANSMITE;
+    uartConfig.Parity = UART_PARITY_NONE;
+    uartConfig.OverSampling = UART_OVERSAMPLING_8;
+    uartConfig.StopBits = UART_STOPBITS_1;
+    uartConfig.WordLength = UART_WORDLENGTH_8B;
+    uartConfig.Sample = UART_THREE_SAMPLE;
+    uartConfig.InterruptFlags = 0;
+    uartConfig.PeripheralClock = UART_PERIPHERAL_CLOCK_AUTO;
+    uartConfig.BaudRate = 2000000UL;
+    (void)UART_enuInit(&uartConfig);
+}
+
+static void benchUartBody(void *args){
+    (void)args;
+    (void)UART_enuSynTransmitBuffer(UART_6, &benchUartByte, 1);
+}
+
+static void benchSpiSetup(void *args){
+    SPI_Config_t spiConfig;
+
+    (void)args;
+    spiConfig.spiNumber         = SPI2;
+    spiConfig.communicationMode = SPI_FULL_DUPLEX;
+    spiConfig.mode              = SPI_MASTER;
+    spiConfig.crcState          = SPI_CRC_DISABLED;
+    spiConfig.dataLength        = SPI_8_BIT_DATA;
+    spiConfig.dataOrder         = SPI_MSB_FIRST;
+    spiConfig.baudRate          = SPI_BAUDRATE_DIV2;
+    spiConfig.polarityPhase     = SPI_ONE_IDLE_FIRST_EDGE;
+    spiConfig.frameFormat       = SPI_MOTOROLA;
+    spiConfig.dmaState          = SPI_DISABLE_DMA;
+    spiConfig.nssManagement     = SPI_NSS_MASTER_SW;
+    spiConfig.slavesConfig.numberOfSlaves = 0;
+    (void)SPI_enuInit(&spiConfig);
+}
+
+static void benchSpiBody(void *args){
+    uint16_t rxData;
+
+    (void)args;
+    (void)SPI_enuMasterSyncTransmitReceive(SPI2, 0xA5, &rxData);
+}
+
+static void benchDmaSetup(void *args){
+    DMA_Config_t dmaConfig;
+
+    (void)args;
+    dmaConfig.DMAx               = DMA2;
+    dmaConfig.Streamx            = DMA_STREAM1;
+    dmaConfig.Channel            = DMA_CHANNEL0;
+    dmaConfig.MBurst             = DMA_MBurst_INCR4;
+    dmaConfig.PBurst             = DMA_PBurst_INCR4;
+    dmaConfig.DoubleBuffer       = DMA_DISABLE_DOUBLE_BUFFER;
+    dmaConfig.Priority           = DMA_PRIORITY_VERY_HIGH;
+    dmaConfig.MSize              = DMA_MSIZE_WORD;
+    dmaConfig.PSize              = DMA_PSIZE_WORD;
+    dmaConfig.MemoryInc          = DMA_MINC_AUTO_INCREMENT;
+    dmaConfig.PeripheralInc      = DMA_PINC_AUTO_INCREMENT;
+    dmaConfig.CircularMode       = DMA_CIRCULAR_MODE_DISABLE;
+    dmaConfig.Direction          = DMA_DIRECTION_M2M;
+    dmaConfig.PeripheralFlowCtrl = DMA_FLOW_CONTROL_USING_DMA;
+    dmaConfig.Mode               = DMA_MODE_FIFO;       // Direct mode is not allowed memory to memory
+    dmaConfig.FifoThreshold      = DMA_FIFO_THRESHOLD_FULL;
+    dmaConfig.NumberOfData       = BENCH_TEST_DMA_WORDS;
+    dmaConfig.PeripheralAddress  = (uint32_t)benchDmaSource;
+    dmaConfig.Memory0Address     = (uint32_t)benchDmaDestination;
+    dmaConfig.Memory1Address     = 0;
+    dmaConfig.Interrupts         = 0;
+    (void)DMA_enuInit(&dmaConfig);
+}
+
+static void benchDmaBody(void *args){
+    (void)args;
+    (void)DMA_enuSetNumberOfData(DMA2, DMA_STREAM1, BENCH_TEST_DMA_WORDS);
+    (void)DMA_enuStartTransfer(DMA2, DMA_STREAM1);
+    while (DMA_u8ReadFlag(DMA2, DMA_STREAM1, DMA_INTERRUPT_TRANSMISSION_COMPLETE) == 0);
+    (void)DMA_enuClearFlag(DMA2, DMA_STREAM1, DMA_INTERRUPT_TRANSMISSION_COMPLETE);
+}
+
+static BENCH_CASE(gpio_set_pin, benchGpioBody, benchGpioSetup, NULL, 16, 256);
+static BENCH_CASE(lcd_write_char, benchLcdBody, benchLcdSetup, NULL, 4, 64);
+static BENCH_CASE(sched_tick, benchTickBody, benchTickSetup, NULL, 16, 256);
+static BENCH_CASE(uart_tx_byte, benchUartBody, benchUartSetup, NULL, 4, 128);
+static BENCH_CASE(spi_transfer, benchSpiBody, benchSpiSetup, NULL, 16, 256);
+static BENCH_CASE(dma_m2m_64, benchDmaBody, benchDmaSetup, NULL, 4, 128);
+
+static const BENCH_Case_t *const benchCases[] = {
+    &gpio_set_pin,
+    &lcd_write_char,
+    &sched_tick,
+    &uart_tx_byte,
+    &spi_transfer,
+    &dma_m2m_64
+};
+
+void driverBenchmarkTest(void){
+    (void)TEST_u32Setup();
+
+    benchStatus = BENCH_enuRunAll(benchCases, sizeof(benchCases) / sizeof(benchCases[0]), benchTestOutput);
+
+    (void)HSERIAL_enuInit();
+    (void)HSERIAL_enuTransmitBuffer(HSERIAL_CHANNEL_1, benchReport, benchReportLength);
+    TEST_vdDone(&benchTestDone, ((benchStatus == BENCH_OK) && (benchReportLength > 0U)
+                                 && (benchReportLength < BENCH_TEST_REPORT_SIZE)
+                                 && (benchReport[benchReportLength - 1U] == '\n')) ? TRUE : FALSE);
+}
@@ -0,0 +1,170 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/bits.h"
+#include "LIB/bench.h"
+
+#include "test.h"
+
+#define BITS_TEST_WORDS             (64U)
+
+typedef enum {
+    BITS_TEST_CLZ,
+    BITS_TEST_CTZ,
+    BITS_TEST_RBIT,
+    BITS_TEST_REV,
+    BITS_TEST_REV16,
+    BITS_TEST_POPCOUNT,
+    BITS_TEST_ADD_SAT,              /* Unsigned and signed, against 64-bit sums */
+    BITS_TEST_CASES
+}BITS_TestCase_t;
+
+typedef struct {
+    uint32_t LoopCycles;            /* Bit-by-bit reference loop over the words */
+    uint32_t BitsCycles;            /* bits.h helper over the same words */
+    uint8_t  Match;                 /* 1 when both gave the same result for every word */
+}BITS_TestResult_t;
+
+/**
+ * Every bits.h helper against a bit-by-bit reference over 64 words
+ * (0, all ones, single bits, a pseudo-random tail):
+ *   bitsResults[case]   BITS_TestResult_t in BITS_TestCase_t order
+ * Match must be 1 for every case, LoopCycles / BitsCycles is the gain.
+ * Passes when every case matches and no helper is slower than its loop.
+ * Build with -DBITS_PORTABLE for the host path on target.
+ */
+volatile uint8_t bitsTestDone = 0;
+BITS_TestResult_t bitsResults[BITS_TEST_CASES];
+
+static uint32_t bitsTestWords[BITS_TEST_WORDS];
+static uint32_t bitsTestRef[BITS_TEST_WORDS];
+static uint32_t bitsTestOut[BITS_TEST_WORDS];
+
+static uint32_t bitsTestReference(BITS_TestCase_t testCase, uint32_t value, uint32_t other){
+    uint32_t result = 0;
+    uint8_t bit;
+
+    switch (testCase) {
+    case BITS_TEST_CLZ:
+        for (bit = 32; (bit > 0U) && (0U == (value & (1UL << (bit - 1U)))); bit--) {
+            result++;
+        }
+        break;
+    case BITS_TEST_CTZ:
+        for (bit = 0; (bit < 32U) && (0U == (value & (1UL << bit))); bit++) {
+            result++;
+        }
+        break;
+    case BITS_TEST_RBIT:
+        for (bit = 0; bit < 32U; bit++) {
+            result |= ((value >> bit) & 1UL) << (31U - bit);
+        }
+        break;
+    case BITS_TEST_REV:
+        for (bit = 0; bit < 32U; bit += 8U) {
+            result |= ((value >> bit) & 0xFFUL) << (24U - bit);
+        }
+        break;
+    case BITS_TEST_REV16:
+        result = ((value & 0x00FF00FFUL) << 8) | ((value >> 8) & 0x00FF00FFUL);
+        break;
+    case BITS_TEST_POPCOUNT:
+        for (bit = 0; bit < 32U; bit++) {
+            result += (value >> bit) & 1UL;
+        }
+        break;
+    case BITS_TEST_ADD_SAT: {
+        uint64_t usum = (uint64_t)value + other;
+        sint64_t ssum = (sint64_t)(sint32_t)value + (sint32_t)other;
+        if (usum > 0xFFFFFFFFULL) {
+            usum = 0xFFFFFFFFULL;
+        }
+        if (ssum > 2147483647LL) {
+            ssum = 2147483647LL;
+        } else if (ssum < (-2147483647LL - 1LL)) {
+            ssum = -2147483647LL - 1LL;
+        } else {
+            // in range
+        }
+        result = (uint32_t)usum ^ (uint32_t)(sint32_t)ssum;
+        break;
+    }
+    default:
+        break;
+    }
+    return result;
+}
+
+static uint32_t bitsTestHelper(BITS_TestCase_t testCase, uint32_t value, uint32_t other){
+    uint32_t result = 0;
+
+    switch (testCase) {
+    case BITS_TEST_CLZ:      result = BITS_u32Clz(value); break;
+    case BITS_TEST_CTZ:      result = BITS_u32Ctz(value); break;
+    case BITS_TEST_RBIT:     result = BITS_u32Rbit(value); break;
+    case BITS_TEST_REV:      result = BITS_u32Rev(value); break;
+    case BITS_TEST_REV16:    result = BITS_u32Rev16(value); break;
+    case BITS_TEST_POPCOUNT: result = BITS_u32Popcount(value); break;
+    case BITS_TEST_ADD_SAT:
+        result = BITS_u32AddSat(value, other) ^ (uint32_t)BITS_s32AddSat((sint32_t)value, (sint32_t)other);
+        break;
+    default:
+        break;
+    }
+    return result;
+}
+
+static bool_t bitsTestPassed(void){
+    bool_t passed = TRUE;
+
+    for (uint8_t i = 0; i < BITS_TEST_CASES; i++) {
+        if ((bitsResults[i].Match != 1U) || (bitsResults[i].BitsCycles > bitsResults[i].LoopCycles)) {
+            passed = FALSE;
+        }
+    }
+    return passed;
+}
+
+void bitsTest(void){
+    uint32_t start;
+    uint32_t seed = 0x12345678UL;
+    uint8_t i;
+
+    (void)BENCH_enuInit();
+
+    // 0, all ones, the 32 single bits, then xorshift words
+    bitsTestWords[0] = 0UL;
+    bitsTestWords[1] = 0xFFFFFFFFUL;
+    for (i = 2; i < BITS_TEST_WORDS; i++) {
+        if (i < 34U) {
+            bitsTestWords[i] = 1UL << (i - 2U);
+        } else {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            bitsTestWords[i] = seed;
+        }
+    }
+
+    for (uint8_t testCase = 0; testCase < BITS_TEST_CASES; testCase++) {
+        start = BENCH_u32Start();
+        for (i = 0; i < BITS_TEST_WORDS; i++) {
+            bitsTestRef[i] = bitsTestReference((BITS_TestCase_t)testCase, bitsTestWords[i], bitsTestWords[BITS_TEST_WORDS - 1U - i]);
+        }
+        bitsResults[testCase].LoopCycles = BENCH_u32Stop(start);
+
+        start = BENCH_u32Start();
+        for (i = 0; i < BITS_TEST_WORDS; i++) {
+            bitsTestOut[i] = bitsTestHelper((BITS_TestCase_t)testCase, bitsTestWords[i], bitsTestWords[BITS_TEST_WORDS - 1U - i]);
+        }
+        bitsResults[testCase].BitsCycles = BENCH_u32Stop(start);
+
+        bitsResults[testCase].Match = 1;
+        for (i = 0; i < BITS_TEST_WORDS; i++) {
+            if (bitsTestOut[i] != bitsTestRef[i]) {
+                bitsResults[testCase].Match = 0;
+            }
+        }
+    }
+
+    TEST_vdDone(&bitsTestDone, bitsTestPassed());
+}
@@ -0,0 +1,130 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/bench.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "MCAL/GPIO_Driver/gpio_int.h"
+#include "HAL/BOARD_Driver/board_cfg.h"
+#include "HAL/BOARD_Driver/board.h"
+
+#include "test.h"
+
+// Ports A, B and C hold the fitted pins (LCD, LEDs, switch, USART6)
+#define BOARD_TEST_REG(address)     (*(volatile uint32_t *)(address))
+#define BOARD_TEST_GPIO(port)       (0x40020000UL + ((uint32_t)(port) * 0x400UL))
+#define BOARD_TEST_PORTS            (3U)
+#define BOARD_TEST_ODR              (0x14UL)
+
+typedef enum {
+    BOARD_TEST_BOOT,                /* Fitted pins : one GPIO_enuInit per pin / BOARD_enuInit */
+    BOARD_TEST_LCD_NIBBLE,          /* 16 nibbles on DB4-DB7 : 4 GPIO_enuSetPinVal / 1 BSRR write */
+    BOARD_TEST_CASES
+}BOARD_TestCase_t;
+
+typedef struct {
+    uint32_t RuntimeCycles;         /* Per-pin driver calls */
+    uint32_t BoardCycles;           /* Folded board image / table */
+    uint8_t  Match;                 /* 1 when both left the same register values */
+}BOARD_TestResult_t;
+
+// The same fitted pins as GPIO_cfg_t, for the per-pin path
+#define BOARD_TEST_X_CFG(ctx, name, gpioPort, gpioPin, gpioMode, gpioType, gpioSpeed, gpioPull, gpioAf) \
+    { .port = (gpioPort), .pin = (gpioPin), .mode = (gpioMode), .outputType = (gpioType), \
+      .speed = (gpioSpeed), .pull = (gpioPull), .alternateFunction = (gpioAf) },
+
+static const GPIO_cfg_t boardTestPins[] = {
+    BOARD_FITTED_PINS(BOARD_TEST_X_CFG, 0)
+};
+
+static const uint32_t boardTestNibble[16] = BOARD_NIBBLE_TABLE(BOARD_LCD_DB4_PIN, BOARD_LCD_DB5_PIN, BOARD_LCD_DB6_PIN, BOARD_LCD_DB7_PIN);
+
+static const GPIO_Val_t boardTestLevel[2] = { GPIO_LOW, GPIO_HIGH };
+
+/**
+ * The fitted pins of board_cfg.h set up twice more after the boot already
+ * applied them (MCU_enuInit, GPIO clocks from BOARD_AHB1_CLOCKS), then the
+ * LCD data nibble written both ways:
+ *   boardResults[case]   BOARD_TestResult_t in BOARD_TestCase_t order
+ * Match must be 1 for both cases, RuntimeCycles / BoardCycles is the gain.
+ * Passes when both cases match and the board path is the faster one.
+ * Adding BOARD_SEVSEG_PINS to BOARD_FITTED_PINS (PA0..PA6 taken by the LCD)
+ * must stop the build.
+ */
+volatile uint8_t boardTestDone = 0;
+BOARD_TestResult_t boardResults[BOARD_TEST_CASES];
+
+static uint32_t boardTestRegs[BOARD_TEST_PORTS][6];
+
+static uint8_t boardTestPorts(uint8_t save){
+    // MODER, OTYPER, OSPEEDR, PUPDR, AFRL, AFRH
+    static const uint8_t gpioRegs[6] = {0x00, 0x04, 0x08, 0x0C, 0x20, 0x24};
+    uint8_t match = 1;
+
+    for (uint8_t port = 0; port < BOARD_TEST_PORTS; port++) {
+        for (uint8_t i = 0; i < 6U; i++) {
+            uint32_t value = BOARD_TEST_REG(BOARD_TEST_GPIO(port) + gpioRegs[i]);
+            if (save != 0U) {
+                boardTestRegs[port][i] = value;
+            } else if (value != boardTestRegs[port][i]) {
+                match = 0;
+            } else {
+                // same value
+            }
+        }
+    }
+    return match;
+}
+
+static bool_t boardTestPassed(void){
+    bool_t passed = TRUE;
+
+    for (uint8_t i = 0; i < BOARD_TEST_CASES; i++) {
+        if ((boardResults[i].Match != 1U) || (boardResults[i].BoardCycles >= boardResults[i].RuntimeCycles)) {
+            passed = FALSE;
+        }
+    }
+    return passed;
+}
+
+void boardTest(void){
+    GPIO_cfg_t pinConfig;
+    uint32_t start;
+    uint32_t nibbleOdr[16];
+
+    (void)TEST_u32Setup();
+
+    // Boot : every fitted pin through GPIO_enuInit, then the folded port images
+    start = BENCH_u32Start();
+    for (uint8_t i = 0; i < (sizeof(boardTestPins) / sizeof(boardTestPins[0])); i++) {
+        pinConfig = boardTestPins[i];
+        (void)GPIO_enuInit(&pinConfig);
+    }
+    boardResults[BOARD_TEST_BOOT].RuntimeCycles = BENCH_u32Stop(start);
+    (void)boardTestPorts(1);
+    start = BENCH_u32Start();
+    (void)BOARD_enuInit();
+    boardResults[BOARD_TEST_BOOT].BoardCycles = BENCH_u32Stop(start);
+    boardResults[BOARD_TEST_BOOT].Match = boardTestPorts(0);
+
+    // LCD data nibble : one call per line, then one precomputed BSRR word
+    start = BENCH_u32Start();
+    for (uint8_t value = 0; value < 16U; value++) {
+        (void)GPIO_enuSetPinVal((GPIO_Port_t)BOARD_LCD_DB4_PORT, (GPIO_Pin_t)BOARD_LCD_DB4_PIN, boardTestLevel[value & 1U]);
+        (void)GPIO_enuSetPinVal((GPIO_Port_t)BOARD_LCD_DB5_PORT, (GPIO_Pin_t)BOARD_LCD_DB5_PIN, boardTestLevel[(value >> 1) & 1U]);
+        (void)GPIO_enuSetPinVal((GPIO_Port_t)BOARD_LCD_DB6_PORT, (GPIO_Pin_t)BOARD_LCD_DB6_PIN, boardTestLevel[(value >> 2) & 1U]);
+        (void)GPIO_enuSetPinVal((GPIO_Port_t)BOARD_LCD_DB7_PORT, (GPIO_Pin_t)BOARD_LCD_DB7_PIN, boardTestLevel[(value >> 3) & 1U]);
+        nibbleOdr[value] = BOARD_TEST_REG(BOARD_TEST_GPIO(BOARD_LCD_DB4_PORT) + BOARD_TEST_ODR);
+    }
+    boardResults[BOARD_TEST_LCD_NIBBLE].RuntimeCycles = BENCH_u32Stop(start);
+
+    boardResults[BOARD_TEST_LCD_NIBBLE].Match = 1;
+    start = BENCH_u32Start();
+    for (uint8_t value = 0; value < 16U; value++) {
+        (void)GPIO_enuSetResetPins((GPIO_Port_t)BOARD_LCD_DB4_PORT, boardTestNibble[value]);
+        if (BOARD_TEST_REG(BOARD_TEST_GPIO(BOARD_LCD_DB4_PORT) + BOARD_TEST_ODR) != nibbleOdr[value]) {
+            boardResults[BOARD_TEST_LCD_NIBBLE].Match = 0;
+        }
+    }
+    boardResults[BOARD_TEST_LCD_NIBBLE].BoardCycles = BENCH_u32Stop(start);
+
+    TEST_vdDone(&boardTestDone, boardTestPassed());
+}
@@ -0,0 +1,64 @@
+
+#include "LIB/stdtypes.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "HAL/MCU_Driver/mcu.h"
+#include "HAL/LED_Driver/led.h"
+#include "HAL/LCD_Driver/lcd.h"
+#include "OS/schedule.h"
+
+#include "test.h"
+
+/**
+ * Fast-start boot: LED and LCD pins are set up while the PLL locks, the LCD
+ * power-on wait runs in the scheduler instead of blocking main.
+ * Read the report from the debugger once bootTestDone is set:
+ *   bootReport[0 .. bootPhaseCount-1]  name, cycles and us of every phase
+ *   bootTotalUs                        reset of CYCCNT -> LCD ready
+ * Set MCU_BOOT_PROFILER to MCU_BOOT_PROFILER_ENABLED (mcu_cfg.h) to also get
+ * the phases marked inside the MCU driver.
+ * Passes when the fast start reached MCU_OK and the report holds the 4 phases
+ * marked here (or more) with a non-zero total.
+ */
+#define BOOT_TEST_MIN_PHASES    (4U)
+
+volatile uint8_t bootTestDone = TEST_RUNNING;
+const MCU_BootPhase_t* bootReport = NULL;
+uint8_t bootPhaseCount = 0;
+uint32_t bootTotalUs = 0;
+static MCU_Status_t bootMcuStatus = MCU_BOOT_PENDING;
+
+static void bootLcdReady(LCD_Status_t status){
+    if(status == LCD_INIT_SUCEESSFULLY){
+        MCU_enuBootMark("LCD power-on + init");
+        MCU_enuGetBootReport(&bootReport, &bootPhaseCount, &bootTotalUs);
+        TEST_vdDone(&bootTestDone, ((bootMcuStatus == MCU_OK) && (bootPhaseCount >= BOOT_TEST_MIN_PHASES)
+                                    && (bootTotalUs > 0U)) ? TRUE : FALSE);
+    }
+}
+
+void fastBootTest(void){
+    MCU_vdBootProfilerStart();
+
+    // PLL is configured and started, CPU keeps running from HSI
+    MCU_enuFastStartInit(NULL);
+
+    // Independent of the clock tree, done while the PLL locks
+    LED_vdInit();
+    MCU_enuBootMark("LED init");
+    bootMcuStatus = MCU_enuPollInit();
+
+    LCD_vdAsyncRegisterCallback(bootLcdReady);
+    LCD_enuAsynInit();
+    MCU_enuBootMark("LCD pins + runnable");
+
+    // Whatever is left of the lock time
+    while(bootMcuStatus == MCU_BOOT_PENDING){
+        bootMcuStatus = MCU_enuPollInit();
+    }
+
+    // SysTick needs the final HCLK
+    SCHED_enuInit(1, SCHED_CLOCK_AUTO);
+    MCU_enuBootMark("Scheduler init");
+
+    SCHED_enuStart();
+}
@@ -0,0 +1,220 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/bench.h"
+#include "MCAL/GPIO_Driver/gpio_int.h"
+#include "MCAL/UART_Driver/uart.h"
+#include "MCAL/SPI_Driver/spi.h"
+#include "MCAL/DMA_Driver/dma.h"
+
+#include "test.h"
+
+// Registers read back after each init
+#define IMAGE_TEST_REG(address)     (*(volatile uint32_t *)(address))
+#define IMAGE_TEST_GPIOB            (0x40020400UL)
+#define IMAGE_TEST_USART6           (0x40011400UL)
+#define IMAGE_TEST_SPI1             (0x40013000UL)
+#define IMAGE_TEST_DMA2_S6          (0x400264A0UL)
+#define IMAGE_TEST_DMA_SFCR_CONFIG  (0x87UL)        // FEIE, DMDIS, FTH : FS is the FIFO level
+
+// APB2 clock with MCU_Configs (HSI 16 MHz, no prescaler), BRR of the UART image is built for it
+#define IMAGE_TEST_APB2_HZ          (16000000UL)
+#define IMAGE_TEST_SRAM             (0x20000000UL)  // Memory address, DMA_enuSetMemoryAddress before a transfer
+
+typedef enum {
+    IMAGE_TEST_GPIO,                /* PB0, PB1 outputs : 2 x GPIO_enuInit / 1 GPIO_enuApplyImage */
+    IMAGE_TEST_UART,                /* USART6 115200 8N1, TX and RX pins */
+    IMAGE_TEST_SPI,                 /* SPI1 master full duplex, software NSS */
+    IMAGE_TEST_DMA,                 /* DMA2 stream 6 channel 5 (USART6 TX) */
+    IMAGE_TEST_CASES
+}IMAGE_TestCase_t;
+
+typedef struct {
+    uint32_t RuntimeCycles;         /* Init with the runtime checks (XXX_enuInit) */
+    uint32_t ImageCycles;           /* Init storing the build-time image (XXX_enuInitImage) */
+    uint8_t  Match;                 /* 1 when both left the same register values */
+}IMAGE_TestResult_t;
+
+#define IMAGE_TEST_LED_PINS(PIN) \
+    PIN(GPIO_PIN_0, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_NO_PULL, GPIO_AF0) \
+    PIN(GPIO_PIN_1, GPIO_MODE_OUTPUT, GPIO_OUTPUT_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_NO_PULL, GPIO_AF0)
+
+static GPIO_IMAGE_DECLARE(imageTestLeds, GPIO_PORT_B, IMAGE_TEST_LED_PINS);
+
+static UART_IMAGE_DECLARE(imageTestUart, UART_6, IMAGE_TEST_APB2_HZ, 115200UL, UART_PARITY_NONE,
+                          UART_OVERSAMPLING_16, UART_STOPBITS_1, UART_WORDLENGTH_8B, UART_THREE_SAMPLE,
+                          UART_ENABLE_TRANSMITE | UART_ENABLE_RECEIVE, 0);
+
+static SPI_IMAGE_DECLARE(imageTestSpi, SPI1, SPI_FULL_DUPLEX, SPI_MASTER, SPI_CRC_DISABLED, SPI_8_BIT_DATA,
+                         SPI_MSB_FIRST, SPI_BAUDRATE_DIV16, SPI_ZERO_IDLE_FIRST_EDGE, SPI_MOTOROLA,
+                         SPI_DISABLE_DMA, SPI_NSS_MASTER_SW, 7);
+
+static DMA_IMAGE_DECLARE(imageTestDma, DMA2, DMA_STREAM6, DMA_CHANNEL5, DMA_DIRECTION_M2P,
+                         DMA_FLOW_CONTROL_USING_DMA, DMA_MODE_FIFO, DMA_PRIORITY_HIGH, DMA_MSIZE_BYTE,
+                         DMA_PSIZE_BYTE, DMA_MINC_AUTO_INCREMENT, DMA_PINC_FIXED, DMA_CIRCULAR_MODE_DISABLE,
+                         DMA_MBurst_SINGLE, DMA_PBurst_SINGLE, DMA_DISABLE_DOUBLE_BUFFER, DMA_FIFO_THRESHOLD_FULL,
+                         IMAGE_TEST_USART6 + 0x04UL, IMAGE_TEST_SRAM, 0,
+                         DMA_INTERRUPT_TRANSFER_COMPLETE_ENABLE | DMA_INTERRUPT_TRANSFER_ERROR_ENABLE, 64);
+
+/**
+ * Each driver initialized twice with the same configuration, first from a
+ * config struct checked at run time, then from the image declared above and
+ * checked at build time (MCU_Configs clocks):
+ *   imageResults[case]   IMAGE_TestResult_t in IMAGE_TestCase_t order
+ * RuntimeCycles / ImageCycles is the gain of dropping the runtime checks and
+ * the per-field read-modify-writes, Match must be 1 for every case.
+ * Passes when every case matches and its image init is the faster one.
+ * Breaking a field of an image above (a PSIZE of 3, a 921600 baud UART on the
+ * 16 MHz APB2 (2.1 % off), a master SPI with SPI_NSS_SLAVE_SW) must stop the build.
+ */
+volatile uint8_t imageTestDone = 0;
+IMAGE_TestResult_t imageResults[IMAGE_TEST_CASES];
+
+static uint32_t imageTestRegs[6];
+
+static void imageTestSave(uint32_t base, const uint8_t *offsets, uint8_t count, uint32_t mask){
+    for (uint8_t i = 0; i < count; i++) {
+        imageTestRegs[i] = IMAGE_TEST_REG(base + offsets[i]) & ((i == (count - 1U)) ? mask : 0xFFFFFFFFUL);
+    }
+}
+
+static uint8_t imageTestCompare(uint32_t base, const uint8_t *offsets, uint8_t count, uint32_t mask){
+    uint8_t match = 1;
+
+    for (uint8_t i = 0; i < count; i++) {
+        if ((IMAGE_TEST_REG(base + offsets[i]) & ((i == (count - 1U)) ? mask : 0xFFFFFFFFUL)) != imageTestRegs[i]) {
+            match = 0;
+        }
+    }
+    return match;
+}
+
+static bool_t imageTestPassed(void){
+    bool_t passed = TRUE;
+
+    for (uint8_t i = 0; i < IMAGE_TEST_CASES; i++) {
+        if ((imageResults[i].Match != 1U) || (imageResults[i].ImageCycles >= imageResults[i].RuntimeCycles)) {
+            passed = FALSE;
+        }
+    }
+    return passed;
+}
+
+void configImageTest(void){
+    // MODER, OTYPER, OSPEEDR, PUPDR, AFRL / BRR, CR1, CR2, CR3 / CR1, CR2, CRCPR / NDTR, PAR, M0AR, SCR, FCR
+    static const uint8_t gpioRegs[] = {0x00, 0x04, 0x08, 0x0C, 0x20};
+    static const uint8_t uartRegs[] = {0x08, 0x0C, 0x10, 0x14};
+    static const uint8_t spiRegs[] = {0x00, 0x04, 0x10};
+    static const uint8_t dmaRegs[] = {0x04, 0x08, 0x0C, 0x00, 0x14};
+    GPIO_cfg_t ledConfig = {
+        .port = GPIO_PORT_B,
+        .mode = GPIO_MODE_OUTPUT,
+        .outputType = GPIO_OUTPUT_TYPE_PUSH_PULL,
+        .speed = GPIO_SPEED_LOW,
+        .pull = GPIO_NO_PULL,
+        .alternateFunction = GPIO_AF0
+    };
+    UART_Config_t uartConfig = {
+        .PeripheralClock = UART_PERIPHERAL_CLOCK_AUTO,
+        .UART_Number = UART_6,
+        .BaudRate = 115200UL,
+        .Parity = UART_PARITY_NONE,
+        .OverSampling = UART_OVERSAMPLING_16,
+        .StopBits = UART_STOPBITS_1,
+        .WordLength = UART_WORDLENGTH_8B,
+        .Sample = UART_THREE_SAMPLE,
+        .UartEnabled = UART_ENABLE_TRANSMITE | UART_ENABLE_RECEIVE,
+        .InterruptFlags = 0
+    };
+    SPI_Config_t spiConfig = {
+        .spiNumber = SPI1,
+        .communicationMode = SPI_FULL_DUPLEX,
+        .mode = SPI_MASTER,
+        .crcState = SPI_CRC_DISABLED,
+        .dataLength = SPI_8_BIT_DATA,
+        .dataOrder = SPI_MSB_FIRST,
+        .baudRate = SPI_BAUDRATE_DIV16,
+        .polarityPhase = SPI_ZERO_IDLE_FIRST_EDGE,
+        .frameFormat = SPI_MOTOROLA,
+        .dmaState = SPI_DISABLE_DMA,
+        .nssManagement = SPI_NSS_MASTER_SW,
+        .crcPolynomial = 7,
+        .slavesConfig = { .numberOfSlaves = 0 }
+    };
+    DMA_Config_t dmaConfig = {
+        .DMAx = DMA2,
+        .Streamx = DMA_STREAM6,
+        .Channel = DMA_CHANNEL5,
+        .Direction = DMA_DIRECTION_M2P,
+        .PeripheralFlowCtrl = DMA_FLOW_CONTROL_USING_DMA,
+        .Mode = DMA_MODE_FIFO,
+        .Priority = DMA_PRIORITY_HIGH,
+        .MSize = DMA_MSIZE_BYTE,
+        .PSize = DMA_PSIZE_BYTE,
+        .MemoryInc = DMA_MINC_AUTO_INCREMENT,
+        .PeripheralInc = DMA_PINC_FIXED,
+        .CircularMode = DMA_CIRCULAR_MODE_DISABLE,
+        .MBurst = DMA_MBurst_SINGLE,
+        .PBurst = DMA_PBurst_SINGLE,
+        .DoubleBuffer = DMA_DISABLE_DOUBLE_BUFFER,
+        .FifoThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .PeripheralAddress = IMAGE_TEST_USART6 + 0x04UL,
+        .Memory0Address = IMAGE_TEST_SRAM,
+        .Memory1Address = 0,
+        .Interrupts = DMA_INTERRUPT_TRANSFER_COMPLETE_ENABLE | DMA_INTERRUPT_TRANSFER_ERROR_ENABLE,
+        .NumberOfData = 64
+    };
+    uint32_t start;
+
+    (void)TEST_u32Setup();
+
+    // GPIO : one init per pin against one image for the port
+    start = BENCH_u32Start();
+    ledConfig.pin = GPIO_PIN_0;
+    (void)GPIO_enuInit(&ledConfig);
+    ledConfig.pin = GPIO_PIN_1;
+    (void)GPIO_enuInit(&ledConfig);
+    imageResults[IMAGE_TEST_GPIO].RuntimeCycles = BENCH_u32Stop(start);
+    imageTestSave(IMAGE_TEST_GPIOB, gpioRegs, sizeof(gpioRegs), 0xFFFFFFFFUL);
+    start = BENCH_u32Start();
+    (void)GPIO_enuApplyImage(&imageTestLeds);
+    imageResults[IMAGE_TEST_GPIO].ImageCycles = BENCH_u32Stop(start);
+    imageResults[IMAGE_TEST_GPIO].Match = imageTestCompare(IMAGE_TEST_GPIOB, gpioRegs, sizeof(gpioRegs), 0xFFFFFFFFUL);
+
+    // UART
+    start = BENCH_u32Start();
+    (void)UART_enuInit(&uartConfig);
+    imageResults[IMAGE_TEST_UART].RuntimeCycles = BENCH_u32Stop(start);
+    imageTestSave(IMAGE_TEST_USART6, uartRegs, sizeof(uartRegs), 0xFFFFFFFFUL);
+    (void)UART_enuDeInit(UART_6);
+    start = BENCH_u32Start();
+    (void)UART_enuInitImage(&imageTestUart);
+    imageResults[IMAGE_TEST_UART].ImageCycles = BENCH_u32Stop(start);
+    imageResults[IMAGE_TEST_UART].Match = imageTestCompare(IMAGE_TEST_USART6, uartRegs, sizeof(uartRegs), 0xFFFFFFFFUL);
+    (void)UART_enuDeInit(UART_6);
+
+    // SPI
+    start = BENCH_u32Start();
+    (void)SPI_enuInit(&spiConfig);
+    imageResults[IMAGE_TEST_SPI].RuntimeCycles = BENCH_u32Stop(start);
+    imageTestSave(IMAGE_TEST_SPI1, spiRegs, sizeof(spiRegs), 0xFFFFFFFFUL);
+    (void)SPI_enuDeInit(SPI1);
+    start = BENCH_u32Start();
+    (void)SPI_enuInitImage(&imageTestSpi);
+    imageResults[IMAGE_TEST_SPI].ImageCycles = BENCH_u32Stop(start);
+    imageResults[IMAGE_TEST_SPI].Match = imageTestCompare(IMAGE_TEST_SPI1, spiRegs, sizeof(spiRegs), 0xFFFFFFFFUL);
+    (void)SPI_enuDeInit(SPI1);
+
+    // DMA
+    start = BENCH_u32Start();
+    (void)DMA_enuInit(&dmaConfig);
+    imageResults[IMAGE_TEST_DMA].RuntimeCycles = BENCH_u32Stop(start);
+    imageTestSave(IMAGE_TEST_DMA2_S6, dmaRegs, sizeof(dmaRegs), IMAGE_TEST_DMA_SFCR_CONFIG);
+    (void)DMA_enuDeInit(DMA2, DMA_STREAM6);
+    start = BENCH_u32Start();
+    (void)DMA_enuInitImage(&imageTestDma);
+    imageResults[IMAGE_TEST_DMA].ImageCycles = BENCH_u32Stop(start);
+    imageResults[IMAGE_TEST_DMA].Match = imageTestCompare(IMAGE_TEST_DMA2_S6, dmaRegs, sizeof(dmaRegs), IMAGE_TEST_DMA_SFCR_CONFIG);
+    (void)DMA_enuDeInit(DMA2, DMA_STREAM6);
+
+    TEST_vdDone(&imageTestDone, imageTestPassed());
+}
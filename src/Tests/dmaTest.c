@@ -21,7 +21,7 @@ void DMA_Test_Transmit(void){
 
     MCU_enuInit(&MCU_Configs);
 
-    NVIC_BP_SetPriority(NVIC_USART1_IRQ, 1);
+    NVIC_BP_SetPriority(NVIC_USART1_IRQ, NVIC_PRIORITY_5);
     NVIC_BP_EnableIRQ(NVIC_USART1_IRQ);
 
     char dataBuffer[100] = "This is a test buffer for DMA transmission via UART.";
@@ -68,7 +68,7 @@ void DMA_Test_Transmit(void){
     uartConfig.WordLength = UART_WORDLENGTH_8B; // 8 bits
     uartConfig.Sample = UART_THREE_SAMPLE; // 3 samples
     uartConfig.InterruptFlags = 0; // No interrupts
-    uartConfig.PeripheralClock = 16000000UL;
+    uartConfig.PeripheralClock = UART_PERIPHERAL_CLOCK_AUTO;
     uartConfig.BaudRate = 9600UL;
     uartStatus = UART_enuInit(&uartConfig);
 
@@ -112,7 +112,7 @@ void DMA_Test_Receive(void){
 
     MCU_enuInit(&MCU_Configs);
 
-    NVIC_BP_SetPriority(NVIC_DMA2_STREAM5_IRQ, 1);
+    NVIC_BP_SetPriority(NVIC_DMA2_STREAM5_IRQ, NVIC_PRIORITY_5);
     NVIC_BP_EnableIRQ(NVIC_DMA2_STREAM5_IRQ);
 
     char dataBuffer[20] = {0};
@@ -158,7 +158,7 @@ void DMA_Test_Receive(void){
     uartConfig.WordLength = UART_WORDLENGTH_8B; // 8 bits
     uartConfig.Sample = UART_THREE_SAMPLE; // 3 samples
     uartConfig.InterruptFlags = 0; // No interrupts
-    uartConfig.PeripheralClock = 16000000UL;
+    uartConfig.PeripheralClock = UART_PERIPHERAL_CLOCK_AUTO;
     uartConfig.BaudRate = 9600UL;
     uartStatus = UART_enuInit(&uartConfig);
 
@@ -0,0 +1,231 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/bench.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "MCAL/UART_Driver/uart.h"
+#include "MCAL/NVIC_Driver/nvic_stm32f401cc.h"
+#include "OS/fault.h"
+
+#include "test.h"
+
+#define FAULT_TEST_SIZE             (256U)
+#define FAULT_TEST_ROUNDS           (16U)
+
+typedef enum {
+    FAULT_TEST_CLEAN,               /* No injection : the reference throughput */
+    FAULT_TEST_LINE_ERRORS,         /* Parity, framing, noise : 1 in 64 ISR entries each */
+    FAULT_TEST_OVERRUN_FLAG,        /* ORE reported : 1 in 32 */
+    FAULT_TEST_SLOW_CONSUMER,       /* RX ISR stalled : 1 in 32, bytes lost for real */
+    FAULT_TEST_SCENARIOS
+}FAULT_TestScenario_t;
+
+typedef struct {
+    uint32_t Injected;              /* Faults injected (every point of the scenario) */
+    uint32_t ErrorCallbacks;        /* Parity + framing + noise + overrun callbacks */
+    uint32_t RoundsCompleted;       /* Receptions that completed */
+    uint32_t RoundsAborted;         /* Receptions ended with UART_enuAbortAsynReceive */
+    uint32_t BytesLost;             /* FAULT_TEST_SIZE - bytes received, over the aborted rounds */
+    uint32_t BytesPerSec;           /* Bytes received / time of the scenario */
+    uint32_t MaxRecoveryUs;         /* Longest time from the abort to the next reception accepted */
+    uint32_t Wedged;                /* Transfers refused as busy after a round ended : must stay 0 */
+}FAULT_TestResult_t;
+
+/**
+ * Build with FAULT FAULT_ENABLED (fault_cfg.h) and connect PC6 (USART6 TX) to PC7 (RX).
+ * Every scenario runs FAULT_TEST_ROUNDS loopback rounds of FAULT_TEST_SIZE bytes
+ * at 115200 : asynchronous transmit and receive, the reception aborted when it has
+ * not completed within twice its line time.
+ *   faultResults[scenario]   FAULT_TestResult_t in FAULT_TestScenario_t order
+ *   faultHseStatus           RCC_EnableHSE with FAULT_POINT_CLOCK_READY : RCC_TIMEOUT
+ *   faultHseRetryStatus      RCC_EnableHSE again without injection : RCC_OK on a board with HSE
+ * Passes when no scenario wedged the driver, the clean run completed every round
+ * without an error callback, every injecting scenario injected and reported errors
+ * (the slow consumer through real overruns) and the HSE enable timed out.
+ */
+volatile uint8_t faultTestDone = 0;
+FAULT_TestResult_t faultResults[FAULT_TEST_SCENARIOS];
+volatile RCC_Status_t faultHseStatus = RCC_NOT_OK;
+volatile RCC_Status_t faultHseRetryStatus = RCC_NOT_OK;
+
+static uint8_t faultTxBuffer[FAULT_TEST_SIZE];
+static uint8_t faultRxBuffer[FAULT_TEST_SIZE];
+static volatile uint8_t faultRxDone = 0;
+static volatile uint32_t faultErrorCallbacks = 0;
+static uint32_t faultCoreHz = 0;
+
+static void faultTestRxDone(void){
+    faultRxDone = 1;
+}
+
+static void faultTestError(void){
+    faultErrorCallbacks++;
+}
+
+static void faultTestTxDone(void){
+    // Nothing, the next round waits for the reception
+}
+
+static uint32_t faultTestInjected(void){
+    uint32_t total = 0;
+    uint32_t count;
+    uint8_t point;
+
+    for (point = 0; point < FAULT_POINTS; point++) {
+        if (FAULT_enuGetInjected((FAULT_Point_t)point, &count) == FAULT_OK) {
+            total += count;
+        }
+    }
+    return total;
+}
+
+static void faultTestScenario(FAULT_TestScenario_t scenario, uint32_t timeoutCycles){
+    FAULT_TestResult_t *result = &faultResults[scenario];
+    UART_AsynBuffer_t txBuffer;
+    UART_AsynBuffer_t rxBuffer;
+    uint32_t scenarioStart;
+    uint32_t start;
+    uint32_t received = 0;
+    uint32_t recoveryUs;
+    uint16_t count;
+    uint8_t round;
+
+    FAULT_vdReset();
+    switch (scenario) {
+        case FAULT_TEST_LINE_ERRORS:
+            (void)FAULT_enuConfigure(FAULT_POINT_UART_PARITY, FAULT_INSTANCE(UART_6), 64);
+            (void)FAULT_enuConfigure(FAULT_POINT_UART_FRAMING, FAULT_INSTANCE(UART_6), 64);
+            (void)FAULT_enuConfigure(FAULT_POINT_UART_NOISE, FAULT_INSTANCE(UART_6), 64);
+            break;
+        case FAULT_TEST_OVERRUN_FLAG:
+            (void)FAULT_enuConfigure(FAULT_POINT_UART_OVERRUN, FAULT_INSTANCE(UART_6), 32);
+            break;
+        case FAULT_TEST_SLOW_CONSUMER:
+            (void)FAULT_enuConfigure(FAULT_POINT_UART_RX_STALL, FAULT_INSTANCE(UART_6), 32);
+            break;
+        default:
+            // Clean run
+            break;
+    }
+    faultErrorCallbacks = 0;
+
+    rxBuffer.buffer = faultRxBuffer;
+    rxBuffer.size = FAULT_TEST_SIZE;
+    rxBuffer.index = 0;
+    rxBuffer.callback = faultTestRxDone;
+    txBuffer.buffer = faultTxBuffer;
+    txBuffer.size = FAULT_TEST_SIZE;
+    txBuffer.index = 0;
+    txBuffer.callback = faultTestTxDone;
+
+    scenarioStart = BENCH_u32Start();
+    for (round = 0; round < FAULT_TEST_ROUNDS; round++) {
+        faultRxDone = 0;
+        if ((UART_enuAsynReceiveBuffer(UART_6, &rxBuffer) != UART_OK)
+            || (UART_enuAsynTransmitBuffer(UART_6, &txBuffer) != UART_OK)) {
+            result->Wedged++;
+            (void)UART_enuAbortAsynReceive(UART_6, &count);
+            continue;
+        }
+
+        start = BENCH_u32Start();
+        while ((faultRxDone == 0) && (BENCH_u32Stop(start) < timeoutCycles));
+
+        if (faultRxDone == 1) {
+            result->RoundsCompleted++;
+            received += FAULT_TEST_SIZE;
+        } else {
+            // Frames lost : the reception would wait for bytes that never come
+            start = BENCH_u32Start();
+            (void)UART_enuAbortAsynReceive(UART_6, &count);
+            result->RoundsAborted++;
+            result->BytesLost += FAULT_TEST_SIZE - count;
+            received += count;
+
+            // Recovered once a new reception is accepted
+            if (UART_enuAsynReceiveBuffer(UART_6, &rxBuffer) != UART_OK) {
+                result->Wedged++;
+            }
+            recoveryUs = TEST_u32CyclesToUs(BENCH_u32Stop(start), faultCoreHz);
+            result->MaxRecoveryUs = (recoveryUs > result->MaxRecoveryUs) ? recoveryUs : result->MaxRecoveryUs;
+            (void)UART_enuAbortAsynReceive(UART_6, &count);
+        }
+    }
+    result->BytesPerSec = (uint32_t)(((uint64_t)received * faultCoreHz) / BENCH_u32Stop(scenarioStart));
+    result->ErrorCallbacks = faultErrorCallbacks;
+    result->Injected = faultTestInjected();
+}
+
+static bool_t faultTestPassed(void){
+    bool_t passed = (faultHseStatus == RCC_TIMEOUT) ? TRUE : FALSE;
+    uint8_t scenario;
+
+    for (scenario = 0; scenario < FAULT_TEST_SCENARIOS; scenario++) {
+        if (faultResults[scenario].Wedged != 0U) {
+            passed = FALSE;
+        } else if (scenario == FAULT_TEST_CLEAN) {
+            if ((faultResults[scenario].RoundsCompleted != FAULT_TEST_ROUNDS) || (faultResults[scenario].ErrorCallbacks != 0U)) {
+                passed = FALSE;
+            }
+        } else if ((faultResults[scenario].Injected == 0U) || (faultResults[scenario].ErrorCallbacks == 0U)) {
+            passed = FALSE;
+        } else {
+            // Injected and reported, nothing wedged
+        }
+    }
+    return passed;
+}
+
+void faultTest(void){
+    UART_Config_t uartConfig;
+    UART_Callbacks_t callbacks;
+    uint32_t frameNs = 0;
+    uint32_t timeoutCycles;
+    uint16_t i;
+    uint8_t scenario;
+
+    faultCoreHz = TEST_u32Setup();
+    FAULT_vdReset();
+
+    uartConfig.UART_Number = UART_6;
+    uartConfig.UartEnabled = UART_ENABLE_TRANSMITE | UART_ENABLE_RECEIVE;
+    uartConfig.Parity = UART_PARITY_NONE;
+    uartConfig.OverSampling = UART_OVERSAMPLING_16;
+    uartConfig.StopBits = UART_STOPBITS_1;
+    uartConfig.WordLength = UART_WORDLENGTH_8B;
+    uartConfig.Sample = UART_THREE_SAMPLE;
+    uartConfig.InterruptFlags = 0;
+    uartConfig.PeripheralClock = UART_PERIPHERAL_CLOCK_AUTO;
+    uartConfig.BaudRate = 115200UL;
+    (void)UART_enuInit(&uartConfig);
+
+    callbacks.ParityErrorCallback = faultTestError;
+    callbacks.FramingErrorCallback = faultTestError;
+    callbacks.NoiseErrorCallback = faultTestError;
+    callbacks.OverrunErrorCallback = faultTestError;
+    callbacks.TC_Callback = NULL;
+    (void)UART_enuRegisterCallbacks(UART_6, &callbacks);
+
+    NVIC_BP_SetPriority(NVIC_USART6_IRQ, NVIC_PRIORITY_5);
+    NVIC_BP_EnableIRQ(NVIC_USART6_IRQ);
+
+    for (i = 0; i < FAULT_TEST_SIZE; i++) {
+        faultTxBuffer[i] = (uint8_t)i;
+    }
+
+    // Twice the line time of a round
+    (void)UART_enuGetFrameTime(UART_6, &frameNs);
+    timeoutCycles = (uint32_t)(((uint64_t)frameNs * FAULT_TEST_SIZE * 2U * faultCoreHz) / 1000000000ULL);
+
+    for (scenario = 0; scenario < FAULT_TEST_SCENARIOS; scenario++) {
+        faultTestScenario((FAULT_TestScenario_t)scenario, timeoutCycles);
+    }
+
+    // Oscillator that never starts, then the same call once the fault is gone
+    FAULT_vdReset();
+    (void)FAULT_enuConfigure(FAULT_POINT_CLOCK_READY, FAULT_INSTANCE(FAULT_CLOCK_HSE), 1);
+    faultHseStatus = RCC_EnableHSE();
+    FAULT_vdReset();
+    faultHseRetryStatus = RCC_EnableHSE();
+
+    TEST_vdDone(&faultTestDone, faultTestPassed());
+}
@@ -0,0 +1,183 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/bench.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "MCAL/FLASH_Driver/flash.h"
+#include "HAL/MCU_Driver/mcu.h"
+
+#include "test.h"
+
+#define BENCH_ITERATIONS     (50U)
+#define BENCH_LIST_SIZE      (32U)
+#define BENCH_MATRIX_SIZE    (8U)
+
+/**
+ * CoreMark-like workload: linked list walk/reverse, small matrix multiply,
+ * a state machine parsing a string, and a CRC16 of every partial result.
+ * Cycles of each accelerator setting end up in flashBenchCycles, read them
+ * from the debugger:
+ *   [0] no prefetch, no caches
+ *   [1] prefetch only
+ *   [2] I-cache + D-cache
+ *   [3] prefetch + I-cache + D-cache  (default of MCU_enuInit)
+ * flashBenchCrc must be the same in all four runs.
+ * Passes when the four CRCs match and the fully accelerated run [3] is faster
+ * than the bare run [0].
+ */
+volatile uint8_t flashBenchDone = TEST_RUNNING;
+volatile uint32_t flashBenchCycles[4] = {0};
+volatile uint16_t flashBenchCrc[4] = {0};
+
+typedef struct BenchNode {
+    struct BenchNode* next;
+    sint16_t value;
+}BenchNode_t;
+
+static BenchNode_t benchNodes[BENCH_LIST_SIZE];
+static sint16_t matrixA[BENCH_MATRIX_SIZE][BENCH_MATRIX_SIZE];
+static sint16_t matrixB[BENCH_MATRIX_SIZE][BENCH_MATRIX_SIZE];
+static sint32_t matrixC[BENCH_MATRIX_SIZE][BENCH_MATRIX_SIZE];
+static const char benchInput[] = "12,-7,3.5e2,+44,0x1F,abc,-0.25,9999,7e-3,,";
+
+static uint16_t benchCrc16(uint16_t crc, uint16_t data){
+    uint8_t bit;
+    crc ^= data;
+    for (bit = 0; bit < 16; bit++) {
+        crc = (crc & 1U) ? (uint16_t)((crc >> 1) ^ 0xA001U) : (uint16_t)(crc >> 1);
+    }
+    return crc;
+}
+
+static uint16_t benchList(uint16_t crc){
+    BenchNode_t* head = &benchNodes[0];
+    BenchNode_t* prev = NULL;
+    BenchNode_t* node;
+    uint8_t index;
+
+    for (index = 0; index < BENCH_LIST_SIZE; index++) {
+        benchNodes[index].value = (sint16_t)((index * 37) ^ crc);
+        benchNodes[index].next = (index + 1U < BENCH_LIST_SIZE) ? &benchNodes[index + 1U] : NULL;
+    }
+    // find the max then reverse the list
+    for (node = head; node != NULL; node = node->next) {
+        if (node->value > head->value) {
+            crc = benchCrc16(crc, (uint16_t)node->value);
+        }
+    }
+    node = head;
+    while (node != NULL) {
+        BenchNode_t* next = node->next;
+        node->next = prev;
+        prev = node;
+        node = next;
+    }
+    for (node = prev; node != NULL; node = node->next) {
+        crc = benchCrc16(crc, (uint16_t)node->value);
+    }
+    return crc;
+}
+
+static uint16_t benchMatrix(uint16_t crc){
+    uint8_t row, col, k;
+
+    for (row = 0; row < BENCH_MATRIX_SIZE; row++) {
+        for (col = 0; col < BENCH_MATRIX_SIZE; col++) {
+            matrixA[row][col] = (sint16_t)((row * col + crc) & 0xFF);
+            matrixB[row][col] = (sint16_t)((row - col) * 3);
+        }
+    }
+    for (row = 0; row < BENCH_MATRIX_SIZE; row++) {
+        for (col = 0; col < BENCH_MATRIX_SIZE; col++) {
+            sint32_t sum = 0;
+            for (k = 0; k < BENCH_MATRIX_SIZE; k++) {
+                sum += (sint32_t)matrixA[row][k] * matrixB[k][col];
+            }
+            matrixC[row][col] = sum;
+            crc = benchCrc16(crc, (uint16_t)sum);
+        }
+    }
+    return crc;
+}
+
+typedef enum {
+    BENCH_START,
+    BENCH_INT,
+    BENCH_FLOAT,
+    BENCH_EXPONENT,
+    BENCH_INVALID
+}BenchState_t;
+
+static uint16_t benchStateMachine(uint16_t crc){
+    BenchState_t state = BENCH_START;
+    uint8_t index;
+
+    for (index = 0; benchInput[index] != '\0'; index++) {
+        char c = benchInput[index];
+        if (c == ',') {
+            crc = benchCrc16(crc, (uint16_t)state);
+            state = BENCH_START;
+            continue;
+        }
+        switch (state) {
+        case BENCH_START:
+            state = ((c >= '0' && c <= '9') || c == '+' || c == '-') ? BENCH_INT : BENCH_INVALID;
+            break;
+        case BENCH_INT:
+            if (c == '.') { state = BENCH_FLOAT; }
+            else if (c == 'e' || c == 'E') { state = BENCH_EXPONENT; }
+            else if (c < '0' || c > '9') { state = BENCH_INVALID; }
+            break;
+        case BENCH_FLOAT:
+            if (c == 'e' || c == 'E') { state = BENCH_EXPONENT; }
+            else if (c < '0' || c > '9') { state = BENCH_INVALID; }
+            break;
+        case BENCH_EXPONENT:
+            if ((c < '0' || c > '9') && c != '-' && c != '+') { state = BENCH_INVALID; }
+            break;
+        default:
+            break;
+        }
+    }
+    return crc;
+}
+
+static void benchRun(uint8_t slot, uint32_t features){
+    uint16_t crc = 0xFFFF;
+    uint32_t start;
+    uint16_t iteration;
+
+    FLASH_enuConfigureAccelerator(features, FLASH_VOLTAGE_2V7_TO_3V6);
+
+    start = BENCH_u32Start();
+    for (iteration = 0; iteration < BENCH_ITERATIONS; iteration++) {
+        crc = benchList(crc);
+        crc = benchMatrix(crc);
+        crc = benchStateMachine(crc);
+    }
+    flashBenchCycles[slot] = BENCH_u32Stop(start);
+    flashBenchCrc[slot] = crc;
+}
+
+void flashAcceleratorBenchmark(void){
+    const MCU_ClockProfile_t fullSpeed = {
+        .MCU_SystemClockSource  = MCU_SYSCLK_PLL,
+        .MCU_PLLClockSource     = MCU_PLL_SOURCE_HSI,
+        .MCU_PLLTargetFrequency = 84000000UL,
+        .MCU_AHP_Prescaler      = MCU_AHB_NO_DIVISION,
+        .MCU_APB1_Prescaler     = MCU_APB1_DIVIDED_BY_2,
+        .MCU_APB2_Prescaler     = MCU_APB2_NO_DIVISION
+    };
+
+    (void)TEST_u32Setup();
+    // 84MHZ from the PLL so the flash runs with 2 wait states
+    MCU_enuSetClockProfile(&fullSpeed);
+
+    benchRun(0, FLASH_NO_FEATURE);
+    benchRun(1, FLASH_PREFETCH_ENABLE);
+    benchRun(2, FLASH_ICACHE_ENABLE | FLASH_DCACHE_ENABLE);
+    benchRun(3, FLASH_ALL_FEATURES);
+
+    TEST_vdDone(&flashBenchDone, ((flashBenchCrc[1] == flashBenchCrc[0]) && (flashBenchCrc[2] == flashBenchCrc[0])
+                                  && (flashBenchCrc[3] == flashBenchCrc[0])
+                                  && (flashBenchCycles[3] < flashBenchCycles[0])) ? TRUE : FALSE);
+}
@@ -0,0 +1,88 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/bench.h"
+#include "HAL/HSERIAL_Driver/hserial.h"
+
+#include "test.h"
+
+#define THROUGHPUT_TEST_BLOCK       (128U)
+#define THROUGHPUT_TEST_BLOCKS      (16U)
+
+// Sustained rate : at least 95 % of the line rate
+#define THROUGHPUT_TEST_MIN_EFFICIENCY (950U)
+
+/**
+ * Sustained transmit throughput of HSERIAL_CHANNEL_1 against its line rate.
+ * Connect a USB-UART to PA9 and sink the data on the host (cat /dev/ttyUSB0 > out.bin),
+ * out.bin holds THROUGHPUT_TEST_BLOCKS + 1 blocks of 0x00..0x7F to check nothing was lost.
+ *   throughputLineUs        HSERIAL_enuGetTransferTime of the whole stream
+ *   throughputMeasuredUs    first block accepted to the block after the last accepted,
+ *                           each block queued as soon as the previous one is done
+ *   throughputBytesPerSec   THROUGHPUT_TEST_BLOCKS * THROUGHPUT_TEST_BLOCK / throughputMeasuredUs
+ *   throughputEfficiency    line time * 1000 / measured time (per-mille, 1000 = line rate)
+ *   throughputRetries       HSERIAL_FAILED_TRANSMIT answers while a block was in flight
+ * Passes when every block was accepted and throughputEfficiency >= THROUGHPUT_TEST_MIN_EFFICIENCY.
+ */
+volatile uint8_t throughputTestDone = 0;
+volatile HSERIAL_Status_t throughputStatus = HSERIAL_NOT_OK;
+volatile uint32_t throughputLineUs = 0;
+volatile uint32_t throughputMeasuredUs = 0;
+volatile uint32_t throughputBytesPerSec = 0;
+volatile uint32_t throughputEfficiency = 0;
+volatile uint32_t throughputRetries = 0;
+
+static uint8_t throughputBlock[THROUGHPUT_TEST_BLOCK];
+
+// Queues the block, retrying while the channel is still sending the previous one
+static HSERIAL_Status_t throughputTestSend(void){
+    HSERIAL_Status_t status;
+
+    do {
+        status = HSERIAL_enuTransmitBuffer(HSERIAL_CHANNEL_1, throughputBlock, THROUGHPUT_TEST_BLOCK);
+        if (status == HSERIAL_FAILED_TRANSMIT) {
+            throughputRetries++;
+        }
+    } while (status == HSERIAL_FAILED_TRANSMIT);
+    return status;
+}
+
+void hserialThroughputTest(void){
+    uint32_t coreHz;
+    uint32_t start;
+    uint32_t cycles;
+    uint16_t block;
+    uint16_t i;
+
+    coreHz = TEST_u32Setup();
+
+    for (i = 0; i < THROUGHPUT_TEST_BLOCK; i++) {
+        throughputBlock[i] = (uint8_t)i;
+    }
+
+    throughputStatus = HSERIAL_enuInit();
+    if (throughputStatus == HSERIAL_OK) {
+        throughputStatus = HSERIAL_enuGetTransferTime(HSERIAL_CHANNEL_1,
+                                                      THROUGHPUT_TEST_BLOCKS * THROUGHPUT_TEST_BLOCK,
+                                                      (uint32_t*)&throughputLineUs);
+    }
+
+    if (throughputStatus == HSERIAL_OK) {
+        throughputStatus = throughputTestSend();
+        start = BENCH_u32Start();
+        // Blocks 2 .. N, then one more accepted once block N left the buffer
+        for (block = 1; (block <= THROUGHPUT_TEST_BLOCKS) && (throughputStatus == HSERIAL_OK); block++) {
+            throughputStatus = throughputTestSend();
+        }
+        cycles = BENCH_u32Stop(start);
+
+        throughputMeasuredUs = TEST_u32CyclesToUs(cycles, coreHz);
+        if (throughputMeasuredUs != 0) {
+            throughputBytesPerSec = (uint32_t)(((uint64_t)THROUGHPUT_TEST_BLOCKS * THROUGHPUT_TEST_BLOCK * 1000000ULL)
+                                               / throughputMeasuredUs);
+            throughputEfficiency = (uint32_t)(((uint64_t)throughputLineUs * 1000ULL) / throughputMeasuredUs);
+        }
+    }
+
+    TEST_vdDone(&throughputTestDone, ((throughputStatus == HSERIAL_OK)
+                                      && (throughputEfficiency >= THROUGHPUT_TEST_MIN_EFFICIENCY)) ? TRUE : FALSE);
+}
@@ -0,0 +1,97 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/bench.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "HAL/MCU_Driver/mcu.h"
+#include "MCAL/I2C_Driver/i2c.h"
+
+#include "test.h"
+
+#define I2C_TEST_EEPROM_ADDRESS (0x50U)     // 24C02 (A2..A0 low)
+#define I2C_TEST_MPU_ADDRESS    (0x68U)     // MPU-6050 (AD0 low)
+#define I2C_TEST_LCD_ADDRESS    (0x27U)     // PCF8574 LCD backpack
+#define I2C_TEST_ABSENT_ADDRESS (0x3CU)     // Nothing on the bus : NACK expected
+#define I2C_TEST_MPU_WHO_AM_I   (0x75U)
+#define I2C_TEST_MPU_ID         (0x68U)     // WHO_AM_I value
+
+static const uint8_t i2cTestEepromOffset = 0x00;
+static const uint8_t i2cTestMpuRegister = I2C_TEST_MPU_WHO_AM_I;
+static const uint8_t i2cTestLcdBacklight = 0x08;
+static uint8_t i2cTestEepromData[16];
+static uint8_t i2cTestMpuId;
+static uint8_t i2cTestProbe;
+
+static I2C_Transaction_t i2cTestTransactions[4] = {
+    // Write-then-read, 16 bytes : DMA on I2C1
+    {I2C_TEST_EEPROM_ADDRESS, &i2cTestEepromOffset, 1, i2cTestEepromData, sizeof(i2cTestEepromData), NULL, NULL, I2C_RESULT_PENDING},
+    // Register read, 1 byte : interrupt path with NACK + STOP at ADDR
+    {I2C_TEST_MPU_ADDRESS, &i2cTestMpuRegister, 1, &i2cTestMpuId, 1, NULL, NULL, I2C_RESULT_PENDING},
+    // Write only
+    {I2C_TEST_LCD_ADDRESS, &i2cTestLcdBacklight, 1, NULL, 0, NULL, NULL, I2C_RESULT_PENDING},
+    // Read only, nobody answers
+    {I2C_TEST_ABSENT_ADDRESS, NULL, 0, &i2cTestProbe, 1, NULL, NULL, I2C_RESULT_PENDING},
+};
+
+/**
+ * I2C1 at 400 kHz on PB6 (SCL) / PB7 (SDA) with 4.7k pull-ups, a 24C02,
+ * an MPU-6050 and a PCF8574 backpack on the bus.
+ * The four transactions are queued back to back, the CPU only waits at the end.
+ * Read the results from the debugger once i2cTestDone is set:
+ *   i2cResults         OK (1), OK, OK, NACK (2)
+ *   i2cCompletions     4, in submission order (i2cOrder = 0, 1, 2, 3)
+ *   i2cMpuId           0x68
+ *   i2cSubmitCycles    HCLK cycles spent queueing the four transactions
+ *   i2cTotalCycles     HCLK cycles until the last callback (~1 ms of bus time)
+ * Passes when every result, the completion order and the MPU id are the ones above.
+ */
+volatile uint8_t i2cTestDone = TEST_RUNNING;
+volatile I2C_Status_t i2cStatus = I2C_NOT_OK;
+volatile I2C_Result_t i2cResults[4];
+volatile uint8_t i2cOrder[4];
+volatile uint8_t i2cCompletions = 0;
+volatile uint8_t i2cMpuId = 0;
+volatile uint32_t i2cSubmitCycles = 0;
+volatile uint32_t i2cTotalCycles = 0;
+
+static void i2cTestCallback(I2C_Transaction_t *transaction){
+    uint8_t index = (uint8_t)(transaction - i2cTestTransactions);
+    i2cResults[index] = transaction->I2C_Result;
+    i2cOrder[i2cCompletions] = index;
+    i2cCompletions++;
+}
+
+void i2cQueueTest(void){
+    I2C_Config_t config = {
+        .I2C_Number = I2C_1,
+        .I2C_Speed  = I2C_SPEED_FAST_400K
+    };
+    static const I2C_Result_t expected[4] = {I2C_RESULT_OK, I2C_RESULT_OK, I2C_RESULT_OK, I2C_RESULT_NACK};
+    bool_t passed = FALSE;
+    uint32_t start;
+
+    (void)TEST_u32Setup();
+
+    i2cStatus = I2C_enuInit(&config);
+
+    start = BENCH_u32Start();
+    for (uint8_t i = 0; (i < 4U) && (i2cStatus == I2C_OK); i++) {
+        i2cTestTransactions[i].I2C_Callback = i2cTestCallback;
+        i2cStatus = I2C_enuSubmit(I2C_1, &i2cTestTransactions[i]);
+    }
+    i2cSubmitCycles = BENCH_u32Stop(start);
+
+    if (i2cStatus == I2C_OK) {
+        while (i2cCompletions < 4U);
+        i2cTotalCycles = BENCH_u32Stop(start);
+        i2cMpuId = i2cTestMpuId;
+
+        passed = (i2cMpuId == I2C_TEST_MPU_ID) ? TRUE : FALSE;
+        for (uint8_t i = 0; i < 4U; i++) {
+            if ((i2cResults[i] != expected[i]) || (i2cOrder[i] != i)) {
+                passed = FALSE;
+            }
+        }
+    }
+
+    TEST_vdDone(&i2cTestDone, passed);
+}
@@ -1,5 +1,6 @@
 
 #include "LIB/stdtypes.h"
+#include "MCAL/NVIC_Driver/nvic.h"
 #include "MCAL/NVIC_Driver/nvic_stm32f401cc.h"
 
 
@@ -14,4 +15,37 @@ void nvicTest(){
     NVIC_BP_SetPendingIRQ(NVIC_SPI1_IRQ);
     NVIC_BP_Pending_t pending;
     NVIC_BP_GetPendingIRQ(NVIC_SPI1_IRQ,&pending);
-}
\ No newline at end of file
+}
+
+#define NVIC_VECTOR_TEST_WAIT    (1000UL)
+
+/**
+ * EXTI0 pended after its vector was replaced in the RAM table.
+ * Passes when the relocation and the install succeed and the direct handler
+ * ran exactly once, nvicVectorTestDone then holds the verdict.
+ */
+volatile uint8_t nvicVectorTestDone = TEST_RUNNING;
+static volatile uint32_t directHandlerCounter = 0;
+
+static void DirectExti0Handler(void){
+    directHandlerCounter++;
+}
+
+void nvicVectorTest(){
+    NVIC_Status_t relocateStatus;
+    NVIC_BP_Status_t vectorStatus;
+    uint32_t wait = 0;
+
+    relocateStatus = NVIC_RelocateVectorTable();
+    vectorStatus = NVIC_BP_SetVector(NVIC_EXTI0_IRQ,DirectExti0Handler);
+    NVIC_BP_EnableIRQ(NVIC_EXTI0_IRQ);
+    NVIC_BP_SetPendingIRQ(NVIC_EXTI0_IRQ);
+
+    while ((directHandlerCounter == 0) && (wait < NVIC_VECTOR_TEST_WAIT)) {
+        wait++;
+    }
+    NVIC_BP_DisableIRQ(NVIC_EXTI0_IRQ);
+
+    TEST_vdDone(&nvicVectorTestDone, ((relocateStatus == NVIC_OK) && (vectorStatus == NVIC_BP_OK)
+                                      && (directHandlerCounter == 1U)) ? TRUE : FALSE);
+}
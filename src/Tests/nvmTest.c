@@ -0,0 +1,126 @@
+
+#include "LIB/stdtypes.h"
+#include "HAL/MCU_Driver/mcu.h"
+#include "MCAL/FLASH_Driver/flash.h"
+#include "MCAL/NVIC_Driver/nvic.h"
+#include "HAL/NVM_Driver/nvm.h"
+#include "OS/update_cfg.h"
+
+#include "test.h"
+
+#define NVM_TEST_KEY_BOOT_COUNT     (0U)
+#define NVM_TEST_KEY_SAMPLE         (1U)
+#define NVM_TEST_WRITES             (1000U)
+
+/**
+ * Configuration store: a boot counter survives resets, then 1000 writes of a
+ * 16 byte sample force several compactions.
+ * Read the results from the debugger once nvmTestDone is set:
+ *   nvmBootCount       +1 on every reset (also after a reset during the writes)
+ *   nvmStats           generation (compactions), used / free bytes, live keys
+ *   nvmLastSample[0]   NVM_TEST_WRITES - 1 when every write was read back
+ *   nvmErrors          0
+ * Passes when nvmErrors is 0, the last sample is NVM_TEST_WRITES - 1, at least
+ * one compaction ran and both keys are live.
+ */
+volatile uint8_t nvmTestDone = TEST_RUNNING;
+volatile uint32_t nvmBootCount = 0;
+volatile uint32_t nvmErrors = 0;
+volatile NVM_Stats_t nvmStats;
+volatile uint32_t nvmLastSample[4] = {0};
+
+void nvmStoreTest(void){
+    uint32_t bootCount = 0;
+    uint32_t sample[4];
+    uint32_t readBack[4];
+    uint16_t length = 0;
+    uint16_t write;
+    NVM_Stats_t stats;
+
+    MCU_enuInit(&MCU_Configs);
+
+    if (NVM_OK != NVM_enuInit()) {
+        nvmErrors++;
+    }
+
+    // First boot after a format : key not found, counter starts at 0
+    NVM_enuRead(NVM_TEST_KEY_BOOT_COUNT, &bootCount, sizeof(bootCount), &length);
+    bootCount++;
+    if (NVM_OK != NVM_enuWrite(NVM_TEST_KEY_BOOT_COUNT, &bootCount, sizeof(bootCount))) {
+        nvmErrors++;
+    }
+    nvmBootCount = bootCount;
+
+    for (write = 0; write < NVM_TEST_WRITES; write++) {
+        sample[0] = write;
+        sample[1] = ~(uint32_t)write;
+        sample[2] = bootCount;
+        sample[3] = 0xA5A5A5A5UL;
+
+        if ((NVM_OK != NVM_enuWrite(NVM_TEST_KEY_SAMPLE, sample, sizeof(sample))) ||
+            (NVM_OK != NVM_enuRead(NVM_TEST_KEY_SAMPLE, readBack, sizeof(readBack), &length)) ||
+            (readBack[0] != sample[0]) || (readBack[1] != sample[1])) {
+            nvmErrors++;
+        }
+    }
+
+    NVM_enuRead(NVM_TEST_KEY_SAMPLE, readBack, sizeof(readBack), &length);
+    nvmLastSample[0] = readBack[0];
+    nvmLastSample[1] = readBack[1];
+    nvmLastSample[2] = readBack[2];
+    nvmLastSample[3] = readBack[3];
+
+    // Boot counter must have survived the compactions
+    NVM_enuRead(NVM_TEST_KEY_BOOT_COUNT, &bootCount, sizeof(bootCount), &length);
+    if (bootCount != nvmBootCount) {
+        nvmErrors++;
+    }
+
+    NVM_enuGetStats(&stats);
+    nvmStats = stats;
+
+    TEST_vdDone(&nvmTestDone, ((nvmErrors == 0U) && (nvmLastSample[0] == (NVM_TEST_WRITES - 1U))
+                               && (stats.NVM_Generation > 0U) && (stats.NVM_Keys == 2U)) ? TRUE : FALSE);
+}
+
+/**
+ * Flash protection with the vector table in SRAM (NVIC_RelocateVectorTable).
+ * The sector of the running image (UPD_APP_SECTOR) and the bootloader must stay
+ * refused, the download slot (UPD_SLOT_SECTOR) must still take an erase and a word
+ * (a downloaded image waiting in the slot is lost).
+ * Read the results from the debugger once flashProtectionTestDone is set:
+ *   flashProtectionStatus[0]  erase of the application sector  FLASH_SECTOR_PROTECTED
+ *   flashProtectionStatus[1]  program into the application     FLASH_SECTOR_PROTECTED
+ *   flashProtectionStatus[2]  erase of sector 0                FLASH_SECTOR_PROTECTED
+ *   flashProtectionStatus[3]  erase of the slot                FLASH_OK
+ *   flashProtectionStatus[4]  program into the slot            FLASH_OK
+ * Passes when every status is the expected one.
+ */
+volatile uint8_t flashProtectionTestDone = TEST_RUNNING;
+volatile FLASH_Status_t flashProtectionStatus[5];
+
+void flashProtectionTest(void){
+    static const FLASH_Status_t expected[5] = {
+        FLASH_SECTOR_PROTECTED, FLASH_SECTOR_PROTECTED, FLASH_SECTOR_PROTECTED, FLASH_OK, FLASH_OK
+    };
+    const uint32_t word = 0x5A5AA5A5UL;
+    bool_t passed;
+    uint8_t i;
+
+    MCU_enuInit(&MCU_Configs);
+    passed = (NVIC_RelocateVectorTable() == NVIC_OK) ? TRUE : FALSE;
+
+    flashProtectionStatus[0] = FLASH_enuEraseSector(UPD_APP_SECTOR);
+    flashProtectionStatus[1] = FLASH_enuProgram(UPD_APP_ADDRESS + 0x8000UL, &word, 1);
+    flashProtectionStatus[2] = FLASH_enuEraseSector(0);
+    flashProtectionStatus[3] = FLASH_enuEraseSector(UPD_SLOT_SECTOR);
+    flashProtectionStatus[4] = FLASH_enuProgram(UPD_SLOT_ADDRESS, &word, 1);
+
+    for (i = 0; i < 5U; i++) {
+        if (flashProtectionStatus[i] != expected[i]) {
+            passed = FALSE;
+        }
+    }
+
+    TEST_vdDone(&flashProtectionTestDone, passed);
+}
@@ -0,0 +1,69 @@
+
+#include "LIB/stdtypes.h"
+#include "MCAL/GPIO_Driver/gpio_int.h"
+#include "HAL/MCU_Driver/mcu.h"
+#include "HAL/LED_Driver/led.h"
+#include "OS/schedule.h"
+#include "OS/power.h"
+#include "OS/power_cfg.h"
+
+#include "test.h"
+
+/**
+ * Low-power scheduler: an LED blinks every 500 ms, the MCU is in STOP between
+ * the blinks (SCHED_IDLE_MODE = SCHED_IDLE_LOW_POWER). A falling edge on PA0
+ * (KEY button of the BlackPill) wakes it early.
+ * Read the residency from the debugger once powerTestDone is set:
+ *   powerReport[PWRM_MODE_SLEEP / STOP / STOP_LP]   entries, early wake-ups, us
+ * Build with SCHED_IDLE_MODE = SCHED_IDLE_LOW_POWER (schedule_cfg.h) and
+ * PWRM_DEEPEST_MODE = PWRM_MODE_STOP_LP (power_cfg.h), both ship disabled.
+ * Note: Detach the debugger before running it, SWD stops in STOP
+ * Passes after POWER_TEST_BLINKS blinks when PWRM_DEEPEST_MODE was entered and
+ * has a non-zero residency.
+ */
+#define POWER_TEST_BLINKS       (10U)
+
+volatile uint8_t powerTestDone = TEST_RUNNING;
+volatile PWRM_Residency_t powerReport[PWRM_NUMBER_OF_MODES];
+static uint8_t powerBlinks = 0;
+
+static void powerBlink(void* args){
+    uint8_t mode;
+    PWRM_Residency_t residency;
+    (void)args;
+
+    LED_vdToggle(BLACK_PILL_LED);
+
+    for(mode = 0; mode < PWRM_NUMBER_OF_MODES; mode++){
+        PWRM_enuGetResidency((PWRM_Mode_t)mode, &residency);
+        powerReport[mode] = residency;
+    }
+
+    powerBlinks++;
+    if (powerBlinks >= POWER_TEST_BLINKS) {
+        TEST_vdDone(&powerTestDone, ((powerReport[PWRM_DEEPEST_MODE].PWRM_Entries > 0U)
+                                     && (powerReport[PWRM_DEEPEST_MODE].PWRM_Residency_us > 0U)) ? TRUE : FALSE);
+    }
+}
+
+static SCHED_Runnable_t powerBlinkRunnable ={
+    .CBF = powerBlink,
+    .Periodicity_ms = 500,
+    .FirstDalay_ms = 0,
+    .Args = NULL,
+    .Priority = 0
+};
+
+void lowPowerSchedulerTest(void){
+    MCU_enuInit(&MCU_Configs);
+    LED_vdInit();
+
+    // LSI calibration needs the final HCLK
+    PWRM_enuInit();
+    PWRM_enuEnablePinWakeup(GPIO_PORT_A, GPIO_PIN_0, PWR_EDGE_FALLING);
+
+    SCHED_enuInit(1, SCHED_CLOCK_AUTO);
+    SCHED_enuRegisterRunnable(&powerBlinkRunnable);
+
+    SCHED_enuStart();
+}
@@ -0,0 +1,112 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/dwt.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "MCAL/FLASH_Driver/flash.h"
+#include "MCAL/SYSTICK_TIMER_Driver/systick.h"
+#include "MCAL/NVIC_Driver/nvic_stm32f401cc.h"
+#include "HAL/MCU_Driver/mcu.h"
+
+#include "test.h"
+
+// SCB ICSR : PENDSTSET pends SysTick from software
+#define RAMF_SCB_ICSR        (*(volatile uint32_t *)0xE000ED04UL)
+#define RAMF_ICSR_PENDSTSET  (0x04000000UL)
+
+#define RAMF_SAMPLES         (64U)
+#define RAMF_MAX_PERMILLE    (250)
+
+/**
+ * Interrupt latency of the RAMFUNC paths, in cycles at 84 MHz, averaged
+ * over RAMF_SAMPLES software-pended interrupts:
+ *   ramFuncCycles[path][accel]
+ *     path  0 : pend -> SysTick callback entry (SysTick_Handler)
+ *           1 : pend -> return of USART1_IRQHandler (flag reads + local handler)
+ *           2 : pend -> return of DMA2_Stream0_IRQHandler (5 flag checks)
+ *     accel 0 : no prefetch, no caches (every fetch pays the 2 wait states)
+ *           1 : prefetch + I-cache + D-cache
+ * Run it twice : once as is, once built with -DRAMFUNC_DISABLE (all in flash),
+ * and compare the two reports from the debugger once ramFuncTestDone is set.
+ * Passes when every latency was measured and, with the RAMFUNC paths in RAM,
+ * turning the accelerators off costs each path at most RAMF_MAX_PERMILLE
+ * (only the vector fetch still reads flash).
+ */
+volatile uint8_t ramFuncTestDone = TEST_RUNNING;
+volatile uint32_t ramFuncCycles[3][2] = {{0}};
+
+static volatile uint32_t sysTickEntry = 0;
+
+static void ramFuncSysTickCallback(void){
+    sysTickEntry = DWT_CYCCNT;
+}
+
+static uint32_t ramFuncMeasure(uint8_t path){
+    uint32_t total = 0;
+    uint32_t start;
+    uint32_t end;
+    uint16_t sample;
+
+    for (sample = 0; sample < RAMF_SAMPLES; sample++) {
+        start = DWT_CYCCNT;
+        if (path == 0) {
+            RAMF_SCB_ICSR = RAMF_ICSR_PENDSTSET;
+            __asm volatile ("dsb\n isb" ::: "memory");
+            end = sysTickEntry;
+        } else {
+            NVIC_BP_SetPendingIRQ((path == 1) ? NVIC_USART1_IRQ : NVIC_DMA2_STREAM0_IRQ);
+            __asm volatile ("dsb\n isb" ::: "memory");
+            end = DWT_CYCCNT;
+        }
+        total += end - start;
+    }
+    return total / RAMF_SAMPLES;
+}
+
+void ramFuncLatencyTest(void){
+    const uint32_t accel[2] = {FLASH_NO_FEATURE, FLASH_ALL_FEATURES};
+    const MCU_ClockProfile_t fullSpeed = {
+        .MCU_SystemClockSource  = MCU_SYSCLK_PLL,
+        .MCU_PLLClockSource     = MCU_PLL_SOURCE_HSI,
+        .MCU_PLLTargetFrequency = 84000000UL,
+        .MCU_AHP_Prescaler      = MCU_AHB_NO_DIVISION,
+        .MCU_APB1_Prescaler     = MCU_APB1_DIVIDED_BY_2,
+        .MCU_APB2_Prescaler     = MCU_APB2_NO_DIVISION
+    };
+    bool_t passed = TRUE;
+    uint8_t setting;
+    uint8_t path;
+
+    // CYCCNT is started by the BENCH time base
+    (void)TEST_u32Setup();
+    // 84MHZ from the PLL so the flash runs with 2 wait states
+    MCU_enuSetClockProfile(&fullSpeed);
+
+    // Counter stays stopped, only the software pend raises SysTick
+    SYSTICK_SetCallBack(ramFuncSysTickCallback);
+    NVIC_BP_EnableIRQ(NVIC_USART1_IRQ);
+    NVIC_BP_EnableIRQ(NVIC_DMA2_STREAM0_IRQ);
+
+    for (setting = 0; setting < 2; setting++) {
+        FLASH_enuConfigureAccelerator(accel[setting], FLASH_VOLTAGE_2V7_TO_3V6);
+        for (path = 0; path < 3; path++) {
+            ramFuncCycles[path][setting] = ramFuncMeasure(path);
+        }
+    }
+
+    NVIC_BP_DisableIRQ(NVIC_USART1_IRQ);
+    NVIC_BP_DisableIRQ(NVIC_DMA2_STREAM0_IRQ);
+    FLASH_enuConfigureAccelerator(FLASH_ALL_FEATURES, FLASH_VOLTAGE_2V7_TO_3V6);
+
+    for (path = 0; path < 3; path++) {
+        if ((ramFuncCycles[path][0] == 0U) || (ramFuncCycles[path][1] == 0U)) {
+            passed = FALSE;
+        }
+#ifndef RAMFUNC_DISABLE
+        if (TEST_s32ErrorPermille(ramFuncCycles[path][0], ramFuncCycles[path][1]) > RAMF_MAX_PERMILLE) {
+            passed = FALSE;
+        }
+#endif
+    }
+
+    TEST_vdDone(&ramFuncTestDone, passed);
+}
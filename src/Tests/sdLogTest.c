@@ -0,0 +1,152 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/bench.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "HAL/MCU_Driver/mcu.h"
+#include "HAL/SD_Driver/sd.h"
+#include "OS/schedule.h"
+#include "OS/sdlog.h"
+
+#include "test.h"
+
+#define SDLOG_TEST_RECORD_SIZE  (64U)
+#define SDLOG_TEST_RECORDS_MS   (6U)        // 6 x 64 bytes per ms : 384 KB/s
+#define SDLOG_TEST_DURATION_MS  (10000UL)
+
+/**
+ * Logs 64-byte records at 384 KB/s for 10 s on a card on SPI1 (CS on PA4),
+ * the logger runnable every 1 ms.
+ * Read the results from the debugger once sdLogTestDone is set:
+ *   sdStatus               SD_OK (1), sdCardType SD_CARD_V2_HC (3) for an SDHC card
+ *   sdLogStats             SDLOG_RecordsDropped 0 if the card keeps up,
+ *                          SDLOG_BlocksWritten ~7500 and SDLOG_Idle TRUE
+ *   sdLogBytesPerSecond    bytes programmed / time from the first record to SDLOG_Idle
+ *   sdLogAppendMaxCycles   worst SDLOG_enuAppend (copy + seal), ~300 cycles
+ *   sdLogRunnableMaxCycles worst SDLOG_vdRunnable step, the one opening a stream
+ *                          (ACMD23 + CMD25, ~20 bytes at 21 MHz)
+ *   sdLogReadBack          first record of the first block written, read back
+ *                          after the run (bytes 14 .. 77 of the block)
+ * Passes when the card and the logger initialised, every record was accepted
+ * (none dropped) and the read-back record is sequence 0 (bytes 0 .. 63).
+ */
+volatile uint8_t sdLogTestDone = TEST_RUNNING;
+volatile SD_Status_t sdStatus = SD_NOT_OK;
+volatile SD_CardType_t sdCardType = SD_CARD_NONE;
+volatile SDLOG_Status_t sdLogStatus = SDLOG_NOT_OK;
+volatile SDLOG_Stats_t sdLogStats;
+volatile uint32_t sdLogBytesPerSecond = 0;
+volatile uint32_t sdLogAppendMaxCycles = 0;
+volatile uint32_t sdLogRunnableMaxCycles = 0;
+volatile uint8_t sdLogReadBack[SDLOG_TEST_RECORD_SIZE];
+
+static uint32_t sdLogTestHclk = 0;
+static uint32_t sdLogTestFirstBlock = 0;
+static uint32_t sdLogTestStart = 0;
+static uint32_t sdLogTestElapsedMs = 0;
+static uint32_t sdLogTestSequence = 0;
+static uint8_t sdLogTestBlock[SD_BLOCK_SIZE];
+
+// Logger step with its duration
+static void sdLogTestWriter(void* args){
+    uint32_t start = BENCH_u32Start();
+    SDLOG_vdRunnable(args);
+    uint32_t cycles = BENCH_u32Stop(start);
+    if (cycles > sdLogRunnableMaxCycles) {
+        sdLogRunnableMaxCycles = cycles;
+    }
+}
+
+// Sensor side : a sequence number and a pattern derived from it
+static void sdLogTestProducer(void* args){
+    uint8_t record[SDLOG_TEST_RECORD_SIZE];
+    SDLOG_Stats_t stats;
+
+    (void)args;
+    if (sdLogTestElapsedMs < SDLOG_TEST_DURATION_MS) {
+        for (uint8_t n = 0; n < SDLOG_TEST_RECORDS_MS; n++) {
+            for (uint8_t i = 0; i < SDLOG_TEST_RECORD_SIZE; i++) {
+                record[i] = (uint8_t)(sdLogTestSequence + i);
+            }
+            sdLogTestSequence++;
+
+            uint32_t start = BENCH_u32Start();
+            (void)SDLOG_enuAppend(record, SDLOG_TEST_RECORD_SIZE);
+            uint32_t cycles = BENCH_u32Stop(start);
+            if (cycles > sdLogAppendMaxCycles) {
+                sdLogAppendMaxCycles = cycles;
+            }
+        }
+        sdLogTestElapsedMs++;
+        if (sdLogTestElapsedMs == SDLOG_TEST_DURATION_MS) {
+            (void)SDLOG_enuFlush();
+        }
+    } else if (sdLogTestDone == TEST_RUNNING) {
+        (void)SDLOG_enuGetStats(&stats);
+        if (stats.SDLOG_Idle == TRUE) {
+            uint32_t elapsed = BENCH_u32Stop(sdLogTestStart);
+            bool_t passed = FALSE;
+            uint32_t bytes = stats.SDLOG_BlocksWritten * SD_BLOCK_SIZE;
+            // bytes * hclk / cycles without overflowing 32 bits
+            sdLogBytesPerSecond = (uint32_t)(((uint64_t)bytes * sdLogTestHclk) / elapsed);
+            sdLogStats = stats;
+
+            if (SD_enuReadBlock(SDLOG_FIRST_BLOCK + sdLogTestFirstBlock, sdLogTestBlock) == SD_OK) {
+                passed = ((stats.SDLOG_RecordsDropped == 0U)
+                          && (stats.SDLOG_BytesLogged == (sdLogTestSequence * SDLOG_TEST_RECORD_SIZE))) ? TRUE : FALSE;
+                for (uint8_t i = 0; i < SDLOG_TEST_RECORD_SIZE; i++) {
+                    sdLogReadBack[i] = sdLogTestBlock[14U + i];
+                    if (sdLogReadBack[i] != i) {
+                        passed = FALSE;
+                    }
+                }
+            }
+            TEST_vdDone(&sdLogTestDone, passed);
+        }
+    } else {
+        // Done
+    }
+}
+
+static SCHED_Runnable_t sdLogWriterRunnable ={
+    .CBF = sdLogTestWriter,
+    .Periodicity_ms = 1,
+    .FirstDalay_ms = 0,
+    .Args = NULL,
+    .Priority = 1
+};
+
+static SCHED_Runnable_t sdLogProducerRunnable ={
+    .CBF = sdLogTestProducer,
+    .Periodicity_ms = 1,
+    .FirstDalay_ms = 0,
+    .Args = NULL,
+    .Priority = 0
+};
+
+void sdLogTest(void){
+    SD_CardType_t type = SD_CARD_NONE;
+    SDLOG_Stats_t stats;
+
+    sdLogTestHclk = TEST_u32Setup();
+
+    sdStatus = SD_enuInit();
+    (void)SD_enuGetCardType(&type);
+    sdCardType = type;
+    if (sdStatus != SD_OK) {
+        TEST_vdDone(&sdLogTestDone, FALSE);
+    }
+
+    sdLogStatus = SDLOG_enuInit();
+    if (sdLogStatus != SDLOG_OK) {
+        TEST_vdDone(&sdLogTestDone, FALSE);
+    }
+    (void)SDLOG_enuGetStats(&stats);
+    sdLogTestFirstBlock = stats.SDLOG_NextBlock;
+    sdLogTestStart = BENCH_u32Start();
+
+    SCHED_enuInit(1, SCHED_CLOCK_AUTO);
+    SCHED_enuRegisterRunnable(&sdLogWriterRunnable);
+    SCHED_enuRegisterRunnable(&sdLogProducerRunnable);
+
+    SCHED_enuStart();
+}
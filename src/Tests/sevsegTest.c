@@ -10,7 +10,7 @@ void sevsegTest(){
 
     MCU_Status_t mcuStatus = MCU_enuInit(&MCU_Configs);
 
-    SYSTICK_Status_t systickStatus = SYSTICK_Init(16000000UL,SYSTICK_NO_PRESCALLER);
+    SYSTICK_Status_t systickStatus = SYSTICK_Init(SYSTICK_CLOCK_AUTO,SYSTICK_NO_PRESCALLER);
     systickStatus = SYSTICK_SetStartValue(1000UL); // random vlaue for wiat
 
     SYSTICK_StartCount();
@@ -0,0 +1,98 @@
+
+#include "LIB/stdtypes.h"
+#include "HAL/MCU_Driver/mcu.h"
+#include "HAL/LED_Driver/led.h"
+#include "OS/schedule.h"
+#include "OS/stack.h"
+
+#include "test.h"
+
+/**
+ * Stack monitor: a shallow runnable (LED toggle) and a deep one (256 byte
+ * local buffer) run for a while, a third one copies the report.
+ * Read it from the debugger once stackTestDone is set:
+ *   stackReport          reserved size, current depth, high-water mark
+ *   stackReportStatus    STACK_OVERFLOW if the reserved stack is too small
+ *   stackRunnable[0..1]  peak depth of the LED and the deep runnable
+ * stackRunnable[1] - stackRunnable[0] should be a bit more than 256 bytes.
+ * Build with SCHED_STACK_MONITOR = SCHED_STACK_MONITOR_ENABLED (schedule_cfg.h).
+ * Passes when the report is STACK_OK, the high-water mark is within the reserved
+ * stack and the deep runnable peaks at least STACK_TEST_DEEP_BYTES above the LED one.
+ */
+#define STACK_TEST_DEEP_BYTES   (256UL)
+
+volatile uint8_t stackTestDone = TEST_RUNNING;
+volatile STACK_Status_t stackReportStatus = STACK_NOT_OK;
+volatile STACK_Usage_t stackReport;
+volatile uint32_t stackRunnable[2] = {0};
+
+static void stackShallow(void* args){
+    (void)args;
+    LED_vdToggle(BLACK_PILL_LED);
+}
+
+static void stackDeep(void* args){
+    volatile uint8_t buffer[256];
+    uint16_t index;
+    (void)args;
+
+    for (index = 0; index < sizeof(buffer); index++) {
+        buffer[index] = (uint8_t)index;
+    }
+}
+
+static void stackCopyReport(void* args){
+    STACK_Usage_t usage;
+    uint32_t depth = 0;
+    (void)args;
+
+    stackReportStatus = STACK_enuGetUsage(&usage);
+    stackReport = usage;
+
+    SCHED_enuGetRunnableStackUsage(0, &depth);
+    stackRunnable[0] = depth;
+    SCHED_enuGetRunnableStackUsage(1, &depth);
+    stackRunnable[1] = depth;
+
+    TEST_vdDone(&stackTestDone, ((stackReportStatus == STACK_OK)
+                                 && (stackReport.STACK_HighWater <= stackReport.STACK_Size)
+                                 && (stackRunnable[1] >= (stackRunnable[0] + STACK_TEST_DEEP_BYTES))) ? TRUE : FALSE);
+}
+
+static SCHED_Runnable_t stackShallowRunnable ={
+    .CBF = stackShallow,
+    .Periodicity_ms = 100,
+    .FirstDalay_ms = 0,
+    .Args = NULL,
+    .Priority = 0
+};
+
+static SCHED_Runnable_t stackDeepRunnable ={
+    .CBF = stackDeep,
+    .Periodicity_ms = 250,
+    .FirstDalay_ms = 10,
+    .Args = NULL,
+    .Priority = 1
+};
+
+static SCHED_Runnable_t stackReportRunnable ={
+    .CBF = stackCopyReport,
+    .Periodicity_ms = 1000,
+    .FirstDalay_ms = 1000,
+    .Args = NULL,
+    .Priority = 2
+};
+
+void stackMonitorTest(void){
+    // The stack was painted first thing in main
+
+    MCU_enuInit(&MCU_Configs);
+    LED_vdInit();
+
+    SCHED_enuInit(1, SCHED_CLOCK_AUTO);
+    SCHED_enuRegisterRunnable(&stackShallowRunnable);
+    SCHED_enuRegisterRunnable(&stackDeepRunnable);
+    SCHED_enuRegisterRunnable(&stackReportRunnable);
+
+    SCHED_enuStart();
+}
@@ -19,7 +19,7 @@ static SCHED_Runnable_t testSwitchRunnable ={
 void SwitchTest(){
     MCU_Status_t mcuStatus = MCU_enuInit(&MCU_Configs);
 
-    SCHED_enuInit(1,16000000UL);
+    SCHED_enuInit(1,SCHED_CLOCK_AUTO);
     
     LED_Status_t ledStat =  LED_vdInit();
 
@@ -0,0 +1,39 @@
+#include "LIB/stdtypes.h"
+#include "LIB/bench.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "HAL/MCU_Driver/mcu.h"
+
+#include "test.h"
+
+uint32_t TEST_u32Setup(void){
+    uint32_t clockHz = 0;
+
+    MCU_enuInit(&MCU_Configs);
+    (void)BENCH_enuInit();
+    (void)RCC_GetClockHz(RCC_AHB1_BUS, &clockHz);
+
+    return clockHz;
+}
+
+void TEST_vdDone(volatile uint8_t *doneFlag, bool_t passed){
+    *doneFlag = (passed == TRUE) ? TEST_PASSED : TEST_FAILED;
+
+    while (1);
+}
+
+uint32_t TEST_u32CyclesToNs(uint32_t cycles, uint32_t clockHz){
+    return (clockHz != 0) ? (uint32_t)(((uint64_t)cycles * 1000000000ULL) / clockHz) : 0;
+}
+
+uint32_t TEST_u32CyclesToUs(uint32_t cycles, uint32_t clockHz){
+    return (clockHz != 0) ? (uint32_t)(((uint64_t)cycles * 1000000ULL) / clockHz) : 0;
+}
+
+sint32_t TEST_s32ErrorPermille(uint32_t measured, uint32_t reference){
+    sint32_t error = 0;
+
+    if (reference != 0) {
+        error = (sint32_t)((((sint64_t)measured - (sint64_t)reference) * 1000) / (sint64_t)reference);
+    }
+    return error;
+}
@@ -11,7 +11,7 @@ void LcdTest()
     MCU_Status_t mcuStatus = MCU_enuInit(NULL);
 
     SYSTICK_Status_t SistickStatus;
-    SistickStatus = SYSTICK_Init(16000000UL, SYSTICK_NO_PRESCALLER);
+    SistickStatus = SYSTICK_Init(SYSTICK_CLOCK_AUTO, SYSTICK_NO_PRESCALLER);
     SistickStatus = SYSTICK_SetStartValue(10000);
     SYSTICK_StartCount();
 
@@ -0,0 +1,171 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/bench.h"
+#include "MCAL/UART_Driver/uart.h"
+#include "MCAL/SPI_Driver/spi.h"
+#include "MCAL/SYSTICK_TIMER_Driver/systick.h"
+
+#include "test.h"
+
+#define TIMING_TEST_FRAMES          (64U)
+#define TIMING_TEST_TICKS           (16U)
+
+// The line time is a floor the transfer cannot beat (DWT and baud rounding aside),
+// the software gap between frames stays below one frame
+#define TIMING_TEST_MIN_PERMILLE    (-20)
+#define TIMING_TEST_MAX_PERMILLE    (1000)
+
+typedef enum {
+    TIMING_TEST_UART_115200,
+    TIMING_TEST_UART_2M_OVER8,
+    TIMING_TEST_UART_9B_2STOP,
+    TIMING_TEST_SPI_DIV8,
+    TIMING_TEST_SPI_DIV32_16BIT,
+    TIMING_TEST_SYSTICK_HCLK,       /* 1 ms reload on HCLK */
+    TIMING_TEST_SYSTICK_HCLK_DIV8,  /* Same reload on HCLK / 8 : 8 ms */
+    TIMING_TEST_CASES
+}TIMING_TestCase_t;
+
+/**
+ * Frame times predicted from the registers against the DWT measurement of
+ * TIMING_TEST_FRAMES back-to-back frames (synchronous drivers, 84 MHz), and
+ * the SysTick period against TIMING_TEST_TICKS exceptions:
+ *   timingPredictedNs[case]   TIMING_TEST_FRAMES * UART_enuGetFrameTime / SPI_enuGetFrameTime,
+ *                             TIMING_TEST_TICKS * SYSTICK_GetPeriod
+ *   timingMeasuredNs[case]    the same transfer timed with BENCH_u32Start / BENCH_u32Stop
+ *   timingErrorPermille[case] (measured - predicted) * 1000 / predicted
+ * in TIMING_TestCase_t order. UART on USART6 (PC6), SPI on SPI2 (PB13..PB15).
+ * The synchronous drivers wait for TC / RXNE before the next frame, the error
+ * is that software gap : a few per-mille at 115200, more at 2 Mbaud and at DIV8.
+ * The SysTick cases are timed from one exception to another, the error stays
+ * within a few cycles of entry jitter.
+ * Passes when every error is within TIMING_TEST_MIN_PERMILLE .. TIMING_TEST_MAX_PERMILLE.
+ */
+volatile uint8_t timingTestDone = 0;
+volatile uint32_t timingPredictedNs[TIMING_TEST_CASES] = {0};
+volatile uint32_t timingMeasuredNs[TIMING_TEST_CASES] = {0};
+volatile sint32_t timingErrorPermille[TIMING_TEST_CASES] = {0};
+
+static uint8_t timingTxBuffer[TIMING_TEST_FRAMES];
+static uint32_t timingCoreHz = 0;
+static volatile uint32_t timingTicks = 0;
+
+static void timingTestStore(TIMING_TestCase_t testCase, uint32_t frameNs, uint32_t frames, uint32_t cycles){
+    uint32_t predicted = frameNs * frames;
+    uint32_t measured = TEST_u32CyclesToNs(cycles, timingCoreHz);
+
+    timingPredictedNs[testCase] = predicted;
+    timingMeasuredNs[testCase] = measured;
+    timingErrorPermille[testCase] = TEST_s32ErrorPermille(measured, predicted);
+}
+
+static void timingTestUart(TIMING_TestCase_t testCase, uint32_t baudRate, UART_OverSampling_t overSampling,
+                           UART_WordLength_t wordLength, UART_StopBit_t stopBits){
+    UART_Config_t uartConfig;
+    uint32_t frameNs = 0;
+    uint32_t start;
+
+    uartConfig.UART_Number = UART_6;
+    uartConfig.UartEnabled = UART_ENABLE_TRANSMITE;
+    uartConfig.Parity = UART_PARITY_NONE;
+    uartConfig.OverSampling = overSampling;
+    uartConfig.StopBits = stopBits;
+    uartConfig.WordLength = wordLength;
+    uartConfig.Sample = UART_THREE_SAMPLE;
+    uartConfig.InterruptFlags = 0;
+    uartConfig.PeripheralClock = UART_PERIPHERAL_CLOCK_AUTO;
+    uartConfig.BaudRate = baudRate;
+    (void)UART_enuInit(&uartConfig);
+    (void)UART_enuGetFrameTime(UART_6, &frameNs);
+
+    // First frame written to an empty shift register, the last one waited out (TC)
+    start = BENCH_u32Start();
+    (void)UART_enuSynTransmitBuffer(UART_6, timingTxBuffer, TIMING_TEST_FRAMES);
+    timingTestStore(testCase, frameNs, TIMING_TEST_FRAMES, BENCH_u32Stop(start));
+
+    (void)UART_enuDeInit(UART_6);
+}
+
+static void timingTestSpi(TIMING_TestCase_t testCase, SPI_BaudRate_t baudRate, SPI_DataLength_t dataLength){
+    SPI_Config_t spiConfig;
+    uint32_t frameNs = 0;
+    uint32_t start;
+    uint16_t rxData;
+    uint16_t i;
+
+    spiConfig.spiNumber         = SPI2;
+    spiConfig.communicationMode = SPI_FULL_DUPLEX;
+    spiConfig.mode              = SPI_MASTER;
+    spiConfig.crcState          = SPI_CRC_DISABLED;
+    spiConfig.dataLength        = dataLength;
+    spiConfig.dataOrder         = SPI_MSB_FIRST;
+    spiConfig.baudRate          = baudRate;
+    spiConfig.polarityPhase     = SPI_ONE_IDLE_FIRST_EDGE;
+    spiConfig.frameFormat       = SPI_MOTOROLA;
+    spiConfig.dmaState          = SPI_DISABLE_DMA;
+    spiConfig.nssManagement     = SPI_NSS_MASTER_SW;
+    spiConfig.slavesConfig.numberOfSlaves = 0;
+    (void)SPI_enuInit(&spiConfig);
+    (void)SPI_enuGetFrameTime(SPI2, &frameNs);
+
+    start = BENCH_u32Start();
+    for (i = 0; i < TIMING_TEST_FRAMES; i++) {
+        (void)SPI_enuMasterSyncTransmitReceive(SPI2, timingTxBuffer[i], &rxData);
+    }
+    timingTestStore(testCase, frameNs, TIMING_TEST_FRAMES, BENCH_u32Stop(start));
+
+    (void)SPI_enuDeInit(SPI2);
+}
+
+static void timingTestTick(void){
+    timingTicks++;
+}
+
+static void timingTestSysTick(TIMING_TestCase_t testCase, SYSTICK_Prescaller_t prescaler){
+    uint32_t periodNs = 0;
+    uint32_t start;
+
+    (void)SYSTICK_Init(SYSTICK_CLOCK_AUTO, prescaler);
+    (void)SYSTICK_SetCallBack(timingTestTick);
+    (void)SYSTICK_SetStartValue((timingCoreHz / 1000UL) - 1UL);
+    (void)SYSTICK_GetPeriod(&periodNs);
+
+    // Timed from one exception to another, the partial first period left out
+    timingTicks = 0;
+    SYSTICK_StartCount();
+    while (timingTicks == 0);
+    start = BENCH_u32Start();
+    while (timingTicks < (TIMING_TEST_TICKS + 1U));
+    timingTestStore(testCase, periodNs, TIMING_TEST_TICKS, BENCH_u32Stop(start));
+
+    SYSTICK_StopCount();
+    (void)SYSTICK_SetCallBack(NULL);
+}
+
+void timingModelTest(void){
+    bool_t passed = TRUE;
+    uint16_t i;
+
+    timingCoreHz = TEST_u32Setup();
+
+    for (i = 0; i < TIMING_TEST_FRAMES; i++) {
+        timingTxBuffer[i] = (uint8_t)(0x30U + (i % 10U));
+    }
+
+    timingTestUart(TIMING_TEST_UART_115200, 115200UL, UART_OVERSAMPLING_16, UART_WORDLENGTH_8B, UART_STOPBITS_1);
+    timingTestUart(TIMING_TEST_UART_2M_OVER8, 2000000UL, UART_OVERSAMPLING_8, UART_WORDLENGTH_8B, UART_STOPBITS_1);
+    timingTestUart(TIMING_TEST_UART_9B_2STOP, 115200UL, UART_OVERSAMPLING_16, UART_WORDLENGTH_9B, UART_STOPBITS_2);
+    timingTestSpi(TIMING_TEST_SPI_DIV8, SPI_BAUDRATE_DIV8, SPI_8_BIT_DATA);
+    timingTestSpi(TIMING_TEST_SPI_DIV32_16BIT, SPI_BAUDRATE_DIV32, SPI_16_BIT_DATA);
+    timingTestSysTick(TIMING_TEST_SYSTICK_HCLK, SYSTICK_NO_PRESCALLER);
+    timingTestSysTick(TIMING_TEST_SYSTICK_HCLK_DIV8, SYSTICK_PRESCALLER_8);
+
+    for (i = 0; i < TIMING_TEST_CASES; i++) {
+        if ((timingPredictedNs[i] == 0U) || (timingErrorPermille[i] < TIMING_TEST_MIN_PERMILLE)
+            || (timingErrorPermille[i] > TIMING_TEST_MAX_PERMILLE)) {
+            passed = FALSE;
+        }
+    }
+
+    TEST_vdDone(&timingTestDone, passed);
+}
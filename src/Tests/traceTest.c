@@ -0,0 +1,107 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/bench.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "HAL/MCU_Driver/mcu.h"
+#include "HAL/HSERIAL_Driver/hserial.h"
+#include "OS/schedule.h"
+#include "OS/trace.h"
+
+#include "test.h"
+
+#define TRACE_TEST_RECORDS      (32U)
+#define TRACE_TEST_DURATION_MS  (5000UL)
+#define TRACE_TEST_MAX_CYCLES   (50U)       // one TRACE_vdRecord
+
+/**
+ * Traces the scheduler, SysTick and the tracer's own UART / DMA traffic for 5 s.
+ * Needs TRACE = TRACE_ENABLED, which adds HSERIAL_CHANNEL_TRACE (USART6 DMA at
+ * 921600 baud, TRACE_vdTxComplete as HSERIAL_UartTxCompleteCallback),
+ * the PC captures USART6 TX (PC6) to a file.
+ * Read the results from the debugger once traceTestDone is set:
+ *   traceRecordCycles      one TRACE_vdRecord call, ~20 cycles from RAM
+ *   traceRunnableMaxCycles worst TRACE_vdRunnable step (starting a transfer)
+ *   traceStats             TRACE_Dropped 0, TRACE_Sent equal to TRACE_Recorded once drained
+ * Passes when nothing was dropped, every record was sent, at least the test's own
+ * records were recorded and one record costs at most TRACE_TEST_MAX_CYCLES.
+ */
+volatile uint8_t traceTestDone = TEST_RUNNING;
+volatile TRACE_Status_t traceStatus = TRACE_NOT_OK;
+volatile uint32_t traceRecordCycles = 0;
+volatile uint32_t traceRunnableMaxCycles = 0;
+volatile TRACE_Stats_t traceStats;
+
+static uint32_t traceTestElapsedMs = 0;
+
+// Tracer step with its duration
+static void traceTestDrain(void* args){
+    uint32_t start = BENCH_u32Start();
+    TRACE_vdRunnable(args);
+    uint32_t cycles = BENCH_u32Stop(start);
+    if (cycles > traceRunnableMaxCycles) {
+        traceRunnableMaxCycles = cycles;
+    }
+}
+
+// Application side : a user event every ms, the stats at the end
+static void traceTestWorker(void* args){
+    TRACE_Stats_t stats;
+
+    (void)args;
+    if (traceTestElapsedMs < TRACE_TEST_DURATION_MS) {
+        TRACE_EVENT(TRACE_EVENT_USER, traceTestElapsedMs);
+        traceTestElapsedMs++;
+        if (traceTestElapsedMs == TRACE_TEST_DURATION_MS) {
+            TRACE_vdStop();
+        }
+    } else if (traceTestDone == TEST_RUNNING) {
+        (void)TRACE_enuGetStats(&stats);
+        if (stats.TRACE_Pending == 0) {
+            traceStats = stats;
+            TEST_vdDone(&traceTestDone, ((stats.TRACE_Dropped == 0U) && (stats.TRACE_Sent == stats.TRACE_Recorded)
+                                         && (stats.TRACE_Recorded >= (TRACE_TEST_RECORDS + TRACE_TEST_DURATION_MS))
+                                         && (traceRecordCycles <= TRACE_TEST_MAX_CYCLES)) ? TRUE : FALSE);
+        }
+    } else {
+        // Done
+    }
+}
+
+static SCHED_Runnable_t traceWorkerRunnable ={
+    .CBF = traceTestWorker,
+    .Periodicity_ms = 1,
+    .FirstDalay_ms = 0,
+    .Args = NULL,
+    .Priority = 0
+};
+
+static SCHED_Runnable_t traceDrainRunnable ={
+    .CBF = traceTestDrain,
+    .Periodicity_ms = 10,
+    .FirstDalay_ms = 0,
+    .Args = NULL,
+    .Priority = 9
+};
+
+void traceTest(void){
+    (void)TEST_u32Setup();
+    HSERIAL_enuInit();
+
+    traceStatus = TRACE_enuStart();
+    if (traceStatus != TRACE_OK) {
+        TEST_vdDone(&traceTestDone, FALSE);
+    }
+
+    // Back to back records, the cost of one (they go out with the rest)
+    uint32_t start = BENCH_u32Start();
+    for (uint32_t i = 0; i < TRACE_TEST_RECORDS; i++) {
+        TRACE_vdRecord(TRACE_EVENT_USER, (uint16_t)i);
+    }
+    traceRecordCycles = BENCH_u32Stop(start) / TRACE_TEST_RECORDS;
+
+    SCHED_enuInit(1, SCHED_CLOCK_AUTO);
+    SCHED_enuRegisterRunnable(&traceWorkerRunnable);
+    SCHED_enuRegisterRunnable(&traceDrainRunnable);
+
+    SCHED_enuStart();
+}
@@ -1,6 +1,7 @@
 
 
 #include <LIB/stdtypes.h>
+#include "MCAL/RCC_Driver/rcc_int.h"
 #include "HAL/MCU_Driver/mcu.h"
 #include "MCAL/UART_Driver/uart.h"
 #include "MCAL/NVIC_Driver/nvic_stm32f401cc.h"
@@ -32,12 +33,12 @@ void uartTest(){
     uartConfig.WordLength = UART_WORDLENGTH_8B; // 8 bits
     uartConfig.Sample = UART_THREE_SAMPLE; // 3 samples
     uartConfig.InterruptFlags = UART_INTERRUPT_RXNE; // No interrupts
-    uartConfig.PeripheralClock = 16000000UL;
+    uartConfig.PeripheralClock = UART_PERIPHERAL_CLOCK_AUTO;
     uartConfig.BaudRate = 4800UL;
     
     MCU_enuInit(&MCU_Configs);
 
-    NVIC_BP_SetPriority(NVIC_USART1_IRQ, 1);
+    NVIC_BP_SetPriority(NVIC_USART1_IRQ, NVIC_PRIORITY_5);
     NVIC_BP_EnableIRQ(NVIC_USART1_IRQ);
 
     UART_enuInit(&uartConfig);
@@ -107,4 +108,158 @@ void uartRxCallBack(void){
 void uartTxCallBack(void){
     int b = 0;
     UART_enuAsynReceiveBuffer(UART_1, &rxbuffer);
-}
\ No newline at end of file
+}
+
+#define UART_SCALING_TEST_SWITCHES      (10U)
+#define UART_SCALING_TEST_FRAME_NS      (86806UL)     // 10 bits at 115200 baud
+#define UART_SCALING_TEST_MAX_PERMILLE  (20)
+
+/**
+ * Switches between 16MHZ (HSI) and 84MHZ (PLL) while sending on UART1.
+ * The text must stay readable on the terminal after every switch,
+ * which means BRR was re-timed by the clock change notifier.
+ * uartScalingErrorPermille[i] is the frame time read back from BRR after switch i
+ * against 115200 baud.
+ * An 84MHZ profile with APB1 not divided (PCLK1 above 42MHZ) must be refused first.
+ * Passes when every switch succeeds and every error is within +/- UART_SCALING_TEST_MAX_PERMILLE.
+ */
+volatile uint8_t uartScalingTestDone = TEST_RUNNING;
+volatile sint32_t uartScalingErrorPermille[UART_SCALING_TEST_SWITCHES] = {0};
+
+void uartClockScalingTest(){
+    const char* message = "Same baud at any SYSCLK\r\n";
+    const MCU_ClockProfile_t lowPower = {
+        .MCU_SystemClockSource  = MCU_SYSCLK_HSI,
+        .MCU_AHP_Prescaler      = MCU_AHB_NO_DIVISION,
+        .MCU_APB1_Prescaler     = MCU_APB1_NO_DIVISION,
+        .MCU_APB2_Prescaler     = MCU_APB2_NO_DIVISION
+    };
+    const MCU_ClockProfile_t boost = {
+        .MCU_SystemClockSource  = MCU_SYSCLK_PLL,
+        .MCU_PLLClockSource     = MCU_PLL_SOURCE_HSI,
+        .MCU_PLLTargetFrequency = 84000000UL,
+        .MCU_AHP_Prescaler      = MCU_AHB_NO_DIVISION,
+        .MCU_APB1_Prescaler     = MCU_APB1_DIVIDED_BY_2,      // APB1 max 42MHZ
+        .MCU_APB2_Prescaler     = MCU_APB2_NO_DIVISION
+    };
+    const MCU_ClockProfile_t overclocked = {
+        .MCU_SystemClockSource  = MCU_SYSCLK_PLL,
+        .MCU_PLLClockSource     = MCU_PLL_SOURCE_HSI,
+        .MCU_PLLTargetFrequency = 84000000UL,
+        .MCU_AHP_Prescaler      = MCU_AHB_NO_DIVISION,
+        .MCU_APB1_Prescaler     = MCU_APB1_NO_DIVISION,       // PCLK1 = 84MHZ
+        .MCU_APB2_Prescaler     = MCU_APB2_NO_DIVISION
+    };
+    UART_Config_t uartConfig;
+    bool_t passed = TRUE;
+    uint32_t frameNs = 0;
+    uint8_t useBoost = 0;
+    uint8_t repeat;
+    uint8_t i;
+
+    uartConfig.UART_Number = UART_1;
+    uartConfig.UartEnabled = UART_ENABLE_TRANSMITE|UART_ENABLE_RECEIVE;
+    uartConfig.Parity = UART_PARITY_NONE;
+    uartConfig.OverSampling = UART_OVERSAMPLING_16;
+    uartConfig.StopBits = UART_STOPBITS_1;
+    uartConfig.WordLength = UART_WORDLENGTH_8B;
+    uartConfig.Sample = UART_THREE_SAMPLE;
+    uartConfig.InterruptFlags = 0;
+    uartConfig.PeripheralClock = UART_PERIPHERAL_CLOCK_AUTO;
+    uartConfig.BaudRate = 115200UL;
+
+    MCU_enuInit(&MCU_Configs);
+    UART_enuInit(&uartConfig);
+
+    if (MCU_enuSetClockProfile(&overclocked) != MCU_WRONG_APB_PRESCALER) {
+        passed = FALSE;
+    }
+
+    for (i = 0; i < UART_SCALING_TEST_SWITCHES; i++)
+    {
+        for (repeat = 0; repeat < 10; repeat++) {
+            UART_enuSynTransmitBuffer(UART_1, (const uint8_t*)message, sizeof("Same baud at any SYSCLK\r\n") - 1);
+        }
+        useBoost ^= 1;
+        if (MCU_enuSetClockProfile(useBoost ? &boost : &lowPower) != MCU_OK) {
+            passed = FALSE;
+        }
+        if (UART_enuGetFrameTime(UART_1, &frameNs) != UART_OK) {
+            passed = FALSE;
+        }
+        uartScalingErrorPermille[i] = TEST_s32ErrorPermille(frameNs, UART_SCALING_TEST_FRAME_NS);
+        if ((uartScalingErrorPermille[i] > UART_SCALING_TEST_MAX_PERMILLE)
+            || (uartScalingErrorPermille[i] < -UART_SCALING_TEST_MAX_PERMILLE)) {
+            passed = FALSE;
+        }
+    }
+
+    TEST_vdDone(&uartScalingTestDone, passed);
+}
+
+#define UART_GATING_TEST_CYCLES         (10U)
+
+/**
+ * UART1 clock is acquired by UART_enuInit and released by UART_enuDeInit,
+ * nothing is clocked while the UART is parked. Read from the debugger:
+ *   uartGatingRefCount[0]  USART1 owners after init   (1)
+ *   uartGatingRefCount[1]  USART1 owners after deinit (0)
+ *   uartGatingTransitions  gate on/off writes of the whole loop
+ *                          (2 per cycle, GPIOA stays pinned by MCU_Configs)
+ * Passes when every cycle sees 1 then 0 owners and the loop made exactly
+ * 2 gate writes per cycle.
+ */
+volatile uint8_t uartGatingTestDone = TEST_RUNNING;
+volatile uint8_t uartGatingRefCount[2] = {0};
+volatile uint32_t uartGatingTransitions = 0;
+
+void uartClockGatingTest(){
+    const char* message = "UART clocked on demand\r\n";
+    UART_Config_t uartConfig;
+    bool_t passed = TRUE;
+    uint32_t transitionsBefore;
+    uint8_t refCount = 0;
+    uint32_t delay;
+    uint8_t i;
+
+    uartConfig.UART_Number = UART_1;
+    uartConfig.UartEnabled = UART_ENABLE_TRANSMITE;
+    uartConfig.Parity = UART_PARITY_NONE;
+    uartConfig.OverSampling = UART_OVERSAMPLING_16;
+    uartConfig.StopBits = UART_STOPBITS_1;
+    uartConfig.WordLength = UART_WORDLENGTH_8B;
+    uartConfig.Sample = UART_THREE_SAMPLE;
+    uartConfig.InterruptFlags = 0;
+    uartConfig.PeripheralClock = UART_PERIPHERAL_CLOCK_AUTO;
+    uartConfig.BaudRate = 115200UL;
+
+    MCU_enuInit(&MCU_Configs);
+    transitionsBefore = RCC_GetPeripheralClockTransitions();
+
+    for (i = 0; i < UART_GATING_TEST_CYCLES; i++)
+    {
+        UART_enuInit(&uartConfig);
+        RCC_GetPeripheralClockRefCount(RCC_APB2_BUS, RCC_APB2_USART1_CLOCK, &refCount);
+        uartGatingRefCount[0] = refCount;
+
+        UART_enuSynTransmitBuffer(UART_1, (const uint8_t*)message, sizeof("UART clocked on demand\r\n") - 1);
+
+        UART_enuDeInit(UART_1);
+        RCC_GetPeripheralClockRefCount(RCC_APB2_BUS, RCC_APB2_USART1_CLOCK, &refCount);
+        uartGatingRefCount[1] = refCount;
+        uartGatingTransitions = RCC_GetPeripheralClockTransitions() - transitionsBefore;
+
+        if ((uartGatingRefCount[0] != 1U) || (uartGatingRefCount[1] != 0U)) {
+            passed = FALSE;
+        }
+
+        // Idle with USART1 gated off
+        for (delay = 0; delay < 1000000UL; delay++);
+    }
+
+    if (uartGatingTransitions != (2UL * UART_GATING_TEST_CYCLES)) {
+        passed = FALSE;
+    }
+
+    TEST_vdDone(&uartGatingTestDone, passed);
+}
@@ -0,0 +1,76 @@
+
+#include "LIB/stdtypes.h"
+#include "LIB/bench.h"
+#include "MCAL/RCC_Driver/rcc_int.h"
+#include "HAL/MCU_Driver/mcu.h"
+#include "HAL/HSERIAL_Driver/hserial.h"
+#include "OS/update.h"
+
+#include "test.h"
+
+/**
+ * Firmware update over UART DMA.
+ * Needs HSERIAL_CHANNEL_1 in HSERIAL_MODE_UART_DMA at 1000000 baud (hserial_cfg.c)
+ * and a host on PA9/PA10 that:
+ *   1. waits for 'R' (the slot erase takes 1-2 s)
+ *   2. sends the 16 byte UPD_Header_t then the image (the application part of
+ *      the .bin, from 0x08010000), padded with 0xFF to a multiple of UPD_CHUNK_SIZE
+ *   3. reads 'K' (committed) or 'E'
+ * Read the results from the debugger once updTestDone is set:
+ *   updStatus          UPD_OK (1)
+ *   updReceived        image size
+ *   updCycles          HCLK cycles from the first chunk to the commit
+ *   updBytesPerSecond  ~100000 at 1 Mbaud when programming keeps up
+ * Set updInstall to 1 after the verdict to reset into the bootloader and run the new image
+ * Passes when the image was committed (UPD_OK) and every byte of it was received.
+ */
+volatile uint8_t updTestDone = TEST_RUNNING;
+volatile uint8_t updInstall = 0;
+volatile UPD_Status_t updStatus = UPD_NOT_OK;
+volatile uint32_t updReceived = 0;
+volatile uint32_t updImageSize = 0;
+volatile uint32_t updCycles = 0;
+volatile uint32_t updBytesPerSecond = 0;
+
+void firmwareUpdateTest(void){
+    UPD_Status_t status;
+    uint32_t received = 0;
+    uint32_t imageSize = 0;
+    uint32_t start = 0;
+    bool_t timing = FALSE;
+    uint32_t hclk;
+
+    hclk = TEST_u32Setup();
+    HSERIAL_enuInit();
+
+    status = UPD_enuStart();
+    while (status == UPD_OK || status == UPD_BUSY) {
+        status = UPD_enuProcess();
+        UPD_enuGetProgress(&received, &imageSize);
+        if ((timing == FALSE) && (received != 0)) {
+            start = BENCH_u32Start();
+            timing = TRUE;
+        }
+        updReceived = received;
+        updImageSize = imageSize;
+        if (status == UPD_OK) {
+            break;
+        }
+    }
+
+    if (timing == TRUE) {
+        updCycles = BENCH_u32Stop(start);
+    }
+    if ((updCycles != 0) && (hclk != 0)) {
+        updBytesPerSecond = (uint32_t)(((uint64_t)received * hclk) / updCycles);
+    }
+    updStatus = status;
+    // Verdict stored without TEST_vdDone : the core must stay free for updInstall
+    updTestDone = ((status == UPD_OK) && (imageSize != 0) && (received == imageSize)) ? TEST_PASSED : TEST_FAILED;
+
+    while (1) {
+        if (updInstall == 1) {
+            UPD_enuInstall();
+        }
+    }
+}
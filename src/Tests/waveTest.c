@@ -0,0 +1,119 @@
+
+#include "LIB/stdtypes.h"
+#include "MCAL/GPIO_Driver/gpio_int.h"
+#include "HAL/LCD_Driver/lcd.h"
+#include "OS/wave.h"
+
+#include "test.h"
+
+#define WAVE_TEST_VCD_SIZE          (4096U)
+#define WAVE_TEST_PWM_PERIODS       (8U)
+
+// Software PWM duty : 1000 / (1000 + 3000) loops, loop overhead aside
+#define WAVE_TEST_DUTY_MIN          (20U)
+#define WAVE_TEST_DUTY_MAX          (30U)
+
+typedef enum {
+    WAVE_TEST_LCD_RS,
+    WAVE_TEST_LCD_EN,
+    WAVE_TEST_LCD_DB4,
+    WAVE_TEST_LCD_DB5,
+    WAVE_TEST_LCD_DB6,
+    WAVE_TEST_LCD_DB7,
+    WAVE_TEST_PWM,
+    WAVE_TEST_SIGNALS
+}WAVE_TestSignal_t;
+
+static const WAVE_Signal_t waveTestSignals[WAVE_TEST_SIGNALS] = {
+    { "LCD_RS",  GPIO_PORT_A, GPIO_PIN_0  },
+    { "LCD_EN",  GPIO_PORT_A, GPIO_PIN_2  },
+    { "LCD_DB4", GPIO_PORT_A, GPIO_PIN_7  },
+    { "LCD_DB5", GPIO_PORT_A, GPIO_PIN_8  },
+    { "LCD_DB6", GPIO_PORT_A, GPIO_PIN_9  },
+    { "LCD_DB7", GPIO_PORT_A, GPIO_PIN_10 },
+    { "PWM",     GPIO_PORT_C, GPIO_PIN_13 }
+};
+
+/**
+ * Build with WAVE WAVE_ENABLED (wave_cfg.h). Captures the LCD (4-bit mode, lcd_cfg.c)
+ * writing "AB", then a software PWM of 25 % duty on PC13 :
+ *   waveEnable     EN pulses : WAVE_MinHighNs must stay above 450 ns (HD44780 PWEH)
+ *   wavePwm        PC13 : WAVE_HighNs * 100 / WAVE_PeriodNs close to 25
+ *   waveEnableOk   1 when the shortest EN pulse is long enough
+ * waveVcd holds the VCD file (waveVcdLength bytes) once waveTestDone is 1,
+ * dump it from the debugger to a .vcd file and open it in GTKWave.
+ * Passes when the VCD was exported, waveEnableOk is 1 and the PWM duty is
+ * within WAVE_TEST_DUTY_MIN .. WAVE_TEST_DUTY_MAX %.
+ */
+volatile uint8_t waveTestDone = 0;
+volatile WAVE_Status_t waveStatus = WAVE_NOT_OK;
+volatile uint8_t waveEnableOk = 0;
+WAVE_Measure_t waveEnable;
+WAVE_Measure_t wavePwm;
+uint8_t waveVcd[WAVE_TEST_VCD_SIZE];
+volatile uint16_t waveVcdLength = 0;
+
+static void waveTestOutput(const uint8_t *line, uint16_t length){
+    for (uint16_t i = 0; (i < length) && (waveVcdLength < WAVE_TEST_VCD_SIZE); i++) {
+        waveVcd[waveVcdLength++] = line[i];
+    }
+}
+
+static void waveTestDelay(volatile uint32_t loops){
+    while (loops-- > 0);
+}
+
+static bool_t waveTestPassed(void){
+    bool_t passed = FALSE;
+
+    if ((waveStatus == WAVE_OK) && (waveEnableOk == 1U) && (wavePwm.WAVE_PeriodNs != 0U) && (waveVcdLength != 0U)) {
+        uint32_t duty = (uint32_t)(((uint64_t)wavePwm.WAVE_HighNs * 100U) / wavePwm.WAVE_PeriodNs);
+        passed = ((duty >= WAVE_TEST_DUTY_MIN) && (duty <= WAVE_TEST_DUTY_MAX)) ? TRUE : FALSE;
+    }
+    return passed;
+}
+
+void waveTest(void){
+    GPIO_cfg_t pwmPin = {
+        .port = GPIO_PORT_C,
+        .pin = GPIO_PIN_13,
+        .mode = GPIO_MODE_OUTPUT,
+        .outputType = GPIO_OUTPUT_TYPE_PUSH_PULL,
+        .speed = GPIO_SPEED_HIGH,
+        .pull = GPIO_NO_PULL,
+        .alternateFunction = GPIO_AF0
+    };
+    uint8_t period;
+
+    (void)TEST_u32Setup();
+    (void)GPIO_enuInit(&pwmPin);
+    (void)GPIO_enuSetPinVal(GPIO_PORT_C, GPIO_PIN_13, GPIO_LOW);
+    (void)LCD_enuSynInit();
+
+    waveStatus = WAVE_enuStart(waveTestSignals, WAVE_TEST_SIGNALS);
+    if (waveStatus == WAVE_OK) {
+        (void)LCD_enuSyncWriteCharacter('A');
+        (void)LCD_enuSyncWriteCharacter('B');
+
+        for (period = 0; period < WAVE_TEST_PWM_PERIODS; period++) {
+            (void)GPIO_enuFlipPinVal(GPIO_PORT_C, GPIO_PIN_13);
+            waveTestDelay(1000);
+            (void)GPIO_enuFlipPinVal(GPIO_PORT_C, GPIO_PIN_13);
+            waveTestDelay(3000);
+        }
+        WAVE_vdStop();
+
+        waveStatus = WAVE_enuMeasure(WAVE_TEST_LCD_EN, &waveEnable);
+        if (waveStatus == WAVE_OK) {
+            waveStatus = WAVE_enuMeasure(WAVE_TEST_PWM, &wavePwm);
+        }
+        if ((waveStatus == WAVE_OK) && (waveEnable.WAVE_Edges != 0) && (waveEnable.WAVE_MinHighNs >= 450U)) {
+            waveEnableOk = 1;
+        }
+        if (waveStatus == WAVE_OK) {
+            waveStatus = WAVE_enuExportVcd(waveTestOutput);
+        }
+    }
+
+    TEST_vdDone(&waveTestDone, waveTestPassed());
+}
@@ -1,4 +1,5 @@
 
+#include "OS/stack.h"
 #include "test.h"
 
 
@@ -6,6 +7,9 @@
 
 int main(){
 
+    // Before anything else uses the stack (OS/stack.h high-water mark)
+    STACK_vdPaint();
+
     // test_SPI_PollingTransmitReceive();
     // Test_Hserial_Sync_Uart();
     // Test_Hserial_Dma_Uart();